@@ -0,0 +1,169 @@
+#include "bench.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+volatile uint64_t flecs_bench_sink;
+
+void flecsBench_init(
+    flecs_bench_t *bench,
+    FILE *out)
+{
+    bench->out = out;
+    bench->result_count = 0;
+    ecs_vec_init_t(NULL, &bench->samples, double, 0);
+    fprintf(out, "{\n  \"unit\": \"ms\",\n  \"results\": [");
+}
+
+void flecsBench_fini(
+    flecs_bench_t *bench)
+{
+    fprintf(bench->out, "%s]\n}\n", bench->result_count ? "\n  " : "");
+    fflush(bench->out);
+    ecs_vec_fini_t(NULL, &bench->samples, double);
+}
+
+bool flecsBench_match(
+    const flecs_bench_t *bench,
+    const char *name)
+{
+    return !bench->filter || strstr(name, bench->filter) != NULL;
+}
+
+static int flecsBench_compare(
+    const void *a,
+    const void *b)
+{
+    double da = *(const double*)a, db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+void flecsBench_run(
+    flecs_bench_t *bench,
+    const char *name,
+    int64_t items,
+    flecs_bench_fn_t fn,
+    void *ctx)
+{
+    if (!flecsBench_match(bench, name)) {
+        return;
+    }
+
+    for (int32_t i = 0; i < bench->warmup; i ++) {
+        fn(ctx);
+    }
+
+    ecs_vec_clear(&bench->samples);
+
+    /* Sample until both the minimum time and sample count are reached */
+    double total = 0;
+    while (total < bench->min_time ||
+        ecs_vec_count(&bench->samples) < bench->min_samples)
+    {
+        uint64_t start = ecs_os_now();
+        fn(ctx);
+        double t = (double)(ecs_os_now() - start) / 1e9;
+        ecs_vec_append_t(NULL, &bench->samples, double)[0] = t;
+        total += t;
+    }
+
+    int32_t count = ecs_vec_count(&bench->samples);
+    double *samples = ecs_vec_first_t(&bench->samples, double);
+    qsort(samples, (size_t)count, sizeof(double), flecsBench_compare);
+
+    double mean = total / count;
+    double median = samples[count / 2];
+    if (!(count % 2)) {
+        median = (median + samples[count / 2 - 1]) / 2;
+    }
+
+    fprintf(bench->out, "%s\n    {\"name\": \"%s\", \"items\": %lld, "
+        "\"samples\": %d, \"min\": %.4f, \"median\": %.4f, "
+        "\"mean\": %.4f, \"max\": %.4f",
+        bench->result_count ? "," : "", name, (long long)items, count,
+        samples[0] * 1000.0, median * 1000.0, mean * 1000.0,
+        samples[count - 1] * 1000.0);
+
+    /* Throughput is computed from the median, which is less sensitive to
+     * outliers than the mean */
+    if (items > 0 && median > 0) {
+        fprintf(bench->out, ", \"ns_per_item\": %.3f, "
+            "\"items_per_sec\": %.0f",
+            median * 1e9 / (double)items, (double)items / median);
+    }
+
+    fprintf(bench->out, "}");
+    fflush(bench->out);
+    bench->result_count ++;
+
+    fprintf(stderr, "%-40s %10.4f ms (median of %d)\n",
+        name, median * 1000.0, count);
+}
+
+uint32_t flecsBench_random(
+    uint32_t *state)
+{
+    /* xorshift32 */
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+float flecsBench_randomFloat(
+    uint32_t *state,
+    float min,
+    float max)
+{
+    float t = (float)(flecsBench_random(state) >> 8) / (float)(1 << 24);
+    return min + (max - min) * t;
+}
+
+ecs_world_t* flecsBench_initEngine(
+    ecs_entity_t *view_out)
+{
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsEngine);
+
+    ecs_entity_t output = ecs_entity(world, { .name = "output" });
+    ecs_set(world, output, FlecsFrameOutput, {
+        .width = 1280,
+        .height = 720,
+        .frame_count = -1,
+        .null_backend = true
+    });
+
+    ecs_entity_t camera = ecs_entity(world, { .name = "camera" });
+    ecs_set(world, camera, FlecsCamera, {
+        .fov = glm_rad(60.0f),
+        .near_ = 0.2f,
+        .far_ = 1000.0f,
+        .aspect_ratio = 1280.0f / 720.0f
+    });
+    ecs_set(world, camera, FlecsPosition3, {0, 20, -60});
+    ecs_set(world, camera, FlecsLookAt, {0, 0, 0});
+
+    FlecsRenderBatchSet batch_set = {0};
+    ecs_entity_t view = ecs_entity(world, { .name = "view" });
+    ecs_vec_append_t(NULL, &batch_set.batches, ecs_entity_t)[0] =
+        flecsEngine_createBatchSet_geometry(world, view, "geometry");
+
+    ecs_set(world, view, FlecsRenderView, { .camera = camera });
+    ecs_set_ptr(world, view, FlecsRenderBatchSet, &batch_set);
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    if (!ecs_singleton_get(world, FlecsEngineImpl)) {
+        fprintf(stderr, "failed to initialize null GPU engine\n");
+        ecs_fini(world);
+        return NULL;
+    }
+
+    if (view_out) {
+        *view_out = view;
+    }
+
+    return world;
+}
@@ -0,0 +1,83 @@
+#ifndef FLECS_ENGINE_BENCH_H
+#define FLECS_ENGINE_BENCH_H
+
+#include "flecs_engine.h"
+#include "modules/renderer/renderer.h"
+
+#include <stdio.h>
+
+typedef void (*flecs_bench_fn_t)(
+    void *ctx);
+
+typedef struct {
+    const char *filter;   /* Only run cases with this substring in the name */
+    double min_time;      /* Minimum time spent measuring a case, in seconds */
+    int32_t min_samples;  /* Minimum number of measured runs of a case */
+    int32_t warmup;       /* Unmeasured runs before sampling */
+    FILE *out;            /* JSON report */
+    int32_t result_count;
+    ecs_vec_t samples;    /* vec<double>, reused across cases */
+} flecs_bench_t;
+
+/* Values computed by a case are written here, so that the compiler can't
+ * remove the work that is being measured. */
+extern volatile uint64_t flecs_bench_sink;
+
+void flecsBench_init(
+    flecs_bench_t *bench,
+    FILE *out);
+
+void flecsBench_fini(
+    flecs_bench_t *bench);
+
+/* True if a case with this name passes the filter. Suites check this before
+ * setting up data for a case. */
+bool flecsBench_match(
+    const flecs_bench_t *bench,
+    const char *name);
+
+/* Measure a case and write its result. Items is the amount of work done by a
+ * single run, used to report time per item. */
+void flecsBench_run(
+    flecs_bench_t *bench,
+    const char *name,
+    int64_t items,
+    flecs_bench_fn_t fn,
+    void *ctx);
+
+/* Deterministic random numbers, so that runs measure the same data */
+uint32_t flecsBench_random(
+    uint32_t *state);
+
+float flecsBench_randomFloat(
+    uint32_t *state,
+    float min,
+    float max);
+
+/* Create a world with an engine on the null GPU backend and a view with a
+ * camera and the geometry batches. Progresses a few frames, so that the
+ * engine is initialized when this returns. */
+ecs_world_t* flecsBench_initEngine(
+    ecs_entity_t *view_out);
+
+/* --- Suites --- */
+
+void flecsBench_culling(
+    flecs_bench_t *bench);
+
+void flecsBench_cluster(
+    flecs_bench_t *bench);
+
+void flecsBench_transform(
+    flecs_bench_t *bench);
+
+void flecsBench_batches(
+    flecs_bench_t *bench);
+
+void flecsBench_gltf(
+    flecs_bench_t *bench);
+
+void flecsBench_textures(
+    flecs_bench_t *bench);
+
+#endif
@@ -0,0 +1,138 @@
+#include "bench.h"
+#include "modules/renderer/batches/batches.h"
+
+typedef struct {
+    const ecs_world_t *world;
+    FlecsEngineImpl *engine;
+    const FlecsRenderBatch *batch;
+    flecsEngine_batch_t *ctx;
+} flecs_bench_batches_t;
+
+static void flecsBench_batches_extract(
+    void *arg)
+{
+    flecs_bench_batches_t *ctx = arg;
+    ctx->ctx->offset = 0;
+    flecsEngine_batch_extractInstances(
+        ctx->world, ctx->engine, ctx->batch, ctx->ctx);
+    flecs_bench_sink += (uint64_t)ctx->ctx->count;
+}
+
+/* Find the batch that renders boxes with per-instance material data */
+static bool flecsBench_batches_find(
+    ecs_world_t *world,
+    flecs_bench_batches_t *out)
+{
+    ecs_iter_t it = ecs_each(world, FlecsRenderBatch);
+    while (ecs_each_next(&it)) {
+        const FlecsRenderBatch *batches = ecs_field(&it, FlecsRenderBatch, 0);
+        for (int32_t i = 0; i < it.count; i ++) {
+            const FlecsRenderBatch *batch = &batches[i];
+            if (batch->extract_callback != flecsEngine_primitive_extract) {
+                continue;
+            }
+
+            flecsEngine_batch_t *ctx = batch->ctx;
+            if (ctx->component == ecs_id(FlecsBox) &&
+                ctx->buffers->owns_material_data)
+            {
+                out->batch = batch;
+                out->ctx = ctx;
+                ecs_iter_fini(&it);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+static void flecsBench_batches_populate(
+    ecs_world_t *world,
+    int32_t count,
+    uint32_t *seed)
+{
+    for (int32_t i = 0; i < count; i ++) {
+        ecs_entity_t e = ecs_new(world);
+        ecs_set(world, e, FlecsBox, {1, 1, 1});
+        ecs_set(world, e, FlecsPosition3, {
+            flecsBench_randomFloat(seed, -300, 300),
+            flecsBench_randomFloat(seed, 0, 20),
+            flecsBench_randomFloat(seed, -300, 300)
+        });
+        ecs_set(world, e, FlecsRgba, {
+            (uint8_t)flecsBench_random(seed),
+            (uint8_t)flecsBench_random(seed),
+            (uint8_t)flecsBench_random(seed), 255
+        });
+    }
+}
+
+void flecsBench_batches(
+    flecs_bench_t *bench)
+{
+    static const int32_t instance_counts[] = { 10000, 100000, 1000000 };
+    const int32_t case_count = ECS_SIZEOF(instance_counts) /
+        ECS_SIZEOF(instance_counts[0]);
+
+    ecs_world_t *world = NULL;
+    ecs_entity_t view = 0;
+    uint32_t seed = 1;
+    int32_t populated = 0;
+
+    for (int32_t i = 0; i < case_count; i ++) {
+        int32_t count = instance_counts[i];
+        char name[64], name_cull[64];
+        snprintf(name, sizeof(name), "batches/extract/%d", count);
+        snprintf(name_cull, sizeof(name_cull),
+            "batches/extract_cull/%d", count);
+        if (!flecsBench_match(bench, name) &&
+            !flecsBench_match(bench, name_cull))
+        {
+            continue;
+        }
+
+        if (!world) {
+            world = flecsBench_initEngine(&view);
+            if (!world) {
+                return;
+            }
+        }
+
+        /* Grow the scene to the instance count of the case. Progressing
+         * updates transforms and sizes the instance buffers. */
+        flecsBench_batches_populate(world, count - populated, &seed);
+        populated = count;
+        ecs_progress(world, 0);
+
+        flecs_bench_batches_t ctx = {
+            .world = world,
+            .engine = ecs_singleton_get_mut(world, FlecsEngineImpl)
+        };
+
+        if (!flecsBench_batches_find(world, &ctx)) {
+            fprintf(stderr, "box batch not found\n");
+            break;
+        }
+
+        ecs_assert(ctx.ctx->buffers->capacity >= count,
+            ECS_INTERNAL_ERROR, NULL);
+
+        const flecs_engine_frustum_t *frustum = ctx.engine->frustum;
+
+        ctx.engine->frustum = NULL;
+        flecsBench_run(bench, name, count, flecsBench_batches_extract, &ctx);
+
+        const FlecsRenderViewImpl *view_impl = ecs_get(
+            world, view, FlecsRenderViewImpl);
+        ctx.engine->frustum = view_impl ? &view_impl->frustum : NULL;
+        flecsBench_run(bench, name_cull, count,
+            flecsBench_batches_extract, &ctx);
+
+        ctx.engine->frustum = frustum;
+    }
+
+    if (world) {
+        ecs_fini(world);
+    }
+}
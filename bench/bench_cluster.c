@@ -0,0 +1,84 @@
+#include "bench.h"
+
+typedef struct {
+    ecs_world_t *world;
+    FlecsEngineImpl *engine;
+    const FlecsRenderView *view;
+} flecs_bench_cluster_t;
+
+static void flecsBench_cluster_build(
+    void *arg)
+{
+    flecs_bench_cluster_t *ctx = arg;
+    flecsEngine_cluster_build(ctx->world, ctx->engine, ctx->view);
+    flecs_bench_sink += ctx->engine->lighting.cluster_offsets[2];
+}
+
+/* Fill the CPU light array with point lights scattered in front of the
+ * camera. Light setup runs in the frame, so this replaces the lights of the
+ * scene until the next frame. */
+static void flecsBench_cluster_setLights(
+    FlecsEngineImpl *engine,
+    int32_t count)
+{
+    flecsEngine_cluster_ensureLights(engine, count);
+
+    uint32_t seed = 1;
+    for (int32_t i = 0; i < count; i ++) {
+        FlecsGpuLight *light = &engine->lighting.cpu_lights[i];
+        light->position[0] = flecsBench_randomFloat(&seed, -100, 100);
+        light->position[1] = flecsBench_randomFloat(&seed, 0, 20);
+        light->position[2] = flecsBench_randomFloat(&seed, -50, 150);
+        light->position[3] = flecsBench_randomFloat(&seed, 2, 15);
+        light->direction[0] = 0.0f;
+        light->direction[1] = 0.0f;
+        light->direction[2] = 0.0f;
+        light->direction[3] = -2.0f; /* Point light */
+        light->color[0] = 1.0f;
+        light->color[1] = 1.0f;
+        light->color[2] = 1.0f;
+        light->color[3] = 0.0f;
+    }
+
+    engine->lighting.light_count = count;
+}
+
+void flecsBench_cluster(
+    flecs_bench_t *bench)
+{
+    static const int32_t light_counts[] = { 64, 256, 1024, 4096 };
+    const int32_t case_count = ECS_SIZEOF(light_counts) /
+        ECS_SIZEOF(light_counts[0]);
+
+    ecs_world_t *world = NULL;
+    flecs_bench_cluster_t ctx = {0};
+
+    for (int32_t i = 0; i < case_count; i ++) {
+        char name[64];
+        snprintf(name, sizeof(name), "cluster/build/%d", light_counts[i]);
+        if (!flecsBench_match(bench, name)) {
+            continue;
+        }
+
+        /* Only create the engine if at least one case runs */
+        if (!world) {
+            ecs_entity_t view = 0;
+            world = flecsBench_initEngine(&view);
+            if (!world) {
+                return;
+            }
+
+            ctx.world = world;
+            ctx.engine = ecs_singleton_get_mut(world, FlecsEngineImpl);
+            ctx.view = ecs_get(world, view, FlecsRenderView);
+        }
+
+        flecsBench_cluster_setLights(ctx.engine, light_counts[i]);
+        flecsBench_run(bench, name, light_counts[i],
+            flecsBench_cluster_build, &ctx);
+    }
+
+    if (world) {
+        ecs_fini(world);
+    }
+}
@@ -0,0 +1,94 @@
+#include "bench.h"
+#include "modules/renderer/frustum_cull.h"
+
+#define FLECS_BENCH_CULLING_COUNT (100 * 1000)
+
+typedef struct {
+    FlecsWorldTransform3 *transforms;
+    float planes[6][4];
+    int32_t count;
+} flecs_bench_culling_t;
+
+static void flecsBench_culling_worldAABB(
+    void *arg)
+{
+    const flecs_bench_culling_t *ctx = arg;
+    const float local_min[3] = { -0.5f, -0.5f, -0.5f };
+    const float local_max[3] = { 0.5f, 0.5f, 0.5f };
+    float sum = 0;
+
+    for (int32_t i = 0; i < ctx->count; i ++) {
+        float wmin[3], wmax[3];
+        flecsEngine_computeWorldAABB(&ctx->transforms[i],
+            local_min, local_max, 1.0f, 1.0f, 1.0f, wmin, wmax);
+        sum += wmin[0] + wmax[2];
+    }
+
+    flecs_bench_sink += (uint64_t)sum;
+}
+
+static void flecsBench_culling_frustum(
+    void *arg)
+{
+    const flecs_bench_culling_t *ctx = arg;
+    const float local_min[3] = { -0.5f, -0.5f, -0.5f };
+    const float local_max[3] = { 0.5f, 0.5f, 0.5f };
+    uint64_t visible = 0;
+
+    for (int32_t i = 0; i < ctx->count; i ++) {
+        float wmin[3], wmax[3];
+        flecsEngine_computeWorldAABB(&ctx->transforms[i],
+            local_min, local_max, 1.0f, 1.0f, 1.0f, wmin, wmax);
+        visible += flecsEngine_testAABBFrustum(ctx->planes, wmin, wmax);
+    }
+
+    flecs_bench_sink += visible;
+}
+
+void flecsBench_culling(
+    flecs_bench_t *bench)
+{
+    if (!flecsBench_match(bench, "culling/world_aabb") &&
+        !flecsBench_match(bench, "culling/aabb_frustum"))
+    {
+        return;
+    }
+
+    flecs_bench_culling_t ctx = { .count = FLECS_BENCH_CULLING_COUNT };
+    ctx.transforms = ecs_os_malloc_n(FlecsWorldTransform3, ctx.count);
+
+    /* Randomly placed, rotated and scaled instances around the camera, so
+     * that part of them is outside of the frustum */
+    uint32_t seed = 1;
+    for (int32_t i = 0; i < ctx.count; i ++) {
+        vec3 axis = {
+            flecsBench_randomFloat(&seed, -1, 1),
+            flecsBench_randomFloat(&seed, -1, 1) + 2.0f,
+            flecsBench_randomFloat(&seed, -1, 1)
+        };
+        vec3 pos = {
+            flecsBench_randomFloat(&seed, -200, 200),
+            flecsBench_randomFloat(&seed, -10, 50),
+            flecsBench_randomFloat(&seed, -200, 200)
+        };
+
+        mat4 m;
+        glm_translate_make(m, pos);
+        glm_rotate(m, flecsBench_randomFloat(&seed, 0, GLM_PIf), axis);
+        glm_scale_uni(m, flecsBench_randomFloat(&seed, 0.5f, 4.0f));
+        glm_mat4_copy(m, ctx.transforms[i].m);
+    }
+
+    mat4 proj, view, view_proj;
+    glm_perspective(glm_rad(60.0f), 16.0f / 9.0f, 0.2f, 1000.0f, proj);
+    glm_lookat((vec3){0, 20, -60}, (vec3){0, 0, 0}, (vec3){0, 1, 0}, view);
+    glm_mat4_mul(proj, view, view_proj);
+    flecsEngine_frustum_extractPlanes(view_proj, ctx.planes);
+
+    flecsBench_run(bench, "culling/world_aabb", ctx.count,
+        flecsBench_culling_worldAABB, &ctx);
+    flecsBench_run(bench, "culling/aabb_frustum", ctx.count,
+        flecsBench_culling_frustum, &ctx);
+
+    ecs_os_free(ctx.transforms);
+}
@@ -0,0 +1,146 @@
+#include "bench.h"
+#include "modules/gltf/gltf.h"
+
+#include <cgltf.h>
+
+/* 512x512 vertex grid with interleaved position, normal and uv */
+#define FLECS_BENCH_GLTF_GRID (512)
+#define FLECS_BENCH_GLTF_STRIDE (8 * ECS_SIZEOF(float))
+
+typedef struct {
+    cgltf_buffer buffer;
+    cgltf_buffer_view vertex_view;
+    cgltf_buffer_view index_view;
+    cgltf_accessor position;
+    cgltf_accessor normal;
+    cgltf_accessor uv;
+    cgltf_accessor indices;
+    cgltf_attribute attributes[3];
+    cgltf_primitive primitive;
+} flecs_bench_gltf_t;
+
+static void flecsBench_gltf_readMesh(
+    void *arg)
+{
+    const flecs_bench_gltf_t *ctx = arg;
+    FlecsMesh3 mesh;
+    ecs_os_zeromem(&mesh);
+
+    flecsEngine_gltf_readMesh(&mesh, &ctx->primitive);
+    flecs_bench_sink += (uint64_t)ecs_vec_count(&mesh.indices);
+
+    ecs_vec_fini_t(NULL, &mesh.vertices, flecs_vec3_t);
+    ecs_vec_fini_t(NULL, &mesh.normals, flecs_vec3_t);
+    ecs_vec_fini_t(NULL, &mesh.uvs, flecs_vec2_t);
+    ecs_vec_fini_t(NULL, &mesh.indices, uint32_t);
+}
+
+/* Build a primitive the way cgltf would after parsing a file, with the
+ * accessors pointing into a single buffer. */
+static void flecsBench_gltf_init(
+    flecs_bench_gltf_t *ctx)
+{
+    const int32_t n = FLECS_BENCH_GLTF_GRID;
+    const int32_t vertex_count = n * n;
+    const int32_t index_count = (n - 1) * (n - 1) * 6;
+    const cgltf_size vertex_size =
+        (cgltf_size)vertex_count * FLECS_BENCH_GLTF_STRIDE;
+    const cgltf_size index_size =
+        (cgltf_size)index_count * sizeof(uint32_t);
+
+    ecs_os_zeromem(ctx);
+    ctx->buffer.size = vertex_size + index_size;
+    ctx->buffer.data = ecs_os_malloc((ecs_size_t)ctx->buffer.size);
+
+    float *vertices = ctx->buffer.data;
+    for (int32_t y = 0; y < n; y ++) {
+        for (int32_t x = 0; x < n; x ++) {
+            float *v = &vertices[(y * n + x) * 8];
+            v[0] = (float)x; v[1] = 0.0f; v[2] = (float)y;
+            v[3] = 0.0f; v[4] = 1.0f; v[5] = 0.0f;
+            v[6] = (float)x / (float)(n - 1);
+            v[7] = (float)y / (float)(n - 1);
+        }
+    }
+
+    uint32_t *indices = ECS_OFFSET(ctx->buffer.data, vertex_size);
+    for (int32_t y = 0; y < n - 1; y ++) {
+        for (int32_t x = 0; x < n - 1; x ++) {
+            uint32_t i0 = (uint32_t)(y * n + x);
+            uint32_t i1 = i0 + 1;
+            uint32_t i2 = i0 + (uint32_t)n;
+            uint32_t i3 = i2 + 1;
+            indices[0] = i0; indices[1] = i2; indices[2] = i1;
+            indices[3] = i1; indices[4] = i2; indices[5] = i3;
+            indices += 6;
+        }
+    }
+
+    ctx->vertex_view = (cgltf_buffer_view){
+        .buffer = &ctx->buffer,
+        .size = vertex_size,
+        .stride = FLECS_BENCH_GLTF_STRIDE,
+        .type = cgltf_buffer_view_type_vertices
+    };
+
+    ctx->index_view = (cgltf_buffer_view){
+        .buffer = &ctx->buffer,
+        .offset = vertex_size,
+        .size = index_size,
+        .type = cgltf_buffer_view_type_indices
+    };
+
+    ctx->position = (cgltf_accessor){
+        .component_type = cgltf_component_type_r_32f,
+        .type = cgltf_type_vec3,
+        .count = (cgltf_size)vertex_count,
+        .stride = FLECS_BENCH_GLTF_STRIDE,
+        .buffer_view = &ctx->vertex_view
+    };
+
+    ctx->normal = ctx->position;
+    ctx->normal.offset = 3 * sizeof(float);
+
+    ctx->uv = ctx->position;
+    ctx->uv.type = cgltf_type_vec2;
+    ctx->uv.offset = 6 * sizeof(float);
+
+    ctx->indices = (cgltf_accessor){
+        .component_type = cgltf_component_type_r_32u,
+        .type = cgltf_type_scalar,
+        .count = (cgltf_size)index_count,
+        .stride = sizeof(uint32_t),
+        .buffer_view = &ctx->index_view
+    };
+
+    ctx->attributes[0] = (cgltf_attribute){
+        .type = cgltf_attribute_type_position, .data = &ctx->position };
+    ctx->attributes[1] = (cgltf_attribute){
+        .type = cgltf_attribute_type_normal, .data = &ctx->normal };
+    ctx->attributes[2] = (cgltf_attribute){
+        .type = cgltf_attribute_type_texcoord, .data = &ctx->uv };
+
+    ctx->primitive = (cgltf_primitive){
+        .type = cgltf_primitive_type_triangles,
+        .indices = &ctx->indices,
+        .attributes = ctx->attributes,
+        .attributes_count = 3
+    };
+}
+
+void flecsBench_gltf(
+    flecs_bench_t *bench)
+{
+    if (!flecsBench_match(bench, "gltf/read_mesh")) {
+        return;
+    }
+
+    flecs_bench_gltf_t *ctx = ecs_os_malloc_t(flecs_bench_gltf_t);
+    flecsBench_gltf_init(ctx);
+
+    flecsBench_run(bench, "gltf/read_mesh", (int64_t)ctx->position.count,
+        flecsBench_gltf_readMesh, ctx);
+
+    ecs_os_free(ctx->buffer.data);
+    ecs_os_free(ctx);
+}
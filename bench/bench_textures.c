@@ -0,0 +1,67 @@
+#include "bench.h"
+
+typedef struct {
+    uint8_t *pixels;
+    uint8_t *mips[2];
+    uint32_t size;
+} flecs_bench_textures_t;
+
+/* Generate the full mip chain on the CPU, like texture_createFromPixels
+ * does for images that don't have mips. */
+static void flecsBench_textures_mipChain(
+    void *arg)
+{
+    flecs_bench_textures_t *ctx = arg;
+    const uint8_t *src = ctx->pixels;
+    uint32_t w = ctx->size, h = ctx->size;
+    int32_t level = 0;
+
+    while (w > 1 || h > 1) {
+        uint32_t mip_w = w > 1 ? w / 2 : 1;
+        uint32_t mip_h = h > 1 ? h / 2 : 1;
+        uint8_t *dst = ctx->mips[level % 2];
+        flecsEngine_texture_downsample(src, w, h, dst, mip_w, mip_h);
+        src = dst;
+        w = mip_w;
+        h = mip_h;
+        level ++;
+    }
+
+    flecs_bench_sink += src[0];
+}
+
+void flecsBench_textures(
+    flecs_bench_t *bench)
+{
+    static const uint32_t sizes[] = { 1024, 2048 };
+    const int32_t case_count = ECS_SIZEOF(sizes) / ECS_SIZEOF(sizes[0]);
+
+    for (int32_t i = 0; i < case_count; i ++) {
+        char name[64];
+        snprintf(name, sizeof(name), "textures/mip_chain/%u", sizes[i]);
+        if (!flecsBench_match(bench, name)) {
+            continue;
+        }
+
+        flecs_bench_textures_t ctx = { .size = sizes[i] };
+        ecs_size_t size = (ecs_size_t)(sizes[i] * sizes[i] * 4);
+        ctx.pixels = ecs_os_malloc(size);
+
+        /* Levels alternate between two buffers, the first level is the
+         * largest one at a quarter of the image */
+        ctx.mips[0] = ecs_os_malloc(size / 4);
+        ctx.mips[1] = ecs_os_malloc(size / 4);
+
+        uint32_t seed = 1;
+        for (ecs_size_t p = 0; p < size; p ++) {
+            ctx.pixels[p] = (uint8_t)flecsBench_random(&seed);
+        }
+
+        flecsBench_run(bench, name, (int64_t)sizes[i] * sizes[i],
+            flecsBench_textures_mipChain, &ctx);
+
+        ecs_os_free(ctx.pixels);
+        ecs_os_free(ctx.mips[0]);
+        ecs_os_free(ctx.mips[1]);
+    }
+}
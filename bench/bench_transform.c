@@ -0,0 +1,92 @@
+#include "bench.h"
+#include "modules/transform3/transform3.h"
+
+/* 100 roots with 10 children per entity, 3 levels deep (111100 entities) */
+#define FLECS_BENCH_TRANSFORM_ROOTS (100)
+#define FLECS_BENCH_TRANSFORM_FANOUT (10)
+#define FLECS_BENCH_TRANSFORM_DEPTH (3)
+
+typedef struct {
+    ecs_world_t *world;
+    ecs_entity_t system;
+} flecs_bench_transform_t;
+
+static void flecsBench_transform_run(
+    void *arg)
+{
+    flecs_bench_transform_t *ctx = arg;
+    ecs_run(ctx->world, ctx->system, 0, NULL);
+}
+
+static int32_t flecsBench_transform_populate(
+    ecs_world_t *world,
+    ecs_entity_t parent,
+    int32_t depth,
+    bool use_parent,
+    uint32_t *seed)
+{
+    ecs_entity_t e;
+    if (!parent) {
+        e = ecs_new(world);
+    } else if (use_parent) {
+        e = ecs_new_w_parent(world, parent, NULL);
+    } else {
+        e = ecs_new_w_pair(world, EcsChildOf, parent);
+    }
+
+    ecs_set(world, e, FlecsPosition3, {
+        flecsBench_randomFloat(seed, -10, 10),
+        flecsBench_randomFloat(seed, -10, 10),
+        flecsBench_randomFloat(seed, -10, 10)
+    });
+    ecs_set(world, e, FlecsRotation3, {
+        0, flecsBench_randomFloat(seed, 0, GLM_PIf), 0
+    });
+
+    int32_t count = 1;
+    if (depth < FLECS_BENCH_TRANSFORM_DEPTH) {
+        for (int32_t i = 0; i < FLECS_BENCH_TRANSFORM_FANOUT; i ++) {
+            count += flecsBench_transform_populate(
+                world, e, depth + 1, use_parent, seed);
+        }
+    }
+
+    return count;
+}
+
+static void flecsBench_transform_hierarchy(
+    flecs_bench_t *bench,
+    const char *name,
+    bool use_parent)
+{
+    if (!flecsBench_match(bench, name)) {
+        return;
+    }
+
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsEngineTransform3);
+
+    uint32_t seed = 1;
+    int32_t count = 0;
+    for (int32_t i = 0; i < FLECS_BENCH_TRANSFORM_ROOTS; i ++) {
+        count += flecsBench_transform_populate(
+            world, 0, 0, use_parent, &seed);
+    }
+
+    flecs_bench_transform_t ctx = {
+        .world = world,
+        .system = ecs_lookup(world, "flecs.engine.transform3.Transform3")
+    };
+    ecs_assert(ctx.system != 0, ECS_INTERNAL_ERROR, NULL);
+
+    flecsBench_run(bench, name, count, flecsBench_transform_run, &ctx);
+
+    ecs_fini(world);
+}
+
+void flecsBench_transform(
+    flecs_bench_t *bench)
+{
+    flecsBench_transform_hierarchy(bench, "transform/childof", false);
+    flecsBench_transform_hierarchy(bench, "transform/parent", true);
+}
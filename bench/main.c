@@ -0,0 +1,123 @@
+#include "bench.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void flecsBench_printUsage(
+    const char *argv0)
+{
+    printf(
+        "Usage: %s [--filter <substr>] [--out <file.json>] [--min-time <ms>]\n"
+        "          [--min-samples <n>]\n"
+        "\n"
+        "  --filter <substr>   Only run cases with the substring in their name,\n"
+        "                      for example batches/ or cluster/build/1024.\n"
+        "  --out <path>        Write the JSON report to a file (default: stdout).\n"
+        "  --min-time <ms>     Minimum time to measure each case (default: 500).\n"
+        "  --min-samples <n>   Minimum runs to measure each case (default: 10).\n"
+        "  -h, --help          Show this help.\n",
+        argv0);
+}
+
+static bool flecsBench_parsePositiveI32(
+    const char *arg,
+    int32_t *out)
+{
+    char *end = NULL;
+    long value = strtol(arg, &end, 10);
+    if (end == arg || *end != '\0' || value <= 0 || value > INT_MAX) {
+        return false;
+    }
+
+    *out = (int32_t)value;
+    return true;
+}
+
+int main(
+    int argc,
+    char *argv[])
+{
+    flecs_bench_t bench = {
+        .min_time = 0.5,
+        .min_samples = 10,
+        .warmup = 2
+    };
+
+    const char *out_path = NULL;
+    int32_t min_time_ms = 500;
+
+    for (int i = 1; i < argc; i ++) {
+        const char *arg = argv[i];
+
+        if (!strcmp(arg, "--help") || !strcmp(arg, "-h")) {
+            flecsBench_printUsage(argv[0]);
+            return 0;
+        }
+
+        if (!strcmp(arg, "--filter") && i + 1 < argc) {
+            bench.filter = argv[++ i];
+            continue;
+        }
+
+        if (!strcmp(arg, "--out") && i + 1 < argc) {
+            out_path = argv[++ i];
+            continue;
+        }
+
+        if (!strcmp(arg, "--min-time")) {
+            if (i + 1 >= argc ||
+                !flecsBench_parsePositiveI32(argv[i + 1], &min_time_ms))
+            {
+                fprintf(stderr, "--min-time requires a positive integer\n");
+                return 1;
+            }
+            i ++;
+            continue;
+        }
+
+        if (!strcmp(arg, "--min-samples")) {
+            if (i + 1 >= argc ||
+                !flecsBench_parsePositiveI32(argv[i + 1], &bench.min_samples))
+            {
+                fprintf(stderr, "--min-samples requires a positive integer\n");
+                return 1;
+            }
+            i ++;
+            continue;
+        }
+
+        fprintf(stderr, "unknown or incomplete option: %s\n", arg);
+        flecsBench_printUsage(argv[0]);
+        return 1;
+    }
+
+    bench.min_time = (double)min_time_ms / 1000.0;
+
+    FILE *out = stdout;
+    if (out_path) {
+        out = fopen(out_path, "wb");
+        if (!out) {
+            fprintf(stderr, "failed to open %s\n", out_path);
+            return 1;
+        }
+    }
+
+    /* Keep engine info messages out of the per case progress output */
+    ecs_log_set_level(-1);
+
+    flecsBench_init(&bench, out);
+    flecsBench_culling(&bench);
+    flecsBench_cluster(&bench);
+    flecsBench_transform(&bench);
+    flecsBench_batches(&bench);
+    flecsBench_gltf(&bench);
+    flecsBench_textures(&bench);
+    flecsBench_fini(&bench);
+
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return 0;
+}
@@ -44,6 +44,9 @@ extern ECS_COMPONENT_DECLARE(flecs_rgba_t);
 #include "modules/geometry_primitives3.h"
 #include "modules/material.h"
 #include "modules/gltf.h"
+#include "modules/stress.h"
+#include "modules/trace.h"
+#include "modules/benchmark.h"
 
 void FlecsEngineImport(
     ecs_world_t *world);
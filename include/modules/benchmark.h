@@ -0,0 +1,23 @@
+#ifndef FLECS_ENGINE_BENCHMARK_H
+#define FLECS_ENGINE_BENCHMARK_H
+
+/* Singleton that benchmarks the engine. After warmup frames, the wall clock,
+ * CPU stage and GPU pass times and the render stats of frame_count frames are
+ * recorded. A JSON report with percentiles is then written to path, and the
+ * application quits.
+ *
+ * CPU and GPU timing are enabled while the benchmark runs. For reproducible
+ * results, progress the world with a fixed delta_time and render offscreen
+ * with FlecsFrameOutput. */
+typedef struct {
+    int32_t warmup_frames;  /* Frames rendered before measuring */
+    int32_t frame_count;    /* Frames measured, 0 for the default (600) */
+    ecs_entity_t camera;    /* Orbits its FlecsLookAt target once while
+                             * measuring. 0 keeps the camera where it is. */
+    const char *scene;      /* Name of the scene in the report, may be NULL */
+    const char *path;       /* JSON report */
+} FlecsBenchmark;
+
+extern ECS_COMPONENT_DECLARE(FlecsBenchmark);
+
+#endif
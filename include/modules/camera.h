@@ -16,4 +16,12 @@ ECS_STRUCT(FlecsCamera, {
     bool orthographic;
 });
 
+/* Sub-pixel offset of the projection for a frame, in pixels within
+ * [-0.5, 0.5]. Cameras of views with a TAA effect cycle through a Halton(2, 3)
+ * sequence, so the average of the offsets over a cycle is close to zero. */
+void flecsEngine_cameraJitterOffset(
+    uint32_t frame,
+    float *x,
+    float *y);
+
 #endif
@@ -6,11 +6,22 @@
 #define ECS_META_IMPL EXTERN
 #endif
 
+/* Render offscreen and write the last frame to a PPM image. frame_count is
+ * the number of frames rendered before quitting: 0 renders a single frame,
+ * -1 renders until the application quits. Without a path, a single frame is
+ * written to frame.ppm and multiple frames aren't written. fallback_adapter
+ * requests a software adapter, so that frames render on machines without a
+ * GPU. null_backend runs the frame loop on the null WebGPU backend, which
+ * records commands without drawing: images are black, but CPU timings and
+ * FlecsGpuCommandStats are deterministic on any machine. */
 ECS_STRUCT(FlecsFrameOutput, {
     int32_t width;
     int32_t height;
     bool msaa;
     const char *path;
+    int32_t frame_count;
+    bool fallback_adapter;
+    bool null_backend;
 });
 
 #endif
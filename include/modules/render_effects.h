@@ -15,6 +15,7 @@ typedef struct {
     uint32_t mip_count;
     float scale_x;
     float scale_y;
+    bool compute; /* Build the mip chain with compute dispatches */
 } FlecsBloom;
 
 extern ECS_COMPONENT_DECLARE(FlecsBloom);
@@ -34,10 +35,34 @@ ECS_STRUCT(FlecsSSAO, {
     float bias;
     float intensity;
     int32_t blur;
+    int32_t resolution;   /* AO resolution divisor (1, 2, 4), 0 = automatic */
+    int32_t sample_count; /* Kernel samples per pixel per frame (1-16) */
+    bool temporal;        /* Accumulate AO over frames, rotating the samples */
 });
 
 extern ECS_COMPONENT_DECLARE(FlecsSSAO);
 
+/* Post-process anti-aliasing, a cheaper alternative to MSAA. Edges are found
+ * on the final image, so the effect works best after tone mapping. */
+ECS_STRUCT(FlecsFXAA, {
+    float edge_threshold;     /* Minimum contrast, relative to local luma */
+    float edge_threshold_min; /* Minimum contrast in dark regions */
+    float subpixel;           /* Subpixel aliasing removal, 0 = off, 1 = max */
+});
+
+extern ECS_COMPONENT_DECLARE(FlecsFXAA);
+
+/* Temporal anti-aliasing. Jitters the camera of the view and accumulates the
+ * frames in a history that is reprojected with the camera motion. When TAA is
+ * the last effect of a view that renders below output resolution, it also
+ * upscales to output resolution. */
+ECS_STRUCT(FlecsTAA, {
+    float feedback;     /* Weight of the history, higher is smoother */
+    float clip_gamma;   /* Size of the neighborhood color box in std devs */
+});
+
+extern ECS_COMPONENT_DECLARE(FlecsTAA);
+
 ecs_entity_t flecsEngine_createEffect_tonyMcMapFace(
     ecs_world_t *world,
     ecs_entity_t parent,
@@ -77,6 +102,24 @@ ecs_entity_t flecsEngine_createEffect_ssao(
     int32_t input,
     const FlecsSSAO *settings);
 
+FlecsFXAA flecsEngine_fxaaSettingsDefault(void);
+
+ecs_entity_t flecsEngine_createEffect_fxaa(
+    ecs_world_t *world,
+    ecs_entity_t parent,
+    const char *name,
+    int32_t input,
+    const FlecsFXAA *settings);
+
+FlecsTAA flecsEngine_taaSettingsDefault(void);
+
+ecs_entity_t flecsEngine_createEffect_taa(
+    ecs_world_t *world,
+    ecs_entity_t parent,
+    const char *name,
+    int32_t input,
+    const FlecsTAA *settings);
+
 ecs_entity_t flecsEngine_createEffect_gammaCorrect(
     ecs_world_t *world,
     ecs_entity_t parent,
@@ -81,10 +81,226 @@ typedef struct {
     const char *source;
     const char *vertex_entry;
     const char *fragment_entry;
+    const char *defines; /* Space separated, evaluated by #ifdef/#ifndef */
 } FlecsShader;
 
 extern ECS_COMPONENT_DECLARE(FlecsShader);
 
+typedef struct {
+    int32_t module_count;   /* Unique shader modules alive in the cache */
+    int32_t compile_count;  /* Total modules compiled by the device */
+    int32_t hit_count;      /* Requests served from the cache */
+} FlecsShaderCacheStats;
+
+extern ECS_COMPONENT_DECLARE(FlecsShaderCacheStats);
+
+typedef struct {
+    int32_t create_count;       /* Bind groups created in the last frame */
+    int32_t reuse_count;        /* Cached bind groups reused in the last frame */
+    int64_t total_create_count; /* Bind groups created since engine init */
+} FlecsBindGroupStats;
+
+extern ECS_COMPONENT_DECLARE(FlecsBindGroupStats);
+
+typedef struct {
+    int32_t frames_in_flight;
+    int32_t wait_count;       /* Fence waits that stalled the last frame */
+    float wait_time;          /* Seconds stalled on fences in the last frame */
+    int64_t frame_count;      /* Frames started since engine init */
+    int64_t total_wait_count; /* Frames that stalled since engine init */
+    double total_wait_time;   /* Seconds stalled since engine init */
+} FlecsFrameSyncStats;
+
+extern ECS_COMPONENT_DECLARE(FlecsFrameSyncStats);
+
+typedef struct {
+    int32_t texture_count;      /* Transient textures of all views */
+    int64_t texture_bytes;      /* Memory of transient textures */
+    int64_t peak_texture_bytes; /* Highest texture_bytes since engine init */
+} FlecsRenderGraphStats;
+
+extern ECS_COMPONENT_DECLARE(FlecsRenderGraphStats);
+
+/* Singleton that enables dynamic resolution. Views are rendered into a
+ * viewport that is scaled to keep the frame time within the budget, and
+ * upscaled to output resolution. The frame time is measured with
+ * FlecsGpuTiming if enabled, otherwise with FlecsCpuTiming. Without either
+ * the frame delta is used, which vsync caps at the refresh interval. */
+typedef struct {
+    float target_frame_time; /* Frame time budget in seconds */
+    float min_scale;         /* Smallest scale of the render resolution */
+    float max_scale;         /* Largest scale, at most 1 */
+    float step;              /* Largest change of the scale per adjustment */
+    float sharpness;         /* Sharpening after upscale, 0 = off, 1 = max */
+} FlecsDynamicResolution;
+
+extern ECS_COMPONENT_DECLARE(FlecsDynamicResolution);
+
+/* Controller state. Published as singleton when dynamic resolution is on. */
+typedef struct {
+    float scale;      /* Scale of the render resolution, 0 if not started */
+    float frame_time; /* Filtered frame time in seconds */
+    int32_t cooldown; /* Frames until the scale can be adjusted again */
+} FlecsDynamicResolutionState;
+
+extern ECS_COMPONENT_DECLARE(FlecsDynamicResolutionState);
+
+/* Singleton that enables GPU timestamp queries. Has no effect if the device
+ * doesn't support timestamps. */
+typedef struct {
+    bool enabled;
+} FlecsGpuTiming;
+
+extern ECS_COMPONENT_DECLARE(FlecsGpuTiming);
+
+typedef struct {
+    const char *name;    /* Static name of the pass */
+    ecs_entity_t effect; /* Effect entity, 0 if not an effect pass */
+    float time;          /* Seconds */
+} FlecsGpuPassTime;
+
+extern ECS_COMPONENT_DECLARE(FlecsGpuPassTime);
+
+/* GPU time of the passes of a view. Set on view entities when GPU timing is
+ * enabled, a few frames after the frame was rendered. */
+typedef struct {
+    float shadow_time;   /* Seconds spent in shadow passes */
+    float batch_time;    /* Seconds spent in batch and depth resolve passes */
+    float effect_time;   /* Seconds spent in effect passes */
+    float total_time;
+    int64_t frame;       /* Frame the timings were recorded in */
+    ecs_vec_t passes;    /* vec<FlecsGpuPassTime> */
+} FlecsRenderViewGpuTime;
+
+extern ECS_COMPONENT_DECLARE(FlecsRenderViewGpuTime);
+
+/* Work done by the last rendered frame of a view. Set on view entities. */
+typedef struct {
+    int32_t draw_count;             /* Batch draw calls, all passes */
+    int64_t instance_count;         /* Instances drawn in the main pass */
+    int64_t shadow_instance_count[FLECS_ENGINE_SHADOW_CASCADE_COUNT];
+    int64_t triangle_count;         /* Triangles drawn, all passes */
+    int32_t pipeline_switch_count;
+    int32_t bind_group_switch_count;
+    int32_t buffer_create_count;
+    int32_t texture_create_count;
+    int32_t write_count;            /* wgpuQueueWriteBuffer calls */
+    int64_t write_bytes;
+    int32_t visible_instance_count; /* Instances that passed frustum culling */
+    int32_t culled_instance_count;
+} FlecsRenderViewStats;
+
+extern ECS_COMPONENT_DECLARE(FlecsRenderViewStats);
+
+/* Commands submitted since the previous frame. Published as singleton when
+ * the engine runs on the null GPU backend, where counts don't depend on the
+ * driver or timing, so they can be compared between runs. */
+typedef struct {
+    int32_t submit_count;
+    int32_t command_buffer_count;
+    int32_t render_pass_count;
+    int32_t compute_pass_count;
+    int32_t draw_count;
+    int32_t draw_indexed_count;
+    int32_t dispatch_count;
+    int32_t pipeline_set_count;
+    int32_t bind_group_set_count;
+    int32_t vertex_buffer_set_count;
+    int32_t index_buffer_set_count;
+    int32_t copy_count;          /* Buffer, texture and query copies */
+    int32_t write_buffer_count;  /* wgpuQueueWriteBuffer calls */
+    int64_t write_buffer_bytes;
+    int32_t write_texture_count; /* wgpuQueueWriteTexture calls */
+    int64_t write_texture_bytes;
+} FlecsGpuCommandStats;
+
+extern ECS_COMPONENT_DECLARE(FlecsGpuCommandStats);
+
+/* Singleton that enables timing of the CPU stages of a frame */
+typedef struct {
+    bool enabled;
+} FlecsCpuTiming;
+
+extern ECS_COMPONENT_DECLARE(FlecsCpuTiming);
+
+/* Seconds spent in a stage, over the last 128 frames */
+typedef struct {
+    float last;
+    float avg;
+    float p50;
+    float p95;
+    float p99;
+} FlecsCpuStageTime;
+
+extern ECS_COMPONENT_DECLARE(FlecsCpuStageTime);
+
+/* Published as singleton while CPU timing is enabled. Stages that run once
+ * per view are summed over the views of a frame. */
+typedef struct {
+    FlecsCpuStageTime frustum;       /* Frustum extraction */
+    FlecsCpuStageTime batch_extract; /* Extraction of batch instances */
+    FlecsCpuStageTime lights;        /* Light setup */
+    FlecsCpuStageTime cluster;       /* Light cluster build */
+    FlecsCpuStageTime shadow;        /* Shadow setup and waiting on cascades */
+    FlecsCpuStageTime batches;       /* Encoding of the batch pass */
+    FlecsCpuStageTime effects;       /* Encoding of effects */
+    FlecsCpuStageTime submit;        /* Queue submit and present */
+    FlecsCpuStageTime acquire;       /* Surface acquire */
+    FlecsCpuStageTime total;         /* Sum of the stages */
+    int32_t sample_count;            /* Frames in the window */
+} FlecsCpuFrameStats;
+
+extern ECS_COMPONENT_DECLARE(FlecsCpuFrameStats);
+
+/* GPU memory allocated by the engine in bytes, by category. Published as
+ * singleton. Sizes are computed from buffer and texture descriptors, and
+ * don't include driver padding. */
+typedef struct {
+    int64_t mesh;          /* Vertex and index buffers of meshes */
+    int64_t texture;       /* Material textures, including mips */
+    int64_t ibl;           /* Environment maps, cubemaps and lookup tables */
+    int64_t shadow;        /* Shadow map arrays and cascade matrices */
+    int64_t render_target; /* Depth, MSAA, view and output targets */
+    int64_t effect;        /* Textures and uniforms of effects */
+    int64_t instance;      /* Instance and material buffers of batches */
+    int64_t uniform;       /* View, light and cluster buffers */
+    int64_t other;         /* Query and readback buffers */
+    int64_t total;
+    int64_t peak_total;    /* Highest total since the process started */
+    int32_t buffer_count;
+    int32_t texture_count;
+    bool over_budget;      /* Total exceeds FlecsGpuMemoryBudget */
+} FlecsGpuMemory;
+
+extern ECS_COMPONENT_DECLARE(FlecsGpuMemory);
+
+typedef void (*flecs_gpu_memory_budget_action_t)(
+    ecs_world_t *world,
+    const FlecsGpuMemory *memory,
+    void *ctx);
+
+/* Singleton with a GPU memory budget. When the total exceeds the budget the
+ * callback is invoked once, and again only after the total dropped below the
+ * budget. Applications can use it to lower quality before the driver starts
+ * paging. */
+typedef struct {
+    int64_t budget;                            /* Bytes, 0 is unlimited */
+    flecs_gpu_memory_budget_action_t callback; /* May be NULL */
+    void *ctx;
+} FlecsGpuMemoryBudget;
+
+extern ECS_COMPONENT_DECLARE(FlecsGpuMemoryBudget);
+
+FlecsDynamicResolution flecsEngine_dynamicResolutionSettingsDefault(void);
+
+/* Feed a measured frame time to the controller and return the new scale.
+ * Doesn't use the world or GPU, so it can be driven with synthetic frame
+ * times. */
+float flecsEngine_dynamicResolution_update(
+    const FlecsDynamicResolution *settings,
+    FlecsDynamicResolutionState *state,
+    float frame_time);
+
 ECS_STRUCT(FlecsRenderBatchSet, {
     ecs_vec_t batches;
 });
@@ -125,6 +341,11 @@ ECS_STRUCT(FlecsRenderView, {
     flecs_engine_background_t background;
     flecs_engine_shadow_params_t shadow;
     ecs_vec_t effects;
+    bool disable_effect_fusion; /* Run pointwise effects as separate passes */
+    bool disable_target_aliasing; /* Give each effect target its own texture */
+    /* Effect targets use RG11B10Ufloat (no alpha) for HDR colors when the
+     * device can render to it, and RGBA8UnormSrgb after tonemapping. */
+    bool packed_effect_targets;
 });
 
 ecs_entity_t flecsEngine_createHdri(
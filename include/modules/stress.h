@@ -0,0 +1,34 @@
+#ifndef FLECS_ENGINE_STRESS_H
+#define FLECS_ENGINE_STRESS_H
+
+#undef ECS_META_IMPL
+#ifndef FLECS_ENGINE_STRESS_IMPL
+#define ECS_META_IMPL EXTERN
+#endif
+
+/* Generates a synthetic scene under the entity it is set on, for measuring
+ * how the engine scales. The same parameters and seed always produce the same
+ * scene. Setting the component again replaces the generated entities.
+ *
+ * Instances are spread across mesh_count sphere, cylinder and cone meshes
+ * with different tessellations. With a hierarchy_depth of N, instances form
+ * chains of N + 1 entities where each entity is the parent of the next.
+ * Moving instances spin with a random angular velocity, so that they stay
+ * within the scene while their world transforms change every frame.
+ * Transparent instances use alpha blended materials. */
+ECS_STRUCT(FlecsStressScene, {
+    uint32_t seed;
+    int32_t instance_count;
+    int32_t mesh_count;         /* 0 is the same as 1 */
+    int32_t hierarchy_depth;    /* Parents above the deepest instances */
+    float moving_fraction;      /* 0..1 */
+    float transparent_fraction; /* 0..1 */
+    int32_t material_count;     /* Shared materials, 0 for per-instance colors */
+    int32_t point_light_count;
+    int32_t spot_light_count;
+    float extent;               /* Half size of the scene, 0 to scale with
+                                 * the instance count */
+    ecs_entity_t camera;        /* If set, placed so that it sees the scene */
+});
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef FLECS_ENGINE_TRACE_H
+#define FLECS_ENGINE_TRACE_H
+
+/* Singleton that records engine events (systems, frame stages, asset loads,
+ * pipeline creation) into a ring buffer. The trace is written as Chrome Trace
+ * Event JSON, which can be loaded in Perfetto or chrome://tracing. */
+typedef struct {
+    bool enabled;
+    int32_t capacity;  /* Events in the ring buffer, 0 for the default */
+    const char *path;  /* Written when the singleton is removed */
+    bool dump;         /* Set to write the trace to path now */
+} FlecsTrace;
+
+extern ECS_COMPONENT_DECLARE(FlecsTrace);
+
+/* Write the events in the ring buffer to path. */
+int flecsEngine_trace_dump(
+    const char *path);
+
+#endif
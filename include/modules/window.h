@@ -12,6 +12,8 @@ ECS_STRUCT(FlecsWindow, {
     int32_t resolution_scale;
     bool msaa;
     bool vsync;
+    bool render_thread;
+    int32_t frames_in_flight;
     const char *title;
 });
 
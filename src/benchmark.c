@@ -0,0 +1,525 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "private.h"
+
+ECS_COMPONENT_DECLARE(FlecsBenchmark);
+
+#define FLECS_ENGINE_BENCHMARK_FRAME_COUNT_DEFAULT (600)
+
+/* Frames rendered after the measured frames, so that GPU timings of the last
+ * measured frames can be read back */
+#define FLECS_ENGINE_BENCHMARK_DRAIN_FRAMES (8)
+
+#define FLECS_ENGINE_BENCHMARK_CPU_STAGE_COUNT (10)
+#define FLECS_ENGINE_BENCHMARK_GPU_PASS_COUNT (4)
+#define FLECS_ENGINE_BENCHMARK_COUNTER_COUNT (11)
+
+typedef struct {
+    const char *name;
+    size_t offset;
+    bool is_i64;      /* Counter is an int64_t, otherwise an int32_t */
+} flecs_engine_benchmark_field_t;
+
+/* Members of FlecsCpuFrameStats in the report */
+static const flecs_engine_benchmark_field_t
+flecs_engine_benchmark_cpu_stages[FLECS_ENGINE_BENCHMARK_CPU_STAGE_COUNT] = {
+    { "frustum", offsetof(FlecsCpuFrameStats, frustum) },
+    { "batch_extract", offsetof(FlecsCpuFrameStats, batch_extract) },
+    { "lights", offsetof(FlecsCpuFrameStats, lights) },
+    { "cluster", offsetof(FlecsCpuFrameStats, cluster) },
+    { "shadow", offsetof(FlecsCpuFrameStats, shadow) },
+    { "batches", offsetof(FlecsCpuFrameStats, batches) },
+    { "effects", offsetof(FlecsCpuFrameStats, effects) },
+    { "submit", offsetof(FlecsCpuFrameStats, submit) },
+    { "acquire", offsetof(FlecsCpuFrameStats, acquire) },
+    { "total", offsetof(FlecsCpuFrameStats, total) }
+};
+
+/* Members of FlecsRenderViewGpuTime in the report */
+static const flecs_engine_benchmark_field_t
+flecs_engine_benchmark_gpu_passes[FLECS_ENGINE_BENCHMARK_GPU_PASS_COUNT] = {
+    { "shadow", offsetof(FlecsRenderViewGpuTime, shadow_time) },
+    { "batch", offsetof(FlecsRenderViewGpuTime, batch_time) },
+    { "effect", offsetof(FlecsRenderViewGpuTime, effect_time) },
+    { "total", offsetof(FlecsRenderViewGpuTime, total_time) }
+};
+
+/* Members of FlecsRenderViewStats in the report, summed over views */
+static const flecs_engine_benchmark_field_t
+flecs_engine_benchmark_counters[FLECS_ENGINE_BENCHMARK_COUNTER_COUNT] = {
+    { "draw_count", offsetof(FlecsRenderViewStats, draw_count) },
+    { "instance_count", offsetof(FlecsRenderViewStats, instance_count), true },
+    { "triangle_count", offsetof(FlecsRenderViewStats, triangle_count), true },
+    { "pipeline_switch_count",
+        offsetof(FlecsRenderViewStats, pipeline_switch_count) },
+    { "bind_group_switch_count",
+        offsetof(FlecsRenderViewStats, bind_group_switch_count) },
+    { "buffer_create_count",
+        offsetof(FlecsRenderViewStats, buffer_create_count) },
+    { "texture_create_count",
+        offsetof(FlecsRenderViewStats, texture_create_count) },
+    { "write_count", offsetof(FlecsRenderViewStats, write_count) },
+    { "write_bytes", offsetof(FlecsRenderViewStats, write_bytes), true },
+    { "visible_instance_count",
+        offsetof(FlecsRenderViewStats, visible_instance_count) },
+    { "culled_instance_count",
+        offsetof(FlecsRenderViewStats, culled_instance_count) }
+};
+
+typedef struct {
+    float frame_time;  /* Wall clock time until the next frame started */
+    bool has_cpu;      /* CPU timing was published for the frame */
+    float cpu[FLECS_ENGINE_BENCHMARK_CPU_STAGE_COUNT];
+    int64_t counters[FLECS_ENGINE_BENCHMARK_COUNTER_COUNT];
+} flecs_engine_benchmark_frame_t;
+
+typedef struct {
+    float time[FLECS_ENGINE_BENCHMARK_GPU_PASS_COUNT];
+} flecs_engine_benchmark_gpu_t;
+
+typedef struct {
+    bool running;
+    int32_t frame;           /* Frames since the benchmark started */
+    uint64_t frame_start;    /* Time the previous frame started */
+    int32_t warmup_frames;
+    int32_t frame_count;
+    flecs_engine_benchmark_frame_t *frames;
+    int32_t sample_count;
+    flecs_engine_benchmark_gpu_t *gpu;
+    int32_t gpu_sample_count;
+    int64_t gpu_frame;       /* Last GPU frame that was seen */
+    bool camera_init;
+    bool camera_valid;
+    vec3 camera_start;
+    vec3 camera_target;
+} flecs_engine_benchmark_t;
+
+static flecs_engine_benchmark_t flecs_engine_benchmark;
+
+void flecsEngine_benchmark_cameraPath(
+    const vec3 start,
+    const vec3 target,
+    float t,
+    vec3 out)
+{
+    float angle = t * 2.0f * (float)GLM_PI;
+    float c = cosf(angle), s = sinf(angle);
+    float x = start[0] - target[0];
+    float z = start[2] - target[2];
+
+    out[0] = target[0] + x * c - z * s;
+    out[1] = start[1];
+    out[2] = target[2] + x * s + z * c;
+}
+
+static void flecsEngine_benchmark_stop(void)
+{
+    flecs_engine_benchmark_t *bench = &flecs_engine_benchmark;
+    ecs_os_free(bench->frames);
+    ecs_os_free(bench->gpu);
+    ecs_os_zeromem(bench);
+}
+
+static void flecsEngine_benchmark_start(
+    const FlecsBenchmark *settings)
+{
+    flecsEngine_benchmark_stop();
+
+    flecs_engine_benchmark_t *bench = &flecs_engine_benchmark;
+    bench->running = true;
+    bench->warmup_frames =
+        settings->warmup_frames > 0 ? settings->warmup_frames : 0;
+    bench->frame_count = settings->frame_count > 0
+        ? settings->frame_count
+        : FLECS_ENGINE_BENCHMARK_FRAME_COUNT_DEFAULT;
+    bench->frames = ecs_os_calloc_n(
+        flecs_engine_benchmark_frame_t, bench->frame_count);
+    bench->gpu = ecs_os_calloc_n(
+        flecs_engine_benchmark_gpu_t, bench->frame_count);
+    bench->gpu_frame = -1;
+}
+
+static void flecsEngine_benchmark_sampleFrame(
+    ecs_world_t *world,
+    flecs_engine_benchmark_frame_t *frame,
+    uint64_t elapsed)
+{
+    frame->frame_time = (float)((double)elapsed * 1e-9);
+
+    const FlecsCpuFrameStats *cpu = ecs_singleton_get(
+        world, FlecsCpuFrameStats);
+    if (cpu) {
+        frame->has_cpu = true;
+        for (int32_t s = 0; s < FLECS_ENGINE_BENCHMARK_CPU_STAGE_COUNT; s ++) {
+            const FlecsCpuStageTime *stage = ECS_OFFSET(
+                cpu, flecs_engine_benchmark_cpu_stages[s].offset);
+            frame->cpu[s] = stage->last;
+        }
+    }
+
+    const FlecsEngineImpl *engine = ecs_singleton_get(world, FlecsEngineImpl);
+    if (!engine || !engine->view_query) {
+        return;
+    }
+
+    ecs_iter_t it = ecs_query_iter(world, engine->view_query);
+    while (ecs_query_next(&it)) {
+        for (int32_t i = 0; i < it.count; i ++) {
+            const FlecsRenderViewStats *stats = ecs_get(
+                world, it.entities[i], FlecsRenderViewStats);
+            if (!stats) {
+                continue;
+            }
+
+            for (int32_t c = 0; c < FLECS_ENGINE_BENCHMARK_COUNTER_COUNT; c ++) {
+                const flecs_engine_benchmark_field_t *field =
+                    &flecs_engine_benchmark_counters[c];
+                const void *ptr = ECS_OFFSET(stats, field->offset);
+                frame->counters[c] += field->is_i64
+                    ? *(const int64_t*)ptr
+                    : *(const int32_t*)ptr;
+            }
+        }
+    }
+}
+
+/* GPU timings arrive a few frames after they were recorded, and frames are
+ * skipped when all readbacks are in use. Sample each frame that is published,
+ * summed over the views that rendered it. */
+static void flecsEngine_benchmark_sampleGpu(
+    ecs_world_t *world,
+    bool record)
+{
+    flecs_engine_benchmark_t *bench = &flecs_engine_benchmark;
+    const FlecsEngineImpl *engine = ecs_singleton_get(world, FlecsEngineImpl);
+    if (!engine || !engine->view_query) {
+        return;
+    }
+
+    flecs_engine_benchmark_gpu_t sample = {0};
+    int64_t latest = -1;
+
+    ecs_iter_t it = ecs_query_iter(world, engine->view_query);
+    while (ecs_query_next(&it)) {
+        for (int32_t i = 0; i < it.count; i ++) {
+            const FlecsRenderViewGpuTime *time = ecs_get(
+                world, it.entities[i], FlecsRenderViewGpuTime);
+            if (!time || time->frame < latest) {
+                continue;
+            }
+
+            if (time->frame > latest) {
+                latest = time->frame;
+                ecs_os_zeromem(&sample);
+            }
+
+            for (int32_t p = 0; p < FLECS_ENGINE_BENCHMARK_GPU_PASS_COUNT; p ++) {
+                sample.time[p] += *(const float*)ECS_OFFSET(
+                    time, flecs_engine_benchmark_gpu_passes[p].offset);
+            }
+        }
+    }
+
+    if (latest <= bench->gpu_frame) {
+        return;
+    }
+
+    bench->gpu_frame = latest;
+    if (record && bench->gpu_sample_count < bench->frame_count) {
+        bench->gpu[bench->gpu_sample_count ++] = sample;
+    }
+}
+
+static void flecsEngine_benchmark_moveCamera(
+    ecs_world_t *world,
+    ecs_entity_t camera)
+{
+    flecs_engine_benchmark_t *bench = &flecs_engine_benchmark;
+
+    /* The path starts where the scene placed the camera */
+    if (!bench->camera_init) {
+        bench->camera_init = true;
+
+        const FlecsPosition3 *p = ecs_get(world, camera, FlecsPosition3);
+        const FlecsLookAt *target = ecs_get(world, camera, FlecsLookAt);
+        if (!p || !target) {
+            ecs_warn("benchmark: camera needs Position3 and LookAt");
+            return;
+        }
+
+        glm_vec3_copy((float*)p, bench->camera_start);
+        glm_vec3_copy((float*)target, bench->camera_target);
+        bench->camera_valid = true;
+    }
+
+    if (!bench->camera_valid) {
+        return;
+    }
+
+    float t = (float)(bench->frame - bench->warmup_frames) /
+        (float)bench->frame_count;
+    t = glm_clamp(t, 0.0f, 1.0f);
+
+    vec3 pos;
+    flecsEngine_benchmark_cameraPath(
+        bench->camera_start, bench->camera_target, t, pos);
+    ecs_set(world, camera, FlecsPosition3, {pos[0], pos[1], pos[2]});
+}
+
+static int flecsEngine_benchmark_compare(
+    const void *a,
+    const void *b)
+{
+    float fa = *(const float*)a, fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+/* Write statistics of times in seconds as milliseconds. Sorts samples. */
+static void flecsEngine_benchmark_writeTimes(
+    FILE *file,
+    float *samples,
+    int32_t count)
+{
+    if (!count) {
+        fprintf(file, "null");
+        return;
+    }
+
+    qsort(samples, (size_t)count, sizeof(float), flecsEngine_benchmark_compare);
+
+    double sum = 0;
+    for (int32_t i = 0; i < count; i ++) {
+        sum += samples[i];
+    }
+
+    /* Nearest rank percentiles */
+    fprintf(file,
+        "{\"avg\":%.4f,\"min\":%.4f,\"p50\":%.4f,\"p95\":%.4f,"
+        "\"p99\":%.4f,\"max\":%.4f}",
+        sum / count * 1000.0,
+        samples[0] * 1000.0,
+        samples[(count - 1) * 50 / 100] * 1000.0,
+        samples[(count - 1) * 95 / 100] * 1000.0,
+        samples[(count - 1) * 99 / 100] * 1000.0,
+        samples[count - 1] * 1000.0);
+}
+
+static int flecsEngine_benchmark_writeReport(
+    ecs_world_t *world,
+    const FlecsBenchmark *settings)
+{
+    const flecs_engine_benchmark_t *bench = &flecs_engine_benchmark;
+    const char *path = settings->path;
+
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        ecs_err("benchmark: failed to open '%s'", path);
+        return -1;
+    }
+
+    int32_t count = bench->sample_count;
+    float *values = ecs_os_malloc_n(float, bench->frame_count);
+
+    fprintf(file, "{\n  \"scene\": ");
+    flecsEngine_writeJsonString(file,
+        settings->scene ? settings->scene : "");
+
+    const FlecsEngineImpl *engine = ecs_singleton_get(world, FlecsEngineImpl);
+    if (engine && engine->adapter) {
+        char name[256];
+        const char *type = flecsEngine_describeAdapter(
+            engine->adapter, name, sizeof(name));
+        fprintf(file, ",\n  \"adapter\": {\"name\": ");
+        flecsEngine_writeJsonString(file, name);
+        fprintf(file, ", \"type\": \"%s\"}", type);
+        fprintf(file, ",\n  \"width\": %d,\n  \"height\": %d",
+            engine->width, engine->height);
+    }
+
+    fprintf(file, ",\n  \"warmup_frames\": %d", bench->warmup_frames);
+    fprintf(file, ",\n  \"frame_count\": %d", count);
+    fprintf(file, ",\n  \"unit\": \"ms\"");
+
+    for (int32_t i = 0; i < count; i ++) {
+        values[i] = bench->frames[i].frame_time;
+    }
+    fprintf(file, ",\n  \"frame_time\": ");
+    flecsEngine_benchmark_writeTimes(file, values, count);
+
+    int32_t cpu_count = 0;
+    for (int32_t i = 0; i < count; i ++) {
+        cpu_count += bench->frames[i].has_cpu;
+    }
+
+    fprintf(file, ",\n  \"cpu\": {\n    \"sample_count\": %d", cpu_count);
+    for (int32_t s = 0; s < FLECS_ENGINE_BENCHMARK_CPU_STAGE_COUNT; s ++) {
+        int32_t n = 0;
+        for (int32_t i = 0; i < count; i ++) {
+            if (bench->frames[i].has_cpu) {
+                values[n ++] = bench->frames[i].cpu[s];
+            }
+        }
+
+        fprintf(file, ",\n    \"%s\": ",
+            flecs_engine_benchmark_cpu_stages[s].name);
+        flecsEngine_benchmark_writeTimes(file, values, n);
+    }
+    fprintf(file, "\n  }");
+
+    int32_t gpu_count = bench->gpu_sample_count;
+    fprintf(file, ",\n  \"gpu\": {\n    \"sample_count\": %d", gpu_count);
+    for (int32_t p = 0; p < FLECS_ENGINE_BENCHMARK_GPU_PASS_COUNT; p ++) {
+        for (int32_t i = 0; i < gpu_count; i ++) {
+            values[i] = bench->gpu[i].time[p];
+        }
+
+        fprintf(file, ",\n    \"%s\": ",
+            flecs_engine_benchmark_gpu_passes[p].name);
+        flecsEngine_benchmark_writeTimes(file, values, gpu_count);
+    }
+    fprintf(file, "\n  }");
+
+    fprintf(file, ",\n  \"counters\": {");
+    for (int32_t c = 0; c < FLECS_ENGINE_BENCHMARK_COUNTER_COUNT; c ++) {
+        int64_t total = 0, max = 0;
+        for (int32_t i = 0; i < count; i ++) {
+            int64_t value = bench->frames[i].counters[c];
+            total += value;
+            if (value > max) {
+                max = value;
+            }
+        }
+
+        fprintf(file, "%s\n    \"%s\": {\"avg\":%.2f,\"max\":%lld,"
+            "\"total\":%lld}", c ? "," : "",
+            flecs_engine_benchmark_counters[c].name,
+            count ? (double)total / count : 0.0,
+            (long long)max, (long long)total);
+    }
+    fprintf(file, "\n  }");
+
+    const FlecsGpuMemory *memory = ecs_singleton_get(world, FlecsGpuMemory);
+    if (memory) {
+        fprintf(file, ",\n  \"gpu_memory\": {\"total\": %lld, "
+            "\"peak_total\": %lld}",
+            (long long)memory->total, (long long)memory->peak_total);
+    }
+
+    fprintf(file, "\n}\n");
+
+    ecs_os_free(values);
+
+    bool ok = !ferror(file);
+    if (fclose(file) || !ok) {
+        ecs_err("benchmark: failed to write '%s'", path);
+        return -1;
+    }
+
+    ecs_trace("benchmark: wrote %d frames to '%s'", count, path);
+    return 0;
+}
+
+static void FlecsEngineBenchmark(
+    ecs_iter_t *it)
+{
+    flecs_engine_benchmark_t *bench = &flecs_engine_benchmark;
+    if (!bench->running) {
+        return;
+    }
+
+    const FlecsBenchmark *settings = ecs_field(it, FlecsBenchmark, 0);
+    uint64_t now = ecs_os_now();
+
+    /* A frame ends when the next one starts. Stats read here were published
+     * by the frame that just ended. */
+    int32_t measured = bench->frame - bench->warmup_frames - 1;
+    if (measured >= 0 && measured < bench->frame_count) {
+        flecsEngine_benchmark_sampleFrame(
+            it->world, &bench->frames[measured], now - bench->frame_start);
+        bench->sample_count = measured + 1;
+    }
+
+    /* Timings published during warmup are skipped */
+    flecsEngine_benchmark_sampleGpu(it->world, measured >= 0);
+
+    int32_t last = bench->frame_count - 1;
+    if (measured >= last && (bench->gpu_sample_count == bench->frame_count ||
+        measured >= last + FLECS_ENGINE_BENCHMARK_DRAIN_FRAMES))
+    {
+        if (settings->path) {
+            flecsEngine_benchmark_writeReport(it->world, settings);
+        } else {
+            ecs_err("benchmark: finished without a report path");
+        }
+
+        bench->running = false;
+        ecs_quit(it->world);
+        return;
+    }
+
+    if (settings->camera) {
+        flecsEngine_benchmark_moveCamera(it->world, settings->camera);
+    }
+
+    bench->frame ++;
+    bench->frame_start = now;
+}
+
+static void flecsEngine_benchmark_onSet(
+    ecs_iter_t *it)
+{
+    FlecsBenchmark *settings = ecs_field(it, FlecsBenchmark, 0);
+    for (int32_t i = 0; i < it->count; i ++) {
+        flecsEngine_benchmark_start(&settings[i]);
+    }
+
+    ecs_singleton_set(it->world, FlecsCpuTiming, { .enabled = true });
+    ecs_singleton_set(it->world, FlecsGpuTiming, { .enabled = true });
+}
+
+static void flecsEngine_benchmark_onRemove(
+    ecs_iter_t *it)
+{
+    (void)it;
+    flecsEngine_benchmark_stop();
+}
+
+void flecsEngine_benchmark_register(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, FlecsBenchmark);
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsBenchmark),
+        .members = {
+            { .name = "warmup_frames", .type = ecs_id(ecs_i32_t) },
+            { .name = "frame_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "camera", .type = ecs_id(ecs_entity_t) },
+            { .name = "scene", .type = ecs_id(ecs_string_t) },
+            { .name = "path", .type = ecs_id(ecs_string_t) }
+        }
+    });
+
+    ecs_set_hooks(world, FlecsBenchmark, {
+        .on_set = flecsEngine_benchmark_onSet,
+        .on_remove = flecsEngine_benchmark_onRemove
+    });
+
+    ecs_add_id(world, ecs_id(FlecsBenchmark), EcsSingleton);
+
+    /* Runs first, so that the camera is moved before transforms are computed
+     * and timing of the frame includes all systems */
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "BenchmarkFrame" }),
+        .phase = EcsOnLoad,
+        .query.terms = {{
+            .id = ecs_id(FlecsBenchmark),
+            .src.id = ecs_id(FlecsBenchmark),
+            .inout = EcsIn
+        }},
+        .callback = FlecsEngineBenchmark
+    });
+}
@@ -0,0 +1,22 @@
+/* Benchmark of frames, configured with the FlecsBenchmark singleton.
+ *
+ * Samples are recorded in process wide state, like the trace.
+ */
+
+#ifndef FLECS_ENGINE_BENCHMARK_IMPL
+#define FLECS_ENGINE_BENCHMARK_IMPL
+
+#include "types.h"
+
+/* Position of a camera that orbits target around the Y axis, at fraction t of
+ * the orbit. start is the position at t = 0. */
+void flecsEngine_benchmark_cameraPath(
+    const vec3 start,
+    const vec3 target,
+    float t,
+    vec3 out);
+
+void flecsEngine_benchmark_register(
+    ecs_world_t *world);
+
+#endif
@@ -0,0 +1,62 @@
+#include "private.h"
+
+#ifndef __EMSCRIPTEN__
+
+/* The names below aren't followed by arguments, so they aren't replaced by
+ * the dispatch macros and refer to the functions of wgpu-native. */
+#define FLECS_ENGINE_WGPU_PROC_NATIVE(ret, name, params) .name = wgpu##name,
+
+static const flecs_engine_wgpu_procs_t flecsEngineNativeGpuProcs = {
+    FLECS_ENGINE_WGPU_PROCS(FLECS_ENGINE_WGPU_PROC_NATIVE)
+};
+
+#undef FLECS_ENGINE_WGPU_PROC_NATIVE
+
+const flecs_engine_wgpu_procs_t *flecs_engine_wgpu = &flecsEngineNativeGpuProcs;
+
+int flecsEngine_gpuBackend_select(
+    flecs_engine_gpu_backend_t backend)
+{
+    if (backend == FlecsGpuBackendNull) {
+        flecs_engine_wgpu = &flecsEngineNullGpuProcs;
+    } else {
+        flecs_engine_wgpu = &flecsEngineNativeGpuProcs;
+    }
+    return 0;
+}
+
+flecs_engine_gpu_backend_t flecsEngine_gpuBackend_get(void)
+{
+    if (flecs_engine_wgpu == &flecsEngineNullGpuProcs) {
+        return FlecsGpuBackendNull;
+    }
+    return FlecsGpuBackendNative;
+}
+
+#else
+
+int flecsEngine_gpuBackend_select(
+    flecs_engine_gpu_backend_t backend)
+{
+    if (backend == FlecsGpuBackendNull) {
+        ecs_err("the null GPU backend is not available on emscripten\n");
+        return -1;
+    }
+    return 0;
+}
+
+flecs_engine_gpu_backend_t flecsEngine_gpuBackend_get(void)
+{
+    return FlecsGpuBackendNative;
+}
+
+bool flecsEngine_nullGpu_takeCounters(
+    WGPUInstance instance,
+    flecs_engine_gpu_command_counters_t *counters)
+{
+    (void)instance;
+    (void)counters;
+    return false;
+}
+
+#endif
@@ -0,0 +1,388 @@
+/* Selection of the WebGPU implementation.
+ *
+ * On native builds the wgpu* functions used by the renderer are called
+ * through a table, so that the engine can run on wgpu-native or on the null
+ * backend in null_gpu.c. The null backend keeps buffers and textures in CPU
+ * memory and records commands without executing draws, so that the frame
+ * loop runs headless on machines without a GPU.
+ *
+ * Functions that are only used to present to a window surface are not part
+ * of the table, as the null backend only renders offscreen. On emscripten
+ * the browser implementation is always used.
+ */
+
+#ifndef FLECS_ENGINE_GPU_BACKEND_H
+#define FLECS_ENGINE_GPU_BACKEND_H
+
+typedef enum {
+    FlecsGpuBackendNative,
+    FlecsGpuBackendNull
+} flecs_engine_gpu_backend_t;
+
+/* Commands executed by the null backend since the counters were last taken.
+ * Counts only depend on what the engine encodes, not on timing. */
+typedef struct {
+    int32_t submit_count;
+    int32_t command_buffer_count;
+    int32_t render_pass_count;
+    int32_t compute_pass_count;
+    int32_t draw_count;
+    int32_t draw_indexed_count;
+    int32_t dispatch_count;
+    int32_t pipeline_set_count;
+    int32_t bind_group_set_count;
+    int32_t vertex_buffer_set_count;
+    int32_t index_buffer_set_count;
+    int32_t copy_count;
+    int32_t write_buffer_count;
+    int64_t write_buffer_bytes;
+    int32_t write_texture_count;
+    int64_t write_texture_bytes;
+    uint64_t command_hash; /* Of submitted commands, depends on their order */
+} flecs_engine_gpu_command_counters_t;
+
+/* Select the implementation used by wgpu* calls. Must be called while no
+ * WebGPU objects exist. Returns -1 if the backend isn't available. */
+int flecsEngine_gpuBackend_select(
+    flecs_engine_gpu_backend_t backend);
+
+flecs_engine_gpu_backend_t flecsEngine_gpuBackend_get(void);
+
+/* Copy the command counters of the null backend to counters and reset them.
+ * Returns false if the null backend isn't selected. */
+bool flecsEngine_nullGpu_takeCounters(
+    WGPUInstance instance,
+    flecs_engine_gpu_command_counters_t *counters);
+
+#ifndef __EMSCRIPTEN__
+
+/* X(return type, name without wgpu prefix, parameter list) */
+#define FLECS_ENGINE_WGPU_PROCS(X) \
+    X(WGPUInstance, CreateInstance, \
+        (WGPUInstanceDescriptor const *descriptor)) \
+    X(void, InstanceProcessEvents, (WGPUInstance instance)) \
+    X(WGPUFuture, InstanceRequestAdapter, \
+        (WGPUInstance instance, WGPURequestAdapterOptions const *options, \
+         WGPURequestAdapterCallbackInfo callbackInfo)) \
+    X(WGPUWaitStatus, InstanceWaitAny, \
+        (WGPUInstance instance, size_t futureCount, \
+         WGPUFutureWaitInfo *futures, uint64_t timeoutNS)) \
+    X(void, InstanceRelease, (WGPUInstance instance)) \
+    X(WGPUFuture, AdapterRequestDevice, \
+        (WGPUAdapter adapter, WGPUDeviceDescriptor const *descriptor, \
+         WGPURequestDeviceCallbackInfo callbackInfo)) \
+    X(WGPUBool, AdapterHasFeature, \
+        (WGPUAdapter adapter, WGPUFeatureName feature)) \
+    X(WGPUStatus, AdapterGetInfo, \
+        (WGPUAdapter adapter, WGPUAdapterInfo *info)) \
+    X(void, AdapterInfoFreeMembers, (WGPUAdapterInfo adapterInfo)) \
+    X(void, AdapterRelease, (WGPUAdapter adapter)) \
+    X(WGPUBindGroup, DeviceCreateBindGroup, \
+        (WGPUDevice device, WGPUBindGroupDescriptor const *descriptor)) \
+    X(WGPUBindGroupLayout, DeviceCreateBindGroupLayout, \
+        (WGPUDevice device, WGPUBindGroupLayoutDescriptor const *descriptor)) \
+    X(WGPUBuffer, DeviceCreateBuffer, \
+        (WGPUDevice device, WGPUBufferDescriptor const *descriptor)) \
+    X(WGPUCommandEncoder, DeviceCreateCommandEncoder, \
+        (WGPUDevice device, WGPUCommandEncoderDescriptor const *descriptor)) \
+    X(WGPUComputePipeline, DeviceCreateComputePipeline, \
+        (WGPUDevice device, WGPUComputePipelineDescriptor const *descriptor)) \
+    X(WGPUPipelineLayout, DeviceCreatePipelineLayout, \
+        (WGPUDevice device, WGPUPipelineLayoutDescriptor const *descriptor)) \
+    X(WGPUQuerySet, DeviceCreateQuerySet, \
+        (WGPUDevice device, WGPUQuerySetDescriptor const *descriptor)) \
+    X(WGPURenderPipeline, DeviceCreateRenderPipeline, \
+        (WGPUDevice device, WGPURenderPipelineDescriptor const *descriptor)) \
+    X(WGPUSampler, DeviceCreateSampler, \
+        (WGPUDevice device, WGPUSamplerDescriptor const *descriptor)) \
+    X(WGPUShaderModule, DeviceCreateShaderModule, \
+        (WGPUDevice device, WGPUShaderModuleDescriptor const *descriptor)) \
+    X(WGPUTexture, DeviceCreateTexture, \
+        (WGPUDevice device, WGPUTextureDescriptor const *descriptor)) \
+    X(WGPUQueue, DeviceGetQueue, (WGPUDevice device)) \
+    X(WGPUBool, DeviceHasFeature, \
+        (WGPUDevice device, WGPUFeatureName feature)) \
+    X(void, DeviceRelease, (WGPUDevice device)) \
+    X(void, QueueSubmit, \
+        (WGPUQueue queue, size_t commandCount, \
+         WGPUCommandBuffer const *commands)) \
+    X(void, QueueWriteBuffer, \
+        (WGPUQueue queue, WGPUBuffer buffer, uint64_t bufferOffset, \
+         void const *data, size_t size)) \
+    X(void, QueueWriteTexture, \
+        (WGPUQueue queue, WGPUTexelCopyTextureInfo const *destination, \
+         void const *data, size_t dataSize, \
+         WGPUTexelCopyBufferLayout const *dataLayout, \
+         WGPUExtent3D const *writeSize)) \
+    X(WGPUFuture, QueueOnSubmittedWorkDone, \
+        (WGPUQueue queue, WGPUQueueWorkDoneCallbackInfo callbackInfo)) \
+    X(void, QueueRelease, (WGPUQueue queue)) \
+    X(WGPUFuture, BufferMapAsync, \
+        (WGPUBuffer buffer, WGPUMapMode mode, size_t offset, size_t size, \
+         WGPUBufferMapCallbackInfo callbackInfo)) \
+    X(void const*, BufferGetConstMappedRange, \
+        (WGPUBuffer buffer, size_t offset, size_t size)) \
+    X(uint64_t, BufferGetSize, (WGPUBuffer buffer)) \
+    X(void, BufferUnmap, (WGPUBuffer buffer)) \
+    X(void, BufferAddRef, (WGPUBuffer buffer)) \
+    X(void, BufferRelease, (WGPUBuffer buffer)) \
+    X(WGPUTextureView, TextureCreateView, \
+        (WGPUTexture texture, WGPUTextureViewDescriptor const *descriptor)) \
+    X(uint32_t, TextureGetWidth, (WGPUTexture texture)) \
+    X(uint32_t, TextureGetHeight, (WGPUTexture texture)) \
+    X(uint32_t, TextureGetDepthOrArrayLayers, (WGPUTexture texture)) \
+    X(uint32_t, TextureGetMipLevelCount, (WGPUTexture texture)) \
+    X(uint32_t, TextureGetSampleCount, (WGPUTexture texture)) \
+    X(WGPUTextureFormat, TextureGetFormat, (WGPUTexture texture)) \
+    X(WGPUTextureDimension, TextureGetDimension, (WGPUTexture texture)) \
+    X(void, TextureRelease, (WGPUTexture texture)) \
+    X(void, TextureViewRelease, (WGPUTextureView textureView)) \
+    X(WGPURenderPassEncoder, CommandEncoderBeginRenderPass, \
+        (WGPUCommandEncoder commandEncoder, \
+         WGPURenderPassDescriptor const *descriptor)) \
+    X(WGPUComputePassEncoder, CommandEncoderBeginComputePass, \
+        (WGPUCommandEncoder commandEncoder, \
+         WGPUComputePassDescriptor const *descriptor)) \
+    X(void, CommandEncoderCopyBufferToBuffer, \
+        (WGPUCommandEncoder commandEncoder, WGPUBuffer source, \
+         uint64_t sourceOffset, WGPUBuffer destination, \
+         uint64_t destinationOffset, uint64_t size)) \
+    X(void, CommandEncoderCopyTextureToBuffer, \
+        (WGPUCommandEncoder commandEncoder, \
+         WGPUTexelCopyTextureInfo const *source, \
+         WGPUTexelCopyBufferInfo const *destination, \
+         WGPUExtent3D const *copySize)) \
+    X(WGPUCommandBuffer, CommandEncoderFinish, \
+        (WGPUCommandEncoder commandEncoder, \
+         WGPUCommandBufferDescriptor const *descriptor)) \
+    X(void, CommandEncoderResolveQuerySet, \
+        (WGPUCommandEncoder commandEncoder, WGPUQuerySet querySet, \
+         uint32_t firstQuery, uint32_t queryCount, WGPUBuffer destination, \
+         uint64_t destinationOffset)) \
+    X(void, CommandEncoderRelease, (WGPUCommandEncoder commandEncoder)) \
+    X(void, CommandBufferRelease, (WGPUCommandBuffer commandBuffer)) \
+    X(void, RenderPassEncoderSetPipeline, \
+        (WGPURenderPassEncoder renderPassEncoder, \
+         WGPURenderPipeline pipeline)) \
+    X(void, RenderPassEncoderSetBindGroup, \
+        (WGPURenderPassEncoder renderPassEncoder, uint32_t groupIndex, \
+         WGPUBindGroup group, size_t dynamicOffsetCount, \
+         uint32_t const *dynamicOffsets)) \
+    X(void, RenderPassEncoderSetVertexBuffer, \
+        (WGPURenderPassEncoder renderPassEncoder, uint32_t slot, \
+         WGPUBuffer buffer, uint64_t offset, uint64_t size)) \
+    X(void, RenderPassEncoderSetIndexBuffer, \
+        (WGPURenderPassEncoder renderPassEncoder, WGPUBuffer buffer, \
+         WGPUIndexFormat format, uint64_t offset, uint64_t size)) \
+    X(void, RenderPassEncoderSetViewport, \
+        (WGPURenderPassEncoder renderPassEncoder, float x, float y, \
+         float width, float height, float minDepth, float maxDepth)) \
+    X(void, RenderPassEncoderSetBlendConstant, \
+        (WGPURenderPassEncoder renderPassEncoder, WGPUColor const *color)) \
+    X(void, RenderPassEncoderDraw, \
+        (WGPURenderPassEncoder renderPassEncoder, uint32_t vertexCount, \
+         uint32_t instanceCount, uint32_t firstVertex, \
+         uint32_t firstInstance)) \
+    X(void, RenderPassEncoderDrawIndexed, \
+        (WGPURenderPassEncoder renderPassEncoder, uint32_t indexCount, \
+         uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, \
+         uint32_t firstInstance)) \
+    X(void, RenderPassEncoderEnd, (WGPURenderPassEncoder renderPassEncoder)) \
+    X(void, RenderPassEncoderRelease, \
+        (WGPURenderPassEncoder renderPassEncoder)) \
+    X(void, ComputePassEncoderSetPipeline, \
+        (WGPUComputePassEncoder computePassEncoder, \
+         WGPUComputePipeline pipeline)) \
+    X(void, ComputePassEncoderSetBindGroup, \
+        (WGPUComputePassEncoder computePassEncoder, uint32_t groupIndex, \
+         WGPUBindGroup group, size_t dynamicOffsetCount, \
+         uint32_t const *dynamicOffsets)) \
+    X(void, ComputePassEncoderDispatchWorkgroups, \
+        (WGPUComputePassEncoder computePassEncoder, \
+         uint32_t workgroupCountX, uint32_t workgroupCountY, \
+         uint32_t workgroupCountZ)) \
+    X(void, ComputePassEncoderEnd, \
+        (WGPUComputePassEncoder computePassEncoder)) \
+    X(void, ComputePassEncoderRelease, \
+        (WGPUComputePassEncoder computePassEncoder)) \
+    X(void, RenderPipelineRelease, (WGPURenderPipeline renderPipeline)) \
+    X(void, ComputePipelineRelease, (WGPUComputePipeline computePipeline)) \
+    X(void, PipelineLayoutRelease, (WGPUPipelineLayout pipelineLayout)) \
+    X(void, BindGroupRelease, (WGPUBindGroup bindGroup)) \
+    X(void, BindGroupLayoutRelease, (WGPUBindGroupLayout bindGroupLayout)) \
+    X(void, SamplerRelease, (WGPUSampler sampler)) \
+    X(void, ShaderModuleRelease, (WGPUShaderModule shaderModule)) \
+    X(void, QuerySetRelease, (WGPUQuerySet querySet))
+
+#define FLECS_ENGINE_WGPU_PROC_MEMBER(ret, name, params) ret (*name) params;
+
+typedef struct {
+    FLECS_ENGINE_WGPU_PROCS(FLECS_ENGINE_WGPU_PROC_MEMBER)
+} flecs_engine_wgpu_procs_t;
+
+#undef FLECS_ENGINE_WGPU_PROC_MEMBER
+
+/* Implementation of the null backend, in null_gpu.c */
+extern const flecs_engine_wgpu_procs_t flecsEngineNullGpuProcs;
+
+/* Table of the selected backend */
+extern const flecs_engine_wgpu_procs_t *flecs_engine_wgpu;
+
+/* Route calls through the table. Only function-like uses are replaced, so
+ * wgpuXxx without arguments still names the function of wgpu-native. */
+#define wgpuCreateInstance(...) \
+    flecs_engine_wgpu->CreateInstance(__VA_ARGS__)
+#define wgpuInstanceProcessEvents(...) \
+    flecs_engine_wgpu->InstanceProcessEvents(__VA_ARGS__)
+#define wgpuInstanceRequestAdapter(...) \
+    flecs_engine_wgpu->InstanceRequestAdapter(__VA_ARGS__)
+#define wgpuInstanceWaitAny(...) \
+    flecs_engine_wgpu->InstanceWaitAny(__VA_ARGS__)
+#define wgpuInstanceRelease(...) \
+    flecs_engine_wgpu->InstanceRelease(__VA_ARGS__)
+#define wgpuAdapterRequestDevice(...) \
+    flecs_engine_wgpu->AdapterRequestDevice(__VA_ARGS__)
+#define wgpuAdapterHasFeature(...) \
+    flecs_engine_wgpu->AdapterHasFeature(__VA_ARGS__)
+#define wgpuAdapterGetInfo(...) \
+    flecs_engine_wgpu->AdapterGetInfo(__VA_ARGS__)
+#define wgpuAdapterInfoFreeMembers(...) \
+    flecs_engine_wgpu->AdapterInfoFreeMembers(__VA_ARGS__)
+#define wgpuAdapterRelease(...) \
+    flecs_engine_wgpu->AdapterRelease(__VA_ARGS__)
+#define wgpuDeviceCreateBindGroup(...) \
+    flecs_engine_wgpu->DeviceCreateBindGroup(__VA_ARGS__)
+#define wgpuDeviceCreateBindGroupLayout(...) \
+    flecs_engine_wgpu->DeviceCreateBindGroupLayout(__VA_ARGS__)
+#define wgpuDeviceCreateBuffer(...) \
+    flecs_engine_wgpu->DeviceCreateBuffer(__VA_ARGS__)
+#define wgpuDeviceCreateCommandEncoder(...) \
+    flecs_engine_wgpu->DeviceCreateCommandEncoder(__VA_ARGS__)
+#define wgpuDeviceCreateComputePipeline(...) \
+    flecs_engine_wgpu->DeviceCreateComputePipeline(__VA_ARGS__)
+#define wgpuDeviceCreatePipelineLayout(...) \
+    flecs_engine_wgpu->DeviceCreatePipelineLayout(__VA_ARGS__)
+#define wgpuDeviceCreateQuerySet(...) \
+    flecs_engine_wgpu->DeviceCreateQuerySet(__VA_ARGS__)
+#define wgpuDeviceCreateRenderPipeline(...) \
+    flecs_engine_wgpu->DeviceCreateRenderPipeline(__VA_ARGS__)
+#define wgpuDeviceCreateSampler(...) \
+    flecs_engine_wgpu->DeviceCreateSampler(__VA_ARGS__)
+#define wgpuDeviceCreateShaderModule(...) \
+    flecs_engine_wgpu->DeviceCreateShaderModule(__VA_ARGS__)
+#define wgpuDeviceCreateTexture(...) \
+    flecs_engine_wgpu->DeviceCreateTexture(__VA_ARGS__)
+#define wgpuDeviceGetQueue(...) \
+    flecs_engine_wgpu->DeviceGetQueue(__VA_ARGS__)
+#define wgpuDeviceHasFeature(...) \
+    flecs_engine_wgpu->DeviceHasFeature(__VA_ARGS__)
+#define wgpuDeviceRelease(...) \
+    flecs_engine_wgpu->DeviceRelease(__VA_ARGS__)
+#define wgpuQueueSubmit(...) \
+    flecs_engine_wgpu->QueueSubmit(__VA_ARGS__)
+#define wgpuQueueWriteBuffer(...) \
+    flecs_engine_wgpu->QueueWriteBuffer(__VA_ARGS__)
+#define wgpuQueueWriteTexture(...) \
+    flecs_engine_wgpu->QueueWriteTexture(__VA_ARGS__)
+#define wgpuQueueOnSubmittedWorkDone(...) \
+    flecs_engine_wgpu->QueueOnSubmittedWorkDone(__VA_ARGS__)
+#define wgpuQueueRelease(...) \
+    flecs_engine_wgpu->QueueRelease(__VA_ARGS__)
+#define wgpuBufferMapAsync(...) \
+    flecs_engine_wgpu->BufferMapAsync(__VA_ARGS__)
+#define wgpuBufferGetConstMappedRange(...) \
+    flecs_engine_wgpu->BufferGetConstMappedRange(__VA_ARGS__)
+#define wgpuBufferGetSize(...) \
+    flecs_engine_wgpu->BufferGetSize(__VA_ARGS__)
+#define wgpuBufferUnmap(...) \
+    flecs_engine_wgpu->BufferUnmap(__VA_ARGS__)
+#define wgpuBufferAddRef(...) \
+    flecs_engine_wgpu->BufferAddRef(__VA_ARGS__)
+#define wgpuBufferRelease(...) \
+    flecs_engine_wgpu->BufferRelease(__VA_ARGS__)
+#define wgpuTextureCreateView(...) \
+    flecs_engine_wgpu->TextureCreateView(__VA_ARGS__)
+#define wgpuTextureGetWidth(...) \
+    flecs_engine_wgpu->TextureGetWidth(__VA_ARGS__)
+#define wgpuTextureGetHeight(...) \
+    flecs_engine_wgpu->TextureGetHeight(__VA_ARGS__)
+#define wgpuTextureGetDepthOrArrayLayers(...) \
+    flecs_engine_wgpu->TextureGetDepthOrArrayLayers(__VA_ARGS__)
+#define wgpuTextureGetMipLevelCount(...) \
+    flecs_engine_wgpu->TextureGetMipLevelCount(__VA_ARGS__)
+#define wgpuTextureGetSampleCount(...) \
+    flecs_engine_wgpu->TextureGetSampleCount(__VA_ARGS__)
+#define wgpuTextureGetFormat(...) \
+    flecs_engine_wgpu->TextureGetFormat(__VA_ARGS__)
+#define wgpuTextureGetDimension(...) \
+    flecs_engine_wgpu->TextureGetDimension(__VA_ARGS__)
+#define wgpuTextureRelease(...) \
+    flecs_engine_wgpu->TextureRelease(__VA_ARGS__)
+#define wgpuTextureViewRelease(...) \
+    flecs_engine_wgpu->TextureViewRelease(__VA_ARGS__)
+#define wgpuCommandEncoderBeginRenderPass(...) \
+    flecs_engine_wgpu->CommandEncoderBeginRenderPass(__VA_ARGS__)
+#define wgpuCommandEncoderBeginComputePass(...) \
+    flecs_engine_wgpu->CommandEncoderBeginComputePass(__VA_ARGS__)
+#define wgpuCommandEncoderCopyBufferToBuffer(...) \
+    flecs_engine_wgpu->CommandEncoderCopyBufferToBuffer(__VA_ARGS__)
+#define wgpuCommandEncoderCopyTextureToBuffer(...) \
+    flecs_engine_wgpu->CommandEncoderCopyTextureToBuffer(__VA_ARGS__)
+#define wgpuCommandEncoderFinish(...) \
+    flecs_engine_wgpu->CommandEncoderFinish(__VA_ARGS__)
+#define wgpuCommandEncoderResolveQuerySet(...) \
+    flecs_engine_wgpu->CommandEncoderResolveQuerySet(__VA_ARGS__)
+#define wgpuCommandEncoderRelease(...) \
+    flecs_engine_wgpu->CommandEncoderRelease(__VA_ARGS__)
+#define wgpuCommandBufferRelease(...) \
+    flecs_engine_wgpu->CommandBufferRelease(__VA_ARGS__)
+#define wgpuRenderPassEncoderSetPipeline(...) \
+    flecs_engine_wgpu->RenderPassEncoderSetPipeline(__VA_ARGS__)
+#define wgpuRenderPassEncoderSetBindGroup(...) \
+    flecs_engine_wgpu->RenderPassEncoderSetBindGroup(__VA_ARGS__)
+#define wgpuRenderPassEncoderSetVertexBuffer(...) \
+    flecs_engine_wgpu->RenderPassEncoderSetVertexBuffer(__VA_ARGS__)
+#define wgpuRenderPassEncoderSetIndexBuffer(...) \
+    flecs_engine_wgpu->RenderPassEncoderSetIndexBuffer(__VA_ARGS__)
+#define wgpuRenderPassEncoderSetViewport(...) \
+    flecs_engine_wgpu->RenderPassEncoderSetViewport(__VA_ARGS__)
+#define wgpuRenderPassEncoderSetBlendConstant(...) \
+    flecs_engine_wgpu->RenderPassEncoderSetBlendConstant(__VA_ARGS__)
+#define wgpuRenderPassEncoderDraw(...) \
+    flecs_engine_wgpu->RenderPassEncoderDraw(__VA_ARGS__)
+#define wgpuRenderPassEncoderDrawIndexed(...) \
+    flecs_engine_wgpu->RenderPassEncoderDrawIndexed(__VA_ARGS__)
+#define wgpuRenderPassEncoderEnd(...) \
+    flecs_engine_wgpu->RenderPassEncoderEnd(__VA_ARGS__)
+#define wgpuRenderPassEncoderRelease(...) \
+    flecs_engine_wgpu->RenderPassEncoderRelease(__VA_ARGS__)
+#define wgpuComputePassEncoderSetPipeline(...) \
+    flecs_engine_wgpu->ComputePassEncoderSetPipeline(__VA_ARGS__)
+#define wgpuComputePassEncoderSetBindGroup(...) \
+    flecs_engine_wgpu->ComputePassEncoderSetBindGroup(__VA_ARGS__)
+#define wgpuComputePassEncoderDispatchWorkgroups(...) \
+    flecs_engine_wgpu->ComputePassEncoderDispatchWorkgroups(__VA_ARGS__)
+#define wgpuComputePassEncoderEnd(...) \
+    flecs_engine_wgpu->ComputePassEncoderEnd(__VA_ARGS__)
+#define wgpuComputePassEncoderRelease(...) \
+    flecs_engine_wgpu->ComputePassEncoderRelease(__VA_ARGS__)
+#define wgpuRenderPipelineRelease(...) \
+    flecs_engine_wgpu->RenderPipelineRelease(__VA_ARGS__)
+#define wgpuComputePipelineRelease(...) \
+    flecs_engine_wgpu->ComputePipelineRelease(__VA_ARGS__)
+#define wgpuPipelineLayoutRelease(...) \
+    flecs_engine_wgpu->PipelineLayoutRelease(__VA_ARGS__)
+#define wgpuBindGroupRelease(...) \
+    flecs_engine_wgpu->BindGroupRelease(__VA_ARGS__)
+#define wgpuBindGroupLayoutRelease(...) \
+    flecs_engine_wgpu->BindGroupLayoutRelease(__VA_ARGS__)
+#define wgpuSamplerRelease(...) \
+    flecs_engine_wgpu->SamplerRelease(__VA_ARGS__)
+#define wgpuShaderModuleRelease(...) \
+    flecs_engine_wgpu->ShaderModuleRelease(__VA_ARGS__)
+#define wgpuQuerySetRelease(...) \
+    flecs_engine_wgpu->QuerySetRelease(__VA_ARGS__)
+
+#endif /* __EMSCRIPTEN__ */
+
+#endif
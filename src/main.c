@@ -14,6 +14,26 @@ typedef struct {
   const char *frame_output_path;
   int32_t width;
   int32_t height;
+  bool render_thread;
+  int32_t frames_in_flight;
+  int32_t dynamic_resolution_ms;
+  bool fxaa;
+  bool taa;
+  bool no_effect_fusion;
+  bool no_target_aliasing;
+  bool packed_targets;
+  bool compute_bloom;
+  bool ssao_temporal;
+  bool gpu_timing;
+  bool cpu_timing;
+  const char *trace_path;
+  const char *benchmark_scene;
+  int32_t benchmark_frames;
+  int32_t benchmark_warmup;
+  const char *benchmark_path;
+  bool software_adapter;
+  bool null_gpu;
+  const char *stress;
 } FlecsAppOptions;
 
 static void flecsPrintUsage(
@@ -21,11 +41,56 @@ static void flecsPrintUsage(
 {
   printf(
     "Usage: %s [--frame-out <file.ppm>] [--width <px>] [--height <px>] [--size <WxH>]\n"
+    "          [--render-thread] [--frames-in-flight <n>] [--dynamic-resolution <ms>]\n"
+    "          [--fxaa] [--taa] [--no-effect-fusion] [--no-target-aliasing]\n"
+    "          [--packed-targets]\n"
+    "          [--compute-bloom] [--ssao-temporal] [--gpu-timing]\n"
+    "          [--cpu-timing] [--trace <file.json>]\n"
+    "          [--benchmark <scene>] [--benchmark-frames <n>]\n"
+    "          [--benchmark-warmup <n>] [--benchmark-out <file.json>]\n"
+    "          [--software-adapter] [--null-gpu] [--stress <json>]\n"
     "\n"
     "  --frame-out <path>  Render one frame to a PPM image, then quit.\n"
     "  --width <px>        Output width (default: 1280).\n"
     "  --height <px>       Output height (default: 800).\n"
     "  --size <WxH>        Set width and height together.\n"
+    "  --render-thread     Submit and present frames from a separate thread.\n"
+    "  --frames-in-flight <n>\n"
+    "                      Frames the CPU may prepare ahead of the GPU (1-3).\n"
+    "  --dynamic-resolution <ms>\n"
+    "                      Scale render resolution to keep frames within budget.\n"
+    "  --fxaa              Post-process anti-aliasing.\n"
+    "  --taa               Temporal anti-aliasing, which also upscales with\n"
+    "                      --dynamic-resolution.\n"
+    "  --no-effect-fusion  Run pointwise effects as separate passes.\n"
+    "  --no-target-aliasing\n"
+    "                      Don't share textures between effect targets.\n"
+    "  --packed-targets    Store effect targets in RG11B10 and RGBA8 formats.\n"
+    "  --compute-bloom     Build the bloom mip chain with compute dispatches.\n"
+    "  --ssao-temporal     Half resolution SSAO with 4 samples per frame,\n"
+    "                      accumulated over frames.\n"
+    "  --gpu-timing        Measure GPU time of passes with timestamp queries.\n"
+    "  --cpu-timing        Measure CPU time of frame stages.\n"
+    "  --trace <path>      Record a Chrome trace of engine events, written on\n"
+    "                      exit. Open it in Perfetto.\n"
+    "  --benchmark <scene>  Render a scene offscreen while the camera orbits,\n"
+    "                      and write a JSON report with frame times and render\n"
+    "                      stats. The scene is a name in etc/assets/scenes\n"
+    "                      (bistro, sponza, ...) or a path to a .flecs file.\n"
+    "  --benchmark-frames <n>\n"
+    "                      Frames to measure (default: 600).\n"
+    "  --benchmark-warmup <n>\n"
+    "                      Frames to render before measuring (default: 60).\n"
+    "  --benchmark-out <path>\n"
+    "                      Report file (default: benchmark.json).\n"
+    "  --software-adapter  Render with a software adapter, for machines\n"
+    "                      without a GPU. Only applies to offscreen rendering.\n"
+    "  --null-gpu          Run offscreen on the null WebGPU backend, which records\n"
+    "                      commands without drawing. For CPU profiling.\n"
+    "  --stress <json>     Generate a synthetic scene. The value sets fields of\n"
+    "                      StressScene, e.g. '{\"instance_count\": 50000}'.\n"
+    "                      Unless a --benchmark scene is given, the scene is\n"
+    "                      generated in an empty scene.\n"
     "  -h, --help          Show this help.\n",
     argv0);
 }
@@ -112,6 +177,138 @@ static int flecsParseArgs(
       continue;
     }
 
+    if (!strcmp(arg, "--frames-in-flight")) {
+      if (i + 1 >= argc || !flecsParsePositiveI32(argv[i + 1], &options->frames_in_flight)) {
+        fprintf(stderr, "Invalid value for --frames-in-flight\n");
+        return -1;
+      }
+      i ++;
+      continue;
+    }
+
+    if (!strcmp(arg, "--dynamic-resolution")) {
+      if (i + 1 >= argc || !flecsParsePositiveI32(argv[i + 1], &options->dynamic_resolution_ms)) {
+        fprintf(stderr, "Invalid value for --dynamic-resolution\n");
+        return -1;
+      }
+      i ++;
+      continue;
+    }
+
+    if (!strcmp(arg, "--render-thread")) {
+      options->render_thread = true;
+      continue;
+    }
+
+    if (!strcmp(arg, "--fxaa")) {
+      options->fxaa = true;
+      continue;
+    }
+
+    if (!strcmp(arg, "--taa")) {
+      options->taa = true;
+      continue;
+    }
+
+    if (!strcmp(arg, "--no-effect-fusion")) {
+      options->no_effect_fusion = true;
+      continue;
+    }
+
+    if (!strcmp(arg, "--no-target-aliasing")) {
+      options->no_target_aliasing = true;
+      continue;
+    }
+
+    if (!strcmp(arg, "--packed-targets")) {
+      options->packed_targets = true;
+      continue;
+    }
+
+    if (!strcmp(arg, "--compute-bloom")) {
+      options->compute_bloom = true;
+      continue;
+    }
+
+    if (!strcmp(arg, "--ssao-temporal")) {
+      options->ssao_temporal = true;
+      continue;
+    }
+
+    if (!strcmp(arg, "--gpu-timing")) {
+      options->gpu_timing = true;
+      continue;
+    }
+
+    if (!strcmp(arg, "--cpu-timing")) {
+      options->cpu_timing = true;
+      continue;
+    }
+
+    if (!strcmp(arg, "--benchmark")) {
+      if (i + 1 >= argc) {
+        fprintf(stderr, "Missing value for --benchmark\n");
+        return -1;
+      }
+      options->benchmark_scene = argv[++ i];
+      continue;
+    }
+
+    if (!strcmp(arg, "--benchmark-frames")) {
+      if (i + 1 >= argc || !flecsParsePositiveI32(argv[i + 1], &options->benchmark_frames)) {
+        fprintf(stderr, "Invalid value for --benchmark-frames\n");
+        return -1;
+      }
+      i ++;
+      continue;
+    }
+
+    if (!strcmp(arg, "--benchmark-warmup")) {
+      if (i + 1 >= argc || !flecsParsePositiveI32(argv[i + 1], &options->benchmark_warmup)) {
+        fprintf(stderr, "Invalid value for --benchmark-warmup\n");
+        return -1;
+      }
+      i ++;
+      continue;
+    }
+
+    if (!strcmp(arg, "--benchmark-out")) {
+      if (i + 1 >= argc) {
+        fprintf(stderr, "Missing value for --benchmark-out\n");
+        return -1;
+      }
+      options->benchmark_path = argv[++ i];
+      continue;
+    }
+
+    if (!strcmp(arg, "--software-adapter")) {
+      options->software_adapter = true;
+      continue;
+    }
+
+    if (!strcmp(arg, "--null-gpu")) {
+      options->null_gpu = true;
+      continue;
+    }
+
+    if (!strcmp(arg, "--stress")) {
+      if (i + 1 >= argc) {
+        fprintf(stderr, "Missing value for --stress\n");
+        return -1;
+      }
+      options->stress = argv[++ i];
+      continue;
+    }
+
+    if (!strcmp(arg, "--trace")) {
+      if (i + 1 >= argc) {
+        fprintf(stderr, "Missing value for --trace\n");
+        return -1;
+      }
+      options->trace_path = argv[++ i];
+      continue;
+    }
+
     fprintf(stderr, "Unknown argument: %s\n", arg);
     return -1;
   }
@@ -123,6 +320,14 @@ void initEngine(
   ecs_world_t *world, 
   FlecsAppOptions options) 
 {
+  // Start tracing before the engine is created, so init is in the trace
+  if (options.trace_path) {
+    ecs_singleton_set(world, FlecsTrace, {
+      .enabled = true,
+      .path = options.trace_path
+    });
+  }
+
   ecs_entity_t view_entity =  ecs_entity(world, { .name = "view" });
   FlecsRenderView view = {
     .shadow = {
@@ -137,18 +342,32 @@ void initEngine(
       .horizon_color = {250, 255, 255},
       .ground_color = {50, 50, 50},
       .ambient_intensity = 0.2
-    }
+    },
+    .disable_effect_fusion = options.no_effect_fusion,
+    .disable_target_aliasing = options.no_target_aliasing,
+    .packed_effect_targets = options.packed_targets
   };
 
   FlecsRenderBatchSet batch_set = {};
 
   ecs_entity_t window = ecs_entity(world, { .name = "window" });
 
-  if (options.frame_output_mode) {
+  if (options.benchmark_scene) {
+    // Render until the benchmark quits, without writing images
+    ecs_set(world, window, FlecsFrameOutput, {
+      .width = options.width,
+      .height = options.height,
+      .frame_count = -1,
+      .fallback_adapter = options.software_adapter,
+      .null_backend = options.null_gpu
+    });
+  } else if (options.frame_output_mode) {
     ecs_set(world, window, FlecsFrameOutput, {
       .width = options.width,
       .height = options.height,
       .path = options.frame_output_path,
+      .fallback_adapter = options.software_adapter,
+      .null_backend = options.null_gpu
     });
   } else {
     ecs_set(world, window, FlecsWindow, {
@@ -157,10 +376,34 @@ void initEngine(
       .height = options.height,
       .resolution_scale = 1,
       .vsync = true,
-      .msaa = false
+      .msaa = false,
+      .render_thread = options.render_thread,
+      .frames_in_flight = options.frames_in_flight
     });
   }
 
+  if (options.dynamic_resolution_ms) {
+    FlecsDynamicResolution dynamic_resolution =
+      flecsEngine_dynamicResolutionSettingsDefault();
+    dynamic_resolution.target_frame_time =
+      (float)options.dynamic_resolution_ms / 1000.0f;
+    ecs_singleton_set_ptr(world, FlecsDynamicResolution, &dynamic_resolution);
+
+    // The controller measures frames with the timers, since the frame delta
+    // is pinned to the refresh interval with vsync. CPU timing is the
+    // fallback for devices without timestamp queries.
+    options.gpu_timing = true;
+    options.cpu_timing = true;
+  }
+
+  if (options.gpu_timing) {
+    ecs_singleton_set(world, FlecsGpuTiming, { .enabled = true });
+  }
+
+  if (options.cpu_timing) {
+    ecs_singleton_set(world, FlecsCpuTiming, { .enabled = true });
+  }
+
   // Camera
   view.camera = ecs_entity(world, { .name = "camera" });
   ecs_set(world, view.camera, FlecsCamera, {
@@ -169,10 +412,22 @@ void initEngine(
       .far_ = 1000.0f,
       .aspect_ratio = options.width / (float)options.height
   });
-  ecs_add(world, view.camera, FlecsCameraController);
   ecs_set(world, view.camera, FlecsPosition3, {-20.38, 2.023, 16.23});
   ecs_set(world, view.camera, FlecsLookAt, {-19.46, 2, 15.842});
 
+  if (options.benchmark_scene) {
+    // The benchmark moves the camera along a fixed path
+    ecs_singleton_set(world, FlecsBenchmark, {
+      .warmup_frames = options.benchmark_warmup,
+      .frame_count = options.benchmark_frames,
+      .camera = view.camera,
+      .scene = options.benchmark_scene,
+      .path = options.benchmark_path
+    });
+  } else {
+    ecs_add(world, view.camera, FlecsCameraController);
+  }
+
   // Light
   view.light = ecs_entity(world, { .name = "light" });
   ecs_set(world, view.light, FlecsPosition3, {1, 1, 1});
@@ -196,7 +451,13 @@ void initEngine(
   FlecsSSAO ssao_settings = flecsEngine_ssaoSettingsDefault();
   ssao_settings.radius = 0.5;
   ssao_settings.blur = 0;
+  if (options.ssao_temporal) {
+    ssao_settings.resolution = 2;
+    ssao_settings.sample_count = 4;
+    ssao_settings.temporal = true;
+  }
   FlecsBloom bloom_settings = flecsEngine_bloomSettingsDefault();
+  bloom_settings.compute = options.compute_bloom;
   FlecsExponentialHeightFog fog_settings =
     flecsEngine_exponentialHeightFogSettingsDefault();
   fog_settings.density = 0.3;
@@ -227,6 +488,15 @@ void initEngine(
       .effect = flecsEngine_createEffect_gammaCorrect(world, view_entity,
         "gammaCorrect", 4) };
 
+  *ecs_vec_append_t(NULL, &view.effects, flecs_render_view_effect_t) =
+    (flecs_render_view_effect_t){ .enabled = options.fxaa, .effect =
+      flecsEngine_createEffect_fxaa(world, view_entity, "fxaa", 5, NULL) };
+
+  // TAA goes last, so that it can also upscale to output resolution
+  *ecs_vec_append_t(NULL, &view.effects, flecs_render_view_effect_t) =
+    (flecs_render_view_effect_t){ .enabled = options.taa, .effect =
+      flecsEngine_createEffect_taa(world, view_entity, "taa", 6, NULL) };
+
   ecs_set_ptr(world, view_entity, FlecsRenderView, &view);
   ecs_set_ptr(world, view_entity, FlecsRenderBatchSet, &batch_set);
 }
@@ -248,7 +518,10 @@ int main(
     .frame_output_mode = false,
     .frame_output_path = NULL,
     .width = 1280,
-    .height = 800
+    .height = 800,
+    .benchmark_frames = 600,
+    .benchmark_warmup = 60,
+    .benchmark_path = "benchmark.json"
   };
 
   int parse_result = flecsParseArgs(argc, argv, &options);
@@ -267,28 +540,79 @@ int main(
 
   ecs_log_set_level(0);
 
+  const char *scene = "etc/assets/scenes/kenney_city.flecs";
+  // const char *scene = "etc/assets/scenes/bistro.flecs";
+  // const char *scene = "etc/assets/scenes/sponza.flecs";
+  // const char *scene = "etc/assets/scenes/a_beautiful_game.flecs";
+  // const char *scene = "etc/assets/scenes/flight_helmet.flecs";
+  // const char *scene = "etc/assets/scenes/damaged_helmet.flecs";
+  // const char *scene = "etc/assets/scenes/city.flecs";
+  // const char *scene = "etc/assets/scenes/museum.flecs";
+  // const char *scene = "etc/assets/scenes/cube.flecs";
+  // const char *scene = "etc/assets/scenes/empty.flecs";
+
+  // Benchmarks accept a scene name or a path
+  char scene_path[256];
+  if (options.benchmark_scene) {
+    scene = options.benchmark_scene;
+    if (!strchr(scene, '/') && !strstr(scene, ".flecs")) {
+      snprintf(scene_path, sizeof(scene_path),
+        "etc/assets/scenes/%s.flecs", scene);
+      scene = scene_path;
+    }
+  } else if (options.stress) {
+    scene = "etc/assets/scenes/empty.flecs";
+  }
+
   ecs_entity_t s = ecs_script(world, {
-    .filename = "etc/assets/scenes/kenney_city.flecs"
-    // .filename = "etc/assets/scenes/bistro.flecs"
-    // .filename = "etc/assets/scenes/sponza.flecs"
-    // .filename = "etc/assets/scenes/a_beautiful_game.flecs"
-    // .filename = "etc/assets/scenes/flight_helmet.flecs"
-    // .filename = "etc/assets/scenes/damaged_helmet.flecs"
-    // .filename = "etc/assets/scenes/city.flecs"
-    // .filename = "etc/assets/scenes/museum.flecs"
-    // .filename = "etc/assets/scenes/cube.flecs"
-    // .filename = "etc/assets/scenes/empty.flecs"
+    .filename = scene
   });
   if (!s) {
     ecs_err("failed to load script\n");
+    if (options.benchmark_scene) {
+      ecs_fini(world);
+      return 1;
+    }
+  }
+
+  // Generate a synthetic scene, with defaults for fields not in the JSON
+  if (options.stress) {
+    FlecsStressScene stress = {
+      .seed = 1,
+      .instance_count = 10000,
+      .mesh_count = 8,
+      .moving_fraction = 0.1f,
+      .transparent_fraction = 0.05f,
+      .material_count = 32,
+      .point_light_count = 64,
+      .spot_light_count = 16
+    };
+
+    if (!ecs_ptr_from_json(
+      world, ecs_id(FlecsStressScene), &stress, options.stress, NULL))
+    {
+      ecs_err("invalid value for --stress\n");
+      ecs_fini(world);
+      return 1;
+    }
+
+    // Frame the scene. Benchmarks orbit from where the camera is placed.
+    stress.camera = ecs_lookup(world, "camera");
+
+    ecs_entity_t stress_entity = ecs_entity(world, { .name = "stress" });
+    ecs_set_ptr(world, stress_entity, FlecsStressScene, &stress);
   }
 
 #ifdef __EMSCRIPTEN__
   emscripten_set_main_loop_arg(
       (em_arg_callback_func)flecsWasmFrame, world, 0, 1);
 #else
-  ecs_singleton_set(world, EcsRest, {0});
-  while (ecs_progress(world, 0)) {}
+  // Benchmarks use a fixed time step, so that animations are reproducible
+  float delta_time = options.benchmark_scene ? 1.0f / 60.0f : 0;
+  if (!options.benchmark_scene) {
+    ecs_singleton_set(world, EcsRest, {0});
+  }
+  while (ecs_progress(world, delta_time)) {}
 #endif
 
   ecs_log_set_level(-1);
@@ -8,6 +8,34 @@ ECS_TAG_DECLARE(FlecsCameraController);
 void FlecsEngineCameraControllerImport(
     ecs_world_t *world);
 
+/* Length of the jitter cycle. Eight Halton points cover a pixel well enough
+ * while the history still converges quickly. */
+#define FLECS_ENGINE_CAMERA_JITTER_PHASES (8)
+
+static float flecsEngine_halton(
+    uint32_t index,
+    uint32_t base)
+{
+    float f = 1.0f, result = 0.0f;
+    while (index > 0) {
+        f /= (float)base;
+        result += f * (float)(index % base);
+        index /= base;
+    }
+    return result;
+}
+
+void flecsEngine_cameraJitterOffset(
+    uint32_t frame,
+    float *x,
+    float *y)
+{
+    /* Skip index 0, which is (0, 0) for every base */
+    uint32_t index = (frame % FLECS_ENGINE_CAMERA_JITTER_PHASES) + 1;
+    *x = flecsEngine_halton(index, 2) - 0.5f;
+    *y = flecsEngine_halton(index, 3) - 0.5f;
+}
+
 static void FlecsCameraTransform(ecs_iter_t *it) {
     FlecsCamera *cameras = ecs_field(it, FlecsCamera, 0);
     const FlecsLookAt *lookat = ecs_field(it, FlecsLookAt, 1);
@@ -20,6 +48,13 @@ static void FlecsCameraTransform(ecs_iter_t *it) {
         window_aspect = (float)engine->actual_width / (float)engine->actual_height;
     }
 
+    /* Jitter is a fraction of a pixel of the render viewport */
+    float render_width = 0.0f, render_height = 0.0f;
+    if (engine && engine->render_width > 0 && engine->render_height > 0) {
+        render_width = (float)engine->render_width;
+        render_height = (float)engine->render_height;
+    }
+
     for (int32_t i = 0; i < it->count; i ++) {
         FlecsCamera *cam = &cameras[i];
         if (window_aspect > 0.0f) {
@@ -52,6 +87,33 @@ static void FlecsCameraTransform(ecs_iter_t *it) {
         }
 
         glm_lookat(eye, center, up, impl[i].view);
+
+        glm_mat4_copy(impl[i].unjittered_mvp, impl[i].prev_mvp);
+        glm_mat4_mul(impl[i].proj, impl[i].view, impl[i].unjittered_mvp);
+        if (!impl[i].has_prev_mvp) {
+            glm_mat4_copy(impl[i].unjittered_mvp, impl[i].prev_mvp);
+            impl[i].has_prev_mvp = true;
+        }
+
+        /* Views request jitter each frame while they have an effect that
+         * resolves it, so it stops when the effect is disabled. */
+        impl[i].jitter[0] = 0.0f;
+        impl[i].jitter[1] = 0.0f;
+        if (impl[i].jitter_requested && render_width > 0.0f) {
+            float x, y;
+            flecsEngine_cameraJitterOffset(impl[i].jitter_index ++, &x, &y);
+            impl[i].jitter[0] = 2.0f * x / render_width;
+            impl[i].jitter[1] = 2.0f * y / render_height;
+
+            /* Translate in NDC. Scaling by the w row makes this work for
+             * both perspective and orthographic projections. */
+            for (int32_t c = 0; c < 4; c ++) {
+                impl[i].proj[c][0] += impl[i].jitter[0] * impl[i].proj[c][3];
+                impl[i].proj[c][1] += impl[i].jitter[1] * impl[i].proj[c][3];
+            }
+        }
+        impl[i].jitter_requested = false;
+
         glm_mat4_mul(impl[i].proj, impl[i].view, impl[i].mvp);
     }
 }
@@ -64,6 +126,9 @@ void FlecsEngineCameraImport(
     ecs_set_name_prefix(world, "Flecs");
     
     ECS_COMPONENT_DEFINE(world, FlecsCameraImpl);
+    ecs_set_hooks(world, FlecsCameraImpl, {
+        .ctor = flecs_default_ctor
+    });
     ECS_TAG_DEFINE(world, FlecsCameraController);
     ECS_META_COMPONENT(world, FlecsCamera);
 
@@ -13,6 +13,7 @@
 #include "../light/light.h"
 #include "../material/material.h"
 #include "../gltf/gltf.h"
+#include "../stress/stress.h"
 
 ECS_COMPONENT_DECLARE(flecs_vec2_t);
 ECS_COMPONENT_DECLARE(flecs_vec3_t);
@@ -33,6 +34,15 @@ static void flecsEngine_cleanup(
     impl->sky_background_hdri = 0;
     impl->black_hdri = 0;
 
+    /* Finish the frame in flight before resources are released */
+    flecsEngine_renderThread_free(impl->render_thread);
+    impl->render_thread = NULL;
+    flecsEngine_frameSync_fini(impl);
+    flecsEngine_gpuTimer_free(impl->gpu_timer);
+    impl->gpu_timer = NULL;
+    flecsEngine_cpuTimer_free(impl->cpu_timer);
+    impl->cpu_timer = NULL;
+
     if (impl->depth.passthrough_pipeline) {
         wgpuRenderPipelineRelease(impl->depth.passthrough_pipeline);
         impl->depth.passthrough_pipeline = NULL;
@@ -55,8 +65,15 @@ static void flecsEngine_cleanup(
         impl->depth.depth_resolve_bind_layout = NULL;
     }
 
+    flecsEngine_releaseUpscale(impl);
+
+    flecsEngine_encodePool_free(impl->encode_pool);
+    impl->encode_pool = NULL;
+    flecsEngine_frameCommands_fini(impl);
+
     flecsEngine_releaseMsaaResources(impl);
     flecsEngine_shadow_cleanup(impl);
+    flecsEngine_viewUniforms_cleanup(impl);
     flecsEngine_material_releaseBuffer(impl);
 
     flecsEngine_surfaceInterface_cleanup(
@@ -71,13 +88,19 @@ static void flecsEngine_cleanup(
     }
 
     if (impl->depth.depth_texture) {
-        wgpuTextureRelease(impl->depth.depth_texture);
+        flecsEngine_gpuMemory_releaseTexture(FlecsGpuMemoryRenderTarget,
+            impl->depth.depth_texture);
         impl->depth.depth_texture = NULL;
     }
 
     impl->depth.depth_texture_width = 0;
     impl->depth.depth_texture_height = 0;
 
+    /* Shader assets reference modules owned by the cache. Drop them so they
+     * are recompiled against the next device. */
+    ecs_remove_all(world, ecs_id(FlecsShaderImpl));
+    flecsEngine_shaderCache_fini(impl);
+
     if (impl->queue) {
         wgpuQueueRelease(impl->queue);
         impl->queue = NULL;
@@ -136,6 +159,8 @@ int flecsEngine_init(
         .height = height,
         .actual_width = width / resolution_scale,
         .actual_height = height / resolution_scale,
+        .render_width = width / resolution_scale,
+        .render_height = height / resolution_scale,
         .resolution_scale = resolution_scale,
         .sample_count = sample_count,
         .vsync = output->vsync,
@@ -144,6 +169,20 @@ int flecsEngine_init(
         .default_attr_cache = flecsEngine_defaultAttrCache_create()
     };
 
+    /* The null backend has no surfaces to present to */
+    if (output->null_backend &&
+        output->ops != &flecsEngineFrameCaptureOutputOps)
+    {
+        ecs_err("The null GPU backend requires frame output\n");
+        goto error;
+    }
+
+    if (flecsEngine_gpuBackend_select(output->null_backend ?
+        FlecsGpuBackendNull : FlecsGpuBackendNative))
+    {
+        goto error;
+    }
+
     WGPUInstanceDescriptor instance_desc = {0};
     impl.instance = wgpuCreateInstance(&instance_desc);
     if (!impl.instance) {
@@ -158,7 +197,8 @@ int flecsEngine_init(
         goto error;
     }
 
-    impl.adapter = flecsEngine_requestAdapter(impl.instance, impl.surface);
+    impl.adapter = flecsEngine_requestAdapter(
+        impl.instance, impl.surface, output->fallback_adapter);
     if (!impl.adapter) {
         goto error;
     }
@@ -169,6 +209,7 @@ int flecsEngine_init(
     }
 
     flecsEngine_setDeviceErrorCallback(impl.device);
+    impl.rg11b10_renderable = flecsEngine_canRenderRG11B10(impl.device);
 
     impl.queue = wgpuDeviceGetQueue(impl.device);
 
@@ -178,10 +219,16 @@ int flecsEngine_init(
         goto error;
     }
 
+    flecsEngine_frameSync_init(&impl, output->frames_in_flight);
+
     if (flecsEngine_initRenderer(world, &impl)) {
         goto error;
     }
 
+    if (output->render_thread) {
+        impl.render_thread = flecsEngine_renderThread_create();
+    }
+
     *ptr = impl;
 
     return 0;
@@ -252,6 +299,8 @@ void FlecsEngineImport(
     ecs_set_name_prefix(world, "Flecs");
 
     ECS_COMPONENT_DEFINE(world, FlecsEngineImpl);
+    flecsEngine_trace_register(world);
+    flecsEngine_benchmark_register(world);
 
     ecs_set_hooks(world, FlecsEngineImpl, {
         .on_remove = flecsEngine_destroy
@@ -268,4 +317,5 @@ void FlecsEngineImport(
     ECS_IMPORT(world, FlecsEngineInput);
     ECS_IMPORT(world, FlecsEngineCamera);
     ECS_IMPORT(world, FlecsEngineGltf);
+    ECS_IMPORT(world, FlecsEngineStress);
 }
@@ -1,5 +1,6 @@
 #define FLECS_ENGINE_FRAME_OUTPUT_IMPL
 #include "frame_capture.h"
+#include "../../../renderer/renderer.h"
 
 #include <stdio.h>
 
@@ -74,7 +75,8 @@ static void flecsEngine_frameCapture_destroyResources(
     }
 
     if (impl->frame_output_texture) {
-        wgpuTextureRelease(impl->frame_output_texture);
+        flecsEngine_gpuMemory_releaseTexture(FlecsGpuMemoryRenderTarget,
+            impl->frame_output_texture);
         impl->frame_output_texture = NULL;
     }
 }
@@ -99,8 +101,8 @@ static int flecsEngine_frameCapture_createResources(
         .sampleCount = 1
     };
 
-    impl->frame_output_texture =
-        wgpuDeviceCreateTexture(impl->device, &color_desc);
+    impl->frame_output_texture = flecsEngine_gpuMemory_createTexture(
+        impl->device, FlecsGpuMemoryRenderTarget, &color_desc);
     if (!impl->frame_output_texture) {
         ecs_err("Failed to create frame-output texture\n");
         return -1;
@@ -110,7 +112,8 @@ static int flecsEngine_frameCapture_createResources(
         wgpuTextureCreateView(impl->frame_output_texture, NULL);
     if (!impl->frame_output_texture_view) {
         ecs_err("Failed to create frame-output texture view\n");
-        wgpuTextureRelease(impl->frame_output_texture);
+        flecsEngine_gpuMemory_releaseTexture(FlecsGpuMemoryRenderTarget,
+            impl->frame_output_texture);
         impl->frame_output_texture = NULL;
         return -1;
     }
@@ -162,10 +165,19 @@ static int flecsEngine_frameCapture_initInstance(
     const void *config)
 {
     const FlecsEngineFrameCaptureOutputConfig *capture_cfg = config;
-    const char *path = "frame.ppm";
+    int32_t frame_count = capture_cfg ? capture_cfg->frame_count : 0;
+    impl->frame_output_count = frame_count ? frame_count : 1;
 
+    const char *path = NULL;
     if (capture_cfg && capture_cfg->path && capture_cfg->path[0]) {
         path = capture_cfg->path;
+    } else if (impl->frame_output_count == 1) {
+        path = "frame.ppm";
+    }
+
+    /* Without a path frames are rendered, but not written */
+    if (!path) {
+        return 0;
     }
 
     impl->frame_output_path = ecs_os_strdup(path);
@@ -236,6 +248,11 @@ static int flecsEngine_frameCapture_encodeFrame(
     WGPUCommandEncoder encoder,
     FlecsEngineSurface *target)
 {
+    /* Only the last frame is read back */
+    if (!impl->frame_output_path || impl->frame_output_count != 1) {
+        return 0;
+    }
+
     uint32_t bytes_per_row = ECS_ALIGN(
         (uint32_t)impl->width * 4u,
         kFrameOutputRowPitchAlignment);
@@ -292,9 +309,20 @@ static int flecsEngine_frameCapture_submitFrame(
     FlecsEngineImpl *impl,
     const FlecsEngineSurface *target)
 {
-    int result = flecsEngine_frameCapture_writeImage(impl, target);
-    impl->output_done = true;
-    ecs_quit(world);
+    int result = 0;
+    if (target->readback_buffer) {
+        result = flecsEngine_frameCapture_writeImage(impl, target);
+    }
+
+    if (impl->frame_output_count > 0) {
+        impl->frame_output_count --;
+    }
+
+    if (!impl->frame_output_count) {
+        impl->output_done = true;
+        ecs_quit(world);
+    }
+
     return result;
 }
 
@@ -335,7 +363,8 @@ static void FlecsFrameOutputOnSet(
     FlecsFrameOutput *outputs = ecs_field(it, FlecsFrameOutput, 0);
     for (int32_t i = 0; i < it->count; i ++) {
         FlecsEngineFrameCaptureOutputConfig output_cfg = {
-            .path = outputs[i].path
+            .path = outputs[i].path,
+            .frame_count = outputs[i].frame_count
         };
 
         FlecsEngineOutputDesc output_desc = {
@@ -343,7 +372,9 @@ static void FlecsFrameOutputOnSet(
             .config = &output_cfg,
             .width = outputs[i].width,
             .height = outputs[i].height,
-            .msaa = outputs[i].msaa
+            .msaa = outputs[i].msaa,
+            .fallback_adapter = outputs[i].fallback_adapter,
+            .null_backend = outputs[i].null_backend
         };
 
         if (flecsEngine_init(it->world, &output_desc)) {
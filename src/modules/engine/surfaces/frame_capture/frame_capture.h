@@ -6,6 +6,7 @@
 
 typedef struct {
     const char *path;
+    int32_t frame_count;
 } FlecsEngineFrameCaptureOutputConfig;
 
 extern const FlecsEngineSurfaceInterface flecsEngineFrameCaptureOutputOps;
@@ -1,5 +1,6 @@
 #define FLECS_ENGINE_WINDOW_IMPL
 #include "window.h"
+#include "../../../renderer/renderer.h"
 
 ECS_COMPONENT_DECLARE(FlecsWindow);
 
@@ -171,6 +172,7 @@ static void FlecsOnWindowCreate(
             existing->surface_config.presentMode = new_vsync
                 ? WGPUPresentMode_Fifo
                 : WGPUPresentMode_Immediate;
+            flecsEngine_renderThread_wait(existing->render_thread);
             flecsEngine_reconfigureSurface(existing);
         }
 
@@ -217,7 +219,9 @@ static void FlecsOnWindowCreate(
         .height = h,
         .resolution_scale = wnd->resolution_scale,
         .msaa = wnd->msaa,
-        .vsync = wnd->vsync
+        .vsync = wnd->vsync,
+        .render_thread = wnd->render_thread,
+        .frames_in_flight = wnd->frames_in_flight
     };
 
     if (flecsEngine_init(it->world, &output_desc)) {
@@ -1,6 +1,7 @@
 #define FLECS_ENGINE_GEOMETRY_MESH_IMPL
 #define FLECS_ENGINE_GEOMETRY_PRIMITIVES3_IMPL
 #include "geometry3.h"
+#include "../renderer/renderer.h"
 
 #include <math.h>
 
@@ -102,17 +103,20 @@ static void FlecsMesh3_on_set(
         FlecsMesh3Impl *mesh_impl = ecs_ensure(world, e, FlecsMesh3Impl);
 
         if (mesh_impl->vertex_buffer) {
-            wgpuBufferRelease(mesh_impl->vertex_buffer);
+            flecsEngine_gpuMemory_releaseBuffer(
+                FlecsGpuMemoryMesh, mesh_impl->vertex_buffer);
             mesh_impl->vertex_buffer = NULL;
         }
 
         if (mesh_impl->vertex_uv_buffer) {
-            wgpuBufferRelease(mesh_impl->vertex_uv_buffer);
+            flecsEngine_gpuMemory_releaseBuffer(
+                FlecsGpuMemoryMesh, mesh_impl->vertex_uv_buffer);
             mesh_impl->vertex_uv_buffer = NULL;
         }
 
         if (mesh_impl->index_buffer) {
-            wgpuBufferRelease(mesh_impl->index_buffer);
+            flecsEngine_gpuMemory_releaseBuffer(
+                FlecsGpuMemoryMesh, mesh_impl->index_buffer);
             mesh_impl->index_buffer = NULL;
         }
 
@@ -144,8 +148,10 @@ static void FlecsMesh3_on_set(
             verts[v].n = mesh_normals[v];
         }
 
-        mesh_impl->vertex_buffer = wgpuDeviceCreateBuffer(impl->device, &vert_desc);
-        wgpuQueueWriteBuffer(impl->queue, mesh_impl->vertex_buffer, 0, verts, vert_size);
+        mesh_impl->vertex_buffer = flecsEngine_gpuMemory_createBuffer(
+            impl->device, FlecsGpuMemoryMesh, &vert_desc);
+        flecsEngine_queueWriteBuffer(
+            impl, mesh_impl->vertex_buffer, 0, verts, (size_t)vert_size);
         ecs_os_free(verts);
 
         if (has_uvs) {
@@ -163,8 +169,10 @@ static void FlecsMesh3_on_set(
                 uv_verts[v].uv = mesh_uvs[v];
             }
 
-            mesh_impl->vertex_uv_buffer = wgpuDeviceCreateBuffer(impl->device, &vert_uv_desc);
-            wgpuQueueWriteBuffer(impl->queue, mesh_impl->vertex_uv_buffer, 0, uv_verts, vert_uv_size);
+            mesh_impl->vertex_uv_buffer = flecsEngine_gpuMemory_createBuffer(
+                impl->device, FlecsGpuMemoryMesh, &vert_uv_desc);
+            flecsEngine_queueWriteBuffer(impl, mesh_impl->vertex_uv_buffer,
+                0, uv_verts, (size_t)vert_uv_size);
             ecs_os_free(uv_verts);
         }
 
@@ -174,10 +182,11 @@ static void FlecsMesh3_on_set(
             .size = (uint64_t)ind_size
         };
 
-        mesh_impl->index_buffer = wgpuDeviceCreateBuffer(impl->device, &ind_desc);
+        mesh_impl->index_buffer = flecsEngine_gpuMemory_createBuffer(
+            impl->device, FlecsGpuMemoryMesh, &ind_desc);
         uint32_t *indices = ecs_vec_first_t(&mesh[i].indices, uint32_t);
-        wgpuQueueWriteBuffer(
-            impl->queue, mesh_impl->index_buffer, 0, indices, ind_size);
+        flecsEngine_queueWriteBuffer(
+            impl, mesh_impl->index_buffer, 0, indices, (size_t)ind_size);
 
         mesh_impl->vertex_count = vert_count;
         mesh_impl->index_count = ind_count;
@@ -81,7 +81,7 @@ static const cgltf_accessor* flecsEngine_gltf_findAttribute(
     return NULL;
 }
 
-static bool flecsEngine_gltf_readMesh(
+bool flecsEngine_gltf_readMesh(
     FlecsMesh3 *mesh3,
     const cgltf_primitive *prim)
 {
@@ -682,7 +682,9 @@ static void FlecsGltf_on_set(
             continue;
         }
 
+        uint64_t trace_start = flecsEngine_trace_begin();
         flecsEngine_gltf_load(world, e, gltf[i].file);
+        flecsEngine_trace_end(trace_start, "asset", "gltf_load", gltf[i].file);
     }
 }
 
@@ -4,3 +4,10 @@
 
 void FlecsEngineGltfImport(
     ecs_world_t *world);
+
+struct cgltf_primitive;
+
+/* Unpack the accessors of a glTF primitive into a mesh. */
+bool flecsEngine_gltf_readMesh(
+    FlecsMesh3 *mesh3,
+    const struct cgltf_primitive *prim);
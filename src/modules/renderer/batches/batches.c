@@ -13,29 +13,30 @@ void flecsEngine_batch_buffers_init(
     buf->owns_material_data = owns_material_data;
 }
 
+static void flecsEngine_batch_gpu_buffers_release(
+    flecsEngine_batch_gpu_buffers_t *gpu)
+{
+    flecsEngine_gpuMemory_releaseBuffer(FlecsGpuMemoryInstance, gpu->transform);
+    flecsEngine_gpuMemory_releaseBuffer(FlecsGpuMemoryInstance, gpu->color);
+    flecsEngine_gpuMemory_releaseBuffer(FlecsGpuMemoryInstance, gpu->pbr);
+    flecsEngine_gpuMemory_releaseBuffer(FlecsGpuMemoryInstance, gpu->emissive);
+    flecsEngine_gpuMemory_releaseBuffer(
+        FlecsGpuMemoryInstance, gpu->material_id);
+    ecs_os_zeromem(gpu);
+}
+
 static void flecsEngine_batch_buffers_releaseGpu(
     flecsEngine_batch_buffers_t *buf)
 {
-    if (buf->instance_transform) {
-        wgpuBufferRelease(buf->instance_transform);
-        buf->instance_transform = NULL;
-    }
-    if (buf->instance_color) {
-        wgpuBufferRelease(buf->instance_color);
-        buf->instance_color = NULL;
-    }
-    if (buf->instance_pbr) {
-        wgpuBufferRelease(buf->instance_pbr);
-        buf->instance_pbr = NULL;
-    }
-    if (buf->instance_emissive) {
-        wgpuBufferRelease(buf->instance_emissive);
-        buf->instance_emissive = NULL;
-    }
-    if (buf->instance_material_id) {
-        wgpuBufferRelease(buf->instance_material_id);
-        buf->instance_material_id = NULL;
+    for (int32_t i = 0; i < FLECS_ENGINE_FRAMES_IN_FLIGHT_MAX; i ++) {
+        flecsEngine_batch_gpu_buffers_release(&buf->gpu[i]);
     }
+
+    buf->instance_transform = NULL;
+    buf->instance_color = NULL;
+    buf->instance_pbr = NULL;
+    buf->instance_emissive = NULL;
+    buf->instance_material_id = NULL;
 }
 
 static void flecsEngine_batch_buffers_freeCpu(
@@ -62,71 +63,109 @@ void flecsEngine_batch_buffers_fini(
     buf->capacity = 0;
 }
 
-static void flecsEngine_batch_buffers_resizeMaterialData(
+static WGPUBuffer flecsEngine_batch_buffers_createVertex(
     const FlecsEngineImpl *engine,
-    flecsEngine_batch_buffers_t *buf,
-    int32_t new_capacity)
+    uint64_t size)
 {
-    flecsEngine_batch_buffers_releaseGpu(buf);
-    flecsEngine_batch_buffers_freeCpu(buf);
-
-    buf->instance_transform = wgpuDeviceCreateBuffer(engine->device,
-        &(WGPUBufferDescriptor){
+    flecsEngine_renderStats_createBuffer(engine);
+    return flecsEngine_gpuMemory_createBuffer(engine->device,
+        FlecsGpuMemoryInstance, &(WGPUBufferDescriptor){
             .usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst,
-            .size = (uint64_t)new_capacity * sizeof(FlecsInstanceTransform)
+            .size = size
         });
+}
 
-    buf->instance_color = wgpuDeviceCreateBuffer(engine->device,
-        &(WGPUBufferDescriptor){
-            .usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst,
-            .size = (uint64_t)new_capacity * sizeof(FlecsRgba)
-        });
+static void flecsEngine_batch_buffers_createGpu(
+    const FlecsEngineImpl *engine,
+    const flecsEngine_batch_buffers_t *buf,
+    flecsEngine_batch_gpu_buffers_t *gpu)
+{
+    flecsEngine_batch_gpu_buffers_release(gpu);
 
-    buf->instance_pbr = wgpuDeviceCreateBuffer(engine->device,
-        &(WGPUBufferDescriptor){
-            .usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst,
-            .size = (uint64_t)new_capacity * sizeof(FlecsPbrMaterial)
-        });
+    uint64_t capacity = (uint64_t)buf->capacity;
+    gpu->transform = flecsEngine_batch_buffers_createVertex(
+        engine, capacity * sizeof(FlecsInstanceTransform));
 
-    buf->instance_emissive = wgpuDeviceCreateBuffer(engine->device,
-        &(WGPUBufferDescriptor){
-            .usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst,
-            .size = (uint64_t)new_capacity * sizeof(FlecsEmissive)
-        });
+    if (buf->owns_material_data) {
+        gpu->color = flecsEngine_batch_buffers_createVertex(
+            engine, capacity * sizeof(FlecsRgba));
+        gpu->pbr = flecsEngine_batch_buffers_createVertex(
+            engine, capacity * sizeof(FlecsPbrMaterial));
+        gpu->emissive = flecsEngine_batch_buffers_createVertex(
+            engine, capacity * sizeof(FlecsEmissive));
+    } else {
+        gpu->material_id = flecsEngine_batch_buffers_createVertex(
+            engine, capacity * sizeof(FlecsMaterialId));
+    }
 
-    buf->cpu_transforms =
-        ecs_os_malloc_n(FlecsInstanceTransform, new_capacity);
-    buf->cpu_colors = ecs_os_malloc_n(FlecsRgba, new_capacity);
-    buf->cpu_pbr_materials =
-        ecs_os_malloc_n(FlecsPbrMaterial, new_capacity);
-    buf->cpu_emissives = ecs_os_malloc_n(FlecsEmissive, new_capacity);
-    buf->capacity = new_capacity;
+    gpu->capacity = buf->capacity;
+}
+
+/* Point the instance buffers at the copy of a frame slot, and grow the copy
+ * if the CPU buffers were resized since the slot was last used. */
+static void flecsEngine_batch_buffers_selectGpu(
+    const FlecsEngineImpl *engine,
+    flecsEngine_batch_buffers_t *buf,
+    int32_t slot)
+{
+    flecsEngine_batch_gpu_buffers_t *gpu = &buf->gpu[slot];
+    if (gpu->capacity != buf->capacity) {
+        flecsEngine_batch_buffers_createGpu(engine, buf, gpu);
+    }
+
+    buf->gpu_slot = slot;
+    buf->instance_transform = gpu->transform;
+    buf->instance_color = gpu->color;
+    buf->instance_pbr = gpu->pbr;
+    buf->instance_emissive = gpu->emissive;
+    buf->instance_material_id = gpu->material_id;
 }
 
-static void flecsEngine_batch_buffers_resizeMaterialIds(
+static void flecsEngine_batch_buffers_resize(
     const FlecsEngineImpl *engine,
     flecsEngine_batch_buffers_t *buf,
     int32_t new_capacity)
 {
-    flecsEngine_batch_buffers_releaseGpu(buf);
-    flecsEngine_batch_buffers_freeCpu(buf);
+    /* A later view in the frame can grow the buffers after earlier views
+     * extracted into [0, base). Keep that range, so that the CPU arrays
+     * always hold all instances of the frame. */
+    buf->cpu_transforms = ecs_os_realloc_n(
+        buf->cpu_transforms, FlecsInstanceTransform, new_capacity);
+    if (buf->owns_material_data) {
+        buf->cpu_colors = ecs_os_realloc_n(
+            buf->cpu_colors, FlecsRgba, new_capacity);
+        buf->cpu_pbr_materials = ecs_os_realloc_n(
+            buf->cpu_pbr_materials, FlecsPbrMaterial, new_capacity);
+        buf->cpu_emissives = ecs_os_realloc_n(
+            buf->cpu_emissives, FlecsEmissive, new_capacity);
+    } else {
+        buf->cpu_material_ids = ecs_os_realloc_n(
+            buf->cpu_material_ids, FlecsMaterialId, new_capacity);
+    }
+    buf->capacity = new_capacity;
 
-    buf->instance_transform = wgpuDeviceCreateBuffer(engine->device,
-        &(WGPUBufferDescriptor){
-            .usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst,
-            .size = (uint64_t)new_capacity * sizeof(FlecsInstanceTransform)
-        });
+    /* The GPU copy of the slot is recreated without [0, base). That range
+     * doesn't need to be uploaded again: the passes of earlier views were
+     * encoded with the previous buffer, which holds their instances and is
+     * kept alive by the commands that reference it. Copies of other frame
+     * slots may still be read by the GPU. They are recreated at the new
+     * capacity when their slot is selected again. */
+    flecsEngine_batch_buffers_selectGpu(engine, buf, buf->gpu_slot);
+}
 
-    buf->instance_material_id = wgpuDeviceCreateBuffer(engine->device,
-        &(WGPUBufferDescriptor){
-            .usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst,
-            .size = (uint64_t)new_capacity * sizeof(FlecsMaterialId)
-        });
+int32_t flecsEngine_batch_buffers_begin(
+    const FlecsEngineImpl *engine,
+    flecsEngine_batch_buffers_t *buf)
+{
+    if (buf->frame != engine->frame_count) {
+        buf->frame = engine->frame_count;
+        buf->count = 0;
+        flecsEngine_batch_buffers_selectGpu(
+            engine, buf, engine->frame_sync.slot);
+    }
 
-    buf->cpu_transforms =
-        ecs_os_malloc_n(FlecsInstanceTransform, new_capacity);
-    buf->cpu_material_ids = ecs_os_malloc_n(FlecsMaterialId, new_capacity);
-    buf->capacity = new_capacity;
+    buf->base = buf->count;
+    return buf->base;
 }
 
 void flecsEngine_batch_buffers_ensureCapacity(
@@ -143,56 +182,56 @@ void flecsEngine_batch_buffers_ensureCapacity(
         new_capacity = 64;
     }
 
-    if (buf->owns_material_data) {
-        flecsEngine_batch_buffers_resizeMaterialData(engine, buf, new_capacity);
-    } else {
-        flecsEngine_batch_buffers_resizeMaterialIds(engine, buf, new_capacity);
-    }
+    flecsEngine_batch_buffers_resize(engine, buf, new_capacity);
 }
 
+/* Only uploads the instances of the current view, [base, count). This relies
+ * on the instance buffer of the slot not changing between the upload and the
+ * draws of a view, see flecsEngine_batch_buffers_resize. */
 void flecsEngine_batch_buffers_upload(
     const FlecsEngineImpl *engine,
     const flecsEngine_batch_buffers_t *buf)
 {
-    int32_t count = buf->count;
-    if (!count) {
+    int32_t base = buf->base;
+    int32_t count = buf->count - base;
+    if (count <= 0) {
         return;
     }
 
-    wgpuQueueWriteBuffer(
-        engine->queue,
+    flecsEngine_queueWriteBuffer(
+        engine,
         buf->instance_transform,
-        0,
-        buf->cpu_transforms,
+        (uint64_t)base * sizeof(FlecsInstanceTransform),
+        &buf->cpu_transforms[base],
         (uint64_t)count * sizeof(FlecsInstanceTransform));
 
     if (buf->owns_material_data) {
-        wgpuQueueWriteBuffer(
-            engine->queue,
+        flecsEngine_queueWriteBuffer(
+            engine,
             buf->instance_color,
-            0,
-            buf->cpu_colors,
+            (uint64_t)base * sizeof(FlecsRgba),
+            &buf->cpu_colors[base],
             (uint64_t)count * sizeof(FlecsRgba));
 
-        wgpuQueueWriteBuffer(
-            engine->queue,
+        flecsEngine_queueWriteBuffer(
+            engine,
             buf->instance_pbr,
-            0,
-            buf->cpu_pbr_materials,
+            (uint64_t)base * sizeof(FlecsPbrMaterial),
+            &buf->cpu_pbr_materials[base],
             (uint64_t)count * sizeof(FlecsPbrMaterial));
 
-        wgpuQueueWriteBuffer(
-            engine->queue,
+        flecsEngine_queueWriteBuffer(
+            engine,
             buf->instance_emissive,
-            0,
-            buf->cpu_emissives,
+            (uint64_t)base * sizeof(FlecsEmissive),
+            &buf->cpu_emissives[base],
             (uint64_t)count * sizeof(FlecsEmissive));
     } else {
-        wgpuQueueWriteBuffer(
-            engine->queue,
+        flecsEngine_queueWriteBuffer(
+            engine,
             buf->instance_material_id,
-            0,
-            buf->cpu_material_ids,
+            (uint64_t)base * sizeof(FlecsMaterialId),
+            &buf->cpu_material_ids[base],
             (uint64_t)count * sizeof(FlecsMaterialId));
     }
 }
@@ -298,17 +337,17 @@ static void flecsEngine_batch_copyMaterialIds(
 /* Test a world-space AABB against the camera frustum and the shadow
  * frustum. Returns true if the AABB is inside either. */
 static bool flecsEngine_isVisibleAABB(
-    const FlecsEngineImpl *engine,
+    const flecs_engine_frustum_t *frustum,
     const float wmin[3],
     const float wmax[3])
 {
-    if (flecsEngine_testAABBFrustum(engine->frustum_planes, wmin, wmax)) {
+    if (flecsEngine_testAABBFrustum(frustum->planes, wmin, wmax)) {
         return true;
     }
 
-    if (engine->shadow_frustum_valid) {
+    if (frustum->shadow_valid) {
         return flecsEngine_testAABBFrustum(
-            engine->shadow_frustum_planes, wmin, wmax);
+            frustum->shadow_planes, wmin, wmax);
     }
 
     return false;
@@ -325,9 +364,11 @@ void flecsEngine_batch_extractInstances(
 
     int32_t base = ctx->offset;
     ctx->count = 0;
+    ctx->culled_count = 0;
 
-    /* Frustum culling state */
-    bool do_cull = engine->frustum_valid &&
+    /* Frustum culling state of the view that is being extracted */
+    const flecs_engine_frustum_t *frustum = engine->frustum;
+    bool do_cull = frustum && frustum->valid &&
         (ctx->mesh.aabb_min[0] <= ctx->mesh.aabb_max[0]);
     const float *aabb_min = ctx->mesh.aabb_min;
     const float *aabb_max = ctx->mesh.aabb_max;
@@ -376,7 +417,8 @@ void flecsEngine_batch_extractInstances(
                     flecsEngine_computeWorldAABB(&wt[i],
                         aabb_min, aabb_max,
                         scale[0], scale[1], scale[2], wmin, wmax);
-                    if (!flecsEngine_isVisibleAABB(engine, wmin, wmax)) {
+                    if (!flecsEngine_isVisibleAABB(frustum, wmin, wmax)) {
+                        ctx->culled_count ++;
                         continue;
                     }
                 }
@@ -409,7 +451,8 @@ void flecsEngine_batch_extractInstances(
                     flecsEngine_computeWorldAABB(&wt[i],
                         aabb_min, aabb_max,
                         1.0f, 1.0f, 1.0f, wmin, wmax);
-                    if (!flecsEngine_isVisibleAABB(engine, wmin, wmax)) {
+                    if (!flecsEngine_isVisibleAABB(frustum, wmin, wmax)) {
+                        ctx->culled_count ++;
                         continue;
                     }
                 }
@@ -448,36 +491,52 @@ void flecsEngine_primitive_extract(
 {
     flecsEngine_batch_t *ctx = batch->ctx;
     flecsEngine_batch_buffers_t *buf = ctx->buffers;
+    int32_t base = flecsEngine_batch_buffers_begin(engine, buf);
 
 redo:
-    ctx->offset = 0;
+    ctx->offset = base;
     flecsEngine_batch_extractInstances(world, engine, batch, ctx);
 
-    if (ctx->count > buf->capacity) {
-        flecsEngine_batch_buffers_ensureCapacity(engine, buf, ctx->count);
+    if ((base + ctx->count) > buf->capacity) {
+        flecsEngine_batch_buffers_ensureCapacity(
+            engine, buf, base + ctx->count);
         goto redo;
     }
 
-    buf->count = ctx->count;
+    buf->count = base + ctx->count;
     flecsEngine_batch_buffers_upload(engine, buf);
+
+    flecsEngine_renderStats_cull(engine, ctx->count, ctx->culled_count);
 }
 
 void flecsEngine_primitive_render(
     const ecs_world_t *world,
     const FlecsEngineImpl *engine,
     const WGPURenderPassEncoder pass,
+    const flecs_engine_pass_state_t *state,
     const FlecsRenderBatch *batch)
 {
     (void)world;
     (void)engine;
 
     flecsEngine_batch_t *ctx = batch->ctx;
-    flecsEngine_batch_draw(pass, ctx);
+    flecsEngine_batch_draw(state, pass, ctx);
 }
 
 void flecsEngine_batch_draw(
+    const flecs_engine_pass_state_t *state,
     const WGPURenderPassEncoder pass,
     const flecsEngine_batch_t *ctx)
+{
+    flecsEngine_batch_drawWithVertexBuffer(
+        state, pass, ctx, ctx->vertex_buffer);
+}
+
+void flecsEngine_batch_drawWithVertexBuffer(
+    const flecs_engine_pass_state_t *state,
+    const WGPURenderPassEncoder pass,
+    const flecsEngine_batch_t *ctx,
+    WGPUBuffer vertex_buffer)
 {
     if (!ctx->count) {
         return;
@@ -488,7 +547,6 @@ void flecsEngine_batch_draw(
         return;
     }
 
-    WGPUBuffer vertex_buffer = ctx->vertex_buffer;
     if (!vertex_buffer || !ctx->mesh.index_buffer ||
         !ctx->mesh.index_count)
     {
@@ -540,6 +598,8 @@ void flecsEngine_batch_draw(
         WGPU_WHOLE_SIZE);
     wgpuRenderPassEncoderDrawIndexed(
         pass, ctx->mesh.index_count, ctx->count, 0, 0, 0);
+    flecsEngine_renderStats_draw(
+        state, ctx->mesh.index_count, (uint32_t)ctx->count);
 }
 
 void flecsEngine_batch_extractSingleInstance(
@@ -554,19 +614,20 @@ void flecsEngine_batch_extractSingleInstance(
     flecsEngine_batch_buffers_t *buf = batch->buffers;
     ecs_assert(buf != NULL, ECS_INTERNAL_ERROR, NULL);
 
-    flecsEngine_batch_buffers_ensureCapacity(engine, buf, 1);
+    int32_t base = flecsEngine_batch_buffers_begin(engine, buf);
+    flecsEngine_batch_buffers_ensureCapacity(engine, buf, base + 1);
 
     flecsEngine_batch_transformInstance(
-        &buf->cpu_transforms[0],
+        &buf->cpu_transforms[base],
         transform,
         scale_x,
         scale_y,
         scale_z);
 
-    buf->cpu_colors[0] = *color;
-    buf->count = 1;
+    buf->cpu_colors[base] = *color;
+    buf->count = base + 1;
     batch->count = 1;
-    batch->offset = 0;
+    batch->offset = base;
 
     flecsEngine_batch_buffers_upload(engine, buf);
 }
@@ -7,13 +7,28 @@ typedef void (*flecsEngine_primitive_scale_t)(
     const void *value,
     float *out);
 
+/* GPU instance buffers of one frame in flight */
+typedef struct {
+    WGPUBuffer transform;
+    WGPUBuffer color;
+    WGPUBuffer pbr;
+    WGPUBuffer emissive;
+    WGPUBuffer material_id;
+    int32_t capacity;
+} flecsEngine_batch_gpu_buffers_t;
+
 /* Shared GPU+CPU instance buffers. One per batch, shared across all groups. */
 typedef struct {
+    /* Buffers of the frame slot that is being recorded */
     WGPUBuffer instance_transform;
     WGPUBuffer instance_color;
     WGPUBuffer instance_pbr;
     WGPUBuffer instance_emissive;
     WGPUBuffer instance_material_id;
+    /* One copy per frame in flight. Copies of other slots are resized when
+     * their slot comes around again. */
+    flecsEngine_batch_gpu_buffers_t gpu[FLECS_ENGINE_FRAMES_IN_FLIGHT_MAX];
+    int32_t gpu_slot;
     FlecsInstanceTransform *cpu_transforms;
     FlecsRgba *cpu_colors;
     FlecsPbrMaterial *cpu_pbr_materials;
@@ -21,6 +36,8 @@ typedef struct {
     FlecsMaterialId *cpu_material_ids;
     int32_t count;
     int32_t capacity;
+    int32_t base;     /* First instance of the view that is being extracted */
+    uint32_t frame;   /* Frame in which buffers were last extracted into */
     bool owns_material_data;
 } flecsEngine_batch_buffers_t;
 
@@ -29,6 +46,7 @@ typedef struct {
     flecsEngine_batch_buffers_t *buffers;
     int32_t count;
     int32_t offset;
+    int32_t culled_count; /* Instances rejected by frustum culling */
     FlecsMesh3Impl mesh;
     WGPUBuffer vertex_buffer; /* vertex buffer used for drawing (set by caller) */
 
@@ -49,11 +67,19 @@ void flecsEngine_batch_buffers_init(
 void flecsEngine_batch_buffers_fini(
     flecsEngine_batch_buffers_t *buf);
 
+/* Start extracting a view into the shared buffers. Views that were extracted
+ * earlier in the same frame keep their instances and the new view appends
+ * after them. Returns the offset of the first instance of the view. */
+int32_t flecsEngine_batch_buffers_begin(
+    const FlecsEngineImpl *engine,
+    flecsEngine_batch_buffers_t *buf);
+
 void flecsEngine_batch_buffers_ensureCapacity(
     const FlecsEngineImpl *engine,
     flecsEngine_batch_buffers_t *buf,
     int32_t count);
 
+/* Upload the instances of the current view (base up to count). */
 void flecsEngine_batch_buffers_upload(
     const FlecsEngineImpl *engine,
     const flecsEngine_batch_buffers_t *buf);
@@ -95,9 +121,20 @@ void flecsEngine_batch_extractInstances(
 /* Draw a single group using the shared buffers at ctx->offset.
  * Uses ctx->vertex_buffer for vertex slot 0. */
 void flecsEngine_batch_draw(
+    const flecs_engine_pass_state_t *state,
     const WGPURenderPassEncoder pass,
     const flecsEngine_batch_t *ctx);
 
+/* Same as flecsEngine_batch_draw, with the buffer for vertex slot 0 passed in.
+ * Batches that draw with different vertex layouts per pass use this instead
+ * of writing ctx->vertex_buffer, since shadow cascades are encoded on worker
+ * threads while the main pass reads the same ctx. */
+void flecsEngine_batch_drawWithVertexBuffer(
+    const flecs_engine_pass_state_t *state,
+    const WGPURenderPassEncoder pass,
+    const flecsEngine_batch_t *ctx,
+    WGPUBuffer vertex_buffer);
+
 void flecsEngine_batch_transformInstance(
     FlecsInstanceTransform *out,
     const FlecsWorldTransform3 *wt,
@@ -138,6 +175,7 @@ void flecsEngine_primitive_render(
     const ecs_world_t *world,
     const FlecsEngineImpl *engine,
     const WGPURenderPassEncoder pass,
+    const flecs_engine_pass_state_t *state,
     const struct FlecsRenderBatch *batch);
 
 void flecsEngine_batch_extractSingleInstance(
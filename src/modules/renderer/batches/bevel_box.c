@@ -185,6 +185,7 @@ static void flecsEngine_bevel_box_extract(
     flecsEngine_bevel_box_batch_t *ctx = batch->ctx;
     flecsEngine_batch_buffers_t *buf = &ctx->buffers;
     bool owns_material_data = ctx->owns_material_data;
+    int32_t base = flecsEngine_batch_buffers_begin(engine, buf);
 
     /* Pass 1: count instances per sub-batch */
     ctx->quad_batch.count = 0;
@@ -217,10 +218,10 @@ static void flecsEngine_bevel_box_extract(
         }
     }
 
-    flecsEngine_batch_buffers_ensureCapacity(engine, buf, total);
+    flecsEngine_batch_buffers_ensureCapacity(engine, buf, base + total);
 
     {
-        int32_t offset = 0;
+        int32_t offset = base;
         ctx->quad_batch.offset = offset;
         offset += ctx->quad_batch.count;
         for (int32_t s = 1; s <= FLECS_BEVEL_BOX_MAX_SEGMENTS; s ++) {
@@ -305,7 +306,7 @@ static void flecsEngine_bevel_box_extract(
     }
 
     /* Single upload */
-    buf->count = total;
+    buf->count = base + total;
     flecsEngine_batch_buffers_upload(engine, buf);
 }
 
@@ -313,18 +314,19 @@ static void flecsEngine_bevel_box_render(
     const ecs_world_t *world,
     const FlecsEngineImpl *engine,
     const WGPURenderPassEncoder pass,
+    const flecs_engine_pass_state_t *state,
     const FlecsRenderBatch *batch)
 {
     (void)world;
     (void)engine;
 
     flecsEngine_bevel_box_batch_t *ctx = batch->ctx;
-    flecsEngine_batch_draw(pass, &ctx->quad_batch);
+    flecsEngine_batch_draw(state, pass, &ctx->quad_batch);
     for (int32_t s = 1; s <= FLECS_BEVEL_BOX_MAX_SEGMENTS; s ++) {
-        flecsEngine_batch_draw(pass, &ctx->bevel_batches[s][0]);
-        flecsEngine_batch_draw(pass, &ctx->bevel_batches[s][1]);
-        flecsEngine_batch_draw(pass, &ctx->corner_batches[s][0]);
-        flecsEngine_batch_draw(pass, &ctx->corner_batches[s][1]);
+        flecsEngine_batch_draw(state, pass, &ctx->bevel_batches[s][0]);
+        flecsEngine_batch_draw(state, pass, &ctx->bevel_batches[s][1]);
+        flecsEngine_batch_draw(state, pass, &ctx->corner_batches[s][0]);
+        flecsEngine_batch_draw(state, pass, &ctx->corner_batches[s][1]);
     }
 }
 
@@ -59,12 +59,13 @@ static void flecsEngine_infinite_plane_renderCallback(
     const ecs_world_t *world,
     const FlecsEngineImpl *engine,
     const WGPURenderPassEncoder pass,
+    const flecs_engine_pass_state_t *state,
     const FlecsRenderBatch *batch)
 {
     (void)world;
     (void)engine;
     flecs_engine_infinite_plane_ctx_t *ctx = batch->ctx;
-    flecsEngine_batch_draw(pass, &ctx->batch);
+    flecsEngine_batch_draw(state, pass, &ctx->batch);
 }
 
 ecs_entity_t flecsEngine_createBatch_infinitePlane(
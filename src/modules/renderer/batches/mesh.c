@@ -77,6 +77,7 @@ void flecsEngine_mesh_extractGroup(
         world, (ecs_entity_t)group_id, FlecsMesh3Impl);
     if (!mesh || !mesh->index_buffer || !mesh->index_count) {
         ctx->count = 0;
+        ctx->culled_count = 0;
         ecs_os_zeromem(&ctx->mesh);
         return;
     }
@@ -94,15 +95,15 @@ void flecsEngine_mesh_extract(
 {
     flecsEngine_mesh_ctx_t *mctx = batch->ctx;
     flecsEngine_batch_buffers_t *shared = &mctx->buffers;
+    int32_t base = flecsEngine_batch_buffers_begin(engine, shared);
 
     const ecs_map_t *groups = ecs_query_get_groups(batch->query);
     if (!groups) {
-        shared->count = 0;
         return;
     }
 
 redo: {
-        int32_t total = 0;
+        int32_t total = base, culled = 0;
         ecs_map_iter_t git = ecs_map_iter(groups);
         while (ecs_map_next(&git)) {
             uint64_t group_id = ecs_map_key(&git);
@@ -116,6 +117,7 @@ redo: {
             flecsEngine_mesh_extractGroup(
                 world, engine, batch, group_id, shared);
             total += ctx->count;
+            culled += ctx->culled_count;
         }
 
         if (total > shared->capacity) {
@@ -124,6 +126,7 @@ redo: {
         }
 
         shared->count = total;
+        flecsEngine_renderStats_cull(engine, total - base, culled);
     }
 
     flecsEngine_batch_buffers_upload(engine, shared);
@@ -133,6 +136,7 @@ void flecsEngine_mesh_render(
     const ecs_world_t *world,
     const FlecsEngineImpl *engine,
     const WGPURenderPassEncoder pass,
+    const flecs_engine_pass_state_t *state,
     const FlecsRenderBatch *batch)
 {
     (void)world;
@@ -149,7 +153,7 @@ void flecsEngine_mesh_render(
         flecsEngine_batch_t *ctx =
             ecs_query_get_group_ctx(batch->query, group);
         ecs_assert(ctx != NULL, ECS_INTERNAL_ERROR, NULL);
-        flecsEngine_batch_draw(pass, ctx);
+        flecsEngine_batch_draw(state, pass, ctx);
     }
 }
 
@@ -271,8 +275,11 @@ static void flecsEngine_textured_mesh_render(
     const ecs_world_t *world,
     const FlecsEngineImpl *engine,
     const WGPURenderPassEncoder pass,
+    const flecs_engine_pass_state_t *state,
     const FlecsRenderBatch *batch)
 {
+    (void)engine;
+
     const ecs_map_t *groups = ecs_query_get_groups(batch->query);
     ecs_assert(groups != NULL, ECS_INTERNAL_ERROR, NULL);
 
@@ -286,8 +293,9 @@ static void flecsEngine_textured_mesh_render(
         ecs_assert(ctx != NULL, ECS_INTERNAL_ERROR, NULL);
 
         /* During shadow pass, use the non-UV vertex buffer */
-        if (engine->shadow.in_pass) {
-            flecsEngine_batch_draw(pass, ctx);
+        if (state->shadow_pass) {
+            flecsEngine_batch_drawWithVertexBuffer(
+                state, pass, ctx, ctx->mesh.vertex_buffer);
             continue;
         }
 
@@ -299,9 +307,10 @@ static void flecsEngine_textured_mesh_render(
         }
         wgpuRenderPassEncoderSetBindGroup(
             pass, 2, (WGPUBindGroup)pbr_tex->_bind_group, 0, NULL);
+        flecsEngine_renderStats_bindGroupSwitch(state);
 
-        ctx->vertex_buffer = ctx->mesh.vertex_uv_buffer;
-        flecsEngine_batch_draw(pass, ctx);
+        flecsEngine_batch_drawWithVertexBuffer(
+            state, pass, ctx, ctx->mesh.vertex_uv_buffer);
     }
 }
 
@@ -403,9 +412,10 @@ static void flecsEngine_transparent_mesh_render(
     const ecs_world_t *world,
     const FlecsEngineImpl *engine,
     const WGPURenderPassEncoder pass,
+    const flecs_engine_pass_state_t *state,
     const FlecsRenderBatch *batch)
 {
-    if (engine->shadow.in_pass) {
+    if (state->shadow_pass) {
         return;
     }
 
@@ -503,6 +513,7 @@ static void flecsEngine_transparent_mesh_render(
             if (sorted[i].is_textured && tex_pipeline) {
                 if (active_pipeline != tex_pipeline) {
                     wgpuRenderPassEncoderSetPipeline(pass, tex_pipeline);
+                    flecsEngine_renderStats_pipelineSwitch(state);
                     active_pipeline = tex_pipeline;
                 }
 
@@ -514,6 +525,7 @@ static void flecsEngine_transparent_mesh_render(
                 wgpuRenderPassEncoderSetBindGroup(
                     pass, 2, (WGPUBindGroup)pbr_tex->_bind_group,
                     0, NULL);
+                flecsEngine_renderStats_bindGroupSwitch(state);
 
                 if (!ctx->mesh.vertex_uv_buffer) {
                     continue;
@@ -524,6 +536,7 @@ static void flecsEngine_transparent_mesh_render(
             } else {
                 if (active_pipeline != non_tex_pipeline) {
                     wgpuRenderPassEncoderSetPipeline(pass, non_tex_pipeline);
+                    flecsEngine_renderStats_pipelineSwitch(state);
                     active_pipeline = non_tex_pipeline;
                 }
 
@@ -559,11 +572,14 @@ static void flecsEngine_transparent_mesh_render(
 
         wgpuRenderPassEncoderDrawIndexed(
             pass, ctx->mesh.index_count, 1, 0, 0, 0);
+        flecsEngine_renderStats_draw(state, ctx->mesh.index_count, 1);
     }
 
-    /* Restore original pipeline so engine->last_pipeline stays consistent */
+    /* Restore original pipeline so the last pipeline of the pass stays
+     * consistent */
     if (active_pipeline != non_tex_pipeline) {
         wgpuRenderPassEncoderSetPipeline(pass, non_tex_pipeline);
+        flecsEngine_renderStats_pipelineSwitch(state);
     }
 
     ecs_os_free(sorted);
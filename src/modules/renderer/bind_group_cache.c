@@ -0,0 +1,180 @@
+#include "renderer.h"
+#include "flecs_engine.h"
+
+ECS_COMPONENT_DECLARE(FlecsBindGroupStats);
+
+WGPUBindGroup flecsEngine_createBindGroup(
+    const FlecsEngineImpl *engine,
+    const WGPUBindGroupDescriptor *desc)
+{
+    WGPUBindGroup bind_group = wgpuDeviceCreateBindGroup(engine->device, desc);
+    if (bind_group) {
+        flecs_engine_bind_groups_t *stats =
+            &((FlecsEngineImpl*)engine)->bind_groups;
+        stats->create_count ++;
+        stats->total_create_count ++;
+    }
+    return bind_group;
+}
+
+void flecsEngine_bindGroups_invalidate(
+    const FlecsEngineImpl *engine)
+{
+    ((FlecsEngineImpl*)engine)->bind_groups.target_version ++;
+}
+
+static bool flecsEngine_bindGroupCache_match(
+    const flecs_engine_bind_group_slot_t *slot,
+    WGPUBindGroupLayout layout,
+    const WGPUBindGroupEntry *entries,
+    uint32_t entry_count)
+{
+    if (slot->layout != layout || slot->entry_count != entry_count) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < entry_count; i ++) {
+        const WGPUBindGroupEntry *a = &slot->entries[i];
+        const WGPUBindGroupEntry *b = &entries[i];
+        if (a->binding != b->binding ||
+            a->buffer != b->buffer ||
+            a->offset != b->offset ||
+            a->size != b->size ||
+            a->sampler != b->sampler ||
+            a->textureView != b->textureView)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void flecsEngine_bindGroupCache_releaseSlot(
+    flecs_engine_bind_group_slot_t *slot)
+{
+    if (slot->bind_group) {
+        wgpuBindGroupRelease(slot->bind_group);
+    }
+    ecs_os_zeromem(slot);
+}
+
+WGPUBindGroup flecsEngine_bindGroupCache_get(
+    const FlecsEngineImpl *engine,
+    flecs_engine_bind_group_cache_t *cache,
+    WGPUBindGroupLayout layout,
+    const WGPUBindGroupEntry *entries,
+    uint32_t entry_count)
+{
+    ecs_assert(entry_count <= FLECS_ENGINE_BIND_GROUP_ENTRIES_MAX,
+        ECS_INVALID_PARAMETER, NULL);
+
+    flecs_engine_bind_groups_t *stats =
+        &((FlecsEngineImpl*)engine)->bind_groups;
+    uint32_t version = stats->target_version;
+    int32_t free_slot = -1;
+
+    for (int32_t i = 0; i < FLECS_ENGINE_BIND_GROUP_CACHE_SIZE; i ++) {
+        flecs_engine_bind_group_slot_t *slot = &cache->slots[i];
+        if (slot->bind_group && slot->target_version != version) {
+            /* Don't hold on to resources of recreated targets */
+            flecsEngine_bindGroupCache_releaseSlot(slot);
+        }
+
+        if (!slot->bind_group) {
+            if (free_slot == -1) {
+                free_slot = i;
+            }
+            continue;
+        }
+
+        if (flecsEngine_bindGroupCache_match(
+            slot, layout, entries, entry_count))
+        {
+            stats->reuse_count ++;
+            return slot->bind_group;
+        }
+    }
+
+    if (free_slot == -1) {
+        free_slot = cache->next;
+        cache->next = (cache->next + 1) % FLECS_ENGINE_BIND_GROUP_CACHE_SIZE;
+    }
+
+    flecs_engine_bind_group_slot_t *slot = &cache->slots[free_slot];
+    flecsEngine_bindGroupCache_releaseSlot(slot);
+
+    slot->bind_group = flecsEngine_createBindGroup(engine,
+        &(WGPUBindGroupDescriptor){
+            .layout = layout,
+            .entryCount = entry_count,
+            .entries = entries
+        });
+    if (!slot->bind_group) {
+        return NULL;
+    }
+
+    slot->layout = layout;
+    slot->entry_count = entry_count;
+    slot->target_version = version;
+    for (uint32_t i = 0; i < entry_count; i ++) {
+        slot->entries[i] = entries[i];
+    }
+
+    return slot->bind_group;
+}
+
+void flecsEngine_bindGroupCache_fini(
+    flecs_engine_bind_group_cache_t *cache)
+{
+    for (int32_t i = 0; i < FLECS_ENGINE_BIND_GROUP_CACHE_SIZE; i ++) {
+        flecsEngine_bindGroupCache_releaseSlot(&cache->slots[i]);
+    }
+    cache->next = 0;
+}
+
+void flecsEngine_bindGroups_beginFrame(
+    FlecsEngineImpl *engine)
+{
+    engine->bind_groups.create_count = 0;
+    engine->bind_groups.reuse_count = 0;
+}
+
+void flecsEngine_bindGroups_publishStats(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine)
+{
+    const flecs_engine_bind_groups_t *bg = &engine->bind_groups;
+    const FlecsBindGroupStats *stats = ecs_singleton_get(
+        world, FlecsBindGroupStats);
+    if (stats &&
+        stats->create_count == bg->create_count &&
+        stats->reuse_count == bg->reuse_count &&
+        stats->total_create_count == bg->total_create_count)
+    {
+        return;
+    }
+
+    ecs_singleton_set(world, FlecsBindGroupStats, {
+        .create_count = bg->create_count,
+        .reuse_count = bg->reuse_count,
+        .total_create_count = bg->total_create_count
+    });
+}
+
+void flecsEngine_bindGroups_register(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, FlecsBindGroupStats);
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsBindGroupStats),
+        .members = {
+            { .name = "create_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "reuse_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "total_create_count", .type = ecs_id(ecs_i64_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(FlecsBindGroupStats), EcsSingleton);
+}
@@ -26,19 +26,65 @@ static bool flecsEngine_cluster_growBuffer(
         new_cap *= 2;
     }
 
-    if (*buffer) {
-        wgpuBufferRelease(*buffer);
-    }
+    flecsEngine_gpuMemory_releaseBuffer(FlecsGpuMemoryUniform, *buffer);
 
     WGPUBufferDescriptor desc = {
         .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst,
         .size = (uint64_t)new_cap * elem_size
     };
-    *buffer = wgpuDeviceCreateBuffer(device, &desc);
+    *buffer = flecsEngine_gpuMemory_createBuffer(
+        device, FlecsGpuMemoryUniform, &desc);
     *capacity = new_cap;
     return true; /* buffer changed, bind group must be recreated */
 }
 
+/* Create a buffer with one region of `stride` bytes per view. */
+static int flecsEngine_cluster_createViewBuffer(
+    FlecsEngineImpl *impl,
+    WGPUBuffer *buffer,
+    WGPUBufferUsage usage,
+    uint32_t stride)
+{
+    flecsEngine_gpuMemory_releaseBuffer(FlecsGpuMemoryUniform, *buffer);
+
+    WGPUBufferDescriptor desc = {
+        .usage = usage | WGPUBufferUsage_CopyDst,
+        .size = (uint64_t)stride *
+            (uint64_t)impl->lighting.cluster_view_capacity
+    };
+    *buffer = flecsEngine_gpuMemory_createBuffer(
+        impl->device, FlecsGpuMemoryUniform, &desc);
+    flecsEngine_renderStats_createBuffer(impl);
+    if (!*buffer) {
+        ecs_err("failed to create cluster GPU buffer");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int flecsEngine_cluster_createViewBuffers(
+    FlecsEngineImpl *impl)
+{
+    if (flecsEngine_cluster_createViewBuffer(impl,
+        &impl->lighting.cluster_info_buffer, WGPUBufferUsage_Uniform,
+        impl->lighting.cluster_info_stride))
+    {
+        return -1;
+    }
+
+    if (flecsEngine_cluster_createViewBuffer(impl,
+        &impl->lighting.cluster_grid_buffer, WGPUBufferUsage_Storage,
+        impl->lighting.cluster_grid_stride))
+    {
+        return -1;
+    }
+
+    return flecsEngine_cluster_createViewBuffer(impl,
+        &impl->lighting.cluster_index_buffer, WGPUBufferUsage_Storage,
+        impl->lighting.cluster_index_stride);
+}
+
 int flecsEngine_cluster_init(
     FlecsEngineImpl *impl)
 {
@@ -53,47 +99,49 @@ int flecsEngine_cluster_init(
     impl->lighting.cpu_cluster_indices = ecs_os_calloc_n(uint32_t, init_indices);
     impl->lighting.cluster_index_capacity = init_indices;
 
-    /* GPU light storage buffer */
+    /* GPU light storage buffer, shared by all views */
     WGPUBufferDescriptor l_desc = {
         .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst,
         .size = (uint64_t)init_lights * sizeof(FlecsGpuLight)
     };
-    impl->lighting.light_buffer = wgpuDeviceCreateBuffer(
-        impl->device, &l_desc);
+    impl->lighting.light_buffer = flecsEngine_gpuMemory_createBuffer(
+        impl->device, FlecsGpuMemoryUniform, &l_desc);
+    if (!impl->lighting.light_buffer) {
+        ecs_err("failed to create cluster GPU buffers");
+        return -1;
+    }
 
-    /* Cluster info uniform buffer (fixed size) */
-    WGPUBufferDescriptor info_desc = {
-        .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
-        .size = sizeof(FlecsClusterInfo)
-    };
-    impl->lighting.cluster_info_buffer = wgpuDeviceCreateBuffer(
-        impl->device, &info_desc);
+    /* Cluster info, grid and light index buffers have a region per view,
+     * so views rendered in the same frame don't overwrite each other. */
+    impl->lighting.cluster_info_stride = flecsEngine_uniformStride(
+        sizeof(FlecsClusterInfo));
+    impl->lighting.cluster_grid_stride = flecsEngine_uniformStride(
+        (uint64_t)FLECS_ENGINE_CLUSTER_TOTAL * sizeof(FlecsClusterEntry));
+    impl->lighting.cluster_index_stride = flecsEngine_uniformStride(
+        (uint64_t)init_indices * sizeof(uint32_t));
+    impl->lighting.cluster_view_capacity = impl->view_uniforms.capacity;
+    if (!impl->lighting.cluster_view_capacity) {
+        impl->lighting.cluster_view_capacity = 1;
+    }
 
-    /* Cluster grid storage buffer (fixed size) */
-    WGPUBufferDescriptor grid_desc = {
-        .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst,
-        .size = (uint64_t)FLECS_ENGINE_CLUSTER_TOTAL *
-            sizeof(FlecsClusterEntry)
-    };
-    impl->lighting.cluster_grid_buffer = wgpuDeviceCreateBuffer(
-        impl->device, &grid_desc);
+    return flecsEngine_cluster_createViewBuffers(impl);
+}
 
-    /* Light index storage buffer */
-    WGPUBufferDescriptor idx_desc = {
-        .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst,
-        .size = (uint64_t)init_indices * sizeof(uint32_t)
-    };
-    impl->lighting.cluster_index_buffer = wgpuDeviceCreateBuffer(
-        impl->device, &idx_desc);
+int flecsEngine_cluster_ensureViewCapacity(
+    FlecsEngineImpl *engine,
+    int32_t view_capacity)
+{
+    if (view_capacity <= engine->lighting.cluster_view_capacity) {
+        return 0;
+    }
 
-    if (!impl->lighting.light_buffer ||
-        !impl->lighting.cluster_info_buffer || !impl->lighting.cluster_grid_buffer ||
-        !impl->lighting.cluster_index_buffer)
-    {
-        ecs_err("failed to create cluster GPU buffers");
+    engine->lighting.cluster_view_capacity = view_capacity;
+    if (flecsEngine_cluster_createViewBuffers(engine)) {
         return -1;
     }
 
+    /* Scene bind groups reference the cluster buffers */
+    engine->scene_bind_version ++;
     return 0;
 }
 
@@ -101,19 +149,23 @@ void flecsEngine_cluster_cleanup(
     FlecsEngineImpl *impl)
 {
     if (impl->lighting.cluster_index_buffer) {
-        wgpuBufferRelease(impl->lighting.cluster_index_buffer);
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryUniform, impl->lighting.cluster_index_buffer);
         impl->lighting.cluster_index_buffer = NULL;
     }
     if (impl->lighting.cluster_grid_buffer) {
-        wgpuBufferRelease(impl->lighting.cluster_grid_buffer);
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryUniform, impl->lighting.cluster_grid_buffer);
         impl->lighting.cluster_grid_buffer = NULL;
     }
     if (impl->lighting.cluster_info_buffer) {
-        wgpuBufferRelease(impl->lighting.cluster_info_buffer);
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryUniform, impl->lighting.cluster_info_buffer);
         impl->lighting.cluster_info_buffer = NULL;
     }
     if (impl->lighting.light_buffer) {
-        wgpuBufferRelease(impl->lighting.light_buffer);
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryUniform, impl->lighting.light_buffer);
         impl->lighting.light_buffer = NULL;
     }
 
@@ -143,6 +195,7 @@ bool flecsEngine_cluster_ensureLights(
     flecsEngine_cluster_growBuffer(engine->device,
         &engine->lighting.light_buffer, &engine->lighting.light_capacity,
         new_cap, sizeof(FlecsGpuLight));
+    flecsEngine_renderStats_createBuffer(engine);
 
     engine->lighting.cluster_bind_group_dirty = true;
     return true;
@@ -161,12 +214,17 @@ static bool flecsEngine_cluster_ensureIndices(
 
     engine->lighting.cpu_cluster_indices = ecs_os_realloc_n(
         engine->lighting.cpu_cluster_indices, uint32_t, new_cap);
+    engine->lighting.cluster_index_capacity = new_cap;
 
-    bool changed = flecsEngine_cluster_growBuffer(engine->device,
-        &engine->lighting.cluster_index_buffer, &engine->lighting.cluster_index_capacity,
-        new_cap, sizeof(uint32_t));
+    /* Regions of views rendered earlier in the frame are lost, but their
+     * draws were already recorded against the old buffer. */
+    engine->lighting.cluster_index_stride = flecsEngine_uniformStride(
+        (uint64_t)new_cap * sizeof(uint32_t));
+    flecsEngine_cluster_createViewBuffer(engine,
+        &engine->lighting.cluster_index_buffer, WGPUBufferUsage_Storage,
+        engine->lighting.cluster_index_stride);
 
-    return changed;
+    return true; /* buffer changed, bind group must be recreated */
 }
 
 static inline int flecsEngine_cluster_index(int tx, int ty, int sz) {
@@ -319,6 +377,18 @@ void flecsEngine_cluster_build(
     FlecsEngineImpl *engine,
     const FlecsRenderView *view)
 {
+    /* Select the cluster regions of the current view. Set this before
+     * anything else so draws never index outside of the buffers. */
+    int32_t slot = engine->view_uniforms.slot;
+    ecs_assert(slot >= 0 && slot < engine->lighting.cluster_view_capacity,
+        ECS_INTERNAL_ERROR, NULL);
+    engine->lighting.cluster_offsets[0] =
+        (uint32_t)slot * engine->lighting.cluster_info_stride;
+    engine->lighting.cluster_offsets[1] =
+        (uint32_t)slot * engine->lighting.cluster_grid_stride;
+    engine->lighting.cluster_offsets[2] =
+        (uint32_t)slot * engine->lighting.cluster_index_stride;
+
     if (!engine->lighting.cluster_info_buffer || !view->camera) {
         return;
     }
@@ -348,11 +418,12 @@ void flecsEngine_cluster_build(
     FlecsClusterInfo info = {
         .grid_size = { FLECS_ENGINE_CLUSTER_X, FLECS_ENGINE_CLUSTER_Y,
             FLECS_ENGINE_CLUSTER_Z, FLECS_ENGINE_CLUSTER_TOTAL },
-        .screen_info = { (float)engine->actual_width, (float)engine->actual_height,
+        /* Tiles are looked up by fragment position in the render viewport */
+        .screen_info = { (float)engine->render_width, (float)engine->render_height,
             near, log_ratio }
     };
-    wgpuQueueWriteBuffer(engine->queue, engine->lighting.cluster_info_buffer,
-        0, &info, sizeof(info));
+    flecsEngine_queueWriteBuffer(engine, engine->lighting.cluster_info_buffer,
+        engine->lighting.cluster_offsets[0], &info, sizeof(info));
 
     /* --- Two-pass cluster assignment --- */
 
@@ -386,6 +457,10 @@ void flecsEngine_cluster_build(
         engine->lighting.cluster_bind_group_dirty = false;
     }
 
+    /* Index stride changes when the index buffer grows */
+    engine->lighting.cluster_offsets[2] =
+        (uint32_t)slot * engine->lighting.cluster_index_stride;
+
     /* Pass 2: fill index list */
     uint32_t cell_offsets[FLECS_ENGINE_CLUSTER_TOTAL];
     for (int i = 0; i < FLECS_ENGINE_CLUSTER_TOTAL; i++) {
@@ -403,16 +478,16 @@ void flecsEngine_cluster_build(
         cell_offsets, fill_counts, indices);
 
     /* Upload everything to GPU */
-    wgpuQueueWriteBuffer(engine->queue, engine->lighting.cluster_grid_buffer,
-        0, grid, sizeof(grid));
+    flecsEngine_queueWriteBuffer(engine, engine->lighting.cluster_grid_buffer,
+        engine->lighting.cluster_offsets[1], grid, sizeof(grid));
 
     if (total_indices > 0) {
-        wgpuQueueWriteBuffer(engine->queue, engine->lighting.cluster_index_buffer,
-            0, indices, (uint64_t)total_indices * sizeof(uint32_t));
+        flecsEngine_queueWriteBuffer(engine, engine->lighting.cluster_index_buffer,
+            engine->lighting.cluster_offsets[2], indices, (uint64_t)total_indices * sizeof(uint32_t));
     }
 
     if (light_count > 0) {
-        wgpuQueueWriteBuffer(engine->queue, engine->lighting.light_buffer,
+        flecsEngine_queueWriteBuffer(engine, engine->lighting.light_buffer,
             0, engine->lighting.cpu_lights,
             (uint64_t)light_count * sizeof(FlecsGpuLight));
     }
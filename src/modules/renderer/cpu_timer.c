@@ -0,0 +1,218 @@
+#include <stdlib.h>
+
+#include "renderer.h"
+#include "flecs_engine.h"
+
+ECS_COMPONENT_DECLARE(FlecsCpuTiming);
+ECS_COMPONENT_DECLARE(FlecsCpuStageTime);
+ECS_COMPONENT_DECLARE(FlecsCpuFrameStats);
+
+/* Frames that averages and percentiles are computed over */
+#define FLECS_ENGINE_CPU_TIMER_WINDOW (128)
+
+struct flecs_engine_cpu_timer_t {
+    bool enabled;                               /* Timing the current frame */
+    uint64_t start[FlecsCpuStageCount];         /* 0 if the stage isn't timed */
+    double frame[FlecsCpuStageCount];           /* Time of the current frame */
+    float samples[FlecsCpuStageCount + 1][FLECS_ENGINE_CPU_TIMER_WINDOW];
+    int32_t sample_index;
+    int32_t sample_count;
+};
+
+/* Names of stages in traces */
+static const char *flecs_engine_cpu_stage_names[FlecsCpuStageCount] = {
+    [FlecsCpuStageFrustum] = "frustum",
+    [FlecsCpuStageBatchExtract] = "batch_extract",
+    [FlecsCpuStageLights] = "lights",
+    [FlecsCpuStageCluster] = "cluster",
+    [FlecsCpuStageShadow] = "shadow",
+    [FlecsCpuStageBatches] = "batches",
+    [FlecsCpuStageEffects] = "effects",
+    [FlecsCpuStageSubmit] = "submit",
+    [FlecsCpuStageAcquire] = "acquire"
+};
+
+flecs_engine_cpu_timer_t* flecsEngine_cpuTimer_create(void)
+{
+    return ecs_os_calloc_t(flecs_engine_cpu_timer_t);
+}
+
+void flecsEngine_cpuTimer_free(
+    flecs_engine_cpu_timer_t *timer)
+{
+    ecs_os_free(timer);
+}
+
+void flecsEngine_cpuTimer_begin(
+    const FlecsEngineImpl *engine,
+    flecs_engine_cpu_stage_t stage)
+{
+    flecs_engine_cpu_timer_t *timer = engine->cpu_timer;
+    if (!timer || (!timer->enabled && !flecsEngine_trace_enabled())) {
+        return;
+    }
+
+    timer->start[stage] = ecs_os_now();
+}
+
+void flecsEngine_cpuTimer_end(
+    const FlecsEngineImpl *engine,
+    flecs_engine_cpu_stage_t stage)
+{
+    flecs_engine_cpu_timer_t *timer = engine->cpu_timer;
+    if (!timer || !timer->start[stage]) {
+        return;
+    }
+
+    uint64_t start = timer->start[stage], end = ecs_os_now();
+    timer->start[stage] = 0;
+
+    /* Stages that run once per view add up over the frame */
+    if (timer->enabled) {
+        timer->frame[stage] += (double)(end - start) * 1e-9;
+    }
+
+    flecsEngine_trace_complete(start, end, "stage",
+        flecs_engine_cpu_stage_names[stage], NULL);
+}
+
+static int flecsEngine_cpuTimer_compare(
+    const void *a,
+    const void *b)
+{
+    float fa = *(const float*)a, fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+static void flecsEngine_cpuTimer_computeStage(
+    const flecs_engine_cpu_timer_t *timer,
+    int32_t stage,
+    FlecsCpuStageTime *out)
+{
+    int32_t count = timer->sample_count;
+    int32_t last = (timer->sample_index + FLECS_ENGINE_CPU_TIMER_WINDOW - 1) %
+        FLECS_ENGINE_CPU_TIMER_WINDOW;
+
+    float sorted[FLECS_ENGINE_CPU_TIMER_WINDOW];
+    double sum = 0;
+    for (int32_t i = 0; i < count; i ++) {
+        sorted[i] = timer->samples[stage][i];
+        sum += sorted[i];
+    }
+
+    qsort(sorted, (size_t)count, sizeof(float), flecsEngine_cpuTimer_compare);
+
+    /* Nearest rank percentiles */
+    out->last = timer->samples[stage][last];
+    out->avg = (float)(sum / count);
+    out->p50 = sorted[(count - 1) * 50 / 100];
+    out->p95 = sorted[(count - 1) * 95 / 100];
+    out->p99 = sorted[(count - 1) * 99 / 100];
+}
+
+void flecsEngine_cpuTimer_beginFrame(
+    ecs_world_t *world,
+    FlecsEngineImpl *engine)
+{
+    flecs_engine_cpu_timer_t *timer = engine->cpu_timer;
+    if (!timer) {
+        return;
+    }
+
+    /* Close the previous frame, it ends when the next frame is extracted */
+    if (timer->enabled) {
+        int32_t index = timer->sample_index;
+        double total = 0;
+        for (int32_t s = 0; s < FlecsCpuStageCount; s ++) {
+            timer->samples[s][index] = (float)timer->frame[s];
+            total += timer->frame[s];
+        }
+        timer->samples[FlecsCpuStageCount][index] = (float)total;
+
+        timer->sample_index = (index + 1) % FLECS_ENGINE_CPU_TIMER_WINDOW;
+        if (timer->sample_count < FLECS_ENGINE_CPU_TIMER_WINDOW) {
+            timer->sample_count ++;
+        }
+
+        FlecsCpuFrameStats stats = { .sample_count = timer->sample_count };
+        FlecsCpuStageTime *stages[FlecsCpuStageCount + 1] = {
+            [FlecsCpuStageFrustum] = &stats.frustum,
+            [FlecsCpuStageBatchExtract] = &stats.batch_extract,
+            [FlecsCpuStageLights] = &stats.lights,
+            [FlecsCpuStageCluster] = &stats.cluster,
+            [FlecsCpuStageShadow] = &stats.shadow,
+            [FlecsCpuStageBatches] = &stats.batches,
+            [FlecsCpuStageEffects] = &stats.effects,
+            [FlecsCpuStageSubmit] = &stats.submit,
+            [FlecsCpuStageAcquire] = &stats.acquire,
+            [FlecsCpuStageCount] = &stats.total
+        };
+
+        for (int32_t s = 0; s <= FlecsCpuStageCount; s ++) {
+            flecsEngine_cpuTimer_computeStage(timer, s, stages[s]);
+        }
+
+        ecs_singleton_set_ptr(world, FlecsCpuFrameStats, &stats);
+    }
+
+    for (int32_t s = 0; s < FlecsCpuStageCount; s ++) {
+        timer->frame[s] = 0;
+    }
+
+    const FlecsCpuTiming *settings = ecs_singleton_get(world, FlecsCpuTiming);
+    bool enabled = settings && settings->enabled;
+    if (!enabled && timer->enabled) {
+        /* Don't mix windows of separate measuring sessions */
+        timer->sample_index = 0;
+        timer->sample_count = 0;
+    }
+
+    timer->enabled = enabled;
+}
+
+void flecsEngine_cpuTimer_register(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, FlecsCpuTiming);
+    ECS_COMPONENT_DEFINE(world, FlecsCpuStageTime);
+    ECS_COMPONENT_DEFINE(world, FlecsCpuFrameStats);
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsCpuTiming),
+        .members = {
+            { .name = "enabled", .type = ecs_id(ecs_bool_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(FlecsCpuTiming), EcsSingleton);
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsCpuStageTime),
+        .members = {
+            { .name = "last", .type = ecs_id(ecs_f32_t) },
+            { .name = "avg", .type = ecs_id(ecs_f32_t) },
+            { .name = "p50", .type = ecs_id(ecs_f32_t) },
+            { .name = "p95", .type = ecs_id(ecs_f32_t) },
+            { .name = "p99", .type = ecs_id(ecs_f32_t) }
+        }
+    });
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsCpuFrameStats),
+        .members = {
+            { .name = "frustum", .type = ecs_id(FlecsCpuStageTime) },
+            { .name = "batch_extract", .type = ecs_id(FlecsCpuStageTime) },
+            { .name = "lights", .type = ecs_id(FlecsCpuStageTime) },
+            { .name = "cluster", .type = ecs_id(FlecsCpuStageTime) },
+            { .name = "shadow", .type = ecs_id(FlecsCpuStageTime) },
+            { .name = "batches", .type = ecs_id(FlecsCpuStageTime) },
+            { .name = "effects", .type = ecs_id(FlecsCpuStageTime) },
+            { .name = "submit", .type = ecs_id(FlecsCpuStageTime) },
+            { .name = "acquire", .type = ecs_id(FlecsCpuStageTime) },
+            { .name = "total", .type = ecs_id(FlecsCpuStageTime) },
+            { .name = "sample_count", .type = ecs_id(ecs_i32_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(FlecsCpuFrameStats), EcsSingleton);
+}
@@ -0,0 +1,237 @@
+#include <math.h>
+
+#include "renderer.h"
+#include "flecs_engine.h"
+
+ECS_COMPONENT_DECLARE(FlecsDynamicResolution);
+ECS_COMPONENT_DECLARE(FlecsDynamicResolutionState);
+
+/* Weight of a new frame time in the filtered frame time */
+#define FLECS_ENGINE_DYNAMIC_RESOLUTION_SMOOTHING (0.1f)
+
+/* The controller aims this far below the budget. The scale goes down when
+ * the frame time exceeds the budget, and up when it drops below the budget by
+ * twice this amount, so small fluctuations don't change the resolution. */
+#define FLECS_ENGINE_DYNAMIC_RESOLUTION_TOLERANCE (0.05f)
+
+/* Frames to wait after a change, so the filtered frame time can catch up */
+#define FLECS_ENGINE_DYNAMIC_RESOLUTION_COOLDOWN (10)
+
+/* Longer frames are hitches (loading, window events) rather than load */
+#define FLECS_ENGINE_DYNAMIC_RESOLUTION_HITCH (0.25f)
+
+#define FLECS_ENGINE_DYNAMIC_RESOLUTION_MIN_SCALE (0.1f)
+
+FlecsDynamicResolution flecsEngine_dynamicResolutionSettingsDefault(void)
+{
+    return (FlecsDynamicResolution){
+        .target_frame_time = 1.0f / 60.0f,
+        .min_scale = 0.5f,
+        .max_scale = 1.0f,
+        .step = 0.05f,
+        .sharpness = 0.9f
+    };
+}
+
+float flecsEngine_dynamicResolution_update(
+    const FlecsDynamicResolution *settings,
+    FlecsDynamicResolutionState *state,
+    float frame_time)
+{
+    float max_scale = glm_clamp(settings->max_scale,
+        FLECS_ENGINE_DYNAMIC_RESOLUTION_MIN_SCALE, 1.0f);
+    float min_scale = glm_clamp(settings->min_scale,
+        FLECS_ENGINE_DYNAMIC_RESOLUTION_MIN_SCALE, max_scale);
+
+    if (state->scale <= 0.0f) {
+        state->scale = max_scale;
+        state->frame_time = 0.0f;
+        state->cooldown = 0;
+    }
+
+    if (frame_time > 0.0f &&
+        frame_time < FLECS_ENGINE_DYNAMIC_RESOLUTION_HITCH)
+    {
+        if (state->frame_time <= 0.0f) {
+            state->frame_time = frame_time;
+        } else {
+            state->frame_time += (frame_time - state->frame_time) *
+                FLECS_ENGINE_DYNAMIC_RESOLUTION_SMOOTHING;
+        }
+    }
+
+    float budget = settings->target_frame_time;
+
+    if (state->cooldown > 0) {
+        state->cooldown --;
+    } else if (budget > 0.0f && state->frame_time > 0.0f) {
+        float tolerance = FLECS_ENGINE_DYNAMIC_RESOLUTION_TOLERANCE;
+        bool over = state->frame_time > budget;
+        bool under = state->frame_time < budget * (1.0f - 2.0f * tolerance);
+
+        if (over || under) {
+            /* Frame time scales roughly with the number of pixels, which
+             * is quadratic in the scale. */
+            float aim = budget * (1.0f - tolerance);
+            float scale = state->scale * sqrtf(aim / state->frame_time);
+            if (settings->step > 0.0f) {
+                scale = glm_clamp(scale,
+                    state->scale - settings->step,
+                    state->scale + settings->step);
+            }
+            scale = glm_clamp(scale, min_scale, max_scale);
+
+            if (scale != state->scale) {
+                state->scale = scale;
+                state->cooldown = FLECS_ENGINE_DYNAMIC_RESOLUTION_COOLDOWN;
+            }
+        }
+    }
+
+    state->scale = glm_clamp(state->scale, min_scale, max_scale);
+    return state->scale;
+}
+
+/* GPU time of all views in the newest timed frame. Returns 0 if no frame was
+ * timed since the last call, as timings arrive a few frames late. */
+static float flecsEngine_dynamicResolution_gpuTime(
+    const ecs_world_t *world,
+    FlecsEngineImpl *engine)
+{
+    int64_t newest = -1;
+    float time = 0.0f;
+
+    ecs_iter_t it = ecs_query_iter(world, engine->view_query);
+    while (ecs_query_next(&it)) {
+        for (int32_t i = 0; i < it.count; i ++) {
+            const FlecsRenderViewGpuTime *t = ecs_get(
+                world, it.entities[i], FlecsRenderViewGpuTime);
+            if (!t || t->frame < newest) {
+                continue;
+            }
+            if (t->frame > newest) {
+                newest = t->frame;
+                time = 0.0f;
+            }
+            time += t->total_time;
+        }
+    }
+
+    if (newest < engine->dynamic_resolution_gpu_frame) {
+        return 0.0f;
+    }
+
+    engine->dynamic_resolution_gpu_frame = newest + 1;
+    return time;
+}
+
+/* With vsync the frame delta is pinned to the refresh interval, which hides
+ * how much headroom there is. The controller is driven by the GPU time of the
+ * frame when GPU timing is on, otherwise by the CPU work of the frame. The
+ * delta is only used when neither is measured. */
+static float flecsEngine_dynamicResolution_frameTime(
+    const ecs_world_t *world,
+    FlecsEngineImpl *engine,
+    float delta_time)
+{
+    const FlecsGpuTiming *gpu = ecs_singleton_get(world, FlecsGpuTiming);
+    if (engine->gpu_timer && engine->view_query && gpu && gpu->enabled) {
+        return flecsEngine_dynamicResolution_gpuTime(world, engine);
+    }
+
+    const FlecsCpuTiming *cpu = ecs_singleton_get(world, FlecsCpuTiming);
+    const FlecsCpuFrameStats *stats = ecs_singleton_get(
+        world, FlecsCpuFrameStats);
+    if (cpu && cpu->enabled && stats && stats->sample_count) {
+        return stats->total.last;
+    }
+
+    return delta_time;
+}
+
+void flecsEngine_dynamicResolution_begin(
+    const ecs_world_t *world,
+    FlecsEngineImpl *engine,
+    float delta_time)
+{
+    const FlecsDynamicResolution *settings = ecs_singleton_get(
+        world, FlecsDynamicResolution);
+
+    float scale = 1.0f;
+    if (settings) {
+        float frame_time = flecsEngine_dynamicResolution_frameTime(
+            world, engine, delta_time);
+        scale = flecsEngine_dynamicResolution_update(
+            settings, &engine->dynamic_resolution, frame_time);
+        engine->upscale.sharpness = settings->sharpness;
+    } else {
+        ecs_os_zeromem(&engine->dynamic_resolution);
+        engine->upscale.sharpness =
+            flecsEngine_dynamicResolutionSettingsDefault().sharpness;
+    }
+
+    /* View targets stay at the actual size, only the viewport is scaled */
+    int32_t width = (int32_t)((float)engine->actual_width * scale + 0.5f);
+    int32_t height = (int32_t)((float)engine->actual_height * scale + 0.5f);
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+    if (width > engine->actual_width) width = engine->actual_width;
+    if (height > engine->actual_height) height = engine->actual_height;
+
+    engine->render_width = width;
+    engine->render_height = height;
+}
+
+void flecsEngine_dynamicResolution_publishStats(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine)
+{
+    const FlecsDynamicResolutionState *state = &engine->dynamic_resolution;
+    const FlecsDynamicResolutionState *published = ecs_singleton_get(
+        world, FlecsDynamicResolutionState);
+
+    if (state->scale <= 0.0f) {
+        if (published) {
+            ecs_singleton_remove(world, FlecsDynamicResolutionState);
+        }
+        return;
+    }
+
+    /* The filtered frame time changes every frame, only publish when the
+     * resolution changes. */
+    if (published && published->scale == state->scale) {
+        return;
+    }
+
+    ecs_singleton_set_ptr(world, FlecsDynamicResolutionState, state);
+}
+
+void flecsEngine_dynamicResolution_register(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, FlecsDynamicResolution);
+    ECS_COMPONENT_DEFINE(world, FlecsDynamicResolutionState);
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsDynamicResolution),
+        .members = {
+            { .name = "target_frame_time", .type = ecs_id(ecs_f32_t) },
+            { .name = "min_scale", .type = ecs_id(ecs_f32_t) },
+            { .name = "max_scale", .type = ecs_id(ecs_f32_t) },
+            { .name = "step", .type = ecs_id(ecs_f32_t) },
+            { .name = "sharpness", .type = ecs_id(ecs_f32_t) }
+        }
+    });
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsDynamicResolutionState),
+        .members = {
+            { .name = "scale", .type = ecs_id(ecs_f32_t) },
+            { .name = "frame_time", .type = ecs_id(ecs_f32_t) },
+            { .name = "cooldown", .type = ecs_id(ecs_i32_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(FlecsDynamicResolution), EcsSingleton);
+    ecs_add_id(world, ecs_id(FlecsDynamicResolutionState), EcsSingleton);
+}
@@ -9,6 +9,16 @@ ECS_COMPONENT_DECLARE(FlecsBloomImpl);
 #define FLECS_ENGINE_BLOOM_PREFERRED_TEXTURE_FORMAT (WGPUTextureFormat_RG11B10Ufloat)
 #define FLECS_ENGINE_BLOOM_MAX_MIP_COUNT (12u)
 
+/* The compute path produces two mips per dispatch, in both directions */
+#define FLECS_ENGINE_BLOOM_MAX_DISPATCH_COUNT (FLECS_ENGINE_BLOOM_MAX_MIP_COUNT)
+#define FLECS_ENGINE_BLOOM_DISPATCH_UNIFORM_STRIDE (256u)
+#define FLECS_ENGINE_BLOOM_COMPUTE_FORMAT (WGPUTextureFormat_RGBA16Float)
+
+/* Texels of the first mip a downsample workgroup owns, and of the second mip
+ * it produces from workgroup memory. */
+#define FLECS_ENGINE_BLOOM_DOWNSAMPLE_TILE (32u)
+#define FLECS_ENGINE_BLOOM_UPSAMPLE_TILE (16u)
+
 typedef struct FlecsBloomUniform {
     float threshold_precomputations[4];
     float viewport[4];
@@ -17,110 +27,307 @@ typedef struct FlecsBloomUniform {
     float _padding;
 } FlecsBloomUniform;
 
+typedef struct FlecsBloomDispatchUniform {
+    float blend[2];
+    uint32_t first;
+    uint32_t levels;
+} FlecsBloomDispatchUniform;
+
+/* Dispatch of the compute path. Downsamples write mip level (and level + 1),
+ * upsamples read mip level and write level - levels. */
+typedef struct {
+    bool upsample;
+    uint32_t level;
+    uint32_t levels;
+} flecs_bloom_dispatch_t;
+
 static const char *kPlaceholderShaderSource =
     FLECS_ENGINE_FULLSCREEN_VS_WGSL
     "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n"
     "@group(0) @binding(1) var input_sampler : sampler;\n"
     "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
-    "  return textureSample(input_texture, input_sampler, in.uv);\n"
+    "  return textureSample(input_texture, input_sampler,\n"
+    "    fullscreen_uv(in.pos, textureDimensions(input_texture)));\n"
     "}\n";
 
+/* Filters shared by the render and compute path. Samples use an explicit
+ * level so the same code runs in fragment and compute shaders. */
+#define FLECS_ENGINE_BLOOM_COMMON_WGSL \
+    "struct BloomUniforms {\n" \
+    "  threshold_precomputations : vec4<f32>,\n" \
+    "  viewport : vec4<f32>,\n" \
+    "  scale : vec2<f32>,\n" \
+    "  aspect : f32,\n" \
+    "  _padding : f32,\n" \
+    "};\n" \
+    "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n" \
+    "@group(0) @binding(1) var bloom_sampler : sampler;\n" \
+    "@group(0) @binding(2) var<uniform> uniforms : BloomUniforms;\n" \
+    "fn soft_threshold(color : vec3<f32>) -> vec3<f32> {\n" \
+    "  let brightness = max(color.r, max(color.g, color.b));\n" \
+    "  var softness = brightness - uniforms.threshold_precomputations.y;\n" \
+    "  softness = clamp(softness, 0.0, uniforms.threshold_precomputations.z);\n" \
+    "  softness = softness * softness * uniforms.threshold_precomputations.w;\n" \
+    "  var contribution = max(brightness - uniforms.threshold_precomputations.x, softness);\n" \
+    "  contribution /= max(brightness, 0.00001);\n" \
+    "  return color * contribution;\n" \
+    "}\n" \
+    "fn tonemapping_luminance(v : vec3<f32>) -> f32 {\n" \
+    "  return dot(v, vec3<f32>(0.2126, 0.7152, 0.0722));\n" \
+    "}\n" \
+    "fn karis_average(color : vec3<f32>) -> f32 {\n" \
+    "  let luma = tonemapping_luminance(color) / 4.0;\n" \
+    "  return 1.0 / (1.0 + luma);\n" \
+    "}\n" \
+    "fn bloom_13_tap(a : vec3<f32>, b : vec3<f32>, c : vec3<f32>,\n" \
+    "  d : vec3<f32>, e : vec3<f32>, f : vec3<f32>, g : vec3<f32>,\n" \
+    "  h : vec3<f32>, i : vec3<f32>, j : vec3<f32>, k : vec3<f32>,\n" \
+    "  l : vec3<f32>, m : vec3<f32>, first_downsample : bool) -> vec3<f32>\n" \
+    "{\n" \
+    "  if (first_downsample) {\n" \
+    "    var group0 = (a + b + d + e) * (0.125 / 4.0);\n" \
+    "    var group1 = (b + c + e + f) * (0.125 / 4.0);\n" \
+    "    var group2 = (d + e + g + h) * (0.125 / 4.0);\n" \
+    "    var group3 = (e + f + h + i) * (0.125 / 4.0);\n" \
+    "    var group4 = (j + k + l + m) * (0.5 / 4.0);\n" \
+    "    group0 *= karis_average(group0);\n" \
+    "    group1 *= karis_average(group1);\n" \
+    "    group2 *= karis_average(group2);\n" \
+    "    group3 *= karis_average(group3);\n" \
+    "    group4 *= karis_average(group4);\n" \
+    "    return group0 + group1 + group2 + group3 + group4;\n" \
+    "  }\n" \
+    "  var sample = (a + c + g + i) * 0.03125;\n" \
+    "  sample += (b + d + f + h) * 0.0625;\n" \
+    "  sample += (e + j + k + l + m) * 0.125;\n" \
+    "  return sample;\n" \
+    "}\n" \
+    "fn bloom_tent(a : vec3<f32>, b : vec3<f32>, c : vec3<f32>,\n" \
+    "  d : vec3<f32>, e : vec3<f32>, f : vec3<f32>, g : vec3<f32>,\n" \
+    "  h : vec3<f32>, i : vec3<f32>) -> vec3<f32>\n" \
+    "{\n" \
+    "  var sample = e * 0.25;\n" \
+    "  sample += (b + d + f + h) * 0.125;\n" \
+    "  sample += (a + c + g + i) * 0.0625;\n" \
+    "  return sample;\n" \
+    "}\n" \
+    "fn sample_input(uv : vec2<f32>) -> vec3<f32> {\n" \
+    "  return textureSampleLevel(input_texture, bloom_sampler, uv, 0.0).rgb;\n" \
+    "}\n" \
+    "fn sample_input_13_tap(uv : vec2<f32>, first_downsample : bool) -> vec3<f32> {\n" \
+    "  let ps = uniforms.scale / vec2<f32>(textureDimensions(input_texture));\n" \
+    "  let pl = 2.0 * ps;\n" \
+    "  let ns = -1.0 * ps;\n" \
+    "  let nl = -2.0 * ps;\n" \
+    "  return bloom_13_tap(\n" \
+    "    sample_input(uv + vec2<f32>(nl.x, pl.y)),\n" \
+    "    sample_input(uv + vec2<f32>(0.00, pl.y)),\n" \
+    "    sample_input(uv + vec2<f32>(pl.x, pl.y)),\n" \
+    "    sample_input(uv + vec2<f32>(nl.x, 0.00)),\n" \
+    "    sample_input(uv),\n" \
+    "    sample_input(uv + vec2<f32>(pl.x, 0.00)),\n" \
+    "    sample_input(uv + vec2<f32>(nl.x, nl.y)),\n" \
+    "    sample_input(uv + vec2<f32>(0.00, nl.y)),\n" \
+    "    sample_input(uv + vec2<f32>(pl.x, nl.y)),\n" \
+    "    sample_input(uv + vec2<f32>(ns.x, ps.y)),\n" \
+    "    sample_input(uv + vec2<f32>(ps.x, ps.y)),\n" \
+    "    sample_input(uv + vec2<f32>(ns.x, ns.y)),\n" \
+    "    sample_input(uv + vec2<f32>(ps.x, ns.y)),\n" \
+    "    first_downsample);\n" \
+    "}\n" \
+    "fn sample_input_3x3_tent(uv : vec2<f32>) -> vec3<f32> {\n" \
+    "  let frag_size = uniforms.scale / vec2<f32>(textureDimensions(input_texture));\n" \
+    "  let x = frag_size.x;\n" \
+    "  let y = frag_size.y;\n" \
+    "  return bloom_tent(\n" \
+    "    sample_input(vec2<f32>(uv.x - x, uv.y + y)),\n" \
+    "    sample_input(vec2<f32>(uv.x, uv.y + y)),\n" \
+    "    sample_input(vec2<f32>(uv.x + x, uv.y + y)),\n" \
+    "    sample_input(vec2<f32>(uv.x - x, uv.y)),\n" \
+    "    sample_input(vec2<f32>(uv.x, uv.y)),\n" \
+    "    sample_input(vec2<f32>(uv.x + x, uv.y)),\n" \
+    "    sample_input(vec2<f32>(uv.x - x, uv.y - y)),\n" \
+    "    sample_input(vec2<f32>(uv.x, uv.y - y)),\n" \
+    "    sample_input(vec2<f32>(uv.x + x, uv.y - y)));\n" \
+    "}\n" \
+    "fn bloom_downsample_first(output_uv : vec2<f32>) -> vec3<f32> {\n" \
+    "  let sample_uv = uniforms.viewport.xy + output_uv * uniforms.viewport.zw;\n" \
+    "  var sample = sample_input_13_tap(sample_uv, true);\n" \
+    "  sample = clamp(sample, vec3<f32>(0.0001), vec3<f32>(3.40282347e+37));\n" \
+    "  if (uniforms.threshold_precomputations.x > 0.0 || uniforms.threshold_precomputations.z > 0.0) {\n" \
+    "    sample = soft_threshold(sample);\n" \
+    "  }\n" \
+    "  return sample;\n" \
+    "}\n"
+
 static const char *kBloomShaderSource =
     FLECS_ENGINE_FULLSCREEN_VS_WGSL
-    "struct BloomUniforms {\n"
-    "  threshold_precomputations : vec4<f32>,\n"
-    "  viewport : vec4<f32>,\n"
-    "  scale : vec2<f32>,\n"
-    "  aspect : f32,\n"
-    "  _padding : f32,\n"
+    FLECS_ENGINE_BLOOM_COMMON_WGSL
+    "@fragment fn downsample_first(@location(0) output_uv : vec2<f32>) -> @location(0) vec4<f32> {\n"
+    "  return vec4<f32>(bloom_downsample_first(output_uv), 1.0);\n"
+    "}\n"
+    "@fragment fn downsample(@location(0) uv : vec2<f32>) -> @location(0) vec4<f32> {\n"
+    "  return vec4<f32>(sample_input_13_tap(uv, false), 1.0);\n"
+    "}\n"
+    "@fragment fn upsample(@location(0) uv : vec2<f32>) -> @location(0) vec4<f32> {\n"
+    "  return vec4<f32>(sample_input_3x3_tent(uv), 1.0);\n"
+    "}\n";
+
+/* Compute path. A downsample workgroup filters a 32x32 tile of the first mip
+ * plus a 4 texel border into workgroup memory, then filters the 16x16 tile of
+ * the next mip from there. An upsample workgroup does the same for a 16x16
+ * tile of the intermediate mip, so each dispatch produces two mips without a
+ * round-trip through memory. Texels in workgroup memory are rounded to half
+ * floats, so they hold the same values the render path stores. The manual
+ * bilinear filter assumes taps are at most one texel apart (scale <= 1). */
+static const char *kBloomComputeShaderSource =
+    FLECS_ENGINE_BLOOM_COMMON_WGSL
+    "struct BloomDispatch {\n"
+    "  blend : vec2<f32>,\n"
+    "  is_first : u32,\n"
+    "  levels : u32,\n"
     "};\n"
-    "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n"
-    "@group(0) @binding(1) var bloom_sampler : sampler;\n"
-    "@group(0) @binding(2) var<uniform> uniforms : BloomUniforms;\n"
-    "fn soft_threshold(color : vec3<f32>) -> vec3<f32> {\n"
-    "  let brightness = max(color.r, max(color.g, color.b));\n"
-    "  var softness = brightness - uniforms.threshold_precomputations.y;\n"
-    "  softness = clamp(softness, 0.0, uniforms.threshold_precomputations.z);\n"
-    "  softness = softness * softness * uniforms.threshold_precomputations.w;\n"
-    "  var contribution = max(brightness - uniforms.threshold_precomputations.x, softness);\n"
-    "  contribution /= max(brightness, 0.00001);\n"
-    "  return color * contribution;\n"
+    "struct BloomTile {\n"
+    "  origin : vec2<i32>,\n"
+    "  stride : i32,\n"
+    "  size : vec2<i32>,\n"
+    "};\n"
+    "@group(0) @binding(3) var<uniform> pass_params : BloomDispatch;\n"
+    "@group(0) @binding(4) var base_a : texture_2d<f32>;\n"
+    "@group(0) @binding(5) var base_b : texture_2d<f32>;\n"
+    "@group(0) @binding(6) var out_a : texture_storage_2d<rgba16float, write>;\n"
+    "@group(0) @binding(7) var out_b : texture_storage_2d<rgba16float, write>;\n"
+    "var<workgroup> tile : array<vec2<u32>, 1600>;\n"
+    "fn tile_store(index : u32, color : vec3<f32>) {\n"
+    "  tile[index] = vec2<u32>(pack2x16float(color.rg),\n"
+    "    pack2x16float(vec2<f32>(color.b, 0.0)));\n"
     "}\n"
-    "fn tonemapping_luminance(v : vec3<f32>) -> f32 {\n"
-    "  return dot(v, vec3<f32>(0.2126, 0.7152, 0.0722));\n"
+    "fn tile_load(t : BloomTile, texel : vec2<i32>) -> vec3<f32> {\n"
+    "  let p = clamp(texel, vec2<i32>(0), t.size - 1) - t.origin;\n"
+    "  let v = tile[u32(p.y * t.stride + p.x)];\n"
+    "  return vec3<f32>(unpack2x16float(v.x), unpack2x16float(v.y).x);\n"
     "}\n"
-    "fn karis_average(color : vec3<f32>) -> f32 {\n"
-    "  let luma = tonemapping_luminance(color) / 4.0;\n"
-    "  return 1.0 / (1.0 + luma);\n"
+    "fn tile_sample(t : BloomTile, uv : vec2<f32>) -> vec3<f32> {\n"
+    "  let p = uv * vec2<f32>(t.size) - 0.5;\n"
+    "  let base = floor(p);\n"
+    "  let w = p - base;\n"
+    "  let i = vec2<i32>(base);\n"
+    "  let c00 = tile_load(t, i);\n"
+    "  let c10 = tile_load(t, i + vec2<i32>(1, 0));\n"
+    "  let c01 = tile_load(t, i + vec2<i32>(0, 1));\n"
+    "  let c11 = tile_load(t, i + vec2<i32>(1, 1));\n"
+    "  return mix(mix(c00, c10, w.x), mix(c01, c11, w.x), w.y);\n"
     "}\n"
-    "fn sample_input_13_tap(uv : vec2<f32>, first_downsample : bool) -> vec3<f32> {\n"
-    "  let ps = uniforms.scale / vec2<f32>(textureDimensions(input_texture));\n"
+    "fn tile_13_tap(t : BloomTile, uv : vec2<f32>) -> vec3<f32> {\n"
+    "  let ps = uniforms.scale / vec2<f32>(t.size);\n"
     "  let pl = 2.0 * ps;\n"
     "  let ns = -1.0 * ps;\n"
     "  let nl = -2.0 * ps;\n"
-    "  let a = textureSample(input_texture, bloom_sampler, uv + vec2<f32>(nl.x, pl.y)).rgb;\n"
-    "  let b = textureSample(input_texture, bloom_sampler, uv + vec2<f32>(0.00, pl.y)).rgb;\n"
-    "  let c = textureSample(input_texture, bloom_sampler, uv + vec2<f32>(pl.x, pl.y)).rgb;\n"
-    "  let d = textureSample(input_texture, bloom_sampler, uv + vec2<f32>(nl.x, 0.00)).rgb;\n"
-    "  let e = textureSample(input_texture, bloom_sampler, uv).rgb;\n"
-    "  let f = textureSample(input_texture, bloom_sampler, uv + vec2<f32>(pl.x, 0.00)).rgb;\n"
-    "  let g = textureSample(input_texture, bloom_sampler, uv + vec2<f32>(nl.x, nl.y)).rgb;\n"
-    "  let h = textureSample(input_texture, bloom_sampler, uv + vec2<f32>(0.00, nl.y)).rgb;\n"
-    "  let i = textureSample(input_texture, bloom_sampler, uv + vec2<f32>(pl.x, nl.y)).rgb;\n"
-    "  let j = textureSample(input_texture, bloom_sampler, uv + vec2<f32>(ns.x, ps.y)).rgb;\n"
-    "  let k = textureSample(input_texture, bloom_sampler, uv + vec2<f32>(ps.x, ps.y)).rgb;\n"
-    "  let l = textureSample(input_texture, bloom_sampler, uv + vec2<f32>(ns.x, ns.y)).rgb;\n"
-    "  let m = textureSample(input_texture, bloom_sampler, uv + vec2<f32>(ps.x, ns.y)).rgb;\n"
-    "  if (first_downsample) {\n"
-    "    var group0 = (a + b + d + e) * (0.125 / 4.0);\n"
-    "    var group1 = (b + c + e + f) * (0.125 / 4.0);\n"
-    "    var group2 = (d + e + g + h) * (0.125 / 4.0);\n"
-    "    var group3 = (e + f + h + i) * (0.125 / 4.0);\n"
-    "    var group4 = (j + k + l + m) * (0.5 / 4.0);\n"
-    "    group0 *= karis_average(group0);\n"
-    "    group1 *= karis_average(group1);\n"
-    "    group2 *= karis_average(group2);\n"
-    "    group3 *= karis_average(group3);\n"
-    "    group4 *= karis_average(group4);\n"
-    "    return group0 + group1 + group2 + group3 + group4;\n"
-    "  }\n"
-    "  var sample = (a + c + g + i) * 0.03125;\n"
-    "  sample += (b + d + f + h) * 0.0625;\n"
-    "  sample += (e + j + k + l + m) * 0.125;\n"
-    "  return sample;\n"
+    "  return bloom_13_tap(\n"
+    "    tile_sample(t, uv + vec2<f32>(nl.x, pl.y)),\n"
+    "    tile_sample(t, uv + vec2<f32>(0.00, pl.y)),\n"
+    "    tile_sample(t, uv + vec2<f32>(pl.x, pl.y)),\n"
+    "    tile_sample(t, uv + vec2<f32>(nl.x, 0.00)),\n"
+    "    tile_sample(t, uv),\n"
+    "    tile_sample(t, uv + vec2<f32>(pl.x, 0.00)),\n"
+    "    tile_sample(t, uv + vec2<f32>(nl.x, nl.y)),\n"
+    "    tile_sample(t, uv + vec2<f32>(0.00, nl.y)),\n"
+    "    tile_sample(t, uv + vec2<f32>(pl.x, nl.y)),\n"
+    "    tile_sample(t, uv + vec2<f32>(ns.x, ps.y)),\n"
+    "    tile_sample(t, uv + vec2<f32>(ps.x, ps.y)),\n"
+    "    tile_sample(t, uv + vec2<f32>(ns.x, ns.y)),\n"
+    "    tile_sample(t, uv + vec2<f32>(ps.x, ns.y)),\n"
+    "    false);\n"
     "}\n"
-    "fn sample_input_3x3_tent(uv : vec2<f32>) -> vec3<f32> {\n"
-    "  let frag_size = uniforms.scale / vec2<f32>(textureDimensions(input_texture));\n"
+    "fn tile_tent(t : BloomTile, uv : vec2<f32>) -> vec3<f32> {\n"
+    "  let frag_size = uniforms.scale / vec2<f32>(t.size);\n"
     "  let x = frag_size.x;\n"
     "  let y = frag_size.y;\n"
-    "  let a = textureSample(input_texture, bloom_sampler, vec2<f32>(uv.x - x, uv.y + y)).rgb;\n"
-    "  let b = textureSample(input_texture, bloom_sampler, vec2<f32>(uv.x, uv.y + y)).rgb;\n"
-    "  let c = textureSample(input_texture, bloom_sampler, vec2<f32>(uv.x + x, uv.y + y)).rgb;\n"
-    "  let d = textureSample(input_texture, bloom_sampler, vec2<f32>(uv.x - x, uv.y)).rgb;\n"
-    "  let e = textureSample(input_texture, bloom_sampler, vec2<f32>(uv.x, uv.y)).rgb;\n"
-    "  let f = textureSample(input_texture, bloom_sampler, vec2<f32>(uv.x + x, uv.y)).rgb;\n"
-    "  let g = textureSample(input_texture, bloom_sampler, vec2<f32>(uv.x - x, uv.y - y)).rgb;\n"
-    "  let h = textureSample(input_texture, bloom_sampler, vec2<f32>(uv.x, uv.y - y)).rgb;\n"
-    "  let i = textureSample(input_texture, bloom_sampler, vec2<f32>(uv.x + x, uv.y - y)).rgb;\n"
-    "  var sample = e * 0.25;\n"
-    "  sample += (b + d + f + h) * 0.125;\n"
-    "  sample += (a + c + g + i) * 0.0625;\n"
-    "  return sample;\n"
+    "  return bloom_tent(\n"
+    "    tile_sample(t, vec2<f32>(uv.x - x, uv.y + y)),\n"
+    "    tile_sample(t, vec2<f32>(uv.x, uv.y + y)),\n"
+    "    tile_sample(t, vec2<f32>(uv.x + x, uv.y + y)),\n"
+    "    tile_sample(t, vec2<f32>(uv.x - x, uv.y)),\n"
+    "    tile_sample(t, vec2<f32>(uv.x, uv.y)),\n"
+    "    tile_sample(t, vec2<f32>(uv.x + x, uv.y)),\n"
+    "    tile_sample(t, vec2<f32>(uv.x - x, uv.y - y)),\n"
+    "    tile_sample(t, vec2<f32>(uv.x, uv.y - y)),\n"
+    "    tile_sample(t, vec2<f32>(uv.x + x, uv.y - y)));\n"
     "}\n"
-    "@fragment fn downsample_first(@location(0) output_uv : vec2<f32>) -> @location(0) vec4<f32> {\n"
-    "  let sample_uv = uniforms.viewport.xy + output_uv * uniforms.viewport.zw;\n"
-    "  var sample = sample_input_13_tap(sample_uv, true);\n"
-    "  sample = clamp(sample, vec3<f32>(0.0001), vec3<f32>(3.40282347e+37));\n"
-    "  if (uniforms.threshold_precomputations.x > 0.0 || uniforms.threshold_precomputations.z > 0.0) {\n"
-    "    sample = soft_threshold(sample);\n"
+    "fn texel_uv(texel : vec2<i32>, size : vec2<i32>) -> vec2<f32> {\n"
+    "  return (vec2<f32>(texel) + 0.5) / vec2<f32>(size);\n"
+    "}\n"
+    "@compute @workgroup_size(16, 16)\n"
+    "fn downsample(@builtin(workgroup_id) wg : vec3<u32>,\n"
+    "  @builtin(local_invocation_id) lid : vec3<u32>,\n"
+    "  @builtin(local_invocation_index) li : u32)\n"
+    "{\n"
+    "  let size_a = vec2<i32>(textureDimensions(out_a));\n"
+    "  let owned = vec2<i32>(wg.xy) * 32;\n"
+    "  var border = 0;\n"
+    "  if (pass_params.levels > 1u) {\n"
+    "    border = 4;\n"
+    "  }\n"
+    "  let stride = 32 + 2 * border;\n"
+    "  let origin = owned - vec2<i32>(border);\n"
+    "  let region = u32(stride * stride);\n"
+    "  for (var k = 0u; k < (region + 255u) / 256u; k ++) {\n"
+    "    let index = li + k * 256u;\n"
+    "    if (index < region) {\n"
+    "      let p = origin + vec2<i32>(i32(index) % stride, i32(index) / stride);\n"
+    "      let texel = clamp(p, vec2<i32>(0), size_a - 1);\n"
+    "      let uv = texel_uv(texel, size_a);\n"
+    "      var color : vec3<f32>;\n"
+    "      if (pass_params.is_first != 0u) {\n"
+    "        color = bloom_downsample_first(uv);\n"
+    "      } else {\n"
+    "        color = sample_input_13_tap(uv, false);\n"
+    "      }\n"
+    "      tile_store(index, color);\n"
+    "      if (all(p == texel) && all(p >= owned) && all(p < owned + 32)) {\n"
+    "        textureStore(out_a, p, vec4<f32>(color, 1.0));\n"
+    "      }\n"
+    "    }\n"
+    "  }\n"
+    "  if (pass_params.levels < 2u) {\n"
+    "    return;\n"
+    "  }\n"
+    "  workgroupBarrier();\n"
+    "  let size_b = vec2<i32>(textureDimensions(out_b));\n"
+    "  let q = vec2<i32>(wg.xy) * 16 + vec2<i32>(lid.xy);\n"
+    "  if (all(q < size_b)) {\n"
+    "    let t = BloomTile(origin, stride, size_a);\n"
+    "    textureStore(out_b, q, vec4<f32>(tile_13_tap(t, texel_uv(q, size_b)), 1.0));\n"
     "  }\n"
-    "  return vec4<f32>(sample, 1.0);\n"
     "}\n"
-    "@fragment fn downsample(@location(0) uv : vec2<f32>) -> @location(0) vec4<f32> {\n"
-    "  return vec4<f32>(sample_input_13_tap(uv, false), 1.0);\n"
+    "fn upsample_texel(texel : vec2<i32>, size : vec2<i32>) -> vec3<f32> {\n"
+    "  return textureLoad(base_a, texel, 0).rgb +\n"
+    "    pass_params.blend.x * sample_input_3x3_tent(texel_uv(texel, size));\n"
     "}\n"
-    "@fragment fn upsample(@location(0) uv : vec2<f32>) -> @location(0) vec4<f32> {\n"
-    "  return vec4<f32>(sample_input_3x3_tent(uv), 1.0);\n"
+    "@compute @workgroup_size(16, 16)\n"
+    "fn upsample(@builtin(workgroup_id) wg : vec3<u32>,\n"
+    "  @builtin(local_invocation_id) lid : vec3<u32>,\n"
+    "  @builtin(local_invocation_index) li : u32)\n"
+    "{\n"
+    "  let size_a = vec2<i32>(textureDimensions(base_a));\n"
+    "  let q = vec2<i32>(wg.xy) * 16 + vec2<i32>(lid.xy);\n"
+    "  if (pass_params.levels < 2u) {\n"
+    "    if (all(q < size_a)) {\n"
+    "      textureStore(out_a, q, vec4<f32>(upsample_texel(q, size_a), 1.0));\n"
+    "    }\n"
+    "    return;\n"
+    "  }\n"
+    "  let origin = vec2<i32>(wg.xy) * 8 - vec2<i32>(4);\n"
+    "  let texel = clamp(origin + vec2<i32>(lid.xy), vec2<i32>(0), size_a - 1);\n"
+    "  tile_store(li, upsample_texel(texel, size_a));\n"
+    "  workgroupBarrier();\n"
+    "  let size_b = vec2<i32>(textureDimensions(base_b));\n"
+    "  if (all(q < size_b)) {\n"
+    "    let t = BloomTile(origin, 16, size_a);\n"
+    "    let color = textureLoad(base_b, q, 0).rgb +\n"
+    "      pass_params.blend.y * tile_tent(t, texel_uv(q, size_b));\n"
+    "    textureStore(out_a, q, vec4<f32>(color, 1.0));\n"
+    "  }\n"
     "}\n";
 
 FlecsBloom flecsEngine_bloomSettingsDefault(void)
@@ -177,9 +384,71 @@ static void flecsEngine_bloom_computeTextureSize(
     *out_height = height;
 }
 
+static void flecsEngine_bloom_releaseComputeTexture(
+    FlecsBloomImpl *bloom)
+{
+    flecsEngine_bindGroupCache_fini(&bloom->compute_input_bind_groups);
+
+    if (bloom->compute_bind_groups) {
+        for (uint32_t i = 0; i < bloom->compute_dispatch_count; i ++) {
+            if (bloom->compute_bind_groups[i]) {
+                wgpuBindGroupRelease(bloom->compute_bind_groups[i]);
+            }
+        }
+        ecs_os_free(bloom->compute_bind_groups);
+        bloom->compute_bind_groups = NULL;
+    }
+
+    if (bloom->upsample_bind_group) {
+        wgpuBindGroupRelease(bloom->upsample_bind_group);
+        bloom->upsample_bind_group = NULL;
+    }
+
+    if (bloom->upsample_views) {
+        for (uint32_t i = 0; i + 1u < bloom->mip_count; i ++) {
+            if (bloom->upsample_views[i]) {
+                wgpuTextureViewRelease(bloom->upsample_views[i]);
+            }
+        }
+        ecs_os_free(bloom->upsample_views);
+        bloom->upsample_views = NULL;
+    }
+
+    if (bloom->upsample_texture) {
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryEffect, bloom->upsample_texture);
+        bloom->upsample_texture = NULL;
+    }
+
+    if (bloom->dummy_storage_view) {
+        wgpuTextureViewRelease(bloom->dummy_storage_view);
+        bloom->dummy_storage_view = NULL;
+    }
+
+    if (bloom->dummy_storage_texture) {
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryEffect, bloom->dummy_storage_texture);
+        bloom->dummy_storage_texture = NULL;
+    }
+
+    bloom->compute_dispatch_count = 0;
+}
+
 static void flecsEngine_bloom_releaseTexture(
     FlecsBloomImpl *bloom)
 {
+    flecsEngine_bloom_releaseComputeTexture(bloom);
+
+    if (bloom->mip_bind_groups) {
+        for (uint32_t i = 0; i < bloom->mip_count; i ++) {
+            if (bloom->mip_bind_groups[i]) {
+                wgpuBindGroupRelease(bloom->mip_bind_groups[i]);
+            }
+        }
+        ecs_os_free(bloom->mip_bind_groups);
+        bloom->mip_bind_groups = NULL;
+    }
+
     if (bloom->mip_views) {
         for (uint32_t i = 0; i < bloom->mip_count; i ++) {
             if (bloom->mip_views[i]) {
@@ -191,7 +460,8 @@ static void flecsEngine_bloom_releaseTexture(
     }
 
     if (bloom->texture) {
-        wgpuTextureRelease(bloom->texture);
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryEffect, bloom->texture);
         bloom->texture = NULL;
     }
 
@@ -199,18 +469,42 @@ static void flecsEngine_bloom_releaseTexture(
     bloom->texture_width = 0;
     bloom->texture_height = 0;
     bloom->texture_format = WGPUTextureFormat_Undefined;
+    bloom->texture_compute = false;
 }
 
 static void flecsEngine_bloom_releaseResources(
     FlecsBloomImpl *bloom)
 {
     flecsEngine_bloom_releaseTexture(bloom);
+    flecsEngine_bindGroupCache_fini(&bloom->input_bind_groups);
 
     if (bloom->uniform_buffer) {
-        wgpuBufferRelease(bloom->uniform_buffer);
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryEffect, bloom->uniform_buffer);
         bloom->uniform_buffer = NULL;
     }
 
+    if (bloom->compute_params_buffer) {
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryEffect, bloom->compute_params_buffer);
+        bloom->compute_params_buffer = NULL;
+    }
+
+    if (bloom->compute_upsample_pipeline) {
+        wgpuComputePipelineRelease(bloom->compute_upsample_pipeline);
+        bloom->compute_upsample_pipeline = NULL;
+    }
+
+    if (bloom->compute_downsample_pipeline) {
+        wgpuComputePipelineRelease(bloom->compute_downsample_pipeline);
+        bloom->compute_downsample_pipeline = NULL;
+    }
+
+    if (bloom->compute_bind_layout) {
+        wgpuBindGroupLayoutRelease(bloom->compute_bind_layout);
+        bloom->compute_bind_layout = NULL;
+    }
+
     if (bloom->sampler) {
         wgpuSamplerRelease(bloom->sampler);
         bloom->sampler = NULL;
@@ -249,7 +543,124 @@ static void flecsEngine_bloom_releaseResources(
 
 FLECS_ENGINE_IMPL_HOOKS(FlecsBloomImpl, flecsEngine_bloom_releaseResources)
 
-static bool flecsEngine_bloom_createTexture(
+static void flecsEngine_bloom_fillBindEntries(
+    const FlecsBloomImpl *bloom,
+    WGPUTextureView source_view,
+    WGPUBindGroupEntry *entries)
+{
+    entries[0] = (WGPUBindGroupEntry){
+        .binding = 0, .textureView = source_view
+    };
+    entries[1] = (WGPUBindGroupEntry){
+        .binding = 1, .sampler = bloom->sampler
+    };
+    entries[2] = (WGPUBindGroupEntry){
+        .binding = 2,
+        .buffer = bloom->uniform_buffer,
+        .offset = 0,
+        .size = sizeof(FlecsBloomUniform)
+    };
+}
+
+static uint32_t flecsEngine_bloom_mipSize(
+    uint32_t size,
+    uint32_t mip)
+{
+    size >>= mip;
+    return size ? size : 1u;
+}
+
+static uint32_t flecsEngine_bloom_computeSchedule(
+    uint32_t mip_count,
+    flecs_bloom_dispatch_t *dispatches)
+{
+    uint32_t count = 0;
+    for (uint32_t mip = 0; mip < mip_count; mip += 2u) {
+        dispatches[count ++] = (flecs_bloom_dispatch_t){
+            .upsample = false,
+            .level = mip,
+            .levels = mip + 1u < mip_count ? 2u : 1u
+        };
+    }
+
+    /* The last mip is the start of the upsample chain. Pairs end on mip 0 or
+     * 1, so the last dispatch always writes upsampled mip 0. */
+    uint32_t mip = mip_count - 1u;
+    while (mip > 0u) {
+        uint32_t levels = mip >= 2u ? 2u : 1u;
+        dispatches[count ++] = (flecs_bloom_dispatch_t){
+            .upsample = true,
+            .level = mip,
+            .levels = levels
+        };
+        mip -= levels;
+    }
+
+    return count;
+}
+
+static void flecsEngine_bloom_fillComputeEntries(
+    const FlecsBloomImpl *bloom,
+    const flecs_bloom_dispatch_t *dispatch,
+    uint32_t index,
+    WGPUTextureView input_view,
+    WGPUBindGroupEntry *entries)
+{
+    uint32_t level = dispatch->level;
+    WGPUTextureView src, base_a, base_b, out_a, out_b;
+
+    if (!dispatch->upsample) {
+        src = level ? bloom->mip_views[level - 1u] : input_view;
+        base_a = base_b = src;
+        out_a = bloom->mip_views[level];
+        out_b = dispatch->levels > 1u
+            ? bloom->mip_views[level + 1u]
+            : bloom->dummy_storage_view;
+    } else {
+        src = level == bloom->mip_count - 1u
+            ? bloom->mip_views[level]
+            : bloom->upsample_views[level];
+        base_a = bloom->mip_views[level - 1u];
+        base_b = bloom->mip_views[level - dispatch->levels];
+        out_a = bloom->upsample_views[level - dispatch->levels];
+        out_b = bloom->dummy_storage_view;
+    }
+
+    flecsEngine_bloom_fillBindEntries(bloom, src, entries);
+    entries[3] = (WGPUBindGroupEntry){
+        .binding = 3,
+        .buffer = bloom->compute_params_buffer,
+        .offset = (uint64_t)index * FLECS_ENGINE_BLOOM_DISPATCH_UNIFORM_STRIDE,
+        .size = sizeof(FlecsBloomDispatchUniform)
+    };
+    entries[4] = (WGPUBindGroupEntry){ .binding = 4, .textureView = base_a };
+    entries[5] = (WGPUBindGroupEntry){ .binding = 5, .textureView = base_b };
+    entries[6] = (WGPUBindGroupEntry){ .binding = 6, .textureView = out_a };
+    entries[7] = (WGPUBindGroupEntry){ .binding = 7, .textureView = out_b };
+}
+
+static WGPUTextureView flecsEngine_bloom_createMipView(
+    WGPUTexture texture,
+    WGPUTextureFormat format,
+    uint32_t mip)
+{
+    WGPUTextureViewDescriptor view_desc = {
+        .format = format,
+        .dimension = WGPUTextureViewDimension_2D,
+        .baseMipLevel = mip,
+        .mipLevelCount = 1,
+        .baseArrayLayer = 0,
+        .arrayLayerCount = 1,
+        .aspect = WGPUTextureAspect_All
+    };
+
+    return wgpuTextureCreateView(texture, &view_desc);
+}
+
+/* Upsampled mips go to a separate texture, as a dispatch can't read and write
+ * the same mip. Mip i of the upsample texture is mip i of the render path
+ * after its upsample pass. */
+static bool flecsEngine_bloom_createComputeTexture(
     const FlecsEngineImpl *engine,
     FlecsBloomImpl *bloom,
     uint32_t width,
@@ -258,7 +669,110 @@ static bool flecsEngine_bloom_createTexture(
     WGPUTextureFormat format)
 {
     WGPUTextureDescriptor texture_desc = {
-        .usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding,
+        .usage = WGPUTextureUsage_StorageBinding | WGPUTextureUsage_TextureBinding,
+        .dimension = WGPUTextureDimension_2D,
+        .size = (WGPUExtent3D){
+            .width = width,
+            .height = height,
+            .depthOrArrayLayers = 1
+        },
+        .format = format,
+        .mipLevelCount = mip_count - 1u,
+        .sampleCount = 1
+    };
+
+    bloom->upsample_texture = flecsEngine_gpuMemory_createTexture(
+        engine->device, FlecsGpuMemoryEffect, &texture_desc);
+    if (!bloom->upsample_texture) {
+        return false;
+    }
+
+    texture_desc.usage = WGPUTextureUsage_StorageBinding;
+    texture_desc.size.width = 1;
+    texture_desc.size.height = 1;
+    texture_desc.mipLevelCount = 1;
+    bloom->dummy_storage_texture = flecsEngine_gpuMemory_createTexture(
+        engine->device, FlecsGpuMemoryEffect, &texture_desc);
+    if (!bloom->dummy_storage_texture) {
+        return false;
+    }
+
+    bloom->dummy_storage_view = flecsEngine_bloom_createMipView(
+        bloom->dummy_storage_texture, format, 0);
+    if (!bloom->dummy_storage_view) {
+        return false;
+    }
+
+    bloom->upsample_views = ecs_os_calloc_n(WGPUTextureView, mip_count - 1u);
+    if (!bloom->upsample_views) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i + 1u < mip_count; i ++) {
+        bloom->upsample_views[i] = flecsEngine_bloom_createMipView(
+            bloom->upsample_texture, format, i);
+        if (!bloom->upsample_views[i]) {
+            return false;
+        }
+    }
+
+    WGPUBindGroupEntry entries[8];
+    flecsEngine_bloom_fillBindEntries(bloom, bloom->upsample_views[0], entries);
+    bloom->upsample_bind_group = flecsEngine_createBindGroup(engine,
+        &(WGPUBindGroupDescriptor){
+            .layout = bloom->bind_layout,
+            .entryCount = 3,
+            .entries = entries
+        });
+    if (!bloom->upsample_bind_group) {
+        return false;
+    }
+
+    flecs_bloom_dispatch_t dispatches[FLECS_ENGINE_BLOOM_MAX_DISPATCH_COUNT];
+    uint32_t count = flecsEngine_bloom_computeSchedule(mip_count, dispatches);
+
+    bloom->compute_bind_groups = ecs_os_calloc_n(WGPUBindGroup, count);
+    if (!bloom->compute_bind_groups) {
+        return false;
+    }
+    bloom->compute_dispatch_count = count;
+
+    /* The first downsample reads the effect input, its bind group is looked
+     * up from compute_input_bind_groups when rendering. */
+    for (uint32_t i = 1; i < count; i ++) {
+        flecsEngine_bloom_fillComputeEntries(
+            bloom, &dispatches[i], i, NULL, entries);
+        bloom->compute_bind_groups[i] = flecsEngine_createBindGroup(engine,
+            &(WGPUBindGroupDescriptor){
+                .layout = bloom->compute_bind_layout,
+                .entryCount = 8,
+                .entries = entries
+            });
+        if (!bloom->compute_bind_groups[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool flecsEngine_bloom_createTexture(
+    const FlecsEngineImpl *engine,
+    FlecsBloomImpl *bloom,
+    uint32_t width,
+    uint32_t height,
+    uint32_t mip_count,
+    WGPUTextureFormat format,
+    bool compute)
+{
+    WGPUTextureUsage usage =
+        WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding;
+    if (compute) {
+        usage |= WGPUTextureUsage_StorageBinding;
+    }
+
+    WGPUTextureDescriptor texture_desc = {
+        .usage = usage,
         .dimension = WGPUTextureDimension_2D,
         .size = (WGPUExtent3D){
             .width = width,
@@ -270,47 +784,63 @@ static bool flecsEngine_bloom_createTexture(
         .sampleCount = 1
     };
 
-    bloom->texture = wgpuDeviceCreateTexture(engine->device, &texture_desc);
+    bloom->texture = flecsEngine_gpuMemory_createTexture(
+        engine->device, FlecsGpuMemoryEffect, &texture_desc);
     if (!bloom->texture) {
         return false;
     }
 
     bloom->mip_views = ecs_os_calloc_n(WGPUTextureView, mip_count);
-    if (!bloom->mip_views) {
+    bloom->mip_bind_groups = ecs_os_calloc_n(WGPUBindGroup, mip_count);
+    bloom->mip_count = mip_count;
+    if (!bloom->mip_views || !bloom->mip_bind_groups) {
         flecsEngine_bloom_releaseTexture(bloom);
         return false;
     }
 
     for (uint32_t i = 0; i < mip_count; i ++) {
-        WGPUTextureViewDescriptor view_desc = {
-            .format = format,
-            .dimension = WGPUTextureViewDimension_2D,
-            .baseMipLevel = i,
-            .mipLevelCount = 1,
-            .baseArrayLayer = 0,
-            .arrayLayerCount = 1,
-            .aspect = WGPUTextureAspect_All
-        };
-
-        bloom->mip_views[i] = wgpuTextureCreateView(
-            bloom->texture, &view_desc);
+        bloom->mip_views[i] = flecsEngine_bloom_createMipView(
+            bloom->texture, format, i);
         if (!bloom->mip_views[i]) {
             flecsEngine_bloom_releaseTexture(bloom);
             return false;
         }
+
+        /* Mips are sampled by both the downsample and upsample chain, so one
+         * bind group per mip covers all passes that read it. */
+        WGPUBindGroupEntry entries[3];
+        flecsEngine_bloom_fillBindEntries(bloom, bloom->mip_views[i], entries);
+        bloom->mip_bind_groups[i] = flecsEngine_createBindGroup(engine,
+            &(WGPUBindGroupDescriptor){
+                .layout = bloom->bind_layout,
+                .entryCount = 3,
+                .entries = entries
+            });
+        if (!bloom->mip_bind_groups[i]) {
+            flecsEngine_bloom_releaseTexture(bloom);
+            return false;
+        }
+    }
+
+    if (compute && !flecsEngine_bloom_createComputeTexture(
+        engine, bloom, width, height, mip_count, format))
+    {
+        flecsEngine_bloom_releaseTexture(bloom);
+        return false;
     }
 
-    bloom->mip_count = mip_count;
     bloom->texture_width = width;
     bloom->texture_height = height;
     bloom->texture_format = format;
+    bloom->texture_compute = compute;
     return true;
 }
 
 static bool flecsEngine_bloom_ensureTexture(
     const FlecsEngineImpl *engine,
     const FlecsBloom *bloom,
-    FlecsBloomImpl *impl)
+    FlecsBloomImpl *impl,
+    bool compute)
 {
     uint32_t width = 0;
     uint32_t height = 0;
@@ -327,12 +857,18 @@ static bool flecsEngine_bloom_ensureTexture(
         mip_count = max_mips;
     }
 
+    /* The compute path needs at least one mip to upsample */
+    if (mip_count < 2u) {
+        compute = false;
+    }
+
     if (impl->texture &&
         impl->mip_views &&
         impl->texture_width == width &&
         impl->texture_height == height &&
         impl->mip_count == mip_count &&
-        impl->texture_format == flecsEngine_getHdrFormat(engine))
+        impl->texture_format == flecsEngine_getHdrFormat(engine) &&
+        impl->texture_compute == compute)
     {
         return true;
     }
@@ -347,7 +883,8 @@ static bool flecsEngine_bloom_ensureTexture(
         width,
         height,
         mip_count,
-        working_format))
+        working_format,
+        compute))
     {
         return true;
     }
@@ -415,8 +952,10 @@ static WGPURenderPipeline flecsEngine_bloom_createPipeline(
         .multisample = WGPU_MULTISAMPLE_DEFAULT
     };
 
+    uint64_t trace_start = flecsEngine_trace_begin();
     WGPURenderPipeline pipeline = wgpuDeviceCreateRenderPipeline(
         engine->device, &pipeline_desc);
+    flecsEngine_trace_end(trace_start, "pipeline", "render_pipeline", "bloom");
     wgpuPipelineLayoutRelease(pipeline_layout);
     return pipeline;
 }
@@ -443,33 +982,15 @@ static WGPUBlendState flecsEngine_bloom_getBlendState(void)
 
 static bool flecsEngine_bloom_runPass(
     const FlecsEngineImpl *engine,
-    const FlecsBloomImpl *bloom,
     WGPUCommandEncoder encoder,
     WGPURenderPipeline pipeline,
-    WGPUTextureView source_view,
+    WGPUBindGroup bind_group,
     WGPUTextureView target_view,
     WGPULoadOp load_op,
     bool use_blend_constant,
-    float blend_value)
+    float blend_value,
+    bool view_target)
 {
-    WGPUBindGroupEntry bind_entries[3] = {
-        { .binding = 0, .textureView = source_view },
-        { .binding = 1, .sampler = bloom->sampler },
-        {
-            .binding = 2,
-            .buffer = bloom->uniform_buffer,
-            .offset = 0,
-            .size = sizeof(FlecsBloomUniform)
-        }
-    };
-
-    WGPUBindGroupDescriptor bind_desc = {
-        .layout = bloom->bind_layout,
-        .entryCount = 3,
-        .entries = bind_entries
-    };
-
-    WGPUBindGroup bind_group = wgpuDeviceCreateBindGroup(engine->device, &bind_desc);
     if (!bind_group) {
         return false;
     }
@@ -489,10 +1010,13 @@ static bool flecsEngine_bloom_runPass(
 
     WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(encoder, &pass_desc);
     if (!pass) {
-        wgpuBindGroupRelease(bind_group);
         return false;
     }
 
+    if (view_target) {
+        flecsEngine_setRenderViewport(engine, pass);
+    }
+
     wgpuRenderPassEncoderSetPipeline(pass, pipeline);
     wgpuRenderPassEncoderSetBindGroup(pass, 0, bind_group, 0, NULL);
     if (use_blend_constant) {
@@ -507,7 +1031,6 @@ static bool flecsEngine_bloom_runPass(
     wgpuRenderPassEncoderDraw(pass, 3, 1, 0, 0);
     wgpuRenderPassEncoderEnd(pass);
     wgpuRenderPassEncoderRelease(pass);
-    wgpuBindGroupRelease(bind_group);
     return true;
 }
 
@@ -549,10 +1072,17 @@ static void flecsEngine_bloom_fillUniform(
     uniform->threshold_precomputations[2] = 2.0f * knee;
     uniform->threshold_precomputations[3] = 0.25f / (knee + 0.00001f);
 
+    /* The first downsample reads the render viewport of the input */
     uniform->viewport[0] = 0.0f;
     uniform->viewport[1] = 0.0f;
     uniform->viewport[2] = 1.0f;
     uniform->viewport[3] = 1.0f;
+    if (engine->actual_width > 0 && engine->actual_height > 0) {
+        uniform->viewport[2] =
+            (float)engine->render_width / (float)engine->actual_width;
+        uniform->viewport[3] =
+            (float)engine->render_height / (float)engine->actual_height;
+    }
 
     uniform->scale[0] = settings->scale_x;
     uniform->scale[1] = settings->scale_y;
@@ -602,7 +1132,8 @@ static bool flecsEngine_bloom_setup(
         .size = sizeof(FlecsBloomUniform)
     };
 
-    bloom.uniform_buffer = wgpuDeviceCreateBuffer(engine->device, &uniform_desc);
+    bloom.uniform_buffer = flecsEngine_gpuMemory_createBuffer(
+        engine->device, FlecsGpuMemoryEffect, &uniform_desc);
     if (!bloom.uniform_buffer) {
         flecsEngine_bloom_releaseResources(&bloom);
         return false;
@@ -647,8 +1178,8 @@ static bool flecsEngine_bloom_setup(
         return false;
     }
 
-    WGPUShaderModule bloom_shader = flecsEngine_createShaderModule(
-        engine->device, kBloomShaderSource);
+    WGPUShaderModule bloom_shader = flecsEngine_shaderCache_get(
+        (FlecsEngineImpl*)engine, kBloomShaderSource);
     if (!bloom_shader) {
         flecsEngine_bloom_releaseResources(&bloom);
         return false;
@@ -696,8 +1227,6 @@ static bool flecsEngine_bloom_setup(
         hdr_format,
         &blend_state);
 
-    wgpuShaderModuleRelease(bloom_shader);
-
     if (!bloom.downsample_first_pipeline ||
         !bloom.downsample_pipeline ||
         !bloom.upsample_pipeline ||
@@ -712,12 +1241,305 @@ static bool flecsEngine_bloom_setup(
     return true;
 }
 
+static bool flecsEngine_bloom_renderMips(
+    const FlecsEngineImpl *engine,
+    WGPUCommandEncoder encoder,
+    const FlecsBloom *bloom,
+    FlecsBloomImpl *impl,
+    WGPUTextureView input_view)
+{
+    WGPUBindGroupEntry input_entries[3];
+    flecsEngine_bloom_fillBindEntries(impl, input_view, input_entries);
+    WGPUBindGroup input_bind_group = flecsEngine_bindGroupCache_get(
+        engine, &impl->input_bind_groups, impl->bind_layout,
+        input_entries, 3);
+
+    if (!flecsEngine_bloom_runPass(
+        engine,
+        encoder,
+        impl->downsample_first_pipeline,
+        input_bind_group,
+        impl->mip_views[0],
+        WGPULoadOp_Clear,
+        false,
+        0.0f,
+        false))
+    {
+        return false;
+    }
+
+    for (uint32_t mip = 1; mip < impl->mip_count; mip ++) {
+        if (!flecsEngine_bloom_runPass(
+            engine,
+            encoder,
+            impl->downsample_pipeline,
+            impl->mip_bind_groups[mip - 1],
+            impl->mip_views[mip],
+            WGPULoadOp_Clear,
+            false,
+            0.0f,
+            false))
+        {
+            return false;
+        }
+    }
+
+    float max_mip = (float)(impl->mip_count - 1u);
+    for (uint32_t mip = impl->mip_count - 1u; mip > 0u; mip --) {
+        float blend = flecsEngine_bloom_computeBlendFactor(
+            bloom, mip, max_mip);
+        if (!flecsEngine_bloom_runPass(
+            engine,
+            encoder,
+            impl->upsample_pipeline,
+            impl->mip_bind_groups[mip],
+            impl->mip_views[mip - 1u],
+            WGPULoadOp_Load,
+            true,
+            blend,
+            false))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool flecsEngine_bloom_ensureCompute(
+    const FlecsEngineImpl *engine,
+    FlecsBloomImpl *bloom)
+{
+    if (bloom->compute_downsample_pipeline) {
+        return true;
+    }
+
+    if (bloom->compute_unsupported) {
+        return false;
+    }
+
+    WGPUBindGroupLayoutEntry layout_entries[8] = {
+        {
+            .binding = 0,
+            .visibility = WGPUShaderStage_Compute,
+            .texture = {
+                .sampleType = WGPUTextureSampleType_Float,
+                .viewDimension = WGPUTextureViewDimension_2D
+            }
+        },
+        {
+            .binding = 1,
+            .visibility = WGPUShaderStage_Compute,
+            .sampler = {
+                .type = WGPUSamplerBindingType_Filtering
+            }
+        },
+        {
+            .binding = 2,
+            .visibility = WGPUShaderStage_Compute,
+            .buffer = {
+                .type = WGPUBufferBindingType_Uniform,
+                .minBindingSize = sizeof(FlecsBloomUniform)
+            }
+        },
+        {
+            .binding = 3,
+            .visibility = WGPUShaderStage_Compute,
+            .buffer = {
+                .type = WGPUBufferBindingType_Uniform,
+                .minBindingSize = sizeof(FlecsBloomDispatchUniform)
+            }
+        },
+        {
+            .binding = 4,
+            .visibility = WGPUShaderStage_Compute,
+            .texture = {
+                .sampleType = WGPUTextureSampleType_Float,
+                .viewDimension = WGPUTextureViewDimension_2D
+            }
+        },
+        {
+            .binding = 5,
+            .visibility = WGPUShaderStage_Compute,
+            .texture = {
+                .sampleType = WGPUTextureSampleType_Float,
+                .viewDimension = WGPUTextureViewDimension_2D
+            }
+        },
+        {
+            .binding = 6,
+            .visibility = WGPUShaderStage_Compute,
+            .storageTexture = {
+                .access = WGPUStorageTextureAccess_WriteOnly,
+                .format = FLECS_ENGINE_BLOOM_COMPUTE_FORMAT,
+                .viewDimension = WGPUTextureViewDimension_2D
+            }
+        },
+        {
+            .binding = 7,
+            .visibility = WGPUShaderStage_Compute,
+            .storageTexture = {
+                .access = WGPUStorageTextureAccess_WriteOnly,
+                .format = FLECS_ENGINE_BLOOM_COMPUTE_FORMAT,
+                .viewDimension = WGPUTextureViewDimension_2D
+            }
+        }
+    };
+
+    bloom->compute_bind_layout = wgpuDeviceCreateBindGroupLayout(
+        engine->device, &(WGPUBindGroupLayoutDescriptor){
+            .entryCount = 8,
+            .entries = layout_entries
+        });
+
+    WGPUBufferDescriptor params_desc = {
+        .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+        .size = FLECS_ENGINE_BLOOM_MAX_DISPATCH_COUNT *
+            FLECS_ENGINE_BLOOM_DISPATCH_UNIFORM_STRIDE
+    };
+    bloom->compute_params_buffer = flecsEngine_gpuMemory_createBuffer(
+        engine->device, FlecsGpuMemoryEffect, &params_desc);
+
+    WGPUShaderModule shader = flecsEngine_shaderCache_get(
+        (FlecsEngineImpl*)engine, kBloomComputeShaderSource);
+
+    if (bloom->compute_bind_layout && bloom->compute_params_buffer && shader) {
+        WGPUPipelineLayout pipeline_layout = wgpuDeviceCreatePipelineLayout(
+            engine->device, &(WGPUPipelineLayoutDescriptor){
+                .bindGroupLayoutCount = 1,
+                .bindGroupLayouts = &bloom->compute_bind_layout
+            });
+
+        if (pipeline_layout) {
+            bloom->compute_downsample_pipeline =
+                wgpuDeviceCreateComputePipeline(engine->device,
+                    &(WGPUComputePipelineDescriptor){
+                        .layout = pipeline_layout,
+                        .compute = {
+                            .module = shader,
+                            .entryPoint = WGPU_STR("downsample")
+                        }
+                    });
+            bloom->compute_upsample_pipeline =
+                wgpuDeviceCreateComputePipeline(engine->device,
+                    &(WGPUComputePipelineDescriptor){
+                        .layout = pipeline_layout,
+                        .compute = {
+                            .module = shader,
+                            .entryPoint = WGPU_STR("upsample")
+                        }
+                    });
+            wgpuPipelineLayoutRelease(pipeline_layout);
+        }
+    }
+
+    if (!bloom->compute_downsample_pipeline ||
+        !bloom->compute_upsample_pipeline)
+    {
+        ecs_warn("bloom: compute path unavailable, using render passes");
+        if (bloom->compute_downsample_pipeline) {
+            wgpuComputePipelineRelease(bloom->compute_downsample_pipeline);
+            bloom->compute_downsample_pipeline = NULL;
+        }
+        bloom->compute_unsupported = true;
+        return false;
+    }
+
+    return true;
+}
+
+static bool flecsEngine_bloom_renderCompute(
+    const FlecsEngineImpl *engine,
+    WGPUCommandEncoder encoder,
+    const FlecsBloom *bloom,
+    FlecsBloomImpl *impl,
+    WGPUTextureView input_view)
+{
+    flecs_bloom_dispatch_t dispatches[FLECS_ENGINE_BLOOM_MAX_DISPATCH_COUNT];
+    uint32_t count = flecsEngine_bloom_computeSchedule(
+        impl->mip_count, dispatches);
+    ecs_assert(count == impl->compute_dispatch_count,
+        ECS_INTERNAL_ERROR, NULL);
+
+    uint8_t params[FLECS_ENGINE_BLOOM_MAX_DISPATCH_COUNT *
+        FLECS_ENGINE_BLOOM_DISPATCH_UNIFORM_STRIDE] = {0};
+    float max_mip = (float)(impl->mip_count - 1u);
+
+    for (uint32_t i = 0; i < count; i ++) {
+        const flecs_bloom_dispatch_t *dispatch = &dispatches[i];
+        FlecsBloomDispatchUniform *uniform = (FlecsBloomDispatchUniform*)
+            &params[i * FLECS_ENGINE_BLOOM_DISPATCH_UNIFORM_STRIDE];
+        uniform->first = !dispatch->upsample && !dispatch->level;
+        uniform->levels = dispatch->levels;
+        if (dispatch->upsample) {
+            uniform->blend[0] = flecsEngine_bloom_computeBlendFactor(
+                bloom, (float)dispatch->level, max_mip);
+            uniform->blend[1] = flecsEngine_bloom_computeBlendFactor(
+                bloom, (float)(dispatch->level - 1u), max_mip);
+        }
+    }
+
+    flecsEngine_queueWriteBuffer(
+        engine,
+        impl->compute_params_buffer,
+        0,
+        params,
+        count * FLECS_ENGINE_BLOOM_DISPATCH_UNIFORM_STRIDE);
+
+    WGPUBindGroupEntry input_entries[8];
+    flecsEngine_bloom_fillComputeEntries(
+        impl, &dispatches[0], 0, input_view, input_entries);
+    WGPUBindGroup input_bind_group = flecsEngine_bindGroupCache_get(
+        engine, &impl->compute_input_bind_groups, impl->compute_bind_layout,
+        input_entries, 8);
+    if (!input_bind_group) {
+        return false;
+    }
+
+    WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(
+        encoder, &(WGPUComputePassDescriptor){0});
+    if (!pass) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; i ++) {
+        const flecs_bloom_dispatch_t *dispatch = &dispatches[i];
+        uint32_t tile, width, height;
+        if (!dispatch->upsample) {
+            /* Workgroups cover the first mip, the second is half its size */
+            tile = FLECS_ENGINE_BLOOM_DOWNSAMPLE_TILE;
+            width = flecsEngine_bloom_mipSize(
+                impl->texture_width, dispatch->level);
+            height = flecsEngine_bloom_mipSize(
+                impl->texture_height, dispatch->level);
+        } else {
+            /* Workgroups cover the last mip that is written */
+            uint32_t mip = dispatch->level - dispatch->levels;
+            tile = FLECS_ENGINE_BLOOM_UPSAMPLE_TILE;
+            width = flecsEngine_bloom_mipSize(impl->texture_width, mip);
+            height = flecsEngine_bloom_mipSize(impl->texture_height, mip);
+        }
+
+        wgpuComputePassEncoderSetPipeline(pass, dispatch->upsample
+            ? impl->compute_upsample_pipeline
+            : impl->compute_downsample_pipeline);
+        wgpuComputePassEncoderSetBindGroup(pass, 0,
+            i ? impl->compute_bind_groups[i] : input_bind_group, 0, NULL);
+        wgpuComputePassEncoderDispatchWorkgroups(pass,
+            (width + tile - 1u) / tile, (height + tile - 1u) / tile, 1);
+    }
+
+    wgpuComputePassEncoderEnd(pass);
+    wgpuComputePassEncoderRelease(pass);
+    return true;
+}
+
 static bool flecsEngine_bloom_renderPassthrough(
     const ecs_world_t *world,
     const FlecsEngineImpl *engine,
     ecs_entity_t effect_entity,
     const FlecsRenderEffect *effect,
-    const FlecsRenderEffectImpl *effect_impl,
+    FlecsRenderEffectImpl *effect_impl,
     WGPUCommandEncoder encoder,
     WGPUTextureView input_view,
     WGPUTextureView output_view,
@@ -742,6 +1564,7 @@ static bool flecsEngine_bloom_renderPassthrough(
         return false;
     }
 
+    flecsEngine_setRenderViewport(engine, pass);
     flecsEngine_renderEffect_render(
         world,
         engine,
@@ -790,66 +1613,40 @@ static bool flecsEngine_bloom_render(
             output_load_op);
     }
 
-    if (!flecsEngine_bloom_ensureTexture(engine, bloom, impl)) {
+    /* Storage textures need a format that supports them, and the manual
+     * filter in workgroup memory only reaches one texel per tap. */
+    bool compute = bloom->compute &&
+        flecsEngine_getHdrFormat(engine) == FLECS_ENGINE_BLOOM_COMPUTE_FORMAT &&
+        bloom->scale_x <= 1.0f && bloom->scale_y <= 1.0f &&
+        flecsEngine_bloom_ensureCompute(engine, impl);
+
+    if (!flecsEngine_bloom_ensureTexture(engine, bloom, impl, compute)) {
         return false;
     }
 
     FlecsBloomUniform uniform = {0};
     flecsEngine_bloom_fillUniform(engine, bloom, &uniform);
-    wgpuQueueWriteBuffer(
-        engine->queue,
+    flecsEngine_queueWriteBuffer(
+        engine,
         impl->uniform_buffer,
         0,
         &uniform,
         sizeof(uniform));
 
-    if (!flecsEngine_bloom_runPass(
-        engine,
-        impl,
-        encoder,
-        impl->downsample_first_pipeline,
-        input_view,
-        impl->mip_views[0],
-        WGPULoadOp_Clear,
-        false,
-        0.0f))
-    {
-        return false;
-    }
-
-    for (uint32_t mip = 1; mip < impl->mip_count; mip ++) {
-        if (!flecsEngine_bloom_runPass(
-            engine,
-            impl,
-            encoder,
-            impl->downsample_pipeline,
-            impl->mip_views[mip - 1],
-            impl->mip_views[mip],
-            WGPULoadOp_Clear,
-            false,
-            0.0f))
-        {
-            return false;
-        }
-    }
-
     float max_mip = (float)(impl->mip_count - 1u);
-    for (uint32_t mip = impl->mip_count - 1u; mip > 0u; mip --) {
-        float blend = flecsEngine_bloom_computeBlendFactor(
-            bloom, mip, max_mip);
-        if (!flecsEngine_bloom_runPass(
-            engine,
-            impl,
-            encoder,
-            impl->upsample_pipeline,
-            impl->mip_views[mip],
-            impl->mip_views[mip - 1u],
-            WGPULoadOp_Load,
-            true,
-            blend))
+    WGPUBindGroup final_bind_group = impl->mip_bind_groups[0];
+
+    if (impl->texture_compute) {
+        if (!flecsEngine_bloom_renderCompute(
+            engine, encoder, bloom, impl, input_view))
         {
             return false;
         }
+        final_bind_group = impl->upsample_bind_group;
+    } else if (!flecsEngine_bloom_renderMips(
+        engine, encoder, bloom, impl, input_view))
+    {
+        return false;
     }
 
     WGPURenderPipeline final_pipeline =
@@ -877,14 +1674,14 @@ static bool flecsEngine_bloom_render(
 
     return flecsEngine_bloom_runPass(
         engine,
-        impl,
         encoder,
         final_pipeline,
-        impl->mip_views[0],
+        final_bind_group,
         output_view,
         WGPULoadOp_Load,
         true,
-        final_blend);
+        final_blend,
+        true);
 }
 
 ecs_entity_t flecsEngine_createEffect_bloom(
@@ -937,7 +1734,8 @@ void flecsEngine_bloom_register(
             { .name = "prefilter", .type = bloom_prefilter_t },
             { .name = "mip_count", .type = ecs_id(ecs_u32_t) },
             { .name = "scale_x", .type = ecs_id(ecs_f32_t) },
-            { .name = "scale_y", .type = ecs_id(ecs_f32_t) }
+            { .name = "scale_y", .type = ecs_id(ecs_f32_t) },
+            { .name = "compute", .type = ecs_id(ecs_bool_t) }
         }
     });
 }
@@ -35,8 +35,8 @@ static const char *kShaderSource =
 int flecsEngine_initDepthResolve(
     FlecsEngineImpl *impl)
 {
-    WGPUShaderModule module = flecsEngine_createShaderModule(
-        impl->device, kShaderSource);
+    WGPUShaderModule module = flecsEngine_shaderCache_get(
+        impl, kShaderSource);
     if (!module) {
         return -1;
     }
@@ -57,7 +57,6 @@ int flecsEngine_initDepthResolve(
             .entryCount = 1
         });
     if (!impl->depth.depth_resolve_bind_layout) {
-        wgpuShaderModuleRelease(module);
         return -1;
     }
 
@@ -67,7 +66,6 @@ int flecsEngine_initDepthResolve(
             .bindGroupLayouts = &impl->depth.depth_resolve_bind_layout
         });
     if (!pipeline_layout) {
-        wgpuShaderModuleRelease(module);
         return -1;
     }
 
@@ -100,7 +98,6 @@ int flecsEngine_initDepthResolve(
         });
 
     wgpuPipelineLayoutRelease(pipeline_layout);
-    wgpuShaderModuleRelease(module);
 
     return impl->depth.depth_resolve_pipeline ? 0 : -1;
 }
@@ -121,12 +118,12 @@ void flecsEngine_depthResolve(
         .textureView = impl->depth.msaa_depth_texture_view
     };
 
-    WGPUBindGroup bind_group = wgpuDeviceCreateBindGroup(
-        impl->device, &(WGPUBindGroupDescriptor){
-            .layout = impl->depth.depth_resolve_bind_layout,
-            .entryCount = 1,
-            .entries = &entry
-        });
+    WGPUBindGroup bind_group = flecsEngine_bindGroupCache_get(
+        impl,
+        &((FlecsEngineImpl*)impl)->depth.depth_resolve_bind_groups,
+        impl->depth.depth_resolve_bind_layout,
+        &entry,
+        1);
     if (!bind_group) {
         return;
     }
@@ -146,7 +143,9 @@ void flecsEngine_depthResolve(
     WGPURenderPassDescriptor pass_desc = {
         .colorAttachmentCount = 0,
         .colorAttachments = NULL,
-        .depthStencilAttachment = &depth_attachment
+        .depthStencilAttachment = &depth_attachment,
+        .timestampWrites = flecsEngine_gpuTimer_pass(
+            impl, FlecsGpuStageBatches, "depth_resolve")
     };
 
     WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(
@@ -158,6 +157,4 @@ void flecsEngine_depthResolve(
         wgpuRenderPassEncoderEnd(pass);
         wgpuRenderPassEncoderRelease(pass);
     }
-
-    wgpuBindGroupRelease(bind_group);
 }
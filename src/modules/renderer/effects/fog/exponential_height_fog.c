@@ -11,64 +11,62 @@ typedef struct FlecsExponentialHeightFogUniform {
     float fog_params[4];
 } FlecsExponentialHeightFogUniform;
 
-static const char *kShaderSource =
-    FLECS_ENGINE_FULLSCREEN_VS_WGSL
-    "struct FogUniforms {\n"
-    "  inv_vp : mat4x4<f32>,\n"
-    "  camera_pos : vec4<f32>,\n"
-    "  fog_color_density : vec4<f32>,\n"
-    "  fog_params : vec4<f32>,\n"
-    "};\n"
-    "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n"
-    "@group(0) @binding(1) var input_sampler : sampler;\n"
-    "@group(0) @binding(2) var depth_texture : texture_depth_2d;\n"
-    "@group(0) @binding(3) var<uniform> uniforms : FogUniforms;\n"
-    "fn reconstruct_world_pos(uv : vec2<f32>, depth : f32) -> vec3<f32> {\n"
-    "  let ndc = vec4<f32>(\n"
-    "    uv.x * 2.0 - 1.0,\n"
-    "    (1.0 - uv.y) * 2.0 - 1.0,\n"
-    "    depth,\n"
-    "    1.0);\n"
-    "  let world_h = uniforms.inv_vp * ndc;\n"
-    "  if (abs(world_h.w) > 1e-6) {\n"
-    "    return world_h.xyz / world_h.w;\n"
-    "  }\n"
-    "  return world_h.xyz;\n"
+#define FLECS_ENGINE_FOG_STAGE_WGSL \
+    "struct FogUniforms {\n" \
+    "  inv_vp : mat4x4<f32>,\n" \
+    "  camera_pos : vec4<f32>,\n" \
+    "  fog_color_density : vec4<f32>,\n" \
+    "  fog_params : vec4<f32>,\n" \
+    "};\n" \
+    "@group(0) @binding(2) var fog_depth_texture : texture_depth_2d;\n" \
+    "@group(0) @binding(3) var<uniform> fog_uniforms : FogUniforms;\n" \
+    "fn fog_reconstruct_world_pos(uv : vec2<f32>, depth : f32) -> vec3<f32> {\n" \
+    "  let ndc = vec4<f32>(\n" \
+    "    uv.x * 2.0 - 1.0,\n" \
+    "    (1.0 - uv.y) * 2.0 - 1.0,\n" \
+    "    depth,\n" \
+    "    1.0);\n" \
+    "  let world_h = fog_uniforms.inv_vp * ndc;\n" \
+    "  if (abs(world_h.w) > 1e-6) {\n" \
+    "    return world_h.xyz / world_h.w;\n" \
+    "  }\n" \
+    "  return world_h.xyz;\n" \
+    "}\n" \
+    "fn fog_apply(src : vec4<f32>, pos : vec4<f32>, uv : vec2<f32>) -> vec4<f32> {\n" \
+    "  let texel = vec2<i32>(pos.xy);\n" \
+    "  let depth = textureLoad(fog_depth_texture, texel, 0);\n" \
+    "  if (depth >= 0.999999) {\n" \
+    "    return src;\n" \
+    "  }\n" \
+    "  let world_pos = fog_reconstruct_world_pos(uv, depth);\n" \
+    "  let ray = world_pos - fog_uniforms.camera_pos.xyz;\n" \
+    "  let distance = length(ray);\n" \
+    "  if (distance <= 1e-6) {\n" \
+    "    return src;\n" \
+    "  }\n" \
+    "  let density = max(fog_uniforms.fog_color_density.w, 0.0);\n" \
+    "  let falloff = max(fog_uniforms.fog_params.x, 1e-6);\n" \
+    "  let base_height = fog_uniforms.fog_params.y;\n" \
+    "  let max_opacity = clamp(fog_uniforms.fog_params.z, 0.0, 1.0);\n" \
+    "  let camera_height = fog_uniforms.camera_pos.y - base_height;\n" \
+    "  let world_height = world_pos.y - base_height;\n" \
+    "  let e0 = exp(clamp(-falloff * camera_height, -80.0, 80.0));\n" \
+    "  let e1 = exp(clamp(-falloff * world_height, -80.0, 80.0));\n" \
+    "  let dy = world_pos.y - fog_uniforms.camera_pos.y;\n" \
+    "  var integral = distance * sqrt(max(e0 * e1, 0.0));\n" \
+    "  if (abs(dy) > 1e-5) {\n" \
+    "    integral = distance * (e0 - e1) / (falloff * dy);\n" \
+    "  }\n" \
+    "  let optical_depth = max(0.0, density * max(integral, 0.0));\n" \
+    "  let fog_factor = min(max_opacity, 1.0 - exp(clamp(-optical_depth, -80.0, 0.0)));\n" \
+    "  let fogged = mix(src.rgb, fog_uniforms.fog_color_density.rgb, fog_factor);\n" \
+    "  return vec4<f32>(fogged, src.a);\n" \
     "}\n"
-    "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
-    "  let src = textureSample(input_texture, input_sampler, in.uv);\n"
-    "  let dims = textureDimensions(depth_texture);\n"
-    "  let dims_f = vec2<f32>(f32(dims.x), f32(dims.y));\n"
-    "  let clamped_uv = clamp(in.uv, vec2<f32>(0.0), vec2<f32>(0.999999));\n"
-    "  let texel = vec2<i32>(clamped_uv * dims_f);\n"
-    "  let depth = textureLoad(depth_texture, texel, 0);\n"
-    "  if (depth >= 0.999999) {\n"
-    "    return src;\n"
-    "  }\n"
-    "  let world_pos = reconstruct_world_pos(in.uv, depth);\n"
-    "  let ray = world_pos - uniforms.camera_pos.xyz;\n"
-    "  let distance = length(ray);\n"
-    "  if (distance <= 1e-6) {\n"
-    "    return src;\n"
-    "  }\n"
-    "  let density = max(uniforms.fog_color_density.w, 0.0);\n"
-    "  let falloff = max(uniforms.fog_params.x, 1e-6);\n"
-    "  let base_height = uniforms.fog_params.y;\n"
-    "  let max_opacity = clamp(uniforms.fog_params.z, 0.0, 1.0);\n"
-    "  let camera_height = uniforms.camera_pos.y - base_height;\n"
-    "  let world_height = world_pos.y - base_height;\n"
-    "  let e0 = exp(clamp(-falloff * camera_height, -80.0, 80.0));\n"
-    "  let e1 = exp(clamp(-falloff * world_height, -80.0, 80.0));\n"
-    "  let dy = world_pos.y - uniforms.camera_pos.y;\n"
-    "  var integral = distance * sqrt(max(e0 * e1, 0.0));\n"
-    "  if (abs(dy) > 1e-5) {\n"
-    "    integral = distance * (e0 - e1) / (falloff * dy);\n"
-    "  }\n"
-    "  let optical_depth = max(0.0, density * max(integral, 0.0));\n"
-    "  let fog_factor = min(max_opacity, 1.0 - exp(clamp(-optical_depth, -80.0, 0.0)));\n"
-    "  let fogged = mix(src.rgb, uniforms.fog_color_density.rgb, fog_factor);\n"
-    "  return vec4<f32>(fogged, src.a);\n"
-    "}\n";
+
+static const char *kStageSource = FLECS_ENGINE_FOG_STAGE_WGSL;
+
+static const char *kShaderSource =
+    FLECS_ENGINE_POINTWISE_EFFECT_WGSL(FLECS_ENGINE_FOG_STAGE_WGSL, "fog_apply");
 
 static ecs_entity_t flecsEngine_exponentialHeightFog_shader(
     ecs_world_t *world)
@@ -85,7 +83,8 @@ static void flecsEngine_exponentialHeightFog_releaseResources(
     FlecsExponentialHeightFogImpl *impl)
 {
     if (impl->uniform_buffer) {
-        wgpuBufferRelease(impl->uniform_buffer);
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryEffect, impl->uniform_buffer);
         impl->uniform_buffer = NULL;
     }
 }
@@ -169,7 +168,8 @@ static bool flecsEngine_exponentialHeightFog_setup(
         .size = sizeof(FlecsExponentialHeightFogUniform)
     };
 
-    fog_impl.uniform_buffer = wgpuDeviceCreateBuffer(engine->device, &uniform_desc);
+    fog_impl.uniform_buffer = flecsEngine_gpuMemory_createBuffer(
+        engine->device, FlecsGpuMemoryEffect, &uniform_desc);
     if (!fog_impl.uniform_buffer) {
         return false;
     }
@@ -229,8 +229,8 @@ static bool flecsEngine_exponentialHeightFog_bind(
 
     FlecsExponentialHeightFogUniform uniform = {0};
     flecsEngine_exponentialHeightFog_fillUniform(world, effect_entity, fog, &uniform);
-    wgpuQueueWriteBuffer(
-        engine->queue,
+    flecsEngine_queueWriteBuffer(
+        engine,
         fog_impl->uniform_buffer,
         0,
         &uniform,
@@ -281,7 +281,9 @@ ecs_entity_t flecsEngine_createEffect_exponentialHeightFog(
         .shader = flecsEngine_exponentialHeightFog_shader(world),
         .input = input,
         .setup_callback = flecsEngine_exponentialHeightFog_setup,
-        .bind_callback = flecsEngine_exponentialHeightFog_bind
+        .bind_callback = flecsEngine_exponentialHeightFog_bind,
+        .pointwise = kStageSource,
+        .pointwise_fn = "fog_apply"
     });
 
     return effect;
@@ -0,0 +1,341 @@
+#include "../../renderer.h"
+#include "flecs_engine.h"
+
+ECS_COMPONENT_DECLARE(FlecsFXAA);
+ECS_COMPONENT_DECLARE(FlecsFXAAImpl);
+
+typedef struct FlecsFXAAUniform {
+    float params[4];    /* edge threshold, edge threshold min, subpixel, 0 */
+    float viewport[4];  /* render width, height, 1/input width, 1/input height */
+} FlecsFXAAUniform;
+
+/* FXAA 3.11 quality preset: find the edge orientation from the luma of the
+ * 3x3 neighborhood, walk along the edge to find its ends, and resample across
+ * the edge based on the distance to the nearest end. */
+static const char *kShaderSource =
+    FLECS_ENGINE_FULLSCREEN_VS_WGSL
+    "struct FxaaUniforms {\n"
+    "  params : vec4<f32>,\n"
+    "  viewport : vec4<f32>,\n"
+    "};\n"
+    "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n"
+    "@group(0) @binding(1) var input_sampler : sampler;\n"
+    "@group(0) @binding(2) var<uniform> uniforms : FxaaUniforms;\n"
+
+    "const EDGE_STEP_COUNT = 10;\n"
+    "const EDGE_STEPS = array<f32, 10>(\n"
+    "  1.0, 1.5, 2.0, 2.0, 2.0, 2.0, 2.0, 2.0, 2.0, 4.0);\n"
+    "const EDGE_GUESS = 8.0;\n"
+
+    /* Samples outside of the render viewport are clamped to its edge */
+    "fn sample_color(uv : vec2<f32>) -> vec4<f32> {\n"
+    "  let texel = uniforms.viewport.zw;\n"
+    "  let uv_max = (uniforms.viewport.xy - vec2<f32>(0.5)) * texel;\n"
+    "  return textureSampleLevel(input_texture, input_sampler,\n"
+    "    clamp(uv, texel * 0.5, uv_max), 0.0);\n"
+    "}\n"
+
+    /* Edges are detected on perceptual luma, so the effect works on linear
+     * input as well as on tone mapped input. */
+    "fn luma(c : vec3<f32>) -> f32 {\n"
+    "  return sqrt(max(dot(c, vec3<f32>(0.299, 0.587, 0.114)), 0.0));\n"
+    "}\n"
+
+    "fn sample_luma(uv : vec2<f32>) -> f32 {\n"
+    "  return luma(sample_color(uv).rgb);\n"
+    "}\n"
+
+    "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
+    "  let texel = uniforms.viewport.zw;\n"
+    "  let uv = in.pos.xy * texel;\n"
+    "  let center = sample_color(uv);\n"
+
+    "  let m = luma(center.rgb);\n"
+    "  let n = sample_luma(uv + vec2<f32>(0.0, -texel.y));\n"
+    "  let s = sample_luma(uv + vec2<f32>(0.0, texel.y));\n"
+    "  let w = sample_luma(uv + vec2<f32>(-texel.x, 0.0));\n"
+    "  let e = sample_luma(uv + vec2<f32>(texel.x, 0.0));\n"
+
+    "  let range_max = max(max(max(n, s), max(w, e)), m);\n"
+    "  let range_min = min(min(min(n, s), min(w, e)), m);\n"
+    "  let range = range_max - range_min;\n"
+    "  if (range < max(uniforms.params.y, range_max * uniforms.params.x)) {\n"
+    "    return center;\n"
+    "  }\n"
+
+    "  let nw = sample_luma(uv + vec2<f32>(-texel.x, -texel.y));\n"
+    "  let ne = sample_luma(uv + vec2<f32>(texel.x, -texel.y));\n"
+    "  let sw = sample_luma(uv + vec2<f32>(-texel.x, texel.y));\n"
+    "  let se = sample_luma(uv + vec2<f32>(texel.x, texel.y));\n"
+
+    /* Subpixel aliasing: how much the center differs from its neighbors */
+    "  let average = (2.0 * (n + s + w + e) + nw + ne + sw + se) / 12.0;\n"
+    "  let subpixel = smoothstep(0.0, 1.0, clamp(abs(average - m) / range, 0.0, 1.0));\n"
+    "  let subpixel_blend = subpixel * subpixel * uniforms.params.z;\n"
+
+    "  let horizontal_contrast =\n"
+    "    abs(n + s - 2.0 * m) * 2.0 + abs(ne + se - 2.0 * e) + abs(nw + sw - 2.0 * w);\n"
+    "  let vertical_contrast =\n"
+    "    abs(e + w - 2.0 * m) * 2.0 + abs(ne + nw - 2.0 * n) + abs(se + sw - 2.0 * s);\n"
+    "  let is_horizontal = horizontal_contrast >= vertical_contrast;\n"
+
+    /* Step across the edge, towards the side with the larger gradient */
+    "  var across = select(vec2<f32>(texel.x, 0.0), vec2<f32>(0.0, texel.y), is_horizontal);\n"
+    "  let luma_p = select(e, s, is_horizontal);\n"
+    "  let luma_n = select(w, n, is_horizontal);\n"
+    "  let gradient_p = abs(luma_p - m);\n"
+    "  let gradient_n = abs(luma_n - m);\n"
+    "  var opposite = luma_p;\n"
+    "  var gradient = gradient_p;\n"
+    "  if (gradient_p < gradient_n) {\n"
+    "    across = -across;\n"
+    "    opposite = luma_n;\n"
+    "    gradient = gradient_n;\n"
+    "  }\n"
+
+    /* Walk along the edge in both directions until the luma changes */
+    "  let along = select(vec2<f32>(0.0, texel.y), vec2<f32>(texel.x, 0.0), is_horizontal);\n"
+    "  let edge_uv = uv + across * 0.5;\n"
+    "  let edge_luma = (m + opposite) * 0.5;\n"
+    "  let threshold = gradient * 0.25;\n"
+
+    "  var uv_p = edge_uv + along;\n"
+    "  var delta_p = sample_luma(uv_p) - edge_luma;\n"
+    "  var done_p = abs(delta_p) >= threshold;\n"
+    "  var uv_n = edge_uv - along;\n"
+    "  var delta_n = sample_luma(uv_n) - edge_luma;\n"
+    "  var done_n = abs(delta_n) >= threshold;\n"
+
+    "  for (var i = 1; i < EDGE_STEP_COUNT && !(done_p && done_n); i++) {\n"
+    "    if (!done_p) {\n"
+    "      uv_p += along * EDGE_STEPS[i];\n"
+    "      delta_p = sample_luma(uv_p) - edge_luma;\n"
+    "      done_p = abs(delta_p) >= threshold;\n"
+    "    }\n"
+    "    if (!done_n) {\n"
+    "      uv_n -= along * EDGE_STEPS[i];\n"
+    "      delta_n = sample_luma(uv_n) - edge_luma;\n"
+    "      done_n = abs(delta_n) >= threshold;\n"
+    "    }\n"
+    "  }\n"
+    "  if (!done_p) {\n"
+    "    uv_p += along * EDGE_GUESS;\n"
+    "  }\n"
+    "  if (!done_n) {\n"
+    "    uv_n -= along * EDGE_GUESS;\n"
+    "  }\n"
+
+    "  let dist_p = select(uv_p.y - uv.y, uv_p.x - uv.x, is_horizontal);\n"
+    "  let dist_n = select(uv.y - uv_n.y, uv.x - uv_n.x, is_horizontal);\n"
+    "  let closest_p = dist_p <= dist_n;\n"
+    "  let shortest = min(dist_p, dist_n);\n"
+    "  let delta = select(delta_n, delta_p, closest_p);\n"
+
+    /* Only blend if the center is on the side of the edge that ends at the
+     * closest end, otherwise the pixel is already correct. */
+    "  var edge_blend = 0.0;\n"
+    "  if ((delta >= 0.0) != (m - edge_luma >= 0.0)) {\n"
+    "    edge_blend = 0.5 - shortest / max(dist_p + dist_n, 1e-6);\n"
+    "  }\n"
+
+    "  let blend = max(edge_blend, subpixel_blend);\n"
+    "  let result = sample_color(uv + across * blend);\n"
+    "  return vec4<f32>(result.rgb, center.a);\n"
+    "}\n";
+
+static ecs_entity_t flecsEngine_fxaa_shader(
+    ecs_world_t *world)
+{
+    return flecsEngine_shader_ensure(world, "FXAAPostShader",
+        &(FlecsShader){
+            .source = kShaderSource,
+            .vertex_entry = "vs_main",
+            .fragment_entry = "fs_main"
+        });
+}
+
+static void flecsEngine_fxaa_releaseResources(
+    FlecsFXAAImpl *impl)
+{
+    if (impl->uniform_buffer) {
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryEffect, impl->uniform_buffer);
+        impl->uniform_buffer = NULL;
+    }
+}
+
+FLECS_ENGINE_IMPL_HOOKS(FlecsFXAAImpl, flecsEngine_fxaa_releaseResources)
+
+static void flecsEngine_fxaa_fillUniform(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    ecs_entity_t effect_entity,
+    const FlecsFXAA *fxaa,
+    FlecsFXAAUniform *uniform)
+{
+    uniform->params[0] = fxaa->edge_threshold;
+    uniform->params[1] = fxaa->edge_threshold_min;
+    uniform->params[2] = glm_clamp(fxaa->subpixel, 0.0f, 1.0f);
+    uniform->params[3] = 0.0f;
+
+    /* Inputs are view targets, which are allocated at the actual size */
+    float input_width = (float)engine->actual_width;
+    float input_height = (float)engine->actual_height;
+
+    ecs_entity_t view_entity = ecs_get_target(world, effect_entity, EcsChildOf, 0);
+    if (view_entity) {
+        const FlecsRenderViewImpl *view_impl = ecs_get(
+            world, view_entity, FlecsRenderViewImpl);
+        if (view_impl && view_impl->effect_target_width > 0) {
+            input_width = (float)view_impl->effect_target_width;
+            input_height = (float)view_impl->effect_target_height;
+        }
+    }
+
+    uniform->viewport[0] = (float)engine->render_width;
+    uniform->viewport[1] = (float)engine->render_height;
+    uniform->viewport[2] = input_width > 0.0f ? 1.0f / input_width : 1.0f;
+    uniform->viewport[3] = input_height > 0.0f ? 1.0f / input_height : 1.0f;
+}
+
+static bool flecsEngine_fxaa_setup(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    ecs_entity_t effect_entity,
+    const FlecsRenderEffect *effect,
+    FlecsRenderEffectImpl *effect_impl,
+    WGPUBindGroupLayoutEntry *layout_entries,
+    uint32_t *entry_count)
+{
+    (void)effect;
+    (void)effect_impl;
+
+    ecs_assert(layout_entries != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(entry_count != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(*entry_count == 2, ECS_INVALID_PARAMETER, NULL);
+
+    FlecsFXAAImpl fxaa_impl = {0};
+
+    WGPUBufferDescriptor uniform_desc = {
+        .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+        .size = sizeof(FlecsFXAAUniform)
+    };
+
+    fxaa_impl.uniform_buffer = flecsEngine_gpuMemory_createBuffer(
+        engine->device, FlecsGpuMemoryEffect, &uniform_desc);
+    if (!fxaa_impl.uniform_buffer) {
+        return false;
+    }
+
+    layout_entries[2] = (WGPUBindGroupLayoutEntry){
+        .binding = 2,
+        .visibility = WGPUShaderStage_Fragment,
+        .buffer = {
+            .type = WGPUBufferBindingType_Uniform,
+            .minBindingSize = sizeof(FlecsFXAAUniform)
+        }
+    };
+
+    ecs_set_ptr((ecs_world_t*)world, effect_entity, FlecsFXAAImpl, &fxaa_impl);
+
+    *entry_count = 3;
+    return true;
+}
+
+static bool flecsEngine_fxaa_bind(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    ecs_entity_t effect_entity,
+    const FlecsRenderEffect *effect,
+    const FlecsRenderEffectImpl *impl,
+    WGPUBindGroupEntry *entries,
+    uint32_t *entry_count)
+{
+    (void)effect;
+    (void)impl;
+
+    ecs_assert(entries != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(entry_count != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(*entry_count == 2, ECS_INVALID_PARAMETER, NULL);
+
+    const FlecsFXAA *fxaa = ecs_get(world, effect_entity, FlecsFXAA);
+    const FlecsFXAAImpl *fxaa_impl = ecs_get(
+        world, effect_entity, FlecsFXAAImpl);
+    if (!fxaa || !fxaa_impl || !fxaa_impl->uniform_buffer) {
+        return false;
+    }
+
+    FlecsFXAAUniform uniform = {0};
+    flecsEngine_fxaa_fillUniform(world, engine, effect_entity, fxaa, &uniform);
+    flecsEngine_queueWriteBuffer(
+        engine,
+        fxaa_impl->uniform_buffer,
+        0,
+        &uniform,
+        sizeof(uniform));
+
+    entries[2] = (WGPUBindGroupEntry){
+        .binding = 2,
+        .buffer = fxaa_impl->uniform_buffer,
+        .offset = 0,
+        .size = sizeof(FlecsFXAAUniform)
+    };
+
+    *entry_count = 3;
+    return true;
+}
+
+FlecsFXAA flecsEngine_fxaaSettingsDefault(void)
+{
+    return (FlecsFXAA){
+        .edge_threshold = 0.125f,
+        .edge_threshold_min = 0.0312f,
+        .subpixel = 0.75f
+    };
+}
+
+ecs_entity_t flecsEngine_createEffect_fxaa(
+    ecs_world_t *world,
+    ecs_entity_t parent,
+    const char *name,
+    int32_t input,
+    const FlecsFXAA *settings)
+{
+    ecs_entity_t effect = ecs_entity(world, { .parent = parent, .name = name });
+
+    FlecsFXAA fxaa = settings
+        ? *settings
+        : flecsEngine_fxaaSettingsDefault();
+
+    ecs_set_ptr(world, effect, FlecsFXAA, &fxaa);
+    ecs_set(world, effect, FlecsRenderEffect, {
+        .shader = flecsEngine_fxaa_shader(world),
+        .input = input,
+        .setup_callback = flecsEngine_fxaa_setup,
+        .bind_callback = flecsEngine_fxaa_bind
+    });
+
+    return effect;
+}
+
+void flecsEngine_fxaa_register(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, FlecsFXAA);
+    ECS_COMPONENT_DEFINE(world, FlecsFXAAImpl);
+
+    ecs_set_hooks(world, FlecsFXAAImpl, {
+        .ctor = flecs_default_ctor,
+        .move = ecs_move(FlecsFXAAImpl),
+        .dtor = ecs_dtor(FlecsFXAAImpl)
+    });
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsFXAA),
+        .members = {
+            { .name = "edge_threshold", .type = ecs_id(ecs_f32_t) },
+            { .name = "edge_threshold_min", .type = ecs_id(ecs_f32_t) },
+            { .name = "subpixel", .type = ecs_id(ecs_f32_t) }
+        }
+    });
+}
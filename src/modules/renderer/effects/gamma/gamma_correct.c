@@ -12,15 +12,16 @@
 #include "../../renderer.h"
 #include "flecs_engine.h"
 
+#define FLECS_ENGINE_GAMMA_STAGE_WGSL \
+    "fn gamma_apply(c : vec4<f32>, pos : vec4<f32>, uv : vec2<f32>) -> vec4<f32> {\n" \
+    "  let gamma = vec3<f32>(1.0 / 2.2);\n" \
+    "  return vec4<f32>(pow(c.rgb, gamma), c.a);\n" \
+    "}\n"
+
+static const char *kStageSource = FLECS_ENGINE_GAMMA_STAGE_WGSL;
+
 static const char *kShaderSource =
-    FLECS_ENGINE_FULLSCREEN_VS_WGSL
-    "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n"
-    "@group(0) @binding(1) var input_sampler : sampler;\n"
-    "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
-    "  let c = textureSample(input_texture, input_sampler, in.uv);\n"
-    "  let gamma = vec3<f32>(1.0 / 2.2);\n"
-    "  return vec4<f32>(pow(c.rgb, gamma), c.a);\n"
-    "}\n";
+    FLECS_ENGINE_POINTWISE_EFFECT_WGSL(FLECS_ENGINE_GAMMA_STAGE_WGSL, "gamma_apply");
 
 static ecs_entity_t flecsEngine_gammaCorrect_shader(
     ecs_world_t *world)
@@ -42,7 +43,9 @@ ecs_entity_t flecsEngine_createEffect_gammaCorrect(
     ecs_entity_t effect = ecs_entity(world, { .parent = parent, .name = name });
     ecs_set(world, effect, FlecsRenderEffect, {
         .shader = flecsEngine_gammaCorrect_shader(world),
-        .input = input
+        .input = input,
+        .pointwise = kStageSource,
+        .pointwise_fn = "gamma_apply"
     });
 
     return effect;
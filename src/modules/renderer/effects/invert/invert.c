@@ -1,14 +1,15 @@
 #include "../../renderer.h"
 #include "flecs_engine.h"
 
+#define FLECS_ENGINE_INVERT_STAGE_WGSL \
+    "fn invert_apply(src : vec4<f32>, pos : vec4<f32>, uv : vec2<f32>) -> vec4<f32> {\n" \
+    "  return vec4<f32>(vec3<f32>(1.0) - src.rgb, src.a);\n" \
+    "}\n"
+
+static const char *kStageSource = FLECS_ENGINE_INVERT_STAGE_WGSL;
+
 static const char *kShaderSource =
-    FLECS_ENGINE_FULLSCREEN_VS_WGSL
-    "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n"
-    "@group(0) @binding(1) var input_sampler : sampler;\n"
-    "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
-    "  let src = textureSample(input_texture, input_sampler, in.uv);\n"
-    "  return vec4<f32>(vec3<f32>(1.0) - src.rgb, src.a);\n"
-    "}\n";
+    FLECS_ENGINE_POINTWISE_EFFECT_WGSL(FLECS_ENGINE_INVERT_STAGE_WGSL, "invert_apply");
 
 static ecs_entity_t flecsEngine_invert_shader(
     ecs_world_t *world)
@@ -30,7 +31,9 @@ ecs_entity_t flecsEngine_createEffect_invert(
     ecs_entity_t effect = ecs_entity(world, { .parent = parent, .name = name });
     ecs_set(world, effect, FlecsRenderEffect, {
         .shader = flecsEngine_invert_shader(world),
-        .input = input
+        .input = input,
+        .pointwise = kStageSource,
+        .pointwise_fn = "invert_apply"
     });
 
     return effect;
@@ -6,14 +6,15 @@ static const char *kShaderSource =
     "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n"
     "@group(0) @binding(1) var input_sampler : sampler;\n"
     "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
-    "  return textureSample(input_texture, input_sampler, in.uv);\n"
+    "  return textureSample(input_texture, input_sampler,\n"
+    "    fullscreen_uv(in.pos, textureDimensions(input_texture)));\n"
     "}\n";
 
 int flecsEngine_initPassthrough(
     FlecsEngineImpl *impl)
 {
-    WGPUShaderModule module = flecsEngine_createShaderModule(
-        impl->device, kShaderSource);
+    WGPUShaderModule module = flecsEngine_shaderCache_get(
+        impl, kShaderSource);
     if (!module) {
         return -1;
     }
@@ -31,7 +32,6 @@ int flecsEngine_initPassthrough(
             .maxAnisotropy = 1
         });
     if (!impl->depth.passthrough_sampler) {
-        wgpuShaderModuleRelease(module);
         return -1;
     }
 
@@ -57,7 +57,6 @@ int flecsEngine_initPassthrough(
             .entryCount = 2
         });
     if (!impl->depth.passthrough_bind_layout) {
-        wgpuShaderModuleRelease(module);
         return -1;
     }
 
@@ -67,7 +66,6 @@ int flecsEngine_initPassthrough(
             .bindGroupLayouts = &impl->depth.passthrough_bind_layout
         });
     if (!pipeline_layout) {
-        wgpuShaderModuleRelease(module);
         return -1;
     }
 
@@ -98,7 +96,6 @@ int flecsEngine_initPassthrough(
         });
 
     wgpuPipelineLayoutRelease(pipeline_layout);
-    wgpuShaderModuleRelease(module);
 
     return impl->depth.passthrough_pipeline ? 0 : -1;
 }
@@ -4,69 +4,144 @@
 ECS_COMPONENT_DECLARE(FlecsSSAO);
 ECS_COMPONENT_DECLARE(FlecsSSAOImpl);
 
+#define FLECS_ENGINE_SSAO_KERNEL_SIZE (16)
+#define FLECS_ENGINE_SSAO_MAX_RESOLUTION (4)
+#define FLECS_ENGINE_SSAO_DEPTH_FORMAT (WGPUTextureFormat_R32Float)
+#define FLECS_ENGINE_SSAO_AO_FORMAT (WGPUTextureFormat_R16Float)
+#define FLECS_ENGINE_SSAO_HISTORY_FORMAT (WGPUTextureFormat_RG16Float)
+
 typedef struct FlecsSSAOUniform {
     mat4 proj;
     mat4 inv_proj;
+    mat4 reproject;     /* Current NDC to previous clip space */
     float params[4];    /* radius, bias, intensity, blur */
-    float viewport[4];  /* width, height, 1/width, 1/height */
+    float viewport[4];  /* render width, height, 1/width, 1/height */
+    float ao[4];        /* AO region width, height, 1/width, 1/height */
+    float sampling[4];  /* sample count, kernel stride, kernel offset, noise offset */
+    float history[4];   /* blend, valid, previous region / texture size */
 } FlecsSSAOUniform;
 
+#define FLECS_ENGINE_SSAO_UNIFORMS_WGSL \
+    "struct SsaoUniforms {\n" \
+    "  proj : mat4x4<f32>,\n" \
+    "  inv_proj : mat4x4<f32>,\n" \
+    "  reproject : mat4x4<f32>,\n" \
+    "  params : vec4<f32>,\n" \
+    "  viewport : vec4<f32>,\n" \
+    "  ao : vec4<f32>,\n" \
+    "  sampling : vec4<f32>,\n" \
+    "  history : vec4<f32>,\n" \
+    "};\n"
+
+/* Occlusion of a pixel. Expects a load_depth(texel) function that reads the
+ * depth at the resolution of the AO. Each frame evaluates sample_count
+ * kernel entries, spread over the kernel with a stride. Rotating the offset
+ * over frames covers the whole kernel. */
+#define FLECS_ENGINE_SSAO_AO_WGSL \
+    "fn reconstruct_view_pos(uv : vec2<f32>, depth : f32) -> vec3<f32> {\n" \
+    "  let ndc = vec4<f32>(\n" \
+    "    uv.x * 2.0 - 1.0,\n" \
+    "    (1.0 - uv.y) * 2.0 - 1.0,\n" \
+    "    depth,\n" \
+    "    1.0);\n" \
+    "  let view_h = uniforms.inv_proj * ndc;\n" \
+    "  return view_h.xyz / view_h.w;\n" \
+    "}\n" \
+    "fn hash22(p : vec2<f32>) -> vec2<f32> {\n" \
+    "  var p3 = fract(vec3<f32>(p.xyx) * vec3<f32>(0.1031, 0.1030, 0.0973));\n" \
+    "  p3 += dot(p3, p3.yzx + 33.33);\n" \
+    "  return fract((p3.xx + p3.yz) * p3.zy);\n" \
+    "}\n" \
+    "const SAMPLE_COUNT = 16u;\n" \
+    "const kernel = array<vec3<f32>, 16>(\n" \
+    "  vec3<f32>( 0.0380,  0.0510,  0.0146),\n" \
+    "  vec3<f32>(-0.0447,  0.0118,  0.0327),\n" \
+    "  vec3<f32>( 0.0264, -0.0423,  0.0581),\n" \
+    "  vec3<f32>(-0.0307,  0.0576,  0.0421),\n" \
+    "  vec3<f32>( 0.0765,  0.0167,  0.0604),\n" \
+    "  vec3<f32>(-0.0579,  0.0611,  0.0527),\n" \
+    "  vec3<f32>( 0.0948, -0.0388,  0.0688),\n" \
+    "  vec3<f32>(-0.0635,  0.0906,  0.0784),\n" \
+    "  vec3<f32>( 0.1291, -0.0206,  0.1064),\n" \
+    "  vec3<f32>(-0.0598,  0.1399,  0.0862),\n" \
+    "  vec3<f32>( 0.1106,  0.1161,  0.1203),\n" \
+    "  vec3<f32>(-0.1588, -0.0539,  0.1040),\n" \
+    "  vec3<f32>( 0.1728,  0.1124,  0.1365),\n" \
+    "  vec3<f32>(-0.0756, -0.1867,  0.1226),\n" \
+    "  vec3<f32>( 0.2300, -0.0827,  0.1510),\n" \
+    "  vec3<f32>(-0.1842,  0.1689,  0.2032)\n" \
+    ");\n" \
+    "fn ssao_occlusion(uv : vec2<f32>, texel : vec2<i32>, dims_f : vec2<f32>,\n" \
+    "  texel_size : vec2<f32>, depth : f32) -> f32\n" \
+    "{\n" \
+    "  let view_pos = reconstruct_view_pos(uv, depth);\n" \
+    "  let px = texel_size.x;\n" \
+    "  let py = texel_size.y;\n" \
+    "  let vp_r = reconstruct_view_pos(\n" \
+    "    uv + vec2<f32>(px, 0.0),\n" \
+    "    load_depth(texel + vec2<i32>(1, 0)));\n" \
+    "  let vp_u = reconstruct_view_pos(\n" \
+    "    uv + vec2<f32>(0.0, -py),\n" \
+    "    load_depth(texel + vec2<i32>(0, -1)));\n" \
+    "  let normal = normalize(cross(vp_r - view_pos, vp_u - view_pos));\n" \
+    "  let noise = hash22(vec2<f32>(f32(texel.x), f32(texel.y)) +\n" \
+    "    uniforms.sampling.w);\n" \
+    "  var random_vec = vec3<f32>(noise.x * 2.0 - 1.0, noise.y * 2.0 - 1.0, 0.0);\n" \
+    "  random_vec = normalize(random_vec - normal * dot(random_vec, normal));\n" \
+    "  let tangent = random_vec;\n" \
+    "  let bitangent = cross(normal, tangent);\n" \
+    "  let radius = uniforms.params.x;\n" \
+    "  let bias = uniforms.params.y;\n" \
+    "  let intensity = uniforms.params.z;\n" \
+    "  let count = u32(uniforms.sampling.x);\n" \
+    "  let stride = u32(uniforms.sampling.y);\n" \
+    "  let offset = u32(uniforms.sampling.z);\n" \
+    "  var occlusion = 0.0;\n" \
+    "  for (var i = 0u; i < count; i++) {\n" \
+    "    let k = kernel[(i * stride + offset) % SAMPLE_COUNT];\n" \
+    "    let sample_dir = tangent * k.x + bitangent * k.y + normal * k.z;\n" \
+    "    let sample_pos = view_pos + sample_dir * radius;\n" \
+    "    let sample_clip = uniforms.proj * vec4<f32>(sample_pos, 1.0);\n" \
+    "    var sample_uv = sample_clip.xy / sample_clip.w;\n" \
+    "    sample_uv = sample_uv * vec2<f32>(0.5, -0.5) + vec2<f32>(0.5, 0.5);\n" \
+    "    if (sample_uv.x < 0.0 || sample_uv.x > 1.0 ||\n" \
+    "        sample_uv.y < 0.0 || sample_uv.y > 1.0) {\n" \
+    "      continue;\n" \
+    "    }\n" \
+    "    let s_texel = vec2<i32>(sample_uv * dims_f);\n" \
+    "    let s_depth = load_depth(s_texel);\n" \
+    "    let sample_view = reconstruct_view_pos(sample_uv, s_depth);\n" \
+    "    let range_check = smoothstep(\n" \
+    "      0.0, 1.0, radius / max(abs(view_pos.z - sample_view.z), 1e-6));\n" \
+    "    occlusion += select(0.0, 1.0,\n" \
+    "      sample_view.z >= sample_pos.z + bias) * range_check;\n" \
+    "  }\n" \
+    "  let fade = 1.0 - smoothstep(radius * 40.0, radius * 100.0, -view_pos.z);\n" \
+    "  return clamp(1.0 - (occlusion / f32(count)) * intensity * fade, 0.0, 1.0);\n" \
+    "}\n"
+
 static const char *kShaderSource =
     FLECS_ENGINE_FULLSCREEN_VS_WGSL
-    "struct SsaoUniforms {\n"
-    "  proj : mat4x4<f32>,\n"
-    "  inv_proj : mat4x4<f32>,\n"
-    "  params : vec4<f32>,\n"
-    "  viewport : vec4<f32>,\n"
-    "};\n"
+    FLECS_ENGINE_SSAO_UNIFORMS_WGSL
     "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n"
     "@group(0) @binding(1) var input_sampler : sampler;\n"
     "@group(0) @binding(2) var depth_texture : texture_depth_2d;\n"
     "@group(0) @binding(3) var<uniform> uniforms : SsaoUniforms;\n"
-
-    "fn reconstruct_view_pos(uv : vec2<f32>, depth : f32) -> vec3<f32> {\n"
-    "  let ndc = vec4<f32>(\n"
-    "    uv.x * 2.0 - 1.0,\n"
-    "    (1.0 - uv.y) * 2.0 - 1.0,\n"
-    "    depth,\n"
-    "    1.0);\n"
-    "  let view_h = uniforms.inv_proj * ndc;\n"
-    "  return view_h.xyz / view_h.w;\n"
-    "}\n"
-
-    "fn hash22(p : vec2<f32>) -> vec2<f32> {\n"
-    "  var p3 = fract(vec3<f32>(p.xyx) * vec3<f32>(0.1031, 0.1030, 0.0973));\n"
-    "  p3 += dot(p3, p3.yzx + 33.33);\n"
-    "  return fract((p3.xx + p3.yz) * p3.zy);\n"
+    "fn load_depth(texel : vec2<i32>) -> f32 {\n"
+    "  return textureLoad(depth_texture, texel, 0);\n"
     "}\n"
-
-    "const SAMPLE_COUNT = 16u;\n"
-    "const kernel = array<vec3<f32>, 16>(\n"
-    "  vec3<f32>( 0.0380,  0.0510,  0.0146),\n"
-    "  vec3<f32>(-0.0447,  0.0118,  0.0327),\n"
-    "  vec3<f32>( 0.0264, -0.0423,  0.0581),\n"
-    "  vec3<f32>(-0.0307,  0.0576,  0.0421),\n"
-    "  vec3<f32>( 0.0765,  0.0167,  0.0604),\n"
-    "  vec3<f32>(-0.0579,  0.0611,  0.0527),\n"
-    "  vec3<f32>( 0.0948, -0.0388,  0.0688),\n"
-    "  vec3<f32>(-0.0635,  0.0906,  0.0784),\n"
-    "  vec3<f32>( 0.1291, -0.0206,  0.1064),\n"
-    "  vec3<f32>(-0.0598,  0.1399,  0.0862),\n"
-    "  vec3<f32>( 0.1106,  0.1161,  0.1203),\n"
-    "  vec3<f32>(-0.1588, -0.0539,  0.1040),\n"
-    "  vec3<f32>( 0.1728,  0.1124,  0.1365),\n"
-    "  vec3<f32>(-0.0756, -0.1867,  0.1226),\n"
-    "  vec3<f32>( 0.2300, -0.0827,  0.1510),\n"
-    "  vec3<f32>(-0.1842,  0.1689,  0.2032)\n"
-    ");\n"
+    FLECS_ENGINE_SSAO_AO_WGSL
 
     "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
-    "  let src = textureSample(input_texture, input_sampler, in.uv);\n"
-    "  let dims = textureDimensions(depth_texture);\n"
-    "  let dims_f = vec2<f32>(f32(dims.x), f32(dims.y));\n"
+    /* in.uv spans the render viewport, which is the top-left region of the
+     * input and depth textures. */
+    "  let uv_scale = uniforms.viewport.xy /\n"
+    "    vec2<f32>(textureDimensions(depth_texture));\n"
+    "  let src = textureSample(input_texture, input_sampler, in.uv * uv_scale);\n"
+    "  let dims_f = uniforms.viewport.xy;\n"
     "  let clamped_uv = clamp(in.uv, vec2<f32>(0.0), vec2<f32>(0.999999));\n"
     "  let texel = vec2<i32>(clamped_uv * dims_f);\n"
-    "  let depth = textureLoad(depth_texture, texel, 0);\n"
+    "  let depth = load_depth(texel);\n"
     "  if (depth >= 0.999999) {\n"
     "    if (uniforms.params.w > 0.0) {\n"
     "      return vec4<f32>(1.0, 1.0, 1.0, 1.0);\n"
@@ -74,54 +149,7 @@ static const char *kShaderSource =
     "    return src;\n"
     "  }\n"
 
-    "  let view_pos = reconstruct_view_pos(in.uv, depth);\n"
-
-    "  let px = uniforms.viewport.z;\n"
-    "  let py = uniforms.viewport.w;\n"
-    "  let vp_r = reconstruct_view_pos(\n"
-    "    in.uv + vec2<f32>(px, 0.0),\n"
-    "    textureLoad(depth_texture, texel + vec2<i32>(1, 0), 0));\n"
-    "  let vp_u = reconstruct_view_pos(\n"
-    "    in.uv + vec2<f32>(0.0, -py),\n"
-    "    textureLoad(depth_texture, texel + vec2<i32>(0, -1), 0));\n"
-    "  let normal = normalize(cross(vp_r - view_pos, vp_u - view_pos));\n"
-    "  let noise = hash22(vec2<f32>(f32(texel.x), f32(texel.y)));\n"
-    "  var random_vec = vec3<f32>(noise.x * 2.0 - 1.0, noise.y * 2.0 - 1.0, 0.0);\n"
-    "  random_vec = normalize(random_vec - normal * dot(random_vec, normal));\n"
-    "  let tangent = random_vec;\n"
-    "  let bitangent = cross(normal, tangent);\n"
-
-    "  let radius = uniforms.params.x;\n"
-    "  let bias = uniforms.params.y;\n"
-    "  let intensity = uniforms.params.z;\n"
-
-    "  var occlusion = 0.0;\n"
-    "  for (var i = 0u; i < SAMPLE_COUNT; i++) {\n"
-    "    let k = kernel[i];\n"
-    "    let sample_dir = tangent * k.x + bitangent * k.y + normal * k.z;\n"
-    "    let sample_pos = view_pos + sample_dir * radius;\n"
-
-    "    let sample_clip = uniforms.proj * vec4<f32>(sample_pos, 1.0);\n"
-    "    var sample_uv = sample_clip.xy / sample_clip.w;\n"
-    "    sample_uv = sample_uv * vec2<f32>(0.5, -0.5) + vec2<f32>(0.5, 0.5);\n"
-
-    "    if (sample_uv.x < 0.0 || sample_uv.x > 1.0 ||\n"
-    "        sample_uv.y < 0.0 || sample_uv.y > 1.0) {\n"
-    "      continue;\n"
-    "    }\n"
-
-    "    let s_texel = vec2<i32>(sample_uv * dims_f);\n"
-    "    let s_depth = textureLoad(depth_texture, s_texel, 0);\n"
-    "    let sample_view = reconstruct_view_pos(sample_uv, s_depth);\n"
-
-    "    let range_check = smoothstep(\n"
-    "      0.0, 1.0, radius / max(abs(view_pos.z - sample_view.z), 1e-6));\n"
-    "    occlusion += select(0.0, 1.0,\n"
-    "      sample_view.z >= sample_pos.z + bias) * range_check;\n"
-    "  }\n"
-
-    "  let fade = 1.0 - smoothstep(radius * 40.0, radius * 100.0, -view_pos.z);\n"
-    "  let ao = clamp(1.0 - (occlusion / f32(SAMPLE_COUNT)) * intensity * fade, 0.0, 1.0);\n"
+    "  let ao = ssao_occlusion(in.uv, texel, dims_f, uniforms.viewport.zw, depth);\n"
 
     /* When blur is enabled, output AO factor only so the blur pass
      * operates on the occlusion term without smearing scene colors.
@@ -132,38 +160,160 @@ static const char *kShaderSource =
     "  return vec4<f32>(src.rgb * ao, src.a);\n"
     "}\n";
 
+/* Reduces the depth buffer to the AO resolution. Texels alternate between
+ * the closest and farthest depth of their footprint, so that both sides of
+ * a depth edge survive the downsample. */
+static const char *kDepthShaderSource =
+    FLECS_ENGINE_FULLSCREEN_VS_WGSL
+    FLECS_ENGINE_SSAO_UNIFORMS_WGSL
+    "@group(0) @binding(0) var depth_texture : texture_depth_2d;\n"
+    "@group(0) @binding(1) var<uniform> uniforms : SsaoUniforms;\n"
+    "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
+    "  let texel = vec2<i32>(in.pos.xy);\n"
+    "  let dims = vec2<i32>(uniforms.viewport.xy);\n"
+    "  let footprint = uniforms.viewport.xy * uniforms.ao.zw;\n"
+    "  let base = vec2<i32>(vec2<f32>(texel) * footprint);\n"
+    "  let extent = clamp(vec2<i32>(ceil(footprint)), vec2<i32>(1), vec2<i32>(4));\n"
+    "  let farthest = ((texel.x + texel.y) & 1) == 1;\n"
+    "  var depth = select(1.0, 0.0, farthest);\n"
+    "  for (var y = 0; y < extent.y; y++) {\n"
+    "    for (var x = 0; x < extent.x; x++) {\n"
+    "      let t = clamp(base + vec2<i32>(x, y), vec2<i32>(0), dims - 1);\n"
+    "      let d = textureLoad(depth_texture, t, 0);\n"
+    "      depth = select(min(depth, d), max(depth, d), farthest);\n"
+    "    }\n"
+    "  }\n"
+    "  return vec4<f32>(depth, 0.0, 0.0, 1.0);\n"
+    "}\n";
+
+/* AO at reduced resolution, from the downsampled depth. Outputs the AO
+ * factor only, which is composited by the blur pass. */
+static const char *kLowResShaderSource =
+    FLECS_ENGINE_FULLSCREEN_VS_WGSL
+    FLECS_ENGINE_SSAO_UNIFORMS_WGSL
+    "@group(0) @binding(0) var depth_texture : texture_2d<f32>;\n"
+    "@group(0) @binding(1) var<uniform> uniforms : SsaoUniforms;\n"
+    "fn load_depth(texel : vec2<i32>) -> f32 {\n"
+    "  return textureLoad(depth_texture, texel, 0).r;\n"
+    "}\n"
+    FLECS_ENGINE_SSAO_AO_WGSL
+    "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
+    "  let dims_f = uniforms.ao.xy;\n"
+    "  let clamped_uv = clamp(in.uv, vec2<f32>(0.0), vec2<f32>(0.999999));\n"
+    "  let texel = vec2<i32>(clamped_uv * dims_f);\n"
+    "  let depth = load_depth(texel);\n"
+    "  if (depth >= 0.999999) {\n"
+    "    return vec4<f32>(1.0, 1.0, 1.0, 1.0);\n"
+    "  }\n"
+    "  let ao = ssao_occlusion(in.uv, texel, dims_f, uniforms.ao.zw, depth);\n"
+    "  return vec4<f32>(ao, ao, ao, 1.0);\n"
+    "}\n";
+
+/* Blends the AO of this frame into the history, reprojected with the camera
+ * motion. The history stores AO and linear depth, which rejects history of
+ * surfaces that weren't visible in the previous frame. */
+static const char *kTemporalShaderSource =
+    FLECS_ENGINE_FULLSCREEN_VS_WGSL
+    FLECS_ENGINE_SSAO_UNIFORMS_WGSL
+    "@group(0) @binding(0) var ao_texture : texture_2d<f32>;\n"
+    "@group(0) @binding(1) var history_texture : texture_2d<f32>;\n"
+    "@group(0) @binding(2) var depth_texture : texture_2d<f32>;\n"
+    "@group(0) @binding(3) var history_sampler : sampler;\n"
+    "@group(0) @binding(4) var<uniform> uniforms : SsaoUniforms;\n"
+    "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
+    "  let texel = vec2<i32>(in.pos.xy);\n"
+    "  let ao = textureLoad(ao_texture, texel, 0).r;\n"
+    "  let depth = textureLoad(depth_texture, texel, 0).r;\n"
+    "  if (depth >= 0.999999) {\n"
+    "    return vec4<f32>(1.0, 0.0, 0.0, 1.0);\n"
+    "  }\n"
+    "  let uv = (vec2<f32>(texel) + 0.5) * uniforms.ao.zw;\n"
+    "  let ndc = vec4<f32>(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, depth, 1.0);\n"
+    "  let view_h = uniforms.inv_proj * ndc;\n"
+    "  let linear_depth = -view_h.z / view_h.w;\n"
+    "  let current = vec4<f32>(ao, linear_depth, 0.0, 1.0);\n"
+    "  if (uniforms.history.y <= 0.0) {\n"
+    "    return current;\n"
+    "  }\n"
+    "  let prev_clip = uniforms.reproject * ndc;\n"
+    "  if (prev_clip.w <= 0.0) {\n"
+    "    return current;\n"
+    "  }\n"
+    "  let prev_ndc = prev_clip.xy / prev_clip.w;\n"
+    "  let prev_uv = vec2<f32>(prev_ndc.x * 0.5 + 0.5, 0.5 - prev_ndc.y * 0.5);\n"
+    "  if (any(prev_uv < vec2<f32>(0.0)) || any(prev_uv > vec2<f32>(1.0))) {\n"
+    "    return current;\n"
+    "  }\n"
+    "  let history = textureSampleLevel(history_texture, history_sampler,\n"
+    "    prev_uv * uniforms.history.zw, 0.0);\n"
+    "  if (abs(history.g - prev_clip.w) > 0.1 * prev_clip.w) {\n"
+    "    return current;\n"
+    "  }\n"
+    "  return vec4<f32>(mix(history.r, ao, uniforms.history.x),\n"
+    "    linear_depth, 0.0, 1.0);\n"
+    "}\n";
+
 /* Cross-bilateral blur + composite shader.
  * Blurs only the AO term using a 1-D cross pattern (horizontal + vertical),
  * giving O(n) cost instead of O(n^2), then composites with the scene. */
 static const char *kBlurShaderSource =
     FLECS_ENGINE_FULLSCREEN_VS_WGSL
-    "struct SsaoUniforms {\n"
-    "  proj : mat4x4<f32>,\n"
-    "  inv_proj : mat4x4<f32>,\n"
-    "  params : vec4<f32>,\n"
-    "  viewport : vec4<f32>,\n"
-    "};\n"
+    FLECS_ENGINE_SSAO_UNIFORMS_WGSL
     "@group(0) @binding(0) var ao_texture : texture_2d<f32>;\n"
     "@group(0) @binding(1) var input_sampler : sampler;\n"
     "@group(0) @binding(2) var depth_texture : texture_depth_2d;\n"
     "@group(0) @binding(3) var<uniform> uniforms : SsaoUniforms;\n"
     "@group(0) @binding(4) var scene_texture : texture_2d<f32>;\n"
 
+    "fn ao_depth(st : vec2<i32>, ao_dims : vec2<i32>, depth_dims : vec2<i32>) -> f32 {\n"
+    "  let sd_texel = clamp(vec2<i32>(\n"
+    "    (vec2<f32>(st) + 0.5) / vec2<f32>(ao_dims) * vec2<f32>(depth_dims)),\n"
+    "    vec2<i32>(0), depth_dims - vec2<i32>(1));\n"
+    "  return textureLoad(depth_texture, sd_texel, 0);\n"
+    "}\n"
+
+    /* Bilinear upsample of reduced resolution AO, with weights that drop
+     * for AO texels at a different depth than the pixel. */
+    "fn upsample_ao(uv : vec2<f32>, ao_dims : vec2<i32>, depth_dims : vec2<i32>,\n"
+    "  center_depth : f32) -> f32\n"
+    "{\n"
+    "  let pos = uv * vec2<f32>(ao_dims) - 0.5;\n"
+    "  let base = vec2<i32>(floor(pos));\n"
+    "  let f = pos - floor(pos);\n"
+    "  var total_ao = 0.0;\n"
+    "  var total_weight = 0.0;\n"
+    "  for (var y = 0; y < 2; y++) {\n"
+    "    for (var x = 0; x < 2; x++) {\n"
+    "      let st = clamp(base + vec2<i32>(x, y), vec2<i32>(0), ao_dims - 1);\n"
+    "      let bw = select(1.0 - f.x, f.x, x == 1) * select(1.0 - f.y, f.y, y == 1);\n"
+    "      let sd = ao_depth(st, ao_dims, depth_dims);\n"
+    "      let w = max(bw, 1e-3) * exp(-abs(center_depth - sd) / 0.001);\n"
+    "      total_ao += textureLoad(ao_texture, st, 0).r * w;\n"
+    "      total_weight += w;\n"
+    "    }\n"
+    "  }\n"
+    "  if (total_weight <= 1e-5) {\n"
+    "    let st = clamp(vec2<i32>(uv * vec2<f32>(ao_dims)), vec2<i32>(0), ao_dims - 1);\n"
+    "    return textureLoad(ao_texture, st, 0).r;\n"
+    "  }\n"
+    "  return total_ao / total_weight;\n"
+    "}\n"
+
     "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
-    "  let ao_dims = vec2<i32>(textureDimensions(ao_texture));\n"
+    /* Only the region of the textures that maps to the render viewport is
+     * rendered to. */
+    "  let uv_scale = uniforms.viewport.xy /\n"
+    "    vec2<f32>(textureDimensions(depth_texture));\n"
+    "  let ao_size = vec2<f32>(textureDimensions(ao_texture)) * uv_scale;\n"
+    "  let ao_dims = max(vec2<i32>(ao_size), vec2<i32>(1));\n"
     "  let clamped_uv = clamp(in.uv, vec2<f32>(0.0), vec2<f32>(0.999999));\n"
     "  let texel = vec2<i32>(clamped_uv * vec2<f32>(ao_dims));\n"
     "  let center_ao = textureLoad(ao_texture, texel, 0).r;\n"
-    "  let scene_dims = vec2<i32>(textureDimensions(scene_texture));\n"
-    "  let scene_texel = vec2<i32>(clamped_uv * vec2<f32>(scene_dims));\n"
+    "  let scene_texel = vec2<i32>(clamped_uv * uniforms.viewport.xy);\n"
     "  let scene = textureLoad(scene_texture, scene_texel, 0);\n"
 
     "  let blur_radius = i32(uniforms.params.w);\n"
-    "  if (blur_radius <= 0) {\n"
-    "    return vec4<f32>(scene.rgb * center_ao, scene.a);\n"
-    "  }\n"
-
-    "  let depth_dims = vec2<i32>(textureDimensions(depth_texture));\n"
+    "  let depth_dims = vec2<i32>(uniforms.viewport.xy);\n"
     "  let depth_texel = vec2<i32>(in.uv * vec2<f32>(depth_dims));\n"
     "  let center_depth = textureLoad(depth_texture,\n"
     "    clamp(depth_texel, vec2<i32>(0), depth_dims - vec2<i32>(1)), 0);\n"
@@ -172,6 +322,11 @@ static const char *kBlurShaderSource =
     "    return scene;\n"
     "  }\n"
 
+    "  if (blur_radius <= 0) {\n"
+    "    let ao = upsample_ao(in.uv, ao_dims, depth_dims, center_depth);\n"
+    "    return vec4<f32>(scene.rgb * ao, scene.a);\n"
+    "  }\n"
+
     "  let sigma = max(f32(blur_radius) * 0.5, 1.0);\n"
     "  let sigma2 = 2.0 * sigma * sigma;\n"
     "  let depth_sigma = 0.001;\n"
@@ -184,10 +339,7 @@ static const char *kBlurShaderSource =
     "    let st = texel + vec2<i32>(x, 0);\n"
     "    if (st.x < 0 || st.x >= ao_dims.x) { continue; }\n"
     "    let s_ao = textureLoad(ao_texture, st, 0).r;\n"
-    "    let sd_texel = clamp(vec2<i32>(\n"
-    "      (vec2<f32>(st) + 0.5) / vec2<f32>(ao_dims) * vec2<f32>(depth_dims)),\n"
-    "      vec2<i32>(0), depth_dims - vec2<i32>(1));\n"
-    "    let sd = textureLoad(depth_texture, sd_texel, 0);\n"
+    "    let sd = ao_depth(st, ao_dims, depth_dims);\n"
     "    let d2 = f32(x * x);\n"
     "    let sw = exp(-d2 / sigma2);\n"
     "    let dw = exp(-abs(center_depth - sd) / depth_sigma);\n"
@@ -202,10 +354,7 @@ static const char *kBlurShaderSource =
     "    let st = texel + vec2<i32>(0, y);\n"
     "    if (st.y < 0 || st.y >= ao_dims.y) { continue; }\n"
     "    let s_ao = textureLoad(ao_texture, st, 0).r;\n"
-    "    let sd_texel = clamp(vec2<i32>(\n"
-    "      (vec2<f32>(st) + 0.5) / vec2<f32>(ao_dims) * vec2<f32>(depth_dims)),\n"
-    "      vec2<i32>(0), depth_dims - vec2<i32>(1));\n"
-    "    let sd = textureLoad(depth_texture, sd_texel, 0);\n"
+    "    let sd = ao_depth(st, ao_dims, depth_dims);\n"
     "    let d2 = f32(y * y);\n"
     "    let sw = exp(-d2 / sigma2);\n"
     "    let dw = exp(-abs(center_depth - sd) / depth_sigma);\n"
@@ -235,13 +384,17 @@ static ecs_entity_t flecsEngine_ssao_shader(
 static void flecsEngine_ssao_releaseBlurTexture(
     FlecsSSAOImpl *impl)
 {
+    /* Blur bind groups sample the intermediate texture */
+    flecsEngine_bindGroupCache_fini(&impl->blur_bind_groups);
+
     if (impl->blur_intermediate_view) {
         wgpuTextureViewRelease(impl->blur_intermediate_view);
         impl->blur_intermediate_view = NULL;
     }
 
     if (impl->blur_intermediate_texture) {
-        wgpuTextureRelease(impl->blur_intermediate_texture);
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryEffect, impl->blur_intermediate_texture);
         impl->blur_intermediate_texture = NULL;
     }
 
@@ -249,15 +402,115 @@ static void flecsEngine_ssao_releaseBlurTexture(
     impl->blur_texture_height = 0;
 }
 
+static void flecsEngine_ssao_releaseLowResTextures(
+    FlecsSSAOImpl *impl)
+{
+    /* Blur bind groups sample the AO and history textures */
+    flecsEngine_bindGroupCache_fini(&impl->blur_bind_groups);
+
+    if (impl->low_res_bind_group) {
+        wgpuBindGroupRelease(impl->low_res_bind_group);
+        impl->low_res_bind_group = NULL;
+    }
+
+    for (int32_t i = 0; i < 2; i ++) {
+        if (impl->temporal_bind_groups[i]) {
+            wgpuBindGroupRelease(impl->temporal_bind_groups[i]);
+            impl->temporal_bind_groups[i] = NULL;
+        }
+
+        if (impl->history_views[i]) {
+            wgpuTextureViewRelease(impl->history_views[i]);
+            impl->history_views[i] = NULL;
+        }
+
+        if (impl->history_textures[i]) {
+            flecsEngine_gpuMemory_releaseTexture(
+                FlecsGpuMemoryEffect, impl->history_textures[i]);
+            impl->history_textures[i] = NULL;
+        }
+    }
+
+    if (impl->ao_view) {
+        wgpuTextureViewRelease(impl->ao_view);
+        impl->ao_view = NULL;
+    }
+
+    if (impl->ao_texture) {
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryEffect, impl->ao_texture);
+        impl->ao_texture = NULL;
+    }
+
+    if (impl->low_depth_view) {
+        wgpuTextureViewRelease(impl->low_depth_view);
+        impl->low_depth_view = NULL;
+    }
+
+    if (impl->low_depth_texture) {
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryEffect, impl->low_depth_texture);
+        impl->low_depth_texture = NULL;
+    }
+
+    impl->low_width = 0;
+    impl->low_height = 0;
+    impl->history_valid = false;
+}
+
+static void flecsEngine_ssao_releaseLowRes(
+    FlecsSSAOImpl *impl)
+{
+    flecsEngine_ssao_releaseLowResTextures(impl);
+    flecsEngine_bindGroupCache_fini(&impl->depth_bind_groups);
+
+    if (impl->history_sampler) {
+        wgpuSamplerRelease(impl->history_sampler);
+        impl->history_sampler = NULL;
+    }
+
+    if (impl->temporal_pipeline) {
+        wgpuRenderPipelineRelease(impl->temporal_pipeline);
+        impl->temporal_pipeline = NULL;
+    }
+
+    if (impl->low_res_pipeline) {
+        wgpuRenderPipelineRelease(impl->low_res_pipeline);
+        impl->low_res_pipeline = NULL;
+    }
+
+    if (impl->depth_pipeline) {
+        wgpuRenderPipelineRelease(impl->depth_pipeline);
+        impl->depth_pipeline = NULL;
+    }
+
+    if (impl->temporal_bind_layout) {
+        wgpuBindGroupLayoutRelease(impl->temporal_bind_layout);
+        impl->temporal_bind_layout = NULL;
+    }
+
+    if (impl->low_res_bind_layout) {
+        wgpuBindGroupLayoutRelease(impl->low_res_bind_layout);
+        impl->low_res_bind_layout = NULL;
+    }
+
+    if (impl->depth_bind_layout) {
+        wgpuBindGroupLayoutRelease(impl->depth_bind_layout);
+        impl->depth_bind_layout = NULL;
+    }
+}
+
 static void flecsEngine_ssao_releaseResources(
     FlecsSSAOImpl *impl)
 {
     if (impl->uniform_buffer) {
-        wgpuBufferRelease(impl->uniform_buffer);
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryEffect, impl->uniform_buffer);
         impl->uniform_buffer = NULL;
     }
 
     flecsEngine_ssao_releaseBlurTexture(impl);
+    flecsEngine_ssao_releaseLowRes(impl);
 
     if (impl->blur_pipeline_surface) {
         wgpuRenderPipelineRelease(impl->blur_pipeline_surface);
@@ -277,24 +530,90 @@ static void flecsEngine_ssao_releaseResources(
 
 FLECS_ENGINE_IMPL_HOOKS(FlecsSSAOImpl, flecsEngine_ssao_releaseResources)
 
+static int32_t flecsEngine_ssao_sampleCount(
+    const FlecsSSAO *ssao)
+{
+    if (ssao->sample_count <= 0) {
+        return FLECS_ENGINE_SSAO_KERNEL_SIZE;
+    }
+    return ssao->sample_count < FLECS_ENGINE_SSAO_KERNEL_SIZE
+        ? ssao->sample_count
+        : FLECS_ENGINE_SSAO_KERNEL_SIZE;
+}
+
+/* Frames it takes the rotating sample set to cover the kernel */
+static int32_t flecsEngine_ssao_kernelStride(
+    const FlecsSSAO *ssao)
+{
+    return FLECS_ENGINE_SSAO_KERNEL_SIZE / flecsEngine_ssao_sampleCount(ssao);
+}
+
+/* Resolution divisor of the AO. Automatic matches the AO of the blur path. */
+static int32_t flecsEngine_ssao_divisor(
+    const FlecsSSAO *ssao)
+{
+    if (ssao->resolution <= 0) {
+        return ssao->blur > 0 ? 2 : 1;
+    }
+    return ssao->resolution < FLECS_ENGINE_SSAO_MAX_RESOLUTION
+        ? ssao->resolution
+        : FLECS_ENGINE_SSAO_MAX_RESOLUTION;
+}
+
+/* Whether AO is computed from downsampled depth into a separate texture.
+ * Without an explicit resolution or temporal accumulation the effect keeps
+ * computing AO from the full resolution depth. */
+static bool flecsEngine_ssao_lowRes(
+    const FlecsSSAO *ssao)
+{
+    if (ssao->temporal) {
+        return true;
+    }
+
+    if (ssao->resolution <= 0) {
+        return false;
+    }
+
+    /* Full resolution AO without blur is composited directly */
+    return ssao->resolution > 1 || ssao->blur > 0;
+}
+
 static void flecsEngine_ssao_fillUniform(
     const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
     ecs_entity_t effect_entity,
     const FlecsSSAO *ssao,
+    const FlecsSSAOImpl *impl,
     FlecsSSAOUniform *uniform)
 {
     glm_mat4_identity(uniform->proj);
     glm_mat4_identity(uniform->inv_proj);
+    glm_mat4_identity(uniform->reproject);
 
     uniform->params[0] = ssao->radius;
     uniform->params[1] = ssao->bias;
     uniform->params[2] = ssao->intensity;
     uniform->params[3] = (float)ssao->blur;
 
-    uniform->viewport[0] = 0.0f;
-    uniform->viewport[1] = 0.0f;
-    uniform->viewport[2] = 0.0f;
-    uniform->viewport[3] = 0.0f;
+    float w = engine->render_width > 0 ? (float)engine->render_width : 1.0f;
+    float h = engine->render_height > 0 ? (float)engine->render_height : 1.0f;
+    uniform->viewport[0] = w;
+    uniform->viewport[1] = h;
+    uniform->viewport[2] = 1.0f / w;
+    uniform->viewport[3] = 1.0f / h;
+    glm_vec4_copy(uniform->viewport, uniform->ao);
+
+    /* Spread the samples of a frame over the kernel. With temporal
+     * accumulation consecutive frames use the next set of samples and a
+     * different noise rotation. */
+    int32_t stride = flecsEngine_ssao_kernelStride(ssao);
+    int32_t offset = ssao->temporal ? (int32_t)(impl->frame_index % (uint32_t)stride) : 0;
+    uniform->sampling[0] = (float)flecsEngine_ssao_sampleCount(ssao);
+    uniform->sampling[1] = (float)stride;
+    uniform->sampling[2] = (float)offset;
+    uniform->sampling[3] = ssao->temporal ? (float)(impl->frame_index % 64u) * 17.0f : 0.0f;
+
+    uniform->history[0] = 1.0f / (float)stride;
 
     ecs_entity_t view_entity = ecs_get_target(world, effect_entity, EcsChildOf, 0);
     if (!view_entity) {
@@ -317,19 +636,28 @@ static void flecsEngine_ssao_fillUniform(
     glm_mat4_copy((vec4*)camera->proj, proj_copy);
     glm_mat4_inv(proj_copy, uniform->inv_proj);
 
-    const FlecsRenderViewImpl *view_impl = ecs_get(
-        world, view_entity, FlecsRenderViewImpl);
-    if (view_impl && view_impl->effect_target_width > 0) {
-        float w = (float)view_impl->effect_target_width;
-        float h = (float)view_impl->effect_target_height;
-        uniform->viewport[0] = w;
-        uniform->viewport[1] = h;
-        uniform->viewport[2] = 1.0f / w;
-        uniform->viewport[3] = 1.0f / h;
+    if (!camera->has_prev_mvp) {
+        return;
+    }
+
+    /* The history is reprojected from view space of this frame */
+    mat4 camera_view, inv_view, prev_mvp;
+    glm_mat4_copy((vec4*)camera->view, camera_view);
+    glm_mat4_copy((vec4*)camera->prev_mvp, prev_mvp);
+    glm_mat4_inv(camera_view, inv_view);
+    glm_mat4_mul(prev_mvp, inv_view, inv_view);
+    glm_mat4_mul(inv_view, uniform->inv_proj, uniform->reproject);
+
+    if (impl->history_valid && impl->low_width > 0) {
+        uniform->history[1] = 1.0f;
+        uniform->history[2] =
+            (float)impl->history_region[0] / (float)impl->low_width;
+        uniform->history[3] =
+            (float)impl->history_region[1] / (float)impl->low_height;
     }
 }
 
-static WGPURenderPipeline flecsEngine_ssao_createBlurPipeline(
+static WGPURenderPipeline flecsEngine_ssao_createPipeline(
     const FlecsEngineImpl *engine,
     WGPUShaderModule shader_module,
     WGPUBindGroupLayout bind_layout,
@@ -375,8 +703,10 @@ static WGPURenderPipeline flecsEngine_ssao_createBlurPipeline(
         .multisample = WGPU_MULTISAMPLE_DEFAULT
     };
 
+    uint64_t trace_start = flecsEngine_trace_begin();
     WGPURenderPipeline pipeline = wgpuDeviceCreateRenderPipeline(
         engine->device, &pipeline_desc);
+    flecsEngine_trace_end(trace_start, "pipeline", "render_pipeline", "ssao");
     wgpuPipelineLayoutRelease(pipeline_layout);
     return pipeline;
 }
@@ -404,7 +734,8 @@ static bool flecsEngine_ssao_setup(
         .size = sizeof(FlecsSSAOUniform)
     };
 
-    ssao_impl.uniform_buffer = wgpuDeviceCreateBuffer(engine->device, &uniform_desc);
+    ssao_impl.uniform_buffer = flecsEngine_gpuMemory_createBuffer(
+        engine->device, FlecsGpuMemoryEffect, &uniform_desc);
     if (!ssao_impl.uniform_buffer) {
         return false;
     }
@@ -489,8 +820,8 @@ static bool flecsEngine_ssao_setup(
         return false;
     }
 
-    WGPUShaderModule blur_shader = flecsEngine_createShaderModule(
-        engine->device, kBlurShaderSource);
+    WGPUShaderModule blur_shader = flecsEngine_shaderCache_get(
+        (FlecsEngineImpl*)engine, kBlurShaderSource);
     if (!blur_shader) {
         flecsEngine_ssao_releaseResources(&ssao_impl);
         return false;
@@ -499,13 +830,11 @@ static bool flecsEngine_ssao_setup(
     WGPUTextureFormat view_target_format = flecsEngine_getViewTargetFormat(engine);
     WGPUTextureFormat hdr_format = flecsEngine_getHdrFormat(engine);
 
-    ssao_impl.blur_pipeline_surface = flecsEngine_ssao_createBlurPipeline(
+    ssao_impl.blur_pipeline_surface = flecsEngine_ssao_createPipeline(
         engine, blur_shader, ssao_impl.blur_bind_layout, view_target_format);
-    ssao_impl.blur_pipeline_hdr = flecsEngine_ssao_createBlurPipeline(
+    ssao_impl.blur_pipeline_hdr = flecsEngine_ssao_createPipeline(
         engine, blur_shader, ssao_impl.blur_bind_layout, hdr_format);
 
-    wgpuShaderModuleRelease(blur_shader);
-
     if (!ssao_impl.blur_pipeline_surface || !ssao_impl.blur_pipeline_hdr) {
         flecsEngine_ssao_releaseResources(&ssao_impl);
         return false;
@@ -543,9 +872,10 @@ static bool flecsEngine_ssao_bind(
     }
 
     FlecsSSAOUniform uniform = {0};
-    flecsEngine_ssao_fillUniform(world, effect_entity, ssao, &uniform);
-    wgpuQueueWriteBuffer(
-        engine->queue,
+    flecsEngine_ssao_fillUniform(
+        world, engine, effect_entity, ssao, ssao_impl, &uniform);
+    flecsEngine_queueWriteBuffer(
+        engine,
         ssao_impl->uniform_buffer,
         0,
         &uniform,
@@ -593,7 +923,8 @@ static bool flecsEngine_ssao_ensureBlurTexture(
         .sampleCount = 1
     };
 
-    impl->blur_intermediate_texture = wgpuDeviceCreateTexture(engine->device, &desc);
+    impl->blur_intermediate_texture = flecsEngine_gpuMemory_createTexture(
+        engine->device, FlecsGpuMemoryEffect, &desc);
     if (!impl->blur_intermediate_texture) {
         return false;
     }
@@ -610,6 +941,466 @@ static bool flecsEngine_ssao_ensureBlurTexture(
     return true;
 }
 
+static bool flecsEngine_ssao_ensureLowResPipelines(
+    const FlecsEngineImpl *engine,
+    FlecsSSAOImpl *impl)
+{
+    if (impl->temporal_pipeline) {
+        return true;
+    }
+
+    if (impl->low_res_failed) {
+        return false;
+    }
+
+    WGPUBindGroupLayoutEntry uniform_entry = {
+        .visibility = WGPUShaderStage_Fragment,
+        .buffer = {
+            .type = WGPUBufferBindingType_Uniform,
+            .minBindingSize = sizeof(FlecsSSAOUniform)
+        }
+    };
+
+    WGPUBindGroupLayoutEntry float_entry = {
+        .visibility = WGPUShaderStage_Fragment,
+        .texture = {
+            .sampleType = WGPUTextureSampleType_Float,
+            .viewDimension = WGPUTextureViewDimension_2D
+        }
+    };
+
+    /* R32Float can't be filtered on all devices */
+    WGPUBindGroupLayoutEntry depth_entry = {
+        .visibility = WGPUShaderStage_Fragment,
+        .texture = {
+            .sampleType = WGPUTextureSampleType_UnfilterableFloat,
+            .viewDimension = WGPUTextureViewDimension_2D
+        }
+    };
+
+    /* Depth downsample: depth, uniforms */
+    WGPUBindGroupLayoutEntry depth_layout_entries[2] = {
+        {
+            .binding = 0,
+            .visibility = WGPUShaderStage_Fragment,
+            .texture = {
+                .sampleType = WGPUTextureSampleType_Depth,
+                .viewDimension = WGPUTextureViewDimension_2D
+            }
+        },
+        uniform_entry
+    };
+    depth_layout_entries[1].binding = 1;
+
+    /* AO: downsampled depth, uniforms */
+    WGPUBindGroupLayoutEntry low_res_layout_entries[2] = {
+        depth_entry, uniform_entry
+    };
+    low_res_layout_entries[0].binding = 0;
+    low_res_layout_entries[1].binding = 1;
+
+    /* Accumulation: ao, history, downsampled depth, sampler, uniforms */
+    WGPUBindGroupLayoutEntry temporal_layout_entries[5] = {
+        float_entry, float_entry, depth_entry,
+        {
+            .visibility = WGPUShaderStage_Fragment,
+            .sampler = {
+                .type = WGPUSamplerBindingType_Filtering
+            }
+        },
+        uniform_entry
+    };
+    for (uint32_t i = 0; i < 5; i ++) {
+        temporal_layout_entries[i].binding = i;
+    }
+
+    impl->depth_bind_layout = wgpuDeviceCreateBindGroupLayout(
+        engine->device, &(WGPUBindGroupLayoutDescriptor){
+            .entryCount = 2,
+            .entries = depth_layout_entries
+        });
+    impl->low_res_bind_layout = wgpuDeviceCreateBindGroupLayout(
+        engine->device, &(WGPUBindGroupLayoutDescriptor){
+            .entryCount = 2,
+            .entries = low_res_layout_entries
+        });
+    impl->temporal_bind_layout = wgpuDeviceCreateBindGroupLayout(
+        engine->device, &(WGPUBindGroupLayoutDescriptor){
+            .entryCount = 5,
+            .entries = temporal_layout_entries
+        });
+
+    impl->history_sampler = wgpuDeviceCreateSampler(engine->device,
+        &(WGPUSamplerDescriptor){
+            .addressModeU = WGPUAddressMode_ClampToEdge,
+            .addressModeV = WGPUAddressMode_ClampToEdge,
+            .addressModeW = WGPUAddressMode_ClampToEdge,
+            .magFilter = WGPUFilterMode_Linear,
+            .minFilter = WGPUFilterMode_Linear,
+            .mipmapFilter = WGPUMipmapFilterMode_Nearest,
+            .lodMinClamp = 0.0f,
+            .lodMaxClamp = 1.0f,
+            .maxAnisotropy = 1
+        });
+
+    WGPUShaderModule depth_shader = flecsEngine_shaderCache_get(
+        (FlecsEngineImpl*)engine, kDepthShaderSource);
+    WGPUShaderModule low_res_shader = flecsEngine_shaderCache_get(
+        (FlecsEngineImpl*)engine, kLowResShaderSource);
+    WGPUShaderModule temporal_shader = flecsEngine_shaderCache_get(
+        (FlecsEngineImpl*)engine, kTemporalShaderSource);
+
+    if (impl->depth_bind_layout && impl->low_res_bind_layout &&
+        impl->temporal_bind_layout && impl->history_sampler &&
+        depth_shader && low_res_shader && temporal_shader)
+    {
+        impl->depth_pipeline = flecsEngine_ssao_createPipeline(engine,
+            depth_shader, impl->depth_bind_layout,
+            FLECS_ENGINE_SSAO_DEPTH_FORMAT);
+        impl->low_res_pipeline = flecsEngine_ssao_createPipeline(engine,
+            low_res_shader, impl->low_res_bind_layout,
+            FLECS_ENGINE_SSAO_AO_FORMAT);
+        impl->temporal_pipeline = flecsEngine_ssao_createPipeline(engine,
+            temporal_shader, impl->temporal_bind_layout,
+            FLECS_ENGINE_SSAO_HISTORY_FORMAT);
+    }
+
+    if (!impl->depth_pipeline || !impl->low_res_pipeline ||
+        !impl->temporal_pipeline)
+    {
+        ecs_warn("ssao: reduced resolution AO unavailable, using full "
+            "resolution");
+        flecsEngine_ssao_releaseLowRes(impl);
+        impl->low_res_failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+static bool flecsEngine_ssao_createTarget(
+    const FlecsEngineImpl *engine,
+    WGPUTextureFormat format,
+    uint32_t width,
+    uint32_t height,
+    WGPUTexture *texture_out,
+    WGPUTextureView *view_out)
+{
+    WGPUTextureDescriptor desc = {
+        .usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding,
+        .dimension = WGPUTextureDimension_2D,
+        .size = (WGPUExtent3D){ .width = width, .height = height, .depthOrArrayLayers = 1 },
+        .format = format,
+        .mipLevelCount = 1,
+        .sampleCount = 1
+    };
+
+    *texture_out = flecsEngine_gpuMemory_createTexture(
+        engine->device, FlecsGpuMemoryEffect, &desc);
+    if (!*texture_out) {
+        return false;
+    }
+
+    *view_out = wgpuTextureCreateView(*texture_out, NULL);
+    return *view_out != NULL;
+}
+
+static bool flecsEngine_ssao_ensureLowResTextures(
+    const FlecsEngineImpl *engine,
+    FlecsSSAOImpl *impl,
+    uint32_t width,
+    uint32_t height)
+{
+    if (impl->low_depth_texture &&
+        impl->low_width == width &&
+        impl->low_height == height)
+    {
+        return true;
+    }
+
+    flecsEngine_ssao_releaseLowResTextures(impl);
+
+    bool ok = flecsEngine_ssao_createTarget(engine,
+        FLECS_ENGINE_SSAO_DEPTH_FORMAT, width, height,
+        &impl->low_depth_texture, &impl->low_depth_view);
+    ok = ok && flecsEngine_ssao_createTarget(engine,
+        FLECS_ENGINE_SSAO_AO_FORMAT, width, height,
+        &impl->ao_texture, &impl->ao_view);
+    for (int32_t i = 0; i < 2; i ++) {
+        ok = ok && flecsEngine_ssao_createTarget(engine,
+            FLECS_ENGINE_SSAO_HISTORY_FORMAT, width, height,
+            &impl->history_textures[i], &impl->history_views[i]);
+    }
+
+    if (ok) {
+        WGPUBindGroupEntry low_res_entries[2] = {
+            { .binding = 0, .textureView = impl->low_depth_view },
+            {
+                .binding = 1,
+                .buffer = impl->uniform_buffer,
+                .offset = 0,
+                .size = sizeof(FlecsSSAOUniform)
+            }
+        };
+
+        impl->low_res_bind_group = flecsEngine_createBindGroup(engine,
+            &(WGPUBindGroupDescriptor){
+                .layout = impl->low_res_bind_layout,
+                .entryCount = 2,
+                .entries = low_res_entries
+            });
+        ok = impl->low_res_bind_group != NULL;
+    }
+
+    for (int32_t i = 0; ok && i < 2; i ++) {
+        WGPUBindGroupEntry temporal_entries[5] = {
+            { .binding = 0, .textureView = impl->ao_view },
+            { .binding = 1, .textureView = impl->history_views[i] },
+            { .binding = 2, .textureView = impl->low_depth_view },
+            { .binding = 3, .sampler = impl->history_sampler },
+            {
+                .binding = 4,
+                .buffer = impl->uniform_buffer,
+                .offset = 0,
+                .size = sizeof(FlecsSSAOUniform)
+            }
+        };
+
+        impl->temporal_bind_groups[i] = flecsEngine_createBindGroup(engine,
+            &(WGPUBindGroupDescriptor){
+                .layout = impl->temporal_bind_layout,
+                .entryCount = 5,
+                .entries = temporal_entries
+            });
+        ok = impl->temporal_bind_groups[i] != NULL;
+    }
+
+    if (!ok) {
+        flecsEngine_ssao_releaseLowResTextures(impl);
+        return false;
+    }
+
+    impl->low_width = width;
+    impl->low_height = height;
+    return true;
+}
+
+/* Renders a fullscreen pass of an SSAO pipeline into a reduced resolution
+ * target, limited to the region that maps to the render viewport. */
+static bool flecsEngine_ssao_lowResPass(
+    WGPUCommandEncoder encoder,
+    WGPURenderPipeline pipeline,
+    WGPUBindGroup bind_group,
+    WGPUTextureView target_view,
+    const uint32_t region[2])
+{
+    WGPURenderPassColorAttachment color_att = {
+        .view = target_view,
+        WGPU_DEPTH_SLICE
+        .loadOp = WGPULoadOp_Clear,
+        .storeOp = WGPUStoreOp_Store,
+        .clearValue = (WGPUColor){ .r = 1, .g = 1, .b = 1, .a = 1 }
+    };
+
+    WGPURenderPassDescriptor pass_desc = {
+        .colorAttachmentCount = 1,
+        .colorAttachments = &color_att
+    };
+
+    WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(
+        encoder, &pass_desc);
+    if (!pass) {
+        return false;
+    }
+
+    wgpuRenderPassEncoderSetViewport(pass, 0.0f, 0.0f,
+        (float)region[0], (float)region[1], 0.0f, 1.0f);
+    wgpuRenderPassEncoderSetPipeline(pass, pipeline);
+    wgpuRenderPassEncoderSetBindGroup(pass, 0, bind_group, 0, NULL);
+    wgpuRenderPassEncoderDraw(pass, 3, 1, 0, 0);
+    wgpuRenderPassEncoderEnd(pass);
+    wgpuRenderPassEncoderRelease(pass);
+    return true;
+}
+
+/* Blurs (or upsamples) the AO term and composites it with the scene */
+static bool flecsEngine_ssao_composite(
+    const FlecsEngineImpl *engine,
+    WGPUCommandEncoder encoder,
+    FlecsSSAOImpl *impl,
+    const FlecsRenderEffectImpl *effect_impl,
+    WGPUTextureView ao_view,
+    WGPUTextureView input_view,
+    WGPUTextureView output_view,
+    WGPUTextureFormat output_format,
+    WGPULoadOp output_load_op)
+{
+    WGPUBindGroupEntry blur_entries[5] = {
+        { .binding = 0, .textureView = ao_view },
+        { .binding = 1, .sampler = effect_impl->input_sampler },
+        { .binding = 2, .textureView = engine->depth.depth_texture_view },
+        {
+            .binding = 3,
+            .buffer = impl->uniform_buffer,
+            .offset = 0,
+            .size = sizeof(FlecsSSAOUniform)
+        },
+        { .binding = 4, .textureView = input_view }
+    };
+
+    WGPUBindGroup blur_bind_group = flecsEngine_bindGroupCache_get(
+        engine, &impl->blur_bind_groups, impl->blur_bind_layout,
+        blur_entries, 5);
+    if (!blur_bind_group) {
+        return false;
+    }
+
+    WGPURenderPassColorAttachment color_att = {
+        .view = output_view,
+        WGPU_DEPTH_SLICE
+        .loadOp = output_load_op,
+        .storeOp = WGPUStoreOp_Store,
+        .clearValue = (WGPUColor){0}
+    };
+
+    WGPURenderPassDescriptor pass_desc = {
+        .colorAttachmentCount = 1,
+        .colorAttachments = &color_att
+    };
+
+    WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(
+        encoder, &pass_desc);
+    if (!pass) {
+        return false;
+    }
+
+    WGPURenderPipeline blur_pipeline =
+        output_format == flecsEngine_getViewTargetFormat(engine)
+            ? impl->blur_pipeline_surface
+            : impl->blur_pipeline_hdr;
+
+    flecsEngine_setRenderViewport(engine, pass);
+    wgpuRenderPassEncoderSetPipeline(pass, blur_pipeline);
+    wgpuRenderPassEncoderSetBindGroup(pass, 0, blur_bind_group, 0, NULL);
+    wgpuRenderPassEncoderDraw(pass, 3, 1, 0, 0);
+    wgpuRenderPassEncoderEnd(pass);
+    wgpuRenderPassEncoderRelease(pass);
+    return true;
+}
+
+/* Computes AO from downsampled depth at a fraction of the display
+ * resolution, optionally accumulated over frames with a reprojected
+ * history, then upsamples it while compositing. */
+static bool flecsEngine_ssao_renderLowRes(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    WGPUCommandEncoder encoder,
+    ecs_entity_t effect_entity,
+    const FlecsSSAO *ssao,
+    FlecsSSAOImpl *impl,
+    const FlecsRenderEffectImpl *effect_impl,
+    uint32_t target_width,
+    uint32_t target_height,
+    WGPUTextureView input_view,
+    WGPUTextureView output_view,
+    WGPUTextureFormat output_format,
+    WGPULoadOp output_load_op)
+{
+    /* Like the blur intermediate, base the AO resolution on the display
+     * size and cap it at the depth buffer resolution. */
+    uint32_t divisor = (uint32_t)flecsEngine_ssao_divisor(ssao);
+    uint32_t width = engine->width > 0 ? (uint32_t)engine->width / divisor : 1;
+    uint32_t height = engine->height > 0 ? (uint32_t)engine->height / divisor : 1;
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+    if (width > target_width) width = target_width;
+    if (height > target_height) height = target_height;
+
+    if (!flecsEngine_ssao_ensureLowResTextures(engine, impl, width, height)) {
+        return false;
+    }
+
+    /* Region of the AO textures that maps to the render viewport. Matches
+     * the AO size derived by the composite shader. */
+    uint32_t region[2] = {
+        (uint32_t)((float)width * (float)engine->render_width /
+            (float)target_width),
+        (uint32_t)((float)height * (float)engine->render_height /
+            (float)target_height)
+    };
+    if (region[0] < 1) region[0] = 1;
+    if (region[1] < 1) region[1] = 1;
+    if (region[0] > width) region[0] = width;
+    if (region[1] > height) region[1] = height;
+
+    if (!ssao->temporal) {
+        impl->history_valid = false;
+    }
+
+    FlecsSSAOUniform uniform = {0};
+    flecsEngine_ssao_fillUniform(
+        world, engine, effect_entity, ssao, impl, &uniform);
+    uniform.ao[0] = (float)region[0];
+    uniform.ao[1] = (float)region[1];
+    uniform.ao[2] = 1.0f / (float)region[0];
+    uniform.ao[3] = 1.0f / (float)region[1];
+    flecsEngine_queueWriteBuffer(
+        engine, impl->uniform_buffer, 0, &uniform, sizeof(uniform));
+
+    WGPUBindGroupEntry depth_entries[2] = {
+        { .binding = 0, .textureView = engine->depth.depth_texture_view },
+        {
+            .binding = 1,
+            .buffer = impl->uniform_buffer,
+            .offset = 0,
+            .size = sizeof(FlecsSSAOUniform)
+        }
+    };
+
+    WGPUBindGroup depth_bind_group = flecsEngine_bindGroupCache_get(
+        engine, &impl->depth_bind_groups, impl->depth_bind_layout,
+        depth_entries, 2);
+    if (!depth_bind_group) {
+        return false;
+    }
+
+    if (!flecsEngine_ssao_lowResPass(encoder, impl->depth_pipeline,
+        depth_bind_group, impl->low_depth_view, region))
+    {
+        return false;
+    }
+
+    if (!flecsEngine_ssao_lowResPass(encoder, impl->low_res_pipeline,
+        impl->low_res_bind_group, impl->ao_view, region))
+    {
+        return false;
+    }
+
+    WGPUTextureView ao_view = impl->ao_view;
+    if (ssao->temporal) {
+        int32_t prev = impl->history_index;
+        int32_t next = 1 - prev;
+        if (!flecsEngine_ssao_lowResPass(encoder, impl->temporal_pipeline,
+            impl->temporal_bind_groups[prev], impl->history_views[next],
+            region))
+        {
+            return false;
+        }
+
+        impl->history_index = next;
+        impl->history_region[0] = region[0];
+        impl->history_region[1] = region[1];
+        impl->history_valid = true;
+        impl->frame_index ++;
+
+        /* The composite reads the AO from the red channel */
+        ao_view = impl->history_views[next];
+    }
+
+    return flecsEngine_ssao_composite(engine, encoder, impl, effect_impl,
+        ao_view, input_view, output_view, output_format, output_load_op);
+}
+
 static bool flecsEngine_ssao_render(
     const ecs_world_t *world,
     const FlecsEngineImpl *engine,
@@ -630,6 +1421,31 @@ static bool flecsEngine_ssao_render(
     ecs_assert(ssao != NULL, ECS_INVALID_OPERATION, NULL);
     ecs_assert(impl != NULL, ECS_INVALID_OPERATION, NULL);
 
+    /* Determine intermediate texture size */
+    uint32_t width = engine->actual_width > 0 ? (uint32_t)engine->actual_width : 1;
+    uint32_t height = engine->actual_height > 0 ? (uint32_t)engine->actual_height : 1;
+
+    ecs_entity_t view_entity = ecs_get_target(
+        world, effect_entity, EcsChildOf, 0);
+    if (view_entity) {
+        const FlecsRenderViewImpl *view_impl = ecs_get(
+            world, view_entity, FlecsRenderViewImpl);
+        if (view_impl && view_impl->effect_target_width > 0) {
+            width = view_impl->effect_target_width;
+            height = view_impl->effect_target_height;
+        }
+    }
+
+    if (flecsEngine_ssao_lowRes(ssao) &&
+        flecsEngine_ssao_ensureLowResPipelines(engine, impl))
+    {
+        return flecsEngine_ssao_renderLowRes(world, engine, encoder,
+            effect_entity, ssao, impl, effect_impl, width, height,
+            input_view, output_view, output_format, output_load_op);
+    }
+
+    impl->history_valid = false;
+
     if (ssao->blur <= 0) {
         /* No blur: render SSAO composited directly to output */
         WGPURenderPassColorAttachment color_att = {
@@ -651,6 +1467,7 @@ static bool flecsEngine_ssao_render(
             return false;
         }
 
+        flecsEngine_setRenderViewport(engine, pass);
         flecsEngine_renderEffect_render(
             world, engine, pass, effect_entity,
             effect, effect_impl, input_view, output_format);
@@ -659,21 +1476,6 @@ static bool flecsEngine_ssao_render(
         return true;
     }
 
-    /* Determine intermediate texture size */
-    uint32_t width = engine->actual_width > 0 ? (uint32_t)engine->actual_width : 1;
-    uint32_t height = engine->actual_height > 0 ? (uint32_t)engine->actual_height : 1;
-
-    ecs_entity_t view_entity = ecs_get_target(
-        world, effect_entity, EcsChildOf, 0);
-    if (view_entity) {
-        const FlecsRenderViewImpl *view_impl = ecs_get(
-            world, view_entity, FlecsRenderViewImpl);
-        if (view_impl && view_impl->effect_target_width > 0) {
-            width = view_impl->effect_target_width;
-            height = view_impl->effect_target_height;
-        }
-    }
-
     /* Base intermediate resolution on display size so that resolution scaling
      * does not degrade AO quality.  Cap at depth-buffer (effect-target)
      * resolution since there is no extra detail to sample beyond that. */
@@ -708,6 +1510,13 @@ static bool flecsEngine_ssao_render(
             return false;
         }
 
+        /* Scale the viewport like the render viewport, so that the AO of
+         * the viewport maps to the same region of the intermediate. */
+        wgpuRenderPassEncoderSetViewport(pass, 0.0f, 0.0f,
+            (float)ssao_width * (float)engine->render_width / (float)width,
+            (float)ssao_height * (float)engine->render_height / (float)height,
+            0.0f, 1.0f);
+
         flecsEngine_renderEffect_render(
             world, engine, pass, effect_entity,
             effect, effect_impl, input_view, hdr_format);
@@ -716,66 +1525,9 @@ static bool flecsEngine_ssao_render(
     }
 
     /* Pass 2: Cross-bilateral blur of AO + composite with scene */
-    {
-        WGPUBindGroupEntry blur_entries[5] = {
-            { .binding = 0, .textureView = impl->blur_intermediate_view },
-            { .binding = 1, .sampler = effect_impl->input_sampler },
-            { .binding = 2, .textureView = engine->depth.depth_texture_view },
-            {
-                .binding = 3,
-                .buffer = impl->uniform_buffer,
-                .offset = 0,
-                .size = sizeof(FlecsSSAOUniform)
-            },
-            { .binding = 4, .textureView = input_view }
-        };
-
-        WGPUBindGroupDescriptor bind_desc = {
-            .layout = impl->blur_bind_layout,
-            .entryCount = 5,
-            .entries = blur_entries
-        };
-
-        WGPUBindGroup blur_bind_group = wgpuDeviceCreateBindGroup(
-            engine->device, &bind_desc);
-        if (!blur_bind_group) {
-            return false;
-        }
-
-        WGPURenderPassColorAttachment color_att = {
-            .view = output_view,
-            WGPU_DEPTH_SLICE
-            .loadOp = output_load_op,
-            .storeOp = WGPUStoreOp_Store,
-            .clearValue = (WGPUColor){0}
-        };
-
-        WGPURenderPassDescriptor pass_desc = {
-            .colorAttachmentCount = 1,
-            .colorAttachments = &color_att
-        };
-
-        WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(
-            encoder, &pass_desc);
-        if (!pass) {
-            wgpuBindGroupRelease(blur_bind_group);
-            return false;
-        }
-
-        WGPURenderPipeline blur_pipeline =
-            output_format == flecsEngine_getViewTargetFormat(engine)
-                ? impl->blur_pipeline_surface
-                : impl->blur_pipeline_hdr;
-
-        wgpuRenderPassEncoderSetPipeline(pass, blur_pipeline);
-        wgpuRenderPassEncoderSetBindGroup(pass, 0, blur_bind_group, 0, NULL);
-        wgpuRenderPassEncoderDraw(pass, 3, 1, 0, 0);
-        wgpuRenderPassEncoderEnd(pass);
-        wgpuRenderPassEncoderRelease(pass);
-        wgpuBindGroupRelease(blur_bind_group);
-    }
-
-    return true;
+    return flecsEngine_ssao_composite(engine, encoder, impl, effect_impl,
+        impl->blur_intermediate_view, input_view, output_view, output_format,
+        output_load_op);
 }
 
 FlecsSSAO flecsEngine_ssaoSettingsDefault(void)
@@ -784,7 +1536,10 @@ FlecsSSAO flecsEngine_ssaoSettingsDefault(void)
         .radius = 0.5f,
         .bias = 0.025f,
         .intensity = 1.0f,
-        .blur = 4
+        .blur = 4,
+        .resolution = 0,
+        .sample_count = FLECS_ENGINE_SSAO_KERNEL_SIZE,
+        .temporal = false
     };
 }
 
@@ -831,7 +1586,10 @@ void flecsEngine_ssao_register(
             { .name = "radius", .type = ecs_id(ecs_f32_t) },
             { .name = "bias", .type = ecs_id(ecs_f32_t) },
             { .name = "intensity", .type = ecs_id(ecs_f32_t) },
-            { .name = "blur", .type = ecs_id(ecs_i32_t) }
+            { .name = "blur", .type = ecs_id(ecs_i32_t) },
+            { .name = "resolution", .type = ecs_id(ecs_i32_t) },
+            { .name = "sample_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "temporal", .type = ecs_id(ecs_bool_t) }
         }
     });
 }
@@ -0,0 +1,714 @@
+#include "../../renderer.h"
+#include "flecs_engine.h"
+
+ECS_COMPONENT_DECLARE(FlecsTAA);
+ECS_COMPONENT_DECLARE(FlecsTAAImpl);
+
+typedef struct FlecsTAAUniform {
+    mat4 reproject;     /* Current NDC to previous clip space */
+    float input[4];     /* render width, height, jitter x, y in pixels */
+    float output[4];    /* region width, height, history width, height */
+    float history[4];   /* previous region width, height, feedback, valid */
+    float params[4];    /* clip gamma, upscaling, 0, 0 */
+} FlecsTAAUniform;
+
+static const char *kShaderSource =
+    FLECS_ENGINE_FULLSCREEN_VS_WGSL
+    "struct TaaUniforms {\n"
+    "  reproject : mat4x4<f32>,\n"
+    "  input_info : vec4<f32>,\n"
+    "  output_info : vec4<f32>,\n"
+    "  history_info : vec4<f32>,\n"
+    "  params : vec4<f32>,\n"
+    "};\n"
+    "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n"
+    "@group(0) @binding(1) var input_sampler : sampler;\n"
+    "@group(0) @binding(2) var depth_texture : texture_depth_2d;\n"
+    "@group(0) @binding(3) var<uniform> uniforms : TaaUniforms;\n"
+    "@group(0) @binding(4) var history_texture : texture_2d<f32>;\n"
+
+    "struct TaaOutput {\n"
+    "  @location(0) color : vec4<f32>,\n"
+    "  @location(1) history : vec4<f32>,\n"
+    "};\n"
+
+    "fn luma(c : vec3<f32>) -> f32 {\n"
+    "  return dot(c, vec3<f32>(0.2126, 0.7152, 0.0722));\n"
+    "}\n"
+
+    /* The input and depth are only valid within the render viewport */
+    "fn clamp_texel(texel : vec2<i32>) -> vec2<i32> {\n"
+    "  let max_texel = vec2<i32>(uniforms.input_info.xy) - vec2<i32>(1);\n"
+    "  return clamp(texel, vec2<i32>(0), max_texel);\n"
+    "}\n"
+
+    /* Catmull-Rom filter from 5 bilinear taps, which keeps the history sharp
+     * when it is resampled every frame. pos is in pixels of the region. */
+    "fn sample_history(pos : vec2<f32>) -> vec3<f32> {\n"
+    "  let size = uniforms.output_info.zw;\n"
+    "  let region = uniforms.history_info.xy;\n"
+    "  let p = clamp(pos, vec2<f32>(0.5), region - vec2<f32>(0.5));\n"
+    "  let c = floor(p - 0.5) + 0.5;\n"
+    "  let f = p - c;\n"
+    "  let w0 = f * (-0.5 + f * (1.0 - 0.5 * f));\n"
+    "  let w1 = 1.0 + f * f * (-2.5 + 1.5 * f);\n"
+    "  let w2 = f * (0.5 + f * (2.0 - 1.5 * f));\n"
+    "  let w3 = f * f * (-0.5 + 0.5 * f);\n"
+    "  let w12 = w1 + w2;\n"
+    "  let tc0 = (c - 1.0) / size;\n"
+    "  let tc12 = (c + w2 / w12) / size;\n"
+    "  let tc3 = (c + 2.0) / size;\n"
+    "  let wa = w12.x * w0.y;\n"
+    "  let wb = w0.x * w12.y;\n"
+    "  let wc = w12.x * w12.y;\n"
+    "  let wd = w3.x * w12.y;\n"
+    "  let we = w12.x * w3.y;\n"
+    "  var result = textureSampleLevel(history_texture, input_sampler,\n"
+    "    vec2<f32>(tc12.x, tc0.y), 0.0).rgb * wa;\n"
+    "  result += textureSampleLevel(history_texture, input_sampler,\n"
+    "    vec2<f32>(tc0.x, tc12.y), 0.0).rgb * wb;\n"
+    "  result += textureSampleLevel(history_texture, input_sampler,\n"
+    "    tc12, 0.0).rgb * wc;\n"
+    "  result += textureSampleLevel(history_texture, input_sampler,\n"
+    "    vec2<f32>(tc3.x, tc12.y), 0.0).rgb * wd;\n"
+    "  result += textureSampleLevel(history_texture, input_sampler,\n"
+    "    vec2<f32>(tc12.x, tc3.y), 0.0).rgb * we;\n"
+    "  return max(result / (wa + wb + wc + wd + we), vec3<f32>(0.0));\n"
+    "}\n"
+
+    "fn resolve(frag_pos : vec4<f32>) -> vec4<f32> {\n"
+    "  let uv = frag_pos.xy / uniforms.output_info.xy;\n"
+    /* Where the jittered frame rendered the unjittered position */
+    "  let pos = uv * uniforms.input_info.xy + uniforms.input_info.zw;\n"
+    "  let texel = vec2<i32>(floor(pos));\n"
+    "  let current = textureLoad(input_texture, clamp_texel(texel), 0);\n"
+
+    /* Color statistics and closest depth of the 3x3 neighborhood */
+    "  var m1 = vec3<f32>(0.0);\n"
+    "  var m2 = vec3<f32>(0.0);\n"
+    "  var depth = 1.0;\n"
+    "  for (var y = -1; y <= 1; y++) {\n"
+    "    for (var x = -1; x <= 1; x++) {\n"
+    "      let t = clamp_texel(texel + vec2<i32>(x, y));\n"
+    "      let c = textureLoad(input_texture, t, 0).rgb;\n"
+    "      m1 += c;\n"
+    "      m2 += c * c;\n"
+    "      depth = min(depth, textureLoad(depth_texture, t, 0));\n"
+    "    }\n"
+    "  }\n"
+
+    "  if (uniforms.history_info.w <= 0.0) {\n"
+    "    return current;\n"
+    "  }\n"
+
+    /* Reproject with the camera motion. Moving objects have no motion
+     * vectors, the neighborhood clamp limits their ghosting. */
+    "  let ndc = vec4<f32>(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, depth, 1.0);\n"
+    "  let prev_clip = uniforms.reproject * ndc;\n"
+    "  if (prev_clip.w <= 0.0) {\n"
+    "    return current;\n"
+    "  }\n"
+    "  let prev_ndc = prev_clip.xy / prev_clip.w;\n"
+    "  let prev_uv = vec2<f32>(prev_ndc.x * 0.5 + 0.5, 0.5 - prev_ndc.y * 0.5);\n"
+    "  if (any(prev_uv < vec2<f32>(0.0)) || any(prev_uv > vec2<f32>(1.0))) {\n"
+    "    return current;\n"
+    "  }\n"
+
+    /* Clamp the history to the variance box of the neighborhood, which
+     * rejects history that doesn't match what is on screen now. */
+    "  let mean = m1 / 9.0;\n"
+    "  let sigma = sqrt(max(m2 / 9.0 - mean * mean, vec3<f32>(0.0)));\n"
+    "  let box_min = mean - sigma * uniforms.params.x;\n"
+    "  let box_max = mean + sigma * uniforms.params.x;\n"
+    "  let history = clamp(\n"
+    "    sample_history(prev_uv * uniforms.history_info.xy), box_min, box_max);\n"
+
+    "  var alpha = 1.0 - uniforms.history_info.z;\n"
+    /* When upscaling, input texels contribute less the further their
+     * center is from the output pixel. */
+    "  if (uniforms.params.y > 0.0) {\n"
+    "    let d = pos - (vec2<f32>(texel) + 0.5);\n"
+    "    alpha *= exp(-2.29 * dot(d, d));\n"
+    "  }\n"
+
+    /* Weighing by inverse luma keeps bright sub-pixel details from
+     * flickering */
+    "  let w_current = alpha / (1.0 + luma(current.rgb));\n"
+    "  let w_history = (1.0 - alpha) / (1.0 + luma(history));\n"
+    "  let color = (current.rgb * w_current + history * w_history) /\n"
+    "    max(w_current + w_history, 1e-5);\n"
+    "  return vec4<f32>(color, current.a);\n"
+    "}\n"
+
+    /* Single target entry point for the generic effect pipelines */
+    "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
+    "  return resolve(in.pos);\n"
+    "}\n"
+
+    "@fragment fn fs_history(in : VertexOutput) -> TaaOutput {\n"
+    "  let color = resolve(in.pos);\n"
+    "  return TaaOutput(color, color);\n"
+    "}\n";
+
+static ecs_entity_t flecsEngine_taa_shader(
+    ecs_world_t *world)
+{
+    return flecsEngine_shader_ensure(world, "TAAPostShader",
+        &(FlecsShader){
+            .source = kShaderSource,
+            .vertex_entry = "vs_main",
+            .fragment_entry = "fs_main"
+        });
+}
+
+static void flecsEngine_taa_releaseHistory(
+    FlecsTAAImpl *impl)
+{
+    for (int32_t i = 0; i < 2; i ++) {
+        if (impl->history_views[i]) {
+            wgpuTextureViewRelease(impl->history_views[i]);
+            impl->history_views[i] = NULL;
+        }
+
+        if (impl->history_textures[i]) {
+            flecsEngine_gpuMemory_releaseTexture(
+                FlecsGpuMemoryEffect, impl->history_textures[i]);
+            impl->history_textures[i] = NULL;
+        }
+    }
+
+    impl->history_width = 0;
+    impl->history_height = 0;
+    impl->history_valid = false;
+}
+
+static void flecsEngine_taa_releaseResources(
+    FlecsTAAImpl *impl)
+{
+    if (impl->uniform_buffer) {
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryEffect, impl->uniform_buffer);
+        impl->uniform_buffer = NULL;
+    }
+
+    if (impl->pipeline_surface) {
+        wgpuRenderPipelineRelease(impl->pipeline_surface);
+        impl->pipeline_surface = NULL;
+    }
+
+    if (impl->pipeline_hdr) {
+        wgpuRenderPipelineRelease(impl->pipeline_hdr);
+        impl->pipeline_hdr = NULL;
+    }
+
+    flecsEngine_taa_releaseHistory(impl);
+}
+
+FLECS_ENGINE_IMPL_HOOKS(FlecsTAAImpl, flecsEngine_taa_releaseResources)
+
+/* Pipeline that writes the resolved color to the output and to the history,
+ * which is always in the HDR format. */
+static WGPURenderPipeline flecsEngine_taa_createPipeline(
+    FlecsEngineImpl *engine,
+    WGPUBindGroupLayout bind_layout,
+    WGPUTextureFormat color_format)
+{
+    WGPUShaderModule shader_module = flecsEngine_shaderCache_get(
+        engine, kShaderSource);
+    if (!shader_module) {
+        return NULL;
+    }
+
+    WGPUPipelineLayoutDescriptor pipeline_layout_desc = {
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &bind_layout
+    };
+
+    WGPUPipelineLayout pipeline_layout = wgpuDeviceCreatePipelineLayout(
+        engine->device, &pipeline_layout_desc);
+    if (!pipeline_layout) {
+        return NULL;
+    }
+
+    WGPUColorTargetState color_targets[2] = {
+        {
+            .format = color_format,
+            .writeMask = WGPUColorWriteMask_All
+        },
+        {
+            .format = flecsEngine_getHdrFormat(engine),
+            .writeMask = WGPUColorWriteMask_All
+        }
+    };
+
+    WGPUVertexState vertex_state = {
+        .module = shader_module,
+        .entryPoint = WGPU_STR("vs_main")
+    };
+
+    WGPUFragmentState fragment_state = {
+        .module = shader_module,
+        .entryPoint = WGPU_STR("fs_history"),
+        .targetCount = 2,
+        .targets = color_targets
+    };
+
+    WGPURenderPipelineDescriptor pipeline_desc = {
+        .layout = pipeline_layout,
+        .vertex = vertex_state,
+        .fragment = &fragment_state,
+        .primitive = {
+            .topology = WGPUPrimitiveTopology_TriangleList,
+            .cullMode = WGPUCullMode_None,
+            .frontFace = WGPUFrontFace_CCW
+        },
+        .multisample = WGPU_MULTISAMPLE_DEFAULT
+    };
+
+    uint64_t trace_start = flecsEngine_trace_begin();
+    WGPURenderPipeline pipeline = wgpuDeviceCreateRenderPipeline(
+        engine->device, &pipeline_desc);
+    flecsEngine_trace_end(trace_start, "pipeline", "render_pipeline", "taa");
+    wgpuPipelineLayoutRelease(pipeline_layout);
+    return pipeline;
+}
+
+/* The pipelines use the layout of the effect, which only exists once setup
+ * has returned, so they are created on first use. */
+static bool flecsEngine_taa_ensurePipelines(
+    const FlecsEngineImpl *engine,
+    FlecsTAAImpl *impl,
+    const FlecsRenderEffectImpl *effect_impl)
+{
+    if (impl->pipeline_surface && impl->pipeline_hdr) {
+        return true;
+    }
+
+    FlecsEngineImpl *mut_engine = (FlecsEngineImpl*)engine;
+
+    if (!impl->pipeline_surface) {
+        impl->pipeline_surface = flecsEngine_taa_createPipeline(mut_engine,
+            effect_impl->bind_layout, flecsEngine_getViewTargetFormat(engine));
+    }
+
+    if (!impl->pipeline_hdr) {
+        impl->pipeline_hdr = flecsEngine_taa_createPipeline(mut_engine,
+            effect_impl->bind_layout, flecsEngine_getHdrFormat(engine));
+    }
+
+    return impl->pipeline_surface && impl->pipeline_hdr;
+}
+
+static bool flecsEngine_taa_ensureHistory(
+    const FlecsEngineImpl *engine,
+    FlecsTAAImpl *impl,
+    FlecsRenderEffectImpl *effect_impl,
+    uint32_t width,
+    uint32_t height)
+{
+    if (impl->history_textures[0] &&
+        impl->history_width == width &&
+        impl->history_height == height)
+    {
+        return true;
+    }
+
+    /* Cached bind groups sample the history */
+    flecsEngine_bindGroupCache_fini(&effect_impl->bind_groups);
+    flecsEngine_taa_releaseHistory(impl);
+
+    WGPUTextureDescriptor desc = {
+        .usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding,
+        .dimension = WGPUTextureDimension_2D,
+        .size = (WGPUExtent3D){ .width = width, .height = height, .depthOrArrayLayers = 1 },
+        .format = flecsEngine_getHdrFormat(engine),
+        .mipLevelCount = 1,
+        .sampleCount = 1
+    };
+
+    for (int32_t i = 0; i < 2; i ++) {
+        impl->history_textures[i] = flecsEngine_gpuMemory_createTexture(
+            engine->device, FlecsGpuMemoryEffect, &desc);
+        if (!impl->history_textures[i]) {
+            flecsEngine_taa_releaseHistory(impl);
+            return false;
+        }
+
+        impl->history_views[i] = wgpuTextureCreateView(
+            impl->history_textures[i], NULL);
+        if (!impl->history_views[i]) {
+            flecsEngine_taa_releaseHistory(impl);
+            return false;
+        }
+    }
+
+    impl->history_width = width;
+    impl->history_height = height;
+    return true;
+}
+
+static bool flecsEngine_taa_setup(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    ecs_entity_t effect_entity,
+    const FlecsRenderEffect *effect,
+    FlecsRenderEffectImpl *effect_impl,
+    WGPUBindGroupLayoutEntry *layout_entries,
+    uint32_t *entry_count)
+{
+    (void)effect;
+    (void)effect_impl;
+
+    ecs_assert(layout_entries != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(entry_count != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(*entry_count == 2, ECS_INVALID_PARAMETER, NULL);
+
+    FlecsTAAImpl taa_impl = {0};
+
+    WGPUBufferDescriptor uniform_desc = {
+        .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+        .size = sizeof(FlecsTAAUniform)
+    };
+
+    taa_impl.uniform_buffer = flecsEngine_gpuMemory_createBuffer(
+        engine->device, FlecsGpuMemoryEffect, &uniform_desc);
+    if (!taa_impl.uniform_buffer) {
+        return false;
+    }
+
+    layout_entries[2] = (WGPUBindGroupLayoutEntry){
+        .binding = 2,
+        .visibility = WGPUShaderStage_Fragment,
+        .texture = {
+            .sampleType = WGPUTextureSampleType_Depth,
+            .viewDimension = WGPUTextureViewDimension_2D,
+            .multisampled = false
+        }
+    };
+
+    layout_entries[3] = (WGPUBindGroupLayoutEntry){
+        .binding = 3,
+        .visibility = WGPUShaderStage_Fragment,
+        .buffer = {
+            .type = WGPUBufferBindingType_Uniform,
+            .minBindingSize = sizeof(FlecsTAAUniform)
+        }
+    };
+
+    layout_entries[4] = (WGPUBindGroupLayoutEntry){
+        .binding = 4,
+        .visibility = WGPUShaderStage_Fragment,
+        .texture = {
+            .sampleType = WGPUTextureSampleType_Float,
+            .viewDimension = WGPUTextureViewDimension_2D,
+            .multisampled = false
+        }
+    };
+
+    *entry_count = 5;
+
+    ecs_set_ptr((ecs_world_t*)world, effect_entity, FlecsTAAImpl, &taa_impl);
+    return true;
+}
+
+static bool flecsEngine_taa_bind(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    ecs_entity_t effect_entity,
+    const FlecsRenderEffect *effect,
+    const FlecsRenderEffectImpl *impl,
+    WGPUBindGroupEntry *entries,
+    uint32_t *entry_count)
+{
+    (void)effect;
+    (void)impl;
+
+    ecs_assert(entries != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(entry_count != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(*entry_count == 2, ECS_INVALID_PARAMETER, NULL);
+
+    if (!engine->depth.depth_texture_view) {
+        return false;
+    }
+
+    const FlecsTAAImpl *taa_impl = ecs_get(world, effect_entity, FlecsTAAImpl);
+    if (!taa_impl || !taa_impl->uniform_buffer ||
+        !taa_impl->history_views[taa_impl->history_index])
+    {
+        return false;
+    }
+
+    entries[2] = (WGPUBindGroupEntry){
+        .binding = 2,
+        .textureView = engine->depth.depth_texture_view
+    };
+
+    entries[3] = (WGPUBindGroupEntry){
+        .binding = 3,
+        .buffer = taa_impl->uniform_buffer,
+        .offset = 0,
+        .size = sizeof(FlecsTAAUniform)
+    };
+
+    entries[4] = (WGPUBindGroupEntry){
+        .binding = 4,
+        .textureView = taa_impl->history_views[taa_impl->history_index]
+    };
+
+    *entry_count = 5;
+    return true;
+}
+
+static void flecsEngine_taa_fillUniform(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    const FlecsRenderView *view,
+    const FlecsTAA *taa,
+    const FlecsTAAImpl *impl,
+    const uint32_t region[2],
+    bool valid,
+    bool upscaling,
+    FlecsTAAUniform *uniform)
+{
+    float render_width = (float)engine->render_width;
+    float render_height = (float)engine->render_height;
+
+    glm_mat4_identity(uniform->reproject);
+    uniform->input[0] = render_width;
+    uniform->input[1] = render_height;
+
+    const FlecsCameraImpl *camera = NULL;
+    if (view->camera) {
+        camera = ecs_get(world, view->camera, FlecsCameraImpl);
+    }
+
+    if (camera) {
+        mat4 unjittered_mvp, prev_mvp, inv_mvp;
+        glm_mat4_copy((vec4*)camera->unjittered_mvp, unjittered_mvp);
+        glm_mat4_copy((vec4*)camera->prev_mvp, prev_mvp);
+        glm_mat4_inv(unjittered_mvp, inv_mvp);
+        glm_mat4_mul(prev_mvp, inv_mvp, uniform->reproject);
+
+        /* NDC y points up, pixel y points down */
+        uniform->input[2] = camera->jitter[0] * render_width * 0.5f;
+        uniform->input[3] = -camera->jitter[1] * render_height * 0.5f;
+    }
+
+    uniform->output[0] = (float)region[0];
+    uniform->output[1] = (float)region[1];
+    uniform->output[2] = (float)impl->history_width;
+    uniform->output[3] = (float)impl->history_height;
+
+    uniform->history[0] = (float)impl->history_region[0];
+    uniform->history[1] = (float)impl->history_region[1];
+    uniform->history[2] = glm_clamp(taa->feedback, 0.0f, 0.99f);
+    uniform->history[3] = valid ? 1.0f : 0.0f;
+
+    uniform->params[0] = taa->clip_gamma;
+    uniform->params[1] = upscaling ? 1.0f : 0.0f;
+}
+
+static bool flecsEngine_taa_render(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    WGPUCommandEncoder encoder,
+    ecs_entity_t effect_entity,
+    const FlecsRenderEffect *effect,
+    FlecsRenderEffectImpl *effect_impl,
+    WGPUTextureView input_view,
+    WGPUTextureFormat input_format,
+    WGPUTextureView output_view,
+    WGPUTextureFormat output_format,
+    WGPULoadOp output_load_op)
+{
+    (void)input_format;
+
+    const FlecsTAA *taa = ecs_get(world, effect_entity, FlecsTAA);
+    FlecsTAAImpl *impl = ecs_get_mut(world, effect_entity, FlecsTAAImpl);
+    ecs_assert(taa != NULL, ECS_INVALID_OPERATION, NULL);
+    ecs_assert(impl != NULL, ECS_INVALID_OPERATION, NULL);
+
+    ecs_entity_t view_entity = ecs_get_target(
+        world, effect_entity, EcsChildOf, 0);
+    if (!view_entity) {
+        return false;
+    }
+
+    const FlecsRenderView *view = ecs_get(world, view_entity, FlecsRenderView);
+    const FlecsRenderViewImpl *view_impl = ecs_get(
+        world, view_entity, FlecsRenderViewImpl);
+    if (!view || !view_impl) {
+        return false;
+    }
+
+    /* As the last effect of a view that renders below output resolution,
+     * the effect writes the view texture and the history is kept at output
+     * resolution. Otherwise it covers the render viewport of the targets. */
+    int32_t last = flecsEngine_renderView_lastEffect(view);
+    const flecs_render_view_effect_t *effects = ecs_vec_first(&view->effects);
+    bool upscaling = last >= 0 && effects[last].effect == effect_entity &&
+        flecsEngine_renderView_effectUpscales(world, engine, view);
+
+    uint32_t region[2], width, height;
+    if (upscaling) {
+        region[0] = width = (uint32_t)engine->width;
+        region[1] = height = (uint32_t)engine->height;
+    } else {
+        region[0] = (uint32_t)engine->render_width;
+        region[1] = (uint32_t)engine->render_height;
+        width = view_impl->effect_target_width;
+        height = view_impl->effect_target_height;
+    }
+
+    if (!width || !height || !region[0] || !region[1]) {
+        return false;
+    }
+
+    if (!flecsEngine_taa_ensurePipelines(engine, impl, effect_impl)) {
+        return false;
+    }
+
+    if (!flecsEngine_taa_ensureHistory(
+        engine, impl, effect_impl, width, height))
+    {
+        return false;
+    }
+
+    /* Switching between modes changes what a history texel means */
+    bool valid = impl->history_valid && impl->history_output == upscaling;
+
+    FlecsTAAUniform uniform = {0};
+    flecsEngine_taa_fillUniform(world, engine, view, taa, impl,
+        region, valid, upscaling, &uniform);
+    flecsEngine_queueWriteBuffer(
+        engine,
+        impl->uniform_buffer,
+        0,
+        &uniform,
+        sizeof(uniform));
+
+    WGPUBindGroupEntry entries[5] = {
+        { .binding = 0, .textureView = input_view },
+        { .binding = 1, .sampler = effect_impl->input_sampler }
+    };
+
+    uint32_t entry_count = 2;
+    if (!flecsEngine_taa_bind(world, engine, effect_entity, effect,
+        effect_impl, entries, &entry_count))
+    {
+        return false;
+    }
+
+    WGPUBindGroup bind_group = flecsEngine_bindGroupCache_get(
+        engine, &effect_impl->bind_groups, effect_impl->bind_layout,
+        entries, entry_count);
+    if (!bind_group) {
+        return false;
+    }
+
+    int32_t write_index = !impl->history_index;
+
+    WGPURenderPassColorAttachment color_atts[2] = {
+        {
+            .view = output_view,
+            WGPU_DEPTH_SLICE
+            .loadOp = output_load_op,
+            .storeOp = WGPUStoreOp_Store,
+            .clearValue = (WGPUColor){0}
+        },
+        {
+            .view = impl->history_views[write_index],
+            WGPU_DEPTH_SLICE
+            .loadOp = WGPULoadOp_Clear,
+            .storeOp = WGPUStoreOp_Store,
+            .clearValue = (WGPUColor){0}
+        }
+    };
+
+    WGPURenderPassDescriptor pass_desc = {
+        .colorAttachmentCount = 2,
+        .colorAttachments = color_atts
+    };
+
+    WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(
+        encoder, &pass_desc);
+    if (!pass) {
+        return false;
+    }
+
+    WGPURenderPipeline pipeline =
+        output_format == flecsEngine_getViewTargetFormat(engine)
+            ? impl->pipeline_surface
+            : impl->pipeline_hdr;
+
+    wgpuRenderPassEncoderSetViewport(pass, 0.0f, 0.0f,
+        (float)region[0], (float)region[1], 0.0f, 1.0f);
+    wgpuRenderPassEncoderSetPipeline(pass, pipeline);
+    wgpuRenderPassEncoderSetBindGroup(pass, 0, bind_group, 0, NULL);
+    wgpuRenderPassEncoderDraw(pass, 3, 1, 0, 0);
+    wgpuRenderPassEncoderEnd(pass);
+    wgpuRenderPassEncoderRelease(pass);
+
+    impl->history_index = write_index;
+    impl->history_region[0] = region[0];
+    impl->history_region[1] = region[1];
+    impl->history_output = upscaling;
+    impl->history_valid = true;
+    return true;
+}
+
+FlecsTAA flecsEngine_taaSettingsDefault(void)
+{
+    return (FlecsTAA){
+        .feedback = 0.9f,
+        .clip_gamma = 1.0f
+    };
+}
+
+ecs_entity_t flecsEngine_createEffect_taa(
+    ecs_world_t *world,
+    ecs_entity_t parent,
+    const char *name,
+    int32_t input,
+    const FlecsTAA *settings)
+{
+    ecs_entity_t effect = ecs_entity(world, { .parent = parent, .name = name });
+
+    FlecsTAA taa = settings
+        ? *settings
+        : flecsEngine_taaSettingsDefault();
+
+    ecs_set_ptr(world, effect, FlecsTAA, &taa);
+    ecs_set(world, effect, FlecsRenderEffect, {
+        .shader = flecsEngine_taa_shader(world),
+        .input = input,
+        .setup_callback = flecsEngine_taa_setup,
+        .bind_callback = flecsEngine_taa_bind,
+        .render_callback = flecsEngine_taa_render,
+        .jitter = true,
+        .upscale = true
+    });
+
+    return effect;
+}
+
+void flecsEngine_taa_register(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, FlecsTAA);
+    ECS_COMPONENT_DEFINE(world, FlecsTAAImpl);
+
+    ecs_set_hooks(world, FlecsTAAImpl, {
+        .ctor = flecs_default_ctor,
+        .move = ecs_move(FlecsTAAImpl),
+        .dtor = ecs_dtor(FlecsTAAImpl)
+    });
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsTAA),
+        .members = {
+            { .name = "feedback", .type = ecs_id(ecs_f32_t) },
+            { .name = "clip_gamma", .type = ecs_id(ecs_f32_t) }
+        }
+    });
+}
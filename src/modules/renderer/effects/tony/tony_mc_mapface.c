@@ -4,27 +4,27 @@
 
 ECS_COMPONENT_DECLARE(FlecsTonyImpl);
 
-static const char *kShaderSource =
-    FLECS_ENGINE_FULLSCREEN_VS_WGSL
-    "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n"
-    "@group(0) @binding(1) var input_sampler : sampler;\n"
-    "@group(0) @binding(2) var tony_lut : texture_3d<f32>;\n"
-    "@group(0) @binding(3) var tony_lut_sampler : sampler;\n"
-    "fn interleaved_gradient_noise(pixel : vec2<f32>) -> f32 {\n"
-    "  return fract(52.9829189 * fract(0.06711056 * pixel.x + 0.00583715 * pixel.y));\n"
+#define FLECS_ENGINE_TONY_STAGE_WGSL \
+    "@group(0) @binding(2) var tony_lut : texture_3d<f32>;\n" \
+    "@group(0) @binding(3) var tony_lut_sampler : sampler;\n" \
+    "fn tony_interleaved_gradient_noise(pixel : vec2<f32>) -> f32 {\n" \
+    "  return fract(52.9829189 * fract(0.06711056 * pixel.x + 0.00583715 * pixel.y));\n" \
+    "}\n" \
+    "fn tony_apply(src : vec4<f32>, pos : vec4<f32>, uv : vec2<f32>) -> vec4<f32> {\n" \
+    "  let encoded = src.rgb / (src.rgb + vec3<f32>(1.0));\n" \
+    "  let dims = 48.0;\n" \
+    "  let lut_uv = clamp(encoded * ((dims - 1.0) / dims) + (0.5 / dims), vec3<f32>(0.0), vec3<f32>(1.0));\n" \
+    "  let mapped = textureSampleLevel(tony_lut, tony_lut_sampler, lut_uv, 0.0).rgb;\n" \
+    "  let pixel = floor(pos.xy);\n" \
+    "  let dither = (tony_interleaved_gradient_noise(pixel) - 0.5) / 255.0;\n" \
+    "  let dithered = clamp(mapped + vec3<f32>(dither), vec3<f32>(0.0), vec3<f32>(1.0));\n" \
+    "  return vec4<f32>(dithered, src.a);\n" \
     "}\n"
-    "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
-    "  let src = textureSample(input_texture, input_sampler, in.uv);\n"
-    "  let encoded = src.rgb / (src.rgb + vec3<f32>(1.0));\n"
-    "  let dims = 48.0;\n"
-    "  let uv = clamp(encoded * ((dims - 1.0) / dims) + (0.5 / dims), vec3<f32>(0.0), vec3<f32>(1.0));\n"
-    "  let mapped = textureSampleLevel(tony_lut, tony_lut_sampler, uv, 0.0).rgb;\n"
-    "  let tex_size = vec2<f32>(textureDimensions(input_texture));\n"
-    "  let pixel = floor(in.uv * tex_size);\n"
-    "  let dither = (interleaved_gradient_noise(pixel) - 0.5) / 255.0;\n"
-    "  let dithered = clamp(mapped + vec3<f32>(dither), vec3<f32>(0.0), vec3<f32>(1.0));\n"
-    "  return vec4<f32>(dithered, src.a);\n"
-    "}\n";
+
+static const char *kStageSource = FLECS_ENGINE_TONY_STAGE_WGSL;
+
+static const char *kShaderSource =
+    FLECS_ENGINE_POINTWISE_EFFECT_WGSL(FLECS_ENGINE_TONY_STAGE_WGSL, "tony_apply");
 
 static ecs_entity_t flecsEngine_tony_shader(
     ecs_world_t *world)
@@ -51,7 +51,8 @@ static void flecsEngine_tony_releaseResources(
     }
 
     if (impl->tony_lut_texture) {
-        wgpuTextureRelease(impl->tony_lut_texture);
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryEffect, impl->tony_lut_texture);
         impl->tony_lut_texture = NULL;
     }
 }
@@ -106,7 +107,8 @@ static bool flecsEngine_tony_setup(
         .sampleCount = 1
     };
 
-    tony.tony_lut_texture = wgpuDeviceCreateTexture(engine->device, &lut_desc);
+    tony.tony_lut_texture = flecsEngine_gpuMemory_createTexture(
+        engine->device, FlecsGpuMemoryEffect, &lut_desc);
     if (!tony.tony_lut_texture) {
         flecsEngine_tony_releaseResources(&tony);
         return false;
@@ -228,7 +230,10 @@ ecs_entity_t flecsEngine_createEffect_tonyMcMapFace(
         .shader = flecsEngine_tony_shader(world),
         .input = input,
         .setup_callback = flecsEngine_tony_setup,
-        .bind_callback = flecsEngine_tony_bind
+        .bind_callback = flecsEngine_tony_bind,
+        .pointwise = kStageSource,
+        .pointwise_fn = "tony_apply",
+        .ldr_output = true
     });
 
     return effect;
@@ -0,0 +1,481 @@
+#include <math.h>
+
+#include "../../renderer.h"
+#include "flecs_engine.h"
+
+/* Spatial upscaler modeled after FSR 1. EASU reconstructs the output from a
+ * 12-tap window around the input position, with a lanczos-like kernel that is
+ * stretched along the local edge direction. RCAS then sharpens the result,
+ * limiting the sharpening lobe so that it can't introduce ringing. Both
+ * passes expect colors in a perceptual space (after tonemapping). */
+
+typedef struct FlecsUpscaleUniform {
+    float size[4];   /* render width, height, output width, height */
+    float params[4]; /* sharpness (linear), unused */
+} FlecsUpscaleUniform;
+
+static const char *kShaderSource =
+    FLECS_ENGINE_FULLSCREEN_VS_WGSL
+    "struct UpscaleUniforms {\n"
+    "  size : vec4<f32>,\n"
+    "  params : vec4<f32>,\n"
+    "};\n"
+    "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n"
+    "@group(0) @binding(1) var<uniform> uniforms : UpscaleUniforms;\n"
+
+    /* Loads are clamped to the render viewport, since the rest of the input
+     * texture isn't rendered to. */
+    "fn easu_load(p : vec2<i32>) -> vec3<f32> {\n"
+    "  let max_p = vec2<i32>(uniforms.size.xy) - vec2<i32>(1);\n"
+    "  return textureLoad(input_texture, clamp(p, vec2<i32>(0), max_p), 0).rgb;\n"
+    "}\n"
+
+    "fn easu_luma(c : vec3<f32>) -> f32 {\n"
+    "  return c.b * 0.5 + (c.r * 0.5 + c.g);\n"
+    "}\n"
+
+    /* Direction and edge length of one bilinear quadrant, weighted by the
+     * bilinear weight of the quadrant. Luma layout:
+     *     a
+     *   b c d
+     *     e   */
+    "fn easu_edge(w : f32, la : f32, lb : f32, lc : f32, ld : f32, le : f32) -> vec3<f32> {\n"
+    "  let dir_x = ld - lb;\n"
+    "  var len_x = 1.0 / max(max(abs(ld - lc), abs(lc - lb)), 1e-5);\n"
+    "  len_x = clamp(abs(dir_x) * len_x, 0.0, 1.0);\n"
+    "  let dir_y = le - la;\n"
+    "  var len_y = 1.0 / max(max(abs(le - lc), abs(lc - la)), 1e-5);\n"
+    "  len_y = clamp(abs(dir_y) * len_y, 0.0, 1.0);\n"
+    "  return vec3<f32>(dir_x, dir_y, len_x * len_x + len_y * len_y) * w;\n"
+    "}\n"
+
+    "fn easu_tap(off : vec2<f32>, dir : vec2<f32>, len : vec2<f32>,\n"
+    "  lob : f32, clp : f32, c : vec3<f32>) -> vec4<f32>\n"
+    "{\n"
+    "  var v = vec2<f32>(\n"
+    "    off.x * dir.x + off.y * dir.y,\n"
+    "    off.x * -dir.y + off.y * dir.x);\n"
+    "  v *= len;\n"
+    "  let d2 = min(dot(v, v), clp);\n"
+    /* Approximation of lanczos2 without sin(), sqrt() or rcp() */
+    "  var wb = 2.0 / 5.0 * d2 - 1.0;\n"
+    "  var wa = lob * d2 - 1.0;\n"
+    "  wb *= wb;\n"
+    "  wa *= wa;\n"
+    "  wb = 25.0 / 16.0 * wb - (25.0 / 16.0 - 1.0);\n"
+    "  let w = wb * wa;\n"
+    "  return vec4<f32>(c * w, w);\n"
+    "}\n"
+
+    "@fragment fn easu_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
+    "  var pp = in.pos.xy * (uniforms.size.xy / uniforms.size.zw) - vec2<f32>(0.5);\n"
+    "  let fp = floor(pp);\n"
+    "  pp -= fp;\n"
+    "  let p = vec2<i32>(fp);\n"
+
+    /*     b c
+     *   e f g h
+     *   i j k l
+     *     n o   */
+    "  let b = easu_load(p + vec2<i32>(0, -1));\n"
+    "  let c = easu_load(p + vec2<i32>(1, -1));\n"
+    "  let e = easu_load(p + vec2<i32>(-1, 0));\n"
+    "  let f = easu_load(p);\n"
+    "  let g = easu_load(p + vec2<i32>(1, 0));\n"
+    "  let h = easu_load(p + vec2<i32>(2, 0));\n"
+    "  let i = easu_load(p + vec2<i32>(-1, 1));\n"
+    "  let j = easu_load(p + vec2<i32>(0, 1));\n"
+    "  let k = easu_load(p + vec2<i32>(1, 1));\n"
+    "  let l = easu_load(p + vec2<i32>(2, 1));\n"
+    "  let n = easu_load(p + vec2<i32>(0, 2));\n"
+    "  let o = easu_load(p + vec2<i32>(1, 2));\n"
+
+    "  let bl = easu_luma(b);\n"
+    "  let cl = easu_luma(c);\n"
+    "  let el = easu_luma(e);\n"
+    "  let fl = easu_luma(f);\n"
+    "  let gl = easu_luma(g);\n"
+    "  let hl = easu_luma(h);\n"
+    "  let il = easu_luma(i);\n"
+    "  let jl = easu_luma(j);\n"
+    "  let kl = easu_luma(k);\n"
+    "  let ll = easu_luma(l);\n"
+    "  let nl = easu_luma(n);\n"
+    "  let ol = easu_luma(o);\n"
+
+    "  var edge = easu_edge((1.0 - pp.x) * (1.0 - pp.y), bl, el, fl, gl, jl);\n"
+    "  edge += easu_edge(pp.x * (1.0 - pp.y), cl, fl, gl, hl, kl);\n"
+    "  edge += easu_edge((1.0 - pp.x) * pp.y, fl, il, jl, kl, nl);\n"
+    "  edge += easu_edge(pp.x * pp.y, gl, jl, kl, ll, ol);\n"
+
+    /* Normalize direction, falling back to horizontal without an edge */
+    "  var dir = edge.xy;\n"
+    "  let dir_r = dot(dir, dir);\n"
+    "  let no_dir = dir_r < 1.0 / 32768.0;\n"
+    "  dir.x = select(dir.x, 1.0, no_dir);\n"
+    "  dir *= select(inverseSqrt(dir_r), 1.0, no_dir);\n"
+
+    /* Stretch the kernel along the edge, and shrink it across the edge */
+    "  var len = edge.z * 0.5;\n"
+    "  len *= len;\n"
+    "  let stretch = dot(dir, dir) / max(abs(dir.x), abs(dir.y));\n"
+    "  let len2 = vec2<f32>(1.0 + (stretch - 1.0) * len, 1.0 - 0.5 * len);\n"
+    "  let lob = 0.5 + ((1.0 / 4.0 - 0.04) - 0.5) * len;\n"
+    "  let clp = 1.0 / lob;\n"
+
+    "  var sum = easu_tap(vec2<f32>(0.0, -1.0) - pp, dir, len2, lob, clp, b);\n"
+    "  sum += easu_tap(vec2<f32>(1.0, -1.0) - pp, dir, len2, lob, clp, c);\n"
+    "  sum += easu_tap(vec2<f32>(-1.0, 1.0) - pp, dir, len2, lob, clp, i);\n"
+    "  sum += easu_tap(vec2<f32>(0.0, 1.0) - pp, dir, len2, lob, clp, j);\n"
+    "  sum += easu_tap(vec2<f32>(0.0, 0.0) - pp, dir, len2, lob, clp, f);\n"
+    "  sum += easu_tap(vec2<f32>(-1.0, 0.0) - pp, dir, len2, lob, clp, e);\n"
+    "  sum += easu_tap(vec2<f32>(1.0, 1.0) - pp, dir, len2, lob, clp, k);\n"
+    "  sum += easu_tap(vec2<f32>(2.0, 1.0) - pp, dir, len2, lob, clp, l);\n"
+    "  sum += easu_tap(vec2<f32>(2.0, 0.0) - pp, dir, len2, lob, clp, h);\n"
+    "  sum += easu_tap(vec2<f32>(1.0, 0.0) - pp, dir, len2, lob, clp, g);\n"
+    "  sum += easu_tap(vec2<f32>(1.0, 2.0) - pp, dir, len2, lob, clp, o);\n"
+    "  sum += easu_tap(vec2<f32>(0.0, 2.0) - pp, dir, len2, lob, clp, n);\n"
+
+    /* Clamp to the 4 nearest texels to remove ringing */
+    "  let min4 = min(min(f, g), min(j, k));\n"
+    "  let max4 = max(max(f, g), max(j, k));\n"
+    "  let color = min(max4, max(min4, sum.rgb / sum.w));\n"
+    "  return vec4<f32>(color, 1.0);\n"
+    "}\n"
+
+    "const RCAS_LIMIT = 0.25 - 1.0 / 16.0;\n"
+
+    "fn rcas_load(p : vec2<i32>) -> vec3<f32> {\n"
+    "  let max_p = vec2<i32>(uniforms.size.zw) - vec2<i32>(1);\n"
+    "  return textureLoad(input_texture, clamp(p, vec2<i32>(0), max_p), 0).rgb;\n"
+    "}\n"
+
+    /* Sharpen with a negative lobe on the cross neighbors. The lobe is the
+     * largest that keeps the result within the range of the neighborhood.
+     *     b
+     *   d e f
+     *     h   */
+    "@fragment fn rcas_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
+    "  let p = vec2<i32>(in.pos.xy);\n"
+    "  let b = rcas_load(p + vec2<i32>(0, -1));\n"
+    "  let d = rcas_load(p + vec2<i32>(-1, 0));\n"
+    "  let e = rcas_load(p);\n"
+    "  let f = rcas_load(p + vec2<i32>(1, 0));\n"
+    "  let h = rcas_load(p + vec2<i32>(0, 1));\n"
+    "  let mn4 = min(min(b, d), min(f, h));\n"
+    "  let mx4 = max(max(b, d), max(f, h));\n"
+    "  let hit_min = min(mn4, e) / max(4.0 * mx4, vec3<f32>(1e-5));\n"
+    "  let hit_max = (vec3<f32>(1.0) - max(mx4, e)) /\n"
+    "    min(4.0 * mn4 - vec3<f32>(4.0), vec3<f32>(-1e-5));\n"
+    "  let lobe_rgb = max(-hit_min, hit_max);\n"
+    "  let lobe = max(-RCAS_LIMIT,\n"
+    "    min(max(lobe_rgb.r, max(lobe_rgb.g, lobe_rgb.b)), 0.0)) *\n"
+    "    uniforms.params.x;\n"
+    "  let color = (lobe * (b + d + f + h) + e) / (4.0 * lobe + 1.0);\n"
+    "  return vec4<f32>(color, 1.0);\n"
+    "}\n";
+
+static WGPURenderPipeline flecsEngine_upscale_createPipeline(
+    FlecsEngineImpl *impl,
+    WGPUShaderModule module,
+    WGPUPipelineLayout pipeline_layout,
+    const char *fragment_entry)
+{
+    WGPUColorTargetState color_target = {
+        .format = flecsEngine_getViewTargetFormat(impl),
+        .writeMask = WGPUColorWriteMask_All
+    };
+
+    return wgpuDeviceCreateRenderPipeline(
+        impl->device, &(WGPURenderPipelineDescriptor){
+            .layout = pipeline_layout,
+            .vertex = {
+                .module = module,
+                .entryPoint = WGPU_STR("vs_main")
+            },
+            .fragment = &(WGPUFragmentState){
+                .module = module,
+                .entryPoint = WGPU_STR(fragment_entry),
+                .targetCount = 1,
+                .targets = &color_target
+            },
+            .primitive = {
+                .topology = WGPUPrimitiveTopology_TriangleList,
+                .cullMode = WGPUCullMode_None,
+                .frontFace = WGPUFrontFace_CCW
+            },
+            .multisample = WGPU_MULTISAMPLE_DEFAULT
+        });
+}
+
+int flecsEngine_initUpscale(
+    FlecsEngineImpl *impl)
+{
+    WGPUShaderModule module = flecsEngine_shaderCache_get(
+        impl, kShaderSource);
+    if (!module) {
+        return -1;
+    }
+
+    WGPUBindGroupLayoutEntry layout_entries[2] = {
+        {
+            .binding = 0,
+            .visibility = WGPUShaderStage_Fragment,
+            .texture = {
+                .sampleType = WGPUTextureSampleType_Float,
+                .viewDimension = WGPUTextureViewDimension_2D
+            }
+        },
+        {
+            .binding = 1,
+            .visibility = WGPUShaderStage_Fragment,
+            .buffer = {
+                .type = WGPUBufferBindingType_Uniform,
+                .minBindingSize = sizeof(FlecsUpscaleUniform)
+            }
+        }
+    };
+
+    impl->upscale.bind_layout = wgpuDeviceCreateBindGroupLayout(
+        impl->device, &(WGPUBindGroupLayoutDescriptor){
+            .entries = layout_entries,
+            .entryCount = 2
+        });
+    if (!impl->upscale.bind_layout) {
+        return -1;
+    }
+
+    impl->upscale.uniform_buffer = flecsEngine_gpuMemory_createBuffer(
+        impl->device, FlecsGpuMemoryEffect,
+        &(WGPUBufferDescriptor){
+            .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+            .size = sizeof(FlecsUpscaleUniform)
+        });
+    if (!impl->upscale.uniform_buffer) {
+        return -1;
+    }
+
+    WGPUPipelineLayout pipeline_layout = wgpuDeviceCreatePipelineLayout(
+        impl->device, &(WGPUPipelineLayoutDescriptor){
+            .bindGroupLayoutCount = 1,
+            .bindGroupLayouts = &impl->upscale.bind_layout
+        });
+    if (!pipeline_layout) {
+        return -1;
+    }
+
+    impl->upscale.easu_pipeline = flecsEngine_upscale_createPipeline(
+        impl, module, pipeline_layout, "easu_main");
+    impl->upscale.rcas_pipeline = flecsEngine_upscale_createPipeline(
+        impl, module, pipeline_layout, "rcas_main");
+
+    wgpuPipelineLayoutRelease(pipeline_layout);
+
+    if (!impl->upscale.easu_pipeline || !impl->upscale.rcas_pipeline) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static void flecsEngine_upscale_releaseTexture(
+    FlecsEngineImpl *impl)
+{
+    /* RCAS bind groups sample the intermediate texture */
+    flecsEngine_bindGroupCache_fini(&impl->upscale.rcas_bind_groups);
+
+    if (impl->upscale.texture_view) {
+        wgpuTextureViewRelease(impl->upscale.texture_view);
+        impl->upscale.texture_view = NULL;
+    }
+
+    if (impl->upscale.texture) {
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryEffect, impl->upscale.texture);
+        impl->upscale.texture = NULL;
+    }
+
+    impl->upscale.texture_width = 0;
+    impl->upscale.texture_height = 0;
+}
+
+void flecsEngine_releaseUpscale(
+    FlecsEngineImpl *impl)
+{
+    flecsEngine_upscale_releaseTexture(impl);
+
+    if (impl->upscale.easu_pipeline) {
+        wgpuRenderPipelineRelease(impl->upscale.easu_pipeline);
+        impl->upscale.easu_pipeline = NULL;
+    }
+
+    if (impl->upscale.rcas_pipeline) {
+        wgpuRenderPipelineRelease(impl->upscale.rcas_pipeline);
+        impl->upscale.rcas_pipeline = NULL;
+    }
+
+    if (impl->upscale.bind_layout) {
+        wgpuBindGroupLayoutRelease(impl->upscale.bind_layout);
+        impl->upscale.bind_layout = NULL;
+    }
+
+    if (impl->upscale.uniform_buffer) {
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryEffect, impl->upscale.uniform_buffer);
+        impl->upscale.uniform_buffer = NULL;
+    }
+}
+
+static bool flecsEngine_upscale_ensureTexture(
+    FlecsEngineImpl *impl)
+{
+    uint32_t width = (uint32_t)impl->width;
+    uint32_t height = (uint32_t)impl->height;
+
+    if (impl->upscale.texture &&
+        impl->upscale.texture_width == width &&
+        impl->upscale.texture_height == height)
+    {
+        return true;
+    }
+
+    flecsEngine_upscale_releaseTexture(impl);
+
+    WGPUTextureDescriptor desc = {
+        .usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding,
+        .dimension = WGPUTextureDimension_2D,
+        .size = (WGPUExtent3D){ .width = width, .height = height, .depthOrArrayLayers = 1 },
+        .format = flecsEngine_getViewTargetFormat(impl),
+        .mipLevelCount = 1,
+        .sampleCount = 1
+    };
+
+    impl->upscale.texture = flecsEngine_gpuMemory_createTexture(
+        impl->device, FlecsGpuMemoryEffect, &desc);
+    if (!impl->upscale.texture) {
+        return false;
+    }
+
+    impl->upscale.texture_view = wgpuTextureCreateView(
+        impl->upscale.texture, NULL);
+    if (!impl->upscale.texture_view) {
+        flecsEngine_upscale_releaseTexture(impl);
+        return false;
+    }
+
+    impl->upscale.texture_width = width;
+    impl->upscale.texture_height = height;
+    return true;
+}
+
+static bool flecsEngine_upscale_runPass(
+    const FlecsEngineImpl *impl,
+    WGPUCommandEncoder encoder,
+    WGPURenderPipeline pipeline,
+    flecs_engine_bind_group_cache_t *bind_groups,
+    WGPUTextureView input_view,
+    WGPUTextureView output_view,
+    WGPULoadOp load_op)
+{
+    WGPUBindGroupEntry entries[2] = {
+        { .binding = 0, .textureView = input_view },
+        {
+            .binding = 1,
+            .buffer = impl->upscale.uniform_buffer,
+            .offset = 0,
+            .size = sizeof(FlecsUpscaleUniform)
+        }
+    };
+
+    WGPUBindGroup bind_group = flecsEngine_bindGroupCache_get(
+        impl, bind_groups, impl->upscale.bind_layout, entries, 2);
+    if (!bind_group) {
+        return false;
+    }
+
+    WGPURenderPassColorAttachment color_attachment = {
+        .view = output_view,
+        WGPU_DEPTH_SLICE
+        .loadOp = load_op,
+        .storeOp = WGPUStoreOp_Store,
+        .clearValue = (WGPUColor){0}
+    };
+
+    WGPURenderPassDescriptor pass_desc = {
+        .colorAttachmentCount = 1,
+        .colorAttachments = &color_attachment
+    };
+
+    WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(
+        encoder, &pass_desc);
+    if (!pass) {
+        return false;
+    }
+
+    wgpuRenderPassEncoderSetPipeline(pass, pipeline);
+    wgpuRenderPassEncoderSetBindGroup(pass, 0, bind_group, 0, NULL);
+    wgpuRenderPassEncoderDraw(pass, 3, 1, 0, 0);
+    wgpuRenderPassEncoderEnd(pass);
+    wgpuRenderPassEncoderRelease(pass);
+    return true;
+}
+
+bool flecsEngine_upscale(
+    FlecsEngineImpl *impl,
+    FlecsRenderViewImpl *view_impl,
+    WGPUCommandEncoder encoder,
+    WGPUTextureView input_view,
+    WGPUTextureView view_texture)
+{
+    float sharpness = glm_clamp(impl->upscale.sharpness, 0.0f, 1.0f);
+
+    /* Without sharpening EASU writes straight to the view texture */
+    bool sharpen = sharpness > 0.0f;
+    if (sharpen && !flecsEngine_upscale_ensureTexture(impl)) {
+        return false;
+    }
+
+    /* Sharpness 1 is the strongest RCAS setting (0 stops), and sharpness
+     * approaching 0 the weakest (2 stops). */
+    FlecsUpscaleUniform uniform = {
+        .size = {
+            (float)impl->render_width,
+            (float)impl->render_height,
+            (float)impl->width,
+            (float)impl->height
+        },
+        .params = { exp2f(-2.0f * (1.0f - sharpness)), 0.0f, 0.0f, 0.0f }
+    };
+
+    flecsEngine_queueWriteBuffer(
+        impl,
+        impl->upscale.uniform_buffer,
+        0,
+        &uniform,
+        sizeof(uniform));
+
+    if (!flecsEngine_upscale_runPass(
+        impl,
+        encoder,
+        impl->upscale.easu_pipeline,
+        &view_impl->upscale_bind_groups,
+        input_view,
+        sharpen ? impl->upscale.texture_view : view_texture,
+        sharpen ? WGPULoadOp_Clear : WGPULoadOp_Load))
+    {
+        return false;
+    }
+
+    if (!sharpen) {
+        return true;
+    }
+
+    return flecsEngine_upscale_runPass(
+        impl,
+        encoder,
+        impl->upscale.rcas_pipeline,
+        &impl->upscale.rcas_bind_groups,
+        impl->upscale.texture_view,
+        view_texture,
+        WGPULoadOp_Load);
+}
@@ -0,0 +1,240 @@
+#include "renderer.h"
+#include "flecs_engine.h"
+
+/* Passes recorded on workers don't depend on each other, so one worker per
+ * shadow cascade is enough. The main thread also picks up jobs while it waits
+ * for the workers. */
+#ifndef FLECS_ENGINE_ENCODE_THREADS
+#ifdef __EMSCRIPTEN__
+#define FLECS_ENGINE_ENCODE_THREADS (0)
+#else
+#define FLECS_ENGINE_ENCODE_THREADS (FLECS_ENGINE_SHADOW_CASCADE_COUNT - 1)
+#endif
+#endif
+
+struct flecs_engine_encode_pool_t {
+    ecs_os_thread_t *threads;
+    int32_t thread_count;
+    ecs_os_mutex_t lock;
+    ecs_os_cond_t job_cond;  /* Signaled when jobs are published */
+    ecs_os_cond_t done_cond; /* Signaled when the last job is done */
+    flecs_engine_encode_job_t *jobs;
+    int32_t job_count;
+    int32_t next_job;
+    int32_t done_count;
+    bool quit;
+};
+
+/* Claim and run the next job. Must be called with the lock held. Returns
+ * false if there are no jobs left to claim. */
+static bool flecsEngine_encodePool_runNext(
+    flecs_engine_encode_pool_t *pool)
+{
+    if (pool->next_job >= pool->job_count) {
+        return false;
+    }
+
+    flecs_engine_encode_job_t *job = &pool->jobs[pool->next_job ++];
+
+    ecs_os_mutex_unlock(pool->lock);
+    job->callback(job->ctx);
+    ecs_os_mutex_lock(pool->lock);
+
+    pool->done_count ++;
+    if (pool->done_count == pool->job_count) {
+        ecs_os_cond_broadcast(pool->done_cond);
+    }
+
+    return true;
+}
+
+static void* flecsEngine_encodePool_worker(
+    void *arg)
+{
+    flecs_engine_encode_pool_t *pool = arg;
+
+    ecs_os_mutex_lock(pool->lock);
+    while (!pool->quit) {
+        if (!flecsEngine_encodePool_runNext(pool)) {
+            ecs_os_cond_wait(pool->job_cond, pool->lock);
+        }
+    }
+    ecs_os_mutex_unlock(pool->lock);
+
+    return NULL;
+}
+
+flecs_engine_encode_pool_t* flecsEngine_encodePool_create(void)
+{
+    int32_t thread_count = FLECS_ENGINE_ENCODE_THREADS;
+    if (thread_count <= 0 || !ecs_os_has_threading()) {
+        return NULL;
+    }
+
+    flecs_engine_encode_pool_t *pool = ecs_os_calloc_t(
+        flecs_engine_encode_pool_t);
+    pool->lock = ecs_os_mutex_new();
+    pool->job_cond = ecs_os_cond_new();
+    pool->done_cond = ecs_os_cond_new();
+    pool->threads = ecs_os_calloc_n(ecs_os_thread_t, thread_count);
+
+    for (int32_t i = 0; i < thread_count; i ++) {
+        pool->threads[i] = ecs_os_thread_new(
+            flecsEngine_encodePool_worker, pool);
+        if (!pool->threads[i]) {
+            break;
+        }
+        pool->thread_count ++;
+    }
+
+    if (!pool->thread_count) {
+        ecs_err("failed to start encoder threads, encoding on main thread");
+        flecsEngine_encodePool_free(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+void flecsEngine_encodePool_free(
+    flecs_engine_encode_pool_t *pool)
+{
+    if (!pool) {
+        return;
+    }
+
+    ecs_os_mutex_lock(pool->lock);
+    pool->quit = true;
+    ecs_os_cond_broadcast(pool->job_cond);
+    ecs_os_mutex_unlock(pool->lock);
+
+    for (int32_t i = 0; i < pool->thread_count; i ++) {
+        ecs_os_thread_join(pool->threads[i]);
+    }
+
+    ecs_os_cond_free(pool->done_cond);
+    ecs_os_cond_free(pool->job_cond);
+    ecs_os_mutex_free(pool->lock);
+    ecs_os_free(pool->threads);
+    ecs_os_free(pool);
+}
+
+void flecsEngine_encodePool_begin(
+    flecs_engine_encode_pool_t *pool,
+    flecs_engine_encode_job_t *jobs,
+    int32_t job_count)
+{
+    if (!pool || !job_count) {
+        return;
+    }
+
+    ecs_os_mutex_lock(pool->lock);
+    ecs_assert(pool->next_job >= pool->job_count, ECS_INVALID_OPERATION,
+        "previous encode jobs are still running");
+    pool->jobs = jobs;
+    pool->job_count = job_count;
+    pool->next_job = 0;
+    pool->done_count = 0;
+    ecs_os_cond_broadcast(pool->job_cond);
+    ecs_os_mutex_unlock(pool->lock);
+}
+
+void flecsEngine_encodePool_end(
+    flecs_engine_encode_pool_t *pool,
+    flecs_engine_encode_job_t *jobs,
+    int32_t job_count)
+{
+    if (!job_count) {
+        return;
+    }
+
+    /* Without workers, jobs are encoded serially in submission order */
+    if (!pool) {
+        for (int32_t i = 0; i < job_count; i ++) {
+            jobs[i].callback(jobs[i].ctx);
+        }
+        return;
+    }
+
+    ecs_os_mutex_lock(pool->lock);
+    ecs_assert(pool->jobs == jobs, ECS_INVALID_PARAMETER, NULL);
+
+    while (flecsEngine_encodePool_runNext(pool)) { }
+
+    while (pool->done_count < pool->job_count) {
+        ecs_os_cond_wait(pool->done_cond, pool->lock);
+    }
+
+    pool->jobs = NULL;
+    pool->job_count = 0;
+    pool->next_job = 0;
+    pool->done_count = 0;
+    ecs_os_mutex_unlock(pool->lock);
+}
+
+void flecsEngine_frameCommands_append(
+    FlecsEngineImpl *engine,
+    WGPUCommandBuffer cmd)
+{
+    ecs_vec_append_t(NULL, &engine->frame_commands, WGPUCommandBuffer)[0] =
+        cmd;
+}
+
+int flecsEngine_frameCommands_flush(
+    FlecsEngineImpl *engine,
+    WGPUCommandEncoder *encoder)
+{
+    WGPUCommandBufferDescriptor cmd_desc = {0};
+    WGPUCommandBuffer cmd = wgpuCommandEncoderFinish(*encoder, &cmd_desc);
+    wgpuCommandEncoderRelease(*encoder);
+    *encoder = NULL;
+
+    if (!cmd) {
+        ecs_err("Failed to create command buffer\n");
+        return -1;
+    }
+
+    flecsEngine_frameCommands_append(engine, cmd);
+
+    WGPUCommandEncoderDescriptor encoder_desc = {0};
+    *encoder = wgpuDeviceCreateCommandEncoder(engine->device, &encoder_desc);
+    if (!*encoder) {
+        ecs_err("Failed to create command encoder\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+void flecsEngine_frameCommands_submit(
+    FlecsEngineImpl *engine)
+{
+    int32_t count = ecs_vec_count(&engine->frame_commands);
+    if (count) {
+        wgpuQueueSubmit(engine->queue, (size_t)count,
+            ecs_vec_first_t(&engine->frame_commands, WGPUCommandBuffer));
+        flecsEngine_frameSync_signal(engine);
+    }
+
+    flecsEngine_frameCommands_clear(engine);
+}
+
+void flecsEngine_frameCommands_clear(
+    FlecsEngineImpl *engine)
+{
+    int32_t i, count = ecs_vec_count(&engine->frame_commands);
+    WGPUCommandBuffer *cmds = ecs_vec_first_t(
+        &engine->frame_commands, WGPUCommandBuffer);
+    for (i = 0; i < count; i ++) {
+        wgpuCommandBufferRelease(cmds[i]);
+    }
+
+    ecs_vec_clear(&engine->frame_commands);
+}
+
+void flecsEngine_frameCommands_fini(
+    FlecsEngineImpl *engine)
+{
+    flecsEngine_frameCommands_clear(engine);
+    ecs_vec_fini_t(NULL, &engine->frame_commands, WGPUCommandBuffer);
+}
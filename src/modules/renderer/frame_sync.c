@@ -0,0 +1,142 @@
+#include "renderer.h"
+#include "flecs_engine.h"
+
+ECS_COMPONENT_DECLARE(FlecsFrameSyncStats);
+
+void flecsEngine_frameSync_init(
+    FlecsEngineImpl *engine,
+    int32_t frames_in_flight)
+{
+    flecs_engine_frame_sync_t *fs = &engine->frame_sync;
+
+    if (frames_in_flight <= 0) {
+        frames_in_flight = FLECS_ENGINE_FRAMES_IN_FLIGHT_DEFAULT;
+    }
+    if (frames_in_flight > FLECS_ENGINE_FRAMES_IN_FLIGHT_MAX) {
+        frames_in_flight = FLECS_ENGINE_FRAMES_IN_FLIGHT_MAX;
+    }
+
+    fs->count = frames_in_flight;
+    fs->slot = 0;
+    fs->fences = ecs_os_calloc_n(flecs_engine_frame_fence_t, frames_in_flight);
+    for (int32_t i = 0; i < frames_in_flight; i ++) {
+        fs->fences[i].done = true;
+    }
+}
+
+void flecsEngine_frameSync_fini(
+    FlecsEngineImpl *engine)
+{
+    flecs_engine_frame_sync_t *fs = &engine->frame_sync;
+    if (!fs->fences) {
+        return;
+    }
+
+    /* Fences are written by queue callbacks, so they can't be freed while
+     * there is still work in flight. */
+    for (int32_t i = 0; i < fs->count; i ++) {
+        if (!fs->fences[i].done) {
+            flecsEngine_processEventsUntilDone(
+                engine->instance, &fs->fences[i].done);
+        }
+    }
+
+    ecs_os_free(fs->fences);
+    fs->fences = NULL;
+    fs->count = 0;
+}
+
+void flecsEngine_frameSync_begin(
+    FlecsEngineImpl *engine)
+{
+    flecs_engine_frame_sync_t *fs = &engine->frame_sync;
+    fs->wait_count = 0;
+    fs->wait_time = 0;
+    fs->frame_count ++;
+
+    if (fs->count <= 1) {
+        return;
+    }
+
+    fs->slot = (fs->slot + 1) % fs->count;
+
+    flecs_engine_frame_fence_t *fence = &fs->fences[fs->slot];
+    if (fence->done) {
+        return;
+    }
+
+    /* Run callbacks of work that finished since the last frame before
+     * treating the fence as a stall. */
+    flecsEngine_processEvents(engine->instance);
+    if (fence->done) {
+        return;
+    }
+
+    ecs_time_t t = {0};
+    ecs_time_measure(&t);
+    flecsEngine_processEventsUntilDone(engine->instance, &fence->done);
+    double wait_time = ecs_time_measure(&t);
+
+    fs->wait_count ++;
+    fs->wait_time += (float)wait_time;
+    fs->total_wait_count ++;
+    fs->total_wait_time += wait_time;
+}
+
+void flecsEngine_frameSync_signal(
+    const FlecsEngineImpl *engine)
+{
+    const flecs_engine_frame_sync_t *fs = &engine->frame_sync;
+    if (fs->count <= 1) {
+        return;
+    }
+
+    flecs_engine_frame_fence_t *fence = &fs->fences[fs->slot];
+    fence->done = false;
+    flecsEngine_queueOnWorkDone(engine->queue, &fence->done);
+}
+
+void flecsEngine_frameSync_publishStats(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine)
+{
+    const flecs_engine_frame_sync_t *fs = &engine->frame_sync;
+    const FlecsFrameSyncStats *stats = ecs_singleton_get(
+        world, FlecsFrameSyncStats);
+    if (stats &&
+        stats->frames_in_flight == fs->count &&
+        stats->frame_count == fs->frame_count &&
+        stats->total_wait_count == fs->total_wait_count)
+    {
+        return;
+    }
+
+    ecs_singleton_set(world, FlecsFrameSyncStats, {
+        .frames_in_flight = fs->count,
+        .wait_count = fs->wait_count,
+        .wait_time = fs->wait_time,
+        .frame_count = fs->frame_count,
+        .total_wait_count = fs->total_wait_count,
+        .total_wait_time = fs->total_wait_time
+    });
+}
+
+void flecsEngine_frameSync_register(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, FlecsFrameSyncStats);
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsFrameSyncStats),
+        .members = {
+            { .name = "frames_in_flight", .type = ecs_id(ecs_i32_t) },
+            { .name = "wait_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "wait_time", .type = ecs_id(ecs_f32_t) },
+            { .name = "frame_count", .type = ecs_id(ecs_i64_t) },
+            { .name = "total_wait_count", .type = ecs_id(ecs_i64_t) },
+            { .name = "total_wait_time", .type = ecs_id(ecs_f64_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(FlecsFrameSyncStats), EcsSingleton);
+}
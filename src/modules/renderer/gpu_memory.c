@@ -0,0 +1,209 @@
+#include <string.h>
+
+#include "renderer.h"
+#include "flecs_engine.h"
+
+ECS_COMPONENT_DECLARE(FlecsGpuMemory);
+ECS_COMPONENT_DECLARE(FlecsGpuMemoryBudget);
+
+typedef struct {
+    int64_t bytes[FlecsGpuMemoryCategoryCount];
+    int64_t total;
+    int64_t peak_total;
+    int32_t buffer_count;
+    int32_t texture_count;
+    bool over_budget;
+} flecs_engine_gpu_memory_t;
+
+static flecs_engine_gpu_memory_t flecs_engine_gpu_memory;
+
+static void flecsEngine_gpuMemory_add(
+    flecs_engine_gpu_memory_category_t category,
+    int64_t bytes)
+{
+    flecs_engine_gpu_memory_t *memory = &flecs_engine_gpu_memory;
+    memory->bytes[category] += bytes;
+    memory->total += bytes;
+    if (memory->total > memory->peak_total) {
+        memory->peak_total = memory->total;
+    }
+}
+
+WGPUBuffer flecsEngine_gpuMemory_createBuffer(
+    WGPUDevice device,
+    flecs_engine_gpu_memory_category_t category,
+    const WGPUBufferDescriptor *desc)
+{
+    WGPUBuffer buffer = wgpuDeviceCreateBuffer(device, desc);
+    if (buffer) {
+        flecsEngine_gpuMemory_add(category, (int64_t)desc->size);
+        flecs_engine_gpu_memory.buffer_count ++;
+    }
+    return buffer;
+}
+
+void flecsEngine_gpuMemory_releaseBuffer(
+    flecs_engine_gpu_memory_category_t category,
+    WGPUBuffer buffer)
+{
+    if (!buffer) {
+        return;
+    }
+
+    flecsEngine_gpuMemory_add(category, -(int64_t)wgpuBufferGetSize(buffer));
+    flecs_engine_gpu_memory.buffer_count --;
+    wgpuBufferRelease(buffer);
+}
+
+int64_t flecsEngine_gpuMemory_textureBytes(
+    WGPUTextureFormat format,
+    WGPUTextureDimension dimension,
+    uint32_t width,
+    uint32_t height,
+    uint32_t depth_or_layers,
+    uint32_t mip_count,
+    uint32_t sample_count)
+{
+    int64_t bytes = 0;
+    for (uint32_t m = 0; m < (mip_count ? mip_count : 1); m ++) {
+        uint32_t w = width >> m ? width >> m : 1;
+        uint32_t h = height >> m ? height >> m : 1;
+        uint32_t d = depth_or_layers;
+
+        /* Layers of 2D arrays and cubemaps don't shrink with the mip level,
+         * the depth of 3D textures does. */
+        if (dimension == WGPUTextureDimension_3D) {
+            d = depth_or_layers >> m ? depth_or_layers >> m : 1;
+        }
+
+        bytes += flecsEngine_textureBytes(format, w, h) * (int64_t)(d ? d : 1);
+    }
+
+    return bytes * (int64_t)(sample_count ? sample_count : 1);
+}
+
+WGPUTexture flecsEngine_gpuMemory_createTexture(
+    WGPUDevice device,
+    flecs_engine_gpu_memory_category_t category,
+    const WGPUTextureDescriptor *desc)
+{
+    WGPUTexture texture = wgpuDeviceCreateTexture(device, desc);
+    if (texture) {
+        flecsEngine_gpuMemory_add(category,
+            flecsEngine_gpuMemory_textureBytes(desc->format, desc->dimension,
+                desc->size.width, desc->size.height,
+                desc->size.depthOrArrayLayers, desc->mipLevelCount,
+                desc->sampleCount));
+        flecs_engine_gpu_memory.texture_count ++;
+    }
+    return texture;
+}
+
+void flecsEngine_gpuMemory_releaseTexture(
+    flecs_engine_gpu_memory_category_t category,
+    WGPUTexture texture)
+{
+    if (!texture) {
+        return;
+    }
+
+    /* The size is computed from the texture, so that callers don't have to
+     * keep the descriptor around */
+    flecsEngine_gpuMemory_add(category,
+        -flecsEngine_gpuMemory_textureBytes(
+            wgpuTextureGetFormat(texture),
+            wgpuTextureGetDimension(texture),
+            wgpuTextureGetWidth(texture),
+            wgpuTextureGetHeight(texture),
+            wgpuTextureGetDepthOrArrayLayers(texture),
+            wgpuTextureGetMipLevelCount(texture),
+            wgpuTextureGetSampleCount(texture)));
+    flecs_engine_gpu_memory.texture_count --;
+    wgpuTextureRelease(texture);
+}
+
+void flecsEngine_gpuMemory_publishStats(
+    ecs_world_t *world)
+{
+    flecs_engine_gpu_memory_t *memory = &flecs_engine_gpu_memory;
+    const int64_t *bytes = memory->bytes;
+
+    /* Zeroed so that padding doesn't break the comparison below */
+    FlecsGpuMemory stats;
+    ecs_os_zeromem(&stats);
+    stats.mesh = bytes[FlecsGpuMemoryMesh];
+    stats.texture = bytes[FlecsGpuMemoryTexture];
+    stats.ibl = bytes[FlecsGpuMemoryIbl];
+    stats.shadow = bytes[FlecsGpuMemoryShadow];
+    stats.render_target = bytes[FlecsGpuMemoryRenderTarget];
+    stats.effect = bytes[FlecsGpuMemoryEffect];
+    stats.instance = bytes[FlecsGpuMemoryInstance];
+    stats.uniform = bytes[FlecsGpuMemoryUniform];
+    stats.other = bytes[FlecsGpuMemoryOther];
+    stats.total = memory->total;
+    stats.peak_total = memory->peak_total;
+    stats.buffer_count = memory->buffer_count;
+    stats.texture_count = memory->texture_count;
+
+    /* Notify the application when the budget is crossed, not every frame
+     * that the engine stays over it. */
+    const FlecsGpuMemoryBudget *budget = ecs_singleton_get(
+        world, FlecsGpuMemoryBudget);
+    stats.over_budget = budget && budget->budget > 0 &&
+        stats.total > budget->budget;
+    if (stats.over_budget && !memory->over_budget) {
+        ecs_warn("GPU memory budget exceeded (%.1f MB of %.1f MB)",
+            (double)stats.total / (1024.0 * 1024.0),
+            (double)budget->budget / (1024.0 * 1024.0));
+        if (budget->callback) {
+            budget->callback(world, &stats, budget->ctx);
+        }
+    }
+    memory->over_budget = stats.over_budget;
+
+    const FlecsGpuMemory *prev = ecs_singleton_get(world, FlecsGpuMemory);
+    if (prev && !memcmp(prev, &stats, sizeof(stats))) {
+        return;
+    }
+
+    ecs_singleton_set_ptr(world, FlecsGpuMemory, &stats);
+}
+
+void flecsEngine_gpuMemory_register(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, FlecsGpuMemory);
+    ECS_COMPONENT_DEFINE(world, FlecsGpuMemoryBudget);
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsGpuMemory),
+        .members = {
+            { .name = "mesh", .type = ecs_id(ecs_i64_t) },
+            { .name = "texture", .type = ecs_id(ecs_i64_t) },
+            { .name = "ibl", .type = ecs_id(ecs_i64_t) },
+            { .name = "shadow", .type = ecs_id(ecs_i64_t) },
+            { .name = "render_target", .type = ecs_id(ecs_i64_t) },
+            { .name = "effect", .type = ecs_id(ecs_i64_t) },
+            { .name = "instance", .type = ecs_id(ecs_i64_t) },
+            { .name = "uniform", .type = ecs_id(ecs_i64_t) },
+            { .name = "other", .type = ecs_id(ecs_i64_t) },
+            { .name = "total", .type = ecs_id(ecs_i64_t) },
+            { .name = "peak_total", .type = ecs_id(ecs_i64_t) },
+            { .name = "buffer_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "texture_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "over_budget", .type = ecs_id(ecs_bool_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(FlecsGpuMemory), EcsSingleton);
+
+    /* The callback and its context aren't reflected */
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsGpuMemoryBudget),
+        .members = {
+            { .name = "budget", .type = ecs_id(ecs_i64_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(FlecsGpuMemoryBudget), EcsSingleton);
+}
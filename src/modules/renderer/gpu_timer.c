@@ -0,0 +1,528 @@
+#include "renderer.h"
+#include "flecs_engine.h"
+
+ECS_COMPONENT_DECLARE(FlecsGpuTiming);
+ECS_COMPONENT_DECLARE(FlecsGpuPassTime);
+ECS_COMPONENT_DECLARE(FlecsRenderViewGpuTime);
+
+/* Passes that can be timed in a frame, across all views */
+#define FLECS_ENGINE_GPU_TIMER_SCOPE_MAX (64)
+#define FLECS_ENGINE_GPU_TIMER_QUERY_MAX (FLECS_ENGINE_GPU_TIMER_SCOPE_MAX * 2)
+
+/* Frames whose timestamps can be waiting for readback. The GPU finishes a
+ * frame up to frames in flight later, and its buffer is mapped after that. */
+#define FLECS_ENGINE_GPU_TIMER_READBACK_COUNT (FLECS_ENGINE_FRAMES_IN_FLIGHT_MAX + 2)
+
+typedef enum {
+    FlecsGpuReadbackFree,
+    FlecsGpuReadbackRecorded, /* Resolve is recorded in the frame commands */
+    FlecsGpuReadbackMapping,
+    FlecsGpuReadbackMapped
+} flecs_engine_gpu_readback_state_t;
+
+/* Pass of a frame that timestamps are written for */
+typedef struct {
+    ecs_entity_t view;
+    ecs_entity_t effect;
+    const char *name;
+    flecs_engine_gpu_stage_t stage;
+} flecs_engine_gpu_scope_t;
+
+/* Copy of the timestamps of a single frame. Map callbacks write the state,
+ * so readbacks don't move while a map is pending. */
+typedef struct {
+    WGPUBuffer buffer;
+    flecs_engine_gpu_scope_t scopes[FLECS_ENGINE_GPU_TIMER_SCOPE_MAX];
+    int32_t scope_count;
+    int64_t frame;
+    flecs_engine_gpu_readback_state_t state;
+    bool map_done;
+    bool map_ok;
+} flecs_engine_gpu_readback_t;
+
+struct flecs_engine_gpu_timer_t {
+    WGPUInstance instance;
+    WGPUQuerySet query_set;
+    WGPUBuffer resolve_buffer;
+    flecs_engine_gpu_readback_t readbacks[FLECS_ENGINE_GPU_TIMER_READBACK_COUNT];
+    /* Timestamp writes of the passes recorded in the current frame. Pass
+     * descriptors point into this array until the frame is recorded. */
+    WGPUPassTimestampWrites writes[FLECS_ENGINE_GPU_TIMER_SCOPE_MAX];
+    int32_t current; /* Readback of the frame being recorded, -1 if none */
+    ecs_entity_t view;
+    int64_t frame_count;
+};
+
+ECS_CTOR(FlecsRenderViewGpuTime, ptr, {
+    ecs_os_zeromem(ptr);
+    ecs_vec_init_t(NULL, &ptr->passes, FlecsGpuPassTime, 0);
+})
+
+ECS_MOVE(FlecsRenderViewGpuTime, dst, src, {
+    ecs_vec_fini_t(NULL, &dst->passes, FlecsGpuPassTime);
+    *dst = *src;
+    ecs_os_zeromem(src);
+})
+
+ECS_COPY(FlecsRenderViewGpuTime, dst, src, {
+    ecs_vec_fini_t(NULL, &dst->passes, FlecsGpuPassTime);
+    *dst = *src;
+    dst->passes = ecs_vec_copy_t(NULL, &src->passes, FlecsGpuPassTime);
+})
+
+ECS_DTOR(FlecsRenderViewGpuTime, ptr, {
+    ecs_vec_fini_t(NULL, &ptr->passes, FlecsGpuPassTime);
+})
+
+flecs_engine_gpu_timer_t* flecsEngine_gpuTimer_create(
+    const FlecsEngineImpl *engine)
+{
+    if (!flecsEngine_hasTimestampQuery(engine->device)) {
+        return NULL;
+    }
+
+    flecs_engine_gpu_timer_t *timer = ecs_os_calloc_t(flecs_engine_gpu_timer_t);
+    timer->instance = engine->instance;
+    timer->current = -1;
+
+    timer->query_set = wgpuDeviceCreateQuerySet(engine->device,
+        &(WGPUQuerySetDescriptor){
+            .type = WGPUQueryType_Timestamp,
+            .count = FLECS_ENGINE_GPU_TIMER_QUERY_MAX
+        });
+
+    uint64_t size = FLECS_ENGINE_GPU_TIMER_QUERY_MAX * sizeof(uint64_t);
+    timer->resolve_buffer = flecsEngine_gpuMemory_createBuffer(engine->device,
+        FlecsGpuMemoryOther, &(WGPUBufferDescriptor){
+            .usage = WGPUBufferUsage_QueryResolve | WGPUBufferUsage_CopySrc,
+            .size = size
+        });
+
+    bool ok = timer->query_set && timer->resolve_buffer;
+    for (int32_t i = 0; ok && i < FLECS_ENGINE_GPU_TIMER_READBACK_COUNT; i ++) {
+        timer->readbacks[i].buffer = flecsEngine_gpuMemory_createBuffer(
+            engine->device, FlecsGpuMemoryOther, &(WGPUBufferDescriptor){
+                .usage = WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst,
+                .size = size
+            });
+        ok = timer->readbacks[i].buffer != NULL;
+    }
+
+    if (!ok) {
+        ecs_warn("gpu timer: failed to create timestamp queries");
+        flecsEngine_gpuTimer_free(timer);
+        return NULL;
+    }
+
+    return timer;
+}
+
+void flecsEngine_gpuTimer_free(
+    flecs_engine_gpu_timer_t *timer)
+{
+    if (!timer) {
+        return;
+    }
+
+    for (int32_t i = 0; i < FLECS_ENGINE_GPU_TIMER_READBACK_COUNT; i ++) {
+        flecs_engine_gpu_readback_t *rb = &timer->readbacks[i];
+
+        /* The map callback writes to the readback */
+        if (rb->state == FlecsGpuReadbackMapping) {
+            flecsEngine_processEventsUntilDone(timer->instance, &rb->map_done);
+            rb->state = rb->map_ok
+                ? FlecsGpuReadbackMapped
+                : FlecsGpuReadbackFree;
+        }
+
+        if (rb->buffer) {
+            if (rb->state == FlecsGpuReadbackMapped) {
+                wgpuBufferUnmap(rb->buffer);
+            }
+            flecsEngine_gpuMemory_releaseBuffer(
+                FlecsGpuMemoryOther, rb->buffer);
+        }
+    }
+
+    flecsEngine_gpuMemory_releaseBuffer(
+        FlecsGpuMemoryOther, timer->resolve_buffer);
+
+    if (timer->query_set) {
+        wgpuQuerySetRelease(timer->query_set);
+    }
+
+    ecs_os_free(timer);
+}
+
+static void flecsEngine_gpuTimer_onMap(
+    WGPUMapAsyncStatus status,
+    const char *message,
+    void *userdata)
+{
+    (void)message;
+    flecs_engine_gpu_readback_t *rb = userdata;
+    rb->map_ok = status == WGPUMapAsyncStatus_Success;
+    rb->map_done = true;
+}
+
+static void flecsEngine_gpuTimer_publishReadback(
+    ecs_world_t *world,
+    flecs_engine_gpu_readback_t *rb)
+{
+    size_t size = (size_t)rb->scope_count * 2 * sizeof(uint64_t);
+    const uint64_t *ticks = wgpuBufferGetConstMappedRange(rb->buffer, 0, size);
+    if (!ticks) {
+        return;
+    }
+
+    FlecsRenderViewGpuTime result = {0};
+    ecs_vec_init_t(NULL, &result.passes, FlecsGpuPassTime, 0);
+
+    /* Scopes of a view are reserved while the view is rendered, so they're
+     * adjacent in the readback. */
+    int32_t i = 0;
+    while (i < rb->scope_count) {
+        ecs_entity_t view = rb->scopes[i].view;
+
+        ecs_vec_clear(&result.passes);
+        result.shadow_time = 0;
+        result.batch_time = 0;
+        result.effect_time = 0;
+        result.total_time = 0;
+        result.frame = rb->frame;
+
+        for (; i < rb->scope_count && rb->scopes[i].view == view; i ++) {
+            const flecs_engine_gpu_scope_t *scope = &rb->scopes[i];
+            uint64_t begin = ticks[i * 2], end = ticks[i * 2 + 1];
+
+            /* Passes that weren't encoded, e.g. when an effect failed */
+            if (!begin || end < begin) {
+                continue;
+            }
+
+            /* Resolved timestamps are in nanoseconds */
+            float time = (float)((double)(end - begin) * 1e-9);
+
+            FlecsGpuPassTime *pass = ecs_vec_append_t(
+                NULL, &result.passes, FlecsGpuPassTime);
+            pass->name = scope->name;
+            pass->effect = scope->effect;
+            pass->time = time;
+
+            if (scope->stage == FlecsGpuStageShadow) {
+                result.shadow_time += time;
+            } else if (scope->stage == FlecsGpuStageBatches) {
+                result.batch_time += time;
+            } else {
+                result.effect_time += time;
+            }
+            result.total_time += time;
+        }
+
+        if (view && ecs_is_alive(world, view)) {
+            ecs_set_ptr(world, view, FlecsRenderViewGpuTime, &result);
+        }
+    }
+
+    ecs_vec_fini_t(NULL, &result.passes, FlecsGpuPassTime);
+}
+
+void flecsEngine_gpuTimer_beginFrame(
+    ecs_world_t *world,
+    FlecsEngineImpl *engine)
+{
+    flecs_engine_gpu_timer_t *timer = engine->gpu_timer;
+    if (!timer) {
+        return;
+    }
+
+    timer->current = -1;
+    timer->view = 0;
+
+    bool pending = false;
+    for (int32_t i = 0; i < FLECS_ENGINE_GPU_TIMER_READBACK_COUNT; i ++) {
+        flecs_engine_gpu_readback_t *rb = &timer->readbacks[i];
+
+        /* The frame that recorded the resolve has been submitted by now, so
+         * its buffer can be mapped. */
+        if (rb->state == FlecsGpuReadbackRecorded) {
+            rb->state = FlecsGpuReadbackMapping;
+            rb->map_done = false;
+            rb->map_ok = false;
+            flecsEngine_bufferMapAsync(rb->buffer, WGPUMapMode_Read, 0,
+                FLECS_ENGINE_GPU_TIMER_QUERY_MAX * sizeof(uint64_t),
+                flecsEngine_gpuTimer_onMap, rb);
+        }
+
+        if (rb->state == FlecsGpuReadbackMapping) {
+            pending = true;
+        }
+    }
+
+    /* Don't wait for the GPU, maps that aren't done are read next frame */
+    if (pending) {
+        flecsEngine_processEvents(engine->instance);
+    }
+
+    /* Publish oldest frames first, so views end up with the latest timings */
+    for (;;) {
+        flecs_engine_gpu_readback_t *oldest = NULL;
+        for (int32_t i = 0; i < FLECS_ENGINE_GPU_TIMER_READBACK_COUNT; i ++) {
+            flecs_engine_gpu_readback_t *rb = &timer->readbacks[i];
+            if (rb->state == FlecsGpuReadbackMapping && rb->map_done) {
+                rb->state = rb->map_ok
+                    ? FlecsGpuReadbackMapped
+                    : FlecsGpuReadbackFree;
+            }
+            if (rb->state == FlecsGpuReadbackMapped &&
+                (!oldest || rb->frame < oldest->frame))
+            {
+                oldest = rb;
+            }
+        }
+
+        if (!oldest) {
+            break;
+        }
+
+        flecsEngine_gpuTimer_publishReadback(world, oldest);
+        wgpuBufferUnmap(oldest->buffer);
+        oldest->state = FlecsGpuReadbackFree;
+    }
+
+    const FlecsGpuTiming *settings = ecs_singleton_get(world, FlecsGpuTiming);
+    if (!settings || !settings->enabled) {
+        return;
+    }
+
+    /* Skip timing the frame if all readbacks are still in use */
+    for (int32_t i = 0; i < FLECS_ENGINE_GPU_TIMER_READBACK_COUNT; i ++) {
+        flecs_engine_gpu_readback_t *rb = &timer->readbacks[i];
+        if (rb->state == FlecsGpuReadbackFree) {
+            rb->scope_count = 0;
+            rb->frame = timer->frame_count;
+            timer->current = i;
+            break;
+        }
+    }
+
+    timer->frame_count ++;
+}
+
+void flecsEngine_gpuTimer_setView(
+    const FlecsEngineImpl *engine,
+    ecs_entity_t view)
+{
+    if (engine->gpu_timer) {
+        engine->gpu_timer->view = view;
+    }
+}
+
+static int32_t flecsEngine_gpuTimer_reserve(
+    const FlecsEngineImpl *engine,
+    flecs_engine_gpu_stage_t stage,
+    const char *name,
+    ecs_entity_t effect)
+{
+    flecs_engine_gpu_timer_t *timer = engine->gpu_timer;
+    if (!timer || timer->current < 0) {
+        return -1;
+    }
+
+    flecs_engine_gpu_readback_t *rb = &timer->readbacks[timer->current];
+    if (rb->scope_count == FLECS_ENGINE_GPU_TIMER_SCOPE_MAX) {
+        return -1;
+    }
+
+    int32_t index = rb->scope_count ++;
+    rb->scopes[index] = (flecs_engine_gpu_scope_t){
+        .view = timer->view,
+        .effect = effect,
+        .name = name,
+        .stage = stage
+    };
+
+    return index;
+}
+
+const WGPUPassTimestampWrites* flecsEngine_gpuTimer_pass(
+    const FlecsEngineImpl *engine,
+    flecs_engine_gpu_stage_t stage,
+    const char *name)
+{
+    int32_t index = flecsEngine_gpuTimer_reserve(engine, stage, name, 0);
+    if (index < 0) {
+        return NULL;
+    }
+
+    flecs_engine_gpu_timer_t *timer = engine->gpu_timer;
+    timer->writes[index] = (WGPUPassTimestampWrites){
+        .querySet = timer->query_set,
+        .beginningOfPassWriteIndex = (uint32_t)index * 2,
+        .endOfPassWriteIndex = (uint32_t)index * 2 + 1
+    };
+
+    return &timer->writes[index];
+}
+
+/* Write a timestamp between passes with an empty compute pass */
+static void flecsEngine_gpuTimer_writeMarker(
+    const flecs_engine_gpu_timer_t *timer,
+    WGPUCommandEncoder encoder,
+    uint32_t query)
+{
+#ifndef __EMSCRIPTEN__
+    WGPUPassTimestampWrites writes = {
+        .querySet = timer->query_set,
+        .beginningOfPassWriteIndex = query,
+        .endOfPassWriteIndex = WGPU_QUERY_SET_INDEX_UNDEFINED
+    };
+
+    WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(
+        encoder, &(WGPUComputePassDescriptor){
+            .timestampWrites = &writes
+        });
+    if (pass) {
+        wgpuComputePassEncoderEnd(pass);
+        wgpuComputePassEncoderRelease(pass);
+    }
+#else
+    (void)timer;
+    (void)encoder;
+    (void)query;
+#endif
+}
+
+int32_t flecsEngine_gpuTimer_begin(
+    const FlecsEngineImpl *engine,
+    WGPUCommandEncoder encoder,
+    flecs_engine_gpu_stage_t stage,
+    const char *name,
+    ecs_entity_t effect)
+{
+    int32_t index = flecsEngine_gpuTimer_reserve(engine, stage, name, effect);
+    if (index >= 0) {
+        flecsEngine_gpuTimer_writeMarker(
+            engine->gpu_timer, encoder, (uint32_t)index * 2);
+    }
+    return index;
+}
+
+void flecsEngine_gpuTimer_end(
+    const FlecsEngineImpl *engine,
+    WGPUCommandEncoder encoder,
+    int32_t scope)
+{
+    if (scope < 0 || !engine->gpu_timer) {
+        return;
+    }
+
+    flecsEngine_gpuTimer_writeMarker(
+        engine->gpu_timer, encoder, (uint32_t)scope * 2 + 1);
+}
+
+void flecsEngine_gpuTimer_endFrame(
+    FlecsEngineImpl *engine,
+    WGPUCommandEncoder encoder)
+{
+    flecs_engine_gpu_timer_t *timer = engine->gpu_timer;
+    if (!timer || timer->current < 0) {
+        return;
+    }
+
+    flecs_engine_gpu_readback_t *rb = &timer->readbacks[timer->current];
+    timer->current = -1;
+
+    if (!rb->scope_count) {
+        return;
+    }
+
+    /* Resolve into a shared buffer and copy out, so the query set and the
+     * resolve buffer can be reused by the next frame right away. */
+    uint32_t query_count = (uint32_t)rb->scope_count * 2;
+    uint64_t size = (uint64_t)query_count * sizeof(uint64_t);
+    wgpuCommandEncoderResolveQuerySet(encoder, timer->query_set, 0,
+        query_count, timer->resolve_buffer, 0);
+    wgpuCommandEncoderCopyBufferToBuffer(encoder, timer->resolve_buffer, 0,
+        rb->buffer, 0, size);
+
+    rb->state = FlecsGpuReadbackRecorded;
+}
+
+void flecsEngine_gpuTimer_discardFrame(
+    FlecsEngineImpl *engine)
+{
+    flecs_engine_gpu_timer_t *timer = engine->gpu_timer;
+    if (!timer) {
+        return;
+    }
+
+    /* The frame wasn't submitted, so its readback would stay empty. Readbacks
+     * of earlier frames are already mapping at this point. */
+    for (int32_t i = 0; i < FLECS_ENGINE_GPU_TIMER_READBACK_COUNT; i ++) {
+        flecs_engine_gpu_readback_t *rb = &timer->readbacks[i];
+        if (rb->state == FlecsGpuReadbackRecorded) {
+            rb->state = FlecsGpuReadbackFree;
+        }
+    }
+
+    timer->current = -1;
+}
+
+void flecsEngine_gpuTimer_register(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, FlecsGpuTiming);
+    ECS_COMPONENT_DEFINE(world, FlecsGpuPassTime);
+    ECS_COMPONENT_DEFINE(world, FlecsRenderViewGpuTime);
+
+    /* Pass names are static strings, explicit hooks keep them from being
+     * copied and freed like owned strings. */
+    ecs_set_hooks(world, FlecsGpuPassTime, {
+        .ctor = flecs_default_ctor
+    });
+
+    ecs_set_hooks(world, FlecsRenderViewGpuTime, {
+        .ctor = ecs_ctor(FlecsRenderViewGpuTime),
+        .move = ecs_move(FlecsRenderViewGpuTime),
+        .copy = ecs_copy(FlecsRenderViewGpuTime),
+        .dtor = ecs_dtor(FlecsRenderViewGpuTime)
+    });
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsGpuTiming),
+        .members = {
+            { .name = "enabled", .type = ecs_id(ecs_bool_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(FlecsGpuTiming), EcsSingleton);
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsGpuPassTime),
+        .members = {
+            { .name = "name", .type = ecs_id(ecs_string_t) },
+            { .name = "effect", .type = ecs_id(ecs_entity_t) },
+            { .name = "time", .type = ecs_id(ecs_f32_t) }
+        }
+    });
+
+    ecs_entity_t vec_pass_time = ecs_vector(world, {
+        .entity = ecs_entity(world, {
+            .name = "::flecs.engine.types.vecGpuPassTime",
+        }),
+        .type = ecs_id(FlecsGpuPassTime)
+    });
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsRenderViewGpuTime),
+        .members = {
+            { .name = "shadow_time", .type = ecs_id(ecs_f32_t) },
+            { .name = "batch_time", .type = ecs_id(ecs_f32_t) },
+            { .name = "effect_time", .type = ecs_id(ecs_f32_t) },
+            { .name = "total_time", .type = ecs_id(ecs_f32_t) },
+            { .name = "frame", .type = ecs_id(ecs_i64_t) },
+            { .name = "passes", .type = vec_pass_time }
+        }
+    });
+}
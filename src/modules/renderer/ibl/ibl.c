@@ -55,7 +55,10 @@ WGPUBindGroupLayout flecsEngine_ibl_ensureBindLayout(
      *   binding 5: Cluster info uniform
      *   binding 6: Cluster grid storage
      *   binding 7: Light indices storage
-     *   binding 8: Lights storage (unified point + spot) */
+     *   binding 8: Lights storage (unified point + spot)
+     *
+     * Cluster bindings use dynamic offsets to select the region of the
+     * view that is being rendered. */
     WGPUBindGroupLayoutEntry layout_entries[9] = {
         {
             .binding = 0,
@@ -103,6 +106,7 @@ WGPUBindGroupLayout flecsEngine_ibl_ensureBindLayout(
             .visibility = WGPUShaderStage_Fragment,
             .buffer = {
                 .type = WGPUBufferBindingType_Uniform,
+                .hasDynamicOffset = true,
                 .minBindingSize = sizeof(FlecsClusterInfo)
             }
         },
@@ -111,6 +115,7 @@ WGPUBindGroupLayout flecsEngine_ibl_ensureBindLayout(
             .visibility = WGPUShaderStage_Fragment,
             .buffer = {
                 .type = WGPUBufferBindingType_ReadOnlyStorage,
+                .hasDynamicOffset = true,
                 .minBindingSize = sizeof(FlecsClusterEntry)
             }
         },
@@ -119,6 +124,7 @@ WGPUBindGroupLayout flecsEngine_ibl_ensureBindLayout(
             .visibility = WGPUShaderStage_Fragment,
             .buffer = {
                 .type = WGPUBufferBindingType_ReadOnlyStorage,
+                .hasDynamicOffset = true,
                 .minBindingSize = sizeof(uint32_t)
             }
         },
@@ -166,8 +172,8 @@ bool flecsEngine_ibl_createRuntimeBindGroup(
         return false;
     }
 
-    ibl->ibl_shadow_bind_group = wgpuDeviceCreateBindGroup(
-        engine->device,
+    ibl->ibl_shadow_bind_group = flecsEngine_createBindGroup(
+        engine,
         &(WGPUBindGroupDescriptor){
             .layout = bind_layout,
             .entryCount = 9,
@@ -206,8 +212,7 @@ bool flecsEngine_ibl_createRuntimeBindGroup(
                 {
                     .binding = 7,
                     .buffer = engine->lighting.cluster_index_buffer,
-                    .size = (uint64_t)engine->lighting.cluster_index_capacity *
-                        sizeof(uint32_t)
+                    .size = engine->lighting.cluster_index_stride
                 },
                 {
                     .binding = 8,
@@ -246,7 +251,8 @@ void flecsEngine_ibl_releaseRuntimeResources(
     }
 
     if (ibl->ibl_brdf_lut_texture) {
-        wgpuTextureRelease(ibl->ibl_brdf_lut_texture);
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryIbl, ibl->ibl_brdf_lut_texture);
         ibl->ibl_brdf_lut_texture = NULL;
     }
 
@@ -256,7 +262,8 @@ void flecsEngine_ibl_releaseRuntimeResources(
     }
 
     if (ibl->ibl_prefiltered_cubemap) {
-        wgpuTextureRelease(ibl->ibl_prefiltered_cubemap);
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryIbl, ibl->ibl_prefiltered_cubemap);
         ibl->ibl_prefiltered_cubemap = NULL;
     }
 
@@ -266,7 +273,8 @@ void flecsEngine_ibl_releaseRuntimeResources(
     }
 
     if (ibl->ibl_equirect_texture) {
-        wgpuTextureRelease(ibl->ibl_equirect_texture);
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryIbl, ibl->ibl_equirect_texture);
         ibl->ibl_equirect_texture = NULL;
     }
 
@@ -303,14 +311,16 @@ static void FlecsIbl_on_set(
             it->world, it->entities[i], FlecsHdriImpl);
         flecsEngine_ibl_releaseRuntimeResources(ibl_impl);
 
-        if (!flecsEngine_ibl_initResources(
+        uint64_t trace_start = flecsEngine_trace_begin();
+        bool ibl_ok = flecsEngine_ibl_initResources(
             engine,
             ibl_impl,
             hdri[i].file,
             NULL, NULL, NULL, NULL,
             hdri[i].filter_sample_count,
-            hdri[i].lut_sample_count))
-        {
+            hdri[i].lut_sample_count);
+        flecsEngine_trace_end(trace_start, "asset", "ibl_build", hdri[i].file);
+        if (!ibl_ok) {
             ecs_err("failed to initialize IBL resources");
             continue;
         }
@@ -349,6 +359,8 @@ void flecsEngine_ibl_ensureSkyBackground(
     }
 
     flecsEngine_ibl_releaseRuntimeResources(ibl);
+
+    uint64_t trace_start = flecsEngine_trace_begin();
     flecsEngine_ibl_initResources(
         engine, ibl, NULL,
         &background->sky_color,
@@ -357,6 +369,7 @@ void flecsEngine_ibl_ensureSkyBackground(
         &background->horizon_color,
         hdri->filter_sample_count,
         hdri->lut_sample_count);
+    flecsEngine_trace_end(trace_start, "asset", "ibl_build", "sky background");
 }
 
 ecs_entity_t flecsEngine_createHdri(
@@ -362,8 +362,10 @@ static WGPURenderPipeline flecsIblCreatePipeline(
         .multisample = WGPU_MULTISAMPLE_DEFAULT
     };
 
+    uint64_t trace_start = flecsEngine_trace_begin();
     WGPURenderPipeline pipeline = wgpuDeviceCreateRenderPipeline(
         engine->device, &pipeline_desc);
+    flecsEngine_trace_end(trace_start, "pipeline", "render_pipeline", "ibl");
     wgpuPipelineLayoutRelease(pipeline_layout);
     return pipeline;
 }
@@ -440,7 +442,8 @@ static bool flecsIblCreateEquirectTexture(
         .sampleCount = 1
     };
 
-    ibl->ibl_equirect_texture = wgpuDeviceCreateTexture(engine->device, &desc);
+    ibl->ibl_equirect_texture = flecsEngine_gpuMemory_createTexture(
+        engine->device, FlecsGpuMemoryIbl, &desc);
     if (!ibl->ibl_equirect_texture) {
         return false;
     }
@@ -515,7 +518,8 @@ static bool flecsIblCreateCubeTexture(
         .sampleCount = 1
     };
 
-    *out_texture = wgpuDeviceCreateTexture(engine->device, &desc);
+    *out_texture = flecsEngine_gpuMemory_createTexture(
+        engine->device, FlecsGpuMemoryIbl, &desc);
     if (!*out_texture) {
         return false;
     }
@@ -545,7 +549,8 @@ static bool flecsIblCreateBrdfLutTexture(
         .sampleCount = 1
     };
 
-    ibl->ibl_brdf_lut_texture = wgpuDeviceCreateTexture(engine->device, &desc);
+    ibl->ibl_brdf_lut_texture = flecsEngine_gpuMemory_createTexture(
+        engine->device, FlecsGpuMemoryIbl, &desc);
     if (!ibl->ibl_brdf_lut_texture) {
         return false;
     }
@@ -707,8 +712,8 @@ static bool flecsIblRunPreprocessPasses(
         goto cleanup;
     }
 
-    prefilter_uniform_buffer = wgpuDeviceCreateBuffer(
-        engine->device,
+    prefilter_uniform_buffer = flecsEngine_gpuMemory_createBuffer(
+        engine->device, FlecsGpuMemoryIbl,
         &(WGPUBufferDescriptor){
             .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
             .size = sizeof(FlecsIblFaceUniform)
@@ -763,8 +768,8 @@ static bool flecsIblRunPreprocessPasses(
         goto cleanup;
     }
 
-    brdf_uniform_buffer = wgpuDeviceCreateBuffer(
-        engine->device,
+    brdf_uniform_buffer = flecsEngine_gpuMemory_createBuffer(
+        engine->device, FlecsGpuMemoryIbl,
         &(WGPUBufferDescriptor){
             .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
             .size = sizeof(FlecsIblBrdfUniform)
@@ -779,6 +784,13 @@ static bool flecsIblRunPreprocessPasses(
         ._padding1 = 0u,
         ._padding2 = 0u
     };
+
+    /* Passes are submitted one at a time and rewrite the same uniforms in
+     * between, so writes can't be staged until the next frame is submitted.
+     * They go to the queue directly, which the render thread must not be
+     * using at the same time. */
+    ecs_assert(flecsEngine_renderThread_idle(engine->render_thread),
+        ECS_INVALID_OPERATION, "IBL passes encoded while a frame is in flight");
     wgpuQueueWriteBuffer(
         engine->queue,
         brdf_uniform_buffer,
@@ -888,12 +900,10 @@ cleanup:
     if (brdf_bind_group) {
         wgpuBindGroupRelease(brdf_bind_group);
     }
-    if (prefilter_uniform_buffer) {
-        wgpuBufferRelease(prefilter_uniform_buffer);
-    }
-    if (brdf_uniform_buffer) {
-        wgpuBufferRelease(brdf_uniform_buffer);
-    }
+    flecsEngine_gpuMemory_releaseBuffer(
+        FlecsGpuMemoryIbl, prefilter_uniform_buffer);
+    flecsEngine_gpuMemory_releaseBuffer(
+        FlecsGpuMemoryIbl, brdf_uniform_buffer);
     if (prefilter_bind_layout) {
         wgpuBindGroupLayoutRelease(prefilter_bind_layout);
     }
@@ -923,6 +933,9 @@ bool flecsEngine_ibl_initResources(
 {
     flecsEngine_ibl_releaseRuntimeResources(ibl);
 
+    /* Textures are uploaded and preprocessed on the queue directly */
+    flecsEngine_renderThread_wait(engine->render_thread);
+
     if (!flecsEngine_ibl_ensureBindLayout(engine)) {
         return false;
     }
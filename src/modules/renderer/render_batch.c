@@ -29,7 +29,8 @@ static void flecsEngine_renderBatch_releaseImpl(
 {
     for (int32_t i = 0; i < FLECS_ENGINE_UNIFORMS_MAX; i ++) {
         if (ptr->uniform_buffers[i]) {
-            wgpuBufferRelease(ptr->uniform_buffers[i]);
+            flecsEngine_gpuMemory_releaseBuffer(
+                FlecsGpuMemoryUniform, ptr->uniform_buffers[i]);
             ptr->uniform_buffers[i] = NULL;
         }
     }
@@ -163,11 +164,9 @@ static bool flecsEngine_renderBatch_setupBindings(
 {
     WGPUBindGroupLayoutEntry layout_entries[FLECS_ENGINE_UNIFORMS_MAX + 1];
     WGPUBindGroupLayoutDescriptor bind_layout_desc = { .entries = layout_entries };
-    WGPUBindGroupEntry entries[FLECS_ENGINE_UNIFORMS_MAX];
 
     ecs_os_memset_n(
         layout_entries, 0, WGPUBindGroupLayoutEntry, FLECS_ENGINE_UNIFORMS_MAX + 1);
-    ecs_os_memset_n(entries, 0, WGPUBindGroupEntry, FLECS_ENGINE_UNIFORMS_MAX);
 
     impl->uniform_count = flecsEngine_renderBatch_uniformCount(uniform_types);
     if (!impl->uniform_count) {
@@ -185,18 +184,28 @@ static bool flecsEngine_renderBatch_setupBindings(
             .minBindingSize = type_size
         };
 
+        bind_layout_desc.entryCount = (uint32_t)b + 1;
+
+        /* FlecsUniform is shared by all batches of a view. It is read from
+         * the per-view uniform buffer with a dynamic offset. */
+        if (type == ecs_id(FlecsUniform)) {
+            ecs_assert(!impl->uses_view_uniforms, ECS_INVALID_PARAMETER,
+                "batch can only have one FlecsUniform binding");
+            layout_entries[b].buffer.hasDynamicOffset = true;
+            impl->uses_view_uniforms = true;
+            continue;
+        }
+
         WGPUBufferDescriptor uniform_desc = {
             .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
             .size = type_size
         };
 
-        entries[b].binding = b;
-        impl->uniform_buffers[b] = entries[b].buffer = 
-            wgpuDeviceCreateBuffer(
-                engine->device, &uniform_desc);
-        entries[b].size = type_size;
-
-        bind_layout_desc.entryCount = (uint32_t)b + 1;
+        impl->uniform_buffers[b] = flecsEngine_gpuMemory_createBuffer(
+            engine->device, FlecsGpuMemoryUniform, &uniform_desc);
+        if (!impl->uniform_buffers[b]) {
+            return false;
+        }
     }
 
     if (include_material_buffer) {
@@ -216,20 +225,6 @@ static bool flecsEngine_renderBatch_setupBindings(
         return false;
     }
 
-    if (!include_material_buffer) {
-        WGPUBindGroupDescriptor bind_group_desc = {
-            .entries = entries,
-            .entryCount = impl->uniform_count,
-            .layout = impl->bind_layout
-        };
-
-        impl->bind_group = wgpuDeviceCreateBindGroup(
-            engine->device, &bind_group_desc);
-        if (!impl->bind_group) {
-            return false;
-        }
-    }
-
     return true;
 }
 
@@ -284,8 +279,11 @@ static WGPURenderPipeline flecsEngine_renderBatch_createShadowPipeline(
         .multisample = WGPU_MULTISAMPLE_DEFAULT
     };
 
+    uint64_t trace_start = flecsEngine_trace_begin();
     WGPURenderPipeline pipeline = wgpuDeviceCreateRenderPipeline(
         engine->device, &pipeline_desc);
+    flecsEngine_trace_end(
+        trace_start, "pipeline", "render_pipeline", "batch_shadow");
     wgpuPipelineLayoutRelease(pipeline_layout);
 
     return pipeline;
@@ -399,8 +397,10 @@ static WGPURenderPipeline flecsEngine_renderBatch_createPipeline(
         pipeline_desc.primitive.cullMode = WGPUCullMode_None;
     }
 
+    uint64_t trace_start = flecsEngine_trace_begin();
     WGPURenderPipeline pipeline = wgpuDeviceCreateRenderPipeline(
         engine->device, &pipeline_desc);
+    flecsEngine_trace_end(trace_start, "pipeline", "render_pipeline", "batch");
     wgpuPipelineLayoutRelease(pipeline_layout);
 
     return pipeline;
@@ -454,6 +454,88 @@ static bool flecsEngine_renderBatch_validate(
     return true;
 }
 
+/* Replace the shader of a batch with a variant that compiles out features
+ * which the scene doesn't use, so that the batch doesn't bind their
+ * resources or run their code. Stores the features the batch depends on in
+ * impl, so that only batches that use a feature are rebuilt when the scene
+ * starts or stops using it. */
+static bool flecsEngine_renderBatch_selectVariant(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    ecs_entity_t shader_entity,
+    const FlecsShader **shader_out,
+    const FlecsShaderImpl **shader_impl_out,
+    FlecsRenderBatchImpl *impl)
+{
+    const FlecsShaderImpl *shader_impl = *shader_impl_out;
+
+    impl->feature_mask = 0;
+    if (shader_impl->uses_shadow) {
+        impl->feature_mask |= FLECS_ENGINE_BATCH_FEATURE_SHADOWS;
+    }
+    if (shader_impl->uses_cluster) {
+        impl->feature_mask |= FLECS_ENGINE_BATCH_FEATURE_CLUSTER_LIGHTS;
+    }
+
+    uint32_t features = engine->batch_features & impl->feature_mask;
+    impl->features = features;
+
+    ecs_strbuf_t buf = ECS_STRBUF_INIT;
+    if (shader_impl->uses_shadow &&
+        !(features & FLECS_ENGINE_BATCH_FEATURE_SHADOWS))
+    {
+        ecs_strbuf_appendstr(&buf, "FLECS_ENGINE_NO_SHADOWS ");
+    }
+    if (shader_impl->uses_cluster &&
+        !(features & FLECS_ENGINE_BATCH_FEATURE_CLUSTER_LIGHTS))
+    {
+        ecs_strbuf_appendstr(&buf, "FLECS_ENGINE_NO_CLUSTER_LIGHTS");
+    }
+
+    char *defines = ecs_strbuf_get(&buf);
+    if (!defines) {
+        return true;
+    }
+
+    ecs_entity_t variant = flecsEngine_shader_ensureVariant(
+        world, shader_entity, defines);
+    ecs_os_free(defines);
+    if (!variant) {
+        return false;
+    }
+
+    /* Creating the variant can move the base shader, get both again */
+    *shader_out = ecs_get(world, variant, FlecsShader);
+    *shader_impl_out = flecsEngine_shader_ensureImpl(world, variant);
+    return *shader_out && *shader_impl_out &&
+        (*shader_impl_out)->shader_module;
+}
+
+uint32_t flecsEngine_renderBatch_sceneFeatures(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine)
+{
+    uint32_t features = 0;
+
+    ecs_iter_t it = ecs_query_iter(world, engine->view_query);
+    while (ecs_query_next(&it)) {
+        const FlecsRenderView *views = ecs_field(&it, FlecsRenderView, 0);
+        for (int32_t i = 0; i < it.count; i ++) {
+            if (views[i].shadow.enabled) {
+                features |= FLECS_ENGINE_BATCH_FEATURE_SHADOWS;
+            }
+        }
+    }
+
+    if (ecs_query_is_true(engine->lighting.point_light_query) ||
+        ecs_query_is_true(engine->lighting.spot_light_query))
+    {
+        features |= FLECS_ENGINE_BATCH_FEATURE_CLUSTER_LIGHTS;
+    }
+
+    return features;
+}
+
 static void flecsEngine_renderBatch_setupShadowPipeline(
     ecs_world_t *world,
     const FlecsEngineImpl *engine,
@@ -528,6 +610,14 @@ static void FlecsRenderBatch_on_set(
             continue;
         }
 
+        if (!flecsEngine_renderBatch_selectVariant(
+            world, engine, rb[i].shader, &shader, &shader_impl, &impl))
+        {
+            flecsEngine_renderBatch_logErr(world, e,
+                "failed to compile shader variant for render batch %s");
+            continue;
+        }
+
         // Setup vertex attributes
         WGPUVertexAttribute vertex_attrs[16];
         int32_t vertex_attr_count = flecsEngine_vertexAttrFromType(
@@ -698,28 +788,38 @@ void flecsEngine_renderBatch_setupLight(
         flecsEngine_colorChannelToFloat(rgb.b) * light->intensity;
 }
 
-static bool flecsEngine_renderBatch_ensureMaterialBindings(
+/* Bind groups are created lazily, and are recreated when the per-view uniform
+ * buffer or the material buffer is reallocated. */
+static WGPUBindGroup flecsEngine_renderBatch_ensureBindGroup(
     const ecs_world_t *world,
     const FlecsEngineImpl *engine,
     const FlecsRenderBatch *batch,
     FlecsRenderBatchImpl *impl)
 {
-    if (!engine->materials.buffer || !engine->materials.count) {
-        return false;
+    uint64_t material_buffer_size = 0;
+    if (impl->uses_material) {
+        if (!engine->materials.buffer || !engine->materials.count) {
+            return NULL;
+        }
+
+        material_buffer_size =
+            (uint64_t)engine->materials.count * sizeof(FlecsGpuMaterial);
     }
 
-    uint64_t material_buffer_size =
-        (uint64_t)engine->materials.count * sizeof(FlecsGpuMaterial);
+    WGPUBindGroup *bind_group = impl->uses_material
+        ? &impl->bind_group_materials
+        : &impl->bind_group;
 
-    if (impl->bind_group_materials &&
+    if (*bind_group &&
+        impl->bind_version == engine->view_uniforms.version &&
         impl->material_buffer_size == material_buffer_size)
     {
-        return true;
+        return *bind_group;
     }
 
-    if (impl->bind_group_materials) {
-        wgpuBindGroupRelease(impl->bind_group_materials);
-        impl->bind_group_materials = NULL;
+    if (*bind_group) {
+        wgpuBindGroupRelease(*bind_group);
+        *bind_group = NULL;
     }
 
     WGPUBindGroupEntry entries[FLECS_ENGINE_UNIFORMS_MAX + 1] = {0};
@@ -729,102 +829,91 @@ static bool flecsEngine_renderBatch_ensureMaterialBindings(
             .buffer = impl->uniform_buffers[i],
             .size = flecsEngine_type_sizeof(world, batch->uniforms[i])
         };
+
+        if (!impl->uniform_buffers[i]) {
+            entries[i].buffer = engine->view_uniforms.buffer;
+        }
     }
 
-    uint32_t storage_binding = impl->uniform_count;
-    entries[storage_binding] = (WGPUBindGroupEntry){
-        .binding = storage_binding,
-        .buffer = engine->materials.buffer,
-        .size = material_buffer_size
-    };
+    uint32_t entry_count = impl->uniform_count;
+    if (impl->uses_material) {
+        entries[entry_count] = (WGPUBindGroupEntry){
+            .binding = entry_count,
+            .buffer = engine->materials.buffer,
+            .size = material_buffer_size
+        };
+        entry_count ++;
+    }
 
     WGPUBindGroupDescriptor bind_group_desc = {
         .entries = entries,
-        .entryCount = storage_binding + 1,
+        .entryCount = entry_count,
         .layout = impl->bind_layout
     };
 
-    impl->bind_group_materials = wgpuDeviceCreateBindGroup(
-        engine->device, &bind_group_desc);
-    if (!impl->bind_group_materials) {
+    *bind_group = flecsEngine_createBindGroup(
+        engine, &bind_group_desc);
+    if (!*bind_group) {
         impl->material_buffer_size = 0;
-        return false;
+        return NULL;
     }
 
+    impl->bind_version = engine->view_uniforms.version;
     impl->material_buffer_size = material_buffer_size;
-    return true;
+    return *bind_group;
 }
 
-static void flecsEngine_renderBatch_updateUniforms(
-    const ecs_world_t *world,
-    FlecsEngineImpl *engine,
-    const FlecsRenderView *view,
-    const FlecsRenderBatchImpl *impl)
+static FlecsHdriImpl* flecsEngine_renderBatch_ensureIbl(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    ecs_entity_t hdri)
 {
-    FlecsUniform uniforms = {0};
-    uniforms.camera_pos[3] = 1.0f;
-
-    if (view->camera) {
-        flecsEngine_renderBatch_setupCamera(world, &uniforms, view->camera);
-    }
-
-    if (view->light) {
-        flecsEngine_renderBatch_setupLight(world, &uniforms, view->light);
+    FlecsHdriImpl *ibl = ecs_get_mut(world, hdri, FlecsHdriImpl);
+    if (!ibl) {
+        return NULL;
     }
 
-    for (int i = 0; i < FLECS_ENGINE_SHADOW_CASCADE_COUNT; i++) {
-        glm_mat4_copy((vec4*)engine->shadow.current_light_vp[i], uniforms.light_vp[i]);
+    /* Recreate combined bind group if scene resources changed */
+    if (ibl->scene_bind_version != engine->scene_bind_version) {
+        flecsEngine_ibl_createRuntimeBindGroup(engine, ibl);
     }
 
-    memcpy(uniforms.cascade_splits, engine->shadow.cascade_splits,
-        sizeof(float) * FLECS_ENGINE_SHADOW_CASCADE_COUNT);
-
-    float bias = view->shadow.bias;
-    if (bias <= 0) { bias = 0.0005f; }
-    uniforms.shadow_info[1] = bias;
+    return ibl;
+}
 
-    /* Per-cascade scale factors: the fraction of the texture each cascade
-     * actually uses. Distant cascades render at reduced resolution. */
-    for (int i = 0; i < FLECS_ENGINE_SHADOW_CASCADE_COUNT; i++) {
-        uniforms.shadow_cascade_scales[i] = engine->shadow.map_size > 0
-            ? (float)engine->shadow.cascade_sizes[i] /
-              (float)engine->shadow.map_size
-            : 1.0f;
+bool flecsEngine_renderBatch_resolveIbl(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    const FlecsRenderView *view,
+    flecs_engine_view_ibl_t *out)
+{
+    ecs_entity_t hdri = view->hdri;
+    if (!hdri) {
+        hdri = engine->sky_background_hdri;
     }
 
-    uniforms.ambient_light[0] = flecsEngine_colorChannelToFloat(view->ambient_light.r);
-    uniforms.ambient_light[1] = flecsEngine_colorChannelToFloat(view->ambient_light.g);
-    uniforms.ambient_light[2] = flecsEngine_colorChannelToFloat(view->ambient_light.b);
-    uniforms.ambient_light[3] = view->background.ambient_intensity;
-
-    uniforms.sky_color[0] = flecsEngine_colorChannelToFloat(view->background.sky_color.r);
-    uniforms.sky_color[1] = flecsEngine_colorChannelToFloat(view->background.sky_color.g);
-    uniforms.sky_color[2] = flecsEngine_colorChannelToFloat(view->background.sky_color.b);
-    uniforms.sky_color[3] = flecsEngine_colorChannelToFloat(view->background.sky_color.a);
-
-    engine->camera_pos[0] = uniforms.camera_pos[0];
-    engine->camera_pos[1] = uniforms.camera_pos[1];
-    engine->camera_pos[2] = uniforms.camera_pos[2];
+    out->environment = flecsEngine_renderBatch_ensureIbl(world, engine, hdri);
+    out->ibl = out->environment;
+    if (view->background.ambient_intensity == 0) {
+        out->ibl = flecsEngine_renderBatch_ensureIbl(
+            world, engine, engine->black_hdri);
+    }
 
-    wgpuQueueWriteBuffer(
-        engine->queue,
-        impl->uniform_buffers[0],
-        0,
-        &uniforms,
-        sizeof(FlecsUniform));
+    return out->environment && out->ibl;
 }
 
 void flecsEngine_renderBatch_render(
     ecs_world_t *world,
     FlecsEngineImpl *engine,
     const WGPURenderPassEncoder pass,
-    const FlecsRenderView *view,
-    ecs_entity_t batch_entity)
+    flecs_engine_pass_state_t *state,
+    const flecs_engine_view_ibl_t *view_ibl,
+    flecs_engine_render_item_t *item)
 {
-    const FlecsRenderBatch *batch = ecs_get(
-        world, batch_entity, FlecsRenderBatch);
-    FlecsRenderBatchImpl *impl = ecs_get_mut(
-        world, batch_entity, FlecsRenderBatchImpl);
+    const FlecsRenderBatch *batch = ecs_ref_get(
+        world, &item->batch, FlecsRenderBatch);
+    FlecsRenderBatchImpl *impl = ecs_ref_get(
+        world, &item->impl, FlecsRenderBatchImpl);
     if (!batch || !impl) {
         return;
     }
@@ -832,58 +921,48 @@ void flecsEngine_renderBatch_render(
     WGPURenderPipeline pipeline = impl->pipeline_hdr;
     ecs_assert(pipeline != NULL, ECS_INTERNAL_ERROR, NULL);
 
-    if (pipeline != engine->last_pipeline) {
+    if (pipeline != state->last_pipeline) {
         wgpuRenderPassEncoderSetPipeline(pass, pipeline);
-        engine->last_pipeline = pipeline;
-        flecsEngine_renderBatch_updateUniforms(world, engine, view, impl);
+        flecsEngine_renderStats_pipelineSwitch(state);
+        state->last_pipeline = pipeline;
     }
 
-    WGPUBindGroup bind_group = impl->bind_group;
-    if (impl->uses_material) {
-        if (!flecsEngine_renderBatch_ensureMaterialBindings(
-            world, engine, batch, impl))
-        {
-            return;
-        }
-
-        bind_group = impl->bind_group_materials;
+    WGPUBindGroup bind_group = flecsEngine_renderBatch_ensureBindGroup(
+        world, engine, batch, impl);
+    if (!bind_group) {
+        return;
     }
 
-    wgpuRenderPassEncoderSetBindGroup(pass, 0, bind_group, 0, NULL);
+    /* Select the uniform block of the current view */
+    uint32_t view_offset = engine->view_uniforms.offset;
+    wgpuRenderPassEncoderSetBindGroup(pass, 0, bind_group,
+        impl->uses_view_uniforms ? 1 : 0,
+        impl->uses_view_uniforms ? &view_offset : NULL);
+    flecsEngine_renderStats_bindGroupSwitch(state);
 
     if (impl->uses_ibl || impl->uses_shadow || impl->uses_cluster) {
-        bool is_skybox = ecs_has(world, batch_entity, FlecsSkyboxBatch);
-        bool is_ground = ecs_has(world, batch_entity, FlecsGroundPlaneBatch);
-        ecs_entity_t hdri = view->hdri;
-        if (!hdri) {
-            hdri = engine->sky_background_hdri;
-        }
-        if (view->background.ambient_intensity == 0 && !is_skybox && !is_ground) {
-            hdri = engine->black_hdri;
-        }
-
-        FlecsHdriImpl *ibl = ecs_get_mut(world, hdri, FlecsHdriImpl);
-        ecs_assert(ibl != NULL, ECS_INTERNAL_ERROR, NULL);
-
-        /* Recreate combined bind group if scene resources changed */
-        if (ibl->scene_bind_version != engine->scene_bind_version) {
-            flecsEngine_ibl_createRuntimeBindGroup(engine, ibl);
-        }
+        const FlecsHdriImpl *ibl =
+            (item->is_skybox || item->is_ground_plane)
+                ? view_ibl->environment
+                : view_ibl->ibl;
 
+        /* Select the cluster regions of the current view */
         wgpuRenderPassEncoderSetBindGroup(
-            pass, 1, ibl->ibl_shadow_bind_group, 0, NULL);
+            pass, 1, ibl->ibl_shadow_bind_group,
+            3, engine->lighting.cluster_offsets);
+        flecsEngine_renderStats_bindGroupSwitch(state);
     }
 
-    batch->callback(world, engine, pass, batch);
+    batch->callback(world, engine, pass, state, batch);
 }
 
 void flecsEngine_renderBatch_extract(
     ecs_world_t *world,
     FlecsEngineImpl *engine,
-    ecs_entity_t batch_entity)
+    flecs_engine_render_item_t *item)
 {
-    const FlecsRenderBatch *batch = ecs_get(
-        world, batch_entity, FlecsRenderBatch);
+    const FlecsRenderBatch *batch = ecs_ref_get(
+        world, &item->batch, FlecsRenderBatch);
     if (!batch || !batch->extract_callback) {
         return;
     }
@@ -892,31 +971,28 @@ void flecsEngine_renderBatch_extract(
 }
 
 void flecsEngine_renderBatch_renderShadow(
-    ecs_world_t *world,
-    FlecsEngineImpl *engine,
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
     const WGPURenderPassEncoder pass,
-    ecs_entity_t batch_entity)
+    flecs_engine_pass_state_t *state,
+    const flecs_engine_shadow_caster_t *caster)
 {
-    const FlecsRenderBatch *batch = ecs_get(
-        world, batch_entity, FlecsRenderBatch);
-    const FlecsRenderBatchImpl *impl = ecs_get(
-        world, batch_entity, FlecsRenderBatchImpl);
-    if (!batch || !impl || !impl->pipeline_shadow || !impl->uses_shadow) {
-        return;
-    }
-
-    WGPURenderPipeline pipeline = impl->pipeline_shadow;
+    const FlecsRenderBatch *batch = caster->batch;
+    WGPURenderPipeline pipeline = caster->impl->pipeline_shadow;
 
-    if (pipeline != engine->last_pipeline) {
+    if (pipeline != state->last_pipeline) {
         wgpuRenderPassEncoderSetPipeline(pass, pipeline);
-        engine->last_pipeline = pipeline;
+        flecsEngine_renderStats_pipelineSwitch(state);
+        state->last_pipeline = pipeline;
     }
 
+    uint32_t vp_offset = engine->shadow.vp_offset +
+        (uint32_t)state->cascade * engine->shadow.vp_stride;
     wgpuRenderPassEncoderSetBindGroup(
-        pass, 0, engine->shadow.pass_bind_groups[engine->shadow.current_cascade],
-        0, NULL);
+        pass, 0, engine->shadow.pass_bind_group, 1, &vp_offset);
+    flecsEngine_renderStats_bindGroupSwitch(state);
 
-    batch->callback(world, engine, pass, batch);
+    batch->callback(world, engine, pass, state, batch);
 }
 
 void flecsEngine_renderBatch_register(
@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "renderer.h"
 #include "flecs_engine.h"
 
@@ -22,10 +24,12 @@ static WGPURenderPassEncoder flecsEngine_renderBatch_beginPass(
         .resolveTarget = msaa ? color_view : NULL,
         WGPU_DEPTH_SLICE
         .loadOp = color_load_op,
-        .storeOp = WGPUStoreOp_Store,
+        /* Only the resolved samples are read after the pass */
+        .storeOp = msaa ? WGPUStoreOp_Discard : WGPUStoreOp_Store,
         .clearValue = sky_color
     };
 
+    /* Depth is stored, it is read by the depth resolve and by effects */
     WGPURenderPassDepthStencilAttachment depth_attachment = {
         .view = msaa ? impl->depth.msaa_depth_texture_view : impl->depth.depth_texture_view,
         .depthLoadOp = WGPULoadOp_Clear,
@@ -41,97 +45,168 @@ static WGPURenderPassEncoder flecsEngine_renderBatch_beginPass(
     WGPURenderPassDescriptor pass_desc = {
         .colorAttachmentCount = 1,
         .colorAttachments = &color_attachment,
-        .depthStencilAttachment = &depth_attachment
+        .depthStencilAttachment = &depth_attachment,
+        .timestampWrites = flecsEngine_gpuTimer_pass(
+            impl, FlecsGpuStageBatches, "batches")
     };
 
     return wgpuCommandEncoderBeginRenderPass(encoder, &pass_desc);
 }
 
-typedef void (*flecsEngine_batchSetVisitor_t)(
-    ecs_world_t *world,
-    FlecsEngineImpl *engine,
-    ecs_entity_t batch_entity,
-    void *ctx);
-
-static void flecsEngine_renderBatch_visitSet(
+static void flecsEngine_renderList_appendSet(
     ecs_world_t *world,
-    FlecsEngineImpl *engine,
+    ecs_vec_t *list,
     const FlecsRenderBatchSet *batch_set,
-    flecsEngine_batchSetVisitor_t visitor,
-    void *ctx)
+    int32_t depth)
 {
+    /* Guard against batch sets that (indirectly) contain themselves */
+    if (depth > 16) {
+        ecs_err("render batch sets are nested too deep");
+        return;
+    }
+
     int32_t i, count = ecs_vec_count(&batch_set->batches);
     ecs_entity_t *batches = ecs_vec_first(&batch_set->batches);
 
     for (i = 0; i < count; i ++) {
         ecs_entity_t batch_entity = batches[i];
-        if (!batch_entity) {
+        if (!batch_entity || !ecs_is_alive(world, batch_entity)) {
             continue;
         }
 
         const FlecsRenderBatchSet *nested_batch_set = ecs_get(
             world, batch_entity, FlecsRenderBatchSet);
         if (nested_batch_set) {
-            flecsEngine_renderBatch_visitSet(
-                world, engine, nested_batch_set, visitor, ctx);
+            flecsEngine_renderList_appendSet(
+                world, list, nested_batch_set, depth + 1);
+            continue;
+        }
+
+        if (!ecs_has(world, batch_entity, FlecsRenderBatch)) {
             continue;
         }
 
-        visitor(world, engine, batch_entity, ctx);
+        flecs_engine_render_item_t *item = ecs_vec_append_t(
+            NULL, list, flecs_engine_render_item_t);
+        item->entity = batch_entity;
+        item->batch = ecs_ref_init(world, batch_entity, FlecsRenderBatch);
+        item->impl = ecs_ref_init(world, batch_entity, FlecsRenderBatchImpl);
+        item->is_skybox = ecs_has(world, batch_entity, FlecsSkyboxBatch);
+        item->is_ground_plane = ecs_has(world, batch_entity, FlecsGroundPlaneBatch);
     }
 }
 
-typedef struct {
-    const WGPURenderPassEncoder pass;
-    const FlecsRenderView *view;
-} flecsEngine_renderVisitorCtx_t;
-
-static void flecsEngine_renderBatch_renderVisitor(
+/* Flatten the batch set tree of a view into an array of batch references. The
+ * list is only rebuilt when an observer signals that batch sets or batches
+ * changed, so passes don't have to walk the tree every frame. */
+static ecs_vec_t* flecsEngine_renderView_ensureRenderList(
     ecs_world_t *world,
-    FlecsEngineImpl *engine,
-    ecs_entity_t batch_entity,
-    void *ctx)
+    ecs_entity_t view_entity,
+    const FlecsEngineImpl *engine,
+    FlecsRenderViewImpl *viewImpl)
 {
-    flecsEngine_renderVisitorCtx_t *render_ctx = ctx;
-    flecsEngine_renderBatch_render(
-        world, engine, render_ctx->pass, render_ctx->view, batch_entity);
-}
+    if (viewImpl->render_list_version == engine->render_list_version) {
+        return &viewImpl->render_list;
+    }
 
-static void flecsEngine_renderBatch_extractVisitor(
-    ecs_world_t *world,
-    FlecsEngineImpl *engine,
-    ecs_entity_t batch_entity,
-    void *ctx)
-{
-    (void)ctx;
-    flecsEngine_renderBatch_extract(world, engine, batch_entity);
-}
+    ecs_vec_clear(&viewImpl->render_list);
 
-static void flecsEngine_renderBatch_shadowVisitor(
-    ecs_world_t *world,
-    FlecsEngineImpl *engine,
-    ecs_entity_t batch_entity,
-    void *ctx)
-{
-    flecsEngine_renderVisitorCtx_t *render_ctx = ctx;
-    flecsEngine_renderBatch_renderShadow(
-        world, engine, render_ctx->pass, batch_entity);
+    const FlecsRenderBatchSet *batch_set = ecs_get(
+        world, view_entity, FlecsRenderBatchSet);
+    if (batch_set) {
+        flecsEngine_renderList_appendSet(
+            world, &viewImpl->render_list, batch_set, 0);
+    }
+
+    viewImpl->render_list_version = engine->render_list_version;
+    return &viewImpl->render_list;
 }
 
 void flecsEngine_renderView_extractBatches(
     ecs_world_t *world,
     ecs_entity_t view_entity,
     FlecsEngineImpl *engine,
-    const FlecsRenderView *view)
+    const FlecsRenderView *view,
+    FlecsRenderViewImpl *viewImpl)
 {
     (void)view;
 
-    const FlecsRenderBatchSet *batch_set = ecs_get(
-        world, view_entity, FlecsRenderBatchSet);
-    ecs_assert(batch_set != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_vec_t *list = flecsEngine_renderView_ensureRenderList(
+        world, view_entity, engine, viewImpl);
+
+    int32_t i, count = ecs_vec_count(list);
+    flecs_engine_render_item_t *items = ecs_vec_first(list);
+    for (i = 0; i < count; i ++) {
+        flecsEngine_renderBatch_extract(world, engine, &items[i]);
+    }
+}
+
+/* Encode a single shadow cascade into its own command buffer. Runs on a worker
+ * thread, so it only reads ECS data and the engine, and keeps its pass state
+ * (pipeline, cascade index, counters) in the cascade. The main pass may be
+ * encoded at the same time, so render callbacks must not write batch state. */
+static void flecsEngine_renderView_encodeShadowCascade(
+    void *ctx)
+{
+    flecs_engine_shadow_cascade_t *cascade = ctx;
+    const FlecsEngineImpl *engine = cascade->engine;
+    int32_t c = cascade->cascade;
+
+    WGPUCommandEncoderDescriptor encoder_desc = {0};
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(
+        engine->device, &encoder_desc);
+    if (!encoder) {
+        ecs_err("failed to create shadow cascade command encoder");
+        return;
+    }
+
+    /* Begin shadow depth-only render pass for this cascade layer */
+    WGPURenderPassDepthStencilAttachment depth_attachment = {
+        .view = engine->shadow.layer_views[c],
+        .depthLoadOp = WGPULoadOp_Clear,
+        .depthStoreOp = WGPUStoreOp_Store,
+        .depthClearValue = 1.0f,
+        .depthReadOnly = false,
+        .stencilLoadOp = WGPULoadOp_Undefined,
+        .stencilStoreOp = WGPUStoreOp_Undefined,
+        .stencilClearValue = 0,
+        .stencilReadOnly = true
+    };
 
-    flecsEngine_renderBatch_visitSet(
-        world, engine, batch_set, flecsEngine_renderBatch_extractVisitor, NULL);
+    WGPURenderPassDescriptor pass_desc = {
+        .colorAttachmentCount = 0,
+        .colorAttachments = NULL,
+        .depthStencilAttachment = &depth_attachment,
+        .timestampWrites = cascade->timestamp_writes
+    };
+
+    WGPURenderPassEncoder shadow_pass = wgpuCommandEncoderBeginRenderPass(
+        encoder, &pass_desc);
+
+    /* Restrict rendering to the cascade's effective resolution.
+     * Distant cascades use smaller viewports to reduce rasterization
+     * cost while the full-size texture layer stores their depth in
+     * the top-left sub-region. */
+    {
+        uint32_t cs = engine->shadow.cascade_sizes[c];
+        wgpuRenderPassEncoderSetViewport(
+            shadow_pass,
+            0.0f, 0.0f,
+            (float)cs, (float)cs,
+            0.0f, 1.0f);
+    }
+
+    for (int32_t i = 0; i < cascade->caster_count; i ++) {
+        flecsEngine_renderBatch_renderShadow(cascade->world, engine,
+            shadow_pass, &cascade->state, &cascade->casters[i]);
+    }
+
+    wgpuRenderPassEncoderEnd(shadow_pass);
+    wgpuRenderPassEncoderRelease(shadow_pass);
+
+    WGPUCommandBufferDescriptor cmd_desc = {0};
+    cascade->cmd = wgpuCommandEncoderFinish(encoder, &cmd_desc);
+    wgpuCommandEncoderRelease(encoder);
 }
 
 void flecsEngine_renderView_renderShadow(
@@ -139,17 +214,19 @@ void flecsEngine_renderView_renderShadow(
     ecs_entity_t view_entity,
     FlecsEngineImpl *engine,
     const FlecsRenderView *view,
-    WGPUCommandEncoder encoder)
+    FlecsRenderViewImpl *viewImpl,
+    flecs_engine_shadow_pass_t *shadow_pass)
 {
+    shadow_pass->job_count = 0;
+
     if (!engine->shadow.texture_view || !view->light) {
         return;
     }
 
-    const FlecsRenderBatchSet *batch_set = ecs_get(
-        world, view_entity, FlecsRenderBatchSet);
-    if (!batch_set) {
-        return;
-    }
+    ecs_vec_t *list = flecsEngine_renderView_ensureRenderList(
+        world, view_entity, engine, viewImpl);
+    int32_t i, count = ecs_vec_count(list);
+    flecs_engine_render_item_t *items = ecs_vec_first(list);
 
     /* Compute all cascade light VP matrices and split distances */
     flecsEngine_shadow_computeCascades(
@@ -158,78 +235,109 @@ void flecsEngine_renderView_renderShadow(
         view->shadow.max_range,
         engine->shadow.current_light_vp, engine->shadow.cascade_splits);
 
-    /* Upload all cascade VP matrices to their own buffers upfront.
-     * This must happen before encoding any render passes because
+    /* Upload all cascade VP matrices of this view in a single write to the
+     * view's slot. This must happen before encoding any render passes because
      * wgpuQueueWriteBuffer calls resolve before command buffer execution. */
+    uint8_t vp_data[FLECS_ENGINE_SHADOW_CASCADE_COUNT *
+        FLECS_ENGINE_UNIFORM_OFFSET_ALIGNMENT] = {0};
+    uint32_t vp_stride = engine->shadow.vp_stride;
+    ecs_assert(vp_stride <= FLECS_ENGINE_UNIFORM_OFFSET_ALIGNMENT,
+        ECS_INTERNAL_ERROR, NULL);
+
     for (int c = 0; c < FLECS_ENGINE_SHADOW_CASCADE_COUNT; c++) {
-        wgpuQueueWriteBuffer(
-            engine->queue,
-            engine->shadow.vp_buffers[c],
-            0,
-            engine->shadow.current_light_vp[c],
+        memcpy(&vp_data[c * vp_stride], engine->shadow.current_light_vp[c],
             sizeof(mat4));
     }
 
-    engine->shadow.in_pass = true;
+    engine->shadow.vp_offset = (uint32_t)engine->view_uniforms.slot *
+        FLECS_ENGINE_SHADOW_CASCADE_COUNT * vp_stride;
 
-    /* Render each cascade into its own texture array layer */
-    for (int c = 0; c < FLECS_ENGINE_SHADOW_CASCADE_COUNT; c++) {
-        if (!engine->shadow.layer_views[c]) {
+    flecsEngine_queueWriteBuffer(
+        engine,
+        engine->shadow.vp_buffer,
+        engine->shadow.vp_offset,
+        vp_data,
+        (size_t)vp_stride * FLECS_ENGINE_SHADOW_CASCADE_COUNT);
+    engine->view_uniforms.write_count ++;
+
+    /* Resolve batch refs here, cascade encoders may run on worker threads */
+    ecs_vec_t *casters = &engine->shadow.casters;
+    ecs_vec_clear(casters);
+    for (i = 0; i < count; i ++) {
+        const FlecsRenderBatch *batch = ecs_ref_get(
+            world, &items[i].batch, FlecsRenderBatch);
+        const FlecsRenderBatchImpl *impl = ecs_ref_get(
+            world, &items[i].impl, FlecsRenderBatchImpl);
+        if (!batch || !impl || !impl->pipeline_shadow || !impl->uses_shadow) {
             continue;
         }
 
-        engine->shadow.current_cascade = c;
-
-        /* Begin shadow depth-only render pass for this cascade layer */
-        WGPURenderPassDepthStencilAttachment depth_attachment = {
-            .view = engine->shadow.layer_views[c],
-            .depthLoadOp = WGPULoadOp_Clear,
-            .depthStoreOp = WGPUStoreOp_Store,
-            .depthClearValue = 1.0f,
-            .depthReadOnly = false,
-            .stencilLoadOp = WGPULoadOp_Undefined,
-            .stencilStoreOp = WGPUStoreOp_Undefined,
-            .stencilClearValue = 0,
-            .stencilReadOnly = true
-        };
+        flecs_engine_shadow_caster_t *caster = ecs_vec_append_t(
+            NULL, casters, flecs_engine_shadow_caster_t);
+        caster->batch = batch;
+        caster->impl = impl;
+    }
 
-        WGPURenderPassDescriptor pass_desc = {
-            .colorAttachmentCount = 0,
-            .colorAttachments = NULL,
-            .depthStencilAttachment = &depth_attachment
-        };
+    static const char *cascade_names[FLECS_ENGINE_SHADOW_CASCADE_COUNT] = {
+        "shadow_cascade_0", "shadow_cascade_1",
+        "shadow_cascade_2", "shadow_cascade_3"
+    };
 
-        WGPURenderPassEncoder shadow_pass = wgpuCommandEncoderBeginRenderPass(
-            encoder, &pass_desc);
-
-        /* Restrict rendering to the cascade's effective resolution.
-         * Distant cascades use smaller viewports to reduce rasterization
-         * cost while the full-size texture layer stores their depth in
-         * the top-left sub-region. */
-        {
-            uint32_t cs = engine->shadow.cascade_sizes[c];
-            wgpuRenderPassEncoderSetViewport(
-                shadow_pass,
-                0.0f, 0.0f,
-                (float)cs, (float)cs,
-                0.0f, 1.0f);
+    /* Render each cascade into its own texture array layer */
+    for (int c = 0; c < FLECS_ENGINE_SHADOW_CASCADE_COUNT; c++) {
+        if (!engine->shadow.layer_views[c]) {
+            continue;
         }
 
-        engine->last_pipeline = NULL;
-
-        flecsEngine_renderVisitorCtx_t shadow_ctx = {
-            .pass = shadow_pass
+        flecs_engine_shadow_cascade_t *cascade =
+            &shadow_pass->cascades[shadow_pass->job_count];
+        cascade->world = world;
+        cascade->engine = engine;
+        cascade->counters = (flecs_engine_render_counters_t){0};
+        cascade->state = (flecs_engine_pass_state_t){
+            .counters = engine->counters ? &cascade->counters : NULL,
+            .cascade = c,
+            .shadow_pass = true
+        };
+        cascade->casters = ecs_vec_first(casters);
+        cascade->caster_count = ecs_vec_count(casters);
+        cascade->cascade = c;
+        cascade->cmd = NULL;
+
+        /* Queries are reserved here, the timer isn't thread safe */
+        cascade->timestamp_writes = flecsEngine_gpuTimer_pass(
+            engine, FlecsGpuStageShadow, cascade_names[c]);
+
+        shadow_pass->jobs[shadow_pass->job_count] = (flecs_engine_encode_job_t){
+            .callback = flecsEngine_renderView_encodeShadowCascade,
+            .ctx = cascade
         };
+        shadow_pass->job_count ++;
+    }
 
-        flecsEngine_renderBatch_visitSet(
-            world, engine, batch_set,
-            flecsEngine_renderBatch_shadowVisitor, &shadow_ctx);
+    flecsEngine_encodePool_begin(
+        engine->encode_pool, shadow_pass->jobs, shadow_pass->job_count);
+}
 
-        wgpuRenderPassEncoderEnd(shadow_pass);
-        wgpuRenderPassEncoderRelease(shadow_pass);
+void flecsEngine_renderView_finishShadow(
+    FlecsEngineImpl *engine,
+    flecs_engine_shadow_pass_t *shadow_pass)
+{
+    flecsEngine_encodePool_end(
+        engine->encode_pool, shadow_pass->jobs, shadow_pass->job_count);
+
+    /* Submit in cascade order regardless of which thread finished first */
+    for (int32_t i = 0; i < shadow_pass->job_count; i ++) {
+        flecs_engine_shadow_cascade_t *cascade = &shadow_pass->cascades[i];
+        flecsEngine_renderStats_addCascade(
+            engine, cascade->cascade, &cascade->counters);
+        if (cascade->cmd) {
+            flecsEngine_frameCommands_append(engine, cascade->cmd);
+            cascade->cmd = NULL;
+        }
     }
 
-    engine->shadow.in_pass = false;
+    shadow_pass->job_count = 0;
 }
 
 void flecsEngine_renderView_renderBatches(
@@ -237,12 +345,18 @@ void flecsEngine_renderView_renderBatches(
     ecs_entity_t view_entity,
     FlecsEngineImpl *engine,
     const FlecsRenderView *view,
-    const FlecsRenderViewImpl *viewImpl,
+    FlecsRenderViewImpl *viewImpl,
     WGPUCommandEncoder encoder)
 {
-    const FlecsRenderBatchSet *batch_set = ecs_get(
-        world, view_entity, FlecsRenderBatchSet);
-    ecs_assert(batch_set != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_vec_t *list = flecsEngine_renderView_ensureRenderList(
+        world, view_entity, engine, viewImpl);
+
+    /* Resolve scene bind groups once for all batches of the view */
+    flecs_engine_view_ibl_t view_ibl;
+    bool has_ibl = flecsEngine_renderBatch_resolveIbl(
+        world, engine, view, &view_ibl);
+    ecs_assert(has_ibl, ECS_INTERNAL_ERROR, NULL);
+    (void)has_ibl;
 
     /* Batches always render into the first effect target. A passthrough
      * effect (or the user's effect chain) blits to the final view texture. */
@@ -255,18 +369,76 @@ void flecsEngine_renderView_renderBatches(
         batch_target,
         WGPULoadOp_Clear);
 
-    /* Always set pipeline/uniforms for first batch in view */
-    engine->last_pipeline = NULL;
+    flecsEngine_setRenderViewport(engine, batch_pass);
 
-    flecsEngine_renderVisitorCtx_t batch_ctx = {
-        .pass = batch_pass,
-        .view = view
-    };
+    /* Starts without a pipeline, so the first batch of the view sets it */
+    flecs_engine_pass_state_t state = { .counters = engine->counters };
 
-    flecsEngine_renderBatch_visitSet(
-        world, engine, batch_set,
-        flecsEngine_renderBatch_renderVisitor, &batch_ctx);
+    int32_t i, count = ecs_vec_count(list);
+    flecs_engine_render_item_t *items = ecs_vec_first(list);
+    for (i = 0; i < count; i ++) {
+        flecsEngine_renderBatch_render(
+            world, engine, batch_pass, &state, &view_ibl, &items[i]);
+    }
 
     wgpuRenderPassEncoderEnd(batch_pass);
     wgpuRenderPassEncoderRelease(batch_pass);
 }
+
+static void flecsEngine_renderList_invalidate(
+    ecs_iter_t *it)
+{
+    FlecsEngineImpl *engine = ecs_singleton_get_mut(
+        it->world, FlecsEngineImpl);
+    if (engine) {
+        engine->render_list_version ++;
+    }
+}
+
+void flecsEngine_batchSets_register(
+    ecs_world_t *world)
+{
+    ecs_entity_t renderer_module = ecs_lookup(world, "flecs.engine.renderer");
+
+    /* Any change to the batch set tree or to the set of batches invalidates
+     * the flattened render lists of all views. */
+    ecs_observer(world, {
+        .entity = ecs_entity(world, {
+            .parent = renderer_module,
+            .name = "RenderListOnBatchSet"
+        }),
+        .query.terms = {{ .id = ecs_id(FlecsRenderBatchSet) }},
+        .events = {EcsOnSet, EcsOnRemove},
+        .callback = flecsEngine_renderList_invalidate
+    });
+
+    ecs_observer(world, {
+        .entity = ecs_entity(world, {
+            .parent = renderer_module,
+            .name = "RenderListOnBatch"
+        }),
+        .query.terms = {{ .id = ecs_id(FlecsRenderBatch) }},
+        .events = {EcsOnSet, EcsOnRemove},
+        .callback = flecsEngine_renderList_invalidate
+    });
+
+    ecs_observer(world, {
+        .entity = ecs_entity(world, {
+            .parent = renderer_module,
+            .name = "RenderListOnSkyboxBatch"
+        }),
+        .query.terms = {{ .id = FlecsSkyboxBatch }},
+        .events = {EcsOnAdd, EcsOnRemove},
+        .callback = flecsEngine_renderList_invalidate
+    });
+
+    ecs_observer(world, {
+        .entity = ecs_entity(world, {
+            .parent = renderer_module,
+            .name = "RenderListOnGroundPlaneBatch"
+        }),
+        .query.terms = {{ .id = FlecsGroundPlaneBatch }},
+        .events = {EcsOnAdd, EcsOnRemove},
+        .callback = flecsEngine_renderList_invalidate
+    });
+}
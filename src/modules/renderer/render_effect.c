@@ -1,11 +1,15 @@
+#include <string.h>
+
 #include "renderer.h"
 #include "flecs_engine.h"
 
 static WGPURenderPipeline flecsEngine_renderEffect_createPipeline(
     const FlecsEngineImpl *engine,
-    const FlecsShader *shader,
-    const FlecsShaderImpl *shader_impl,
-    WGPUBindGroupLayout bind_layout,
+    WGPUShaderModule module,
+    const char *vertex_entry,
+    const char *fragment_entry,
+    const WGPUBindGroupLayout *bind_layouts,
+    uint32_t bind_layout_count,
     WGPUTextureFormat color_format);
 
 ECS_COMPONENT_DECLARE(FlecsRenderEffect);
@@ -43,6 +47,16 @@ static void flecsEngine_renderEffect_release(
         ptr->pipeline_hdr = NULL;
     }
 
+    for (int32_t i = 0; i < FLECS_ENGINE_EFFECT_PACKED_FORMAT_COUNT; i ++) {
+        if (ptr->pipeline_packed[i]) {
+            wgpuRenderPipelineRelease(ptr->pipeline_packed[i]);
+            ptr->pipeline_packed[i] = NULL;
+        }
+        ptr->packed_formats[i] = WGPUTextureFormat_Undefined;
+    }
+
+    flecsEngine_bindGroupCache_fini(&ptr->bind_groups);
+
     if (ptr->bind_layout) {
         wgpuBindGroupLayoutRelease(ptr->bind_layout);
         ptr->bind_layout = NULL;
@@ -98,23 +112,121 @@ static WGPURenderPassEncoder flecsEngine_renderEffect_beginPass(
         .colorAttachments = &color_attachment
     };
 
-    return wgpuCommandEncoderBeginRenderPass(encoder, &pass_desc);
+    WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(
+        encoder, &pass_desc);
+    if (pass) {
+        flecsEngine_setRenderViewport(impl, pass);
+    }
+
+    return pass;
 }
 
-void flecsEngine_renderEffect_render(
+void flecsEngine_setRenderViewport(
+    const FlecsEngineImpl *impl,
+    WGPURenderPassEncoder pass)
+{
+    wgpuRenderPassEncoderSetViewport(pass, 0.0f, 0.0f,
+        (float)impl->render_width, (float)impl->render_height,
+        0.0f, 1.0f);
+}
+
+bool flecsEngine_needsUpscale(
+    const FlecsEngineImpl *impl)
+{
+    return impl->render_width != impl->width ||
+        impl->render_height != impl->height;
+}
+
+int32_t flecsEngine_renderView_lastEffect(
+    const FlecsRenderView *view)
+{
+    int32_t effect_count = ecs_vec_count(&view->effects);
+    const flecs_render_view_effect_t *effects = ecs_vec_first(&view->effects);
+    for (int32_t i = effect_count - 1; i >= 0; i --) {
+        if (effects[i].enabled) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool flecsEngine_renderView_effectUpscales(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *impl,
+    const FlecsRenderView *view)
+{
+    if (!flecsEngine_needsUpscale(impl)) {
+        return false;
+    }
+
+    int32_t last = flecsEngine_renderView_lastEffect(view);
+    if (last < 0) {
+        return false;
+    }
+
+    const flecs_render_view_effect_t *effects = ecs_vec_first(&view->effects);
+    const FlecsRenderEffect *effect = ecs_get(
+        world, effects[last].effect, FlecsRenderEffect);
+    return effect && effect->upscale;
+}
+
+static WGPURenderPipeline flecsEngine_renderEffect_pipeline(
     const ecs_world_t *world,
     const FlecsEngineImpl *engine,
-    const WGPURenderPassEncoder pass,
-    ecs_entity_t effect_entity,
     const FlecsRenderEffect *effect,
-    const FlecsRenderEffectImpl *impl,
-    WGPUTextureView input_view,
-    WGPUTextureFormat output_format)
+    FlecsRenderEffectImpl *impl,
+    WGPUTextureFormat format)
 {
-    ecs_assert(effect != NULL, ECS_INVALID_PARAMETER, NULL);
-    ecs_assert(impl != NULL, ECS_INVALID_PARAMETER, NULL);
-    ecs_assert(input_view != NULL, ECS_INVALID_PARAMETER, NULL);
+    if (format == flecsEngine_getViewTargetFormat(engine)) {
+        return impl->pipeline_surface;
+    }
+
+    if (format == flecsEngine_getHdrFormat(engine)) {
+        return impl->pipeline_hdr;
+    }
+
+    int32_t i;
+    for (i = 0; i < FLECS_ENGINE_EFFECT_PACKED_FORMAT_COUNT; i ++) {
+        if (!impl->pipeline_packed[i]) {
+            break;
+        }
+        if (impl->packed_formats[i] == format) {
+            return impl->pipeline_packed[i];
+        }
+    }
+
+    if (i == FLECS_ENGINE_EFFECT_PACKED_FORMAT_COUNT) {
+        ecs_err("too many target formats for render effect");
+        return NULL;
+    }
+
+    const FlecsShader *shader = ecs_get(world, effect->shader, FlecsShader);
+    const FlecsShaderImpl *shader_impl = ecs_get(
+        world, effect->shader, FlecsShaderImpl);
+    if (!shader || !shader_impl || !shader_impl->shader_module) {
+        return NULL;
+    }
+
+    impl->pipeline_packed[i] = flecsEngine_renderEffect_createPipeline(
+        engine,
+        shader_impl->shader_module,
+        shader->vertex_entry,
+        shader->fragment_entry,
+        &impl->bind_layout,
+        1,
+        format);
+    impl->packed_formats[i] = format;
+    return impl->pipeline_packed[i];
+}
 
+static WGPUBindGroup flecsEngine_renderEffect_bindGroup(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    ecs_entity_t effect_entity,
+    const FlecsRenderEffect *effect,
+    FlecsRenderEffectImpl *impl,
+    WGPUTextureView input_view)
+{
     WGPUBindGroupEntry entries[8] = {
         { .binding = 0, .textureView = input_view },
         { .binding = 1, .sampler = impl->input_sampler }
@@ -135,27 +247,55 @@ void flecsEngine_renderEffect_render(
     ecs_assert(entry_count > 0, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(entry_count <= 8, ECS_INTERNAL_ERROR, NULL);
 
-    WGPUBindGroupDescriptor bind_group_desc = {
-        .layout = impl->bind_layout,
-        .entryCount = entry_count,
-        .entries = entries
-    };
+    /* Entries only reference the input view and resources owned by the effect,
+     * so the bind group can be reused until render targets are recreated. */
+    return flecsEngine_bindGroupCache_get(
+        engine, &impl->bind_groups, impl->bind_layout, entries, entry_count);
+}
 
-    WGPUBindGroup bind_group = wgpuDeviceCreateBindGroup(
-        engine->device, &bind_group_desc);
+void flecsEngine_renderEffect_render(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    const WGPURenderPassEncoder pass,
+    ecs_entity_t effect_entity,
+    const FlecsRenderEffect *effect,
+    FlecsRenderEffectImpl *impl,
+    WGPUTextureView input_view,
+    WGPUTextureFormat output_format)
+{
+    ecs_assert(effect != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(impl != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(input_view != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    WGPUBindGroup bind_group = flecsEngine_renderEffect_bindGroup(
+        world, engine, effect_entity, effect, impl, input_view);
     ecs_assert(bind_group != NULL, ECS_INTERNAL_ERROR, NULL);
 
-    WGPURenderPipeline pipeline =
-        output_format == flecsEngine_getViewTargetFormat(engine)
-            ? impl->pipeline_surface
-            : impl->pipeline_hdr;
+    WGPURenderPipeline pipeline = flecsEngine_renderEffect_pipeline(
+        world, engine, effect, impl, output_format);
     ecs_assert(pipeline != NULL, ECS_INTERNAL_ERROR, NULL);
 
     wgpuRenderPassEncoderSetPipeline(pass, pipeline);
     wgpuRenderPassEncoderSetBindGroup(pass, 0, bind_group, 0, NULL);
     wgpuRenderPassEncoderDraw(pass, 3, 1, 0, 0);
+}
 
-    wgpuBindGroupRelease(bind_group);
+static WGPUBindGroup flecsEngine_renderEffect_passthroughBindGroup(
+    const FlecsEngineImpl *engine,
+    FlecsRenderViewImpl *viewImpl,
+    WGPUTextureView input_view)
+{
+    WGPUBindGroupEntry entries[2] = {
+        { .binding = 0, .textureView = input_view },
+        { .binding = 1, .sampler = engine->depth.passthrough_sampler }
+    };
+
+    return flecsEngine_bindGroupCache_get(
+        engine,
+        &viewImpl->passthrough_bind_groups,
+        engine->depth.passthrough_bind_layout,
+        entries,
+        2);
 }
 
 /* Resolve the input index for an effect, scanning back past any disabled
@@ -174,6 +314,375 @@ static int32_t flecsEngine_resolveEffectInput(
     return 0;
 }
 
+static bool flecsEngine_renderEffect_isPointwise(
+    const ecs_world_t *world,
+    ecs_entity_t entity,
+    const FlecsRenderEffect *effect)
+{
+    if (!effect->pointwise || !effect->pointwise_fn) {
+        return false;
+    }
+
+    if (effect->render_callback || effect->jitter || effect->upscale) {
+        return false;
+    }
+
+    const FlecsRenderEffectImpl *impl = ecs_get(
+        world, entity, FlecsRenderEffectImpl);
+    return impl && impl->bind_layout;
+}
+
+/* Find the last effect of the run of pointwise effects that starts at first,
+ * which is rendered as a single pass. Each effect of the run must read the
+ * output of the previous one, and outputs inside the run may not be read by
+ * effects after it. Returns first if the effect isn't fused. */
+static int32_t flecsEngine_renderView_fusedRun(
+    const ecs_world_t *world,
+    const FlecsRenderView *view,
+    int32_t first)
+{
+    if (view->disable_effect_fusion) {
+        return first;
+    }
+
+    int32_t effect_count = ecs_vec_count(&view->effects);
+    const flecs_render_view_effect_t *effects = ecs_vec_first(&view->effects);
+
+    const FlecsRenderEffect *stages[FLECS_ENGINE_EFFECT_FUSION_MAX];
+    stages[0] = ecs_get(world, effects[first].effect, FlecsRenderEffect);
+    if (!stages[0] || !flecsEngine_renderEffect_isPointwise(
+        world, effects[first].effect, stages[0]))
+    {
+        return first;
+    }
+
+    int32_t i, s, stage_count = 1, last = first;
+    for (i = first + 1; i < effect_count; i ++) {
+        if (!effects[i].enabled) {
+            continue;
+        }
+
+        if (stage_count == FLECS_ENGINE_EFFECT_FUSION_MAX) {
+            break;
+        }
+
+        const FlecsRenderEffect *effect = ecs_get(
+            world, effects[i].effect, FlecsRenderEffect);
+        if (!effect || !flecsEngine_renderEffect_isPointwise(
+            world, effects[i].effect, effect))
+        {
+            break;
+        }
+
+        if (flecsEngine_resolveEffectInput(effects, effect->input) != last + 1) {
+            break;
+        }
+
+        /* Stages share a module, so the same stage can't be used twice */
+        for (s = 0; s < stage_count; s ++) {
+            if (stages[s]->pointwise == effect->pointwise) {
+                break;
+            }
+        }
+        if (s != stage_count) {
+            break;
+        }
+
+        stages[stage_count ++] = effect;
+        last = i;
+    }
+
+    for (i = last + 1; i < effect_count && last != first; i ++) {
+        if (!effects[i].enabled) {
+            continue;
+        }
+
+        const FlecsRenderEffect *effect = ecs_get(
+            world, effects[i].effect, FlecsRenderEffect);
+        if (!effect) {
+            continue;
+        }
+
+        /* Target t is the output of effect t - 1, end the run there */
+        int32_t input = flecsEngine_resolveEffectInput(effects, effect->input);
+        if (input > first && input <= last) {
+            last = input - 1;
+        }
+    }
+
+    return last;
+}
+
+/* Replace @group(0) in the stage with the group of the stage */
+static void flecsEngine_renderEffect_appendStage(
+    ecs_strbuf_t *buf,
+    const char *stage,
+    int32_t group)
+{
+    const char *token = "@group(0)";
+    ecs_size_t token_len = ecs_os_strlen(token);
+    const char *ptr = stage;
+    const char *match;
+
+    while ((match = strstr(ptr, token))) {
+        ecs_strbuf_appendstrn(buf, ptr, (int32_t)(match - ptr));
+        ecs_strbuf_append(buf, "@group(%d)", group);
+        ptr = match + token_len;
+    }
+
+    ecs_strbuf_appendstr(buf, ptr);
+}
+
+static WGPURenderPipeline flecsEngine_renderEffect_createFused(
+    ecs_world_t *world,
+    FlecsEngineImpl *engine,
+    const flecs_engine_fused_effect_t *fused)
+{
+    ecs_strbuf_t buf = ECS_STRBUF_INIT;
+    ecs_strbuf_appendstr(&buf, FLECS_ENGINE_FULLSCREEN_VS_WGSL
+        "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n"
+        "@group(0) @binding(1) var input_sampler : sampler;\n");
+
+    WGPUBindGroupLayout layouts[FLECS_ENGINE_EFFECT_FUSION_MAX + 1] = {
+        engine->depth.passthrough_bind_layout
+    };
+
+    int32_t s;
+    for (s = 0; s < fused->count; s ++) {
+        const FlecsRenderEffect *effect = ecs_get(
+            world, fused->effects[s], FlecsRenderEffect);
+        flecsEngine_renderEffect_appendStage(&buf, effect->pointwise, s + 1);
+        layouts[s + 1] = fused->layouts[s];
+    }
+
+    ecs_strbuf_appendstr(&buf,
+        "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n"
+        "  var color = textureSample(input_texture, input_sampler,\n"
+        "    fullscreen_uv(in.pos, textureDimensions(input_texture)));\n");
+    for (s = 0; s < fused->count; s ++) {
+        const FlecsRenderEffect *effect = ecs_get(
+            world, fused->effects[s], FlecsRenderEffect);
+        ecs_strbuf_append(&buf, "  color = %s(color, in.pos, in.uv);\n",
+            effect->pointwise_fn);
+    }
+    ecs_strbuf_appendstr(&buf, "  return color;\n}\n");
+
+    char *source = ecs_strbuf_get(&buf);
+    WGPUShaderModule module = flecsEngine_shaderCache_get(engine, source);
+    ecs_os_free(source);
+    if (!module) {
+        return NULL;
+    }
+
+    return flecsEngine_renderEffect_createPipeline(engine, module,
+        "vs_main", "fs_main", layouts, (uint32_t)fused->count + 1,
+        fused->format);
+}
+
+static WGPURenderPipeline flecsEngine_renderView_fusedPipeline(
+    ecs_world_t *world,
+    FlecsEngineImpl *engine,
+    FlecsRenderViewImpl *viewImpl,
+    const flecs_render_view_effect_t *effects,
+    int32_t first,
+    int32_t last,
+    WGPUTextureFormat format)
+{
+    flecs_engine_fused_effect_t key = { .format = format };
+    for (int32_t i = first; i <= last; i ++) {
+        if (!effects[i].enabled) {
+            continue;
+        }
+        const FlecsRenderEffectImpl *impl = ecs_get(
+            world, effects[i].effect, FlecsRenderEffectImpl);
+        key.effects[key.count] = effects[i].effect;
+        key.layouts[key.count] = impl->bind_layout;
+        key.count ++;
+    }
+
+    /* Layouts are part of the key, so pipelines of effects that were set up
+     * again are not reused. */
+    int32_t count = ecs_vec_count(&viewImpl->fused_effects);
+    flecs_engine_fused_effect_t *fused = ecs_vec_first(&viewImpl->fused_effects);
+    for (int32_t i = 0; i < count; i ++) {
+        if (fused[i].count == key.count && fused[i].format == key.format &&
+            !memcmp(fused[i].effects, key.effects, sizeof(key.effects)) &&
+            !memcmp(fused[i].layouts, key.layouts, sizeof(key.layouts)))
+        {
+            return fused[i].pipeline;
+        }
+    }
+
+    key.pipeline = flecsEngine_renderEffect_createFused(world, engine, &key);
+    if (!key.pipeline) {
+        return NULL;
+    }
+
+    ecs_vec_append_t(NULL, &viewImpl->fused_effects,
+        flecs_engine_fused_effect_t)[0] = key;
+    return key.pipeline;
+}
+
+void flecsEngine_renderView_releaseFusedEffects(
+    FlecsRenderViewImpl *viewImpl)
+{
+    int32_t count = ecs_vec_count(&viewImpl->fused_effects);
+    flecs_engine_fused_effect_t *fused = ecs_vec_first(&viewImpl->fused_effects);
+    for (int32_t i = 0; i < count; i ++) {
+        if (fused[i].pipeline) {
+            wgpuRenderPipelineRelease(fused[i].pipeline);
+        }
+    }
+
+    ecs_vec_fini_t(NULL, &viewImpl->fused_effects, flecs_engine_fused_effect_t);
+}
+
+static bool flecsEngine_renderView_renderFused(
+    ecs_world_t *world,
+    FlecsEngineImpl *engine,
+    const FlecsRenderView *view,
+    FlecsRenderViewImpl *viewImpl,
+    WGPUCommandEncoder encoder,
+    int32_t first,
+    int32_t last,
+    WGPUTextureView input_view,
+    WGPUTextureView output_view,
+    WGPUTextureFormat output_format,
+    WGPULoadOp load_op)
+{
+    const flecs_render_view_effect_t *effects = ecs_vec_first(&view->effects);
+
+    WGPURenderPipeline pipeline = flecsEngine_renderView_fusedPipeline(
+        world, engine, viewImpl, effects, first, last, output_format);
+    if (!pipeline) {
+        return false;
+    }
+
+    WGPURenderPassEncoder pass = flecsEngine_renderEffect_beginPass(
+        engine, view, encoder, output_view, load_op);
+    wgpuRenderPassEncoderSetPipeline(pass, pipeline);
+    wgpuRenderPassEncoderSetBindGroup(pass, 0,
+        flecsEngine_renderEffect_passthroughBindGroup(
+            engine, viewImpl, input_view), 0, NULL);
+
+    /* Each stage binds its own resources. The input bindings of the stage
+     * layouts are unused by the fused shader. */
+    uint32_t group = 1;
+    for (int32_t i = first; i <= last; i ++) {
+        if (!effects[i].enabled) {
+            continue;
+        }
+
+        ecs_entity_t entity = effects[i].effect;
+        const FlecsRenderEffect *effect = ecs_get(
+            world, entity, FlecsRenderEffect);
+        FlecsRenderEffectImpl *effect_impl = ecs_get_mut(
+            world, entity, FlecsRenderEffectImpl);
+
+        WGPUBindGroup bind_group = flecsEngine_renderEffect_bindGroup(
+            world, engine, entity, effect, effect_impl, input_view);
+        ecs_assert(bind_group != NULL, ECS_INTERNAL_ERROR, NULL);
+        wgpuRenderPassEncoderSetBindGroup(pass, group ++, bind_group, 0, NULL);
+    }
+
+    wgpuRenderPassEncoderDraw(pass, 3, 1, 0, 0);
+    wgpuRenderPassEncoderEnd(pass);
+    wgpuRenderPassEncoderRelease(pass);
+    return true;
+}
+
+/* Format of the target an effect writes. Effects with a render callback
+ * create their own pipelines for the HDR format, so they always write it. */
+static WGPUTextureFormat flecsEngine_renderView_effectFormat(
+    const FlecsEngineImpl *engine,
+    const FlecsRenderView *view,
+    const FlecsRenderEffect *effect,
+    WGPUTextureFormat input_format)
+{
+    WGPUTextureFormat hdr_format = flecsEngine_getHdrFormat(engine);
+    if (!view->packed_effect_targets || effect->render_callback) {
+        return hdr_format;
+    }
+
+    /* Tonemapped colors fit in 8 bits, sRGB keeps precision in the darks */
+    if (effect->ldr_output ||
+        input_format == WGPUTextureFormat_RGBA8UnormSrgb)
+    {
+        return WGPUTextureFormat_RGBA8UnormSrgb;
+    }
+
+    if (engine->rg11b10_renderable &&
+        hdr_format == WGPUTextureFormat_RGBA16Float)
+    {
+        return WGPUTextureFormat_RG11B10Ufloat;
+    }
+
+    return hdr_format;
+}
+
+void flecsEngine_renderView_planEffects(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    const FlecsRenderView *view,
+    flecs_engine_render_graph_t *graph)
+{
+    int32_t effect_count = ecs_vec_count(&view->effects);
+    const flecs_render_view_effect_t *effects = ecs_vec_first(&view->effects);
+    int32_t last_enabled = flecsEngine_renderView_lastEffect(view);
+    bool needs_upscale = flecsEngine_needsUpscale(engine) &&
+        !flecsEngine_renderView_effectUpscales(world, engine, view);
+
+    /* Target 0 is the batch output, target i + 1 the output of effect i. A
+     * write to -1 goes to the view texture, which the graph doesn't own. */
+    flecsEngine_renderGraph_begin(graph, effect_count + 1);
+    flecsEngine_renderGraph_setFormat(graph, 0, flecsEngine_getHdrFormat(engine));
+    flecsEngine_renderGraph_addPass(graph, -1, 0);
+
+    if (last_enabled < 0) {
+        flecsEngine_renderGraph_addPass(graph, 0, -1);
+        return;
+    }
+
+    int32_t i;
+    for (i = 0; i < effect_count; i ++) {
+        if (!effects[i].enabled) {
+            continue;
+        }
+
+        const FlecsRenderEffect *effect = ecs_get(
+            world, effects[i].effect, FlecsRenderEffect);
+        ecs_assert(effect != NULL, ECS_INVALID_PARAMETER, NULL);
+
+        WGPUTextureFormat input_format = flecsEngine_renderGraph_targetFormat(
+            graph, flecsEngine_resolveEffectInput(effects, effect->input));
+        flecsEngine_renderGraph_setFormat(graph, i + 1,
+            flecsEngine_renderView_effectFormat(
+                engine, view, effect, input_format));
+    }
+
+    for (i = 0; i < effect_count; i ++) {
+        if (!effects[i].enabled) {
+            continue;
+        }
+
+        const FlecsRenderEffect *effect = ecs_get(
+            world, effects[i].effect, FlecsRenderEffect);
+        ecs_assert(effect != NULL, ECS_INVALID_PARAMETER, NULL);
+
+        /* A fused run is one pass, its inner targets are never written */
+        int32_t last = flecsEngine_renderView_fusedRun(world, view, i);
+        bool writes_to_final = (last == last_enabled) && !needs_upscale;
+        flecsEngine_renderGraph_addPass(graph,
+            flecsEngine_resolveEffectInput(effects, effect->input),
+            writes_to_final ? -1 : last + 1);
+        i = last;
+    }
+
+    if (needs_upscale) {
+        flecsEngine_renderGraph_addPass(graph, last_enabled + 1, -1);
+    }
+}
+
 void flecsEngine_renderView_renderEffects(
     ecs_world_t *world,
     ecs_entity_t view_entity,
@@ -184,49 +693,44 @@ void flecsEngine_renderView_renderEffects(
     WGPUCommandEncoder encoder)
 {
     int32_t effect_count = ecs_vec_count(&view->effects);
-    const flecs_render_view_effect_t *effects = NULL;
-
-    /* Find the last enabled effect. */
-    int32_t last_enabled = -1;
-    if (effect_count > 0) {
-        effects = ecs_vec_first(&view->effects);
-        for (int32_t i = effect_count - 1; i >= 0; i --) {
-            if (effects[i].enabled) {
-                last_enabled = i;
-                break;
-            }
-        }
-    }
+    const flecs_render_view_effect_t *effects = ecs_vec_first(&view->effects);
+    int32_t last_enabled = flecsEngine_renderView_lastEffect(view);
+
+    /* The upscale pass is skipped if the last effect upscales by itself */
+    bool needs_upscale = flecsEngine_needsUpscale(engine) &&
+        !flecsEngine_renderView_effectUpscales(world, engine, view);
 
-    /* No effects enabled — blit batch output to screen via passthrough. */
+    /* No effects enabled — blit batch output to screen via passthrough, or
+     * upscale it when rendering below output resolution. */
     if (last_enabled < 0) {
-        if (!viewImpl->passthrough_bind_group) {
-            WGPUBindGroupEntry entries[2] = {
-                { .binding = 0, .textureView = viewImpl->effect_target_views[0] },
-                { .binding = 1, .sampler = engine->depth.passthrough_sampler }
-            };
-            viewImpl->passthrough_bind_group = wgpuDeviceCreateBindGroup(
-                engine->device,
-                &(WGPUBindGroupDescriptor){
-                    .layout = engine->depth.passthrough_bind_layout,
-                    .entryCount = 2,
-                    .entries = entries
-                });
+        if (needs_upscale) {
+            int32_t scope = flecsEngine_gpuTimer_begin(
+                engine, encoder, FlecsGpuStageEffects, "upscale", 0);
+            if (!flecsEngine_upscale(engine, viewImpl, encoder,
+                viewImpl->effect_target_views[0], view_texture))
+            {
+                ecs_err("failed to upscale view");
+            }
+            flecsEngine_gpuTimer_end(engine, encoder, scope);
+            return;
         }
 
+        WGPUBindGroup bg = flecsEngine_renderEffect_passthroughBindGroup(
+            engine, viewImpl, viewImpl->effect_target_views[0]);
+
+        int32_t scope = flecsEngine_gpuTimer_begin(
+            engine, encoder, FlecsGpuStageEffects, "passthrough", 0);
         WGPURenderPassEncoder pass = flecsEngine_renderEffect_beginPass(
             engine, view, encoder, view_texture, WGPULoadOp_Load);
         wgpuRenderPassEncoderSetPipeline(pass, engine->depth.passthrough_pipeline);
-        wgpuRenderPassEncoderSetBindGroup(pass, 0,
-            viewImpl->passthrough_bind_group, 0, NULL);
+        wgpuRenderPassEncoderSetBindGroup(pass, 0, bg, 0, NULL);
         wgpuRenderPassEncoderDraw(pass, 3, 1, 0, 0);
         wgpuRenderPassEncoderEnd(pass);
         wgpuRenderPassEncoderRelease(pass);
+        flecsEngine_gpuTimer_end(engine, encoder, scope);
         return;
     }
 
-    bool needs_upscale = engine->resolution_scale > 1;
-
     for (int32_t i = 0; i < effect_count; i ++) {
         if (!effects[i].enabled) {
             continue;
@@ -244,14 +748,15 @@ void flecsEngine_renderView_renderEffects(
         ecs_assert(effect->input >= 0, ECS_INVALID_PARAMETER, NULL);
         ecs_assert(effect->input <= i, ECS_INVALID_PARAMETER, NULL);
 
-        bool is_last = (i == last_enabled);
+        int32_t last = flecsEngine_renderView_fusedRun(world, view, i);
+        bool is_last = (last == last_enabled);
         bool writes_to_final = is_last && !needs_upscale;
         WGPUTextureView output_view = writes_to_final
             ? view_texture
-            : viewImpl->effect_target_views[i + 1];
+            : viewImpl->effect_target_views[last + 1];
         WGPUTextureFormat output_format = writes_to_final
             ? flecsEngine_getViewTargetFormat(engine)
-            : viewImpl->effect_target_format;
+            : flecsEngine_renderGraph_targetFormat(&viewImpl->graph, last + 1);
 
         int32_t resolved_input = flecsEngine_resolveEffectInput(
             effects, effect->input);
@@ -259,6 +764,25 @@ void flecsEngine_renderView_renderEffects(
             viewImpl->effect_target_views[resolved_input];
         WGPULoadOp load_op = writes_to_final ? WGPULoadOp_Load : WGPULoadOp_Clear;
 
+        /* Effects encode their own passes, so they're timed with markers
+         * around the passes rather than with pass timestamp writes. */
+        int32_t scope = flecsEngine_gpuTimer_begin(engine, encoder,
+            FlecsGpuStageEffects, last != i ? "fused_effects" : "effect",
+            entity);
+
+        if (last != i) {
+            bool render_ok = flecsEngine_renderView_renderFused(world, engine,
+                view, viewImpl, encoder, i, last, input_view, output_view,
+                output_format, load_op);
+            flecsEngine_gpuTimer_end(engine, encoder, scope);
+            if (!render_ok) {
+                ecs_err("failed to render fused effects");
+                return;
+            }
+            i = last;
+            continue;
+        }
+
         if (effect->render_callback) {
             bool render_ok = effect->render_callback(
                 world,
@@ -268,10 +792,12 @@ void flecsEngine_renderView_renderEffects(
                 effect,
                 effect_impl,
                 input_view,
-                viewImpl->effect_target_format,
+                flecsEngine_renderGraph_targetFormat(
+                    &viewImpl->graph, resolved_input),
                 output_view,
                 output_format,
                 load_op);
+            flecsEngine_gpuTimer_end(engine, encoder, scope);
             if (!render_ok) {
                 ecs_err("failed to render effect");
                 return;
@@ -298,46 +824,35 @@ void flecsEngine_renderView_renderEffects(
 
         wgpuRenderPassEncoderEnd(effect_pass);
         wgpuRenderPassEncoderRelease(effect_pass);
+        flecsEngine_gpuTimer_end(engine, encoder, scope);
     }
 
-    /* When upscaling is needed, passthrough blits from the last effect's
-     * intermediate target to the final view texture at window resolution. */
+    /* When rendering below output resolution, the last effect writes to an
+     * intermediate target that is upscaled to the final view texture. */
     if (needs_upscale) {
-        WGPUTextureView upscale_input =
-            viewImpl->effect_target_views[last_enabled + 1];
-
-        WGPUBindGroupEntry entries[2] = {
-            { .binding = 0, .textureView = upscale_input },
-            { .binding = 1, .sampler = engine->depth.passthrough_sampler }
-        };
-        WGPUBindGroup bg = wgpuDeviceCreateBindGroup(engine->device,
-            &(WGPUBindGroupDescriptor){
-                .layout = engine->depth.passthrough_bind_layout,
-                .entryCount = 2,
-                .entries = entries
-            });
-
-        WGPURenderPassEncoder pass = flecsEngine_renderEffect_beginPass(
-            engine, view, encoder, view_texture, WGPULoadOp_Load);
-        wgpuRenderPassEncoderSetPipeline(pass, engine->depth.passthrough_pipeline);
-        wgpuRenderPassEncoderSetBindGroup(pass, 0, bg, 0, NULL);
-        wgpuRenderPassEncoderDraw(pass, 3, 1, 0, 0);
-        wgpuRenderPassEncoderEnd(pass);
-        wgpuRenderPassEncoderRelease(pass);
-        wgpuBindGroupRelease(bg);
+        int32_t scope = flecsEngine_gpuTimer_begin(
+            engine, encoder, FlecsGpuStageEffects, "upscale", 0);
+        if (!flecsEngine_upscale(engine, viewImpl, encoder,
+            viewImpl->effect_target_views[last_enabled + 1], view_texture))
+        {
+            ecs_err("failed to upscale view");
+        }
+        flecsEngine_gpuTimer_end(engine, encoder, scope);
     }
 }
 
 static WGPURenderPipeline flecsEngine_renderEffect_createPipeline(
     const FlecsEngineImpl *engine,
-    const FlecsShader *shader,
-    const FlecsShaderImpl *shader_impl,
-    WGPUBindGroupLayout bind_layout,
+    WGPUShaderModule module,
+    const char *vertex_entry,
+    const char *fragment_entry,
+    const WGPUBindGroupLayout *bind_layouts,
+    uint32_t bind_layout_count,
     WGPUTextureFormat color_format)
 {
     WGPUPipelineLayoutDescriptor pipeline_layout_desc = {
-        .bindGroupLayoutCount = 1,
-        .bindGroupLayouts = &bind_layout
+        .bindGroupLayoutCount = bind_layout_count,
+        .bindGroupLayouts = bind_layouts
     };
 
     WGPUPipelineLayout pipeline_layout = wgpuDeviceCreatePipelineLayout(
@@ -352,13 +867,13 @@ static WGPURenderPipeline flecsEngine_renderEffect_createPipeline(
     };
 
     WGPUVertexState vertex_state = {
-        .module = shader_impl->shader_module,
-        .entryPoint = WGPU_STR(shader->vertex_entry ? shader->vertex_entry : "vs_main")
+        .module = module,
+        .entryPoint = WGPU_STR(vertex_entry ? vertex_entry : "vs_main")
     };
 
     WGPUFragmentState fragment_state = {
-        .module = shader_impl->shader_module,
-        .entryPoint = WGPU_STR(shader->fragment_entry ? shader->fragment_entry : "fs_main"),
+        .module = module,
+        .entryPoint = WGPU_STR(fragment_entry ? fragment_entry : "fs_main"),
         .targetCount = 1,
         .targets = &color_target
     };
@@ -375,8 +890,10 @@ static WGPURenderPipeline flecsEngine_renderEffect_createPipeline(
         .multisample = WGPU_MULTISAMPLE_DEFAULT
     };
 
+    uint64_t trace_start = flecsEngine_trace_begin();
     WGPURenderPipeline pipeline = wgpuDeviceCreateRenderPipeline(
         engine->device, &pipeline_desc);
+    flecsEngine_trace_end(trace_start, "pipeline", "render_pipeline", "effect");
 
     wgpuPipelineLayoutRelease(pipeline_layout);
     return pipeline;
@@ -493,9 +1010,11 @@ static void FlecsRenderEffect_on_set(
 
         impl.pipeline_surface = flecsEngine_renderEffect_createPipeline(
             engine,
-            shader,
-            shader_impl,
-            impl.bind_layout,
+            shader_impl->shader_module,
+            shader->vertex_entry,
+            shader->fragment_entry,
+            &impl.bind_layout,
+            1,
             flecsEngine_getViewTargetFormat(engine));
         if (!impl.pipeline_surface) {
             flecsEngine_renderEffect_release(&impl);
@@ -506,9 +1025,11 @@ static void FlecsRenderEffect_on_set(
 
         impl.pipeline_hdr = flecsEngine_renderEffect_createPipeline(
             engine,
-            shader,
-            shader_impl,
-            impl.bind_layout,
+            shader_impl->shader_module,
+            shader->vertex_entry,
+            shader->fragment_entry,
+            &impl.bind_layout,
+            1,
             hdr_format);
         if (!impl.pipeline_hdr) {
             flecsEngine_renderEffect_release(&impl);
@@ -0,0 +1,259 @@
+#include "renderer.h"
+#include "flecs_engine.h"
+
+ECS_COMPONENT_DECLARE(FlecsRenderGraphStats);
+
+void flecsEngine_renderGraph_begin(
+    flecs_engine_render_graph_t *graph,
+    int32_t target_count)
+{
+    ecs_vec_clear(&graph->passes);
+    ecs_vec_set_count_t(NULL, &graph->target_formats, WGPUTextureFormat,
+        target_count);
+    ecs_vec_set_count_t(NULL, &graph->target_slots, int32_t, target_count);
+    ecs_vec_set_count_t(NULL, &graph->last_use, int32_t, target_count);
+    graph->target_count = target_count;
+    graph->slot_count = 0;
+
+    WGPUTextureFormat *formats = ecs_vec_first(&graph->target_formats);
+    for (int32_t t = 0; t < target_count; t ++) {
+        formats[t] = WGPUTextureFormat_Undefined;
+    }
+}
+
+void flecsEngine_renderGraph_setFormat(
+    flecs_engine_render_graph_t *graph,
+    int32_t target,
+    WGPUTextureFormat format)
+{
+    ecs_assert(target >= 0 && target < graph->target_count,
+        ECS_INVALID_PARAMETER, NULL);
+    ecs_vec_get_t(&graph->target_formats, WGPUTextureFormat, target)[0] =
+        format;
+}
+
+WGPUTextureFormat flecsEngine_renderGraph_targetFormat(
+    const flecs_engine_render_graph_t *graph,
+    int32_t target)
+{
+    ecs_assert(target >= 0 && target < graph->target_count,
+        ECS_INVALID_PARAMETER, NULL);
+    return ecs_vec_get_t(&graph->target_formats, WGPUTextureFormat, target)[0];
+}
+
+WGPUTextureFormat flecsEngine_renderGraph_slotFormat(
+    const flecs_engine_render_graph_t *graph,
+    int32_t slot)
+{
+    ecs_assert(slot >= 0 && slot < graph->slot_count,
+        ECS_INVALID_PARAMETER, NULL);
+    return ecs_vec_get_t(&graph->slot_formats, WGPUTextureFormat, slot)[0];
+}
+
+void flecsEngine_renderGraph_addPass(
+    flecs_engine_render_graph_t *graph,
+    int32_t read,
+    int32_t write)
+{
+    ecs_assert(read < graph->target_count, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(write < graph->target_count, ECS_INVALID_PARAMETER, NULL);
+
+    flecs_engine_graph_pass_t *pass = ecs_vec_append_t(
+        NULL, &graph->passes, flecs_engine_graph_pass_t);
+    pass->read = read;
+    pass->write = write;
+}
+
+int32_t flecsEngine_renderGraph_compile(
+    flecs_engine_render_graph_t *graph,
+    bool alias)
+{
+    int32_t t, p, s;
+    int32_t target_count = graph->target_count;
+    int32_t pass_count = ecs_vec_count(&graph->passes);
+    const flecs_engine_graph_pass_t *passes = ecs_vec_first(&graph->passes);
+    const WGPUTextureFormat *formats = ecs_vec_first(&graph->target_formats);
+    int32_t *slots = ecs_vec_first(&graph->target_slots);
+    int32_t *last_use = ecs_vec_first(&graph->last_use);
+
+    for (t = 0; t < target_count; t ++) {
+        slots[t] = -1;
+        last_use[t] = -1;
+    }
+
+    /* A target lives from the pass that writes it to the last pass that
+     * reads it. Targets that are never read still need a texture to write. */
+    for (p = 0; p < pass_count; p ++) {
+        if (passes[p].read >= 0) {
+            last_use[passes[p].read] = p;
+        }
+        if (passes[p].write >= 0 && last_use[passes[p].write] < p) {
+            last_use[passes[p].write] = p;
+        }
+    }
+
+    ecs_vec_clear(&graph->slot_use);
+    ecs_vec_clear(&graph->slot_formats);
+    graph->slot_count = 0;
+
+    for (p = 0; p < pass_count; p ++) {
+        int32_t write = passes[p].write;
+        if (write < 0 || slots[write] >= 0) {
+            continue;
+        }
+
+        /* Reuse a texture with the same format whose last target was used by
+         * an earlier pass. The input of this pass is still in use, so it is
+         * never picked. */
+        int32_t *slot_use = ecs_vec_first(&graph->slot_use);
+        WGPUTextureFormat *slot_formats = ecs_vec_first(&graph->slot_formats);
+        for (s = alias ? 0 : graph->slot_count; s < graph->slot_count; s ++) {
+            if (slot_use[s] < p && slot_formats[s] == formats[write]) {
+                break;
+            }
+        }
+
+        if (s == graph->slot_count) {
+            ecs_vec_append_t(NULL, &graph->slot_use, int32_t)[0] = -1;
+            ecs_vec_append_t(NULL, &graph->slot_formats,
+                WGPUTextureFormat)[0] = formats[write];
+            graph->slot_count ++;
+        }
+
+        slots[write] = s;
+        ecs_vec_get_t(&graph->slot_use, int32_t, s)[0] = last_use[write];
+    }
+
+    return graph->slot_count;
+}
+
+int32_t flecsEngine_renderGraph_targetSlot(
+    const flecs_engine_render_graph_t *graph,
+    int32_t target)
+{
+    ecs_assert(target >= 0 && target < graph->target_count,
+        ECS_INVALID_PARAMETER, NULL);
+    return ecs_vec_get_t(&graph->target_slots, int32_t, target)[0];
+}
+
+void flecsEngine_renderGraph_fini(
+    flecs_engine_render_graph_t *graph)
+{
+    ecs_vec_fini_t(NULL, &graph->passes, flecs_engine_graph_pass_t);
+    ecs_vec_fini_t(NULL, &graph->target_formats, WGPUTextureFormat);
+    ecs_vec_fini_t(NULL, &graph->target_slots, int32_t);
+    ecs_vec_fini_t(NULL, &graph->last_use, int32_t);
+    ecs_vec_fini_t(NULL, &graph->slot_use, int32_t);
+    ecs_vec_fini_t(NULL, &graph->slot_formats, WGPUTextureFormat);
+    graph->target_count = 0;
+    graph->slot_count = 0;
+}
+
+int64_t flecsEngine_textureBlockSize(
+    WGPUTextureFormat format,
+    uint32_t *block_dim)
+{
+    /* Block compressed formats store 4x4 texels per block */
+    switch (format) {
+    case WGPUTextureFormat_BC1RGBAUnorm:
+    case WGPUTextureFormat_BC1RGBAUnormSrgb:
+        *block_dim = 4;
+        return 8;
+    case WGPUTextureFormat_BC3RGBAUnorm:
+    case WGPUTextureFormat_BC3RGBAUnormSrgb:
+    case WGPUTextureFormat_BC7RGBAUnorm:
+    case WGPUTextureFormat_BC7RGBAUnormSrgb:
+        *block_dim = 4;
+        return 16;
+    default:
+        break;
+    }
+
+    *block_dim = 1;
+    switch (format) {
+    case WGPUTextureFormat_RGBA32Float:
+        return 16;
+    case WGPUTextureFormat_RGBA16Float:
+        return 8;
+    case WGPUTextureFormat_R8Unorm:
+        return 1;
+    case WGPUTextureFormat_RG8Unorm:
+    case WGPUTextureFormat_R16Float:
+        return 2;
+    default:
+        /* RGBA8, BGRA8, RG11B10, RGB9E5, RG16F, R32F and depth formats */
+        return 4;
+    }
+}
+
+int64_t flecsEngine_textureBytes(
+    WGPUTextureFormat format,
+    uint32_t width,
+    uint32_t height)
+{
+    uint32_t block_dim;
+    int64_t block_size = flecsEngine_textureBlockSize(format, &block_dim);
+    return block_size *
+        (int64_t)((width + block_dim - 1) / block_dim) *
+        (int64_t)((height + block_dim - 1) / block_dim);
+}
+
+void flecsEngine_renderGraph_publishStats(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine)
+{
+    if (!engine->view_query) {
+        return;
+    }
+
+    int32_t texture_count = 0;
+    int64_t texture_bytes = 0;
+
+    ecs_iter_t it = ecs_query_iter(world, engine->view_query);
+    while (ecs_query_next(&it)) {
+        const FlecsRenderViewImpl *views = ecs_field(
+            &it, FlecsRenderViewImpl, 1);
+        for (int32_t i = 0; i < it.count; i ++) {
+            texture_count += views[i].transient_count;
+            texture_bytes += views[i].transient_bytes;
+        }
+    }
+
+    const FlecsRenderGraphStats *stats = ecs_singleton_get(
+        world, FlecsRenderGraphStats);
+    int64_t peak = texture_bytes;
+    if (stats) {
+        if (stats->texture_count == texture_count &&
+            stats->texture_bytes == texture_bytes)
+        {
+            return;
+        }
+
+        if (stats->peak_texture_bytes > peak) {
+            peak = stats->peak_texture_bytes;
+        }
+    }
+
+    ecs_singleton_set(world, FlecsRenderGraphStats, {
+        .texture_count = texture_count,
+        .texture_bytes = texture_bytes,
+        .peak_texture_bytes = peak
+    });
+}
+
+void flecsEngine_renderGraph_register(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, FlecsRenderGraphStats);
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsRenderGraphStats),
+        .members = {
+            { .name = "texture_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "texture_bytes", .type = ecs_id(ecs_i64_t) },
+            { .name = "peak_texture_bytes", .type = ecs_id(ecs_i64_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(FlecsRenderGraphStats), EcsSingleton);
+}
@@ -36,16 +36,15 @@ static void flecsEngine_material_ensureBufferCapacity(
         ecs_os_malloc_n(FlecsGpuMaterial, new_capacity);
     ecs_assert(new_cpu_materials != NULL, ECS_OUT_OF_MEMORY, NULL);
 
-    WGPUBuffer new_material_buffer = wgpuDeviceCreateBuffer(
-        impl->device, &(WGPUBufferDescriptor){
+    WGPUBuffer new_material_buffer = flecsEngine_gpuMemory_createBuffer(
+        impl->device, FlecsGpuMemoryInstance, &(WGPUBufferDescriptor){
             .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst,
             .size = (uint64_t)new_capacity * sizeof(FlecsGpuMaterial)
         });
     ecs_assert(new_material_buffer != NULL, ECS_INTERNAL_ERROR, NULL);
 
-    if (impl->materials.buffer) {
-        wgpuBufferRelease(impl->materials.buffer);
-    }
+    flecsEngine_gpuMemory_releaseBuffer(
+        FlecsGpuMemoryInstance, impl->materials.buffer);
 
     ecs_os_free(impl->materials.cpu_materials);
 
@@ -58,7 +57,8 @@ void flecsEngine_material_releaseBuffer(
     FlecsEngineImpl *impl)
 {
     if (impl->materials.buffer) {
-        wgpuBufferRelease(impl->materials.buffer);
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryInstance, impl->materials.buffer);
         impl->materials.buffer = NULL;
     }
 
@@ -144,8 +144,8 @@ redo: {
             return;
         }
 
-        wgpuQueueWriteBuffer(
-            impl->queue,
+        flecsEngine_queueWriteBuffer(
+            impl,
             impl->materials.buffer,
             0,
             impl->materials.cpu_materials,
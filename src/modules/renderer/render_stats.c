@@ -0,0 +1,233 @@
+#include <string.h>
+
+#include "renderer.h"
+#include "flecs_engine.h"
+
+ECS_COMPONENT_DECLARE(FlecsRenderViewStats);
+ECS_COMPONENT_DECLARE(FlecsGpuCommandStats);
+
+void flecsEngine_renderStats_draw(
+    const flecs_engine_pass_state_t *state,
+    uint32_t index_count,
+    uint32_t instance_count)
+{
+    flecs_engine_render_counters_t *counters = state->counters;
+    if (!counters) {
+        return;
+    }
+
+    counters->draw_count ++;
+    counters->instance_count += instance_count;
+    counters->triangle_count += (int64_t)(index_count / 3) * instance_count;
+}
+
+void flecsEngine_renderStats_pipelineSwitch(
+    const flecs_engine_pass_state_t *state)
+{
+    if (state->counters) {
+        state->counters->pipeline_switch_count ++;
+    }
+}
+
+void flecsEngine_renderStats_bindGroupSwitch(
+    const flecs_engine_pass_state_t *state)
+{
+    if (state->counters) {
+        state->counters->bind_group_switch_count ++;
+    }
+}
+
+void flecsEngine_renderStats_createBuffer(
+    const FlecsEngineImpl *engine)
+{
+    if (engine->counters) {
+        engine->counters->buffer_create_count ++;
+    }
+}
+
+void flecsEngine_renderStats_createTexture(
+    const FlecsEngineImpl *engine)
+{
+    if (engine->counters) {
+        engine->counters->texture_create_count ++;
+    }
+}
+
+void flecsEngine_renderStats_write(
+    const FlecsEngineImpl *engine,
+    size_t size)
+{
+    flecs_engine_render_counters_t *counters = engine->counters;
+    if (!counters) {
+        return;
+    }
+
+    counters->write_count ++;
+    counters->write_bytes += (int64_t)size;
+}
+
+void flecsEngine_renderStats_cull(
+    const FlecsEngineImpl *engine,
+    int32_t visible,
+    int32_t culled)
+{
+    flecs_engine_render_counters_t *counters = engine->counters;
+    if (!counters) {
+        return;
+    }
+
+    counters->visible_instance_count += visible;
+    counters->culled_instance_count += culled;
+}
+
+void flecsEngine_renderStats_addCascade(
+    const FlecsEngineImpl *engine,
+    int32_t cascade,
+    const flecs_engine_render_counters_t *src)
+{
+    flecs_engine_render_counters_t *dst = engine->counters;
+    if (!dst) {
+        return;
+    }
+
+    /* Instances of a cascade are reported separately from the main pass */
+    dst->draw_count += src->draw_count;
+    dst->triangle_count += src->triangle_count;
+    dst->cascade_instance_count[cascade] += src->instance_count;
+    dst->pipeline_switch_count += src->pipeline_switch_count;
+    dst->bind_group_switch_count += src->bind_group_switch_count;
+    dst->buffer_create_count += src->buffer_create_count;
+    dst->texture_create_count += src->texture_create_count;
+    dst->write_count += src->write_count;
+    dst->write_bytes += src->write_bytes;
+}
+
+void flecsEngine_renderStats_publish(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine)
+{
+    if (!engine->view_query) {
+        return;
+    }
+
+    ecs_iter_t it = ecs_query_iter(world, engine->view_query);
+    while (ecs_query_next(&it)) {
+        const FlecsRenderViewImpl *views = ecs_field(
+            &it, FlecsRenderViewImpl, 1);
+        for (int32_t i = 0; i < it.count; i ++) {
+            const flecs_engine_render_counters_t *c = &views[i].counters;
+            /* Zeroed so that padding doesn't break the comparison below */
+            FlecsRenderViewStats stats;
+            ecs_os_zeromem(&stats);
+            stats.draw_count = c->draw_count;
+            stats.instance_count = c->instance_count;
+            stats.triangle_count = c->triangle_count;
+            stats.pipeline_switch_count = c->pipeline_switch_count;
+            stats.bind_group_switch_count = c->bind_group_switch_count;
+            stats.buffer_create_count = c->buffer_create_count;
+            stats.texture_create_count = c->texture_create_count;
+            stats.write_count = c->write_count;
+            stats.write_bytes = c->write_bytes;
+            stats.visible_instance_count = c->visible_instance_count;
+            stats.culled_instance_count = c->culled_instance_count;
+            memcpy(stats.shadow_instance_count, c->cascade_instance_count,
+                sizeof(stats.shadow_instance_count));
+
+            const FlecsRenderViewStats *prev = ecs_get(
+                world, it.entities[i], FlecsRenderViewStats);
+            if (prev && !memcmp(prev, &stats, sizeof(stats))) {
+                continue;
+            }
+
+            ecs_set_ptr(world, it.entities[i], FlecsRenderViewStats, &stats);
+        }
+    }
+}
+
+void flecsEngine_renderStats_publishCommands(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine)
+{
+    flecs_engine_gpu_command_counters_t c;
+    if (!flecsEngine_nullGpu_takeCounters(engine->instance, &c)) {
+        return;
+    }
+
+    /* Zeroed so that padding doesn't break the comparison below */
+    FlecsGpuCommandStats stats;
+    ecs_os_zeromem(&stats);
+    stats.submit_count = c.submit_count;
+    stats.command_buffer_count = c.command_buffer_count;
+    stats.render_pass_count = c.render_pass_count;
+    stats.compute_pass_count = c.compute_pass_count;
+    stats.draw_count = c.draw_count;
+    stats.draw_indexed_count = c.draw_indexed_count;
+    stats.dispatch_count = c.dispatch_count;
+    stats.pipeline_set_count = c.pipeline_set_count;
+    stats.bind_group_set_count = c.bind_group_set_count;
+    stats.vertex_buffer_set_count = c.vertex_buffer_set_count;
+    stats.index_buffer_set_count = c.index_buffer_set_count;
+    stats.copy_count = c.copy_count;
+    stats.write_buffer_count = c.write_buffer_count;
+    stats.write_buffer_bytes = c.write_buffer_bytes;
+    stats.write_texture_count = c.write_texture_count;
+    stats.write_texture_bytes = c.write_texture_bytes;
+
+    const FlecsGpuCommandStats *prev = ecs_singleton_get(
+        world, FlecsGpuCommandStats);
+    if (prev && !memcmp(prev, &stats, sizeof(stats))) {
+        return;
+    }
+
+    ecs_singleton_set_ptr(world, FlecsGpuCommandStats, &stats);
+}
+
+void flecsEngine_renderStats_register(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, FlecsRenderViewStats);
+    ECS_COMPONENT_DEFINE(world, FlecsGpuCommandStats);
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsRenderViewStats),
+        .members = {
+            { .name = "draw_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "instance_count", .type = ecs_id(ecs_i64_t) },
+            { .name = "shadow_instance_count", .type = ecs_id(ecs_i64_t),
+                .count = FLECS_ENGINE_SHADOW_CASCADE_COUNT },
+            { .name = "triangle_count", .type = ecs_id(ecs_i64_t) },
+            { .name = "pipeline_switch_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "bind_group_switch_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "buffer_create_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "texture_create_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "write_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "write_bytes", .type = ecs_id(ecs_i64_t) },
+            { .name = "visible_instance_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "culled_instance_count", .type = ecs_id(ecs_i32_t) }
+        }
+    });
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsGpuCommandStats),
+        .members = {
+            { .name = "submit_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "command_buffer_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "render_pass_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "compute_pass_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "draw_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "draw_indexed_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "dispatch_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "pipeline_set_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "bind_group_set_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "vertex_buffer_set_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "index_buffer_set_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "copy_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "write_buffer_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "write_buffer_bytes", .type = ecs_id(ecs_i64_t) },
+            { .name = "write_texture_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "write_texture_bytes", .type = ecs_id(ecs_i64_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(FlecsGpuCommandStats), EcsSingleton);
+}
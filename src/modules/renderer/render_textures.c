@@ -19,6 +19,34 @@ static uint32_t flecsEngine_computeMipCount(
     return count;
 }
 
+void flecsEngine_texture_downsample(
+    const uint8_t *src,
+    uint32_t src_w,
+    uint32_t src_h,
+    uint8_t *dst,
+    uint32_t dst_w,
+    uint32_t dst_h)
+{
+    for (uint32_t y = 0; y < dst_h; y++) {
+        for (uint32_t x = 0; x < dst_w; x++) {
+            uint32_t sx = x * 2, sy = y * 2;
+            uint32_t sx1 = sx + 1 < src_w ? sx + 1 : sx;
+            uint32_t sy1 = sy + 1 < src_h ? sy + 1 : sy;
+
+            const uint8_t *p00 = &src[(sy  * src_w + sx ) * 4];
+            const uint8_t *p10 = &src[(sy  * src_w + sx1) * 4];
+            const uint8_t *p01 = &src[(sy1 * src_w + sx ) * 4];
+            const uint8_t *p11 = &src[(sy1 * src_w + sx1) * 4];
+
+            uint8_t *out = &dst[(y * dst_w + x) * 4];
+            for (int c = 0; c < 4; c++) {
+                out[c] = (uint8_t)(
+                    (p00[c] + p10[c] + p01[c] + p11[c] + 2) / 4);
+            }
+        }
+    }
+}
+
 static WGPUTexture flecsEngine_texture_createFromPixels(
     WGPUDevice device,
     WGPUQueue queue,
@@ -39,7 +67,8 @@ static WGPUTexture flecsEngine_texture_createFromPixels(
         .sampleCount = 1
     };
 
-    WGPUTexture texture = wgpuDeviceCreateTexture(device, &tex_desc);
+    WGPUTexture texture = flecsEngine_gpuMemory_createTexture(
+        device, FlecsGpuMemoryTexture, &tex_desc);
     if (!texture) {
         ecs_err("failed to create texture (%ux%u)", width, height);
         return NULL;
@@ -78,24 +107,8 @@ static WGPUTexture flecsEngine_texture_createFromPixels(
             uint8_t *mip_pixels = ecs_os_malloc(
                 (ecs_size_t)(mip_w * mip_h * bytes_per_pixel));
 
-            for (uint32_t y = 0; y < mip_h; y++) {
-                for (uint32_t x = 0; x < mip_w; x++) {
-                    uint32_t sx = x * 2, sy = y * 2;
-                    uint32_t sx1 = sx + 1 < prev_w ? sx + 1 : sx;
-                    uint32_t sy1 = sy + 1 < prev_h ? sy + 1 : sy;
-
-                    const uint8_t *p00 = &prev_pixels[(sy  * prev_w + sx ) * 4];
-                    const uint8_t *p10 = &prev_pixels[(sy  * prev_w + sx1) * 4];
-                    const uint8_t *p01 = &prev_pixels[(sy1 * prev_w + sx ) * 4];
-                    const uint8_t *p11 = &prev_pixels[(sy1 * prev_w + sx1) * 4];
-
-                    uint8_t *out = &mip_pixels[(y * mip_w + x) * 4];
-                    for (int c = 0; c < 4; c++) {
-                        out[c] = (uint8_t)(
-                            (p00[c] + p10[c] + p01[c] + p11[c] + 2) / 4);
-                    }
-                }
-            }
+            flecsEngine_texture_downsample(
+                prev_pixels, prev_w, prev_h, mip_pixels, mip_w, mip_h);
 
             dst.mipLevel = mip;
             src_layout.bytesPerRow = mip_w * bytes_per_pixel;
@@ -184,7 +197,8 @@ static WGPUTexture flecsEngine_texture_loadDds(
         .sampleCount = 1
     };
 
-    WGPUTexture texture = wgpuDeviceCreateTexture(device, &tex_desc);
+    WGPUTexture texture = flecsEngine_gpuMemory_createTexture(
+        device, FlecsGpuMemoryTexture, &tex_desc);
     if (!texture) {
         ecs_err("failed to create DDS texture: %s", path);
         ecs_os_free(file_data);
@@ -438,7 +452,7 @@ bool flecsEngine_pbr_texture_createBindGroup(
         .entryCount = 5
     };
 
-    *out_bind_group = wgpuDeviceCreateBindGroup(engine->device, &bg_desc);
+    *out_bind_group = flecsEngine_createBindGroup(engine, &bg_desc);
     return *out_bind_group != NULL;
 }
 
@@ -458,11 +472,22 @@ void flecsEngine_texture_onSet(
             continue;
         }
 
+        uint64_t trace_start = flecsEngine_trace_begin();
         WGPUTexture texture = flecsEngine_texture_loadFile(
             engine->device, engine->queue, tex[i].path);
+        flecsEngine_trace_end(
+            trace_start, "asset", "texture_load", tex[i].path);
         if (texture) {
             FlecsTextureImpl *tex_impl = ecs_ensure(
                 world, it->entities[i], FlecsTextureImpl);
+
+            /* Bind groups keep their own reference to the previous view */
+            if (tex_impl->view) {
+                wgpuTextureViewRelease(tex_impl->view);
+            }
+            flecsEngine_gpuMemory_releaseTexture(
+                FlecsGpuMemoryTexture, tex_impl->texture);
+
             tex_impl->texture = texture;
             tex_impl->view = wgpuTextureCreateView(texture, NULL);
         }
@@ -0,0 +1,272 @@
+#include <string.h>
+
+#include "renderer.h"
+#include "../engine/engine.h"
+#include "flecs_engine.h"
+
+typedef struct {
+    WGPUBuffer buffer;   /* Referenced until the write is replayed */
+    uint64_t offset;
+    int32_t data_offset; /* Offset of the staged data in the packet */
+    int32_t size;
+} flecs_engine_packet_write_t;
+
+/* Everything the render thread needs to submit and present a frame. Once a
+ * packet is handed off the main thread doesn't touch it until it is done. */
+typedef struct {
+    ecs_vec_t writes;   /* vec<flecs_engine_packet_write_t> */
+    ecs_vec_t data;     /* vec<uint8_t>, staged buffer writes */
+    ecs_vec_t commands; /* vec<WGPUCommandBuffer> */
+    FlecsEngineSurface target;
+    /* Copied from the engine on handoff, since the singleton can move while
+     * the next frame is simulated. */
+    WGPUQueue queue;
+    WGPUSurface surface;               /* NULL if there is nothing to present */
+    flecs_engine_frame_fence_t *fence; /* NULL without frames in flight */
+} flecs_engine_frame_packet_t;
+
+struct flecs_engine_render_thread_t {
+    ecs_os_thread_t thread;
+    ecs_os_mutex_t lock;
+    ecs_os_cond_t cond;
+    flecs_engine_frame_packet_t packets[2];
+    int32_t recording;  /* Packet the main thread stages writes into */
+    bool pending;       /* Other packet is owned by the render thread */
+    bool quit;
+};
+
+static void flecsEngine_framePacket_clear(
+    flecs_engine_frame_packet_t *packet)
+{
+    int32_t i, count = ecs_vec_count(&packet->writes);
+    flecs_engine_packet_write_t *writes = ecs_vec_first(&packet->writes);
+    for (i = 0; i < count; i ++) {
+        wgpuBufferRelease(writes[i].buffer);
+    }
+
+    count = ecs_vec_count(&packet->commands);
+    WGPUCommandBuffer *cmds = ecs_vec_first(&packet->commands);
+    for (i = 0; i < count; i ++) {
+        wgpuCommandBufferRelease(cmds[i]);
+    }
+
+    ecs_vec_clear(&packet->writes);
+    ecs_vec_clear(&packet->data);
+    ecs_vec_clear(&packet->commands);
+    flecsEngine_releaseFrameTarget(&packet->target);
+}
+
+static void flecsEngine_framePacket_fini(
+    flecs_engine_frame_packet_t *packet)
+{
+    flecsEngine_framePacket_clear(packet);
+    ecs_vec_fini_t(NULL, &packet->writes, flecs_engine_packet_write_t);
+    ecs_vec_fini_t(NULL, &packet->data, uint8_t);
+    ecs_vec_fini_t(NULL, &packet->commands, WGPUCommandBuffer);
+}
+
+/* Replay staged writes, then submit and present. Writes were issued before
+ * the frame's command buffers were recorded, so they go first. */
+static void flecsEngine_framePacket_present(
+    flecs_engine_frame_packet_t *packet)
+{
+    const uint8_t *data = ecs_vec_first(&packet->data);
+
+    int32_t i, count = ecs_vec_count(&packet->writes);
+    flecs_engine_packet_write_t *writes = ecs_vec_first(&packet->writes);
+    for (i = 0; i < count; i ++) {
+        wgpuQueueWriteBuffer(packet->queue, writes[i].buffer,
+            writes[i].offset, &data[writes[i].data_offset],
+            (size_t)writes[i].size);
+    }
+
+    count = ecs_vec_count(&packet->commands);
+    if (count) {
+        wgpuQueueSubmit(packet->queue, (size_t)count,
+            ecs_vec_first_t(&packet->commands, WGPUCommandBuffer));
+
+        /* Same as flecsEngine_frameSync_signal, for the slot of the packet.
+         * Fences are heap allocated, so the pointer survives engine moves. */
+        if (packet->fence) {
+            packet->fence->done = false;
+            flecsEngine_queueOnWorkDone(packet->queue, &packet->fence->done);
+        }
+    }
+
+    /* Only the window surface enables the render thread, and all its
+     * submit_frame does is present. */
+    if (packet->surface) {
+        flecsEngine_presentSurface(packet->surface);
+    }
+
+    flecsEngine_framePacket_clear(packet);
+}
+
+static void* flecsEngine_renderThread_main(
+    void *arg)
+{
+    flecs_engine_render_thread_t *rt = arg;
+
+    ecs_os_mutex_lock(rt->lock);
+    for (;;) {
+        while (!rt->pending && !rt->quit) {
+            ecs_os_cond_wait(rt->cond, rt->lock);
+        }
+
+        if (!rt->pending) {
+            break;
+        }
+
+        flecs_engine_frame_packet_t *packet = &rt->packets[!rt->recording];
+        ecs_os_mutex_unlock(rt->lock);
+        flecsEngine_framePacket_present(packet);
+        ecs_os_mutex_lock(rt->lock);
+
+        rt->pending = false;
+        ecs_os_cond_broadcast(rt->cond);
+    }
+    ecs_os_mutex_unlock(rt->lock);
+
+    return NULL;
+}
+
+flecs_engine_render_thread_t* flecsEngine_renderThread_create(void)
+{
+    if (!ecs_os_has_threading()) {
+        ecs_err("render thread requires threading, submitting on main thread");
+        return NULL;
+    }
+
+    flecs_engine_render_thread_t *rt = ecs_os_calloc_t(
+        flecs_engine_render_thread_t);
+    rt->lock = ecs_os_mutex_new();
+    rt->cond = ecs_os_cond_new();
+    rt->thread = ecs_os_thread_new(flecsEngine_renderThread_main, rt);
+    if (!rt->thread) {
+        ecs_err("failed to start render thread, submitting on main thread");
+        ecs_os_cond_free(rt->cond);
+        ecs_os_mutex_free(rt->lock);
+        ecs_os_free(rt);
+        return NULL;
+    }
+
+    return rt;
+}
+
+void flecsEngine_renderThread_free(
+    flecs_engine_render_thread_t *rt)
+{
+    if (!rt) {
+        return;
+    }
+
+    /* Let the thread finish the frame in flight before quitting */
+    ecs_os_mutex_lock(rt->lock);
+    rt->quit = true;
+    ecs_os_cond_broadcast(rt->cond);
+    ecs_os_mutex_unlock(rt->lock);
+
+    ecs_os_thread_join(rt->thread);
+
+    flecsEngine_framePacket_fini(&rt->packets[0]);
+    flecsEngine_framePacket_fini(&rt->packets[1]);
+    ecs_os_cond_free(rt->cond);
+    ecs_os_mutex_free(rt->lock);
+    ecs_os_free(rt);
+}
+
+void flecsEngine_renderThread_wait(
+    flecs_engine_render_thread_t *rt)
+{
+    if (!rt) {
+        return;
+    }
+
+    ecs_os_mutex_lock(rt->lock);
+    while (rt->pending) {
+        ecs_os_cond_wait(rt->cond, rt->lock);
+    }
+    ecs_os_mutex_unlock(rt->lock);
+}
+
+bool flecsEngine_renderThread_idle(
+    flecs_engine_render_thread_t *rt)
+{
+    if (!rt) {
+        return true;
+    }
+
+    ecs_os_mutex_lock(rt->lock);
+    bool idle = !rt->pending;
+    ecs_os_mutex_unlock(rt->lock);
+    return idle;
+}
+
+void flecsEngine_renderThread_submit(
+    FlecsEngineImpl *engine,
+    FlecsEngineSurface *target)
+{
+    flecs_engine_render_thread_t *rt = engine->render_thread;
+    ecs_assert(rt != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    /* At most one frame is in flight: wait for the previous packet before
+     * handing off the next one. */
+    flecsEngine_renderThread_wait(rt);
+
+    flecs_engine_frame_packet_t *packet = &rt->packets[rt->recording];
+
+    /* Move command buffers and the frame target into the packet */
+    int32_t count = ecs_vec_count(&engine->frame_commands);
+    WGPUCommandBuffer *cmds = ecs_vec_first(&engine->frame_commands);
+    for (int32_t i = 0; i < count; i ++) {
+        ecs_vec_append_t(NULL, &packet->commands, WGPUCommandBuffer)[0] =
+            cmds[i];
+    }
+    ecs_vec_clear(&engine->frame_commands);
+
+    packet->target = *target;
+    ecs_os_zeromem(target);
+
+    flecs_engine_frame_sync_t *fs = &engine->frame_sync;
+    packet->queue = engine->queue;
+    packet->surface = engine->surface;
+    packet->fence = fs->count > 1 ? &fs->fences[fs->slot] : NULL;
+
+    ecs_os_mutex_lock(rt->lock);
+    rt->recording = !rt->recording;
+    rt->pending = true;
+    ecs_os_cond_broadcast(rt->cond);
+    ecs_os_mutex_unlock(rt->lock);
+}
+
+void flecsEngine_queueWriteBuffer(
+    const FlecsEngineImpl *engine,
+    WGPUBuffer buffer,
+    uint64_t offset,
+    const void *data,
+    size_t size)
+{
+    flecsEngine_renderStats_write(engine, size);
+
+    flecs_engine_render_thread_t *rt = engine->render_thread;
+    if (!rt) {
+        wgpuQueueWriteBuffer(engine->queue, buffer, offset, data, size);
+        return;
+    }
+
+    /* The render thread may still be submitting the previous frame, so the
+     * write is staged and replayed right before this frame is submitted. */
+    flecs_engine_frame_packet_t *packet = &rt->packets[rt->recording];
+    int32_t data_offset = ecs_vec_count(&packet->data);
+    void *dst = ecs_vec_grow_t(NULL, &packet->data, uint8_t, (int32_t)size);
+    memcpy(dst, data, size);
+
+    flecsEngine_bufferAddRef(buffer);
+
+    flecs_engine_packet_write_t *write = ecs_vec_append_t(
+        NULL, &packet->writes, flecs_engine_packet_write_t);
+    write->buffer = buffer;
+    write->offset = offset;
+    write->data_offset = data_offset;
+    write->size = (int32_t)size;
+}
@@ -25,6 +25,9 @@ ECS_CTOR(FlecsRenderView, ptr, {
     ptr->shadow.map_size = FLECS_ENGINE_SHADOW_MAP_SIZE_DEFAULT;
     ptr->shadow.bias = 0.0005f;
     ptr->shadow.max_range = 100.0f;
+    ptr->disable_effect_fusion = false;
+    ptr->disable_target_aliasing = false;
+    ptr->packed_effect_targets = false;
 })
 
 ECS_MOVE(FlecsRenderView, dst, src, {
@@ -41,6 +44,9 @@ ECS_COPY(FlecsRenderView, dst, src, {
     dst->ambient_light = src->ambient_light;
     dst->background = src->background;
     dst->shadow = src->shadow;
+    dst->disable_effect_fusion = src->disable_effect_fusion;
+    dst->disable_target_aliasing = src->disable_target_aliasing;
+    dst->packed_effect_targets = src->packed_effect_targets;
     dst->effects = ecs_vec_copy_t(NULL, &src->effects, flecs_render_view_effect_t);
 })
 
@@ -55,52 +61,77 @@ static void flecsEngine_renderView_releaseTargets(
         return;
     }
 
-    for (int32_t i = 0; i < impl->effect_target_count; i ++) {
-        if (impl->effect_target_views && impl->effect_target_views[i]) {
-            wgpuTextureViewRelease(impl->effect_target_views[i]);
-            impl->effect_target_views[i] = NULL;
+    for (int32_t i = 0; i < impl->transient_count; i ++) {
+        if (impl->transient_views && impl->transient_views[i]) {
+            wgpuTextureViewRelease(impl->transient_views[i]);
+            impl->transient_views[i] = NULL;
         }
-        if (impl->effect_target_textures && impl->effect_target_textures[i]) {
-            wgpuTextureRelease(impl->effect_target_textures[i]);
-            impl->effect_target_textures[i] = NULL;
+        if (impl->transient_textures && impl->transient_textures[i]) {
+            flecsEngine_gpuMemory_releaseTexture(
+                FlecsGpuMemoryRenderTarget, impl->transient_textures[i]);
+            impl->transient_textures[i] = NULL;
         }
     }
 
+    if (impl->transient_views) {
+        ecs_os_free(impl->transient_views);
+        impl->transient_views = NULL;
+    }
+    if (impl->transient_textures) {
+        ecs_os_free(impl->transient_textures);
+        impl->transient_textures = NULL;
+    }
+    if (impl->transient_formats) {
+        ecs_os_free(impl->transient_formats);
+        impl->transient_formats = NULL;
+    }
+
+    /* Logical target views don't own the transient textures */
     if (impl->effect_target_views) {
         ecs_os_free(impl->effect_target_views);
         impl->effect_target_views = NULL;
     }
-    if (impl->effect_target_textures) {
-        ecs_os_free(impl->effect_target_textures);
-        impl->effect_target_textures = NULL;
-    }
 
-    if (impl->passthrough_bind_group) {
-        wgpuBindGroupRelease(impl->passthrough_bind_group);
-        impl->passthrough_bind_group = NULL;
-    }
+    flecsEngine_bindGroupCache_fini(&impl->passthrough_bind_groups);
+    flecsEngine_bindGroupCache_fini(&impl->upscale_bind_groups);
 
+    impl->transient_count = 0;
+    impl->transient_bytes = 0;
     impl->effect_target_count = 0;
     impl->effect_target_width = 0;
     impl->effect_target_height = 0;
     impl->effect_target_format = WGPUTextureFormat_Undefined;
 }
 
+static void flecsEngine_renderView_releaseImpl(
+    FlecsRenderViewImpl *impl)
+{
+    flecsEngine_renderView_releaseTargets(impl);
+    flecsEngine_renderGraph_fini(&impl->graph);
+    flecsEngine_renderView_releaseFusedEffects(impl);
+    ecs_vec_fini_t(NULL, &impl->render_list, flecs_engine_render_item_t);
+    impl->render_list_version = 0;
+}
+
 FLECS_ENGINE_IMPL_HOOKS(FlecsRenderViewImpl,
-    flecsEngine_renderView_releaseTargets)
+    flecsEngine_renderView_releaseImpl)
 
+/* Create a texture for each slot of the compiled render graph */
 static bool flecsEngine_renderView_createTargets(
     FlecsEngineImpl *engine,
-    FlecsRenderViewImpl *impl,
-    int32_t effect_count,
-    WGPUTextureFormat format)
+    FlecsRenderViewImpl *impl)
 {
+    const flecs_engine_render_graph_t *graph = &impl->graph;
+    int32_t texture_count = graph->slot_count;
     uint32_t width = (uint32_t)engine->actual_width;
     uint32_t height = (uint32_t)engine->actual_height;
 
-    impl->effect_target_textures = ecs_os_calloc_n(WGPUTexture, effect_count);
-    impl->effect_target_views = ecs_os_calloc_n(WGPUTextureView, effect_count);
-    if (!impl->effect_target_textures || !impl->effect_target_views) {
+    impl->transient_textures = ecs_os_calloc_n(WGPUTexture, texture_count);
+    impl->transient_views = ecs_os_calloc_n(WGPUTextureView, texture_count);
+    impl->transient_formats = ecs_os_calloc_n(WGPUTextureFormat, texture_count);
+    if (!impl->transient_textures || !impl->transient_views ||
+        !impl->transient_formats)
+    {
         goto error;
     }
 
@@ -112,29 +143,37 @@ static bool flecsEngine_renderView_createTargets(
             .height = height,
             .depthOrArrayLayers = 1
         },
-        .format = format,
         .mipLevelCount = 1,
         .sampleCount = 1
     };
 
-    for (int32_t i = 0; i < effect_count; i ++) {
-        impl->effect_target_textures[i] = wgpuDeviceCreateTexture(
-            engine->device, &color_desc);
-        if (!impl->effect_target_textures[i]) {
+    impl->transient_count = texture_count;
+    impl->transient_bytes = 0;
+
+    for (int32_t i = 0; i < texture_count; i ++) {
+        color_desc.format = flecsEngine_renderGraph_slotFormat(graph, i);
+        impl->transient_formats[i] = color_desc.format;
+
+        impl->transient_textures[i] = flecsEngine_gpuMemory_createTexture(
+            engine->device, FlecsGpuMemoryRenderTarget, &color_desc);
+        flecsEngine_renderStats_createTexture(engine);
+        if (!impl->transient_textures[i]) {
             goto error;
         }
 
-        impl->effect_target_views[i] = wgpuTextureCreateView(
-            impl->effect_target_textures[i], NULL);
-        if (!impl->effect_target_views[i]) {
+        impl->transient_views[i] = wgpuTextureCreateView(
+            impl->transient_textures[i], NULL);
+        if (!impl->transient_views[i]) {
             goto error;
         }
+
+        impl->transient_bytes += flecsEngine_textureBytes(
+            color_desc.format, width, height);
     }
 
-    impl->effect_target_count = effect_count;
     impl->effect_target_width = width;
     impl->effect_target_height = height;
-    impl->effect_target_format = format;
+    impl->effect_target_format = flecsEngine_renderGraph_targetFormat(graph, 0);
 
     return true;
 error:
@@ -142,49 +181,100 @@ error:
     return false;
 }
 
-static int flecsEngine_renderView_ensureTargets(
-    FlecsEngineImpl *engine,
-    FlecsRenderViewImpl *impl,
-    int32_t effect_count)
+/* True if the existing textures can hold the slots of the compiled graph */
+static bool flecsEngine_renderView_targetsValid(
+    const FlecsEngineImpl *engine,
+    const FlecsRenderViewImpl *impl)
 {
-    if (effect_count <= 0) {
-        return 0;
+    const flecs_engine_render_graph_t *graph = &impl->graph;
+
+    if (!impl->transient_textures || !impl->transient_views ||
+        impl->effect_target_width != (uint32_t)engine->actual_width ||
+        impl->effect_target_height != (uint32_t)engine->actual_height ||
+        impl->transient_count < graph->slot_count)
+    {
+        return false;
     }
 
-    uint32_t width = (uint32_t)engine->actual_width;
-    uint32_t height = (uint32_t)engine->actual_height;
-    WGPUTextureFormat surface_format = engine->surface_config.format;
-    WGPUTextureFormat desired_format = flecsEngine_getHdrFormat(engine);
-
-    if (impl->effect_target_count >= effect_count) {
-        if (impl->effect_target_textures && impl->effect_target_views) {
-            if (impl->effect_target_width == width &&
-                impl->effect_target_height == height &&
-                impl->effect_target_format == desired_format)
-            {
-                return 0;
-            }
+    for (int32_t i = 0; i < graph->slot_count; i ++) {
+        if (impl->transient_formats[i] !=
+            flecsEngine_renderGraph_slotFormat(graph, i))
+        {
+            return false;
         }
     }
 
-    flecsEngine_renderView_releaseTargets(impl);
+    return true;
+}
 
-    if (flecsEngine_renderView_createTargets(
-        engine, impl, effect_count, desired_format))
-    {
-        return 0;
+/* Map the logical targets of the effect chain onto the transient textures
+ * that the render graph assigned to them. */
+static bool flecsEngine_renderView_mapTargets(
+    FlecsRenderViewImpl *impl)
+{
+    const flecs_engine_render_graph_t *graph = &impl->graph;
+    int32_t target_count = graph->target_count;
+
+    if (impl->effect_target_count != target_count) {
+        WGPUTextureView *views = ecs_os_realloc_n(
+            impl->effect_target_views, WGPUTextureView, target_count);
+        if (!views) {
+            return false;
+        }
+        impl->effect_target_views = views;
+        impl->effect_target_count = target_count;
     }
 
-    if (desired_format != surface_format &&
-        flecsEngine_renderView_createTargets(
-            engine, impl, effect_count, surface_format))
-    {
+    for (int32_t t = 0; t < target_count; t ++) {
+        int32_t slot = flecsEngine_renderGraph_targetSlot(graph, t);
+        impl->effect_target_views[t] = slot >= 0
+            ? impl->transient_views[slot]
+            : NULL;
+    }
+
+    return true;
+}
+
+static int flecsEngine_renderView_ensureTargets(
+    const ecs_world_t *world,
+    FlecsEngineImpl *engine,
+    const FlecsRenderView *view,
+    FlecsRenderViewImpl *impl)
+{
+    flecsEngine_renderView_planEffects(world, engine, view, &impl->graph);
+    flecsEngine_renderGraph_compile(
+        &impl->graph, !view->disable_target_aliasing);
+
+    /* Textures are kept while the size and the formats of the slots are
+     * unchanged, so that toggling effects or the upscale pass doesn't
+     * reallocate them. */
+    if (flecsEngine_renderView_targetsValid(engine, impl)) {
+        return flecsEngine_renderView_mapTargets(impl) ? 0 : -1;
+    }
+
+    flecsEngine_renderView_releaseTargets(impl);
+    flecsEngine_bindGroups_invalidate(engine);
+
+    if (!flecsEngine_renderView_createTargets(engine, impl)) {
+        WGPUTextureFormat surface_format = engine->surface_config.format;
+        if (flecsEngine_getHdrFormat(engine) == surface_format) {
+            return -1;
+        }
+
+        /* Plan again, HDR targets use the surface format from now on */
         engine->hdr_color_format = surface_format;
+        flecsEngine_renderView_planEffects(world, engine, view, &impl->graph);
+        flecsEngine_renderGraph_compile(
+            &impl->graph, !view->disable_target_aliasing);
+
+        if (!flecsEngine_renderView_createTargets(engine, impl)) {
+            return -1;
+        }
+
         ecs_warn("falling back to LDR targets: HDR format unavailable");
-        return 0;
     }
 
-    return -1;
+    return flecsEngine_renderView_mapTargets(impl) ? 0 : -1;
 }
 
 static void flecsEngine_renderView_render(
@@ -193,22 +283,37 @@ static void flecsEngine_renderView_render(
     ecs_entity_t view_entity,
     const FlecsRenderView *view,
     FlecsRenderViewImpl *impl,
-    WGPUCommandEncoder encoder,
+    WGPUCommandEncoder *encoder,
     WGPUTextureView view_texture)
 {
-    engine->last_pipeline = NULL;
+    flecsEngine_gpuTimer_setView(engine, view_entity);
 
-    int32_t effect_count = ecs_vec_count(&view->effects);
-    int32_t target_count = effect_count > 0 ? effect_count : 1;
-    if (effect_count > 0 && engine->resolution_scale > 1) {
-        target_count = effect_count + 1;
-    }
-    if (flecsEngine_renderView_ensureTargets(engine, impl, target_count))
-    {
+    /* Counters are published by the next extract */
+    impl->counters = (flecs_engine_render_counters_t){0};
+    engine->counters = &impl->counters;
+
+    if (flecsEngine_renderView_ensureTargets(world, engine, view, impl)) {
         ecs_err("failed to allocate effect render targets");
         return;
     }
 
+    /* Instances are extracted right before the view is encoded. Each view
+     * appends to the batch buffers, so views rendered earlier in the frame
+     * keep their own visible instances. */
+    engine->frustum = &impl->frustum;
+    flecsEngine_cpuTimer_begin(engine, FlecsCpuStageBatchExtract);
+    flecsEngine_renderView_extractBatches(
+        world, view_entity, engine, view, impl);
+    flecsEngine_cpuTimer_end(engine, FlecsCpuStageBatchExtract);
+
+    /* Iterate light queries before cascade encoders start reading the world
+     * from worker threads. */
+    flecsEngine_cpuTimer_begin(engine, FlecsCpuStageLights);
+    flecsEngine_setupLights(world, engine);
+    flecsEngine_cpuTimer_end(engine, FlecsCpuStageLights);
+
+    flecs_engine_shadow_pass_t shadow_pass = {0};
+
     if (view->shadow.enabled) {
         if (flecsEngine_shadow_ensureSize(
             world, engine, (uint32_t)view->shadow.map_size))
@@ -216,8 +321,20 @@ static void flecsEngine_renderView_render(
             ecs_err("failed to resize shadow maps");
         }
 
+        flecsEngine_cpuTimer_begin(engine, FlecsCpuStageShadow);
         flecsEngine_renderView_renderShadow(
-            world, view_entity, engine, view, encoder);
+            world, view_entity, engine, view, impl, &shadow_pass);
+        flecsEngine_cpuTimer_end(engine, FlecsCpuStageShadow);
+
+        /* Cascades are submitted as separate command buffers. Close the
+         * encoder so that passes of earlier views, which read the shared
+         * shadow maps, are submitted before the cascades overwrite them. */
+        if (shadow_pass.job_count &&
+            flecsEngine_frameCommands_flush(engine, encoder))
+        {
+            flecsEngine_renderView_finishShadow(engine, &shadow_pass);
+            return;
+        }
     } else {
         for (int i = 0; i < FLECS_ENGINE_SHADOW_CASCADE_COUNT; i++) {
             memset(engine->shadow.current_light_vp[i], 0, sizeof(mat4));
@@ -225,33 +342,67 @@ static void flecsEngine_renderView_render(
         }
     }
 
-    flecsEngine_setupLights(world, engine);
+    flecsEngine_viewUniforms_update(world, engine, view);
+
+    flecsEngine_cpuTimer_begin(engine, FlecsCpuStageCluster);
     flecsEngine_cluster_build(world, engine, view);
+    flecsEngine_cpuTimer_end(engine, FlecsCpuStageCluster);
 
+    /* The main pass and effects are encoded while the cascades are encoded
+     * on worker threads. The command buffer of the main pass is submitted
+     * after the cascades. */
+    flecsEngine_cpuTimer_begin(engine, FlecsCpuStageBatches);
     flecsEngine_renderView_renderBatches(
-        world, view_entity, engine, view, impl, encoder);
+        world, view_entity, engine, view, impl, *encoder);
 
     /* When MSAA is active, the batch pass writes to the MSAA depth texture
      * rather than the 1-sample depth texture.  Resolve the multisampled depth
      * into the 1-sample texture so that post-process effects (SSAO, fog, …)
      * can read it. */
     if (engine->sample_count > 1) {
-        flecsEngine_depthResolve(engine, encoder);
+        flecsEngine_depthResolve(engine, *encoder);
     }
+    flecsEngine_cpuTimer_end(engine, FlecsCpuStageBatches);
 
+    flecsEngine_cpuTimer_begin(engine, FlecsCpuStageEffects);
     flecsEngine_renderView_renderEffects(
-        world, view_entity, engine, view, impl, view_texture, encoder);
+        world, view_entity, engine, view, impl, view_texture, *encoder);
+    flecsEngine_cpuTimer_end(engine, FlecsCpuStageEffects);
+
+    /* Time spent waiting for cascade encoders counts as shadow time */
+    flecsEngine_cpuTimer_begin(engine, FlecsCpuStageShadow);
+    flecsEngine_renderView_finishShadow(engine, &shadow_pass);
+    flecsEngine_cpuTimer_end(engine, FlecsCpuStageShadow);
+}
+
+/* Jitter only pays off when an effect accumulates it over frames, otherwise
+ * it just makes the image shake. */
+static bool flecsEngine_renderView_hasJitterEffect(
+    const ecs_world_t *world,
+    const FlecsRenderView *view)
+{
+    int32_t i, count = ecs_vec_count(&view->effects);
+    const flecs_render_view_effect_t *effects = ecs_vec_first(&view->effects);
+    for (i = 0; i < count; i ++) {
+        if (!effects[i].enabled) {
+            continue;
+        }
+
+        const FlecsRenderEffect *effect = ecs_get(
+            world, effects[i].effect, FlecsRenderEffect);
+        if (effect && effect->jitter) {
+            return true;
+        }
+    }
+    return false;
 }
 
 static void flecsEngine_renderView_extract(
     ecs_world_t *world,
     FlecsEngineImpl *engine,
-    ecs_entity_t view_entity,
     const FlecsRenderView *view,
     FlecsRenderViewImpl *impl)
 {
-    (void)impl;
-
     /* Rebuild the sky background HDRI if the view's background colors
      * changed since the last frame. */
     if (!view->hdri) {
@@ -259,18 +410,24 @@ static void flecsEngine_renderView_extract(
             world, engine, &view->background);
     }
 
-    /* Extract frustum planes from camera view-projection matrix */
-    engine->frustum_valid = false;
-    engine->shadow_frustum_valid = false;
+    /* Extract frustum planes from camera view-projection matrix. Planes are
+     * stored on the view, so views with disjoint frusta cull independently. */
+    flecs_engine_frustum_t *frustum = &impl->frustum;
+    frustum->valid = false;
+    frustum->shadow_valid = false;
 
     if (view->camera) {
-        const FlecsCameraImpl *camera = ecs_get(
+        FlecsCameraImpl *camera = ecs_get_mut(
             world, view->camera, FlecsCameraImpl);
         if (camera) {
+            if (flecsEngine_renderView_hasJitterEffect(world, view)) {
+                camera->jitter_requested = true;
+            }
+
             flecsEngine_frustum_extractPlanes(
                 camera->mvp,
-                engine->frustum_planes);
-            engine->frustum_valid = true;
+                frustum->planes);
+            frustum->valid = true;
 
             /* Build a second frustum with far = max_range so that shadow
              * casters beyond the camera far plane but within shadow range
@@ -292,14 +449,12 @@ static void flecsEngine_renderView_extract(
 
                     flecsEngine_frustum_extractPlanes(
                         shadow_vp,
-                        engine->shadow_frustum_planes);
-                    engine->shadow_frustum_valid = true;
+                        frustum->shadow_planes);
+                    frustum->shadow_valid = true;
                 }
             }
         }
     }
-
-    flecsEngine_renderView_extractBatches(world, view_entity, engine, view);
 }
 
 void flecsEngine_renderView_extractAll(
@@ -311,12 +466,13 @@ void flecsEngine_renderView_extractAll(
         FlecsRenderView *views = ecs_field(&it, FlecsRenderView, 0);
         FlecsRenderViewImpl *viewImpls = ecs_field(&it, FlecsRenderViewImpl, 1);
         for (int32_t i = 0; i < it.count; i ++) {
+            flecsEngine_cpuTimer_begin(engine, FlecsCpuStageFrustum);
             flecsEngine_renderView_extract(
                 world,
                 engine,
-                it.entities[i],
                 &views[i],
                 &viewImpls[i]);
+            flecsEngine_cpuTimer_end(engine, FlecsCpuStageFrustum);
         }
     }
 }
@@ -325,18 +481,52 @@ void flecsEngine_renderView_renderAll(
     ecs_world_t *world,
     FlecsEngineImpl *engine,
     WGPUTextureView view_texture,
-    WGPUCommandEncoder encoder)
+    WGPUCommandEncoder *encoder)
 {
+    int32_t view_count = 0;
     ecs_iter_t it = ecs_query_iter(world, engine->view_query);
+    while (ecs_query_next(&it)) {
+        view_count += it.count;
+    }
+
+    engine->frame_count ++;
+    engine->view_uniforms.write_count = 0;
+
+    /* Each frame in flight writes its own range of view slots, so uniforms
+     * and clusters of a frame the GPU may still read aren't overwritten. */
+    int32_t frames_in_flight = engine->frame_sync.count;
+    if (frames_in_flight < 1) {
+        frames_in_flight = 1;
+    }
+
+    if (flecsEngine_viewUniforms_ensure(
+        engine, view_count * frames_in_flight))
+    {
+        return;
+    }
+
+    int32_t slot = engine->frame_sync.slot *
+        (engine->view_uniforms.capacity / frames_in_flight);
+    it = ecs_query_iter(world, engine->view_query);
     while (ecs_query_next(&it)) {
         FlecsRenderView *views = ecs_field(&it, FlecsRenderView, 0);
         FlecsRenderViewImpl *viewImpls = ecs_field(&it, FlecsRenderViewImpl, 1);
         for (int32_t i = 0; i < it.count; i ++) {
+            engine->view_uniforms.slot = slot ++;
             flecsEngine_renderView_render(world, engine, it.entities[i], 
                 &views[i], &viewImpls[i],
                 encoder, view_texture);
+            if (!*encoder) {
+                /* Failed to replace encoder after submitting cascades */
+                ecs_iter_fini(&it);
+                goto done;
+            }
         }
     }
+
+done:
+    engine->frustum = NULL;
+    engine->counters = NULL;
 }
 
 void flecsEngine_renderView_register(
@@ -408,7 +598,10 @@ void flecsEngine_renderView_register(
             { .name = "ambient_light", .type = ecs_id(flecs_rgba_t) },
             { .name = "background", .type = ecs_id(flecs_engine_background_t) },
             { .name = "shadow", .type = ecs_id(flecs_engine_shadow_params_t) },
-            { .name = "effects", .type = vec_view_effect }
+            { .name = "effects", .type = vec_view_effect },
+            { .name = "disable_effect_fusion", .type = ecs_id(ecs_bool_t) },
+            { .name = "disable_target_aliasing", .type = ecs_id(ecs_bool_t) },
+            { .name = "packed_effect_targets", .type = ecs_id(ecs_bool_t) }
         }
     });
 }
@@ -18,7 +18,7 @@ extern ECS_COMPONENT_DECLARE(FlecsEmissive);
 extern ECS_COMPONENT_DECLARE(FlecsMaterialId);
 ECS_COMPONENT_DECLARE(FlecsUniform);
 
-static void flecsEngine_releaseFrameTarget(
+void flecsEngine_releaseFrameTarget(
     FlecsEngineSurface *target)
 {
     if (target->owns_view_texture && target->view_texture) {
@@ -55,7 +55,8 @@ static void flecsEngine_createDepthResources(
     }
 
     if (*texture) {
-        wgpuTextureRelease(*texture);
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryRenderTarget, *texture);
         *texture = NULL;
     }
 
@@ -72,7 +73,8 @@ static void flecsEngine_createDepthResources(
         .sampleCount = 1
     };
 
-    *texture = wgpuDeviceCreateTexture(device, &depth_desc);
+    *texture = flecsEngine_gpuMemory_createTexture(
+        device, FlecsGpuMemoryRenderTarget, &depth_desc);
     if (!*texture) {
         ecs_err("Failed to create depth texture\n");
         return;
@@ -81,7 +83,8 @@ static void flecsEngine_createDepthResources(
     *view = wgpuTextureCreateView(*texture, NULL);
     if (!*view) {
         ecs_err("Failed to create depth texture view\n");
-        wgpuTextureRelease(*texture);
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryRenderTarget, *texture);
         *texture = NULL;
     }
 }
@@ -104,6 +107,9 @@ static int flecsEngine_ensureDepthResources(
         return 0;
     }
 
+    /* Effects bind the depth texture */
+    flecsEngine_bindGroups_invalidate(impl);
+
     flecsEngine_createDepthResources(
         impl->device,
         width,
@@ -124,12 +130,15 @@ static int flecsEngine_ensureDepthResources(
 void flecsEngine_releaseMsaaResources(
     FlecsEngineImpl *impl)
 {
+    flecsEngine_bindGroupCache_fini(&impl->depth.depth_resolve_bind_groups);
+
     if (impl->depth.msaa_color_texture_view) {
         wgpuTextureViewRelease(impl->depth.msaa_color_texture_view);
         impl->depth.msaa_color_texture_view = NULL;
     }
     if (impl->depth.msaa_color_texture) {
-        wgpuTextureRelease(impl->depth.msaa_color_texture);
+        flecsEngine_gpuMemory_releaseTexture(FlecsGpuMemoryRenderTarget,
+            impl->depth.msaa_color_texture);
         impl->depth.msaa_color_texture = NULL;
     }
     if (impl->depth.msaa_depth_texture_view) {
@@ -137,7 +146,8 @@ void flecsEngine_releaseMsaaResources(
         impl->depth.msaa_depth_texture_view = NULL;
     }
     if (impl->depth.msaa_depth_texture) {
-        wgpuTextureRelease(impl->depth.msaa_depth_texture);
+        flecsEngine_gpuMemory_releaseTexture(FlecsGpuMemoryRenderTarget,
+            impl->depth.msaa_depth_texture);
         impl->depth.msaa_depth_texture = NULL;
     }
     impl->depth.msaa_texture_width = 0;
@@ -192,8 +202,8 @@ static int flecsEngine_ensureMsaaResources(
         .sampleCount = (uint32_t)sc
     };
 
-    impl->depth.msaa_color_texture = wgpuDeviceCreateTexture(
-        impl->device, &color_desc);
+    impl->depth.msaa_color_texture = flecsEngine_gpuMemory_createTexture(
+        impl->device, FlecsGpuMemoryRenderTarget, &color_desc);
     if (!impl->depth.msaa_color_texture) {
         ecs_err("Failed to create MSAA color texture");
         return -1;
@@ -221,8 +231,8 @@ static int flecsEngine_ensureMsaaResources(
         .sampleCount = (uint32_t)sc
     };
 
-    impl->depth.msaa_depth_texture = wgpuDeviceCreateTexture(
-        impl->device, &depth_desc);
+    impl->depth.msaa_depth_texture = flecsEngine_gpuMemory_createTexture(
+        impl->device, FlecsGpuMemoryRenderTarget, &depth_desc);
     if (!impl->depth.msaa_depth_texture) {
         ecs_err("Failed to create MSAA depth texture");
         flecsEngine_releaseMsaaResources(impl);
@@ -244,11 +254,20 @@ static int flecsEngine_ensureMsaaResources(
     return 0;
 }
 
+/* Rebuild the pipelines of all batches, or if all is false, only of batches
+ * that were built for different scene features than they use from
+ * features. Batches that don't depend on a feature that changed keep their
+ * pipelines. */
 static void flecsEngine_rebuildBatchPipelines(
-    ecs_world_t *world)
+    ecs_world_t *world,
+    bool all,
+    uint32_t features)
 {
     ecs_query_t *q = ecs_query(world, {
-        .terms = {{ ecs_id(FlecsRenderBatch) }}
+        .terms = {
+            { ecs_id(FlecsRenderBatch) },
+            { ecs_id(FlecsRenderBatchImpl), .oper = EcsOptional }
+        }
     });
     if (!q) {
         return;
@@ -258,7 +277,17 @@ static void flecsEngine_rebuildBatchPipelines(
 
     ecs_iter_t it = ecs_query_iter(world, q);
     while (ecs_query_next(&it)) {
+        const FlecsRenderBatchImpl *impls = ecs_field(
+            &it, FlecsRenderBatchImpl, 1);
         for (int32_t i = 0; i < it.count; i++) {
+            if (!all) {
+                if (!impls) {
+                    break;
+                }
+                if ((features & impls[i].feature_mask) == impls[i].features) {
+                    continue;
+                }
+            }
             ecs_modified_id(world, it.entities[i], ecs_id(FlecsRenderBatch));
         }
     }
@@ -272,6 +301,14 @@ int flecsEngine_initRenderer(
     FlecsEngineImpl *impl)
 {
     impl->hdr_color_format = WGPUTextureFormat_RGBA16Float;
+    impl->render_list_version = 1;
+    impl->batch_features = FLECS_ENGINE_BATCH_FEATURES_ALL;
+    impl->bind_groups.target_version = 1;
+    impl->encode_pool = flecsEngine_encodePool_create();
+    impl->gpu_timer = flecsEngine_gpuTimer_create(impl);
+    impl->cpu_timer = flecsEngine_cpuTimer_create();
+
+    flecsEngine_shaderCache_init(impl);
 
     if (flecsEngine_ensureDepthResources(impl)) {
         goto error;
@@ -287,6 +324,10 @@ int flecsEngine_initRenderer(
         .cache_kind = EcsQueryCacheAuto
     });
 
+    if (flecsEngine_viewUniforms_init(impl)) {
+        goto error;
+    }
+
     if (flecsEngine_shadow_init(world, impl, FLECS_ENGINE_SHADOW_MAP_SIZE_DEFAULT)) {
         goto error;
     }
@@ -347,6 +388,10 @@ int flecsEngine_initRenderer(
         goto error;
     }
 
+    if (flecsEngine_initUpscale(impl)) {
+        goto error;
+    }
+
     return 0;
 error:
     return -1;
@@ -361,16 +406,32 @@ static void FlecsEngineExtract(
         return;
     }
 
+    flecsEngine_cpuTimer_beginFrame(it->world, impl);
+
+    uint64_t trace_start = flecsEngine_trace_begin();
     flecsEngine_renderView_extractAll(it->world, impl);
+    flecsEngine_shaderCache_publishStats(it->world, impl);
+    flecsEngine_bindGroups_publishStats(it->world, impl);
+    flecsEngine_frameSync_publishStats(it->world, impl);
+    flecsEngine_dynamicResolution_publishStats(it->world, impl);
+    flecsEngine_renderGraph_publishStats(it->world, impl);
+    flecsEngine_renderStats_publish(it->world, impl);
+    flecsEngine_renderStats_publishCommands(it->world, impl);
+    flecsEngine_gpuMemory_publishStats(it->world);
+    flecsEngine_trace_end(trace_start, "system", "FlecsEngineExtract", NULL);
 }
 
-static void FlecsEngineRender(
+static void flecsEngine_renderFrame(
     ecs_iter_t *it)
 {
     FlecsEngineImpl *impl = ecs_field(it, FlecsEngineImpl, 0);
 
     const FlecsEngineSurfaceInterface *surface_impl = impl->surface_impl;
 
+    /* The surface can't be reconfigured or acquired while the render thread
+     * is still presenting the previous frame. */
+    flecsEngine_renderThread_wait(impl->render_thread);
+
     int prep_result = flecsEngine_surfaceInterface_prepareFrame(
         surface_impl, it->world, impl);
     if (prep_result > 0) {
@@ -396,6 +457,8 @@ static void FlecsEngineRender(
         if (impl->actual_height < 1) impl->actual_height = 1;
     }
 
+    flecsEngine_dynamicResolution_begin(it->world, impl, it->delta_time);
+
     if (flecsEngine_ensureDepthResources(impl)) {
         flecsEngine_surfaceInterface_onFrameFailed(
             surface_impl, it->world, impl);
@@ -403,7 +466,9 @@ static void FlecsEngineRender(
     }
 
     /* Ensure MSAA resources match current sample_count / dimensions.
-     * If sample_count changed, also rebuild batch pipelines. */
+     * If sample_count changed, also rebuild batch pipelines. When the scene
+     * starts or stops using shadows or local lights, batches whose shaders
+     * use them are rebuilt with a variant without them. */
     {
         int32_t prev_sc = impl->depth.msaa_texture_sample_count;
         int32_t cur_sc = impl->sample_count < 2 ? 0 : impl->sample_count;
@@ -414,8 +479,14 @@ static void FlecsEngineRender(
             return;
         }
 
-        if (prev_sc != cur_sc) {
-            flecsEngine_rebuildBatchPipelines(it->world);
+        uint32_t features = flecsEngine_renderBatch_sceneFeatures(
+            it->world, impl);
+        bool features_changed = features != impl->batch_features;
+        impl->batch_features = features;
+
+        if (prev_sc != cur_sc || features_changed) {
+            flecsEngine_rebuildBatchPipelines(
+                it->world, prev_sc != cur_sc, features);
         }
     }
 
@@ -424,8 +495,10 @@ static void FlecsEngineRender(
     WGPUCommandEncoder encoder = NULL;
     WGPUCommandBuffer cmd = NULL;
 
+    flecsEngine_cpuTimer_begin(impl, FlecsCpuStageAcquire);
     int target_result = flecsEngine_surfaceInterface_acquireFrame(
         surface_impl, impl, &frame_target);
+    flecsEngine_cpuTimer_end(impl, FlecsCpuStageAcquire);
     if (target_result > 0) {
         return;
     }
@@ -443,12 +516,23 @@ static void FlecsEngineRender(
         goto cleanup;
     }
 
+    /* Select the copy of per-frame buffers the GPU is done with */
+    flecsEngine_frameSync_begin(impl);
+
+    /* Publish GPU timings of frames the GPU is done with */
+    flecsEngine_gpuTimer_beginFrame(it->world, impl);
+
     // Sync materials
     flecsEngine_material_uploadBuffer(it->world, impl);
 
     // Render all views
+    flecsEngine_bindGroups_beginFrame(impl);
     flecsEngine_renderView_renderAll(
-        it->world, impl, frame_target.view_texture, encoder);
+        it->world, impl, frame_target.view_texture, &encoder);
+    if (!encoder) {
+        failed = true;
+        goto cleanup;
+    }
 
     if (flecsEngine_surfaceInterface_encodeFrame(
         surface_impl, impl, encoder, &frame_target))
@@ -457,6 +541,8 @@ static void FlecsEngineRender(
         goto cleanup;
     }
 
+    flecsEngine_gpuTimer_endFrame(impl, encoder);
+
     WGPUCommandBufferDescriptor cmd_desc = {0};
     cmd = wgpuCommandEncoderFinish(encoder, &cmd_desc);
     if (!cmd) {
@@ -465,7 +551,21 @@ static void FlecsEngineRender(
         goto cleanup;
     }
 
-    wgpuQueueSubmit(impl->queue, 1, &cmd);
+    /* Submit together with command buffers of passes that were encoded
+     * separately, e.g. shadow cascades. */
+    flecsEngine_frameCommands_append(impl, cmd);
+    cmd = NULL;
+
+    flecsEngine_cpuTimer_begin(impl, FlecsCpuStageSubmit);
+
+    if (impl->render_thread) {
+        /* Hands off command buffers and the frame target */
+        flecsEngine_renderThread_submit(impl, &frame_target);
+        flecsEngine_cpuTimer_end(impl, FlecsCpuStageSubmit);
+        goto cleanup;
+    }
+
+    flecsEngine_frameCommands_submit(impl);
 
     if (flecsEngine_surfaceInterface_submitFrame(
         surface_impl, it->world, impl, &frame_target))
@@ -473,7 +573,10 @@ static void FlecsEngineRender(
         failed = true;
     }
 
+    flecsEngine_cpuTimer_end(impl, FlecsCpuStageSubmit);
+
 cleanup:
+    flecsEngine_frameCommands_clear(impl);
     if (cmd) {
         wgpuCommandBufferRelease(cmd);
     }
@@ -484,11 +587,20 @@ cleanup:
     flecsEngine_releaseFrameTarget(&frame_target);
 
     if (failed) {
+        flecsEngine_gpuTimer_discardFrame(impl);
         flecsEngine_surfaceInterface_onFrameFailed(
             surface_impl, it->world, impl);
     }
 }
 
+static void FlecsEngineRender(
+    ecs_iter_t *it)
+{
+    uint64_t trace_start = flecsEngine_trace_begin();
+    flecsEngine_renderFrame(it);
+    flecsEngine_trace_end(trace_start, "system", "FlecsEngineRender", NULL);
+}
+
 void FlecsEngineRendererImport(
     ecs_world_t *world)
 {
@@ -559,12 +671,22 @@ void FlecsEngineRendererImport(
         .members = {
             { .name = "source", .type = ecs_id(ecs_string_t) },
             { .name = "vertex_entry", .type = ecs_id(ecs_string_t) },
-            { .name = "fragment_entry", .type = ecs_id(ecs_string_t) }
+            { .name = "fragment_entry", .type = ecs_id(ecs_string_t) },
+            { .name = "defines", .type = ecs_id(ecs_string_t) }
         }
     });
 
     flecsEngine_shader_register(world);
+    flecsEngine_bindGroups_register(world);
+    flecsEngine_frameSync_register(world);
+    flecsEngine_gpuTimer_register(world);
+    flecsEngine_cpuTimer_register(world);
+    flecsEngine_dynamicResolution_register(world);
+    flecsEngine_renderGraph_register(world);
+    flecsEngine_renderStats_register(world);
+    flecsEngine_gpuMemory_register(world);
     flecsEngine_renderBatch_register(world);
+    flecsEngine_batchSets_register(world);
     flecsEngine_renderEffect_register(world);
     flecsEngine_renderView_register(world);
     flecsEngine_ibl_register(world);
@@ -572,6 +694,8 @@ void FlecsEngineRendererImport(
     flecsEngine_bloom_register(world);
     flecsEngine_exponentialHeightFog_register(world);
     flecsEngine_ssao_register(world);
+    flecsEngine_fxaa_register(world);
+    flecsEngine_taa_register(world);
 
     /* Register FlecsTextureImpl (renderer-side companion for FlecsTexture) */
     ECS_COMPONENT_DEFINE(world, FlecsTextureImpl);
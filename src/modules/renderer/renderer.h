@@ -11,6 +11,9 @@
 
 #define FLECS_ENGINE_SHADOW_MAP_SIZE_DEFAULT 4096
 
+/* Alignment of dynamic uniform buffer offsets (WebGPU default limit) */
+#define FLECS_ENGINE_UNIFORM_OFFSET_ALIGNMENT 256
+
 struct FlecsRenderBatch;
 struct FlecsRenderEffect;
 extern ECS_TAG_DECLARE(FlecsSkyboxBatch);
@@ -21,6 +24,7 @@ typedef void (*flecs_render_batch_callback)(
     const ecs_world_t *world,
     const FlecsEngineImpl *engine,
     const WGPURenderPassEncoder pass,
+    const flecs_engine_pass_state_t *state,
     const struct FlecsRenderBatch *batch);
 
 typedef void (*flecs_render_batch_extract_callback)(
@@ -75,6 +79,18 @@ ECS_PRIVATE
 
 // Fullscreen post-process effect. Input uses chain indexing:
 // 0 = batches framebuffer, k > 0 = output of effect[k - 1].
+// Effects that set jitter resolve sub-pixel camera jitter, which is applied
+// to the camera of the view while the effect is enabled. Effects that set
+// upscale reconstruct output resolution from the render viewport, and write
+// the view texture directly when they are the last enabled effect.
+// Pointwise effects only read the input pixel at the output position. They
+// set pointwise to a WGSL stage that declares its resources in @group(0) from
+// binding 2, and defines pointwise_fn as fn(color, pos, uv) -> vec4<f32>.
+// Adjacent pointwise effects are fused into a single pass, in which each stage
+// reads its resources from its own bind group.
+// Effects that set ldr_output (tonemappers) write colors in [0, 1], which lets
+// views with packed_effect_targets store their output, and the output of the
+// effects after it, in an 8 bit target.
 ECS_STRUCT(FlecsRenderEffect, {
     ecs_entity_t shader;
     int32_t input;
@@ -84,6 +100,11 @@ ECS_PRIVATE
     flecs_render_effect_render_callback render_callback;
     void *ctx;
     void (*free_ctx)(void *ctx);
+    bool jitter;
+    bool upscale;
+    const char *pointwise;
+    const char *pointwise_fn;
+    bool ldr_output;
 });
 
 int flecsEngine_initPassthrough(
@@ -92,6 +113,55 @@ int flecsEngine_initPassthrough(
 int flecsEngine_initDepthResolve(
     FlecsEngineImpl *impl);
 
+int flecsEngine_initUpscale(
+    FlecsEngineImpl *impl);
+
+void flecsEngine_releaseUpscale(
+    FlecsEngineImpl *impl);
+
+/* Upscale the render viewport of input_view to the view texture. */
+bool flecsEngine_upscale(
+    FlecsEngineImpl *impl,
+    FlecsRenderViewImpl *view_impl,
+    WGPUCommandEncoder encoder,
+    WGPUTextureView input_view,
+    WGPUTextureView view_texture);
+
+/* True if views render below output resolution, in which case the effect
+ * chain ends with the upscale pass. */
+bool flecsEngine_needsUpscale(
+    const FlecsEngineImpl *impl);
+
+/* Index of the last enabled effect of a view, or -1 if there is none. */
+int32_t flecsEngine_renderView_lastEffect(
+    const FlecsRenderView *view);
+
+/* True if the last enabled effect of the view writes the view texture at
+ * output resolution, in which case the upscale pass is skipped. */
+bool flecsEngine_renderView_effectUpscales(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *impl,
+    const FlecsRenderView *view);
+
+/* Declare the passes of the view's effect chain on the render graph, so that
+ * effect targets with non-overlapping lifetimes share a texture. */
+void flecsEngine_renderView_planEffects(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    const FlecsRenderView *view,
+    flecs_engine_render_graph_t *graph);
+
+/* Release pipelines of fused pointwise effects. */
+void flecsEngine_renderView_releaseFusedEffects(
+    FlecsRenderViewImpl *view_impl);
+
+/* Restrict a pass that writes a view target to the render viewport. View
+ * targets are allocated at the actual size, and with dynamic resolution only
+ * their top-left region is rendered to. */
+void flecsEngine_setRenderViewport(
+    const FlecsEngineImpl *impl,
+    WGPURenderPassEncoder pass);
+
 void flecsEngine_depthResolve(
     const FlecsEngineImpl *impl,
     WGPUCommandEncoder encoder);
@@ -133,6 +203,12 @@ void flecsEngine_exponentialHeightFog_register(
 void flecsEngine_ssao_register(
     ecs_world_t *world);
 
+void flecsEngine_fxaa_register(
+    ecs_world_t *world);
+
+void flecsEngine_taa_register(
+    ecs_world_t *world);
+
 ecs_entity_t flecsEngine_shader_ensure(
     ecs_world_t *world,
     const char *name,
@@ -151,7 +227,7 @@ void flecsEngine_renderView_renderAll(
     ecs_world_t *world,
     FlecsEngineImpl *impl,
     WGPUTextureView view_texture,
-    WGPUCommandEncoder encoder);
+    WGPUCommandEncoder *encoder);
 
 void flecsEngine_material_uploadBuffer(
     const ecs_world_t *world,
@@ -181,31 +257,80 @@ bool flecsEngine_ibl_createRuntimeBindGroup(
 void flecsEngine_ibl_releaseResources(
     FlecsEngineImpl *impl);
 
+/* Resolve the IBL impls that batches of a view bind. Returns false if an
+ * impl is missing. */
+bool flecsEngine_renderBatch_resolveIbl(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine,
+    const FlecsRenderView *view,
+    flecs_engine_view_ibl_t *out);
+
 void flecsEngine_renderBatch_render(
     ecs_world_t *world,
     FlecsEngineImpl *impl,
     const WGPURenderPassEncoder pass,
-    const FlecsRenderView *view,
-    ecs_entity_t batch_entity);
+    flecs_engine_pass_state_t *state,
+    const flecs_engine_view_ibl_t *view_ibl,
+    flecs_engine_render_item_t *item);
+
+/* Features that batch shaders must be compiled with for the current scene,
+ * as FLECS_ENGINE_BATCH_FEATURE_* flags. */
+uint32_t flecsEngine_renderBatch_sceneFeatures(
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine);
 
 void flecsEngine_renderBatch_extract(
     ecs_world_t *world,
     FlecsEngineImpl *impl,
-    ecs_entity_t batch_entity);
+    flecs_engine_render_item_t *item);
+
+void flecsEngine_renderBatch_setupCamera(
+    const ecs_world_t *world,
+    FlecsUniform *uniforms,
+    ecs_entity_t entity);
+
+void flecsEngine_renderBatch_setupLight(
+    const ecs_world_t *world,
+    FlecsUniform *uniforms,
+    ecs_entity_t entity);
+
+/* Round a uniform block size up to the dynamic offset alignment. */
+uint32_t flecsEngine_uniformStride(
+    uint64_t size);
+
+int flecsEngine_viewUniforms_init(
+    FlecsEngineImpl *engine);
+
+void flecsEngine_viewUniforms_cleanup(
+    FlecsEngineImpl *engine);
+
+/* Make sure there is a uniform slot for each view. Bumps the version when the
+ * buffer is recreated so batches rebuild their bind groups. */
+int flecsEngine_viewUniforms_ensure(
+    FlecsEngineImpl *engine,
+    int32_t view_count);
+
+/* Compute the FlecsUniform block of a view once and upload it to the slot of
+ * the view. Must be called after the shadow cascades for the view are known. */
+void flecsEngine_viewUniforms_update(
+    const ecs_world_t *world,
+    FlecsEngineImpl *engine,
+    const FlecsRenderView *view);
 
 void flecsEngine_renderView_renderBatches(
     ecs_world_t *world,
     ecs_entity_t view_entity,
     FlecsEngineImpl *engine,
     const FlecsRenderView *view,
-    const FlecsRenderViewImpl *viewImpl,
+    FlecsRenderViewImpl *viewImpl,
     WGPUCommandEncoder encoder);
 
 void flecsEngine_renderView_extractBatches(
     ecs_world_t *world,
     ecs_entity_t view_entity,
     FlecsEngineImpl *engine,
-    const FlecsRenderView *view);
+    const FlecsRenderView *view,
+    FlecsRenderViewImpl *viewImpl);
 
 void flecsEngine_renderEffect_render(
     const ecs_world_t *world,
@@ -213,7 +338,7 @@ void flecsEngine_renderEffect_render(
     const WGPURenderPassEncoder pass,
     ecs_entity_t effect_entity,
     const FlecsRenderEffect *effect,
-    const FlecsRenderEffectImpl *effect_impl,
+    FlecsRenderEffectImpl *effect_impl,
     WGPUTextureView input_view,
     WGPUTextureFormat output_format);
 
@@ -230,6 +355,441 @@ const FlecsShaderImpl* flecsEngine_shader_ensureImpl(
     ecs_world_t *world,
     ecs_entity_t shader_entity);
 
+/* Create a variant of a shader asset that is compiled with additional
+ * defines. Variants are stored as children of the base shader entity. */
+ecs_entity_t flecsEngine_shader_ensureVariant(
+    ecs_world_t *world,
+    ecs_entity_t shader_entity,
+    const char *defines);
+
+void flecsEngine_shaderCache_init(
+    FlecsEngineImpl *engine);
+
+void flecsEngine_shaderCache_fini(
+    FlecsEngineImpl *engine);
+
+void flecsEngine_shaderCache_publishStats(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine);
+
+/* Return a cached module for the WGSL source, compiling it on first use. The
+ * module is owned by the cache and must not be released by the caller. */
+WGPUShaderModule flecsEngine_shaderCache_get(
+    FlecsEngineImpl *engine,
+    const char *wgsl_source);
+
+/* Create a bind group and count it in the bind group stats. */
+WGPUBindGroup flecsEngine_createBindGroup(
+    const FlecsEngineImpl *engine,
+    const WGPUBindGroupDescriptor *desc);
+
+/* Return a bind group for the entries, creating it on a cache miss. The bind
+ * group is owned by the cache and must not be released by the caller. */
+WGPUBindGroup flecsEngine_bindGroupCache_get(
+    const FlecsEngineImpl *engine,
+    flecs_engine_bind_group_cache_t *cache,
+    WGPUBindGroupLayout layout,
+    const WGPUBindGroupEntry *entries,
+    uint32_t entry_count);
+
+void flecsEngine_bindGroupCache_fini(
+    flecs_engine_bind_group_cache_t *cache);
+
+/* Must be called when textures that are bound by cached bind groups are
+ * recreated, so stale bind groups are rebuilt. */
+void flecsEngine_bindGroups_invalidate(
+    const FlecsEngineImpl *engine);
+
+void flecsEngine_bindGroups_beginFrame(
+    FlecsEngineImpl *engine);
+
+void flecsEngine_bindGroups_publishStats(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine);
+
+void flecsEngine_bindGroups_register(
+    ecs_world_t *world);
+
+void flecsEngine_frameSync_init(
+    FlecsEngineImpl *engine,
+    int32_t frames_in_flight);
+
+/* Wait for all frames in flight and free the fences. */
+void flecsEngine_frameSync_fini(
+    FlecsEngineImpl *engine);
+
+/* Advance to the next frame slot, waiting for the GPU if the frame that last
+ * used the slot is still executing. */
+void flecsEngine_frameSync_begin(
+    FlecsEngineImpl *engine);
+
+/* Arm the fence of the current slot. Must be called after the command
+ * buffers of the frame are submitted. */
+void flecsEngine_frameSync_signal(
+    const FlecsEngineImpl *engine);
+
+void flecsEngine_frameSync_publishStats(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine);
+
+void flecsEngine_frameSync_register(
+    ecs_world_t *world);
+
+/* Count work of the view that is being rendered. No-ops outside of views. */
+void flecsEngine_renderStats_draw(
+    const flecs_engine_pass_state_t *state,
+    uint32_t index_count,
+    uint32_t instance_count);
+
+void flecsEngine_renderStats_pipelineSwitch(
+    const flecs_engine_pass_state_t *state);
+
+void flecsEngine_renderStats_bindGroupSwitch(
+    const flecs_engine_pass_state_t *state);
+
+void flecsEngine_renderStats_createBuffer(
+    const FlecsEngineImpl *engine);
+
+void flecsEngine_renderStats_createTexture(
+    const FlecsEngineImpl *engine);
+
+void flecsEngine_renderStats_write(
+    const FlecsEngineImpl *engine,
+    size_t size);
+
+void flecsEngine_renderStats_cull(
+    const FlecsEngineImpl *engine,
+    int32_t visible,
+    int32_t culled);
+
+/* Add the counters of a shadow cascade to the view. */
+void flecsEngine_renderStats_addCascade(
+    const FlecsEngineImpl *engine,
+    int32_t cascade,
+    const flecs_engine_render_counters_t *counters);
+
+/* Publish counters of the last rendered frame as FlecsRenderViewStats. */
+void flecsEngine_renderStats_publish(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine);
+
+/* Publish the commands recorded by the null GPU backend as
+ * FlecsGpuCommandStats. Does nothing on other backends. */
+void flecsEngine_renderStats_publishCommands(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine);
+
+void flecsEngine_renderStats_register(
+    ecs_world_t *world);
+
+/* Stage of a timed pass, used to sum up the GPU time of a view */
+typedef enum {
+    FlecsGpuStageShadow,
+    FlecsGpuStageBatches,
+    FlecsGpuStageEffects
+} flecs_engine_gpu_stage_t;
+
+/* Create timestamp queries. Returns NULL if the device doesn't support them,
+ * in which case all other gpuTimer functions are no-ops. */
+flecs_engine_gpu_timer_t* flecsEngine_gpuTimer_create(
+    const FlecsEngineImpl *engine);
+
+/* Wait for pending readbacks and release the queries. */
+void flecsEngine_gpuTimer_free(
+    flecs_engine_gpu_timer_t *timer);
+
+/* Publish timings of earlier frames that the GPU is done with, and start
+ * timing the frame if enabled by the FlecsGpuTiming singleton. Must be called
+ * after the previous frame was submitted. */
+void flecsEngine_gpuTimer_beginFrame(
+    ecs_world_t *world,
+    FlecsEngineImpl *engine);
+
+/* Set the view that passes reserved from now on belong to. */
+void flecsEngine_gpuTimer_setView(
+    const FlecsEngineImpl *engine,
+    ecs_entity_t view);
+
+/* Timestamp writes for a render pass descriptor. Returns NULL when the frame
+ * isn't timed. The writes stay valid until the end of the frame. */
+const WGPUPassTimestampWrites* flecsEngine_gpuTimer_pass(
+    const FlecsEngineImpl *engine,
+    flecs_engine_gpu_stage_t stage,
+    const char *name);
+
+/* Time the passes encoded between begin and end, for passes that are encoded
+ * by callbacks. Returns the scope to pass to end, -1 if the frame isn't
+ * timed. */
+int32_t flecsEngine_gpuTimer_begin(
+    const FlecsEngineImpl *engine,
+    WGPUCommandEncoder encoder,
+    flecs_engine_gpu_stage_t stage,
+    const char *name,
+    ecs_entity_t effect);
+
+void flecsEngine_gpuTimer_end(
+    const FlecsEngineImpl *engine,
+    WGPUCommandEncoder encoder,
+    int32_t scope);
+
+/* Resolve the timestamps of the frame. Must be encoded after all timed
+ * passes, into the last command buffer of the frame. */
+void flecsEngine_gpuTimer_endFrame(
+    FlecsEngineImpl *engine,
+    WGPUCommandEncoder encoder);
+
+/* Drop the timestamps of a frame that failed before it was submitted. */
+void flecsEngine_gpuTimer_discardFrame(
+    FlecsEngineImpl *engine);
+
+void flecsEngine_gpuTimer_register(
+    ecs_world_t *world);
+
+/* CPU stages of a frame */
+typedef enum {
+    FlecsCpuStageFrustum,
+    FlecsCpuStageBatchExtract,
+    FlecsCpuStageLights,
+    FlecsCpuStageCluster,
+    FlecsCpuStageShadow,
+    FlecsCpuStageBatches,
+    FlecsCpuStageEffects,
+    FlecsCpuStageSubmit,
+    FlecsCpuStageAcquire,
+    FlecsCpuStageCount
+} flecs_engine_cpu_stage_t;
+
+flecs_engine_cpu_timer_t* flecsEngine_cpuTimer_create(void);
+
+void flecsEngine_cpuTimer_free(
+    flecs_engine_cpu_timer_t *timer);
+
+/* Publish the stats of the previous frame and start timing the next frame if
+ * enabled by the FlecsCpuTiming singleton. */
+void flecsEngine_cpuTimer_beginFrame(
+    ecs_world_t *world,
+    FlecsEngineImpl *engine);
+
+/* Time a stage. Stages can be timed more than once per frame, but can't be
+ * nested in themselves. Stages are also recorded in the trace. No-ops when
+ * timing and tracing are disabled. */
+void flecsEngine_cpuTimer_begin(
+    const FlecsEngineImpl *engine,
+    flecs_engine_cpu_stage_t stage);
+
+void flecsEngine_cpuTimer_end(
+    const FlecsEngineImpl *engine,
+    flecs_engine_cpu_stage_t stage);
+
+void flecsEngine_cpuTimer_register(
+    ecs_world_t *world);
+
+typedef enum {
+    FlecsGpuMemoryMesh,
+    FlecsGpuMemoryTexture,
+    FlecsGpuMemoryIbl,
+    FlecsGpuMemoryShadow,
+    FlecsGpuMemoryRenderTarget,
+    FlecsGpuMemoryEffect,
+    FlecsGpuMemoryInstance,
+    FlecsGpuMemoryUniform,
+    FlecsGpuMemoryOther,
+    FlecsGpuMemoryCategoryCount
+} flecs_engine_gpu_memory_category_t;
+
+/* GPU memory is tracked process wide, since resources are also released from
+ * component destructors that have no access to the engine. Resources must be
+ * created and released on the main thread. */
+
+/* Create a buffer and add its size to a category. Buffers created with this
+ * function must be released with flecsEngine_gpuMemory_releaseBuffer. */
+WGPUBuffer flecsEngine_gpuMemory_createBuffer(
+    WGPUDevice device,
+    flecs_engine_gpu_memory_category_t category,
+    const WGPUBufferDescriptor *desc);
+
+/* Release a buffer and subtract its size from a category. Accepts NULL. */
+void flecsEngine_gpuMemory_releaseBuffer(
+    flecs_engine_gpu_memory_category_t category,
+    WGPUBuffer buffer);
+
+WGPUTexture flecsEngine_gpuMemory_createTexture(
+    WGPUDevice device,
+    flecs_engine_gpu_memory_category_t category,
+    const WGPUTextureDescriptor *desc);
+
+void flecsEngine_gpuMemory_releaseTexture(
+    flecs_engine_gpu_memory_category_t category,
+    WGPUTexture texture);
+
+/* Size of a texture with all of its mips, layers and samples. */
+int64_t flecsEngine_gpuMemory_textureBytes(
+    WGPUTextureFormat format,
+    WGPUTextureDimension dimension,
+    uint32_t width,
+    uint32_t height,
+    uint32_t depth_or_layers,
+    uint32_t mip_count,
+    uint32_t sample_count);
+
+/* Publish the FlecsGpuMemory singleton and check the budget. */
+void flecsEngine_gpuMemory_publishStats(
+    ecs_world_t *world);
+
+void flecsEngine_gpuMemory_register(
+    ecs_world_t *world);
+
+/* Run the dynamic resolution controller and compute the render viewport
+ * for the frame. The frame delta is only used if the frame isn't timed. */
+void flecsEngine_dynamicResolution_begin(
+    const ecs_world_t *world,
+    FlecsEngineImpl *engine,
+    float delta_time);
+
+void flecsEngine_dynamicResolution_publishStats(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine);
+
+void flecsEngine_dynamicResolution_register(
+    ecs_world_t *world);
+
+/* Reset the graph for a frame with target_count logical targets. */
+void flecsEngine_renderGraph_begin(
+    flecs_engine_render_graph_t *graph,
+    int32_t target_count);
+
+/* Set the format of a logical target. Targets only share a texture when
+ * their formats are the same. */
+void flecsEngine_renderGraph_setFormat(
+    flecs_engine_render_graph_t *graph,
+    int32_t target,
+    WGPUTextureFormat format);
+
+WGPUTextureFormat flecsEngine_renderGraph_targetFormat(
+    const flecs_engine_render_graph_t *graph,
+    int32_t target);
+
+/* Format of a texture assigned by the last compile. */
+WGPUTextureFormat flecsEngine_renderGraph_slotFormat(
+    const flecs_engine_render_graph_t *graph,
+    int32_t slot);
+
+/* Add a pass that reads and writes a logical target, in execution order.
+ * Use -1 for a pass that reads nothing or writes the view texture. */
+void flecsEngine_renderGraph_addPass(
+    flecs_engine_render_graph_t *graph,
+    int32_t read,
+    int32_t write);
+
+/* Assign textures to targets. With alias set, targets whose lifetimes don't
+ * overlap share a texture, otherwise each target gets its own. Returns the
+ * number of textures needed. */
+int32_t flecsEngine_renderGraph_compile(
+    flecs_engine_render_graph_t *graph,
+    bool alias);
+
+/* Texture assigned to a target by the last compile, -1 if unused. */
+int32_t flecsEngine_renderGraph_targetSlot(
+    const flecs_engine_render_graph_t *graph,
+    int32_t target);
+
+void flecsEngine_renderGraph_fini(
+    flecs_engine_render_graph_t *graph);
+
+/* Size of a texel block in bytes. Block_dim is set to the width and height
+ * of a block in texels, which is 1 for formats that aren't compressed. */
+int64_t flecsEngine_textureBlockSize(
+    WGPUTextureFormat format,
+    uint32_t *block_dim);
+
+/* Approximate size of a single mip level texture. */
+int64_t flecsEngine_textureBytes(
+    WGPUTextureFormat format,
+    uint32_t width,
+    uint32_t height);
+
+void flecsEngine_renderGraph_publishStats(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine);
+
+void flecsEngine_renderGraph_register(
+    ecs_world_t *world);
+
+/* Start worker threads for encoding. Returns NULL if the platform has no
+ * threads, in which case jobs are encoded on the calling thread. */
+flecs_engine_encode_pool_t* flecsEngine_encodePool_create(void);
+
+void flecsEngine_encodePool_free(
+    flecs_engine_encode_pool_t *pool);
+
+/* Hand jobs to the workers. Returns without waiting for the jobs, so the
+ * caller can encode other passes in the meantime. */
+void flecsEngine_encodePool_begin(
+    flecs_engine_encode_pool_t *pool,
+    flecs_engine_encode_job_t *jobs,
+    int32_t job_count);
+
+/* Wait until all jobs passed to begin are done. Runs the jobs on the calling
+ * thread if there is no pool. */
+void flecsEngine_encodePool_end(
+    flecs_engine_encode_pool_t *pool,
+    flecs_engine_encode_job_t *jobs,
+    int32_t job_count);
+
+void flecsEngine_frameCommands_append(
+    FlecsEngineImpl *engine,
+    WGPUCommandBuffer cmd);
+
+/* Finish the encoder into the frame command list and replace it with a new
+ * encoder, so command buffers appended next are submitted before it. */
+int flecsEngine_frameCommands_flush(
+    FlecsEngineImpl *engine,
+    WGPUCommandEncoder *encoder);
+
+/* Submit the command buffers of the frame in the order they were added. */
+void flecsEngine_frameCommands_submit(
+    FlecsEngineImpl *engine);
+
+void flecsEngine_frameCommands_clear(
+    FlecsEngineImpl *engine);
+
+void flecsEngine_frameCommands_fini(
+    FlecsEngineImpl *engine);
+
+void flecsEngine_releaseFrameTarget(
+    FlecsEngineSurface *target);
+
+/* Start the thread that submits and presents frames. Returns NULL if threads
+ * aren't available, in which case frames are submitted by the main thread. */
+flecs_engine_render_thread_t* flecsEngine_renderThread_create(void);
+
+void flecsEngine_renderThread_free(
+    flecs_engine_render_thread_t *rt);
+
+/* Wait until the render thread is done with the previous frame. */
+void flecsEngine_renderThread_wait(
+    flecs_engine_render_thread_t *rt);
+
+/* Returns true if no frame is in flight, so that the queue can be used
+ * directly. Also true without a render thread. */
+bool flecsEngine_renderThread_idle(
+    flecs_engine_render_thread_t *rt);
+
+/* Hand off the frame command buffers, staged buffer writes and target to the
+ * render thread. Takes ownership of the target. */
+void flecsEngine_renderThread_submit(
+    FlecsEngineImpl *engine,
+    FlecsEngineSurface *target);
+
+/* Write to a buffer on the queue. With a render thread the write is staged and
+ * replayed right before the command buffers of the frame are submitted. */
+void flecsEngine_queueWriteBuffer(
+    const FlecsEngineImpl *engine,
+    WGPUBuffer buffer,
+    uint64_t offset,
+    const void *data,
+    size_t size);
+
 FlecsDefaultAttrCache* flecsEngine_defaultAttrCache_create(void);
 
 void flecsEngine_defaultAttrCache_free(
@@ -257,6 +817,10 @@ int flecsEngine_cluster_init(
 void flecsEngine_cluster_cleanup(
     FlecsEngineImpl *impl);
 
+int flecsEngine_cluster_ensureViewCapacity(
+    FlecsEngineImpl *engine,
+    int32_t view_capacity);
+
 bool flecsEngine_cluster_ensureLights(
     FlecsEngineImpl *engine, int32_t needed);
 
@@ -273,6 +837,10 @@ int flecsEngine_shadow_init(
 void flecsEngine_shadow_cleanup(
     FlecsEngineImpl *impl);
 
+int flecsEngine_shadow_ensureViewCapacity(
+    FlecsEngineImpl *impl,
+    int32_t view_count);
+
 int flecsEngine_shadow_ensureSize(
     ecs_world_t *world,
     FlecsEngineImpl *impl,
@@ -287,18 +855,54 @@ void flecsEngine_shadow_computeCascades(
     mat4 out_light_vp[FLECS_ENGINE_SHADOW_CASCADE_COUNT],
     float out_splits[FLECS_ENGINE_SHADOW_CASCADE_COUNT]);
 
+/* Batch that renders into the shadow maps, resolved on the main thread so
+ * cascade encoders don't access entity refs. */
+typedef struct {
+    const FlecsRenderBatch *batch;
+    const FlecsRenderBatchImpl *impl;
+} flecs_engine_shadow_caster_t;
+
+typedef struct {
+    const ecs_world_t *world;
+    const FlecsEngineImpl *engine; /* Shared with the other cascades */
+    flecs_engine_pass_state_t state;
+    const flecs_engine_shadow_caster_t *casters;
+    int32_t caster_count;
+    int32_t cascade;
+    const WGPUPassTimestampWrites *timestamp_writes; /* NULL if not timed */
+    flecs_engine_render_counters_t counters; /* Added to the view when done */
+    WGPUCommandBuffer cmd;
+} flecs_engine_shadow_cascade_t;
+
+/* Shadow cascades of a view, each encoded into its own command buffer. */
+typedef struct {
+    flecs_engine_shadow_cascade_t cascades[FLECS_ENGINE_SHADOW_CASCADE_COUNT];
+    flecs_engine_encode_job_t jobs[FLECS_ENGINE_SHADOW_CASCADE_COUNT];
+    int32_t job_count;
+} flecs_engine_shadow_pass_t;
+
 void flecsEngine_renderBatch_renderShadow(
-    ecs_world_t *world,
-    FlecsEngineImpl *engine,
+    const ecs_world_t *world,
+    const FlecsEngineImpl *engine,
     const WGPURenderPassEncoder pass,
-    ecs_entity_t batch_entity);
+    flecs_engine_pass_state_t *state,
+    const flecs_engine_shadow_caster_t *caster);
 
+/* Start encoding the shadow cascades of a view. Cascades may be encoded on
+ * worker threads until flecsEngine_renderView_finishShadow is called. */
 void flecsEngine_renderView_renderShadow(
     ecs_world_t *world,
     ecs_entity_t view_entity,
     FlecsEngineImpl *engine,
     const FlecsRenderView *view,
-    WGPUCommandEncoder encoder);
+    FlecsRenderViewImpl *viewImpl,
+    flecs_engine_shadow_pass_t *shadow_pass);
+
+/* Wait for the cascades of a view and add their command buffers to the frame
+ * in cascade order. */
+void flecsEngine_renderView_finishShadow(
+    FlecsEngineImpl *engine,
+    flecs_engine_shadow_pass_t *shadow_pass);
 
 /* Shared ECS_DTOR + ECS_MOVE pair for types whose cleanup is a single
  * release function.  The destructor calls release_fn(ptr), and the move
@@ -311,7 +915,10 @@ void flecsEngine_renderView_renderShadow(
     })
 
 /* Shared fullscreen-triangle vertex shader used by all post-process effects.
- * Produces a single triangle covering clip space with correct UVs. */
+ * Produces a single triangle covering clip space with correct UVs. The UV
+ * spans the render viewport, which can be smaller than the view targets. View
+ * targets are sampled with fullscreen_uv(), which maps the fragment position
+ * to the UV of the same texel in a texture. */
 #define FLECS_ENGINE_FULLSCREEN_VS_WGSL \
     "struct VertexOutput {\n" \
     "  @builtin(position) pos : vec4<f32>,\n" \
@@ -327,6 +934,22 @@ void flecsEngine_renderView_renderShadow(
     "  out.pos = vec4<f32>(p, 0.0, 1.0);\n" \
     "  out.uv = vec2<f32>((p.x + 1.0) * 0.5, (1.0 - p.y) * 0.5);\n" \
     "  return out;\n" \
+    "}\n" \
+    "fn fullscreen_uv(pos : vec4<f32>, dims : vec2<u32>) -> vec2<f32> {\n" \
+    "  return pos.xy / vec2<f32>(dims);\n" \
+    "}\n"
+
+/* Shader of a pointwise effect that runs by itself. The stage is the same
+ * WGSL that is used when the effect is fused with its neighbours. */
+#define FLECS_ENGINE_POINTWISE_EFFECT_WGSL(stage, apply_fn) \
+    FLECS_ENGINE_FULLSCREEN_VS_WGSL \
+    "@group(0) @binding(0) var input_texture : texture_2d<f32>;\n" \
+    "@group(0) @binding(1) var input_sampler : sampler;\n" \
+    stage \
+    "@fragment fn fs_main(in : VertexOutput) -> @location(0) vec4<f32> {\n" \
+    "  let src = textureSample(input_texture, input_sampler,\n" \
+    "    fullscreen_uv(in.pos, textureDimensions(input_texture)));\n" \
+    "  return " apply_fn "(src, in.pos, in.uv);\n" \
     "}\n"
 
 /* Create a WGPUShaderModule from a WGSL source string. */
@@ -342,6 +965,15 @@ WGPUTexture flecsEngine_texture_loadFile(
     WGPUQueue queue,
     const char *path);
 
+/* Box filter an RGBA8 image into the next mip level. */
+void flecsEngine_texture_downsample(
+    const uint8_t *src,
+    uint32_t src_w,
+    uint32_t src_h,
+    uint8_t *dst,
+    uint32_t dst_w,
+    uint32_t dst_h);
+
 WGPUTexture flecsEngine_texture_create1x1(
     WGPUDevice device,
     WGPUQueue queue,
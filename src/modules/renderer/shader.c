@@ -3,6 +3,9 @@
 
 ECS_COMPONENT_DECLARE(FlecsShader);
 ECS_COMPONENT_DECLARE(FlecsShaderImpl);
+ECS_COMPONENT_DECLARE(FlecsShaderCacheStats);
+
+#define FLECS_ENGINE_SHADER_PP_MAX_DEPTH (16)
 
 WGPUShaderModule flecsEngine_createShaderModule(
     WGPUDevice device,
@@ -21,13 +24,289 @@ WGPUShaderModule flecsEngine_createShaderModule(
         });
 }
 
+static uint64_t flecsEngine_shader_hash(
+    const char *str)
+{
+    /* FNV-1a */
+    uint64_t hash = 14695981039346656037ull;
+    for (const char *ptr = str; *ptr; ptr ++) {
+        hash ^= (uint8_t)*ptr;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void flecsEngine_shaderCache_init(
+    FlecsEngineImpl *engine)
+{
+    ecs_map_init(&engine->shader_cache.modules, NULL);
+    engine->shader_cache.module_count = 0;
+    engine->shader_cache.compile_count = 0;
+    engine->shader_cache.hit_count = 0;
+}
+
+void flecsEngine_shaderCache_fini(
+    FlecsEngineImpl *engine)
+{
+    if (!ecs_map_is_init(&engine->shader_cache.modules)) {
+        return;
+    }
+
+    ecs_map_iter_t it = ecs_map_iter(&engine->shader_cache.modules);
+    while (ecs_map_next(&it)) {
+        flecs_engine_shader_module_t *entry = ecs_map_ptr(&it);
+        while (entry) {
+            flecs_engine_shader_module_t *next = entry->next;
+            if (entry->module) {
+                wgpuShaderModuleRelease(entry->module);
+            }
+            ecs_os_free(entry->source);
+            ecs_os_free(entry);
+            entry = next;
+        }
+    }
+
+    ecs_map_fini(&engine->shader_cache.modules);
+    engine->shader_cache.module_count = 0;
+}
+
+WGPUShaderModule flecsEngine_shaderCache_get(
+    FlecsEngineImpl *engine,
+    const char *wgsl_source)
+{
+    flecs_engine_shader_cache_t *cache = &engine->shader_cache;
+    uint64_t key = flecsEngine_shader_hash(wgsl_source);
+
+    ecs_map_val_t *existing = ecs_map_get(&cache->modules, key);
+    flecs_engine_shader_module_t *first = existing
+        ? (flecs_engine_shader_module_t*)(uintptr_t)*existing
+        : NULL;
+
+    for (flecs_engine_shader_module_t *entry = first; entry;
+        entry = entry->next)
+    {
+        if (!ecs_os_strcmp(entry->source, wgsl_source)) {
+            cache->hit_count ++;
+            return entry->module;
+        }
+    }
+
+    uint64_t trace_start = flecsEngine_trace_begin();
+    WGPUShaderModule module = flecsEngine_createShaderModule(
+        engine->device, wgsl_source);
+    flecsEngine_trace_end(trace_start, "pipeline", "shader_compile", NULL);
+    if (!module) {
+        return NULL;
+    }
+
+    flecs_engine_shader_module_t *entry =
+        ecs_os_calloc_t(flecs_engine_shader_module_t);
+    entry->source = ecs_os_strdup(wgsl_source);
+    entry->module = module;
+    entry->next = first;
+
+    if (existing) {
+        *existing = (ecs_map_val_t)(uintptr_t)entry;
+    } else {
+        ecs_map_insert(&cache->modules, key, (ecs_map_val_t)(uintptr_t)entry);
+    }
+
+    cache->module_count ++;
+    cache->compile_count ++;
+    return module;
+}
+
+void flecsEngine_shaderCache_publishStats(
+    ecs_world_t *world,
+    const FlecsEngineImpl *engine)
+{
+    const flecs_engine_shader_cache_t *cache = &engine->shader_cache;
+    const FlecsShaderCacheStats *stats = ecs_singleton_get(
+        world, FlecsShaderCacheStats);
+    if (stats &&
+        stats->module_count == cache->module_count &&
+        stats->compile_count == cache->compile_count &&
+        stats->hit_count == cache->hit_count)
+    {
+        return;
+    }
+
+    ecs_singleton_set(world, FlecsShaderCacheStats, {
+        .module_count = cache->module_count,
+        .compile_count = cache->compile_count,
+        .hit_count = cache->hit_count
+    });
+}
+
+static bool flecsEngine_shader_isDefined(
+    const char *defines,
+    const char *name,
+    ecs_size_t name_len)
+{
+    if (!defines) {
+        return false;
+    }
+
+    const char *ptr = defines;
+    while (*ptr) {
+        while (*ptr == ' ' || *ptr == ',') {
+            ptr ++;
+        }
+
+        const char *start = ptr;
+        while (*ptr && *ptr != ' ' && *ptr != ',') {
+            ptr ++;
+        }
+
+        if ((ptr - start) == name_len && !ecs_os_strncmp(start, name, name_len)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Expand #ifdef/#ifndef/#else/#endif lines. WGSL has no use for '#', so any
+ * line that starts with it is treated as a directive. */
+static char* flecsEngine_shader_preprocess(
+    const char *source,
+    const char *defines)
+{
+    bool active[FLECS_ENGINE_SHADER_PP_MAX_DEPTH + 1];
+    bool parent_active[FLECS_ENGINE_SHADER_PP_MAX_DEPTH + 1];
+    int32_t depth = 0;
+    active[0] = true;
+    parent_active[0] = true;
+
+    ecs_strbuf_t buf = ECS_STRBUF_INIT;
+    const char *line = source;
+
+    while (*line) {
+        const char *end = strchr(line, '\n');
+        const char *next = end ? end + 1 : line + ecs_os_strlen(line);
+
+        const char *ptr = line;
+        while (*ptr == ' ' || *ptr == '\t') {
+            ptr ++;
+        }
+
+        if (*ptr != '#') {
+            if (active[depth]) {
+                ecs_strbuf_appendstrn(&buf, line, (int32_t)(next - line));
+            }
+            line = next;
+            continue;
+        }
+
+        ptr ++;
+        const char *directive = ptr;
+        while (*ptr && *ptr != ' ' && *ptr != '\t' && *ptr != '\n') {
+            ptr ++;
+        }
+        ecs_size_t directive_len = (ecs_size_t)(ptr - directive);
+
+        while (*ptr == ' ' || *ptr == '\t') {
+            ptr ++;
+        }
+        const char *arg = ptr;
+        while (*ptr && *ptr != ' ' && *ptr != '\t' &&
+            *ptr != '\r' && *ptr != '\n')
+        {
+            ptr ++;
+        }
+        ecs_size_t arg_len = (ecs_size_t)(ptr - arg);
+
+        if ((directive_len == 5 && !ecs_os_strncmp(directive, "ifdef", 5)) ||
+            (directive_len == 6 && !ecs_os_strncmp(directive, "ifndef", 6)))
+        {
+            if (depth == FLECS_ENGINE_SHADER_PP_MAX_DEPTH) {
+                ecs_err("shader preprocessor: #if nesting too deep");
+                goto error;
+            }
+            if (!arg_len) {
+                ecs_err("shader preprocessor: missing name for #%.*s",
+                    directive_len, directive);
+                goto error;
+            }
+
+            bool cond = flecsEngine_shader_isDefined(defines, arg, arg_len);
+            if (directive_len == 6) {
+                cond = !cond;
+            }
+
+            depth ++;
+            parent_active[depth] = active[depth - 1];
+            active[depth] = parent_active[depth] && cond;
+        } else if (directive_len == 4 && !ecs_os_strncmp(directive, "else", 4)) {
+            if (!depth) {
+                ecs_err("shader preprocessor: #else without #ifdef");
+                goto error;
+            }
+            active[depth] = parent_active[depth] && !active[depth];
+        } else if (directive_len == 5 && !ecs_os_strncmp(directive, "endif", 5)) {
+            if (!depth) {
+                ecs_err("shader preprocessor: #endif without #ifdef");
+                goto error;
+            }
+            depth --;
+        } else {
+            ecs_err("shader preprocessor: unknown directive '#%.*s'",
+                directive_len, directive);
+            goto error;
+        }
+
+        line = next;
+    }
+
+    if (depth) {
+        ecs_err("shader preprocessor: missing #endif");
+        goto error;
+    }
+
+    return ecs_strbuf_get(&buf);
+error:
+    ecs_strbuf_reset(&buf);
+    return NULL;
+}
+
+static void flecsShaderFree(
+    FlecsShader *ptr)
+{
+    ecs_os_free((char*)ptr->source);
+    ecs_os_free((char*)ptr->vertex_entry);
+    ecs_os_free((char*)ptr->fragment_entry);
+    ecs_os_free((char*)ptr->defines);
+    *ptr = (FlecsShader){0};
+}
+
+/* Shaders own their strings, so that variants can store generated defines
+ * and callers don't have to keep strings alive for the lifetime of the
+ * component. */
+ECS_COPY(FlecsShader, dst, src, {
+    flecsShaderFree(dst);
+    dst->source = src->source ? ecs_os_strdup(src->source) : NULL;
+    dst->vertex_entry =
+        src->vertex_entry ? ecs_os_strdup(src->vertex_entry) : NULL;
+    dst->fragment_entry =
+        src->fragment_entry ? ecs_os_strdup(src->fragment_entry) : NULL;
+    dst->defines = src->defines ? ecs_os_strdup(src->defines) : NULL;
+})
+
+ECS_MOVE(FlecsShader, dst, src, {
+    flecsShaderFree(dst);
+    *dst = *src;
+    *src = (FlecsShader){0};
+})
+
+ECS_DTOR(FlecsShader, ptr, {
+    flecsShaderFree(ptr);
+})
+
 static void flecsShaderImplRelease(
     FlecsShaderImpl *ptr)
 {
-    if (ptr->shader_module) {
-        wgpuShaderModuleRelease(ptr->shader_module);
-        ptr->shader_module = NULL;
-    }
+    /* Modules are owned by the engine shader cache */
+    ptr->shader_module = NULL;
 }
 
 FLECS_ENGINE_IMPL_HOOKS(FlecsShaderImpl, flecsShaderImplRelease)
@@ -38,8 +317,8 @@ static bool flecsEngine_shader_compile(
     const FlecsShader *shader,
     FlecsShaderImpl *shader_impl)
 {
-    const FlecsEngineImpl *engine = ecs_singleton_get(world, FlecsEngineImpl);
-    if (!engine) {
+    FlecsEngineImpl *engine = ecs_singleton_get_mut(world, FlecsEngineImpl);
+    if (!engine || !engine->device) {
         char *name = ecs_get_path(world, shader_entity);
         ecs_err("cannot compile shader '%s': engine is not initialized", name);
         ecs_os_free(name);
@@ -56,21 +335,35 @@ static bool flecsEngine_shader_compile(
 
     flecsShaderImplRelease(shader_impl);
 
-    shader_impl->shader_module = flecsEngine_createShaderModule(
-        engine->device, shader->source);
+    char *source = flecsEngine_shader_preprocess(
+        shader->source, shader->defines);
+    if (!source) {
+        char *name = ecs_get_path(world, shader_entity);
+        ecs_err("failed to preprocess shader asset '%s'", name);
+        ecs_os_free(name);
+        return false;
+    }
+
+    shader_impl->shader_module = flecsEngine_shaderCache_get(engine, source);
 
     if (!shader_impl->shader_module) {
         char *name = ecs_get_path(world, shader_entity);
         ecs_err("failed to compile shader asset '%s'", name);
         ecs_os_free(name);
+        ecs_os_free(source);
         return false;
     }
 
-    /* Detect shader features from source once at compile time */
-    shader_impl->uses_ibl = flecsEngine_shader_usesIbl(shader);
-    shader_impl->uses_shadow = flecsEngine_shader_usesShadow(shader);
-    shader_impl->uses_cluster = flecsEngine_shader_usesCluster(shader);
-    shader_impl->uses_textures = flecsEngine_shader_usesTextures(shader);
+    /* Detect shader features from the expanded source once at compile time,
+     * so that variants which compile out a feature also drop its bindings. */
+    FlecsShader expanded = *shader;
+    expanded.source = source;
+    shader_impl->uses_ibl = flecsEngine_shader_usesIbl(&expanded);
+    shader_impl->uses_shadow = flecsEngine_shader_usesShadow(&expanded);
+    shader_impl->uses_cluster = flecsEngine_shader_usesCluster(&expanded);
+    shader_impl->uses_textures = flecsEngine_shader_usesTextures(&expanded);
+
+    ecs_os_free(source);
 
     return true;
 }
@@ -112,7 +405,8 @@ ecs_entity_t flecsEngine_shader_ensure(
     if (!existing ||
         ecs_os_strcmp(existing->source, shader->source) ||
         ecs_os_strcmp(existing->vertex_entry, shader->vertex_entry) ||
-        ecs_os_strcmp(existing->fragment_entry, shader->fragment_entry))
+        ecs_os_strcmp(existing->fragment_entry, shader->fragment_entry) ||
+        ecs_os_strcmp(existing->defines, shader->defines))
     {
         ecs_set_ptr(world, shader_entity, FlecsShader, shader);
     }
@@ -120,16 +414,75 @@ ecs_entity_t flecsEngine_shader_ensure(
     return shader_entity;
 }
 
+ecs_entity_t flecsEngine_shader_ensureVariant(
+    ecs_world_t *world,
+    ecs_entity_t shader_entity,
+    const char *defines)
+{
+    const FlecsShader *base = ecs_get(world, shader_entity, FlecsShader);
+    if (!base) {
+        char *name = ecs_get_path(world, shader_entity);
+        ecs_err("entity '%s' does not have FlecsShader", name);
+        ecs_os_free(name);
+        return 0;
+    }
+
+    if (!defines || !defines[0]) {
+        return shader_entity;
+    }
+
+    ecs_strbuf_t buf = ECS_STRBUF_INIT;
+    if (base->defines && base->defines[0]) {
+        ecs_strbuf_append(&buf, "%s ", base->defines);
+    }
+    ecs_strbuf_appendstr(&buf, defines);
+    char *all_defines = ecs_strbuf_get(&buf);
+
+    char variant_name[32];
+    snprintf(variant_name, sizeof(variant_name), "variant_%016llx",
+        (unsigned long long)flecsEngine_shader_hash(all_defines));
+
+    ecs_entity_t variant = ecs_entity_init(world, &(ecs_entity_desc_t){
+        .name = variant_name,
+        .parent = shader_entity
+    });
+
+    /* Creating the child can move the base shader */
+    base = ecs_get(world, shader_entity, FlecsShader);
+
+    const FlecsShader *existing = ecs_get(world, variant, FlecsShader);
+    if (!existing ||
+        ecs_os_strcmp(existing->source, base->source) ||
+        ecs_os_strcmp(existing->vertex_entry, base->vertex_entry) ||
+        ecs_os_strcmp(existing->fragment_entry, base->fragment_entry) ||
+        ecs_os_strcmp(existing->defines, all_defines))
+    {
+        /* The copy hook duplicates the strings, so all_defines can be freed */
+        ecs_set(world, variant, FlecsShader, {
+            .source = base->source,
+            .vertex_entry = base->vertex_entry,
+            .fragment_entry = base->fragment_entry,
+            .defines = all_defines
+        });
+    }
+
+    ecs_os_free(all_defines);
+
+    return variant;
+}
+
 static void FlecsShader_on_set(
     ecs_iter_t *it)
 {
     ecs_world_t *world = it->world;
-    FlecsShader *shaders = ecs_field(it, FlecsShader, 0);
 
     for (int32_t i = 0; i < it->count; i ++) {
         ecs_entity_t shader_entity = it->entities[i];
         FlecsShaderImpl *shader_impl = ecs_ensure(world, shader_entity, FlecsShaderImpl);
-        if (!flecsEngine_shader_compile(world, shader_entity, &shaders[i], shader_impl)) {
+
+        /* Adding the impl can move the entity, get the shader afterwards */
+        const FlecsShader *shader = ecs_get(world, shader_entity, FlecsShader);
+        if (!flecsEngine_shader_compile(world, shader_entity, shader, shader_impl)) {
             continue;
         }
     }
@@ -140,9 +493,24 @@ void flecsEngine_shader_register(
 {
     ECS_COMPONENT_DEFINE(world, FlecsShader);
     ECS_COMPONENT_DEFINE(world, FlecsShaderImpl);
+    ECS_COMPONENT_DEFINE(world, FlecsShaderCacheStats);
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsShaderCacheStats),
+        .members = {
+            { .name = "module_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "compile_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "hit_count", .type = ecs_id(ecs_i32_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(FlecsShaderCacheStats), EcsSingleton);
 
     ecs_set_hooks(world, FlecsShader, {
         .ctor = flecs_default_ctor,
+        .copy = ecs_copy(FlecsShader),
+        .move = ecs_move(FlecsShader),
+        .dtor = ecs_dtor(FlecsShader),
         .on_set = FlecsShader_on_set
     });
 
@@ -19,16 +19,22 @@
     "  _pad1 : u32\n" \
     "};\n"
 
-/* Cluster bind group bindings at group 1 (shared with IBL + shadow). */
+/* Cluster bind group bindings at group 1 (shared with IBL + shadow). Define
+ * FLECS_ENGINE_NO_CLUSTER_LIGHTS to compile a variant without them. */
 #define FLECS_ENGINE_SHADER_COMMON_CLUSTER_BINDINGS_WGSL \
+    "#ifndef FLECS_ENGINE_NO_CLUSTER_LIGHTS\n" \
     "@group(1) @binding(5) var<uniform> cluster_info : ClusterInfo;\n" \
     "@group(1) @binding(6) var<storage, read> cluster_grid : array<ClusterEntry>;\n" \
     "@group(1) @binding(7) var<storage, read> light_indices : array<u32>;\n" \
-    "@group(1) @binding(8) var<storage, read> lights : array<Light>;\n"
+    "@group(1) @binding(8) var<storage, read> lights : array<Light>;\n" \
+    "#endif\n"
 
 /* Cluster index lookup function */
 #define FLECS_ENGINE_SHADER_COMMON_CLUSTER_FUNCTIONS_WGSL \
     "fn getClusterIndex(frag_coord : vec4<f32>) -> u32 {\n" \
+    "#ifdef FLECS_ENGINE_NO_CLUSTER_LIGHTS\n" \
+    "  return 0u;\n" \
+    "#else\n" \
     "  let grid_x = cluster_info.grid_size.x;\n" \
     "  let grid_y = cluster_info.grid_size.y;\n" \
     "  let grid_z = cluster_info.grid_size.z;\n" \
@@ -41,6 +47,7 @@
     "  let depth = 1.0 / frag_coord.w;\n" \
     "  let slice = min(u32(max(log(depth / near) / log_ratio * f32(grid_z), 0.0)), grid_z - 1u);\n" \
     "  return tile_x + tile_y * grid_x + slice * grid_x * grid_y;\n" \
+    "#endif\n" \
     "}\n"
 
 /* Combined macro including types, bindings and functions */
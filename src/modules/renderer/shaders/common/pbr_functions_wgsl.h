@@ -112,6 +112,7 @@
     "  ggx_v : f32,\n" \
     "  cluster_idx : u32) -> vec3<f32> {\n" \
     "  var result = vec3<f32>(0.0);\n" \
+    "#ifndef FLECS_ENGINE_NO_CLUSTER_LIGHTS\n" \
     "  let entry = cluster_grid[cluster_idx];\n" \
     "  for (var j = 0u; j < entry.light_count; j++) {\n" \
     "    let i = light_indices[entry.light_offset + j];\n" \
@@ -148,6 +149,7 @@
     "    let specular = computeSpecular(n, ndotv, ggx_v, l, h, roughness, f);\n" \
     "    result += (diffuse + specular) * light_color * ndotl * attenuation * spot_effect;\n" \
     "  }\n" \
+    "#endif\n" \
     "  return result;\n" \
     "}\n"
 
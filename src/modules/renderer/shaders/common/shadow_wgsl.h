@@ -1,13 +1,23 @@
 #ifndef FLECS_ENGINE_SHADER_COMMON_SHADOW_WGSL_H
 #define FLECS_ENGINE_SHADER_COMMON_SHADOW_WGSL_H
 
+/* Define FLECS_ENGINE_NO_SHADOWS to compile a variant without shadow map
+ * bindings. Such variants do not receive or cast shadows. */
 #define FLECS_ENGINE_SHADER_COMMON_SHADOW_WGSL \
-    "@group(1) @binding(3) var shadow_map : texture_depth_2d_array;\n" \
-    "@group(1) @binding(4) var shadow_sampler : sampler_comparison;\n" \
     "struct ShadowResult {\n" \
     "  shadow : f32,\n" \
     "  debug_color : vec3<f32>\n" \
     "};\n" \
+    "#ifdef FLECS_ENGINE_NO_SHADOWS\n" \
+    "fn computeShadow(world_pos : vec3<f32>) -> ShadowResult {\n" \
+    "  var result : ShadowResult;\n" \
+    "  result.shadow = 1.0;\n" \
+    "  result.debug_color = vec3<f32>(1.0, 1.0, 1.0);\n" \
+    "  return result;\n" \
+    "}\n" \
+    "#else\n" \
+    "@group(1) @binding(3) var shadow_map : texture_depth_2d_array;\n" \
+    "@group(1) @binding(4) var shadow_sampler : sampler_comparison;\n" \
     "fn cascadeDebugColor(cascade : i32) -> vec3<f32> {\n" \
     "  if (cascade == 0) { return vec3<f32>(1.0, 0.2, 0.2); }\n" \
     "  if (cascade == 1) { return vec3<f32>(0.2, 1.0, 0.2); }\n" \
@@ -65,6 +75,7 @@
     "  if (shadow < 0.0) { shadow = 1.0; }\n" \
     "  result.shadow = shadow;\n" \
     "  return result;\n" \
-    "}\n"
+    "}\n" \
+    "#endif\n"
 
 #endif
@@ -47,8 +47,8 @@ int flecsEngine_shadow_init(
 
     /* Compile shadow depth shader directly (bypasses ECS shader system
      * to avoid deferred context issues during batch setup) */
-    impl->shadow.shader_module = flecsEngine_createShaderModule(
-        impl->device, kShadowDepthShaderSource);
+    impl->shadow.shader_module = flecsEngine_shaderCache_get(
+        impl, kShadowDepthShaderSource);
     if (!impl->shadow.shader_module) {
         ecs_err("failed to compile shadow depth shader");
         return -1;
@@ -68,7 +68,9 @@ int flecsEngine_shadow_init(
         .sampleCount = 1
     };
 
-    impl->shadow.texture = wgpuDeviceCreateTexture(impl->device, &tex_desc);
+    impl->shadow.texture = flecsEngine_gpuMemory_createTexture(
+        impl->device, FlecsGpuMemoryShadow, &tex_desc);
+    flecsEngine_renderStats_createTexture(impl);
     if (!impl->shadow.texture) {
         ecs_err("failed to create shadow map texture");
         return -1;
@@ -136,6 +138,7 @@ int flecsEngine_shadow_init(
         .visibility = WGPUShaderStage_Vertex,
         .buffer = (WGPUBufferBindingLayout){
             .type = WGPUBufferBindingType_Uniform,
+            .hasDynamicOffset = true,
             .minBindingSize = sizeof(mat4)
         }
     }};
@@ -152,46 +155,76 @@ int flecsEngine_shadow_init(
         return -1;
     }
 
-    /* Create one VP buffer and bind group per cascade. Each cascade needs its
-     * own buffer because wgpuQueueWriteBuffer calls are all resolved before
-     * the command buffer executes, so a single shared buffer would only
-     * contain the last cascade's VP matrix by the time any render pass runs. */
-    for (int i = 0; i < FLECS_ENGINE_SHADOW_CASCADE_COUNT; i++) {
-        WGPUBufferDescriptor buf_desc = {
-            .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
-            .size = sizeof(mat4)
-        };
+    if (flecsEngine_shadow_ensureViewCapacity(
+        impl, impl->view_uniforms.capacity))
+    {
+        return -1;
+    }
 
-        impl->shadow.vp_buffers[i] = wgpuDeviceCreateBuffer(
-            impl->device, &buf_desc);
-        if (!impl->shadow.vp_buffers[i]) {
-            ecs_err("failed to create shadow VP buffer %d", i);
-            return -1;
-        }
+    /* Bump shadow version so that combined IBL+shadow bind groups are
+     * recreated with the new shadow resources. */
+    impl->scene_bind_version++;
 
-        WGPUBindGroupEntry pass_entries[1] = {{
-            .binding = 0,
-            .buffer = impl->shadow.vp_buffers[i],
-            .size = sizeof(mat4)
-        }};
+    return 0;
+}
 
-        WGPUBindGroupDescriptor pass_group_desc = {
-            .layout = impl->shadow.pass_bind_layout,
-            .entryCount = 1,
-            .entries = pass_entries
-        };
+/* Recreate the light VP buffer with one block per cascade for each view slot.
+ * All cascades of all views share a single bind group, and the shadow pass
+ * selects a block with a dynamic offset. Each block needs its own slot because
+ * wgpuQueueWriteBuffer calls are all resolved before the command buffer
+ * executes, so a shared block would only contain the last written matrix. */
+int flecsEngine_shadow_ensureViewCapacity(
+    FlecsEngineImpl *impl,
+    int32_t view_count)
+{
+    if (impl->shadow.pass_bind_group) {
+        wgpuBindGroupRelease(impl->shadow.pass_bind_group);
+        impl->shadow.pass_bind_group = NULL;
+    }
+    if (impl->shadow.vp_buffer) {
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryShadow, impl->shadow.vp_buffer);
+        impl->shadow.vp_buffer = NULL;
+    }
 
-        impl->shadow.pass_bind_groups[i] = wgpuDeviceCreateBindGroup(
-            impl->device, &pass_group_desc);
-        if (!impl->shadow.pass_bind_groups[i]) {
-            ecs_err("failed to create shadow pass bind group %d", i);
-            return -1;
-        }
+    if (view_count < 1) {
+        view_count = 1;
     }
 
-    /* Bump shadow version so that combined IBL+shadow bind groups are
-     * recreated with the new shadow resources. */
-    impl->scene_bind_version++;
+    impl->shadow.vp_stride = flecsEngine_uniformStride(sizeof(mat4));
+
+    WGPUBufferDescriptor buf_desc = {
+        .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+        .size = (uint64_t)impl->shadow.vp_stride * (uint64_t)view_count *
+            FLECS_ENGINE_SHADOW_CASCADE_COUNT
+    };
+
+    impl->shadow.vp_buffer = flecsEngine_gpuMemory_createBuffer(
+        impl->device, FlecsGpuMemoryShadow, &buf_desc);
+    flecsEngine_renderStats_createBuffer(impl);
+    if (!impl->shadow.vp_buffer) {
+        ecs_err("failed to create shadow VP buffer");
+        return -1;
+    }
+
+    WGPUBindGroupEntry pass_entries[1] = {{
+        .binding = 0,
+        .buffer = impl->shadow.vp_buffer,
+        .size = sizeof(mat4)
+    }};
+
+    WGPUBindGroupDescriptor pass_group_desc = {
+        .layout = impl->shadow.pass_bind_layout,
+        .entryCount = 1,
+        .entries = pass_entries
+    };
+
+    impl->shadow.pass_bind_group = flecsEngine_createBindGroup(
+        impl, &pass_group_desc);
+    if (!impl->shadow.pass_bind_group) {
+        ecs_err("failed to create shadow pass bind group");
+        return -1;
+    }
 
     return 0;
 }
@@ -199,15 +232,14 @@ int flecsEngine_shadow_init(
 void flecsEngine_shadow_cleanup(
     FlecsEngineImpl *impl)
 {
-    for (int i = 0; i < FLECS_ENGINE_SHADOW_CASCADE_COUNT; i++) {
-        if (impl->shadow.pass_bind_groups[i]) {
-            wgpuBindGroupRelease(impl->shadow.pass_bind_groups[i]);
-            impl->shadow.pass_bind_groups[i] = NULL;
-        }
-        if (impl->shadow.vp_buffers[i]) {
-            wgpuBufferRelease(impl->shadow.vp_buffers[i]);
-            impl->shadow.vp_buffers[i] = NULL;
-        }
+    if (impl->shadow.pass_bind_group) {
+        wgpuBindGroupRelease(impl->shadow.pass_bind_group);
+        impl->shadow.pass_bind_group = NULL;
+    }
+    if (impl->shadow.vp_buffer) {
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryShadow, impl->shadow.vp_buffer);
+        impl->shadow.vp_buffer = NULL;
     }
     if (impl->shadow.pass_bind_layout) {
         wgpuBindGroupLayoutRelease(impl->shadow.pass_bind_layout);
@@ -228,13 +260,13 @@ void flecsEngine_shadow_cleanup(
         impl->shadow.texture_view = NULL;
     }
     if (impl->shadow.texture) {
-        wgpuTextureRelease(impl->shadow.texture);
+        flecsEngine_gpuMemory_releaseTexture(
+            FlecsGpuMemoryShadow, impl->shadow.texture);
         impl->shadow.texture = NULL;
     }
-    if (impl->shadow.shader_module) {
-        wgpuShaderModuleRelease(impl->shadow.shader_module);
-        impl->shadow.shader_module = NULL;
-    }
+    /* Shader module is owned by the shader cache */
+    impl->shadow.shader_module = NULL;
+    ecs_vec_fini_t(NULL, &impl->shadow.casters, flecs_engine_shadow_caster_t);
 }
 
 static void flecsEngine_shadow_computeSingleCascade(
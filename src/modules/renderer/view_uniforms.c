@@ -0,0 +1,158 @@
+#include <string.h>
+
+#include "renderer.h"
+#include "flecs_engine.h"
+
+#define FLECS_ENGINE_VIEW_UNIFORMS_INITIAL_CAPACITY (4)
+
+uint32_t flecsEngine_uniformStride(
+    uint64_t size)
+{
+    uint64_t align = FLECS_ENGINE_UNIFORM_OFFSET_ALIGNMENT;
+    return (uint32_t)((size + align - 1) / align * align);
+}
+
+static int flecsEngine_viewUniforms_createBuffer(
+    FlecsEngineImpl *engine,
+    int32_t capacity)
+{
+    flecs_engine_view_uniforms_t *vu = &engine->view_uniforms;
+
+    if (vu->buffer) {
+        flecsEngine_gpuMemory_releaseBuffer(FlecsGpuMemoryUniform, vu->buffer);
+        vu->buffer = NULL;
+    }
+
+    WGPUBufferDescriptor desc = {
+        .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+        .size = (uint64_t)vu->stride * (uint64_t)capacity
+    };
+
+    vu->buffer = flecsEngine_gpuMemory_createBuffer(
+        engine->device, FlecsGpuMemoryUniform, &desc);
+    if (!vu->buffer) {
+        ecs_err("failed to create view uniform buffer");
+        vu->capacity = 0;
+        return -1;
+    }
+
+    vu->capacity = capacity;
+
+    /* Batch bind groups reference the buffer and must be recreated */
+    vu->version ++;
+
+    return 0;
+}
+
+int flecsEngine_viewUniforms_init(
+    FlecsEngineImpl *engine)
+{
+    engine->view_uniforms.stride = flecsEngine_uniformStride(
+        sizeof(FlecsUniform));
+    return flecsEngine_viewUniforms_createBuffer(
+        engine, FLECS_ENGINE_VIEW_UNIFORMS_INITIAL_CAPACITY);
+}
+
+void flecsEngine_viewUniforms_cleanup(
+    FlecsEngineImpl *engine)
+{
+    if (engine->view_uniforms.buffer) {
+        flecsEngine_gpuMemory_releaseBuffer(
+            FlecsGpuMemoryUniform, engine->view_uniforms.buffer);
+        engine->view_uniforms.buffer = NULL;
+    }
+
+    engine->view_uniforms.capacity = 0;
+}
+
+int flecsEngine_viewUniforms_ensure(
+    FlecsEngineImpl *engine,
+    int32_t view_count)
+{
+    int32_t capacity = engine->view_uniforms.capacity;
+    if (view_count <= capacity) {
+        return 0;
+    }
+
+    if (!capacity) {
+        capacity = FLECS_ENGINE_VIEW_UNIFORMS_INITIAL_CAPACITY;
+    }
+    while (capacity < view_count) {
+        capacity *= 2;
+    }
+
+    if (flecsEngine_viewUniforms_createBuffer(engine, capacity)) {
+        return -1;
+    }
+
+    if (flecsEngine_shadow_ensureViewCapacity(engine, capacity)) {
+        return -1;
+    }
+
+    return flecsEngine_cluster_ensureViewCapacity(engine, capacity);
+}
+
+void flecsEngine_viewUniforms_update(
+    const ecs_world_t *world,
+    FlecsEngineImpl *engine,
+    const FlecsRenderView *view)
+{
+    flecs_engine_view_uniforms_t *vu = &engine->view_uniforms;
+    ecs_assert(vu->slot >= 0 && vu->slot < vu->capacity,
+        ECS_INTERNAL_ERROR, NULL);
+
+    FlecsUniform uniforms = {0};
+    uniforms.camera_pos[3] = 1.0f;
+
+    if (view->camera) {
+        flecsEngine_renderBatch_setupCamera(world, &uniforms, view->camera);
+    }
+
+    if (view->light) {
+        flecsEngine_renderBatch_setupLight(world, &uniforms, view->light);
+    }
+
+    for (int i = 0; i < FLECS_ENGINE_SHADOW_CASCADE_COUNT; i++) {
+        glm_mat4_copy((vec4*)engine->shadow.current_light_vp[i], uniforms.light_vp[i]);
+    }
+
+    memcpy(uniforms.cascade_splits, engine->shadow.cascade_splits,
+        sizeof(float) * FLECS_ENGINE_SHADOW_CASCADE_COUNT);
+
+    float bias = view->shadow.bias;
+    if (bias <= 0) { bias = 0.0005f; }
+    uniforms.shadow_info[1] = bias;
+
+    /* Per-cascade scale factors: the fraction of the texture each cascade
+     * actually uses. Distant cascades render at reduced resolution. */
+    for (int i = 0; i < FLECS_ENGINE_SHADOW_CASCADE_COUNT; i++) {
+        uniforms.shadow_cascade_scales[i] = engine->shadow.map_size > 0
+            ? (float)engine->shadow.cascade_sizes[i] /
+              (float)engine->shadow.map_size
+            : 1.0f;
+    }
+
+    uniforms.ambient_light[0] = flecsEngine_colorChannelToFloat(view->ambient_light.r);
+    uniforms.ambient_light[1] = flecsEngine_colorChannelToFloat(view->ambient_light.g);
+    uniforms.ambient_light[2] = flecsEngine_colorChannelToFloat(view->ambient_light.b);
+    uniforms.ambient_light[3] = view->background.ambient_intensity;
+
+    uniforms.sky_color[0] = flecsEngine_colorChannelToFloat(view->background.sky_color.r);
+    uniforms.sky_color[1] = flecsEngine_colorChannelToFloat(view->background.sky_color.g);
+    uniforms.sky_color[2] = flecsEngine_colorChannelToFloat(view->background.sky_color.b);
+    uniforms.sky_color[3] = flecsEngine_colorChannelToFloat(view->background.sky_color.a);
+
+    engine->camera_pos[0] = uniforms.camera_pos[0];
+    engine->camera_pos[1] = uniforms.camera_pos[1];
+    engine->camera_pos[2] = uniforms.camera_pos[2];
+
+    vu->offset = (uint32_t)vu->slot * vu->stride;
+
+    flecsEngine_queueWriteBuffer(
+        engine,
+        vu->buffer,
+        vu->offset,
+        &uniforms,
+        sizeof(FlecsUniform));
+    vu->write_count ++;
+}
@@ -0,0 +1,332 @@
+#include <math.h>
+
+#define FLECS_ENGINE_STRESS_IMPL
+#include "stress.h"
+
+/* Meshes cycle through these shapes, with a tessellation and size that
+ * differs per cycle so that each mesh is a separate geometry asset. */
+#define FLECS_ENGINE_STRESS_SHAPE_COUNT (3)
+
+static uint32_t flecsEngine_stress_random(
+    uint32_t *state)
+{
+    /* xorshift32 */
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static float flecsEngine_stress_randomFloat(
+    uint32_t *state,
+    float min,
+    float max)
+{
+    float t = (float)(flecsEngine_stress_random(state) >> 8) /
+        (float)(1 << 24);
+    return min + (max - min) * t;
+}
+
+/* The order in which values are drawn must not depend on the compiler.
+ * Initializer lists and function arguments don't have a defined evaluation
+ * order, so values are always drawn in separate statements. */
+static flecs_vec3_t flecsEngine_stress_randomVec3(
+    uint32_t *state,
+    flecs_vec3_t min,
+    flecs_vec3_t max)
+{
+    flecs_vec3_t result;
+    result.x = flecsEngine_stress_randomFloat(state, min.x, max.x);
+    result.y = flecsEngine_stress_randomFloat(state, min.y, max.y);
+    result.z = flecsEngine_stress_randomFloat(state, min.z, max.z);
+    return result;
+}
+
+static int32_t flecsEngine_stress_randomIndex(
+    uint32_t *state,
+    int32_t count)
+{
+    return (int32_t)(flecsEngine_stress_random(state) % (uint32_t)count);
+}
+
+static flecs_rgba_t flecsEngine_stress_randomColor(
+    uint32_t *state,
+    uint8_t alpha)
+{
+    flecs_rgba_t result;
+    result.r = (uint8_t)(64 + flecsEngine_stress_randomIndex(state, 192));
+    result.g = (uint8_t)(64 + flecsEngine_stress_randomIndex(state, 192));
+    result.b = (uint8_t)(64 + flecsEngine_stress_randomIndex(state, 192));
+    result.a = alpha;
+    return result;
+}
+
+static void flecsEngine_stress_setMesh(
+    ecs_world_t *world,
+    ecs_entity_t e,
+    int32_t mesh)
+{
+    int32_t cycle = mesh / FLECS_ENGINE_STRESS_SHAPE_COUNT;
+    int32_t segments = 8 + (cycle % 8) * 4;
+    float size = 0.5f + (float)(cycle / 8) * 0.05f;
+
+    switch (mesh % FLECS_ENGINE_STRESS_SHAPE_COUNT) {
+    case 0:
+        ecs_set(world, e, FlecsSphere, {
+            .segments = segments, .smooth = true, .radius = size });
+        break;
+    case 1:
+        ecs_set(world, e, FlecsCylinder, {
+            .segments = segments, .smooth = true, .length = size * 2.0f });
+        break;
+    default:
+        ecs_set(world, e, FlecsCone, {
+            .segments = segments, .smooth = true, .length = size * 2.0f });
+        break;
+    }
+}
+
+static ecs_entity_t flecsEngine_stress_createMaterial(
+    ecs_world_t *world,
+    ecs_entity_t parent,
+    uint32_t *rng,
+    bool transparent)
+{
+    ecs_entity_t e = ecs_entity(world, { .parent = parent });
+    ecs_add_id(world, e, EcsPrefab);
+
+    flecs_rgba_t color = flecsEngine_stress_randomColor(
+        rng, transparent ? 96 : 255);
+    ecs_set_ptr(world, e, FlecsRgba, &color);
+
+    FlecsPbrMaterial material = {0};
+    material.metallic =
+        flecsEngine_stress_randomFloat(rng, 0.0f, 1.0f) < 0.2f ? 1.0f : 0.0f;
+    material.roughness = flecsEngine_stress_randomFloat(rng, 0.1f, 1.0f);
+    ecs_set_ptr(world, e, FlecsPbrMaterial, &material);
+
+    if (transparent) {
+        ecs_add(world, e, FlecsAlphaBlend);
+    }
+
+    return e;
+}
+
+static void flecsEngine_stress_createInstances(
+    ecs_world_t *world,
+    ecs_entity_t parent,
+    const FlecsStressScene *params,
+    float extent,
+    uint32_t *rng)
+{
+    int32_t mesh_count = params->mesh_count > 0 ? params->mesh_count : 1;
+    int32_t material_count = params->material_count > 0 ?
+        params->material_count : 0;
+    int32_t chain_length = params->hierarchy_depth > 0 ?
+        params->hierarchy_depth + 1 : 1;
+
+    /* Transparent materials are variants of the opaque ones. Per-instance
+     * colors can't be alpha blended, so there is at least one. */
+    int32_t transparent_count = 0;
+    if (params->transparent_fraction > 0) {
+        transparent_count = material_count ? material_count : 1;
+    }
+
+    ecs_entity_t *materials = NULL;
+    if (material_count + transparent_count) {
+        materials = ecs_os_malloc_n(
+            ecs_entity_t, material_count + transparent_count);
+    }
+
+    for (int32_t i = 0; i < material_count; i ++) {
+        materials[i] = flecsEngine_stress_createMaterial(
+            world, parent, rng, false);
+    }
+
+    for (int32_t i = 0; i < transparent_count; i ++) {
+        materials[material_count + i] = flecsEngine_stress_createMaterial(
+            world, parent, rng, true);
+    }
+
+    ecs_entity_t prev = 0;
+    for (int32_t i = 0; i < params->instance_count; i ++) {
+        ecs_entity_t e;
+        FlecsPosition3 position;
+        if (!(i % chain_length)) {
+            e = ecs_new_w_parent(world, parent, NULL);
+            position = flecsEngine_stress_randomVec3(rng,
+                (flecs_vec3_t){ -extent, 0.5f, -extent },
+                (flecs_vec3_t){ extent, 2.0f, extent });
+        } else {
+            /* Child of the previous instance in the chain */
+            e = ecs_new_w_parent(world, prev, NULL);
+            position = flecsEngine_stress_randomVec3(rng,
+                (flecs_vec3_t){ -1.0f, 1.5f, -1.0f },
+                (flecs_vec3_t){ 1.0f, 1.5f, 1.0f });
+        }
+
+        ecs_set_ptr(world, e, FlecsPosition3, &position);
+        prev = e;
+
+        flecsEngine_stress_setMesh(
+            world, e, flecsEngine_stress_randomIndex(rng, mesh_count));
+
+        float scale = flecsEngine_stress_randomFloat(rng, 0.5f, 1.5f);
+        ecs_set(world, e, FlecsScale3, {scale, scale, scale});
+
+        float yaw = flecsEngine_stress_randomFloat(rng, 0, 2 * GLM_PIf);
+        ecs_set(world, e, FlecsRotation3, {0, yaw, 0});
+
+        if (flecsEngine_stress_randomFloat(rng, 0, 1) <
+            params->moving_fraction)
+        {
+            FlecsAngularVelocity3 velocity = flecsEngine_stress_randomVec3(rng,
+                (flecs_vec3_t){ -0.5f, -2.0f, -0.5f },
+                (flecs_vec3_t){ 0.5f, 2.0f, 0.5f });
+            ecs_set_ptr(world, e, FlecsAngularVelocity3, &velocity);
+        }
+
+        if (flecsEngine_stress_randomFloat(rng, 0, 1) <
+            params->transparent_fraction)
+        {
+            ecs_add_pair(world, e, EcsIsA, materials[material_count +
+                flecsEngine_stress_randomIndex(rng, transparent_count)]);
+        } else if (material_count) {
+            ecs_add_pair(world, e, EcsIsA,
+                materials[flecsEngine_stress_randomIndex(rng, material_count)]);
+        } else {
+            flecs_rgba_t color = flecsEngine_stress_randomColor(rng, 255);
+            float roughness = flecsEngine_stress_randomFloat(rng, 0.1f, 1.0f);
+            ecs_set_ptr(world, e, FlecsRgba, &color);
+            ecs_set(world, e, FlecsPbrMaterial, {
+                .metallic = 0.0f,
+                .roughness = roughness
+            });
+        }
+    }
+
+    ecs_os_free(materials);
+}
+
+static void flecsEngine_stress_createLights(
+    ecs_world_t *world,
+    ecs_entity_t parent,
+    const FlecsStressScene *params,
+    float extent,
+    uint32_t *rng)
+{
+    for (int32_t i = 0; i < params->point_light_count; i ++) {
+        ecs_entity_t e = ecs_new_w_parent(world, parent, NULL);
+        FlecsPosition3 position = flecsEngine_stress_randomVec3(rng,
+            (flecs_vec3_t){ -extent, 1.0f, -extent },
+            (flecs_vec3_t){ extent, 6.0f, extent });
+        ecs_set_ptr(world, e, FlecsPosition3, &position);
+
+        FlecsPointLight light = {0};
+        light.intensity = flecsEngine_stress_randomFloat(rng, 1.0f, 5.0f);
+        light.range = flecsEngine_stress_randomFloat(rng, 3.0f, 12.0f);
+        ecs_set_ptr(world, e, FlecsPointLight, &light);
+
+        flecs_rgba_t color = flecsEngine_stress_randomColor(rng, 255);
+        ecs_set_ptr(world, e, FlecsRgba, &color);
+    }
+
+    for (int32_t i = 0; i < params->spot_light_count; i ++) {
+        ecs_entity_t e = ecs_new_w_parent(world, parent, NULL);
+        FlecsPosition3 position = flecsEngine_stress_randomVec3(rng,
+            (flecs_vec3_t){ -extent, 4.0f, -extent },
+            (flecs_vec3_t){ extent, 10.0f, extent });
+        ecs_set_ptr(world, e, FlecsPosition3, &position);
+
+        /* Point down, tilted by up to ~25 degrees */
+        FlecsRotation3 rotation = flecsEngine_stress_randomVec3(rng,
+            (flecs_vec3_t){ -GLM_PI_2f - 0.45f, 0, 0 },
+            (flecs_vec3_t){ -GLM_PI_2f + 0.45f, 2 * GLM_PIf, 0 });
+        ecs_set_ptr(world, e, FlecsRotation3, &rotation);
+
+        FlecsSpotLight light = { .inner_angle = 15.0f, .outer_angle = 30.0f };
+        light.intensity = flecsEngine_stress_randomFloat(rng, 2.0f, 8.0f);
+        light.range = flecsEngine_stress_randomFloat(rng, 8.0f, 20.0f);
+        ecs_set_ptr(world, e, FlecsSpotLight, &light);
+
+        flecs_rgba_t color = flecsEngine_stress_randomColor(rng, 255);
+        ecs_set_ptr(world, e, FlecsRgba, &color);
+    }
+}
+
+static void flecsEngine_stress_generate(
+    ecs_world_t *world,
+    ecs_entity_t root,
+    const FlecsStressScene *params)
+{
+    /* Replace entities of an earlier generation. The name is set after the
+     * delete, so that a deferred delete can't remove the new entities. */
+    ecs_entity_t scene = ecs_lookup_child(world, root, "generated");
+    if (scene) {
+        ecs_delete(world, scene);
+    }
+
+    scene = ecs_new_w_parent(world, root, NULL);
+    ecs_set_name(world, scene, "generated");
+
+    /* Gives instances a parent transform, so that computing their transform
+     * doesn't need to search up the hierarchy */
+    ecs_set(world, scene, FlecsPosition3, {0, 0, 0});
+
+    /* Scramble the seed, so that nearby seeds don't produce similar scenes
+     * and a seed of 0 (which xorshift can't use) is valid */
+    uint32_t rng = (params->seed + 1u) * 2654435761u;
+    if (!rng) {
+        rng = 1;
+    }
+
+    float extent = params->extent;
+    if (extent <= 0) {
+        extent = fmaxf(10.0f, sqrtf((float)params->instance_count) * 1.5f);
+    }
+
+    /* Add the components of each entity in one table move */
+    ecs_defer_begin(world);
+    flecsEngine_stress_createInstances(world, scene, params, extent, &rng);
+    flecsEngine_stress_createLights(world, scene, params, extent, &rng);
+
+    if (params->camera) {
+        ecs_set(world, params->camera, FlecsPosition3, {
+            0, extent * 0.4f + 5.0f, -extent * 1.1f - 5.0f });
+        ecs_set(world, params->camera, FlecsLookAt, {0, 0, 0});
+    }
+    ecs_defer_end(world);
+
+    ecs_dbg("generated stress scene: %d instances, %d point lights, "
+        "%d spot lights", params->instance_count, params->point_light_count,
+        params->spot_light_count);
+}
+
+static void FlecsStressScene_on_set(
+    ecs_iter_t *it)
+{
+    ecs_world_t *world = it->world;
+    const FlecsStressScene *params = ecs_field(it, FlecsStressScene, 0);
+
+    for (int32_t i = 0; i < it->count; i ++) {
+        uint64_t trace_start = flecsEngine_trace_begin();
+        flecsEngine_stress_generate(world, it->entities[i], &params[i]);
+        flecsEngine_trace_end(trace_start, "asset", "stress_scene", NULL);
+    }
+}
+
+void FlecsEngineStressImport(
+    ecs_world_t *world)
+{
+    ECS_MODULE(world, FlecsEngineStress);
+
+    ecs_set_name_prefix(world, "Flecs");
+
+    ECS_META_COMPONENT(world, FlecsStressScene);
+
+    ecs_set_hooks(world, FlecsStressScene, {
+        .ctor = flecs_default_ctor,
+        .on_set = FlecsStressScene_on_set
+    });
+}
@@ -0,0 +1,9 @@
+#include "../../private.h"
+
+#ifndef FLECS_ENGINE_STRESS_IMPL
+#define FLECS_ENGINE_STRESS_IMPL
+
+void FlecsEngineStressImport(
+    ecs_world_t *world);
+
+#endif
@@ -0,0 +1,1371 @@
+#include <string.h>
+
+#include "private.h"
+#include "modules/renderer/renderer.h"
+
+#ifndef __EMSCRIPTEN__
+
+/* Null WebGPU backend. Objects are reference counted CPU allocations. Buffers
+ * own their contents, so that writes, copies and readbacks behave like they
+ * do on a GPU. Textures allocate storage on their first write, as render
+ * targets are never written from the CPU. Encoders record commands which are
+ * counted on submit; only copies are executed, draws and dispatches are not.
+ * Callbacks fire the next time events are processed. */
+
+typedef enum {
+    FlecsNullGpuInstance,
+    FlecsNullGpuAdapter,
+    FlecsNullGpuDevice,
+    FlecsNullGpuQueue,
+    FlecsNullGpuBuffer,
+    FlecsNullGpuTexture,
+    FlecsNullGpuTextureView,
+    FlecsNullGpuCommandEncoder,
+    FlecsNullGpuCommandBuffer,
+    FlecsNullGpuPassEncoder,
+    FlecsNullGpuOther /* Pipelines, layouts, bind groups, samplers, ... */
+} flecs_engine_null_gpu_kind_t;
+
+typedef struct {
+    int32_t refcount;
+    flecs_engine_null_gpu_kind_t kind;
+} flecs_engine_null_gpu_object_t;
+
+typedef enum {
+    FlecsNullGpuPendingAdapter,
+    FlecsNullGpuPendingDevice,
+    FlecsNullGpuPendingMap,
+    FlecsNullGpuPendingWorkDone
+} flecs_engine_null_gpu_pending_kind_t;
+
+typedef struct {
+    flecs_engine_null_gpu_pending_kind_t kind;
+    void *object; /* Adapter, device or buffer passed to the callback */
+    union {
+        WGPURequestAdapterCallbackInfo adapter;
+        WGPURequestDeviceCallbackInfo device;
+        WGPUBufferMapCallbackInfo map;
+        WGPUQueueWorkDoneCallbackInfo work_done;
+    } info;
+} flecs_engine_null_gpu_pending_t;
+
+typedef struct {
+    flecs_engine_null_gpu_object_t hdr;
+    ecs_os_mutex_t lock;
+    ecs_vec_t pending; /* vec<flecs_engine_null_gpu_pending_t> */
+    uint64_t next_future;
+    flecs_engine_gpu_command_counters_t counters;
+} flecs_engine_null_gpu_instance_t;
+
+/* Objects don't keep their instance alive, the engine releases the instance
+ * after everything else. */
+typedef struct {
+    flecs_engine_null_gpu_object_t hdr;
+    flecs_engine_null_gpu_instance_t *instance;
+} flecs_engine_null_gpu_child_t;
+
+typedef struct {
+    flecs_engine_null_gpu_object_t hdr;
+    flecs_engine_null_gpu_instance_t *instance;
+    uint8_t *data;
+    uint64_t size;
+    bool mapped;
+} flecs_engine_null_gpu_buffer_t;
+
+typedef struct {
+    flecs_engine_null_gpu_object_t hdr;
+    WGPUTextureFormat format;
+    WGPUTextureDimension dimension;
+    WGPUExtent3D size;
+    uint32_t mip_level_count;
+    uint32_t sample_count;
+    uint8_t *data; /* Allocated on the first write */
+} flecs_engine_null_gpu_texture_t;
+
+typedef struct {
+    flecs_engine_null_gpu_object_t hdr;
+    flecs_engine_null_gpu_texture_t *texture;
+} flecs_engine_null_gpu_texture_view_t;
+
+typedef enum {
+    FlecsNullGpuCmdBeginRenderPass,
+    FlecsNullGpuCmdBeginComputePass,
+    FlecsNullGpuCmdEndPass,
+    FlecsNullGpuCmdSetPipeline,
+    FlecsNullGpuCmdSetBindGroup,
+    FlecsNullGpuCmdSetVertexBuffer,
+    FlecsNullGpuCmdSetIndexBuffer,
+    FlecsNullGpuCmdSetViewport,
+    FlecsNullGpuCmdSetBlendConstant,
+    FlecsNullGpuCmdDraw,
+    FlecsNullGpuCmdDrawIndexed,
+    FlecsNullGpuCmdDispatch,
+    FlecsNullGpuCmdCopyBufferToBuffer,
+    FlecsNullGpuCmdCopyTextureToBuffer,
+    FlecsNullGpuCmdResolveQuerySet
+} flecs_engine_null_gpu_command_kind_t;
+
+typedef struct {
+    flecs_engine_null_gpu_command_kind_t kind;
+    uint32_t count;          /* Vertices, indices or workgroups */
+    uint32_t instance_count;
+    /* Copies keep a reference to their source and destination */
+    flecs_engine_null_gpu_buffer_t *src_buffer;
+    flecs_engine_null_gpu_texture_t *src_texture;
+    flecs_engine_null_gpu_buffer_t *dst_buffer;
+    uint64_t src_offset;
+    uint64_t dst_offset;
+    uint64_t size;
+    uint32_t mip_level;
+    WGPUOrigin3D origin;
+    WGPUTexelCopyBufferLayout layout;
+    WGPUExtent3D extent;
+} flecs_engine_null_gpu_command_t;
+
+typedef struct {
+    flecs_engine_null_gpu_object_t hdr;
+    ecs_vec_t commands; /* vec<flecs_engine_null_gpu_command_t> */
+} flecs_engine_null_gpu_commands_t;
+
+typedef struct {
+    flecs_engine_null_gpu_object_t hdr;
+    flecs_engine_null_gpu_commands_t *encoder;
+} flecs_engine_null_gpu_pass_t;
+
+#define FLECS_ENGINE_NULL_GPU_STR(s) \
+    ((WGPUStringView){ .data = (s), .length = sizeof(s) - 1 })
+
+static void* flecsEngine_nullGpu_new(
+    flecs_engine_null_gpu_kind_t kind,
+    ecs_size_t size)
+{
+    flecs_engine_null_gpu_object_t *obj = ecs_os_calloc(size);
+    obj->refcount = 1;
+    obj->kind = kind;
+    return obj;
+}
+
+static void flecsEngine_nullGpu_addRef(
+    void *ptr)
+{
+    if (ptr) {
+        ecs_os_ainc(&((flecs_engine_null_gpu_object_t*)ptr)->refcount);
+    }
+}
+
+static void flecsEngine_nullGpu_release(
+    void *ptr);
+
+static void flecsEngine_nullGpu_commandsFini(
+    ecs_vec_t *commands)
+{
+    int32_t i, count = ecs_vec_count(commands);
+    flecs_engine_null_gpu_command_t *cmds = ecs_vec_first(commands);
+    for (i = 0; i < count; i ++) {
+        flecsEngine_nullGpu_release(cmds[i].src_buffer);
+        flecsEngine_nullGpu_release(cmds[i].src_texture);
+        flecsEngine_nullGpu_release(cmds[i].dst_buffer);
+    }
+    ecs_vec_fini_t(NULL, commands, flecs_engine_null_gpu_command_t);
+}
+
+static void flecsEngine_nullGpu_release(
+    void *ptr)
+{
+    flecs_engine_null_gpu_object_t *obj = ptr;
+    if (!obj || ecs_os_adec(&obj->refcount)) {
+        return;
+    }
+
+    switch (obj->kind) {
+    case FlecsNullGpuInstance: {
+        flecs_engine_null_gpu_instance_t *instance = ptr;
+        ecs_vec_fini_t(NULL, &instance->pending,
+            flecs_engine_null_gpu_pending_t);
+        ecs_os_mutex_free(instance->lock);
+        break;
+    }
+    case FlecsNullGpuBuffer:
+        ecs_os_free(((flecs_engine_null_gpu_buffer_t*)ptr)->data);
+        break;
+    case FlecsNullGpuTexture:
+        ecs_os_free(((flecs_engine_null_gpu_texture_t*)ptr)->data);
+        break;
+    case FlecsNullGpuTextureView:
+        flecsEngine_nullGpu_release(
+            ((flecs_engine_null_gpu_texture_view_t*)ptr)->texture);
+        break;
+    case FlecsNullGpuCommandEncoder:
+    case FlecsNullGpuCommandBuffer:
+        flecsEngine_nullGpu_commandsFini(
+            &((flecs_engine_null_gpu_commands_t*)ptr)->commands);
+        break;
+    default:
+        break;
+    }
+
+    ecs_os_free(obj);
+}
+
+static flecs_engine_null_gpu_command_t* flecsEngine_nullGpu_record(
+    flecs_engine_null_gpu_commands_t *encoder,
+    flecs_engine_null_gpu_command_kind_t kind)
+{
+    flecs_engine_null_gpu_command_t *cmd = ecs_vec_append_t(
+        NULL, &encoder->commands, flecs_engine_null_gpu_command_t);
+    ecs_os_zeromem(cmd);
+    cmd->kind = kind;
+    return cmd;
+}
+
+static flecs_engine_null_gpu_command_t* flecsEngine_nullGpu_recordPass(
+    void *pass,
+    flecs_engine_null_gpu_command_kind_t kind)
+{
+    return flecsEngine_nullGpu_record(
+        ((flecs_engine_null_gpu_pass_t*)pass)->encoder, kind);
+}
+
+/* ---- Events ---- */
+
+static WGPUFuture flecsEngine_nullGpu_enqueue(
+    flecs_engine_null_gpu_instance_t *instance,
+    const flecs_engine_null_gpu_pending_t *pending)
+{
+    ecs_os_mutex_lock(instance->lock);
+    flecs_engine_null_gpu_pending_t *elem = ecs_vec_append_t(
+        NULL, &instance->pending, flecs_engine_null_gpu_pending_t);
+    *elem = *pending;
+    WGPUFuture future = { .id = ++ instance->next_future };
+    ecs_os_mutex_unlock(instance->lock);
+    return future;
+}
+
+static void flecsEngine_nullGpu_fire(
+    flecs_engine_null_gpu_pending_t *p)
+{
+    WGPUStringView message = {0};
+
+    switch (p->kind) {
+    case FlecsNullGpuPendingAdapter:
+        p->info.adapter.callback(WGPURequestAdapterStatus_Success,
+            p->object, message, p->info.adapter.userdata1,
+            p->info.adapter.userdata2);
+        break;
+    case FlecsNullGpuPendingDevice:
+        p->info.device.callback(WGPURequestDeviceStatus_Success,
+            p->object, message, p->info.device.userdata1,
+            p->info.device.userdata2);
+        break;
+    case FlecsNullGpuPendingMap: {
+        flecs_engine_null_gpu_buffer_t *buffer = p->object;
+        buffer->mapped = true;
+        p->info.map.callback(WGPUMapAsyncStatus_Success, message,
+            p->info.map.userdata1, p->info.map.userdata2);
+        flecsEngine_nullGpu_release(buffer);
+        break;
+    }
+    case FlecsNullGpuPendingWorkDone:
+        p->info.work_done.callback(WGPUQueueWorkDoneStatus_Success, message,
+            p->info.work_done.userdata1, p->info.work_done.userdata2);
+        break;
+    }
+}
+
+/* Callbacks may enqueue new work, so they run on a copy of the list and
+ * without holding the lock. */
+static void flecsEngine_nullGpu_processEvents(
+    flecs_engine_null_gpu_instance_t *instance)
+{
+    ecs_os_mutex_lock(instance->lock);
+    ecs_vec_t pending = instance->pending;
+    ecs_vec_init_t(NULL, &instance->pending,
+        flecs_engine_null_gpu_pending_t, 0);
+    ecs_os_mutex_unlock(instance->lock);
+
+    int32_t i, count = ecs_vec_count(&pending);
+    flecs_engine_null_gpu_pending_t *elems = ecs_vec_first(&pending);
+    for (i = 0; i < count; i ++) {
+        flecsEngine_nullGpu_fire(&elems[i]);
+    }
+
+    ecs_vec_fini_t(NULL, &pending, flecs_engine_null_gpu_pending_t);
+}
+
+/* ---- Instance and adapter ---- */
+
+static WGPUInstance flecsEngine_nullGpu_CreateInstance(
+    WGPUInstanceDescriptor const *descriptor)
+{
+    (void)descriptor;
+    flecs_engine_null_gpu_instance_t *instance = flecsEngine_nullGpu_new(
+        FlecsNullGpuInstance, ECS_SIZEOF(flecs_engine_null_gpu_instance_t));
+    instance->lock = ecs_os_mutex_new();
+    ecs_vec_init_t(NULL, &instance->pending,
+        flecs_engine_null_gpu_pending_t, 0);
+    return (WGPUInstance)instance;
+}
+
+static void flecsEngine_nullGpu_InstanceProcessEvents(
+    WGPUInstance instance)
+{
+    flecsEngine_nullGpu_processEvents(
+        (flecs_engine_null_gpu_instance_t*)instance);
+}
+
+static WGPUFuture flecsEngine_nullGpu_InstanceRequestAdapter(
+    WGPUInstance instance,
+    WGPURequestAdapterOptions const *options,
+    WGPURequestAdapterCallbackInfo callbackInfo)
+{
+    (void)options;
+    flecs_engine_null_gpu_child_t *adapter = flecsEngine_nullGpu_new(
+        FlecsNullGpuAdapter, ECS_SIZEOF(flecs_engine_null_gpu_child_t));
+    adapter->instance = (flecs_engine_null_gpu_instance_t*)instance;
+
+    flecs_engine_null_gpu_pending_t pending = {
+        .kind = FlecsNullGpuPendingAdapter,
+        .object = adapter,
+        .info.adapter = callbackInfo
+    };
+    return flecsEngine_nullGpu_enqueue(adapter->instance, &pending);
+}
+
+static WGPUWaitStatus flecsEngine_nullGpu_InstanceWaitAny(
+    WGPUInstance instance,
+    size_t futureCount,
+    WGPUFutureWaitInfo *futures,
+    uint64_t timeoutNS)
+{
+    (void)timeoutNS;
+    flecsEngine_nullGpu_processEvents(
+        (flecs_engine_null_gpu_instance_t*)instance);
+    for (size_t i = 0; i < futureCount; i ++) {
+        futures[i].completed = true;
+    }
+    return WGPUWaitStatus_Success;
+}
+
+static void flecsEngine_nullGpu_InstanceRelease(
+    WGPUInstance instance)
+{
+    flecsEngine_nullGpu_release(instance);
+}
+
+static WGPUFuture flecsEngine_nullGpu_AdapterRequestDevice(
+    WGPUAdapter adapter,
+    WGPUDeviceDescriptor const *descriptor,
+    WGPURequestDeviceCallbackInfo callbackInfo)
+{
+    (void)descriptor;
+    flecs_engine_null_gpu_child_t *device = flecsEngine_nullGpu_new(
+        FlecsNullGpuDevice, ECS_SIZEOF(flecs_engine_null_gpu_child_t));
+    device->instance = ((flecs_engine_null_gpu_child_t*)adapter)->instance;
+
+    flecs_engine_null_gpu_pending_t pending = {
+        .kind = FlecsNullGpuPendingDevice,
+        .object = device,
+        .info.device = callbackInfo
+    };
+    return flecsEngine_nullGpu_enqueue(device->instance, &pending);
+}
+
+/* Report the features the engine checks for as supported, except timestamp
+ * queries, which have nothing to measure. */
+static WGPUBool flecsEngine_nullGpu_hasFeature(
+    WGPUFeatureName feature)
+{
+    return feature == WGPUFeatureName_TextureCompressionBC ||
+        feature == WGPUFeatureName_RG11B10UfloatRenderable;
+}
+
+static WGPUBool flecsEngine_nullGpu_AdapterHasFeature(
+    WGPUAdapter adapter,
+    WGPUFeatureName feature)
+{
+    (void)adapter;
+    return flecsEngine_nullGpu_hasFeature(feature);
+}
+
+static WGPUStatus flecsEngine_nullGpu_AdapterGetInfo(
+    WGPUAdapter adapter,
+    WGPUAdapterInfo *info)
+{
+    (void)adapter;
+    info->vendor = FLECS_ENGINE_NULL_GPU_STR("flecs");
+    info->architecture = FLECS_ENGINE_NULL_GPU_STR("");
+    info->device = FLECS_ENGINE_NULL_GPU_STR("Null GPU");
+    info->description = FLECS_ENGINE_NULL_GPU_STR("Null WebGPU backend");
+    info->backendType = WGPUBackendType_Null;
+    info->adapterType = WGPUAdapterType_CPU;
+    info->vendorID = 0;
+    info->deviceID = 0;
+    return WGPUStatus_Success;
+}
+
+static void flecsEngine_nullGpu_AdapterInfoFreeMembers(
+    WGPUAdapterInfo adapterInfo)
+{
+    /* Strings are static */
+    (void)adapterInfo;
+}
+
+static void flecsEngine_nullGpu_AdapterRelease(
+    WGPUAdapter adapter)
+{
+    flecsEngine_nullGpu_release(adapter);
+}
+
+/* ---- Device ---- */
+
+static void* flecsEngine_nullGpu_newOther(void)
+{
+    return flecsEngine_nullGpu_new(
+        FlecsNullGpuOther, ECS_SIZEOF(flecs_engine_null_gpu_object_t));
+}
+
+static WGPUBindGroup flecsEngine_nullGpu_DeviceCreateBindGroup(
+    WGPUDevice device,
+    WGPUBindGroupDescriptor const *descriptor)
+{
+    (void)device;
+    (void)descriptor;
+    return flecsEngine_nullGpu_newOther();
+}
+
+static WGPUBindGroupLayout flecsEngine_nullGpu_DeviceCreateBindGroupLayout(
+    WGPUDevice device,
+    WGPUBindGroupLayoutDescriptor const *descriptor)
+{
+    (void)device;
+    (void)descriptor;
+    return flecsEngine_nullGpu_newOther();
+}
+
+static WGPUBuffer flecsEngine_nullGpu_DeviceCreateBuffer(
+    WGPUDevice device,
+    WGPUBufferDescriptor const *descriptor)
+{
+    flecs_engine_null_gpu_buffer_t *buffer = flecsEngine_nullGpu_new(
+        FlecsNullGpuBuffer, ECS_SIZEOF(flecs_engine_null_gpu_buffer_t));
+    buffer->instance = ((flecs_engine_null_gpu_child_t*)device)->instance;
+    buffer->size = descriptor->size;
+    buffer->data = ecs_os_calloc(
+        (ecs_size_t)(descriptor->size ? descriptor->size : 1));
+    buffer->mapped = descriptor->mappedAtCreation;
+    return (WGPUBuffer)buffer;
+}
+
+static WGPUCommandEncoder flecsEngine_nullGpu_DeviceCreateCommandEncoder(
+    WGPUDevice device,
+    WGPUCommandEncoderDescriptor const *descriptor)
+{
+    (void)device;
+    (void)descriptor;
+    flecs_engine_null_gpu_commands_t *encoder = flecsEngine_nullGpu_new(
+        FlecsNullGpuCommandEncoder,
+        ECS_SIZEOF(flecs_engine_null_gpu_commands_t));
+    ecs_vec_init_t(NULL, &encoder->commands,
+        flecs_engine_null_gpu_command_t, 0);
+    return (WGPUCommandEncoder)encoder;
+}
+
+static WGPUComputePipeline flecsEngine_nullGpu_DeviceCreateComputePipeline(
+    WGPUDevice device,
+    WGPUComputePipelineDescriptor const *descriptor)
+{
+    (void)device;
+    (void)descriptor;
+    return flecsEngine_nullGpu_newOther();
+}
+
+static WGPUPipelineLayout flecsEngine_nullGpu_DeviceCreatePipelineLayout(
+    WGPUDevice device,
+    WGPUPipelineLayoutDescriptor const *descriptor)
+{
+    (void)device;
+    (void)descriptor;
+    return flecsEngine_nullGpu_newOther();
+}
+
+static WGPUQuerySet flecsEngine_nullGpu_DeviceCreateQuerySet(
+    WGPUDevice device,
+    WGPUQuerySetDescriptor const *descriptor)
+{
+    (void)device;
+    (void)descriptor;
+    return flecsEngine_nullGpu_newOther();
+}
+
+static WGPURenderPipeline flecsEngine_nullGpu_DeviceCreateRenderPipeline(
+    WGPUDevice device,
+    WGPURenderPipelineDescriptor const *descriptor)
+{
+    (void)device;
+    (void)descriptor;
+    return flecsEngine_nullGpu_newOther();
+}
+
+static WGPUSampler flecsEngine_nullGpu_DeviceCreateSampler(
+    WGPUDevice device,
+    WGPUSamplerDescriptor const *descriptor)
+{
+    (void)device;
+    (void)descriptor;
+    return flecsEngine_nullGpu_newOther();
+}
+
+static WGPUShaderModule flecsEngine_nullGpu_DeviceCreateShaderModule(
+    WGPUDevice device,
+    WGPUShaderModuleDescriptor const *descriptor)
+{
+    (void)device;
+    (void)descriptor;
+    return flecsEngine_nullGpu_newOther();
+}
+
+static WGPUTexture flecsEngine_nullGpu_DeviceCreateTexture(
+    WGPUDevice device,
+    WGPUTextureDescriptor const *descriptor)
+{
+    (void)device;
+    flecs_engine_null_gpu_texture_t *texture = flecsEngine_nullGpu_new(
+        FlecsNullGpuTexture, ECS_SIZEOF(flecs_engine_null_gpu_texture_t));
+    texture->format = descriptor->format;
+    texture->dimension = descriptor->dimension;
+    texture->size = descriptor->size;
+    texture->mip_level_count = descriptor->mipLevelCount;
+    texture->sample_count = descriptor->sampleCount;
+    return (WGPUTexture)texture;
+}
+
+static WGPUQueue flecsEngine_nullGpu_DeviceGetQueue(
+    WGPUDevice device)
+{
+    flecs_engine_null_gpu_child_t *queue = flecsEngine_nullGpu_new(
+        FlecsNullGpuQueue, ECS_SIZEOF(flecs_engine_null_gpu_child_t));
+    queue->instance = ((flecs_engine_null_gpu_child_t*)device)->instance;
+    return (WGPUQueue)queue;
+}
+
+static WGPUBool flecsEngine_nullGpu_DeviceHasFeature(
+    WGPUDevice device,
+    WGPUFeatureName feature)
+{
+    (void)device;
+    return flecsEngine_nullGpu_hasFeature(feature);
+}
+
+static void flecsEngine_nullGpu_DeviceRelease(
+    WGPUDevice device)
+{
+    flecsEngine_nullGpu_release(device);
+}
+
+/* ---- Textures ---- */
+
+typedef struct {
+    int64_t row_bytes;   /* Bytes in a row of blocks */
+    int64_t image_bytes; /* Bytes in a layer or depth slice */
+    int64_t offset;      /* Offset of the level in the texture storage */
+} flecs_engine_null_gpu_level_t;
+
+/* Levels are stored one after the other, with the layers of a level stored
+ * contiguously. Returns the size of the storage. */
+static int64_t flecsEngine_nullGpu_textureLevel(
+    const flecs_engine_null_gpu_texture_t *texture,
+    uint32_t mip_level,
+    flecs_engine_null_gpu_level_t *level_out)
+{
+    uint32_t block_dim;
+    int64_t block_size = flecsEngine_textureBlockSize(
+        texture->format, &block_dim);
+    uint32_t mip_count = texture->mip_level_count ?
+        texture->mip_level_count : 1;
+
+    int64_t offset = 0;
+    for (uint32_t m = 0; m < mip_count; m ++) {
+        uint32_t w = texture->size.width >> m;
+        uint32_t h = texture->size.height >> m;
+        uint32_t d = texture->size.depthOrArrayLayers;
+        if (texture->dimension == WGPUTextureDimension_3D) {
+            d >>= m;
+        }
+
+        flecs_engine_null_gpu_level_t level;
+        level.row_bytes = block_size *
+            (((w ? w : 1) + block_dim - 1) / block_dim);
+        level.image_bytes = level.row_bytes *
+            (((h ? h : 1) + block_dim - 1) / block_dim);
+        level.offset = offset;
+
+        if (m == mip_level && level_out) {
+            *level_out = level;
+        }
+
+        offset += level.image_bytes * (d ? d : 1);
+    }
+
+    return offset;
+}
+
+/* Copy a region between texture storage and linear memory. Reads from a
+ * texture that was never written return zeros. */
+static void flecsEngine_nullGpu_copyTexels(
+    flecs_engine_null_gpu_texture_t *texture,
+    uint32_t mip_level,
+    WGPUOrigin3D origin,
+    uint8_t *data,
+    uint64_t data_size,
+    const WGPUTexelCopyBufferLayout *layout,
+    const WGPUExtent3D *extent,
+    bool to_texture)
+{
+    flecs_engine_null_gpu_level_t level = {0};
+    int64_t storage_size = flecsEngine_nullGpu_textureLevel(
+        texture, mip_level, &level);
+
+    if (to_texture && !texture->data) {
+        texture->data = ecs_os_calloc((ecs_size_t)storage_size);
+    }
+
+    uint32_t block_dim;
+    int64_t block_size = flecsEngine_textureBlockSize(
+        texture->format, &block_dim);
+    int64_t copy_row_bytes = block_size *
+        ((extent->width + block_dim - 1) / block_dim);
+    uint32_t copy_rows = (extent->height + block_dim - 1) / block_dim;
+
+    int64_t bytes_per_row = layout->bytesPerRow;
+    if (layout->bytesPerRow == WGPU_COPY_STRIDE_UNDEFINED) {
+        bytes_per_row = copy_row_bytes;
+    }
+    int64_t rows_per_image = layout->rowsPerImage;
+    if (layout->rowsPerImage == WGPU_COPY_STRIDE_UNDEFINED) {
+        rows_per_image = copy_rows;
+    }
+
+    for (uint32_t z = 0; z < extent->depthOrArrayLayers; z ++) {
+        for (uint32_t y = 0; y < copy_rows; y ++) {
+            int64_t tex_offset = level.offset +
+                (int64_t)(origin.z + z) * level.image_bytes +
+                (int64_t)(origin.y / block_dim + y) * level.row_bytes +
+                (int64_t)(origin.x / block_dim) * block_size;
+            int64_t data_offset = (int64_t)layout->offset +
+                (int64_t)z * rows_per_image * bytes_per_row +
+                (int64_t)y * bytes_per_row;
+
+            if (data_offset + copy_row_bytes > (int64_t)data_size ||
+                tex_offset + copy_row_bytes > storage_size)
+            {
+                continue;
+            }
+
+            if (to_texture) {
+                memcpy(texture->data + tex_offset, data + data_offset,
+                    (size_t)copy_row_bytes);
+            } else if (texture->data) {
+                memcpy(data + data_offset, texture->data + tex_offset,
+                    (size_t)copy_row_bytes);
+            } else {
+                memset(data + data_offset, 0, (size_t)copy_row_bytes);
+            }
+        }
+    }
+}
+
+static WGPUTextureView flecsEngine_nullGpu_TextureCreateView(
+    WGPUTexture texture,
+    WGPUTextureViewDescriptor const *descriptor)
+{
+    (void)descriptor;
+    flecs_engine_null_gpu_texture_view_t *view = flecsEngine_nullGpu_new(
+        FlecsNullGpuTextureView,
+        ECS_SIZEOF(flecs_engine_null_gpu_texture_view_t));
+    view->texture = (flecs_engine_null_gpu_texture_t*)texture;
+    flecsEngine_nullGpu_addRef(texture);
+    return (WGPUTextureView)view;
+}
+
+static uint32_t flecsEngine_nullGpu_TextureGetWidth(
+    WGPUTexture texture)
+{
+    return ((flecs_engine_null_gpu_texture_t*)texture)->size.width;
+}
+
+static uint32_t flecsEngine_nullGpu_TextureGetHeight(
+    WGPUTexture texture)
+{
+    return ((flecs_engine_null_gpu_texture_t*)texture)->size.height;
+}
+
+static uint32_t flecsEngine_nullGpu_TextureGetDepthOrArrayLayers(
+    WGPUTexture texture)
+{
+    return ((flecs_engine_null_gpu_texture_t*)texture)
+        ->size.depthOrArrayLayers;
+}
+
+static uint32_t flecsEngine_nullGpu_TextureGetMipLevelCount(
+    WGPUTexture texture)
+{
+    return ((flecs_engine_null_gpu_texture_t*)texture)->mip_level_count;
+}
+
+static uint32_t flecsEngine_nullGpu_TextureGetSampleCount(
+    WGPUTexture texture)
+{
+    return ((flecs_engine_null_gpu_texture_t*)texture)->sample_count;
+}
+
+static WGPUTextureFormat flecsEngine_nullGpu_TextureGetFormat(
+    WGPUTexture texture)
+{
+    return ((flecs_engine_null_gpu_texture_t*)texture)->format;
+}
+
+static WGPUTextureDimension flecsEngine_nullGpu_TextureGetDimension(
+    WGPUTexture texture)
+{
+    return ((flecs_engine_null_gpu_texture_t*)texture)->dimension;
+}
+
+static void flecsEngine_nullGpu_TextureRelease(
+    WGPUTexture texture)
+{
+    flecsEngine_nullGpu_release(texture);
+}
+
+static void flecsEngine_nullGpu_TextureViewRelease(
+    WGPUTextureView textureView)
+{
+    flecsEngine_nullGpu_release(textureView);
+}
+
+/* ---- Buffers ---- */
+
+static WGPUFuture flecsEngine_nullGpu_BufferMapAsync(
+    WGPUBuffer buffer,
+    WGPUMapMode mode,
+    size_t offset,
+    size_t size,
+    WGPUBufferMapCallbackInfo callbackInfo)
+{
+    (void)mode;
+    (void)offset;
+    (void)size;
+    flecs_engine_null_gpu_buffer_t *ptr =
+        (flecs_engine_null_gpu_buffer_t*)buffer;
+
+    /* Keep the buffer alive until the callback fired */
+    flecsEngine_nullGpu_addRef(ptr);
+
+    flecs_engine_null_gpu_pending_t pending = {
+        .kind = FlecsNullGpuPendingMap,
+        .object = ptr,
+        .info.map = callbackInfo
+    };
+    return flecsEngine_nullGpu_enqueue(ptr->instance, &pending);
+}
+
+static void const* flecsEngine_nullGpu_BufferGetConstMappedRange(
+    WGPUBuffer buffer,
+    size_t offset,
+    size_t size)
+{
+    flecs_engine_null_gpu_buffer_t *ptr =
+        (flecs_engine_null_gpu_buffer_t*)buffer;
+    if (!ptr->mapped || offset > ptr->size) {
+        return NULL;
+    }
+    if (size != WGPU_WHOLE_MAP_SIZE && offset + size > ptr->size) {
+        return NULL;
+    }
+    return ptr->data + offset;
+}
+
+static uint64_t flecsEngine_nullGpu_BufferGetSize(
+    WGPUBuffer buffer)
+{
+    return ((flecs_engine_null_gpu_buffer_t*)buffer)->size;
+}
+
+static void flecsEngine_nullGpu_BufferUnmap(
+    WGPUBuffer buffer)
+{
+    ((flecs_engine_null_gpu_buffer_t*)buffer)->mapped = false;
+}
+
+static void flecsEngine_nullGpu_BufferAddRef(
+    WGPUBuffer buffer)
+{
+    flecsEngine_nullGpu_addRef(buffer);
+}
+
+static void flecsEngine_nullGpu_BufferRelease(
+    WGPUBuffer buffer)
+{
+    flecsEngine_nullGpu_release(buffer);
+}
+
+/* ---- Queue ---- */
+
+/* FNV-1a step, the result depends on the order in which values are hashed */
+static uint64_t flecsEngine_nullGpu_hash(
+    uint64_t hash,
+    uint64_t value)
+{
+    return (hash ^ value) * 1099511628211ull;
+}
+
+static void flecsEngine_nullGpu_execute(
+    const flecs_engine_null_gpu_command_t *cmd,
+    flecs_engine_gpu_command_counters_t *counters)
+{
+    switch (cmd->kind) {
+    case FlecsNullGpuCmdBeginRenderPass:
+        counters->render_pass_count ++;
+        break;
+    case FlecsNullGpuCmdBeginComputePass:
+        counters->compute_pass_count ++;
+        break;
+    case FlecsNullGpuCmdSetPipeline:
+        counters->pipeline_set_count ++;
+        break;
+    case FlecsNullGpuCmdSetBindGroup:
+        counters->bind_group_set_count ++;
+        break;
+    case FlecsNullGpuCmdSetVertexBuffer:
+        counters->vertex_buffer_set_count ++;
+        break;
+    case FlecsNullGpuCmdSetIndexBuffer:
+        counters->index_buffer_set_count ++;
+        break;
+    case FlecsNullGpuCmdDraw:
+        counters->draw_count ++;
+        break;
+    case FlecsNullGpuCmdDrawIndexed:
+        counters->draw_indexed_count ++;
+        break;
+    case FlecsNullGpuCmdDispatch:
+        counters->dispatch_count ++;
+        break;
+    case FlecsNullGpuCmdCopyBufferToBuffer: {
+        const flecs_engine_null_gpu_buffer_t *src = cmd->src_buffer;
+        flecs_engine_null_gpu_buffer_t *dst = cmd->dst_buffer;
+        if (cmd->src_offset + cmd->size <= src->size &&
+            cmd->dst_offset + cmd->size <= dst->size)
+        {
+            memmove(dst->data + cmd->dst_offset,
+                src->data + cmd->src_offset, (size_t)cmd->size);
+        }
+        counters->copy_count ++;
+        break;
+    }
+    case FlecsNullGpuCmdCopyTextureToBuffer:
+        flecsEngine_nullGpu_copyTexels(cmd->src_texture, cmd->mip_level,
+            cmd->origin, cmd->dst_buffer->data, cmd->dst_buffer->size,
+            &cmd->layout, &cmd->extent, false);
+        counters->copy_count ++;
+        break;
+    case FlecsNullGpuCmdResolveQuerySet: {
+        /* Queries are never written, resolve them to zero */
+        flecs_engine_null_gpu_buffer_t *dst = cmd->dst_buffer;
+        uint64_t size = (uint64_t)cmd->count * sizeof(uint64_t);
+        if (cmd->dst_offset + size <= dst->size) {
+            memset(dst->data + cmd->dst_offset, 0, (size_t)size);
+        }
+        counters->copy_count ++;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static void flecsEngine_nullGpu_QueueSubmit(
+    WGPUQueue queue,
+    size_t commandCount,
+    WGPUCommandBuffer const *commands)
+{
+    flecs_engine_null_gpu_instance_t *instance =
+        ((flecs_engine_null_gpu_child_t*)queue)->instance;
+
+    flecs_engine_gpu_command_counters_t counters = {0};
+    counters.submit_count = 1;
+    counters.command_buffer_count = (int32_t)commandCount;
+
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < commandCount; i ++) {
+        flecs_engine_null_gpu_commands_t *cb =
+            (flecs_engine_null_gpu_commands_t*)commands[i];
+        int32_t c, count = ecs_vec_count(&cb->commands);
+        flecs_engine_null_gpu_command_t *cmds = ecs_vec_first(&cb->commands);
+        hash = flecsEngine_nullGpu_hash(hash, (uint64_t)count);
+        for (c = 0; c < count; c ++) {
+            flecsEngine_nullGpu_execute(&cmds[c], &counters);
+            hash = flecsEngine_nullGpu_hash(hash, cmds[c].kind);
+            hash = flecsEngine_nullGpu_hash(hash, cmds[c].count);
+            hash = flecsEngine_nullGpu_hash(hash, cmds[c].instance_count);
+        }
+    }
+
+    ecs_os_mutex_lock(instance->lock);
+    flecs_engine_gpu_command_counters_t *dst = &instance->counters;
+    dst->submit_count += counters.submit_count;
+    dst->command_buffer_count += counters.command_buffer_count;
+    dst->render_pass_count += counters.render_pass_count;
+    dst->compute_pass_count += counters.compute_pass_count;
+    dst->draw_count += counters.draw_count;
+    dst->draw_indexed_count += counters.draw_indexed_count;
+    dst->dispatch_count += counters.dispatch_count;
+    dst->pipeline_set_count += counters.pipeline_set_count;
+    dst->bind_group_set_count += counters.bind_group_set_count;
+    dst->vertex_buffer_set_count += counters.vertex_buffer_set_count;
+    dst->index_buffer_set_count += counters.index_buffer_set_count;
+    dst->copy_count += counters.copy_count;
+    dst->command_hash = flecsEngine_nullGpu_hash(dst->command_hash, hash);
+    ecs_os_mutex_unlock(instance->lock);
+}
+
+static void flecsEngine_nullGpu_QueueWriteBuffer(
+    WGPUQueue queue,
+    WGPUBuffer buffer,
+    uint64_t bufferOffset,
+    void const *data,
+    size_t size)
+{
+    flecs_engine_null_gpu_instance_t *instance =
+        ((flecs_engine_null_gpu_child_t*)queue)->instance;
+    flecs_engine_null_gpu_buffer_t *ptr =
+        (flecs_engine_null_gpu_buffer_t*)buffer;
+
+    if (bufferOffset + size <= ptr->size) {
+        memcpy(ptr->data + bufferOffset, data, size);
+    } else {
+        ecs_err("null GPU: write of %u bytes at offset %u exceeds buffer "
+            "size %u\n", (uint32_t)size, (uint32_t)bufferOffset,
+            (uint32_t)ptr->size);
+    }
+
+    ecs_os_mutex_lock(instance->lock);
+    instance->counters.write_buffer_count ++;
+    instance->counters.write_buffer_bytes += (int64_t)size;
+    ecs_os_mutex_unlock(instance->lock);
+}
+
+static void flecsEngine_nullGpu_QueueWriteTexture(
+    WGPUQueue queue,
+    WGPUTexelCopyTextureInfo const *destination,
+    void const *data,
+    size_t dataSize,
+    WGPUTexelCopyBufferLayout const *dataLayout,
+    WGPUExtent3D const *writeSize)
+{
+    flecs_engine_null_gpu_instance_t *instance =
+        ((flecs_engine_null_gpu_child_t*)queue)->instance;
+
+    flecsEngine_nullGpu_copyTexels(
+        (flecs_engine_null_gpu_texture_t*)destination->texture,
+        destination->mipLevel, destination->origin, (uint8_t*)data,
+        dataSize, dataLayout, writeSize, true);
+
+    ecs_os_mutex_lock(instance->lock);
+    instance->counters.write_texture_count ++;
+    instance->counters.write_texture_bytes += (int64_t)dataSize;
+    ecs_os_mutex_unlock(instance->lock);
+}
+
+static WGPUFuture flecsEngine_nullGpu_QueueOnSubmittedWorkDone(
+    WGPUQueue queue,
+    WGPUQueueWorkDoneCallbackInfo callbackInfo)
+{
+    /* Submitted work is done when wgpuQueueSubmit returns */
+    flecs_engine_null_gpu_pending_t pending = {
+        .kind = FlecsNullGpuPendingWorkDone,
+        .info.work_done = callbackInfo
+    };
+    return flecsEngine_nullGpu_enqueue(
+        ((flecs_engine_null_gpu_child_t*)queue)->instance, &pending);
+}
+
+static void flecsEngine_nullGpu_QueueRelease(
+    WGPUQueue queue)
+{
+    flecsEngine_nullGpu_release(queue);
+}
+
+/* ---- Command encoding ---- */
+
+static void* flecsEngine_nullGpu_beginPass(
+    WGPUCommandEncoder commandEncoder,
+    flecs_engine_null_gpu_command_kind_t kind)
+{
+    flecs_engine_null_gpu_commands_t *encoder =
+        (flecs_engine_null_gpu_commands_t*)commandEncoder;
+    flecsEngine_nullGpu_record(encoder, kind);
+
+    flecs_engine_null_gpu_pass_t *pass = flecsEngine_nullGpu_new(
+        FlecsNullGpuPassEncoder, ECS_SIZEOF(flecs_engine_null_gpu_pass_t));
+    pass->encoder = encoder;
+    return pass;
+}
+
+static WGPURenderPassEncoder flecsEngine_nullGpu_CommandEncoderBeginRenderPass(
+    WGPUCommandEncoder commandEncoder,
+    WGPURenderPassDescriptor const *descriptor)
+{
+    (void)descriptor;
+    return flecsEngine_nullGpu_beginPass(
+        commandEncoder, FlecsNullGpuCmdBeginRenderPass);
+}
+
+static WGPUComputePassEncoder flecsEngine_nullGpu_CommandEncoderBeginComputePass(
+    WGPUCommandEncoder commandEncoder,
+    WGPUComputePassDescriptor const *descriptor)
+{
+    (void)descriptor;
+    return flecsEngine_nullGpu_beginPass(
+        commandEncoder, FlecsNullGpuCmdBeginComputePass);
+}
+
+static void flecsEngine_nullGpu_CommandEncoderCopyBufferToBuffer(
+    WGPUCommandEncoder commandEncoder,
+    WGPUBuffer source,
+    uint64_t sourceOffset,
+    WGPUBuffer destination,
+    uint64_t destinationOffset,
+    uint64_t size)
+{
+    flecs_engine_null_gpu_command_t *cmd = flecsEngine_nullGpu_record(
+        (flecs_engine_null_gpu_commands_t*)commandEncoder,
+        FlecsNullGpuCmdCopyBufferToBuffer);
+    cmd->src_buffer = (flecs_engine_null_gpu_buffer_t*)source;
+    cmd->dst_buffer = (flecs_engine_null_gpu_buffer_t*)destination;
+    cmd->src_offset = sourceOffset;
+    cmd->dst_offset = destinationOffset;
+    cmd->size = size;
+    flecsEngine_nullGpu_addRef(source);
+    flecsEngine_nullGpu_addRef(destination);
+}
+
+static void flecsEngine_nullGpu_CommandEncoderCopyTextureToBuffer(
+    WGPUCommandEncoder commandEncoder,
+    WGPUTexelCopyTextureInfo const *source,
+    WGPUTexelCopyBufferInfo const *destination,
+    WGPUExtent3D const *copySize)
+{
+    flecs_engine_null_gpu_command_t *cmd = flecsEngine_nullGpu_record(
+        (flecs_engine_null_gpu_commands_t*)commandEncoder,
+        FlecsNullGpuCmdCopyTextureToBuffer);
+    cmd->src_texture = (flecs_engine_null_gpu_texture_t*)source->texture;
+    cmd->dst_buffer = (flecs_engine_null_gpu_buffer_t*)destination->buffer;
+    cmd->mip_level = source->mipLevel;
+    cmd->origin = source->origin;
+    cmd->layout = destination->layout;
+    cmd->extent = *copySize;
+    flecsEngine_nullGpu_addRef(source->texture);
+    flecsEngine_nullGpu_addRef(destination->buffer);
+}
+
+static WGPUCommandBuffer flecsEngine_nullGpu_CommandEncoderFinish(
+    WGPUCommandEncoder commandEncoder,
+    WGPUCommandBufferDescriptor const *descriptor)
+{
+    (void)descriptor;
+    flecs_engine_null_gpu_commands_t *encoder =
+        (flecs_engine_null_gpu_commands_t*)commandEncoder;
+
+    /* Move the recorded commands to the command buffer */
+    flecs_engine_null_gpu_commands_t *cb = flecsEngine_nullGpu_new(
+        FlecsNullGpuCommandBuffer,
+        ECS_SIZEOF(flecs_engine_null_gpu_commands_t));
+    cb->commands = encoder->commands;
+    ecs_vec_init_t(NULL, &encoder->commands,
+        flecs_engine_null_gpu_command_t, 0);
+    return (WGPUCommandBuffer)cb;
+}
+
+static void flecsEngine_nullGpu_CommandEncoderResolveQuerySet(
+    WGPUCommandEncoder commandEncoder,
+    WGPUQuerySet querySet,
+    uint32_t firstQuery,
+    uint32_t queryCount,
+    WGPUBuffer destination,
+    uint64_t destinationOffset)
+{
+    (void)querySet;
+    (void)firstQuery;
+    flecs_engine_null_gpu_command_t *cmd = flecsEngine_nullGpu_record(
+        (flecs_engine_null_gpu_commands_t*)commandEncoder,
+        FlecsNullGpuCmdResolveQuerySet);
+    cmd->dst_buffer = (flecs_engine_null_gpu_buffer_t*)destination;
+    cmd->dst_offset = destinationOffset;
+    cmd->count = queryCount;
+    flecsEngine_nullGpu_addRef(destination);
+}
+
+static void flecsEngine_nullGpu_CommandEncoderRelease(
+    WGPUCommandEncoder commandEncoder)
+{
+    flecsEngine_nullGpu_release(commandEncoder);
+}
+
+static void flecsEngine_nullGpu_CommandBufferRelease(
+    WGPUCommandBuffer commandBuffer)
+{
+    flecsEngine_nullGpu_release(commandBuffer);
+}
+
+static void flecsEngine_nullGpu_RenderPassEncoderSetPipeline(
+    WGPURenderPassEncoder renderPassEncoder,
+    WGPURenderPipeline pipeline)
+{
+    (void)pipeline;
+    flecsEngine_nullGpu_recordPass(
+        renderPassEncoder, FlecsNullGpuCmdSetPipeline);
+}
+
+static void flecsEngine_nullGpu_RenderPassEncoderSetBindGroup(
+    WGPURenderPassEncoder renderPassEncoder,
+    uint32_t groupIndex,
+    WGPUBindGroup group,
+    size_t dynamicOffsetCount,
+    uint32_t const *dynamicOffsets)
+{
+    (void)groupIndex;
+    (void)group;
+    (void)dynamicOffsetCount;
+    (void)dynamicOffsets;
+    flecsEngine_nullGpu_recordPass(
+        renderPassEncoder, FlecsNullGpuCmdSetBindGroup);
+}
+
+static void flecsEngine_nullGpu_RenderPassEncoderSetVertexBuffer(
+    WGPURenderPassEncoder renderPassEncoder,
+    uint32_t slot,
+    WGPUBuffer buffer,
+    uint64_t offset,
+    uint64_t size)
+{
+    (void)slot;
+    (void)buffer;
+    (void)offset;
+    (void)size;
+    flecsEngine_nullGpu_recordPass(
+        renderPassEncoder, FlecsNullGpuCmdSetVertexBuffer);
+}
+
+static void flecsEngine_nullGpu_RenderPassEncoderSetIndexBuffer(
+    WGPURenderPassEncoder renderPassEncoder,
+    WGPUBuffer buffer,
+    WGPUIndexFormat format,
+    uint64_t offset,
+    uint64_t size)
+{
+    (void)buffer;
+    (void)format;
+    (void)offset;
+    (void)size;
+    flecsEngine_nullGpu_recordPass(
+        renderPassEncoder, FlecsNullGpuCmdSetIndexBuffer);
+}
+
+static void flecsEngine_nullGpu_RenderPassEncoderSetViewport(
+    WGPURenderPassEncoder renderPassEncoder,
+    float x,
+    float y,
+    float width,
+    float height,
+    float minDepth,
+    float maxDepth)
+{
+    (void)x;
+    (void)y;
+    (void)width;
+    (void)height;
+    (void)minDepth;
+    (void)maxDepth;
+    flecsEngine_nullGpu_recordPass(
+        renderPassEncoder, FlecsNullGpuCmdSetViewport);
+}
+
+static void flecsEngine_nullGpu_RenderPassEncoderSetBlendConstant(
+    WGPURenderPassEncoder renderPassEncoder,
+    WGPUColor const *color)
+{
+    (void)color;
+    flecsEngine_nullGpu_recordPass(
+        renderPassEncoder, FlecsNullGpuCmdSetBlendConstant);
+}
+
+static void flecsEngine_nullGpu_RenderPassEncoderDraw(
+    WGPURenderPassEncoder renderPassEncoder,
+    uint32_t vertexCount,
+    uint32_t instanceCount,
+    uint32_t firstVertex,
+    uint32_t firstInstance)
+{
+    (void)firstVertex;
+    (void)firstInstance;
+    flecs_engine_null_gpu_command_t *cmd = flecsEngine_nullGpu_recordPass(
+        renderPassEncoder, FlecsNullGpuCmdDraw);
+    cmd->count = vertexCount;
+    cmd->instance_count = instanceCount;
+}
+
+static void flecsEngine_nullGpu_RenderPassEncoderDrawIndexed(
+    WGPURenderPassEncoder renderPassEncoder,
+    uint32_t indexCount,
+    uint32_t instanceCount,
+    uint32_t firstIndex,
+    int32_t baseVertex,
+    uint32_t firstInstance)
+{
+    (void)firstIndex;
+    (void)baseVertex;
+    (void)firstInstance;
+    flecs_engine_null_gpu_command_t *cmd = flecsEngine_nullGpu_recordPass(
+        renderPassEncoder, FlecsNullGpuCmdDrawIndexed);
+    cmd->count = indexCount;
+    cmd->instance_count = instanceCount;
+}
+
+static void flecsEngine_nullGpu_RenderPassEncoderEnd(
+    WGPURenderPassEncoder renderPassEncoder)
+{
+    flecsEngine_nullGpu_recordPass(
+        renderPassEncoder, FlecsNullGpuCmdEndPass);
+}
+
+static void flecsEngine_nullGpu_RenderPassEncoderRelease(
+    WGPURenderPassEncoder renderPassEncoder)
+{
+    flecsEngine_nullGpu_release(renderPassEncoder);
+}
+
+static void flecsEngine_nullGpu_ComputePassEncoderSetPipeline(
+    WGPUComputePassEncoder computePassEncoder,
+    WGPUComputePipeline pipeline)
+{
+    (void)pipeline;
+    flecsEngine_nullGpu_recordPass(
+        computePassEncoder, FlecsNullGpuCmdSetPipeline);
+}
+
+static void flecsEngine_nullGpu_ComputePassEncoderSetBindGroup(
+    WGPUComputePassEncoder computePassEncoder,
+    uint32_t groupIndex,
+    WGPUBindGroup group,
+    size_t dynamicOffsetCount,
+    uint32_t const *dynamicOffsets)
+{
+    (void)groupIndex;
+    (void)group;
+    (void)dynamicOffsetCount;
+    (void)dynamicOffsets;
+    flecsEngine_nullGpu_recordPass(
+        computePassEncoder, FlecsNullGpuCmdSetBindGroup);
+}
+
+static void flecsEngine_nullGpu_ComputePassEncoderDispatchWorkgroups(
+    WGPUComputePassEncoder computePassEncoder,
+    uint32_t workgroupCountX,
+    uint32_t workgroupCountY,
+    uint32_t workgroupCountZ)
+{
+    flecs_engine_null_gpu_command_t *cmd = flecsEngine_nullGpu_recordPass(
+        computePassEncoder, FlecsNullGpuCmdDispatch);
+    cmd->count = workgroupCountX * workgroupCountY * workgroupCountZ;
+}
+
+static void flecsEngine_nullGpu_ComputePassEncoderEnd(
+    WGPUComputePassEncoder computePassEncoder)
+{
+    flecsEngine_nullGpu_recordPass(
+        computePassEncoder, FlecsNullGpuCmdEndPass);
+}
+
+static void flecsEngine_nullGpu_ComputePassEncoderRelease(
+    WGPUComputePassEncoder computePassEncoder)
+{
+    flecsEngine_nullGpu_release(computePassEncoder);
+}
+
+/* ---- Other objects ---- */
+
+static void flecsEngine_nullGpu_RenderPipelineRelease(
+    WGPURenderPipeline renderPipeline)
+{
+    flecsEngine_nullGpu_release(renderPipeline);
+}
+
+static void flecsEngine_nullGpu_ComputePipelineRelease(
+    WGPUComputePipeline computePipeline)
+{
+    flecsEngine_nullGpu_release(computePipeline);
+}
+
+static void flecsEngine_nullGpu_PipelineLayoutRelease(
+    WGPUPipelineLayout pipelineLayout)
+{
+    flecsEngine_nullGpu_release(pipelineLayout);
+}
+
+static void flecsEngine_nullGpu_BindGroupRelease(
+    WGPUBindGroup bindGroup)
+{
+    flecsEngine_nullGpu_release(bindGroup);
+}
+
+static void flecsEngine_nullGpu_BindGroupLayoutRelease(
+    WGPUBindGroupLayout bindGroupLayout)
+{
+    flecsEngine_nullGpu_release(bindGroupLayout);
+}
+
+static void flecsEngine_nullGpu_SamplerRelease(
+    WGPUSampler sampler)
+{
+    flecsEngine_nullGpu_release(sampler);
+}
+
+static void flecsEngine_nullGpu_ShaderModuleRelease(
+    WGPUShaderModule shaderModule)
+{
+    flecsEngine_nullGpu_release(shaderModule);
+}
+
+static void flecsEngine_nullGpu_QuerySetRelease(
+    WGPUQuerySet querySet)
+{
+    flecsEngine_nullGpu_release(querySet);
+}
+
+#define FLECS_ENGINE_WGPU_PROC_NULL(ret, name, params) \
+    .name = flecsEngine_nullGpu_##name,
+
+const flecs_engine_wgpu_procs_t flecsEngineNullGpuProcs = {
+    FLECS_ENGINE_WGPU_PROCS(FLECS_ENGINE_WGPU_PROC_NULL)
+};
+
+#undef FLECS_ENGINE_WGPU_PROC_NULL
+
+bool flecsEngine_nullGpu_takeCounters(
+    WGPUInstance instance,
+    flecs_engine_gpu_command_counters_t *counters)
+{
+    if (!instance || flecsEngine_gpuBackend_get() != FlecsGpuBackendNull) {
+        return false;
+    }
+
+    flecs_engine_null_gpu_instance_t *ptr =
+        (flecs_engine_null_gpu_instance_t*)instance;
+    ecs_os_mutex_lock(ptr->lock);
+    *counters = ptr->counters;
+    ecs_os_zeromem(&ptr->counters);
+    ecs_os_mutex_unlock(ptr->lock);
+    return true;
+}
+
+#endif
@@ -137,12 +137,14 @@ static void flecsEngine_onRequestDevice(
 
 WGPUAdapter flecsEngine_requestAdapter(
     WGPUInstance instance,
-    WGPUSurface surface)
+    WGPUSurface surface,
+    bool force_fallback)
 {
     WGPUAdapter adapter = NULL;
 
     WGPURequestAdapterOptions options = {
-        .compatibleSurface = surface
+        .compatibleSurface = surface,
+        .forceFallbackAdapter = force_fallback
     };
 
 #ifdef __EMSCRIPTEN__
@@ -184,12 +186,27 @@ WGPUDevice flecsEngine_requestDevice(
     WGPUDevice device = NULL;
 
 #ifndef __EMSCRIPTEN__
-    WGPUFeatureName required_features[] = {
+    WGPUFeatureName required_features[3] = {
         WGPUFeatureName_TextureCompressionBC
     };
+    size_t feature_count = 1;
+
+    /* Optional, effect targets fall back to RGBA16Float without it */
+    if (wgpuAdapterHasFeature(adapter,
+        WGPUFeatureName_RG11B10UfloatRenderable))
+    {
+        required_features[feature_count ++] =
+            WGPUFeatureName_RG11B10UfloatRenderable;
+    }
+
+    /* Optional, GPU timing is disabled without it */
+    if (wgpuAdapterHasFeature(adapter, WGPUFeatureName_TimestampQuery)) {
+        required_features[feature_count ++] = WGPUFeatureName_TimestampQuery;
+    }
+
     WGPUDeviceDescriptor desc = {
         .requiredFeatures = required_features,
-        .requiredFeatureCount = 1
+        .requiredFeatureCount = feature_count
     };
 #else
     WGPUDeviceDescriptor desc = {0};
@@ -229,6 +246,71 @@ WGPUDevice flecsEngine_requestDevice(
     return device;
 }
 
+const char* flecsEngine_describeAdapter(
+    WGPUAdapter adapter,
+    char *name_out,
+    size_t name_size)
+{
+    ecs_os_strncpy(name_out, "unknown", (ecs_size_t)name_size);
+    name_out[name_size - 1] = '\0';
+
+#ifdef __EMSCRIPTEN__
+    (void)adapter;
+    return "unknown";
+#else
+    WGPUAdapterInfo info = {0};
+    if (wgpuAdapterGetInfo(adapter, &info) != WGPUStatus_Success) {
+        return "unknown";
+    }
+
+    if (info.device.data && info.device.length) {
+        size_t length = info.device.length;
+        if (length == WGPU_STRLEN) {
+            length = strlen(info.device.data);
+        }
+        if (length >= name_size) {
+            length = name_size - 1;
+        }
+        memcpy(name_out, info.device.data, length);
+        name_out[length] = '\0';
+    }
+
+    const char *type;
+    switch (info.adapterType) {
+    case WGPUAdapterType_DiscreteGPU: type = "discrete"; break;
+    case WGPUAdapterType_IntegratedGPU: type = "integrated"; break;
+    case WGPUAdapterType_CPU: type = "cpu"; break;
+    default: type = "unknown"; break;
+    }
+
+    wgpuAdapterInfoFreeMembers(info);
+    return type;
+#endif
+}
+
+bool flecsEngine_canRenderRG11B10(
+    WGPUDevice device)
+{
+#ifdef __EMSCRIPTEN__
+    (void)device;
+    return false;
+#else
+    return wgpuDeviceHasFeature(device,
+        WGPUFeatureName_RG11B10UfloatRenderable);
+#endif
+}
+
+bool flecsEngine_hasTimestampQuery(
+    WGPUDevice device)
+{
+#ifdef __EMSCRIPTEN__
+    (void)device;
+    return false;
+#else
+    return wgpuDeviceHasFeature(device, WGPUFeatureName_TimestampQuery);
+#endif
+}
+
 void flecsEngine_setDeviceErrorCallback(
     WGPUDevice device)
 {
@@ -256,6 +338,63 @@ void flecsEngine_processEventsUntilDone(
     (void)instance;
 }
 
+void flecsEngine_processEvents(
+    WGPUInstance instance)
+{
+#ifdef __EMSCRIPTEN__
+    (void)instance;
+#else
+    wgpuInstanceProcessEvents(instance);
+#endif
+}
+
+#ifdef __EMSCRIPTEN__
+
+static void flecsEngine_onQueueWorkDone(
+    WGPUQueueWorkDoneStatus status,
+    void *userdata)
+{
+    (void)status;
+    *(bool*)userdata = true;
+}
+
+void flecsEngine_queueOnWorkDone(
+    WGPUQueue queue,
+    bool *done)
+{
+    wgpuQueueOnSubmittedWorkDone(queue, flecsEngine_onQueueWorkDone, done);
+}
+
+#else /* native */
+
+static void flecsEngine_onQueueWorkDone(
+    WGPUQueueWorkDoneStatus status,
+    WGPUStringView message,
+    void *userdata1,
+    void *userdata2)
+{
+    (void)status;
+    (void)message;
+    (void)userdata2;
+    *(bool*)userdata1 = true;
+}
+
+void flecsEngine_queueOnWorkDone(
+    WGPUQueue queue,
+    bool *done)
+{
+    WGPUQueueWorkDoneCallbackInfo info = {
+        .mode = WGPUCallbackMode_AllowProcessEvents,
+        .callback = flecsEngine_onQueueWorkDone,
+        .userdata1 = done,
+        .userdata2 = NULL
+    };
+
+    wgpuQueueOnSubmittedWorkDone(queue, info);
+}
+
+#endif /* __EMSCRIPTEN__ */
+
 #ifdef __EMSCRIPTEN__
 
 typedef struct {
@@ -540,6 +679,16 @@ void flecsEngine_presentSurface(
 #endif
 }
 
+void flecsEngine_bufferAddRef(
+    WGPUBuffer buffer)
+{
+#ifdef __EMSCRIPTEN__
+    wgpuBufferReference(buffer);
+#else
+    wgpuBufferAddRef(buffer);
+#endif
+}
+
 void flecsEngine_releaseSwapChain(void)
 {
 #ifdef __EMSCRIPTEN__
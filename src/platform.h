@@ -9,11 +9,13 @@
 
 /* ---- GPU initialisation ---- */
 
-/* Request an adapter, blocking until the request completes.
+/* Request an adapter, blocking until the request completes. With
+   force_fallback a software adapter is requested.
    Returns NULL on failure. */
 WGPUAdapter flecsEngine_requestAdapter(
     WGPUInstance instance,
-    WGPUSurface surface);
+    WGPUSurface surface,
+    bool force_fallback);
 
 /* Request a device, blocking until the request completes.
    Returns NULL on failure. */
@@ -21,6 +23,21 @@ WGPUDevice flecsEngine_requestDevice(
     WGPUAdapter adapter,
     WGPUInstance instance);
 
+/* Write the name of an adapter to name_out, and return its type: "discrete",
+   "integrated", "cpu" or "unknown". */
+const char* flecsEngine_describeAdapter(
+    WGPUAdapter adapter,
+    char *name_out,
+    size_t name_size);
+
+/* True if the device can use RG11B10Ufloat textures as render attachments. */
+bool flecsEngine_canRenderRG11B10(
+    WGPUDevice device);
+
+/* True if the device can write timestamp queries in passes. */
+bool flecsEngine_hasTimestampQuery(
+    WGPUDevice device);
+
 /* Install an uncaptured-error callback on the device.
    On native wgpu this is a no-op (errors surface through validation). */
 void flecsEngine_setDeviceErrorCallback(
@@ -34,6 +51,17 @@ void flecsEngine_processEventsUntilDone(
     WGPUInstance instance,
     bool *done);
 
+/* Pump the event mechanism once without blocking.  No-op on WASM, where
+   callbacks run from the browser event loop. */
+void flecsEngine_processEvents(
+    WGPUInstance instance);
+
+/* Set *done to true once the work submitted to the queue so far has
+   finished executing on the GPU. */
+void flecsEngine_queueOnWorkDone(
+    WGPUQueue queue,
+    bool *done);
+
 /* Platform-agnostic buffer-map callback signature. */
 typedef void (*FlecsCompatBufferMapCallback)(
     WGPUMapAsyncStatus status,
@@ -51,6 +79,10 @@ void flecsEngine_bufferMapAsync(
     FlecsCompatBufferMapCallback callback,
     void *userdata);
 
+/* Increment the reference count of a buffer. */
+void flecsEngine_bufferAddRef(
+    WGPUBuffer buffer);
+
 /* ---- Surface / swap-chain ---- */
 
 /* Create a WGPUSurface from a GLFW window.
@@ -4,5 +4,7 @@
 #include "types.h"
 #include "utils.h"
 #include "platform.h"
+#include "trace.h"
+#include "benchmark.h"
 
 #endif
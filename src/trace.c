@@ -0,0 +1,296 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "private.h"
+
+ECS_COMPONENT_DECLARE(FlecsTrace);
+
+#define FLECS_ENGINE_TRACE_CAPACITY_DEFAULT (65536)
+#define FLECS_ENGINE_TRACE_DETAIL_SIZE (64)
+
+/* Threads that get their own track in the trace viewer */
+#define FLECS_ENGINE_TRACE_THREAD_MAX (32)
+
+typedef struct {
+    const char *category;
+    const char *name;
+    uint64_t start;
+    uint64_t end;
+    uint64_t thread;
+    char detail[FLECS_ENGINE_TRACE_DETAIL_SIZE];
+} flecs_engine_trace_event_t;
+
+typedef struct {
+    flecs_engine_trace_event_t *events;
+    int32_t capacity;
+    int64_t written;  /* Events recorded since start, incremented atomically */
+    int32_t writers;  /* Threads recording an event, incremented atomically */
+    int32_t enabled;  /* Nonzero while recording, changed atomically */
+    uint64_t origin;  /* Time that the trace started */
+} flecs_engine_trace_t;
+
+static flecs_engine_trace_t flecs_engine_trace;
+
+void flecsEngine_trace_start(
+    int32_t capacity)
+{
+    flecsEngine_trace_stop();
+
+    if (capacity <= 0) {
+        capacity = FLECS_ENGINE_TRACE_CAPACITY_DEFAULT;
+    }
+
+    flecs_engine_trace.events = ecs_os_calloc_n(
+        flecs_engine_trace_event_t, capacity);
+    flecs_engine_trace.capacity = capacity;
+    flecs_engine_trace.written = 0;
+    flecs_engine_trace.origin = ecs_os_now();
+
+    /* Publishes the buffer to threads that check enabled */
+    ecs_os_ainc(&flecs_engine_trace.enabled);
+}
+
+/* Wait for threads that are still recording an event. Writers that register
+ * after the increment see that tracing is disabled, since the increment is a
+ * full barrier. */
+static void flecsEngine_trace_drain(void)
+{
+    while (ecs_os_ainc(&flecs_engine_trace.writers) > 1) {
+        ecs_os_adec(&flecs_engine_trace.writers);
+        ecs_os_sleep(0, 1000);
+    }
+    ecs_os_adec(&flecs_engine_trace.writers);
+}
+
+/* Tracing is started and stopped from a single thread, other threads only
+ * check whether it is enabled. */
+void flecsEngine_trace_stop(void)
+{
+    if (flecs_engine_trace.enabled) {
+        ecs_os_adec(&flecs_engine_trace.enabled);
+    }
+    flecsEngine_trace_drain();
+
+    ecs_os_free(flecs_engine_trace.events);
+    flecs_engine_trace.events = NULL;
+    flecs_engine_trace.capacity = 0;
+    flecs_engine_trace.written = 0;
+}
+
+bool flecsEngine_trace_enabled(void)
+{
+    return flecs_engine_trace.enabled != 0;
+}
+
+uint64_t flecsEngine_trace_begin(void)
+{
+    if (!flecs_engine_trace.enabled) {
+        return 0;
+    }
+
+    return ecs_os_now();
+}
+
+void flecsEngine_trace_complete(
+    uint64_t start,
+    uint64_t end,
+    const char *category,
+    const char *name,
+    const char *detail)
+{
+    if (!start || !flecs_engine_trace.enabled) {
+        return;
+    }
+
+    /* Registered as writer before checking enabled again, so that stop
+     * doesn't free the buffer while the event is written. */
+    ecs_os_ainc(&flecs_engine_trace.writers);
+    if (!flecs_engine_trace.enabled) {
+        ecs_os_adec(&flecs_engine_trace.writers);
+        return;
+    }
+
+    /* Events can be recorded from worker threads, slots are claimed with an
+     * atomic increment. Once the buffer is full the oldest events are
+     * overwritten. The counter is 64 bit so that it doesn't wrap. */
+    int64_t index = ecs_os_lainc(&flecs_engine_trace.written) - 1;
+    flecs_engine_trace_event_t *event = &flecs_engine_trace.events[
+        (uint64_t)index % (uint64_t)flecs_engine_trace.capacity];
+
+    event->category = category;
+    event->name = name;
+    event->start = start;
+    event->end = end;
+    event->thread = ecs_os_api.thread_self_
+        ? (uint64_t)ecs_os_thread_self()
+        : 0;
+
+    if (detail) {
+        ecs_os_strncpy(event->detail, detail, FLECS_ENGINE_TRACE_DETAIL_SIZE);
+        event->detail[FLECS_ENGINE_TRACE_DETAIL_SIZE - 1] = '\0';
+    } else {
+        event->detail[0] = '\0';
+    }
+
+    ecs_os_adec(&flecs_engine_trace.writers);
+}
+
+void flecsEngine_trace_end(
+    uint64_t start,
+    const char *category,
+    const char *name,
+    const char *detail)
+{
+    if (!start) {
+        return;
+    }
+
+    flecsEngine_trace_complete(start, ecs_os_now(), category, name, detail);
+}
+
+/* Chrome trace thread ids are small numbers, OS thread ids can be pointers */
+static int32_t flecsEngine_trace_threadIndex(
+    uint64_t *threads,
+    int32_t *thread_count,
+    uint64_t thread)
+{
+    for (int32_t i = 0; i < *thread_count; i ++) {
+        if (threads[i] == thread) {
+            return i;
+        }
+    }
+
+    if (*thread_count == FLECS_ENGINE_TRACE_THREAD_MAX) {
+        return FLECS_ENGINE_TRACE_THREAD_MAX;
+    }
+
+    threads[*thread_count] = thread;
+    return (*thread_count) ++;
+}
+
+int flecsEngine_trace_dump(
+    const char *path)
+{
+    if (!flecs_engine_trace.enabled) {
+        ecs_err("trace: tracing is not enabled");
+        return -1;
+    }
+
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        ecs_err("trace: failed to open '%s'", path);
+        return -1;
+    }
+
+    int64_t written = flecs_engine_trace.written;
+    int32_t capacity = flecs_engine_trace.capacity;
+    int32_t count = written < capacity ? (int32_t)written : capacity;
+    int64_t first = written - count;
+
+    uint64_t threads[FLECS_ENGINE_TRACE_THREAD_MAX];
+    int32_t thread_count = 0;
+    int32_t written_count = 0; /* Events in the file, skipped ones excluded */
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for (int32_t i = 0; i < count; i ++) {
+        const flecs_engine_trace_event_t *event = &flecs_engine_trace.events[
+            (uint64_t)(first + i) % (uint64_t)capacity];
+
+        /* Events that started before the trace was restarted */
+        if (event->start < flecs_engine_trace.origin) {
+            continue;
+        }
+
+        double ts = (double)(event->start - flecs_engine_trace.origin) / 1000.0;
+        double dur = event->end > event->start
+            ? (double)(event->end - event->start) / 1000.0
+            : 0.0;
+        int32_t tid = flecsEngine_trace_threadIndex(
+            threads, &thread_count, event->thread);
+
+        fprintf(file, "%s\n{\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+            "\"ts\":%.3f,\"dur\":%.3f,\"cat\":",
+            written_count ? "," : "", tid, ts, dur);
+        flecsEngine_writeJsonString(file, event->category);
+        fprintf(file, ",\"name\":");
+        flecsEngine_writeJsonString(file, event->name);
+        if (event->detail[0]) {
+            fprintf(file, ",\"args\":{\"detail\":");
+            flecsEngine_writeJsonString(file, event->detail);
+            fputc('}', file);
+        }
+        fputc('}', file);
+        written_count ++;
+    }
+
+    fprintf(file, "\n]}\n");
+
+    bool ok = !ferror(file);
+    if (fclose(file) || !ok) {
+        ecs_err("trace: failed to write '%s'", path);
+        return -1;
+    }
+
+    ecs_trace("trace: wrote %d events to '%s'", written_count, path);
+    return 0;
+}
+
+static void flecsEngine_trace_onSet(
+    ecs_iter_t *it)
+{
+    FlecsTrace *trace = ecs_field(it, FlecsTrace, 0);
+    for (int32_t i = 0; i < it->count; i ++) {
+        if (trace[i].enabled && !flecs_engine_trace.enabled) {
+            flecsEngine_trace_start(trace[i].capacity);
+        } else if (!trace[i].enabled && flecs_engine_trace.enabled) {
+            flecsEngine_trace_stop();
+        }
+
+        if (trace[i].dump) {
+            if (trace[i].path) {
+                flecsEngine_trace_dump(trace[i].path);
+            } else {
+                ecs_err("trace: dump requested without a path");
+            }
+            trace[i].dump = false;
+        }
+    }
+}
+
+/* Write the trace when the component is removed, which includes world
+ * teardown, so that runs that quit by themselves leave a trace behind. */
+static void flecsEngine_trace_onRemove(
+    ecs_iter_t *it)
+{
+    FlecsTrace *trace = ecs_field(it, FlecsTrace, 0);
+    for (int32_t i = 0; i < it->count; i ++) {
+        if (flecs_engine_trace.enabled && trace[i].path) {
+            flecsEngine_trace_dump(trace[i].path);
+        }
+        flecsEngine_trace_stop();
+    }
+}
+
+void flecsEngine_trace_register(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, FlecsTrace);
+
+    ecs_struct(world, {
+        .entity = ecs_id(FlecsTrace),
+        .members = {
+            { .name = "enabled", .type = ecs_id(ecs_bool_t) },
+            { .name = "capacity", .type = ecs_id(ecs_i32_t) },
+            { .name = "path", .type = ecs_id(ecs_string_t) },
+            { .name = "dump", .type = ecs_id(ecs_bool_t) }
+        }
+    });
+
+    ecs_set_hooks(world, FlecsTrace, {
+        .on_set = flecsEngine_trace_onSet,
+        .on_remove = flecsEngine_trace_onRemove
+    });
+
+    ecs_add_id(world, ecs_id(FlecsTrace), EcsSingleton);
+}
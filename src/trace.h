@@ -0,0 +1,45 @@
+/* Trace of engine events, written as Chrome Trace Event JSON.
+ *
+ * Events are recorded into a process wide ring buffer, so that code without
+ * access to the engine (asset loaders) can record events too.
+ */
+
+#ifndef FLECS_ENGINE_TRACE_IMPL
+#define FLECS_ENGINE_TRACE_IMPL
+
+#include "types.h"
+
+/* Start recording into a ring buffer of capacity events. Events recorded
+ * earlier are dropped. */
+void flecsEngine_trace_start(
+    int32_t capacity);
+
+/* Stop recording and free the ring buffer. Waits for threads that are
+ * recording an event. */
+void flecsEngine_trace_stop(void);
+
+bool flecsEngine_trace_enabled(void);
+
+/* Start time of an event, 0 if tracing is disabled. */
+uint64_t flecsEngine_trace_begin(void);
+
+/* Record an event that started at start. Category and name must be static
+ * strings, detail is copied and may be NULL. No-op if start is 0. */
+void flecsEngine_trace_end(
+    uint64_t start,
+    const char *category,
+    const char *name,
+    const char *detail);
+
+/* Record an event with a known start and end time. */
+void flecsEngine_trace_complete(
+    uint64_t start,
+    uint64_t end,
+    const char *category,
+    const char *name,
+    const char *detail);
+
+void flecsEngine_trace_register(
+    ecs_world_t *world);
+
+#endif
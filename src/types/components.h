@@ -50,14 +50,46 @@ typedef struct {
 
 extern ECS_COMPONENT_DECLARE(FlecsShaderImpl);
 
+/* Resolved entry of the flattened batch set tree of a view */
 typedef struct {
-    WGPUTexture *effect_target_textures;
+    ecs_entity_t entity;
+    ecs_ref_t batch;
+    ecs_ref_t impl;
+    bool is_skybox;
+    bool is_ground_plane;
+} flecs_engine_render_item_t;
+
+/* Scene bind groups of the view that is being rendered, resolved once per
+ * pass. Batches light with ibl, which is a black environment if the view has
+ * no ambient light. The skybox and ground plane always use environment. */
+typedef struct {
+    FlecsHdriImpl *ibl;
+    FlecsHdriImpl *environment;
+} flecs_engine_view_ibl_t;
+
+typedef struct {
+    /* Transient textures, shared by targets that aren't used at once */
+    WGPUTexture *transient_textures;
+    WGPUTextureView *transient_views;
+    WGPUTextureFormat *transient_formats;
+    int32_t transient_count;
+    int64_t transient_bytes;
+    /* Target k is the output of effect k - 1, target 0 the batch output.
+     * Views point into the transient textures, NULL if the target isn't
+     * written this frame. */
     WGPUTextureView *effect_target_views;
     int32_t effect_target_count;
     uint32_t effect_target_width;
     uint32_t effect_target_height;
-    WGPUTextureFormat effect_target_format;
-    WGPUBindGroup passthrough_bind_group;
+    WGPUTextureFormat effect_target_format; /* Format of the batch output */
+    flecs_engine_render_graph_t graph;
+    ecs_vec_t fused_effects; /* vec<flecs_engine_fused_effect_t> */
+    flecs_engine_bind_group_cache_t passthrough_bind_groups;
+    flecs_engine_bind_group_cache_t upscale_bind_groups;
+    ecs_vec_t render_list; /* vec<flecs_engine_render_item_t> */
+    uint32_t render_list_version;
+    flecs_engine_frustum_t frustum;
+    flecs_engine_render_counters_t counters; /* Of the last rendered frame */
 } FlecsRenderViewImpl;
 
 extern ECS_COMPONENT_DECLARE(FlecsRenderViewImpl);
@@ -70,21 +102,32 @@ typedef struct {
     WGPURenderPipeline pipeline_shadow;
     WGPUBuffer uniform_buffers[FLECS_ENGINE_UNIFORMS_MAX];
     uint64_t material_buffer_size;
+    uint32_t bind_version;
     uint8_t uniform_count;
+    bool uses_view_uniforms;
     bool uses_material;
     bool uses_ibl;
     bool uses_shadow;
     bool uses_cluster;
     bool uses_textures;
+    uint32_t feature_mask; /* Scene features the shader can compile out */
+    uint32_t features;     /* Scene features the pipelines were built with */
 } FlecsRenderBatchImpl;
 
 extern ECS_COMPONENT_DECLARE(FlecsRenderBatchImpl);
 
+/* Packed effect target formats (RG11B10Ufloat, RGBA8UnormSrgb) */
+#define FLECS_ENGINE_EFFECT_PACKED_FORMAT_COUNT (2)
+
 typedef struct {
     WGPUBindGroupLayout bind_layout;
     WGPURenderPipeline pipeline_surface;
     WGPURenderPipeline pipeline_hdr;
+    /* Pipelines for packed target formats, created on first use */
+    WGPURenderPipeline pipeline_packed[FLECS_ENGINE_EFFECT_PACKED_FORMAT_COUNT];
+    WGPUTextureFormat packed_formats[FLECS_ENGINE_EFFECT_PACKED_FORMAT_COUNT];
     WGPUSampler input_sampler;
+    flecs_engine_bind_group_cache_t bind_groups;
 } FlecsRenderEffectImpl;
 
 extern ECS_COMPONENT_DECLARE(FlecsRenderEffectImpl);
@@ -104,10 +147,57 @@ typedef struct {
     WGPUBindGroupLayout blur_bind_layout;
     WGPURenderPipeline blur_pipeline_surface;
     WGPURenderPipeline blur_pipeline_hdr;
+    flecs_engine_bind_group_cache_t blur_bind_groups;
+    /* Reduced resolution and temporal AO, created on first use */
+    WGPUBindGroupLayout depth_bind_layout;
+    WGPUBindGroupLayout low_res_bind_layout;
+    WGPUBindGroupLayout temporal_bind_layout;
+    WGPURenderPipeline depth_pipeline;
+    WGPURenderPipeline low_res_pipeline;
+    WGPURenderPipeline temporal_pipeline;
+    WGPUSampler history_sampler;
+    flecs_engine_bind_group_cache_t depth_bind_groups;
+    WGPUTexture low_depth_texture;      /* Downsampled depth */
+    WGPUTextureView low_depth_view;
+    WGPUTexture ao_texture;             /* AO of this frame */
+    WGPUTextureView ao_view;
+    WGPUTexture history_textures[2];    /* Accumulated AO, linear depth */
+    WGPUTextureView history_views[2];
+    WGPUBindGroup low_res_bind_group;
+    WGPUBindGroup temporal_bind_groups[2]; /* Read history i */
+    uint32_t low_width;
+    uint32_t low_height;
+    uint32_t history_region[2];         /* AO region of the last frame */
+    int32_t history_index;              /* History written by the last frame */
+    uint32_t frame_index;               /* Rotates the kernel samples */
+    bool history_valid;
+    bool low_res_failed;
 } FlecsSSAOImpl;
 
 extern ECS_COMPONENT_DECLARE(FlecsSSAOImpl);
 
+typedef struct {
+    WGPUBuffer uniform_buffer;
+} FlecsFXAAImpl;
+
+extern ECS_COMPONENT_DECLARE(FlecsFXAAImpl);
+
+typedef struct {
+    WGPUBuffer uniform_buffer;
+    WGPURenderPipeline pipeline_surface;
+    WGPURenderPipeline pipeline_hdr;
+    WGPUTexture history_textures[2];
+    WGPUTextureView history_views[2];
+    uint32_t history_width;
+    uint32_t history_height;
+    int32_t history_index;       /* History written by the last frame */
+    uint32_t history_region[2];  /* Region written by the last frame */
+    bool history_valid;
+    bool history_output;         /* History is at output resolution */
+} FlecsTAAImpl;
+
+extern ECS_COMPONENT_DECLARE(FlecsTAAImpl);
+
 typedef struct {
     WGPUTexture tony_lut_texture;
     WGPUTextureView tony_lut_texture_view;
@@ -127,10 +217,27 @@ typedef struct {
     WGPUBuffer uniform_buffer;
     WGPUTexture texture;
     WGPUTextureView *mip_views;
+    WGPUBindGroup *mip_bind_groups; /* Bind groups that sample mip_views[i] */
+    flecs_engine_bind_group_cache_t input_bind_groups;
     uint32_t mip_count;
     uint32_t texture_width;
     uint32_t texture_height;
     WGPUTextureFormat texture_format;
+    /* Compute path, created on first use */
+    WGPUBindGroupLayout compute_bind_layout;
+    WGPUComputePipeline compute_downsample_pipeline;
+    WGPUComputePipeline compute_upsample_pipeline;
+    WGPUBuffer compute_params_buffer; /* One FlecsBloomDispatchUniform per dispatch */
+    WGPUTexture upsample_texture;     /* Upsampled mips, mip_count - 1 levels */
+    WGPUTextureView *upsample_views;
+    WGPUBindGroup upsample_bind_group; /* Samples upsample_views[0] */
+    WGPUTexture dummy_storage_texture; /* Bound to unused storage outputs */
+    WGPUTextureView dummy_storage_view;
+    WGPUBindGroup *compute_bind_groups; /* Per dispatch, NULL if it reads the input */
+    flecs_engine_bind_group_cache_t compute_input_bind_groups;
+    uint32_t compute_dispatch_count;
+    bool texture_compute;     /* Texture was created for the compute path */
+    bool compute_unsupported; /* Compute pipelines failed to create */
 } FlecsBloomImpl;
 
 extern ECS_COMPONENT_DECLARE(FlecsBloomImpl);
@@ -140,6 +247,12 @@ typedef struct {
     mat4 view;
     mat4 proj;
     mat4 mvp;
+    mat4 unjittered_mvp;  /* mvp without the jitter */
+    mat4 prev_mvp;        /* unjittered_mvp of the previous frame */
+    float jitter[2];      /* Offset of the projection in NDC */
+    uint32_t jitter_index;
+    bool jitter_requested; /* Set by views that resolve the jitter */
+    bool has_prev_mvp;
 } FlecsCameraImpl;
 
 extern ECS_COMPONENT_DECLARE(FlecsCameraImpl);
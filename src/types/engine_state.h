@@ -7,6 +7,16 @@
 
 #define FLECS_ENGINE_UNIFORMS_MAX (8)
 #define FLECS_ENGINE_INSTANCE_TYPES_MAX (8)
+#define FLECS_ENGINE_BIND_GROUP_ENTRIES_MAX (8)
+#define FLECS_ENGINE_BIND_GROUP_CACHE_SIZE (4)
+
+/* Features that batch shaders are compiled with. Batches use shader variants
+ * without the features that no view or light in the scene needs. */
+#define FLECS_ENGINE_BATCH_FEATURE_SHADOWS (1u << 0)
+#define FLECS_ENGINE_BATCH_FEATURE_CLUSTER_LIGHTS (1u << 1)
+#define FLECS_ENGINE_BATCH_FEATURES_ALL \
+    (FLECS_ENGINE_BATCH_FEATURE_SHADOWS | \
+     FLECS_ENGINE_BATCH_FEATURE_CLUSTER_LIGHTS)
 
 struct FlecsEngineSurfaceInterface;
 
@@ -17,14 +27,16 @@ typedef struct {
     uint32_t map_size;
     uint32_t cascade_sizes[FLECS_ENGINE_SHADOW_CASCADE_COUNT];
     WGPUShaderModule shader_module;
-    WGPUBuffer vp_buffers[FLECS_ENGINE_SHADOW_CASCADE_COUNT];
+    /* One light VP block per (view, cascade), selected with a dynamic offset */
+    WGPUBuffer vp_buffer;
+    uint32_t vp_stride;
+    uint32_t vp_offset; /* Offset of cascade 0 for the current view */
     WGPUBindGroupLayout pass_bind_layout;
-    WGPUBindGroup pass_bind_groups[FLECS_ENGINE_SHADOW_CASCADE_COUNT];
-    int current_cascade;
+    WGPUBindGroup pass_bind_group;
     WGPUSampler sampler;
     mat4 current_light_vp[FLECS_ENGINE_SHADOW_CASCADE_COUNT];
     float cascade_splits[FLECS_ENGINE_SHADOW_CASCADE_COUNT];
-    bool in_pass;
+    ecs_vec_t casters; /* vec<flecs_engine_shadow_caster_t> of current view */
 } flecs_engine_shadow_t;
 
 typedef struct {
@@ -38,6 +50,12 @@ typedef struct {
     WGPUBuffer cluster_info_buffer;
     WGPUBuffer cluster_grid_buffer;
     WGPUBuffer cluster_index_buffer;
+    /* Cluster buffers hold one region per view, selected by dynamic offset */
+    uint32_t cluster_info_stride;
+    uint32_t cluster_grid_stride;
+    uint32_t cluster_index_stride;
+    int32_t cluster_view_capacity;
+    uint32_t cluster_offsets[3]; /* Info, grid and index offset of current view */
     bool cluster_bind_group_dirty;
 
     ecs_query_t *point_light_query;
@@ -63,6 +81,65 @@ typedef struct {
     uint32_t last_id;
 } flecs_engine_materials_t;
 
+/* Bind group built from a set of entries. Entries are compared by handle, so
+ * slots also store the target version to catch handles that were released
+ * and reallocated at the same address. */
+typedef struct {
+    WGPUBindGroup bind_group;
+    WGPUBindGroupLayout layout;
+    WGPUBindGroupEntry entries[FLECS_ENGINE_BIND_GROUP_ENTRIES_MAX];
+    uint32_t entry_count;
+    uint32_t target_version;
+} flecs_engine_bind_group_slot_t;
+
+/* Small cache of bind groups for a single owner, e.g. an effect that may be
+ * rendered with the targets of more than one view. */
+typedef struct {
+    flecs_engine_bind_group_slot_t slots[FLECS_ENGINE_BIND_GROUP_CACHE_SIZE];
+    int32_t next;
+} flecs_engine_bind_group_cache_t;
+
+typedef struct {
+    uint32_t target_version; /* Bumped when bindable render targets are recreated */
+    int32_t create_count;    /* Bind groups created in the last frame */
+    int32_t reuse_count;     /* Cached bind groups reused in the last frame */
+    int64_t total_create_count;
+} flecs_engine_bind_groups_t;
+
+/* Group 0 of a fused effect pass binds the input, and each stage has its own
+ * group. This keeps fused passes within the default limit of 4 groups. */
+#define FLECS_ENGINE_EFFECT_FUSION_MAX (3)
+
+/* Pipeline that runs adjacent pointwise effects of a view as one pass */
+typedef struct {
+    ecs_entity_t effects[FLECS_ENGINE_EFFECT_FUSION_MAX];
+    WGPUBindGroupLayout layouts[FLECS_ENGINE_EFFECT_FUSION_MAX];
+    int32_t count;
+    WGPUTextureFormat format;
+    WGPURenderPipeline pipeline;
+} flecs_engine_fused_effect_t;
+
+/* Pass of a view, and the targets it reads and writes. Passes in a view chain
+ * read at most one target. */
+typedef struct {
+    int32_t read;  /* Target read by the pass, -1 if none */
+    int32_t write; /* Target written by the pass, -1 for the view texture */
+} flecs_engine_graph_pass_t;
+
+/* Passes of a view in execution order. Compiling the graph assigns targets
+ * with non-overlapping lifetimes and the same format to the same transient
+ * texture. */
+typedef struct {
+    ecs_vec_t passes;         /* vec<flecs_engine_graph_pass_t> */
+    ecs_vec_t target_formats; /* vec<WGPUTextureFormat> */
+    ecs_vec_t target_slots;   /* vec<int32_t>, texture of a target or -1 */
+    ecs_vec_t last_use;       /* vec<int32_t>, last pass that uses a target */
+    ecs_vec_t slot_use;       /* vec<int32_t>, last pass that uses a texture */
+    ecs_vec_t slot_formats;   /* vec<WGPUTextureFormat> */
+    int32_t target_count;
+    int32_t slot_count;
+} flecs_engine_render_graph_t;
+
 typedef struct {
     WGPUTexture depth_texture;
     WGPUTextureView depth_texture_view;
@@ -88,20 +165,153 @@ typedef struct {
      * texture so that post-process effects (SSAO, fog, …) can read it. */
     WGPURenderPipeline depth_resolve_pipeline;
     WGPUBindGroupLayout depth_resolve_bind_layout;
+    flecs_engine_bind_group_cache_t depth_resolve_bind_groups;
 } flecs_engine_depth_t;
 
+/* Spatial upscale from the render viewport to output resolution: an edge
+ * adaptive upsample (EASU) followed by a sharpening pass (RCAS). */
+typedef struct {
+    WGPURenderPipeline easu_pipeline;
+    WGPURenderPipeline rcas_pipeline;
+    WGPUBindGroupLayout bind_layout;
+    WGPUBuffer uniform_buffer;
+    float sharpness;
+
+    /* Output of EASU that is sharpened into the view texture */
+    WGPUTexture texture;
+    WGPUTextureView texture_view;
+    uint32_t texture_width;
+    uint32_t texture_height;
+    flecs_engine_bind_group_cache_t rcas_bind_groups;
+} flecs_engine_upscale_t;
+
+/* Culling state of a view, computed once per view per frame */
+typedef struct {
+    float planes[6][4];
+    float shadow_planes[6][4];
+    bool valid;
+    bool shadow_valid;
+} flecs_engine_frustum_t;
+
+/* Per-view FlecsUniform blocks, computed once per view per frame and selected
+ * by batches with a dynamic uniform offset. */
+typedef struct {
+    WGPUBuffer buffer;
+    uint32_t stride;
+    int32_t capacity;    /* Number of view slots in buffer */
+    int32_t slot;        /* Slot of the view that is being rendered */
+    uint32_t offset;     /* Dynamic offset of the current view block */
+    uint32_t version;    /* Bumped when buffers are recreated */
+    int32_t write_count; /* Uniform writes issued in the last frame */
+} flecs_engine_view_uniforms_t;
+
+#define FLECS_ENGINE_FRAMES_IN_FLIGHT_MAX (3)
+#define FLECS_ENGINE_FRAMES_IN_FLIGHT_DEFAULT (2)
+
+/* Signaled when the GPU is done with the work submitted for a frame slot.
+ * Heap allocated, since the queue callback outlives copies of the engine. */
+typedef struct {
+    bool done;
+} flecs_engine_frame_fence_t;
+
+/* Dynamic per-frame buffers have one copy per frame in flight. Before a slot
+ * is reused the CPU waits for the fence of the frame that last used it. */
+typedef struct {
+    flecs_engine_frame_fence_t *fences; /* One per frame slot */
+    int32_t count;            /* Frames in flight */
+    int32_t slot;             /* Slot of the frame that is being recorded */
+    int32_t wait_count;       /* Fence waits that stalled the last frame */
+    float wait_time;          /* Seconds stalled in the last frame */
+    int64_t frame_count;
+    int64_t total_wait_count;
+    double total_wait_time;
+} flecs_engine_frame_sync_t;
+
+typedef void (*flecs_engine_encode_callback_t)(
+    void *ctx);
+
+/* Pass that is recorded into its own command encoder, and that can therefore
+ * be encoded on a worker thread. */
+typedef struct {
+    flecs_engine_encode_callback_t callback;
+    void *ctx;
+} flecs_engine_encode_job_t;
+
+/* Worker threads for encoding jobs. Opaque and heap allocated, so that the
+ * engine struct can be copied while the workers reference the pool. */
+typedef struct flecs_engine_encode_pool_t flecs_engine_encode_pool_t;
+
+/* Thread that submits and presents frames while the next frame is simulated.
+ * Opaque and heap allocated, like the encode pool. */
+typedef struct flecs_engine_render_thread_t flecs_engine_render_thread_t;
+
+/* Timestamp queries and their readback buffers. Heap allocated, since buffer
+ * map callbacks outlive copies of the engine. */
+typedef struct flecs_engine_gpu_timer_t flecs_engine_gpu_timer_t;
+
+/* Stage timers with a window of samples, heap allocated so that copies of
+ * the engine stay small. */
+typedef struct flecs_engine_cpu_timer_t flecs_engine_cpu_timer_t;
+
+/* Work done while rendering a view. Shadow cascades count into their own
+ * counters, which are added to the view when the cascades are finished. */
+typedef struct {
+    int32_t draw_count;
+    int64_t instance_count;   /* Instances drawn in the main pass */
+    int64_t triangle_count;
+    int64_t cascade_instance_count[FLECS_ENGINE_SHADOW_CASCADE_COUNT];
+    int32_t pipeline_switch_count;
+    int32_t bind_group_switch_count;
+    int32_t buffer_create_count;
+    int32_t texture_create_count;
+    int32_t write_count;      /* Queue buffer writes */
+    int64_t write_bytes;
+    int32_t visible_instance_count;
+    int32_t culled_instance_count;
+} flecs_engine_render_counters_t;
+
+/* State of a render pass while it is encoded. Shadow cascades are encoded at
+ * the same time on worker threads, so each has its own state and they share
+ * a const engine. */
+typedef struct {
+    WGPURenderPipeline last_pipeline;
+    flecs_engine_render_counters_t *counters; /* NULL if not collected */
+    int32_t cascade;     /* Cascade rendered by a shadow pass */
+    bool shadow_pass;
+} flecs_engine_pass_state_t;
+
+/* Cached module. Sources with the same hash are chained, so that a hash
+ * collision can't return the module of a different source. */
+typedef struct flecs_engine_shader_module_t {
+    char *source;
+    WGPUShaderModule module;
+    struct flecs_engine_shader_module_t *next;
+} flecs_engine_shader_module_t;
+
+/* Shader modules keyed by a hash of their preprocessed WGSL source. The cache
+ * owns the modules, so users must not release modules obtained from it. */
+typedef struct {
+    ecs_map_t modules; /* map<hash, flecs_engine_shader_module_t*> */
+    int32_t module_count;
+    int32_t compile_count;
+    int32_t hit_count;
+} flecs_engine_shader_cache_t;
+
 typedef struct {
     GLFWwindow *window;
     int32_t width;
     int32_t height;
-    int32_t actual_width;
+    int32_t actual_width;  /* Size of view targets, width / resolution_scale */
     int32_t actual_height;
+    int32_t render_width;  /* Viewport that views render to, <= actual size */
+    int32_t render_height;
     int32_t resolution_scale;
     int32_t sample_count; /* 1 or 4 (derived from msaa bool) */
     bool vsync;
     const struct FlecsEngineSurfaceInterface *surface_impl;
     bool output_done;
-    const char *frame_output_path;
+    const char *frame_output_path;  /* NULL if no image is written */
+    int32_t frame_output_count;     /* Frames left, -1 renders until quit */
 
     WGPUInstance instance;
     WGPUSurface surface;
@@ -114,6 +324,7 @@ typedef struct {
 
     WGPUSurfaceConfiguration surface_config;
     WGPUTextureFormat hdr_color_format;
+    bool rg11b10_renderable;
 
     ecs_entity_t sky_background_hdri;
     ecs_entity_t black_hdri;
@@ -122,21 +333,51 @@ typedef struct {
     uint32_t scene_bind_version;
 
     ecs_query_t *view_query;
-    WGPURenderPipeline last_pipeline;
+    uint32_t render_list_version;
+    uint32_t batch_features; /* FLECS_ENGINE_BATCH_FEATURE_* */
     float camera_pos[3];
 
     flecs_engine_shadow_t shadow;
     flecs_engine_lighting_t lighting;
     flecs_engine_materials_t materials;
     flecs_engine_depth_t depth;
+    flecs_engine_shader_cache_t shader_cache;
+    flecs_engine_view_uniforms_t view_uniforms;
+    flecs_engine_bind_groups_t bind_groups;
 
     FlecsDefaultAttrCache *default_attr_cache;
 
-    /* Frustum culling state (computed once per frame during extract) */
-    float frustum_planes[6][4];
-    float shadow_frustum_planes[6][4];
-    bool frustum_valid;
-    bool shadow_frustum_valid;
+    /* Culling state of the view that is being extracted */
+    const flecs_engine_frustum_t *frustum;
+
+    /* Counters of the view that is being rendered, NULL outside of views */
+    flecs_engine_render_counters_t *counters;
+
+    /* Incremented for every rendered frame. Batch buffers use it to detect
+     * the first view that extracts into them in a frame. */
+    uint32_t frame_count;
+
+    /* Workers for encoding independent passes. NULL if passes are encoded
+     * on the main thread. */
+    flecs_engine_encode_pool_t *encode_pool;
+
+    /* Command buffers finished so far in the frame, submitted in order */
+    ecs_vec_t frame_commands; /* vec<WGPUCommandBuffer> */
+
+    /* Render thread, NULL if frames are submitted on the main thread */
+    flecs_engine_render_thread_t *render_thread;
+
+    flecs_engine_frame_sync_t frame_sync;
+
+    /* GPU timestamp queries, NULL if the device doesn't support them */
+    flecs_engine_gpu_timer_t *gpu_timer;
+
+    /* CPU stage timers */
+    flecs_engine_cpu_timer_t *cpu_timer;
+
+    FlecsDynamicResolutionState dynamic_resolution;
+    int64_t dynamic_resolution_gpu_frame; /* Next GPU timed frame to use */
+    flecs_engine_upscale_t upscale;
 } FlecsEngineImpl;
 
 extern ECS_COMPONENT_DECLARE(FlecsEngineImpl);
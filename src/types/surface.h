@@ -50,6 +50,10 @@ typedef struct FlecsEngineOutputDesc {
     int32_t resolution_scale;
     bool msaa;
     bool vsync;
+    bool render_thread;
+    int32_t frames_in_flight; /* 0 selects the default */
+    bool fallback_adapter;    /* Request a software adapter */
+    bool null_backend;        /* Use the null backend, offscreen only */
 } FlecsEngineOutputDesc;
 
 #endif
@@ -235,3 +235,21 @@ ecs_entity_t flecsEngine_vecU32(
         .type = ecs_id(ecs_u32_t)
     });
 }
+
+void flecsEngine_writeJsonString(
+    FILE *file,
+    const char *str)
+{
+    fputc('"', file);
+    for (const char *ch = str; *ch; ch ++) {
+        if (*ch == '"' || *ch == '\\') {
+            fputc('\\', file);
+            fputc(*ch, file);
+        } else if ((unsigned char)*ch < 0x20) {
+            fprintf(file, "\\u%04x", (unsigned char)*ch);
+        } else {
+            fputc(*ch, file);
+        }
+    }
+    fputc('"', file);
+}
@@ -1,6 +1,8 @@
 #ifndef FLECS_ENGINE_UTILS_H
 #define FLECS_ENGINE_UTILS_H
 
+#include <stdio.h>
+
 #include "types.h"
 
 void flecsEngine_registerVec3Type(
@@ -53,4 +55,10 @@ ecs_entity_t flecsEngine_vecVec2(
 ecs_entity_t flecsEngine_vecU32(
     ecs_world_t *world);
 
+/* Write str as a quoted JSON string, escaping quotes, backslashes and
+ * control characters. */
+void flecsEngine_writeJsonString(
+    FILE *file,
+    const char *str);
+
 #endif
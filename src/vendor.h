@@ -14,5 +14,6 @@
 
 #include <flecs.h>
 #include "wgpu_compat.h"
+#include "gpu_backend.h"
 
 #endif
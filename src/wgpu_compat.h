@@ -37,6 +37,9 @@ typedef WGPUBufferMapAsyncStatus WGPUMapAsyncStatus;
 #define WGPUMapAsyncStatus_Success WGPUBufferMapAsyncStatus_Success
 #define WGPUMapAsyncStatus_Unknown WGPUBufferMapAsyncStatus_Unknown
 
+/* Pass timestamp writes */
+typedef WGPURenderPassTimestampWrites WGPUPassTimestampWrites;
+
 /* ---- WGPUStringView compat ---- */
 
 /* wgpu-native v27 uses WGPUStringView for entryPoint / shader code.
@@ -0,0 +1,51 @@
+#include "test.h"
+
+#include <string.h>
+
+int32_t flecs_test_failures;
+
+typedef struct {
+    const char *name;
+    void (*fn)(void);
+} flecs_test_suite_t;
+
+static const flecs_test_suite_t flecs_test_suites[] = {
+    { "render_thread", flecsTest_renderThread },
+    { "dynamic_resolution", flecsTest_dynamicResolution },
+    { "shader_cache", flecsTest_shaderCache },
+    { "view_uniforms", flecsTest_viewUniforms },
+    { "bind_groups", flecsTest_bindGroups },
+    { "encode_pool", flecsTest_encodePool },
+    { "render_graph", flecsTest_renderGraph },
+    { "gpu_memory", flecsTest_gpuMemory },
+    { "render_stats", flecsTest_renderStats }
+};
+
+/* Usage: flecs_engine_test [suite]. Runs all suites without an argument. */
+int main(
+    int argc,
+    char *argv[])
+{
+    const char *filter = argc > 1 ? argv[1] : NULL;
+    int32_t i, count = ECS_COUNT_OF(flecs_test_suites), run = 0;
+
+    for (i = 0; i < count; i ++) {
+        const flecs_test_suite_t *suite = &flecs_test_suites[i];
+        if (filter && strcmp(filter, suite->name)) {
+            continue;
+        }
+
+        int32_t failures = flecs_test_failures;
+        suite->fn();
+        fprintf(stderr, "%-20s %s\n", suite->name,
+            failures == flecs_test_failures ? "ok" : "FAILED");
+        run ++;
+    }
+
+    if (!run) {
+        fprintf(stderr, "no test suite named '%s'\n", filter);
+        return 1;
+    }
+
+    return flecs_test_failures != 0;
+}
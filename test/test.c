@@ -0,0 +1,81 @@
+#include "test.h"
+
+ecs_world_t* flecsTest_initEngine(void)
+{
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsEngine);
+
+    ecs_entity_t output = ecs_entity(world, { .name = "output" });
+    ecs_set(world, output, FlecsFrameOutput, {
+        .width = 64,
+        .height = 64,
+        .frame_count = -1,
+        .null_backend = true
+    });
+
+    ecs_progress(world, 0);
+
+    if (!ecs_singleton_get(world, FlecsEngineImpl)) {
+        fprintf(stderr, "failed to initialize null GPU engine\n");
+        ecs_fini(world);
+        return NULL;
+    }
+
+    return world;
+}
+
+ecs_entity_t flecsTest_createView(
+    ecs_world_t *world,
+    const char *name,
+    bool shadows)
+{
+    ecs_entity_t view = ecs_entity(world, { .name = name });
+
+    ecs_entity_t camera = ecs_entity(world, {
+        .parent = view, .name = "camera" });
+    ecs_set(world, camera, FlecsCamera, {
+        .fov = glm_rad(60.0f),
+        .near_ = 0.2f,
+        .far_ = 1000.0f,
+        .aspect_ratio = 1.0f
+    });
+    ecs_set(world, camera, FlecsPosition3, {0, 20, -60});
+    ecs_set(world, camera, FlecsLookAt, {0, 0, 0});
+
+    FlecsRenderView desc = { .camera = camera };
+    if (shadows) {
+        desc.light = ecs_entity(world, { .parent = view, .name = "light" });
+        ecs_set(world, desc.light, FlecsPosition3, {1, 1, 1});
+        ecs_set(world, desc.light, FlecsDirectionalLight, {
+            .intensity = 2.0f });
+        ecs_set(world, desc.light, FlecsLookAt, {0, 0, 0});
+        desc.shadow.enabled = true;
+        desc.shadow.map_size = 256;
+        desc.shadow.max_range = 150.0f;
+    }
+
+    FlecsRenderBatchSet batch_set = {0};
+    ecs_vec_append_t(NULL, &batch_set.batches, ecs_entity_t)[0] =
+        flecsEngine_createBatchSet_geometry(world, view, "geometry");
+
+    ecs_set_ptr(world, view, FlecsRenderView, &desc);
+    ecs_set_ptr(world, view, FlecsRenderBatchSet, &batch_set);
+
+    return view;
+}
+
+void flecsTest_populate(
+    ecs_world_t *world,
+    int32_t size)
+{
+    for (int32_t x = 0; x < size; x ++) {
+        for (int32_t z = 0; z < size; z ++) {
+            ecs_entity_t e = ecs_new(world);
+            ecs_set(world, e, FlecsBox, {1, 1, 1});
+            ecs_set(world, e, FlecsPosition3, {
+                (float)(x * 3 - size), 0.5f, (float)(z * 3 - size) });
+            ecs_set(world, e, FlecsRgba, {
+                (uint8_t)(x * 40), (uint8_t)(z * 40), 128, 255 });
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef FLECS_ENGINE_TEST_H
+#define FLECS_ENGINE_TEST_H
+
+#include "flecs_engine.h"
+#include "modules/renderer/renderer.h"
+
+#include <stdio.h>
+
+/* Number of failed expectations, the test executable fails if nonzero */
+extern int32_t flecs_test_failures;
+
+#define flecsTest_expect(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: expected %s\n", \
+                __FILE__, __LINE__, #cond); \
+            flecs_test_failures ++; \
+        } \
+    } while (0)
+
+/* Create a world with an engine on the null GPU backend that renders to an
+ * offscreen target. Progresses a frame, so that the engine is initialized
+ * when this returns. */
+ecs_world_t* flecsTest_initEngine(void);
+
+/* Create a view named name with a camera and the geometry batches. Views
+ * with shadows get a directional light that casts them. */
+ecs_entity_t flecsTest_createView(
+    ecs_world_t *world,
+    const char *name,
+    bool shadows);
+
+/* Add a size x size grid of colored boxes around the origin */
+void flecsTest_populate(
+    ecs_world_t *world,
+    int32_t size);
+
+/* --- Suites --- */
+
+void flecsTest_renderThread(void);
+
+void flecsTest_dynamicResolution(void);
+
+void flecsTest_shaderCache(void);
+
+void flecsTest_viewUniforms(void);
+
+void flecsTest_bindGroups(void);
+
+void flecsTest_encodePool(void);
+
+void flecsTest_renderGraph(void);
+
+void flecsTest_gpuMemory(void);
+
+void flecsTest_renderStats(void);
+
+#endif
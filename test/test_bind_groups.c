@@ -0,0 +1,58 @@
+#include "test.h"
+
+/* Stats are published when a frame is extracted, so they describe the frame
+ * rendered by the previous progress. */
+static int32_t flecsTest_bindGroups_progress(
+    ecs_world_t *world)
+{
+    ecs_progress(world, 0);
+    const FlecsBindGroupStats *stats = ecs_singleton_get(
+        world, FlecsBindGroupStats);
+    flecsTest_expect(stats != NULL);
+    return stats ? stats->create_count : -1;
+}
+
+/* Once every frame in flight has rendered, frames reuse cached bind groups
+ * until the view is resized. */
+static void flecsTest_bindGroups_steadyState(void)
+{
+    ecs_world_t *world = flecsTest_initEngine();
+    flecsTest_expect(world != NULL);
+    if (!world) {
+        return;
+    }
+
+    flecsTest_createView(world, "view", true);
+    flecsTest_populate(world, 4);
+
+    int32_t i, warmup = FLECS_ENGINE_FRAMES_IN_FLIGHT_MAX + 2;
+    for (i = 0; i < warmup; i ++) {
+        flecsTest_bindGroups_progress(world);
+    }
+
+    for (i = 0; i < 5; i ++) {
+        flecsTest_expect(flecsTest_bindGroups_progress(world) == 0);
+    }
+
+    /* Halves the size of the view targets */
+    FlecsEngineImpl *engine = ecs_singleton_get_mut(world, FlecsEngineImpl);
+    engine->resolution_scale = 2;
+    flecsTest_bindGroups_progress(world);
+
+    int32_t created = 0;
+    for (i = 0; i < warmup; i ++) {
+        created += flecsTest_bindGroups_progress(world);
+    }
+    flecsTest_expect(created > 0);
+
+    for (i = 0; i < 5; i ++) {
+        flecsTest_expect(flecsTest_bindGroups_progress(world) == 0);
+    }
+
+    ecs_fini(world);
+}
+
+void flecsTest_bindGroups(void)
+{
+    flecsTest_bindGroups_steadyState();
+}
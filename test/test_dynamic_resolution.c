@@ -0,0 +1,118 @@
+#include "test.h"
+
+/* The controller is driven with synthetic frame times, it doesn't need an
+ * engine. Settings are the defaults: a 60 FPS budget, scales between 0.5
+ * and 1 and steps of at most 0.05. */
+
+static float flecsTest_dynamicResolution_run(
+    const FlecsDynamicResolution *settings,
+    FlecsDynamicResolutionState *state,
+    float frame_time,
+    int32_t frames)
+{
+    float scale = 0.0f;
+    for (int32_t i = 0; i < frames; i ++) {
+        scale = flecsEngine_dynamicResolution_update(
+            settings, state, frame_time);
+    }
+    return scale;
+}
+
+/* Frames over budget lower the scale down to the minimum, frames well below
+ * the budget raise it back to the maximum. */
+static void flecsTest_dynamicResolution_converge(void)
+{
+    FlecsDynamicResolution settings =
+        flecsEngine_dynamicResolutionSettingsDefault();
+    FlecsDynamicResolutionState state = {0};
+    float budget = settings.target_frame_time;
+
+    float prev = flecsEngine_dynamicResolution_update(
+        &settings, &state, budget * 2.0f);
+    flecsTest_expect(prev <= settings.max_scale);
+
+    bool monotonic = true;
+    for (int32_t i = 0; i < 300; i ++) {
+        float scale = flecsEngine_dynamicResolution_update(
+            &settings, &state, budget * 2.0f);
+        monotonic &= scale <= prev;
+        prev = scale;
+    }
+    flecsTest_expect(monotonic);
+    flecsTest_expect(prev == settings.min_scale);
+
+    float scale = flecsTest_dynamicResolution_run(
+        &settings, &state, budget * 0.3f, 300);
+    flecsTest_expect(scale == settings.max_scale);
+}
+
+/* Frame times between the budget and the tolerance below it don't change
+ * the scale, so small fluctuations don't make the resolution oscillate. */
+static void flecsTest_dynamicResolution_deadband(void)
+{
+    FlecsDynamicResolution settings =
+        flecsEngine_dynamicResolutionSettingsDefault();
+    FlecsDynamicResolutionState state = { .scale = 0.7f };
+    float budget = settings.target_frame_time;
+
+    float scale = flecsTest_dynamicResolution_run(
+        &settings, &state, budget * 0.95f, 200);
+    flecsTest_expect(scale == 0.7f);
+
+    /* Alternating around the filtered value stays within the band */
+    for (int32_t i = 0; i < 200; i ++) {
+        scale = flecsEngine_dynamicResolution_update(&settings, &state,
+            budget * (i % 2 ? 0.93f : 0.97f));
+    }
+    flecsTest_expect(scale == 0.7f);
+}
+
+/* A single adjustment moves the scale by at most one step, after which the
+ * scale holds while the filtered frame time catches up. */
+static void flecsTest_dynamicResolution_stepAndCooldown(void)
+{
+    FlecsDynamicResolution settings =
+        flecsEngine_dynamicResolutionSettingsDefault();
+    FlecsDynamicResolutionState state = {0};
+    float budget = settings.target_frame_time;
+
+    float scale = flecsEngine_dynamicResolution_update(
+        &settings, &state, budget * 10.0f);
+    flecsTest_expect(scale < settings.max_scale);
+    flecsTest_expect(scale >= settings.max_scale - settings.step - 1e-6f);
+    flecsTest_expect(state.cooldown > 0);
+
+    int32_t cooldown = state.cooldown;
+    for (int32_t i = 0; i < cooldown; i ++) {
+        flecsTest_expect(flecsEngine_dynamicResolution_update(
+            &settings, &state, budget * 10.0f) == scale);
+    }
+
+    flecsTest_expect(flecsEngine_dynamicResolution_update(
+        &settings, &state, budget * 10.0f) < scale);
+}
+
+/* Hitches and missing measurements don't feed the filter */
+static void flecsTest_dynamicResolution_hitch(void)
+{
+    FlecsDynamicResolution settings =
+        flecsEngine_dynamicResolutionSettingsDefault();
+    FlecsDynamicResolutionState state = {0};
+
+    float scale = flecsTest_dynamicResolution_run(
+        &settings, &state, 1.0f, 50);
+    flecsTest_expect(scale == settings.max_scale);
+    flecsTest_expect(state.frame_time == 0.0f);
+
+    scale = flecsTest_dynamicResolution_run(&settings, &state, 0.0f, 50);
+    flecsTest_expect(scale == settings.max_scale);
+    flecsTest_expect(state.frame_time == 0.0f);
+}
+
+void flecsTest_dynamicResolution(void)
+{
+    flecsTest_dynamicResolution_converge();
+    flecsTest_dynamicResolution_deadband();
+    flecsTest_dynamicResolution_stepAndCooldown();
+    flecsTest_dynamicResolution_hitch();
+}
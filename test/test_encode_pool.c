@@ -0,0 +1,75 @@
+#include "test.h"
+
+/* Render a frame and return the commands it submitted */
+static flecs_engine_gpu_command_counters_t flecsTest_encodePool_frame(
+    ecs_world_t *world)
+{
+    flecs_engine_gpu_command_counters_t counters = {0};
+    const FlecsEngineImpl *engine = ecs_singleton_get(world, FlecsEngineImpl);
+    flecsEngine_nullGpu_takeCounters(engine->instance, &counters);
+
+    ecs_progress(world, 0);
+
+    engine = ecs_singleton_get(world, FlecsEngineImpl);
+    flecsTest_expect(
+        flecsEngine_nullGpu_takeCounters(engine->instance, &counters));
+    return counters;
+}
+
+/* Shadow cascades encoded on worker threads submit the same commands, in the
+ * same order, as cascades encoded serially on the main thread. */
+static void flecsTest_encodePool_sameCommands(void)
+{
+    ecs_world_t *world = flecsTest_initEngine();
+    flecsTest_expect(world != NULL);
+    if (!world) {
+        return;
+    }
+
+    flecsTest_createView(world, "shadowed", true);
+    flecsTest_createView(world, "unshadowed", false);
+    flecsTest_populate(world, 4);
+
+    for (int32_t i = 0; i < FLECS_ENGINE_FRAMES_IN_FLIGHT_MAX + 2; i ++) {
+        ecs_progress(world, 0);
+    }
+
+    FlecsEngineImpl *engine = ecs_singleton_get_mut(world, FlecsEngineImpl);
+    if (!engine->encode_pool) {
+        /* Threading isn't available, both runs would encode serially */
+        engine->encode_pool = flecsEngine_encodePool_create();
+    }
+    flecsTest_expect(engine->encode_pool != NULL);
+
+    flecs_engine_gpu_command_counters_t pooled =
+        flecsTest_encodePool_frame(world);
+
+    engine = ecs_singleton_get_mut(world, FlecsEngineImpl);
+    flecsEngine_encodePool_free(engine->encode_pool);
+    engine->encode_pool = NULL;
+
+    flecs_engine_gpu_command_counters_t serial =
+        flecsTest_encodePool_frame(world);
+
+    /* A view with shadows renders every cascade */
+    flecsTest_expect(pooled.command_buffer_count >
+        FLECS_ENGINE_SHADOW_CASCADE_COUNT);
+    flecsTest_expect(pooled.draw_indexed_count > 0);
+
+    flecsTest_expect(pooled.command_buffer_count ==
+        serial.command_buffer_count);
+    flecsTest_expect(pooled.render_pass_count == serial.render_pass_count);
+    flecsTest_expect(pooled.draw_count == serial.draw_count);
+    flecsTest_expect(pooled.draw_indexed_count == serial.draw_indexed_count);
+    flecsTest_expect(pooled.pipeline_set_count == serial.pipeline_set_count);
+    flecsTest_expect(
+        pooled.bind_group_set_count == serial.bind_group_set_count);
+    flecsTest_expect(pooled.command_hash == serial.command_hash);
+
+    ecs_fini(world);
+}
+
+void flecsTest_encodePool(void)
+{
+    flecsTest_encodePool_sameCommands();
+}
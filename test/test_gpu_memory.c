@@ -0,0 +1,139 @@
+#include "test.h"
+
+/* Allocations are counted for the whole process, so the test compares the
+ * categories before and after resources are created. */
+
+#define FLECS_TEST_TEXTURE_PATH "flecs_test_gpu_memory.ppm"
+
+/* Stats are published when a frame is extracted. The second frame publishes
+ * what the first one allocated while rendering. */
+static FlecsGpuMemory flecsTest_gpuMemory_progress(
+    ecs_world_t *world)
+{
+    FlecsGpuMemory result = {0};
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    const FlecsGpuMemory *stats = ecs_singleton_get(world, FlecsGpuMemory);
+    flecsTest_expect(stats != NULL);
+    if (stats) {
+        result = *stats;
+    }
+
+    return result;
+}
+
+/* A quad with 4 vertices, 4 UVs and 6 indices */
+static void flecsTest_gpuMemory_createQuad(
+    ecs_world_t *world)
+{
+    ecs_entity_t e = ecs_entity(world, { .name = "quad" });
+    FlecsMesh3 *mesh = ecs_ensure(world, e, FlecsMesh3);
+
+    ecs_vec_set_count_t(NULL, &mesh->vertices, flecs_vec3_t, 4);
+    ecs_vec_set_count_t(NULL, &mesh->normals, flecs_vec3_t, 4);
+    ecs_vec_set_count_t(NULL, &mesh->uvs, flecs_vec2_t, 4);
+    ecs_vec_set_count_t(NULL, &mesh->indices, uint32_t, 6);
+
+    flecs_vec3_t *v = ecs_vec_first_t(&mesh->vertices, flecs_vec3_t);
+    flecs_vec3_t *vn = ecs_vec_first_t(&mesh->normals, flecs_vec3_t);
+    flecs_vec2_t *uv = ecs_vec_first_t(&mesh->uvs, flecs_vec2_t);
+    uint32_t *idx = ecs_vec_first_t(&mesh->indices, uint32_t);
+
+    for (int32_t i = 0; i < 4; i ++) {
+        float x = (float)(i & 1), y = (float)(i >> 1);
+        v[i] = (flecs_vec3_t){x - 0.5f, y - 0.5f, 0.0f};
+        vn[i] = (flecs_vec3_t){0.0f, 0.0f, 1.0f};
+        uv[i] = (flecs_vec2_t){x, y};
+    }
+
+    const uint32_t indices[6] = { 0, 1, 2, 2, 1, 3 };
+    for (int32_t i = 0; i < 6; i ++) {
+        idx[i] = indices[i];
+    }
+
+    ecs_modified(world, e, FlecsMesh3);
+}
+
+/* A 4x2 RGB image, which is loaded as RGBA8 with 3 mip levels */
+static bool flecsTest_gpuMemory_createTexture(
+    ecs_world_t *world)
+{
+    FILE *f = fopen(FLECS_TEST_TEXTURE_PATH, "wb");
+    flecsTest_expect(f != NULL);
+    if (!f) {
+        return false;
+    }
+
+    uint8_t pixels[4 * 2 * 3];
+    for (int32_t i = 0; i < (int32_t)sizeof(pixels); i ++) {
+        pixels[i] = (uint8_t)(i * 10);
+    }
+
+    fprintf(f, "P6\n4 2\n255\n");
+    fwrite(pixels, 1, sizeof(pixels), f);
+    fclose(f);
+
+    ecs_entity_t e = ecs_entity(world, { .name = "texture" });
+    ecs_set(world, e, FlecsTexture, { .path = FLECS_TEST_TEXTURE_PATH });
+    remove(FLECS_TEST_TEXTURE_PATH);
+
+    const FlecsTextureImpl *impl = ecs_get(world, e, FlecsTextureImpl);
+    return impl && impl->texture;
+}
+
+/* Loading assets and adding a view only changes the categories of the
+ * resources they create, by the size of those resources. */
+static void flecsTest_gpuMemory_categories(void)
+{
+    ecs_world_t *world = flecsTest_initEngine();
+    flecsTest_expect(world != NULL);
+    if (!world) {
+        return;
+    }
+
+    FlecsGpuMemory base = flecsTest_gpuMemory_progress(world);
+
+    flecsTest_gpuMemory_createQuad(world);
+    flecsTest_expect(flecsTest_gpuMemory_createTexture(world));
+
+    FlecsGpuMemory loaded = flecsTest_gpuMemory_progress(world);
+
+    /* Vertex buffers with and without UVs, and the index buffer */
+    int64_t mesh_bytes = 4 * (int64_t)sizeof(FlecsLitVertex) +
+        4 * (int64_t)sizeof(FlecsLitVertexUv) + 6 * (int64_t)sizeof(uint32_t);
+    flecsTest_expect(loaded.mesh - base.mesh == mesh_bytes);
+    flecsTest_expect(loaded.buffer_count - base.buffer_count == 3);
+
+    /* Mips of 4x2, 2x1 and 1x1 texels */
+    flecsTest_expect(loaded.texture - base.texture == (4 * 2 + 2 + 1) * 4);
+    flecsTest_expect(loaded.texture_count - base.texture_count == 1);
+    flecsTest_expect(loaded.render_target == base.render_target);
+
+    /* Without effects a view renders batches to a single HDR target at the
+     * size of the output. */
+    ecs_entity_t view = flecsTest_createView(world, "view", false);
+    FlecsGpuMemory rendered = flecsTest_gpuMemory_progress(world);
+
+    const FlecsEngineImpl *engine = ecs_singleton_get(world, FlecsEngineImpl);
+    int64_t target_bytes = flecsEngine_textureBytes(
+        flecsEngine_getHdrFormat(engine),
+        (uint32_t)engine->actual_width, (uint32_t)engine->actual_height);
+    flecsTest_expect(target_bytes > 0);
+    flecsTest_expect(
+        rendered.render_target - loaded.render_target == target_bytes);
+    flecsTest_expect(rendered.texture == loaded.texture);
+
+    /* Targets are released with the view */
+    ecs_delete(world, view);
+    FlecsGpuMemory deleted = flecsTest_gpuMemory_progress(world);
+    flecsTest_expect(deleted.render_target == loaded.render_target);
+
+    ecs_fini(world);
+}
+
+void flecsTest_gpuMemory(void)
+{
+    flecsTest_gpuMemory_categories();
+}
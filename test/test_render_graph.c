@@ -0,0 +1,100 @@
+#include "test.h"
+
+/* Add the effects of the default view of the app. Effects that are disabled
+ * there by default are disabled here too. */
+static void flecsTest_renderGraph_addEffects(
+    ecs_world_t *world,
+    ecs_entity_t view_entity,
+    bool aliasing)
+{
+    FlecsRenderView *view = ecs_get_mut(world, view_entity, FlecsRenderView);
+    view->disable_target_aliasing = !aliasing;
+
+    FlecsSSAO ssao_settings = flecsEngine_ssaoSettingsDefault();
+    FlecsBloom bloom_settings = flecsEngine_bloomSettingsDefault();
+    FlecsExponentialHeightFog fog_settings =
+        flecsEngine_exponentialHeightFogSettingsDefault();
+
+    *ecs_vec_append_t(NULL, &view->effects, flecs_render_view_effect_t) =
+        (flecs_render_view_effect_t){ .enabled = true, .effect =
+            flecsEngine_createEffect_ssao(world, view_entity,
+                "ssao", 0, &ssao_settings) };
+    *ecs_vec_append_t(NULL, &view->effects, flecs_render_view_effect_t) =
+        (flecs_render_view_effect_t){ .enabled = true, .effect =
+            flecsEngine_createEffect_bloom(world, view_entity,
+                "bloom", 1, &bloom_settings) };
+    *ecs_vec_append_t(NULL, &view->effects, flecs_render_view_effect_t) =
+        (flecs_render_view_effect_t){ .enabled = false, .effect =
+            flecsEngine_createEffect_exponentialHeightFog(world, view_entity,
+                "heightFog", 2, &fog_settings) };
+    *ecs_vec_append_t(NULL, &view->effects, flecs_render_view_effect_t) =
+        (flecs_render_view_effect_t){ .enabled = true, .effect =
+            flecsEngine_createEffect_tonyMcMapFace(world, view_entity,
+                "tonyMcMapFace", 3) };
+    *ecs_vec_append_t(NULL, &view->effects, flecs_render_view_effect_t) =
+        (flecs_render_view_effect_t){ .enabled = false, .effect =
+            flecsEngine_createEffect_gammaCorrect(world, view_entity,
+                "gammaCorrect", 4) };
+    *ecs_vec_append_t(NULL, &view->effects, flecs_render_view_effect_t) =
+        (flecs_render_view_effect_t){ .enabled = false, .effect =
+            flecsEngine_createEffect_fxaa(world, view_entity,
+                "fxaa", 5, NULL) };
+    *ecs_vec_append_t(NULL, &view->effects, flecs_render_view_effect_t) =
+        (flecs_render_view_effect_t){ .enabled = false, .effect =
+            flecsEngine_createEffect_taa(world, view_entity,
+                "taa", 6, NULL) };
+
+    ecs_modified(world, view_entity, FlecsRenderView);
+}
+
+/* Render the default effect stack for a few frames in a new engine and
+ * return the render graph stats. Stats are published when a frame is
+ * extracted, so the first frames only publish the ones before them. */
+static FlecsRenderGraphStats flecsTest_renderGraph_run(
+    bool aliasing)
+{
+    FlecsRenderGraphStats result = {0};
+
+    ecs_world_t *world = flecsTest_initEngine();
+    flecsTest_expect(world != NULL);
+    if (!world) {
+        return result;
+    }
+
+    ecs_entity_t view = flecsTest_createView(world, "view", false);
+    flecsTest_renderGraph_addEffects(world, view, aliasing);
+    flecsTest_populate(world, 4);
+
+    for (int32_t i = 0; i < 4; i ++) {
+        ecs_progress(world, 0);
+    }
+
+    const FlecsRenderGraphStats *stats = ecs_singleton_get(
+        world, FlecsRenderGraphStats);
+    flecsTest_expect(stats != NULL);
+    if (stats) {
+        result = *stats;
+    }
+
+    ecs_fini(world);
+    return result;
+}
+
+/* Effect targets whose lifetimes don't overlap share a texture. The batch
+ * output is dead once SSAO has read it, so bloom writes to the same
+ * texture. */
+static void flecsTest_renderGraph_aliasing(void)
+{
+    FlecsRenderGraphStats aliased = flecsTest_renderGraph_run(true);
+    FlecsRenderGraphStats unaliased = flecsTest_renderGraph_run(false);
+
+    flecsTest_expect(aliased.peak_texture_bytes > 0);
+    flecsTest_expect(
+        aliased.peak_texture_bytes < unaliased.peak_texture_bytes);
+    flecsTest_expect(aliased.texture_count < unaliased.texture_count);
+}
+
+void flecsTest_renderGraph(void)
+{
+    flecsTest_renderGraph_aliasing();
+}
@@ -0,0 +1,104 @@
+#include "test.h"
+#include "modules/renderer/batches/batches.h"
+
+/* Box meshes have 12 triangles, quads 2 */
+#define FLECS_TEST_BOX_TRIANGLES (12)
+#define FLECS_TEST_QUAD_TRIANGLES (2)
+
+/* A view that only renders a box and a quad batch, so that the counts of a
+ * frame follow from the scene. */
+static ecs_entity_t flecsTest_renderStats_createView(
+    ecs_world_t *world,
+    ecs_entity_t *batches)
+{
+    ecs_entity_t view = flecsTest_createView(world, "view", false);
+
+    ecs_entity_t batch_set = ecs_entity(world, {
+        .parent = view, .name = "primitives" });
+    batches[0] = flecsEngine_createBatch_boxes(world, batch_set, "boxes");
+    batches[1] = flecsEngine_createBatch_quads(world, batch_set, "quads");
+
+    FlecsRenderBatchSet desc = {0};
+    ecs_vec_append_t(NULL, &desc.batches, ecs_entity_t)[0] = batches[0];
+    ecs_vec_append_t(NULL, &desc.batches, ecs_entity_t)[0] = batches[1];
+    ecs_set_ptr(world, batch_set, FlecsRenderBatchSet, &desc);
+
+    /* Replace the geometry batches of the test view */
+    FlecsRenderBatchSet view_set = {0};
+    ecs_vec_append_t(NULL, &view_set.batches, ecs_entity_t)[0] = batch_set;
+    ecs_set_ptr(world, view, FlecsRenderBatchSet, &view_set);
+
+    return view;
+}
+
+/* The scene is a 4x4 grid of boxes and two quads, all in front of the
+ * camera. Each batch draws its instances with one call, sets its pipeline
+ * and binds its own group and the scene group. */
+static void flecsTest_renderStats_fixedScene(void)
+{
+    ecs_world_t *world = flecsTest_initEngine();
+    flecsTest_expect(world != NULL);
+    if (!world) {
+        return;
+    }
+
+    ecs_entity_t batches[2];
+    ecs_entity_t view = flecsTest_renderStats_createView(world, batches);
+    flecsTest_populate(world, 4);
+
+    for (int32_t i = 0; i < 2; i ++) {
+        ecs_entity_t e = ecs_new(world);
+        ecs_set(world, e, FlecsQuad, {2, 2});
+        ecs_set(world, e, FlecsPosition3, {(float)(i * 4 - 2), 2, 0});
+        ecs_set(world, e, FlecsRgba, {255, 255, 255, 255});
+    }
+
+    /* Stats of a frame are published by the next one */
+    for (int32_t i = 0; i < 3; i ++) {
+        ecs_progress(world, 0);
+    }
+
+    for (int32_t i = 0; i < 2; i ++) {
+        const FlecsRenderBatchImpl *impl = ecs_get(
+            world, batches[i], FlecsRenderBatchImpl);
+        flecsTest_expect(impl != NULL);
+        flecsTest_expect(impl && impl->uses_ibl);
+    }
+
+    const FlecsRenderViewStats *stats = ecs_get(
+        world, view, FlecsRenderViewStats);
+    flecsTest_expect(stats != NULL);
+    if (!stats) {
+        ecs_fini(world);
+        return;
+    }
+
+    flecsTest_expect(stats->draw_count == 2);
+    flecsTest_expect(stats->pipeline_switch_count == 2);
+    flecsTest_expect(stats->bind_group_switch_count == 4);
+    flecsTest_expect(stats->instance_count == 18);
+    flecsTest_expect(stats->triangle_count ==
+        16 * FLECS_TEST_BOX_TRIANGLES + 2 * FLECS_TEST_QUAD_TRIANGLES);
+    flecsTest_expect(stats->visible_instance_count == 18);
+    flecsTest_expect(stats->culled_instance_count == 0);
+
+    /* The same frame again renders the same work */
+    FlecsRenderViewStats prev = *stats;
+    ecs_progress(world, 0);
+    stats = ecs_get(world, view, FlecsRenderViewStats);
+    flecsTest_expect(stats != NULL);
+    if (stats) {
+        flecsTest_expect(stats->draw_count == prev.draw_count);
+        flecsTest_expect(
+            stats->pipeline_switch_count == prev.pipeline_switch_count);
+        flecsTest_expect(
+            stats->bind_group_switch_count == prev.bind_group_switch_count);
+    }
+
+    ecs_fini(world);
+}
+
+void flecsTest_renderStats(void)
+{
+    flecsTest_renderStats_fixedScene();
+}
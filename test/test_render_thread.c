@@ -0,0 +1,140 @@
+#include "test.h"
+
+#include <string.h>
+
+static void flecsTest_onMapped(
+    WGPUMapAsyncStatus status,
+    const char *message,
+    void *userdata)
+{
+    (void)message;
+    flecsTest_expect(status == WGPUMapAsyncStatus_Success);
+    *(bool*)userdata = true;
+}
+
+/* Writes staged while a frame is recorded are replayed by the render thread
+ * before the frame's command buffers are submitted. */
+static void flecsTest_renderThread_handoff(void)
+{
+    ecs_world_t *world = flecsTest_initEngine();
+    flecsTest_expect(world != NULL);
+    if (!world) {
+        return;
+    }
+
+    FlecsEngineImpl *engine = ecs_singleton_get_mut(world, FlecsEngineImpl);
+    flecs_engine_gpu_command_counters_t counters;
+    flecsTest_expect(
+        flecsEngine_nullGpu_takeCounters(engine->instance, &counters));
+
+    engine->render_thread = flecsEngine_renderThread_create();
+    flecsTest_expect(engine->render_thread != NULL);
+    if (!engine->render_thread) {
+        ecs_fini(world);
+        return;
+    }
+
+    WGPUBuffer buffer = wgpuDeviceCreateBuffer(engine->device,
+        &(WGPUBufferDescriptor){
+            .usage = WGPUBufferUsage_CopyDst | WGPUBufferUsage_MapRead,
+            .size = 16
+        });
+
+    const uint32_t values[4] = { 1, 2, 3, 4 };
+    flecsEngine_queueWriteBuffer(engine, buffer, 0, values, sizeof(values));
+
+    /* Staged in the packet, not written yet */
+    flecsEngine_nullGpu_takeCounters(engine->instance, &counters);
+    flecsTest_expect(counters.write_buffer_count == 0);
+
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(
+        engine->device, &(WGPUCommandEncoderDescriptor){0});
+    flecsEngine_frameCommands_append(engine, wgpuCommandEncoderFinish(
+        encoder, &(WGPUCommandBufferDescriptor){0}));
+    wgpuCommandEncoderRelease(encoder);
+
+    /* Nothing to present, the engine renders offscreen */
+    FlecsEngineSurface target = {0};
+    flecsEngine_renderThread_submit(engine, &target);
+    flecsEngine_renderThread_wait(engine->render_thread);
+
+    flecsTest_expect(ecs_vec_count(&engine->frame_commands) == 0);
+
+    flecsEngine_nullGpu_takeCounters(engine->instance, &counters);
+    flecsTest_expect(counters.submit_count == 1);
+    flecsTest_expect(counters.command_buffer_count == 1);
+    flecsTest_expect(counters.write_buffer_count == 1);
+    flecsTest_expect(counters.write_buffer_bytes == (int64_t)sizeof(values));
+
+    bool mapped = false;
+    flecsEngine_bufferMapAsync(buffer, WGPUMapMode_Read, 0, sizeof(values),
+        flecsTest_onMapped, &mapped);
+    flecsEngine_processEventsUntilDone(engine->instance, &mapped);
+
+    const uint32_t *data = wgpuBufferGetConstMappedRange(
+        buffer, 0, sizeof(values));
+    flecsTest_expect(data != NULL);
+    if (data) {
+        flecsTest_expect(!memcmp(data, values, sizeof(values)));
+    }
+    wgpuBufferUnmap(buffer);
+
+    flecsEngine_renderThread_free(engine->render_thread);
+    engine->render_thread = NULL;
+    wgpuBufferRelease(buffer);
+    ecs_fini(world);
+}
+
+/* A packet only keeps what it needs from the engine, so the singleton can
+ * change after the handoff. */
+static void flecsTest_renderThread_engineMoves(void)
+{
+    ecs_world_t *world = flecsTest_initEngine();
+    flecsTest_expect(world != NULL);
+    if (!world) {
+        return;
+    }
+
+    FlecsEngineImpl *engine = ecs_singleton_get_mut(world, FlecsEngineImpl);
+    flecs_engine_gpu_command_counters_t counters;
+    flecsEngine_nullGpu_takeCounters(engine->instance, &counters);
+
+    flecs_engine_render_thread_t *rt = flecsEngine_renderThread_create();
+    flecsTest_expect(rt != NULL);
+    if (!rt) {
+        ecs_fini(world);
+        return;
+    }
+
+    /* Hand off from a copy of the engine and clobber it while the render
+     * thread may still be submitting. */
+    FlecsEngineImpl *copy = ecs_os_memdup_t(engine, FlecsEngineImpl);
+    copy->render_thread = rt;
+    ecs_vec_init_t(NULL, &copy->frame_commands, WGPUCommandBuffer, 0);
+
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(
+        copy->device, &(WGPUCommandEncoderDescriptor){0});
+    flecsEngine_frameCommands_append(copy, wgpuCommandEncoderFinish(
+        encoder, &(WGPUCommandBufferDescriptor){0}));
+    wgpuCommandEncoderRelease(encoder);
+
+    FlecsEngineSurface target = {0};
+    flecsEngine_renderThread_submit(copy, &target);
+    ecs_vec_fini_t(NULL, &copy->frame_commands, WGPUCommandBuffer);
+    memset(copy, 0xff, sizeof(FlecsEngineImpl));
+    ecs_os_free(copy);
+
+    flecsEngine_renderThread_wait(rt);
+
+    flecsEngine_nullGpu_takeCounters(engine->instance, &counters);
+    flecsTest_expect(counters.submit_count == 1);
+
+    flecsEngine_renderThread_free(rt);
+    ecs_fini(world);
+}
+
+void flecsTest_renderThread(void)
+{
+    flecsTest_renderThread_handoff();
+    flecsTest_renderThread_engineMoves();
+}
@@ -0,0 +1,172 @@
+#include "test.h"
+
+/* Doesn't use scene features, so its pipelines don't depend on lights */
+static const char *flecs_test_shader_source =
+    "// flecs_engine_test: shader_cache\n"
+    "@vertex fn vs_main(@location(0) pos: vec3<f32>)"
+        " -> @builtin(position) vec4<f32> {\n"
+    "    return vec4<f32>(pos, 1.0);\n"
+    "}\n"
+    "@fragment fn fs_main() -> @location(0) vec4<f32> {\n"
+    "    return vec4<f32>(1.0);\n"
+    "}\n";
+
+static ecs_entity_t flecsTest_shaderCache_createShader(
+    ecs_world_t *world,
+    const char *name)
+{
+    return flecsEngine_shader_ensure(world, name, &(FlecsShader){
+        .source = flecs_test_shader_source,
+        .vertex_entry = "vs_main",
+        .fragment_entry = "fs_main"
+    });
+}
+
+static ecs_entity_t flecsTest_shaderCache_createBatch(
+    ecs_world_t *world,
+    ecs_entity_t shader)
+{
+    ecs_entity_t batch = ecs_new(world);
+    ecs_set(world, batch, FlecsRenderBatch, {
+        .shader = shader,
+        .vertex_type = ecs_id(FlecsLitVertex),
+        .instance_types = { ecs_id(FlecsInstanceTransform) }
+    });
+    return batch;
+}
+
+static WGPURenderPipeline flecsTest_shaderCache_pipeline(
+    const ecs_world_t *world,
+    ecs_entity_t batch)
+{
+    const FlecsRenderBatchImpl *impl = ecs_get(
+        world, batch, FlecsRenderBatchImpl);
+    return impl ? impl->pipeline_hdr : NULL;
+}
+
+/* Find a geometry batch of the view whose shader uses local lights */
+static ecs_entity_t flecsTest_shaderCache_findClusterBatch(
+    const ecs_world_t *world)
+{
+    ecs_iter_t it = ecs_each(world, FlecsRenderBatchImpl);
+    while (ecs_each_next(&it)) {
+        const FlecsRenderBatchImpl *impls = ecs_field(
+            &it, FlecsRenderBatchImpl, 0);
+        for (int32_t i = 0; i < it.count; i ++) {
+            if (impls[i].feature_mask &
+                FLECS_ENGINE_BATCH_FEATURE_CLUSTER_LIGHTS)
+            {
+                ecs_entity_t result = it.entities[i];
+                ecs_iter_fini(&it);
+                return result;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Batches that share a shader, or use shaders with the same source, share
+ * one compiled module. */
+static void flecsTest_shaderCache_shareModule(void)
+{
+    ecs_world_t *world = flecsTest_initEngine();
+    flecsTest_expect(world != NULL);
+    if (!world) {
+        return;
+    }
+
+    const flecs_engine_shader_cache_t *cache =
+        &ecs_singleton_get(world, FlecsEngineImpl)->shader_cache;
+    int32_t compile_count = cache->compile_count;
+    int32_t module_count = cache->module_count;
+    int32_t hit_count = cache->hit_count;
+
+    ecs_entity_t shader = flecsTest_shaderCache_createShader(
+        world, "TestShaderCacheShared");
+    ecs_entity_t batch_a = flecsTest_shaderCache_createBatch(world, shader);
+    ecs_entity_t batch_b = flecsTest_shaderCache_createBatch(world, shader);
+
+    flecsTest_expect(flecsTest_shaderCache_pipeline(world, batch_a) != NULL);
+    flecsTest_expect(flecsTest_shaderCache_pipeline(world, batch_b) != NULL);
+
+    /* A different shader asset with the same source hits the cache */
+    ecs_entity_t copy = flecsTest_shaderCache_createShader(
+        world, "TestShaderCacheCopy");
+    ecs_entity_t batch_c = flecsTest_shaderCache_createBatch(world, copy);
+    flecsTest_expect(flecsTest_shaderCache_pipeline(world, batch_c) != NULL);
+
+    /* Creating components can move the singleton, get it again */
+    cache = &ecs_singleton_get(world, FlecsEngineImpl)->shader_cache;
+    flecsTest_expect(cache->compile_count - compile_count == 1);
+    flecsTest_expect(cache->module_count - module_count == 1);
+    flecsTest_expect(cache->hit_count > hit_count);
+
+    const FlecsShaderImpl *impl = ecs_get(world, shader, FlecsShaderImpl);
+    const FlecsShaderImpl *copy_impl = ecs_get(world, copy, FlecsShaderImpl);
+    flecsTest_expect(impl != NULL && copy_impl != NULL);
+    if (impl && copy_impl) {
+        flecsTest_expect(impl->shader_module == copy_impl->shader_module);
+    }
+
+    ecs_fini(world);
+}
+
+/* When the scene starts using local lights, only batches whose shaders use
+ * them are rebuilt. */
+static void flecsTest_shaderCache_rebuildByFeature(void)
+{
+    ecs_world_t *world = flecsTest_initEngine();
+    flecsTest_expect(world != NULL);
+    if (!world) {
+        return;
+    }
+
+    flecsTest_createView(world, "view", false);
+    ecs_entity_t shader = flecsTest_shaderCache_createShader(
+        world, "TestShaderCacheUnlit");
+    ecs_entity_t unlit = flecsTest_shaderCache_createBatch(world, shader);
+    ecs_progress(world, 0);
+
+    ecs_entity_t lit = flecsTest_shaderCache_findClusterBatch(world);
+    flecsTest_expect(lit != 0);
+    if (!lit) {
+        ecs_fini(world);
+        return;
+    }
+
+    const FlecsRenderBatchImpl *lit_impl = ecs_get(
+        world, lit, FlecsRenderBatchImpl);
+    flecsTest_expect(!(lit_impl->features &
+        FLECS_ENGINE_BATCH_FEATURE_CLUSTER_LIGHTS));
+
+    WGPURenderPipeline unlit_pipeline =
+        flecsTest_shaderCache_pipeline(world, unlit);
+    WGPURenderPipeline lit_pipeline =
+        flecsTest_shaderCache_pipeline(world, lit);
+
+    ecs_entity_t light = ecs_new(world);
+    ecs_set(world, light, FlecsPosition3, {0, 5, 0});
+    ecs_set(world, light, FlecsPointLight, {
+        .intensity = 1.0f, .range = 10.0f });
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    /* Rebuilt pipelines are created before the old ones are released, so a
+     * pipeline that wasn't rebuilt is the only one with the same handle. */
+    flecsTest_expect(
+        flecsTest_shaderCache_pipeline(world, unlit) == unlit_pipeline);
+    flecsTest_expect(
+        flecsTest_shaderCache_pipeline(world, lit) != lit_pipeline);
+
+    lit_impl = ecs_get(world, lit, FlecsRenderBatchImpl);
+    flecsTest_expect(lit_impl->features &
+        FLECS_ENGINE_BATCH_FEATURE_CLUSTER_LIGHTS);
+
+    ecs_fini(world);
+}
+
+void flecsTest_shaderCache(void)
+{
+    flecsTest_shaderCache_shareModule();
+    flecsTest_shaderCache_rebuildByFeature();
+}
@@ -0,0 +1,34 @@
+#include "test.h"
+
+/* Each view writes its uniforms once per frame, and views with shadows
+ * also write their cascade matrices once. */
+static void flecsTest_viewUniforms_writeCount(void)
+{
+    ecs_world_t *world = flecsTest_initEngine();
+    flecsTest_expect(world != NULL);
+    if (!world) {
+        return;
+    }
+
+    flecsTest_createView(world, "shadowed", true);
+    flecsTest_createView(world, "unshadowed", false);
+    flecsTest_populate(world, 4);
+
+    const int32_t view_count = 2, shadowed_count = 1;
+
+    for (int32_t i = 0; i < 5; i ++) {
+        ecs_progress(world, 0);
+
+        const FlecsEngineImpl *engine = ecs_singleton_get(
+            world, FlecsEngineImpl);
+        flecsTest_expect(engine->view_uniforms.write_count ==
+            view_count + shadowed_count);
+    }
+
+    ecs_fini(world);
+}
+
+void flecsTest_viewUniforms(void)
+{
+    flecsTest_viewUniforms_writeCount();
+}